@@ -174,6 +174,29 @@ bool findPattern(const Pattern& pattern, const cv::Mat& viewGray, const cv::Size
   return found;
 }
 
+bool findPattern(const Pattern& pattern, const cv::Mat& viewGray, const cv::Size& boardSize, std::size_t downscale, std::vector<int>& detectedId, std::vector<cv::Point2f>& pointbuf)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
+  // the CCTag detector is already multi-scale, a downscaled pass would only
+  // duplicate its internal pyramid
+  if(pattern == ASYMMETRIC_CCTAG_GRID)
+    downscale = 1;
+#endif
+
+  if(downscale > 1)
+  {
+    cv::Mat viewGraySmall;
+    cv::resize(viewGray, viewGraySmall, cv::Size(), 1.0 / downscale, 1.0 / downscale, cv::INTER_AREA);
+
+    std::vector<int> prefilterId;
+    std::vector<cv::Point2f> prefilterBuf;
+    if(!findPattern(pattern, viewGraySmall, boardSize, prefilterId, prefilterBuf))
+      return false;
+  }
+
+  return findPattern(pattern, viewGray, boardSize, detectedId, pointbuf);
+}
+
 void calcChessboardCorners(std::vector<cv::Point3f>& corners, const cv::Size& boardSize,
                            const float squareSize, Pattern pattern = Pattern::CHESSBOARD)
 {
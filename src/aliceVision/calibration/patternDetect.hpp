@@ -56,6 +56,22 @@ std::ostream& operator<<(std::ostream &stream, const Pattern pattern);
  */
 bool findPattern(const Pattern& pattern, const cv::Mat& viewGray, const cv::Size& boardSize, std::vector<int>& detectedId, std::vector<cv::Point2f>& pointbuf);
 
+/**
+ * @brief This function detects the checkerboard in images, rejecting frames early
+ * on a downscaled version of the image: the full resolution detection only runs
+ * when the cheap downscaled pass found the pattern. The CCTag pattern ignores the
+ * prefilter as its detector is already multi-scale.
+ *
+ * @param[in] pattern The type of pattern used for the calibration.
+ * @param[in] viewGray The image in gray level.
+ * @param[in] boardSize The size of the calibration pattern.
+ * @param[in] downscale Downscale factor of the prefilter pass, 1 disables the prefilter.
+ * @param[out] detectedId Id of the detected CCTags.
+ * @param[out] pointbuf Coordinates of the 2D points in each image.
+ * @return True if the pattern is found, otherwise false.
+ */
+bool findPattern(const Pattern& pattern, const cv::Mat& viewGray, const cv::Size& boardSize, std::size_t downscale, std::vector<int>& detectedId, std::vector<cv::Point2f>& pointbuf);
+
 /**
  * @brief This function computes the points' coordinates of the checkerboard.
  *
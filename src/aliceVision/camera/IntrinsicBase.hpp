@@ -82,23 +82,33 @@ struct IntrinsicBase
       return this->cam2ima( X.head<2>()/X(2) );
   }
 
+  /// Batched counterpart of project: one virtual dispatch amortized over all
+  /// the given points. The base implementation falls back to per-point calls;
+  /// models with a closed-form distortion override it with vectorized math.
+  virtual void projectMany(
+    const geometry::Pose3 & pose,
+    const Mat3X & pts3D,
+    Mat2X & pts2D,
+    bool applyDistortion = true) const
+  {
+    pts2D.resize(2, pts3D.cols());
+    for(Mat3X::Index i = 0; i < pts3D.cols(); ++i)
+      pts2D.col(i) = this->project(pose, pts3D.col(i), applyDistortion);
+  }
+
   /// Compute the residual between the 3D projected point X and an image observation x
   Vec2 residual(const geometry::Pose3 & pose, const Vec3 & X, const Vec2 & x) const
   {
     const Vec2 proj = this->project(pose, X);
     return x - proj;
   }
-  
+
   Mat2X residuals(const geometry::Pose3 & pose, const Mat3X & X, const Mat2X & x) const
   {
     assert(X.cols() == x.cols());
-    const std::size_t numPts = x.cols();
-    Mat2X residuals = Mat2X::Zero(2, numPts);
-    for(std::size_t i = 0; i < numPts; ++i)
-    {
-      residuals.col(i) = residual(pose, X.col(i), x.col(i));
-    }
-    return residuals;
+    Mat2X proj;
+    this->projectMany(pose, X, proj);
+    return x - proj;
   }
 
   // --
@@ -132,6 +142,13 @@ struct IntrinsicBase
   /// Remove the distortion to a camera point (that is in normalized camera frame)
   virtual Vec2 remove_disto(const Vec2& p) const  = 0;
 
+  /// Cache the inverse distortion as a look-up table used by remove_disto,
+  /// trading a sub-epsilon accuracy loss for a large speedup in non-optimizing
+  /// contexts (guided matching, triangulation from known poses). The cache is
+  /// dropped by updateFromParams, so an optimization never uses stale values.
+  /// No effect on models without such a cache.
+  virtual void enableInverseDistortionCache(std::size_t numSamples = 2048) {}
+
   /// Return the un-distorted pixel (with removed distortion)
   virtual Vec2 get_ud_pixel(const Vec2& p) const = 0;
 
@@ -92,10 +92,29 @@ class Pinhole : public IntrinsicBase
     return ( p -  principal_point() ) / focal();
   }
 
+  /// Vectorized projection: the pose, perspective division, distortion and
+  /// intrinsics are applied to all the columns at once with Eigen
+  virtual void projectMany(
+    const geometry::Pose3 & pose,
+    const Mat3X & pts3D,
+    Mat2X & pts2D,
+    bool applyDistortion = true) const
+  {
+    const Mat3X X = pose(pts3D); // apply pose
+    pts2D = X.topRows<2>().array().rowwise() / X.row(2).array();
+    if(applyDistortion && this->have_disto()) // apply disto
+      add_disto_many(pts2D);
+    // apply intrinsics
+    pts2D = (focal() * pts2D).colwise() + principal_point();
+  }
+
   virtual bool have_disto() const {  return false; }
 
   virtual Vec2 add_disto(const Vec2& p) const  { return p; }
 
+  /// Add distortion in place to camera frame points, vectorized counterpart of add_disto
+  virtual void add_disto_many(Mat2X& pts) const {}
+
   virtual Vec2 remove_disto(const Vec2& p) const  { return p; }
 
   virtual double imagePlane_toCameraPlaneError(double value) const
@@ -11,6 +11,7 @@
 #include <aliceVision/camera/cameraCommon.hpp>
 #include <aliceVision/camera/Pinhole.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace aliceVision {
@@ -44,6 +45,67 @@ namespace radial_distortion{
     return .5*(lowerbound+upbound);
   }
 
+  /**
+   * @brief 1D look-up table caching the inverse of a radial distortion model.
+   *
+   * A radial model only rescales a point by a factor depending on its squared
+   * radius, so the iterative bisection_Radius_Solve can be sampled once over
+   * the image domain and replaced by a linear interpolation at query time.
+   */
+  class InverseRadiusLUT
+  {
+  public:
+
+    /// Sample the inverse distortion scale factor over [0, maxR2]
+    template <class Disto_Functor>
+    void build(const std::vector<double>& params,
+               double maxR2,
+               Disto_Functor& functor,
+               std::size_t numSamples = 2048)
+    {
+      assert(maxR2 > 0.0);
+      assert(numSamples > 1);
+      _step = maxR2 / (numSamples - 1);
+      _scales.resize(numSamples);
+      _scales[0] = 1.0; // the distortion has no effect at the optical center
+      for(std::size_t i = 1; i < numSamples; ++i)
+      {
+        const double r2 = i * _step;
+        _scales[i] = ::sqrt(bisection_Radius_Solve(params, r2, functor) / r2);
+      }
+    }
+
+    /// Whether the table has been built and covers the given squared radius
+    bool contains(double r2) const
+    {
+      return !_scales.empty() && (r2 <= (_scales.size() - 1) * _step);
+    }
+
+    /// Drop the cached samples (e.g. when the distortion parameters change)
+    void clear()
+    {
+      _scales.clear();
+    }
+
+    /// Inverse distortion scale factor at the given squared radius (linear interpolation)
+    double operator()(double r2) const
+    {
+      const double pos = r2 / _step;
+      const std::size_t idx = static_cast<std::size_t>(pos);
+      if(idx + 1 >= _scales.size())
+        return _scales.back();
+      const double frac = pos - idx;
+      return _scales[idx] + frac * (_scales[idx + 1] - _scales[idx]);
+    }
+
+  private:
+
+    /// squared radius distance between two consecutive samples
+    double _step = 0.0;
+    /// undistorted/distorted radius ratio per sampled squared radius
+    std::vector<double> _scales;
+  };
+
 } // namespace radial_distortion
 
 /// Implement a Pinhole camera with a 1 radial distortion coefficient.
@@ -78,18 +140,50 @@ class PinholeRadialK1 : public Pinhole
     return (p * r_coeff);
   }
 
+  /// Add distortion to all the points at once, see add_disto
+  virtual void add_disto_many(Mat2X& pts) const
+  {
+    const double k1 = _distortionParams.at(0);
+
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> r_coeff = 1. + k1*r2;
+
+    pts = pts.array().rowwise() * r_coeff;
+  }
+
   /// Remove distortion (return p' such that disto(p') = p)
   virtual Vec2 remove_disto(const Vec2& p) const {
     // Compute the radius from which the point p comes from thanks to a bisection
     // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
     const double r2 = p(0)*p(0) + p(1)*p(1);
+    if(_inverseRadiusLUT.contains(r2))
+      return _inverseRadiusLUT(r2) * p;
     const double radius = (r2 == 0) ?
       1. :
       ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor) / r2);
     return radius * p;
   }
 
+  /// Cache the inverse distortion over the image domain, see IntrinsicBase
+  virtual void enableInverseDistortionCache(std::size_t numSamples = 2048)
+  {
+    // the LUT covers the largest squared radius reached by the image corners
+    double maxR2 = 0.0;
+    const Vec2 corners[4] = {Vec2(0, 0), Vec2(w(), 0), Vec2(0, h()), Vec2(w(), h())};
+    for(const Vec2& corner : corners)
+      maxR2 = std::max(maxR2, ima2cam(corner).squaredNorm());
+    _inverseRadiusLUT.build(_distortionParams, maxR2, distoFunctor, numSamples);
+  }
+
+  // Data wrapper for non linear optimization (update from data)
+  virtual bool updateFromParams(const std::vector<double>& params)
+  {
+    // the cached inverse distortion is no longer valid
+    _inverseRadiusLUT.clear();
+    return Pinhole::updateFromParams(params);
+  }
+
   /// Return the un-distorted pixel (with removed distortion)
   virtual Vec2 get_ud_pixel(const Vec2& p) const
   {
@@ -110,6 +204,9 @@ class PinholeRadialK1 : public Pinhole
     const double k1 = params[0];
     return r2 * Square(1.+r2*k1);
   }
+
+  /// optional cached inverse distortion, see enableInverseDistortionCache()
+  radial_distortion::InverseRadiusLUT _inverseRadiusLUT;
 };
 
 /// Implement a Pinhole camera with a 3 radial distortion coefficients.
@@ -146,18 +243,52 @@ class PinholeRadialK3 : public Pinhole
     return (p * r_coeff);
   }
 
+  /// Add distortion to all the points at once, see add_disto
+  virtual void add_disto_many(Mat2X& pts) const
+  {
+    const double k1 = _distortionParams[0], k2 = _distortionParams[1], k3 = _distortionParams[2];
+
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> r4 = r2 * r2;
+    const Eigen::Array<double, 1, Eigen::Dynamic> r6 = r4 * r2;
+    const Eigen::Array<double, 1, Eigen::Dynamic> r_coeff = 1. + k1*r2 + k2*r4 + k3*r6;
+
+    pts = pts.array().rowwise() * r_coeff;
+  }
+
   /// Remove distortion (return p' such that disto(p') = p)
   virtual Vec2 remove_disto(const Vec2& p) const {
     // Compute the radius from which the point p comes from thanks to a bisection
     // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
     const double r2 = p(0)*p(0) + p(1)*p(1);
+    if(_inverseRadiusLUT.contains(r2))
+      return _inverseRadiusLUT(r2) * p;
     const double radius = (r2 == 0) ? //1. : ::sqrt(bisectionSolve(_distortionParams, r2) / r2);
       1. :
       ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor) / r2);
     return radius * p;
   }
 
+  /// Cache the inverse distortion over the image domain, see IntrinsicBase
+  virtual void enableInverseDistortionCache(std::size_t numSamples = 2048)
+  {
+    // the LUT covers the largest squared radius reached by the image corners
+    double maxR2 = 0.0;
+    const Vec2 corners[4] = {Vec2(0, 0), Vec2(w(), 0), Vec2(0, h()), Vec2(w(), h())};
+    for(const Vec2& corner : corners)
+      maxR2 = std::max(maxR2, ima2cam(corner).squaredNorm());
+    _inverseRadiusLUT.build(_distortionParams, maxR2, distoFunctor, numSamples);
+  }
+
+  // Data wrapper for non linear optimization (update from data)
+  virtual bool updateFromParams(const std::vector<double>& params)
+  {
+    // the cached inverse distortion is no longer valid
+    _inverseRadiusLUT.clear();
+    return Pinhole::updateFromParams(params);
+  }
+
   /// Return the un-distorted pixel (with removed distortion)
   virtual Vec2 get_ud_pixel(const Vec2& p) const
   {
@@ -178,6 +309,9 @@ class PinholeRadialK3 : public Pinhole
     const double k1 = params[0], k2 = params[1], k3 = params[2];
     return r2 * Square(1.+r2*(k1+r2*(k2+r2*k3)));
   }
+
+  /// optional cached inverse distortion, see enableInverseDistortionCache()
+  radial_distortion::InverseRadiusLUT _inverseRadiusLUT;
 };
 
 } // namespace camera
@@ -20,6 +20,100 @@
 namespace aliceVision {
 namespace camera {
 
+/**
+ * @brief Per-pixel map from undistorted to distorted coordinates.
+ *
+ * Evaluating the distortion model per output pixel is the expensive part of the
+ * undistortion (get_d_pixel computes the full distortion polynomial); the map
+ * caches these coordinates once per intrinsic, so that every view sharing the
+ * same camera only pays for the cheap bilinear remap.
+ */
+class UndistortionMap
+{
+public:
+
+  /**
+   * @brief Precompute the distorted coordinates of every output pixel.
+   * @param[in] intrinsicPtr The camera intrinsic with its distortion model.
+   * @param[in] width The image width in pixels.
+   * @param[in] height The image height in pixels.
+   * @param[in] correctPrincipalPoint Recenter the principal point.
+   */
+  void compute(const IntrinsicBase* intrinsicPtr,
+               int width,
+               int height,
+               bool correctPrincipalPoint = false)
+  {
+    Vec2 ppCorrection(0.0, 0.0);
+
+    if(correctPrincipalPoint)
+    {
+      if(camera::isPinhole(intrinsicPtr->getType()))
+      {
+        const Vec2 center(width * 0.5, height * 0.5);
+        const camera::Pinhole* pinholePtr = dynamic_cast<const camera::Pinhole*>(intrinsicPtr);
+        ppCorrection = pinholePtr->principal_point() - center;
+      }
+    }
+
+    // float keeps the map at 8 bytes per pixel and is precise enough for a
+    // sub-millipixel sampling position on large sensors
+    _mapX.resize(width, height);
+    _mapY.resize(width, height);
+
+    #pragma omp parallel for
+    for(int j = 0; j < height; ++j)
+      for(int i = 0; i < width; ++i)
+      {
+        // compute coordinates with distortion
+        const Vec2 disto_pix = intrinsicPtr->get_d_pixel(Vec2(i, j)) + ppCorrection;
+        _mapX(j, i) = static_cast<float>(disto_pix(0));
+        _mapY(j, i) = static_cast<float>(disto_pix(1));
+      }
+  }
+
+  /// Whether the map has been computed for the given image size
+  bool isValid(int width, int height) const
+  {
+    return (_mapX.Width() == width) && (_mapX.Height() == height);
+  }
+
+  /**
+   * @brief Undistort an image by remapping it through the precomputed map.
+   * @param[in] imageIn The distorted input image.
+   * @param[out] image_ud The undistorted output image.
+   * @param[in] fillcolor The color used for pixels falling outside the input image.
+   */
+  template <typename T>
+  void undistort(const image::Image<T>& imageIn,
+                 image::Image<T>& image_ud,
+                 T fillcolor) const
+  {
+    assert(isValid(imageIn.Width(), imageIn.Height()));
+
+    image_ud.resize(imageIn.Width(), imageIn.Height(), true, fillcolor);
+    const image::Sampler2d<image::SamplerLinear> sampler;
+
+    #pragma omp parallel for
+    for(int j = 0; j < imageIn.Height(); ++j)
+      for(int i = 0; i < imageIn.Width(); ++i)
+      {
+        const float x = _mapX(j, i);
+        const float y = _mapY(j, i);
+
+        // pick pixel if it is in the image domain
+        if(imageIn.Contains(y, x))
+          image_ud(j, i) = sampler(imageIn, y, x);
+      }
+  }
+
+private:
+  /// distorted x coordinate of each output pixel
+  image::Image<float> _mapX;
+  /// distorted y coordinate of each output pixel
+  image::Image<float> _mapY;
+};
+
 /// Undistort an image according a given camera and its distortion model
 template <typename T>
 void UndistortImage(
@@ -66,6 +160,18 @@ void UndistortImage(
   }
 }
 
+/// Undistort an image through a precomputed undistortion map, to be shared
+/// across all the views of the same intrinsic
+template <typename T>
+void UndistortImage(
+  const image::Image<T>& imageIn,
+  const UndistortionMap& undistortionMap,
+  image::Image<T>& image_ud,
+  T fillcolor)
+{
+  undistortionMap.undistort(imageIn, image_ud, fillcolor);
+}
+
 } // namespace camera
 } // namespace aliceVision
 
@@ -78,3 +78,40 @@ BOOST_AUTO_TEST_CASE(cameraPinholeRadial_disto_undisto_K3) {
     BOOST_CHECK(! (cam.add_disto(ptCamera) == cam.remove_disto(cam.add_disto(ptCamera))) ) ;
   }
 }
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a PinholeRadialK3 camera and enable the inverse-distortion cache
+// - Generate random points inside the image domain
+// - Assert that the cached remove_disto matches the iterative one
+// - Assert that updating the parameters drops the cache
+//-----------------
+BOOST_AUTO_TEST_CASE(cameraPinholeRadial_inverse_distortion_cache_K3) {
+
+  const PinholeRadialK3 camRef(1000, 1000, 1000, 500, 500,
+    // K1, K2, K3
+    -0.245539, 0.255195, 0.163773);
+
+  PinholeRadialK3 camCached = camRef;
+  camCached.enableInverseDistortionCache();
+
+  const double epsilon = 1e-4;
+  for(int i = 0; i < 10; ++i)
+  {
+    // generate random point inside the image domain (last random to avoid 0,0)
+    const Vec2 ptImage = (Vec2::Random() * 800./2.) + Vec2(500,500) + Vec2::Random();
+
+    // Check that the cached inverse distortion matches the iterative bisection
+    EXPECT_MATRIX_NEAR( camRef.get_ud_pixel(ptImage), camCached.get_ud_pixel(ptImage), epsilon);
+  }
+
+  // Check that the cache is dropped when the parameters are updated
+  std::vector<double> params = camCached.getParams();
+  params[3] = -0.2;
+  BOOST_CHECK(camCached.updateFromParams(params));
+
+  const PinholeRadialK3 camUpdated(1000, 1000, 1000, 500, 500, -0.2, 0.255195, 0.163773);
+  const Vec2 ptImage(100., 100.);
+  EXPECT_MATRIX_NEAR( camUpdated.get_ud_pixel(ptImage), camCached.get_ud_pixel(ptImage), 1e-12);
+}
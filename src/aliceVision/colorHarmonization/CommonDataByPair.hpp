@@ -60,6 +60,29 @@ public:
     }
   }
 
+  /**
+   * Compute Histogram for the color data of the whole image
+   *
+   * \param[in] channelIndex selected channel : 0 = red; 1 = green; 2 = blue
+   * \param[in] image Image with RGB or LAB type
+   * \param[out] histo  Histogram of the image.
+   *
+   */
+  template< typename ImageType >
+  static void computeHisto(
+    Histogram< double > & histo,
+    std::size_t channelIndex,
+    const image::Image< ImageType >& image )
+  {
+    for(int j = 0; j < image.Height(); ++j)
+    {
+      for(int i = 0; i < image.Width(); ++i)
+      {
+        histo.Add(image(j,i)(channelIndex));
+      }
+    }
+  }
+
   const std::string & getLeftImage()const{ return _sLeftImage; }
   const std::string & getRightImage()const{ return _sRightImage; }
 
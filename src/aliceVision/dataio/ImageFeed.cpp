@@ -13,6 +13,8 @@
 #include <boost/algorithm/string/case_conv.hpp> 
 #include <boost/algorithm/string/replace.hpp>
 
+#include <condition_variable>
+#include <mutex>
 #include <queue>
 #include <iostream>
 #include <fstream>
@@ -20,6 +22,7 @@
 #include <regex>
 #include <iterator>
 #include <string>
+#include <thread>
 
 namespace aliceVision{
 namespace dataio{
@@ -31,9 +34,11 @@ public:
   static bool isSupported(const std::string &ext);
   
   FeederImpl() : _isInit(false) {}
-  
+
   FeederImpl(const std::string& imagePath, const std::string& calibPath);
-  
+
+  ~FeederImpl();
+
   template<typename T>
   bool readImage(image::Image<T> &image,
                    camera::PinholeRadialK3 &camIntrinsics,
@@ -53,6 +58,8 @@ public:
     }
     else
     {
+      waitEnumeration();
+
       if(_images.empty())
         return false;
       if(_currentImageIndex >= _images.size())
@@ -73,6 +80,13 @@ public:
       ALICEVISION_LOG_DEBUG(imageName);
 
       image::readImage(imageName, image);
+
+      // warm up the next frame while the caller processes the current one
+      if(_prefetchThread.joinable())
+        _prefetchThread.join();
+      if(_currentImageIndex + 1 < _images.size())
+        _prefetchThread = std::thread(&FeederImpl::prefetchFile, _images[_currentImageIndex + 1]);
+
       return true;
     }
     return true;
@@ -133,21 +147,54 @@ private:
     ++_viewIterator;
     return true;
   }
-  
+
+  /**
+   * @brief List the images of the given folder into _images, sorted
+   * alphabetically. Runs on a background thread, so the constructor returns
+   * while large (network) folders are still being listed; every accessor of
+   * _images goes through waitEnumeration() first.
+   */
+  void enumerateDirectory(const std::string& folder, const std::string& filePattern, const std::regex re);
+
+  /// Block until the background directory enumeration (if any) has completed.
+  void waitEnumeration() const
+  {
+    std::unique_lock<std::mutex> lock(_imagesMutex);
+    _imagesListed.wait(lock, [this]{ return _enumerationDone; });
+  }
+
+  /**
+   * @brief Warm the filesystem cache with the content of the given file, so
+   * the decode of the next frame does not wait on (network) storage.
+   */
+  static void prefetchFile(const std::string& path)
+  {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    char buffer[65536];
+    while(file.read(buffer, sizeof(buffer)))
+      ;
+  }
+
 private:
   static const std::vector<std::string> supportedExtensions;
-  
+
 private:
   bool _isInit;
   bool _withCalibration;
   // It contains the images to be fed
   std::vector<std::string> _images;
   camera::PinholeRadialK3 _camIntrinsics;
-  
+
   bool _sfmMode = false;
   sfmData::SfMData _sfmdata;
   sfmData::Views::const_iterator _viewIterator;
   unsigned int _currentImageIndex = 0;
+
+  mutable std::mutex _imagesMutex;
+  mutable std::condition_variable _imagesListed;
+  bool _enumerationDone = true;
+  std::thread _enumerationThread;
+  std::thread _prefetchThread;
 };
 
 const std::vector<std::string> ImageFeed::FeederImpl::supportedExtensions = {".jpg", ".jpeg", ".png", ".ppm", ".tif", ".tiff", ".exr"};
@@ -237,34 +284,12 @@ ImageFeed::FeederImpl::FeederImpl(const std::string& imagePath, const std::strin
       ALICEVISION_LOG_DEBUG("folder without expression: " << imagePath);
     }
     ALICEVISION_LOG_DEBUG("directory feedImage");
-    // if it is a directory, list all the images and add them to the list
-    bf::directory_iterator iterator(folder);
-    // since some OS will provide the files in a random order, first store them
-    // in a priority queue and then fill the _image queue with the alphabetical
-    // order from the priority queue
-    std::priority_queue<std::string, 
-                    std::vector<std::string>, 
-                    std::greater<std::string> > tmpSorter;
-    for(; iterator != bf::directory_iterator(); ++iterator)
-    {
-      // get the extension of the current file to check whether it is an image
-      const std::string ext = iterator->path().extension().string();
-      if(FeederImpl::isSupported(ext))
-      {
-        const std::string filepath = iterator->path().string();
-        const std::string filename = iterator->path().filename().string();
-        // If we have a filePattern (a sequence of images), we have to match the regex.
-        if(filePattern.empty() || std::regex_match(filename, re))
-          tmpSorter.push(filepath);
-      }
-    }
-    // put all the retrieve files inside the queue
-    while(!tmpSorter.empty())
-    {
-      _images.push_back(tmpSorter.top());
-      tmpSorter.pop();
-    }
-    
+    // if it is a directory, list all the images on a background thread: on
+    // large (network) folders the listing takes minutes, and in the meantime
+    // the caller can finish its own setup (calibration, features, voctree...)
+    _enumerationDone = false;
+    _enumerationThread = std::thread(&FeederImpl::enumerateDirectory, this, folder, filePattern, re);
+
     _withCalibration = !calibPath.empty();
     _sfmMode = false;
     _isInit = true;
@@ -284,14 +309,58 @@ ImageFeed::FeederImpl::FeederImpl(const std::string& imagePath, const std::strin
   }
 }
 
+ImageFeed::FeederImpl::~FeederImpl()
+{
+  if(_enumerationThread.joinable())
+    _enumerationThread.join();
+  if(_prefetchThread.joinable())
+    _prefetchThread.join();
+}
+
+void ImageFeed::FeederImpl::enumerateDirectory(const std::string& folder, const std::string& filePattern, const std::regex re)
+{
+  namespace bf = boost::filesystem;
+
+  // since some OS will provide the files in a random order, first store them
+  // in a priority queue and then fill the _image queue with the alphabetical
+  // order from the priority queue
+  std::priority_queue<std::string,
+                  std::vector<std::string>,
+                  std::greater<std::string> > tmpSorter;
+  for(bf::directory_iterator iterator(folder); iterator != bf::directory_iterator(); ++iterator)
+  {
+    // get the extension of the current file to check whether it is an image
+    const std::string ext = iterator->path().extension().string();
+    if(FeederImpl::isSupported(ext))
+    {
+      const std::string filepath = iterator->path().string();
+      const std::string filename = iterator->path().filename().string();
+      // If we have a filePattern (a sequence of images), we have to match the regex.
+      if(filePattern.empty() || std::regex_match(filename, re))
+        tmpSorter.push(filepath);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(_imagesMutex);
+  // put all the retrieve files inside the queue
+  while(!tmpSorter.empty())
+  {
+    _images.push_back(tmpSorter.top());
+    tmpSorter.pop();
+  }
+  _enumerationDone = true;
+  _imagesListed.notify_all();
+}
+
 std::size_t ImageFeed::FeederImpl::nbFrames() const
 {
   if(!_isInit)
     return 0;
-  
+
   if(_sfmMode)
     return _sfmdata.getViews().size();
-  
+
+  waitEnumeration();
   return _images.size();
 }
 
@@ -319,6 +388,7 @@ bool ImageFeed::FeederImpl::goToFrame(const unsigned int frame)
   }
   else
   {
+    waitEnumeration();
     _currentImageIndex = frame;
     // Image list mode
     if(frame >= _images.size())
@@ -343,6 +413,7 @@ bool ImageFeed::FeederImpl::goToNextFrame()
   }
   else
   {
+    waitEnumeration();
     ++_currentImageIndex;
     ALICEVISION_LOG_DEBUG("next frame " << _currentImageIndex);
     if(_currentImageIndex >= _images.size())
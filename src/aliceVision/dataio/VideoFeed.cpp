@@ -16,6 +16,10 @@
 
 #include <iostream>
 #include <exception>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace aliceVision{
 namespace dataio{
@@ -24,13 +28,15 @@ class VideoFeed::FeederImpl
 {
 public:
   FeederImpl() : _isInit(false) { }
-  
+
   FeederImpl(const std::string &videoPath, const std::string &calibPath);
-  
+
   FeederImpl(int videoDevice, const std::string &calibPath);
-  
+
+  ~FeederImpl();
+
   bool isInit() const {return _isInit;}
-  
+
   bool readImage(image::Image<image::RGBColor> &imageRGB,
                    camera::PinholeRadialK3 &camIntrinsics,
                    std::string &mediaPath,
@@ -40,25 +46,55 @@ public:
                      camera::PinholeRadialK3 &camIntrinsics,
                      std::string &mediaPath,
                      bool &hasIntrinsics);
-  
+
   bool readImage(image::Image<unsigned char> &imageGray,
                      camera::PinholeRadialK3 &camIntrinsics,
                      std::string &mediaPath,
                      bool &hasIntrinsics);
-  
+
   bool goToFrame(const unsigned int frame);
-  
+
   bool goToNextFrame();
-  
+
   std::size_t nbFrames() const;
-  
+
 private:
+
+  /// A frame decoded ahead of time, already converted to the grayscale float
+  /// format the feature extraction wants.
+  struct PrefetchedFrame
+  {
+    image::Image<float> image;
+    /// false marks the end of the stream
+    bool ok = false;
+  };
+
+  /// Start the decoding thread, the current frame must already be grabbed.
+  void startPrefetch();
+  /// Stop and join the decoding thread, drop the frames decoded ahead.
+  void stopPrefetch();
+  /// Decoding thread: retrieve/convert frames into the bounded queue.
+  void decodeLoop();
+
   bool _isInit;
   bool _isLive;
   bool _withIntrinsics;
   std::string _videoPath;
   cv::VideoCapture _videoCapture;
   camera::PinholeRadialK3 _camIntrinsics;
+  std::size_t _nbFrames = 0;
+
+  /// Depth of the prefetch queue: one frame being processed, one being decoded.
+  static const std::size_t _queueCapacity = 2;
+
+  bool _prefetchActive = false;
+  bool _stopDecoding = false;
+  bool _decodeFinished = false;
+  std::deque<PrefetchedFrame> _queue;
+  std::mutex _mutex;
+  std::condition_variable _queueNotEmpty;
+  std::condition_variable _queueNotFull;
+  std::thread _decodeThread;
 };
 
 
@@ -74,6 +110,7 @@ VideoFeed::FeederImpl::FeederImpl(const std::string &videoPath, const std::strin
   }
   // Grab frame 0, so we can call readImage.
   goToFrame(0);
+  _nbFrames = static_cast<std::size_t>(_videoCapture.get(cv::CAP_PROP_FRAME_COUNT));
 
   // load the calibration path
   _withIntrinsics = !calibPath.empty();
@@ -95,7 +132,8 @@ VideoFeed::FeederImpl::FeederImpl(int videoDevice, const std::string &calibPath)
   }
 
   goToNextFrame();
-  
+  _nbFrames = static_cast<std::size_t>(_videoCapture.get(cv::CAP_PROP_FRAME_COUNT));
+
   // load the calibration path
   _withIntrinsics = !calibPath.empty();
   if(_withIntrinsics)
@@ -104,11 +142,89 @@ VideoFeed::FeederImpl::FeederImpl(int videoDevice, const std::string &calibPath)
   _isInit = true;
 }
 
+VideoFeed::FeederImpl::~FeederImpl()
+{
+  stopPrefetch();
+}
+
+void VideoFeed::FeederImpl::startPrefetch()
+{
+  _stopDecoding = false;
+  _decodeFinished = false;
+  _prefetchActive = true;
+  _decodeThread = std::thread(&FeederImpl::decodeLoop, this);
+}
+
+void VideoFeed::FeederImpl::stopPrefetch()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopDecoding = true;
+  }
+  _queueNotFull.notify_all();
+  if(_decodeThread.joinable())
+    _decodeThread.join();
+  _queue.clear();
+  _stopDecoding = false;
+  _decodeFinished = false;
+  _prefetchActive = false;
+}
+
+void VideoFeed::FeederImpl::decodeLoop()
+{
+  // the frame to decode has already been grabbed (by the constructor,
+  // goToFrame() or the previous loop iteration)
+  while(true)
+  {
+    PrefetchedFrame frame;
+    cv::Mat bgrFrame;
+    frame.ok = _videoCapture.retrieve(bgrFrame) && (bgrFrame.data != nullptr);
+    if(frame.ok)
+    {
+      cv::Mat grey;
+      if(bgrFrame.channels() == 3)
+        cv::cvtColor(bgrFrame, grey, cv::COLOR_BGR2GRAY);
+      else
+        grey = bgrFrame;
+
+      image::Image<unsigned char> greyUChar;
+      greyUChar.resize(grey.cols, grey.rows);
+      cv::cv2eigen(grey, greyUChar);
+      frame.image = (greyUChar.GetMat().cast<float>() / 255.f);
+    }
+    const bool endOfStream = !frame.ok;
+
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _queueNotFull.wait(lock, [this]{ return _queue.size() < _queueCapacity || _stopDecoding; });
+      if(_stopDecoding)
+        break;
+      _queue.push_back(std::move(frame));
+    }
+    _queueNotEmpty.notify_all();
+
+    if(endOfStream || !_videoCapture.grab())
+      break;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _decodeFinished = true;
+  }
+  _queueNotEmpty.notify_all();
+}
+
 bool VideoFeed::FeederImpl::readImage(image::Image<image::RGBColor> &imageRGB,
           camera::PinholeRadialK3 &camIntrinsics,
           std::string &mediaPath,
           bool &hasIntrinsics)
 {
+  if(_prefetchActive)
+  {
+    // the decoding thread owns the capture and only keeps grayscale frames
+    throw std::logic_error("Cannot read RGB frames from a video feed once the grayscale prefetch is active : " + _videoPath);
+  }
+
   cv::Mat frame;
   const bool grabStatus = _videoCapture.retrieve(frame);
 
@@ -116,7 +232,7 @@ bool VideoFeed::FeederImpl::readImage(image::Image<image::RGBColor> &imageRGB,
   {
     return false;
   }
-  
+
   if(frame.channels() == 3)
   {
     cv::Mat color;
@@ -154,6 +270,32 @@ bool VideoFeed::FeederImpl::readImage(image::Image<float> &imageGray,
           std::string &mediaPath,
           bool &hasIntrinsics)
 {
+  // Decode ahead of the caller: the decoding thread fills a bounded queue of
+  // frames already converted to grayscale float, so the decode and conversion
+  // of the next frames overlap the processing of the current one.
+  // A live feed stays synchronous to not add latency to the capture.
+  if(!_isLive && !_prefetchActive)
+    startPrefetch();
+
+  if(_prefetchActive)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _queueNotEmpty.wait(lock, [this]{ return !_queue.empty() || _decodeFinished; });
+    if(_queue.empty() || !_queue.front().ok)
+      return false;
+
+    // the frame stays at the front of the queue until goToNextFrame(),
+    // so consecutive reads of the current frame keep working
+    imageGray = _queue.front().image;
+
+    hasIntrinsics = _withIntrinsics;
+    if(_withIntrinsics)
+      camIntrinsics = _camIntrinsics;
+
+    mediaPath = _videoPath;
+    return true;
+  }
+
   image::Image<unsigned char> imageGrayUChar;
   if(FeederImpl::readImage(imageGrayUChar, camIntrinsics, mediaPath, hasIntrinsics))
   {
@@ -169,6 +311,23 @@ bool VideoFeed::FeederImpl::readImage(image::Image<unsigned char> &imageGray,
                    std::string &mediaPath,
                    bool &hasIntrinsics)
 {
+  if(_prefetchActive)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _queueNotEmpty.wait(lock, [this]{ return !_queue.empty() || _decodeFinished; });
+    if(_queue.empty() || !_queue.front().ok)
+      return false;
+
+    imageGray = ((_queue.front().image.GetMat() * 255.f).array() + 0.5f).matrix().cast<unsigned char>();
+
+    hasIntrinsics = _withIntrinsics;
+    if(_withIntrinsics)
+      camIntrinsics = _camIntrinsics;
+
+    mediaPath = _videoPath;
+    return true;
+  }
+
   cv::Mat frame;
   const bool grabStatus = _videoCapture.retrieve(frame);
 
@@ -176,7 +335,7 @@ bool VideoFeed::FeederImpl::readImage(image::Image<unsigned char> &imageGray,
   {
     return false;
   }
-  
+
   if(frame.channels() == 3)
   {
     // convert to gray
@@ -202,19 +361,24 @@ bool VideoFeed::FeederImpl::readImage(image::Image<unsigned char> &imageGray,
 
 std::size_t VideoFeed::FeederImpl::nbFrames() const
 {
-  if (!_videoCapture.isOpened())
-    return 0;
-  return _videoCapture.get(cv::CAP_PROP_FRAME_COUNT);
+  // cached at construction: the capture is owned by the decoding thread
+  // once the prefetch is active
+  return _nbFrames;
 }
 
 bool VideoFeed::FeederImpl::goToFrame(const unsigned int frame)
 {
+  // a random seek invalidates the frames decoded ahead,
+  // the prefetch restarts from the new position on the next read
+  if(_prefetchActive)
+    stopPrefetch();
+
   if (!_videoCapture.isOpened())
   {
     ALICEVISION_LOG_WARNING("We cannot open the video file.");
     return false;
   }
-  
+
   if(_isLive)
     return goToNextFrame();
   
@@ -234,6 +398,26 @@ bool VideoFeed::FeederImpl::goToFrame(const unsigned int frame)
 
 bool VideoFeed::FeederImpl::goToNextFrame()
 {
+  if(_prefetchActive)
+  {
+    bool popped = false;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if(!_queue.empty())
+      {
+        _queue.pop_front();
+        popped = true;
+      }
+    }
+    if(popped)
+      _queueNotFull.notify_all();
+
+    // report whether a next frame exists, as the synchronous grab() did
+    std::unique_lock<std::mutex> lock(_mutex);
+    _queueNotEmpty.wait(lock, [this]{ return !_queue.empty() || _decodeFinished; });
+    return !_queue.empty() && _queue.front().ok;
+  }
+
   return _videoCapture.grab();
 }
 
@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "DepthSimMap.hpp"
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
@@ -48,6 +49,11 @@ void DepthSimMap::add11(DepthSimMap* depthSimMap)
     if((depthSimMap->step * depthSimMap->scale) % 2 == 0)
         k -= 1;
 
+    // with a 1x1 footprint each input cell touches exactly one output cell,
+    // so the loop can run in parallel; larger footprints overlap between cells
+    const bool pixelWise = (depthSimMap->step * depthSimMap->scale == 1);
+
+#pragma omp parallel for if(pixelWise)
     for(int i = 0; i < depthSimMap->dsm->size(); i++)
     {
         int x = (i % depthSimMap->w) * depthSimMap->step * depthSimMap->scale;
@@ -94,6 +100,7 @@ void DepthSimMap::add(DepthSimMap* depthSimMap)
         throw std::runtime_error("Error DepthSimMap: You can only add to the same scale and step map.");
     }
 
+#pragma omp parallel for
     for(int i = 0; i < dsm->size(); i++)
     {
         DepthSim depthSim1 = (*dsm)[i];
@@ -110,6 +117,7 @@ Point2d DepthSimMap::getMaxMinDepth() const
 {
     float maxDepth = -1.0f;
     float minDepth = std::numeric_limits<float>::max();
+#pragma omp parallel for reduction(max: maxDepth) reduction(min: minDepth)
     for(int j = 0; j < w * h; j++)
     {
         if((*dsm)[j].depth > -1.0f)
@@ -125,6 +133,7 @@ Point2d DepthSimMap::getMaxMinSim() const
 {
     float maxSim = -1.0f;
     float minSim = std::numeric_limits<float>::max();
+#pragma omp parallel for reduction(max: maxSim) reduction(min: minSim)
     for(int j = 0; j < w * h; j++)
     {
         if((*dsm)[j].sim > -1.0f)
@@ -176,17 +185,21 @@ StaticVector<float>* DepthSimMap::getDepthMapStep1()
     depthMap->reserve(wdm * hdm);
     depthMap->resize_with(wdm * hdm, -1.0f);
 
-    for(int i = 0; i < wdm * hdm; i++)
+    // deinterleave row by row: the source row is shared by "step" output rows
+    // and the output row is written contiguously
+#pragma omp parallel for
+    for(int yp = 0; yp < hdm; yp++)
     {
-        int x = (i % wdm) / step;
-        int y = (i / wdm) / step;
-        if((x < w) && (y < h))
-        {
-			// dsm size: (width, height) / (scale*step)
-            float depth = (*dsm)[y * w + x].depth;
-			// depthMap size: (width, height) / scale
-            (*depthMap)[i] = depth;
-        }
+        const int y = yp / step;
+        if(y >= h)
+            continue;
+		// dsm size: (width, height) / (scale*step)
+        const DepthSim* dsmRow = &(*dsm)[y * w];
+		// depthMap size: (width, height) / scale
+        float* dstRow = &(*depthMap)[yp * wdm];
+        const int wStop = std::min(wdm, w * step);
+        for(int xp = 0; xp < wStop; xp++)
+            dstRow[xp] = dsmRow[xp / step].depth;
     }
 
     return depthMap;
@@ -200,15 +213,17 @@ StaticVector<float>* DepthSimMap::getSimMapStep1()
     StaticVector<float>* simMap = new StaticVector<float>();
     simMap->reserve(wdm * hdm);
     simMap->resize_with(wdm * hdm, -1.0f);
-    for(int i = 0; i < wdm * hdm; i++)
+#pragma omp parallel for
+    for(int yp = 0; yp < hdm; yp++)
     {
-        int x = (i % wdm) / step;
-        int y = (i / wdm) / step;
-        if((x < w) && (y < h))
-        {
-            float sim = (*dsm)[y * w + x].sim;
-            (*simMap)[i] = sim;
-        }
+        const int y = yp / step;
+        if(y >= h)
+            continue;
+        const DepthSim* dsmRow = &(*dsm)[y * w];
+        float* dstRow = &(*simMap)[yp * wdm];
+        const int wStop = std::min(wdm, w * step);
+        for(int xp = 0; xp < wStop; xp++)
+            dstRow[xp] = dsmRow[xp / step].sim;
     }
 
     return simMap;
@@ -222,17 +237,19 @@ StaticVector<float>* DepthSimMap::getDepthMapStep1XPart(int xFrom, int partW)
     StaticVector<float>* depthMap = new StaticVector<float>();
     depthMap->reserve(wdm * hdm);
     depthMap->resize_with(wdm * hdm, -1.0f);
+#pragma omp parallel for
     for(int yp = 0; yp < hdm; yp++)
     {
+        const int y = yp / step;
+        if(y >= h)
+            continue;
+        const DepthSim* dsmRow = &(*dsm)[y * w];
+        float* dstRow = &(*depthMap)[yp * partW];
         for(int xp = xFrom; xp < xFrom + partW; xp++)
         {
-            int x = xp / step;
-            int y = yp / step;
-            if((x < w) && (y < h))
-            {
-                float depth = (*dsm)[y * w + x].depth;
-                (*depthMap)[yp * partW + (xp - xFrom)] = depth;
-            }
+            const int x = xp / step;
+            if(x < w)
+                dstRow[xp - xFrom] = dsmRow[x].depth;
         }
     }
 
@@ -247,17 +264,19 @@ StaticVector<float>* DepthSimMap::getSimMapStep1XPart(int xFrom, int partW)
     StaticVector<float>* simMap = new StaticVector<float>();
     simMap->reserve(wdm * hdm);
     simMap->resize_with(wdm * hdm, -1.0f);
+#pragma omp parallel for
     for(int yp = 0; yp < hdm; yp++)
     {
+        const int y = yp / step;
+        if(y >= h)
+            continue;
+        const DepthSim* dsmRow = &(*dsm)[y * w];
+        float* dstRow = &(*simMap)[yp * partW];
         for(int xp = xFrom; xp < xFrom + partW; xp++)
         {
-            int x = xp / step;
-            int y = yp / step;
-            if((x < w) && (y < h))
-            {
-                float sim = (*dsm)[y * w + x].sim;
-                (*simMap)[yp * partW + (xp - xFrom)] = sim;
-            }
+            const int x = xp / step;
+            if(x < w)
+                dstRow[xp - xFrom] = dsmRow[x].sim;
         }
     }
 
@@ -268,14 +287,17 @@ void DepthSimMap::initJustFromDepthMapT(StaticVector<float>* depthMapT, float de
 {
     int hdm = mp->getHeight(rc) / scale;
 
-    for(int i = 0; i < dsm->size(); i++)
+#pragma omp parallel for
+    for(int r = 0; r < h; r++)
     {
-        int x = (i % w) * step;
-        int y = (i / w) * step;
-        if((x < w) && (y < h))
+        const int y = r * step;
+        if(y >= h)
+            continue;
+        DepthSim* dsmRow = &(*dsm)[r * w];
+        for(int c = 0; c * step < w; c++)
         {
-            (*dsm)[i].depth = (*depthMapT)[x * hdm + y];
-            (*dsm)[i].sim = defaultSim;
+            dsmRow[c].depth = (*depthMapT)[(c * step) * hdm + y];
+            dsmRow[c].sim = defaultSim;
         }
     }
 }
@@ -284,14 +306,18 @@ void DepthSimMap::initJustFromDepthMap(StaticVector<float>* depthMap, float defa
 {
     int wdm = mp->getWidth(rc) / scale;
 
-    for(int i = 0; i < dsm->size(); i++)
+#pragma omp parallel for
+    for(int r = 0; r < h; r++)
     {
-        int x = (i % w) * step;
-        int y = (i / w) * step;
-        if((x < w) && (y < h))
+        const int y = r * step;
+        if(y >= h)
+            continue;
+        DepthSim* dsmRow = &(*dsm)[r * w];
+        const float* srcRow = &(*depthMap)[y * wdm];
+        for(int c = 0; c * step < w; c++)
         {
-            (*dsm)[i].depth = (*depthMap)[y * wdm + x];
-            (*dsm)[i].sim = defaultSim;
+            dsmRow[c].depth = srcRow[c * step];
+            dsmRow[c].sim = defaultSim;
         }
     }
 }
@@ -302,14 +328,21 @@ void DepthSimMap::initFromDepthMapTAndSimMapT(StaticVector<float>* depthMapT, St
     int wdm = mp->getWidth(rc) / depthSimMapsScale;
     int hdm = mp->getHeight(rc) / depthSimMapsScale;
 
-    for(int i = 0; i < dsm->size(); i++)
+#pragma omp parallel for
+    for(int r = 0; r < h; r++)
     {
-        int x = (((i % w) * step) * scale) / depthSimMapsScale;
-        int y = (((i / w) * step) * scale) / depthSimMapsScale;
-        if((x < wdm) && (y < hdm))
+        const int y = ((r * step) * scale) / depthSimMapsScale;
+        if(y >= hdm)
+            continue;
+        DepthSim* dsmRow = &(*dsm)[r * w];
+        for(int c = 0; c < w; c++)
         {
-            (*dsm)[i].depth = (*depthMapT)[x * hdm + y];
-            (*dsm)[i].sim = (*simMapT)[x * hdm + y];
+            const int x = ((c * step) * scale) / depthSimMapsScale;
+            if(x < wdm)
+            {
+                dsmRow[c].depth = (*depthMapT)[x * hdm + y];
+                dsmRow[c].sim = (*simMapT)[x * hdm + y];
+            }
         }
     }
 }
@@ -322,15 +355,17 @@ StaticVector<float>* DepthSimMap::getDepthMapTStep1()
     StaticVector<float>* depthMap = new StaticVector<float>();
     depthMap->reserve(wdm * hdm);
     depthMap->resize_with(wdm * hdm, -1.0f);
-    for(int i = 0; i < wdm * hdm; i++)
+    // the transposed map is written one contiguous column block at a time
+#pragma omp parallel for
+    for(int xp = 0; xp < wdm; xp++)
     {
-        int x = (i / hdm) / step;
-        int y = (i % hdm) / step;
-        if((x < w) && (y < h))
-        {
-            float depth = (*dsm)[y * w + x].depth;
-            (*depthMap)[i] = depth;
-        }
+        const int x = xp / step;
+        if(x >= w)
+            continue;
+        float* dstCol = &(*depthMap)[xp * hdm];
+        const int hStop = std::min(hdm, h * step);
+        for(int yp = 0; yp < hStop; yp++)
+            dstCol[yp] = (*dsm)[(yp / step) * w + x].depth;
     }
 
     return depthMap;
@@ -339,10 +374,11 @@ StaticVector<float>* DepthSimMap::getDepthMapTStep1()
 StaticVector<float>* DepthSimMap::getDepthMap()
 {
     StaticVector<float>* depthMap = new StaticVector<float>();
-    depthMap->reserve(dsm->size());
+    depthMap->resize(dsm->size());
+#pragma omp parallel for
     for(int i = 0; i < dsm->size(); i++)
     {
-        depthMap->push_back((*dsm)[i].depth);
+        (*depthMap)[i] = (*dsm)[i].depth;
     }
     return depthMap;
 }
@@ -409,8 +445,12 @@ void DepthSimMap::save(int rc, const StaticVector<int>& tcams)
         metadata.push_back(oiio::ParamValue("AliceVision:P", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44), 1, matrixP.data()));
     }
 
-    imageIO::writeImage(getFileNameFromIndex(mp, rc, mvsUtils::EFileType::depthMap, scale), width, height, depthMap->getDataWritable(), imageIO::EImageQuality::LOSSLESS, metadata);
-    imageIO::writeImage(getFileNameFromIndex(mp, rc, mvsUtils::EFileType::simMap, scale), width, height, simMap->getDataWritable());
+    // encode in the background, the maps are moved into the write queue
+    imageIO::writeImageAsync(getFileNameFromIndex(mp, rc, mvsUtils::EFileType::depthMap, scale), width, height, std::move(depthMap->getDataWritable()), imageIO::EImageQuality::LOSSLESS, metadata);
+    imageIO::writeImageAsync(getFileNameFromIndex(mp, rc, mvsUtils::EFileType::simMap, scale), width, height, std::move(simMap->getDataWritable()));
+
+    delete depthMap;
+    delete simMap;
 
     {
         // TODO: write max & min depth in depth maps metadata.
@@ -446,10 +486,12 @@ void DepthSimMap::saveRefine(int rc, std::string depthMapFileName, std::string s
     std::vector<float> depthMap(size);
     std::vector<float> simMap(size);
 
+    // deinterleave into the planar buffers expected by the image writer
+#pragma omp parallel for
     for(int i = 0; i < dsm->size(); ++i)
     {
-        depthMap.at(i) = (*dsm)[i].depth;
-        simMap.at(i) = (*dsm)[i].sim;
+        depthMap[i] = (*dsm)[i].depth;
+        simMap[i] = (*dsm)[i].sim;
     }
 
     oiio::ParamValueList metadata = imageIO::getMetadataFromMap(mp->getMetadata(rc));
@@ -462,8 +504,9 @@ void DepthSimMap::saveRefine(int rc, std::string depthMapFileName, std::string s
         metadata.push_back(oiio::ParamValue("AliceVision:P", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44), 1, matrixP.data()));
     }
 
-    imageIO::writeImage(depthMapFileName, width, height, depthMap, imageIO::EImageQuality::LOSSLESS, metadata);
-    imageIO::writeImage(simMapFileName, width, height, simMap);
+    // encode in the background, the maps are moved into the write queue
+    imageIO::writeImageAsync(depthMapFileName, width, height, std::move(depthMap), imageIO::EImageQuality::LOSSLESS, metadata);
+    imageIO::writeImageAsync(simMapFileName, width, height, std::move(simMap));
 }
 
 float DepthSimMap::getCellSmoothStep(int rc, const int cellId)
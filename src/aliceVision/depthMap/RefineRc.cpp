@@ -6,6 +6,8 @@
 
 #include "RefineRc.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Telemetry.hpp>
+#include <aliceVision/system/nvtx.hpp>
 #include <aliceVision/gpu/gpu.hpp>
 
 #include <aliceVision/mvsData/Point2d.hpp>
@@ -108,6 +110,24 @@ DepthSimMap* RefineRc::refineAndFuseDepthSimMapCUDA(DepthSimMap* depthPixSizeMap
     int w11 = sp->mp->getWidth(rc);
     int h11 = sp->mp->getHeight(rc);
 
+    // start decoding the target images in the background, they are needed one
+    // after the other when the cameras are uploaded to the GPU
+    sp->cps._ic.prefetchImages(tcams);
+
+    if(!sp->visualizePartialDepthMaps)
+    {
+        // fused path: the per-tc refined maps stay resident on the GPU, only the
+        // depth/pixSize map is uploaded and the fused map downloaded
+        DepthSimMap* depthSimMapFused = new DepthSimMap(rc, sp->mp, 1, 1);
+        sp->cps.refineAndFuseDepthSimMapsGaussianKernelVoting(_userTcOrPixSize, _ndepthsToRefine,
+                                                              depthSimMapFused->dsm, depthPixSizeMapVis->dsm, rc, tcams,
+                                                              1, _wsh, _gammaC, _gammaP, 0.0f, _nSamplesHalf,
+                                                              _ndepthsToRefine, _sigma);
+        return depthSimMapFused;
+    }
+
+    // per-tc host path, kept for the partial depth map visualization
+
     StaticVector<DepthSimMap*>* dataMaps = new StaticVector<DepthSimMap*>();
     dataMaps->reserve(tcams.size() + 1);
     dataMaps->push_back(depthPixSizeMapVis); //!!DO NOT ERASE!!!
@@ -259,6 +279,10 @@ bool RefineRc::refinercCUDA(bool checkIfExists)
         return false;
     }
 
+    // rc level range, the GPU phases nest under it in the profiler timeline
+    const NvtxScope nvtxScope("refinercCUDA rc=" + std::to_string(rc));
+    const system::Telemetry::ScopedTimer telemetryTimer("refine");
+
     long tall = clock();
 
     DepthSimMap* depthPixSizeMapVis = getDepthPixSizeMapFromSGM();
@@ -307,7 +331,7 @@ bool RefineRc::refinercCUDA(bool checkIfExists)
     return true;
 }
 
-void refineDepthMaps(int CUDADeviceNo, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams)
+void refineDepthMaps(int CUDADeviceNo, mvsUtils::ImagesCache& ic, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams)
 {
     const int fileScale = 1; // input images scale (should be one)
     int sgmScale = mp->userParams.get<int>("semiGlobalMatching.scale", -1);
@@ -324,8 +348,6 @@ void refineDepthMaps(int CUDADeviceNo, mvsUtils::MultiViewParams* mp, const Stat
         ALICEVISION_LOG_INFO("PSSGM autoScaleStep scale: " << sgmScale << ", step: " << sgmStep);
     }
 
-    int bandType = 0;
-    mvsUtils::ImagesCache ic(mp, bandType, true);
     PlaneSweepingCuda cps(CUDADeviceNo, ic, mp, sgmScale);
     SemiGlobalMatchingParams sp(mp, cps);
 
@@ -354,12 +376,18 @@ void refineDepthMaps(mvsUtils::MultiViewParams* mp, const StaticVector<int>& cam
         numthreads = num_gpus_to_use;
     }
 
+    const int bandType = 0;
+
+    // load images from files into RAM, the cache is shared by all the GPU threads
+    // (its in-memory images are protected by per-image mutexes)
+    mvsUtils::ImagesCache ic(mp, bandType, true);
+
     if(numthreads == 1)
     {
         // The GPU sorting is determined by an environment variable named CUDA_DEVICE_ORDER
         // Possible values: FASTEST_FIRST (default) or PCI_BUS_ID
         const int CUDADeviceNo = 0;
-        refineDepthMaps(CUDADeviceNo, mp, cams);
+        refineDepthMaps(CUDADeviceNo, ic, mp, cams);
     }
     else
     {
@@ -382,9 +410,12 @@ void refineDepthMaps(mvsUtils::MultiViewParams* mp, const StaticVector<int>& cam
             {
                 subcams.push_back(cams[rc]);
             }
-            refineDepthMaps(cpu_thread_id, mp, subcams);
+            refineDepthMaps(cpu_thread_id, ic, mp, subcams);
         }
     }
+
+    // wait until the background depth/sim map writes have landed
+    imageIO::flushImageWrites();
 }
 
 } // namespace depthMap
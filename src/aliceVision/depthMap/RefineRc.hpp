@@ -38,7 +38,7 @@ private:
 };
 
 void refineDepthMaps(mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams);
-void refineDepthMaps(int CUDADeviceNo, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams);
+void refineDepthMaps(int CUDADeviceNo, mvsUtils::ImagesCache& ic, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams);
 
 } // namespace depthMap
 } // namespace aliceVision
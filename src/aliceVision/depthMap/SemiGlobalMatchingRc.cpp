@@ -6,6 +6,8 @@
 
 #include "SemiGlobalMatchingRc.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Telemetry.hpp>
+#include <aliceVision/system/nvtx.hpp>
 #include <aliceVision/gpu/gpu.hpp>
 
 #include <aliceVision/depthMap/SemiGlobalMatchingRcTc.hpp>
@@ -58,7 +60,22 @@ SemiGlobalMatchingRc::SemiGlobalMatchingRc(bool doComputeDepthsAndResetTCams, in
 
     if(doComputeDepthsAndResetTCams)
     {
-        computeDepthsAndResetTCams();
+        // reuse the depth candidates persisted by a previous run, recomputing
+        // them triangulates the epipolar depths against every target camera
+        if(mvsUtils::FileExists(tcamsFileName) && mvsUtils::FileExists(depthsFileName) && mvsUtils::FileExists(depthsTcamsLimitsFileName))
+        {
+            loadArrayFromFile<int>( tcams, tcamsFileName, true);
+            depths = loadArrayFromFile<float>(depthsFileName);
+            loadArrayFromFile<Pixel>( depthsTcamsLimits,  depthsTcamsLimitsFileName );
+        }
+        else
+        {
+            computeDepthsAndResetTCams();
+            // persist before the volume sweep so an interrupted run can reload
+            saveArrayToFile<float>(depthsFileName, depths);
+            saveArrayToFile<int>(tcamsFileName, tcams);
+            saveArrayToFile<Pixel>(depthsTcamsLimitsFileName, depthsTcamsLimits);
+        }
     }
     else
     {
@@ -478,6 +495,77 @@ void SemiGlobalMatchingRc::getSubDepthsForTCam( int tcamid, std::vector<float>&
     }
 }
 
+StaticVector<IdValue>* SemiGlobalMatchingRc::computeTileBestIdVal(int tileLUX, int tileLUY, int tileW, int tileH,
+                                                                  StaticVectorBool* rcSilhoueteMap, int zborder)
+{
+    const int volDimX = tileW;
+    const int volDimY = tileH;
+    const int volDimZ = depths->size();
+    float volumeMBinGPUMem = 0.0f;
+
+    StaticVector<unsigned char>* simVolume = nullptr;
+
+    // pipelined sweeps: the GPU computes the similarity volume of the next target
+    // camera while the host merges the previous one into the global volume
+    SemiGlobalMatchingRcTc* srt = nullptr;
+    {
+        std::vector<float> subDepths;
+        getSubDepthsForTCam(0, subDepths);
+        srt = new SemiGlobalMatchingRcTc(subDepths, rc, tcams[0], scale, step, tileLUX, tileLUY, tileW, tileH, sp, rcSilhoueteMap);
+        srt->computeDepthSimMapVolumeStart(volumeMBinGPUMem, wsh, gammaC, gammaP);
+    }
+
+    SemiGlobalMatchingVolume* svol = nullptr;
+
+    for(int c = 0; c < tcams.size(); c++)
+    {
+        simVolume = srt->computeDepthSimMapVolumeFinish();
+        delete srt;
+        srt = nullptr;
+
+        if(c == 0)
+        {
+            // recompute to all depths
+            volumeMBinGPUMem = ((volumeMBinGPUMem / (float)depthsTcamsLimits[0].y) * (float)volDimZ);
+
+            svol = new SemiGlobalMatchingVolume(volumeMBinGPUMem, volDimX, volDimY, volDimZ, sp);
+        }
+
+        // start the sweep of the next target camera before the host-side merge below
+        if(c + 1 < tcams.size())
+        {
+            float nextVolumeMBinGPUMem = 0.0f;
+            std::vector<float> subDepths;
+            getSubDepthsForTCam(c + 1, subDepths);
+            srt = new SemiGlobalMatchingRcTc(subDepths, rc, tcams[c + 1], scale, step, tileLUX, tileLUY, tileW, tileH, sp, rcSilhoueteMap);
+            srt->computeDepthSimMapVolumeStart(nextVolumeMBinGPUMem, wsh, gammaC, gammaP);
+        }
+
+        if(c == 0)
+            svol->copyVolume(simVolume, depthsTcamsLimits[0].x, depthsTcamsLimits[0].y);
+        else
+            svol->addVolumeSecondMin(simVolume,depthsTcamsLimits[c].x,depthsTcamsLimits[c].y);
+        delete simVolume;
+    }
+
+    // Reduction of 'volume' (X, Y, Z) into 'volumeStepZ' (X, Y, Z/step)
+    svol->cloneVolumeSecondStepZ();
+
+    // Filter on the 3D volume to weight voxels based on their neighborhood strongness.
+    // So it downweights local minimums that are not supported by their neighborhood.
+    if(sp->doSGMoptimizeVolume) // this is here for experimental reason ... to show how SGGC work on non
+                                // optimized depthmaps ... it must equals to true in normal case
+    {
+        svol->SGMoptimizeVolumeStepZ(rc, step, tileLUX * step, tileLUY * step, scale);
+    }
+
+    // For each pixel: choose the voxel with the minimal similarity value
+    StaticVector<IdValue>* volumeBestIdVal = svol->getOrigVolumeBestIdValFromVolumeStepZ(zborder);
+    delete svol;
+
+    return volumeBestIdVal;
+}
+
 bool SemiGlobalMatchingRc::sgmrc(bool checkIfExists)
 {
     if(sp->mp->verbose)
@@ -493,14 +581,15 @@ bool SemiGlobalMatchingRc::sgmrc(bool checkIfExists)
         return false;
     }
 
-    long tall = clock();
+    // rc level range, the GPU phases nest under it in the profiler timeline
+    const NvtxScope nvtxScope("sgmrc rc=" + std::to_string(rc));
+    const system::Telemetry::ScopedTimer telemetryTimer("sgm");
 
-    const int volDimX = w;
-    const int volDimY = h;
-    const int volDimZ = depths->size();
-    float volumeMBinGPUMem = 0.0f;
+    long tall = clock();
 
-    StaticVector<unsigned char>* simVolume = nullptr;
+    // announce the target cameras so that image cache misses load in the background
+    // while the depth list is computed
+    sp->cps._ic.prefetchImages(tcams);
 
     StaticVectorBool* rcSilhoueteMap = nullptr;
     if(sp->useSilhouetteMaskCodedByColor)
@@ -511,46 +600,82 @@ bool SemiGlobalMatchingRc::sgmrc(bool checkIfExists)
         sp->cps.getSilhoueteMap(rcSilhoueteMap, scale, step, sp->silhouetteMaskColor, rc);
     }
 
+    // tiled sweeps keep only one tile of the similarity volume in GPU memory,
+    // allowing depth maps at scales whose full volume would not fit
+    const int tileDim = sp->mp->userParams.get<int>("semiGlobalMatching.tileDim", 0);
+    const int tileOverlap = std::max(2, sp->mp->userParams.get<int>("semiGlobalMatching.tileOverlap", 64));
+
+    const int zborder = 2;
+    StaticVector<IdValue>* volumeBestIdVal = nullptr;
+
+    if((tileDim <= 0) || ((w <= tileDim) && (h <= tileDim)))
     {
-        std::vector<float> subDepths;
-        getSubDepthsForTCam(0, subDepths);
-        SemiGlobalMatchingRcTc srt(subDepths, rc, tcams[0], scale, step, sp, rcSilhoueteMap);
-        simVolume = srt.computeDepthSimMapVolume(volumeMBinGPUMem, wsh, gammaC, gammaP);
+        volumeBestIdVal = computeTileBestIdVal(0, 0, w, h, rcSilhoueteMap, zborder);
     }
+    else
+    {
+        if(tileDim <= tileOverlap)
+            throw std::runtime_error("Error SemiGlobalMatchingRc: semiGlobalMatching.tileDim must be larger than semiGlobalMatching.tileOverlap.");
 
-    // recompute to all depths
-    volumeMBinGPUMem = ((volumeMBinGPUMem / (float)depthsTcamsLimits[0].y) * (float)volDimZ);
+        // tile origins, the last tile of each dimension is shifted back to end at the image border
+        const int tileStep = tileDim - tileOverlap;
+        std::vector<int> tileLUXs;
+        std::vector<int> tileLUYs;
+        for(int x = 0;; x += tileStep)
+        {
+            if(x + tileDim >= w)
+            {
+                tileLUXs.push_back(std::max(0, w - tileDim));
+                break;
+            }
+            tileLUXs.push_back(x);
+        }
+        for(int y = 0;; y += tileStep)
+        {
+            if(y + tileDim >= h)
+            {
+                tileLUYs.push_back(std::max(0, h - tileDim));
+                break;
+            }
+            tileLUYs.push_back(y);
+        }
 
-    SemiGlobalMatchingVolume* svol = new SemiGlobalMatchingVolume(volumeMBinGPUMem, volDimX, volDimY, volDimZ, sp);
-    svol->copyVolume(simVolume, depthsTcamsLimits[0].x, depthsTcamsLimits[0].y);
-    delete simVolume;
+        ALICEVISION_LOG_INFO("sgmrc: tiled sweep of rc " << rc << ": " << tileLUXs.size() << "x" << tileLUYs.size()
+                                                         << " tiles of " << tileDim << "x" << tileDim
+                                                         << " with overlap " << tileOverlap);
 
-    for(int c = 1; c < tcams.size(); c++)
-    {
-        std::vector<float> subDepths;
-        getSubDepthsForTCam(c, subDepths);
-        SemiGlobalMatchingRcTc* srt = new SemiGlobalMatchingRcTc(subDepths, rc, tcams[c], scale, step, sp, rcSilhoueteMap);
-        simVolume = srt->computeDepthSimMapVolume(volumeMBinGPUMem, wsh, gammaC, gammaP);
-        delete srt;
-        svol->addVolumeSecondMin(simVolume,depthsTcamsLimits[c].x,depthsTcamsLimits[c].y);
-        delete simVolume;
-    }
+        volumeBestIdVal = new StaticVector<IdValue>();
+        volumeBestIdVal->reserve(w * h);
+        volumeBestIdVal->resize_with(w * h, IdValue(-1, 1.0f));
 
-    // Reduction of 'volume' (X, Y, Z) into 'volumeStepZ' (X, Y, Z/step)
-    svol->cloneVolumeSecondStepZ();
+        for(const int tileLUY : tileLUYs)
+        {
+            for(const int tileLUX : tileLUXs)
+            {
+                const int tileW = std::min(tileDim, w);
+                const int tileH = std::min(tileDim, h);
 
-    // Filter on the 3D volume to weight voxels based on their neighborhood strongness.
-    // So it downweights local minimums that are not supported by their neighborhood.
-    if(sp->doSGMoptimizeVolume) // this is here for experimental reason ... to show how SGGC work on non
-                                // optimized depthmaps ... it must equals to true in normal case
-    {
-        svol->SGMoptimizeVolumeStepZ(rc, step, 0, 0, scale);
-    }
+                StaticVector<IdValue>* tileBestIdVal = computeTileBestIdVal(tileLUX, tileLUY, tileW, tileH, rcSilhoueteMap, zborder);
 
-    // For each pixel: choose the voxel with the minimal similarity value
-    int zborder = 2;
-    StaticVector<IdValue>* volumeBestIdVal = svol->getOrigVolumeBestIdValFromVolumeStepZ(zborder);
-    delete svol;
+                // stitch the inner part of the tile, each half of an overlap band
+                // belongs to the tile whose center is closest to it
+                const int xBegin = (tileLUX == 0) ? 0 : tileOverlap / 2;
+                const int xEnd = (tileLUX + tileW == w) ? tileW : tileW - (tileOverlap - tileOverlap / 2);
+                const int yBegin = (tileLUY == 0) ? 0 : tileOverlap / 2;
+                const int yEnd = (tileLUY + tileH == h) ? tileH : tileH - (tileOverlap - tileOverlap / 2);
+
+                for(int y = yBegin; y < yEnd; y++)
+                {
+                    for(int x = xBegin; x < xEnd; x++)
+                    {
+                        (*volumeBestIdVal)[(tileLUY + y) * w + (tileLUX + x)] = (*tileBestIdVal)[y * tileW + x];
+                    }
+                }
+
+                delete tileBestIdVal;
+            }
+        }
+    }
 
     if(rcSilhoueteMap != nullptr)
     {
@@ -592,10 +717,10 @@ bool SemiGlobalMatchingRc::sgmrc(bool checkIfExists)
         for(int i = 0; i < volumeBestIdVal->size(); i++)
             volumeBestId.at(i) = std::max(0, (*volumeBestIdVal)[i].id);
 
-        imageIO::writeImage(SGM_idDepthMapFileName, volDimX, volDimY, volumeBestId);
+        imageIO::writeImage(SGM_idDepthMapFileName, w, h, volumeBestId);
 
         if(sp->visualizeDepthMaps)
-            imageIO::writeImageScaledColors("visualize_" + SGM_idDepthMapFileName, volDimX, volDimY, 0, depths->size(), volumeBestId.data(), true);
+            imageIO::writeImageScaledColors("visualize_" + SGM_idDepthMapFileName, w, h, 0, depths->size(), volumeBestId.data(), true);
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -615,7 +740,7 @@ bool SemiGlobalMatchingRc::sgmrc(bool checkIfExists)
     return true;
 }
 
-void computeDepthMapsPSSGM(int CUDADeviceNo, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams)
+void computeDepthMapsPSSGM(int CUDADeviceNo, mvsUtils::ImagesCache& ic, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams)
 {
     const int fileScale = 1; // input images scale (should be one)
     int sgmScale = mp->userParams.get<int>("semiGlobalMatching.scale", -1);
@@ -633,10 +758,6 @@ void computeDepthMapsPSSGM(int CUDADeviceNo, mvsUtils::MultiViewParams* mp, cons
         ALICEVISION_LOG_INFO("PSSGM autoScaleStep: scale: " << sgmScale << ", step: " << sgmStep);
     }
 
-    const int bandType = 0;
-    
-    // load images from files into RAM 
-    mvsUtils::ImagesCache ic(mp, bandType, true);
     // load stuff on GPU memory and creates multi-level images and computes gradients
     PlaneSweepingCuda cps(CUDADeviceNo, ic, mp, sgmScale);
     // init plane sweeping parameters
@@ -673,12 +794,18 @@ void computeDepthMapsPSSGM(mvsUtils::MultiViewParams* mp, const StaticVector<int
         numthreads = num_gpus_to_use;
     }
 
+    const int bandType = 0;
+
+    // load images from files into RAM, the cache is shared by all the GPU threads
+    // (its in-memory images are protected by per-image mutexes)
+    mvsUtils::ImagesCache ic(mp, bandType, true);
+
     if(numthreads == 1)
     {
         // The GPU sorting is determined by an environment variable named CUDA_DEVICE_ORDER
         // Possible values: FASTEST_FIRST (default) or PCI_BUS_ID
         const int CUDADeviceNo = 0;
-        computeDepthMapsPSSGM(CUDADeviceNo, mp, cams);
+        computeDepthMapsPSSGM(CUDADeviceNo, ic, mp, cams);
     }
     else
     {
@@ -701,7 +828,7 @@ void computeDepthMapsPSSGM(mvsUtils::MultiViewParams* mp, const StaticVector<int
             {
                 subcams.push_back(cams[rc]);
             }
-            computeDepthMapsPSSGM(cpu_thread_id, mp, subcams);
+            computeDepthMapsPSSGM(cpu_thread_id, ic, mp, subcams);
         }
     }
 }
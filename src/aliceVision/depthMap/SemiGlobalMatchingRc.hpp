@@ -38,6 +38,12 @@ protected:
 private:
     void getSubDepthsForTCam( int tcamid, std::vector<float>& subDepths );
 
+    /// sweep and optimize the similarity volume of one tile of the RC image
+    /// (tile origin and size in volume cells) and return the per-pixel best
+    /// depth id / similarity value of the tile
+    StaticVector<IdValue>* computeTileBestIdVal(int tileLUX, int tileLUY, int tileW, int tileH,
+                                                StaticVectorBool* rcSilhoueteMap, int zborder);
+
 protected:
     SemiGlobalMatchingParams* sp;
 
@@ -61,7 +67,7 @@ protected:
 };
 
 void computeDepthMapsPSSGM(mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams);
-void computeDepthMapsPSSGM(int CUDADeviceNo, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams);
+void computeDepthMapsPSSGM(int CUDADeviceNo, mvsUtils::ImagesCache& ic, mvsUtils::MultiViewParams* mp, const StaticVector<int>& cams);
 
 } // namespace depthMap
 } // namespace aliceVision
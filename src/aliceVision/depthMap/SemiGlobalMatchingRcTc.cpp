@@ -25,11 +25,51 @@ SemiGlobalMatchingRcTc::SemiGlobalMatchingRcTc(
     , _step( step )
     , _w( sp->mp->getWidth(rc) / (scale * step) )
     , _h( sp->mp->getHeight(rc) / (scale * step) )
+    , _tileLUX( 0 )
+    , _tileLUY( 0 )
+    , _tileW( sp->mp->getWidth(rc) / (scale * step) )
+    , _tileH( sp->mp->getHeight(rc) / (scale * step) )
 {
     tc = _tc;
     epipShift = 0.0f;
 
     rcSilhoueteMap = _rcSilhoueteMap;
+
+    _pendingVolume = nullptr;
+    _pendingVolumeStartTime = 0;
+}
+
+SemiGlobalMatchingRcTc::SemiGlobalMatchingRcTc(
+                         const std::vector<float>& _rcTcDepths,
+                         int _rc,
+                         int _tc,
+                         int scale,
+                         int step,
+                         int tileLUX,
+                         int tileLUY,
+                         int tileW,
+                         int tileH,
+                         SemiGlobalMatchingParams* _sp,
+                         StaticVectorBool* _rcSilhoueteMap)
+    : rcTcDepths(_rcTcDepths)
+    , sp( _sp )
+    , rc( _rc )
+    , _scale( scale )
+    , _step( step )
+    , _w( sp->mp->getWidth(rc) / (scale * step) )
+    , _h( sp->mp->getHeight(rc) / (scale * step) )
+    , _tileLUX( tileLUX )
+    , _tileLUY( tileLUY )
+    , _tileW( tileW )
+    , _tileH( tileH )
+{
+    tc = _tc;
+    epipShift = 0.0f;
+
+    rcSilhoueteMap = _rcSilhoueteMap;
+
+    _pendingVolume = nullptr;
+    _pendingVolumeStartTime = 0;
 }
 
 SemiGlobalMatchingRcTc::~SemiGlobalMatchingRcTc()
@@ -41,11 +81,11 @@ StaticVector<Voxel>* SemiGlobalMatchingRcTc::getPixels()
 {
     StaticVector<Voxel>* pixels = new StaticVector<Voxel>();
 
-    pixels->reserve(_w * _h);
+    pixels->reserve(_tileW * _tileH);
 
-    for(int y = 0; y < _h; y++)
+    for(int y = _tileLUY; y < _tileLUY + _tileH; y++)
     {
-        for(int x = 0; x < _w; x++)
+        for(int x = _tileLUX; x < _tileLUX + _tileW; x++)
         {
             if(rcSilhoueteMap == nullptr)
             {
@@ -67,11 +107,17 @@ StaticVector<Voxel>* SemiGlobalMatchingRcTc::getPixels()
 StaticVector<unsigned char>* SemiGlobalMatchingRcTc::computeDepthSimMapVolume(float& volumeMBinGPUMem, int wsh, float gammaC,
                                                                    float gammaP)
 {
-    long tall = clock();
+    computeDepthSimMapVolumeStart(volumeMBinGPUMem, wsh, gammaC, gammaP);
+    return computeDepthSimMapVolumeFinish();
+}
+
+void SemiGlobalMatchingRcTc::computeDepthSimMapVolumeStart(float& volumeMBinGPUMem, int wsh, float gammaC, float gammaP)
+{
+    _pendingVolumeStartTime = clock();
 
     int volStepXY = _step;
-    int volDimX = _w;
-    int volDimY = _h;
+    int volDimX = _tileW;
+    int volDimY = _tileH;
     int volDimZ = rcTcDepths.size();
 
     StaticVector<unsigned char>* volume = new StaticVector<unsigned char>();
@@ -84,12 +130,27 @@ StaticVector<unsigned char>* SemiGlobalMatchingRcTc::computeDepthSimMapVolume(fl
     StaticVector<Voxel>* pixels = getPixels();
 
     volumeMBinGPUMem =
-        sp->cps.sweepPixelsToVolume(rcTcDepths.size(), volume, volDimX, volDimY, volDimZ, volStepXY, 0, 0, 0,
+        sp->cps.sweepPixelsToVolumeBegin(rcTcDepths.size(), volume, volDimX, volDimY, volDimZ, volStepXY,
+                                     _tileLUX * _step, _tileLUY * _step, 0,
                                      &rcTcDepths, rc, wsh, gammaC, gammaP, pixels, _scale, 1, tcams, 0.0f);
     delete pixels;
 
+    _pendingVolume = volume;
+}
+
+StaticVector<unsigned char>* SemiGlobalMatchingRcTc::computeDepthSimMapVolumeFinish()
+{
+    int volDimX = _tileW;
+    int volDimY = _tileH;
+    int volDimZ = rcTcDepths.size();
+
+    sp->cps.sweepPixelsToVolumeWait();
+
+    StaticVector<unsigned char>* volume = _pendingVolume;
+    _pendingVolume = nullptr;
+
     if(sp->mp->verbose)
-        mvsUtils::printfElapsedTime(tall, "SemiGlobalMatchingRcTc::computeDepthSimMapVolume ");
+        mvsUtils::printfElapsedTime(_pendingVolumeStartTime, "SemiGlobalMatchingRcTc::computeDepthSimMapVolume ");
 
     if(sp->P3 > 0)
     {
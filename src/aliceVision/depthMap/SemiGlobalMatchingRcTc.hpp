@@ -18,10 +18,21 @@ class SemiGlobalMatchingRcTc
 public:
     SemiGlobalMatchingRcTc(const std::vector<float>& _rcTcDepths, int _rc, int _tc, int _scale, int _step, SemiGlobalMatchingParams* _sp,
                 StaticVectorBool* _rcSilhoueteMap = NULL);
+
+    /// sweep only the given tile of the RC image, tile origin and size are
+    /// expressed in volume cells (image pixels divided by scale * step)
+    SemiGlobalMatchingRcTc(const std::vector<float>& _rcTcDepths, int _rc, int _tc, int _scale, int _step,
+                int _tileLUX, int _tileLUY, int _tileW, int _tileH, SemiGlobalMatchingParams* _sp,
+                StaticVectorBool* _rcSilhoueteMap = NULL);
     ~SemiGlobalMatchingRcTc(void);
 
     StaticVector<unsigned char>* computeDepthSimMapVolume(float& volumeMBinGPUMem, int wsh, float gammaC, float gammaP);
 
+    /// start the similarity volume computation on the GPU and return immediately,
+    /// the volume is only valid after computeDepthSimMapVolumeFinish()
+    void computeDepthSimMapVolumeStart(float& volumeMBinGPUMem, int wsh, float gammaC, float gammaP);
+    StaticVector<unsigned char>* computeDepthSimMapVolumeFinish();
+
 private:
     StaticVector<Voxel>* getPixels();
     const SemiGlobalMatchingParams* const sp;
@@ -34,9 +45,18 @@ private:
     const int _step;
     const int _w;
     const int _h;
+    // tile of the RC image covered by the volume, in volume cells
+    const int _tileLUX;
+    const int _tileLUY;
+    const int _tileW;
+    const int _tileH;
     float epipShift;
     // int w, h;
     StaticVectorBool* rcSilhoueteMap;
+
+    // volume of the sweep in flight (see computeDepthSimMapVolumeStart)
+    StaticVector<unsigned char>* _pendingVolume;
+    long _pendingVolumeStartTime;
 };
 
 } // namespace depthMap
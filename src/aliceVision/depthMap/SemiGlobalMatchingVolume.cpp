@@ -49,6 +49,12 @@ SemiGlobalMatchingVolume::SemiGlobalMatchingVolume(float _volGpuMB, int _volDimX
     _volumeStepZ = new StaticVector<unsigned char>( volDimX * volDimY * (volDimZ / volStepZ), 255 );
 
     _volumeBestZ = new StaticVector<int>( volDimX * volDimY * (volDimZ / volStepZ), -1 );
+
+    // multi-GB similarity volumes: huge pages keep the per-voxel loops off the dTLB
+    _volume->adviseHugePages();
+    _volumeSecondBest->adviseHugePages();
+    _volumeStepZ->adviseHugePages();
+    _volumeBestZ->adviseHugePages();
 }
 
 SemiGlobalMatchingVolume::~SemiGlobalMatchingVolume()
@@ -75,15 +81,18 @@ void SemiGlobalMatchingVolume::cloneVolumeStepZ()
     unsigned char* _volumePtr = _volume->getDataWritable().data();
     unsigned char* _volumeStepZPtr = _volumeStepZ->getDataWritable().data();
     int* _volumeBestZPtr = _volumeBestZ->getDataWritable().data();
-    for(int z = 0; z < volDimZ; z++)
+    // each thread owns the output chunks of its own zs values; iterating z in
+    // ascending order inside a chunk keeps the original '<=' tie-breaking
+#pragma omp parallel for
+    for(int zs = 0; zs < volDimZ / volStepZ; zs++)
     {
-        for(int y = 0; y < volDimY; y++)
+        for(int z = zs * volStepZ; z < (zs + 1) * volStepZ; z++)
         {
-            for(int x = 0; x < volDimX; x++)
+            for(int y = 0; y < volDimY; y++)
             {
-                if((z / volStepZ) < (volDimZ / volStepZ))
+                for(int x = 0; x < volDimX; x++)
                 {
-                    int offs = (z / volStepZ) * volDimX * volDimY + y * volDimX + x;
+                    int offs = zs * volDimX * volDimY + y * volDimX + x;
                     unsigned char oldSim = _volumeStepZPtr[offs];
                     unsigned char newSim = _volumePtr[z * volDimX * volDimY + y * volDimX + x];
                     if(newSim <= oldSim)
@@ -112,15 +121,18 @@ void SemiGlobalMatchingVolume::cloneVolumeSecondStepZ()
     unsigned char* _volumeStepZPtr = _volumeStepZ->getDataWritable().data();
     unsigned char* _volumeSecondBestPtr = _volumeSecondBest->getDataWritable().data();
     int* _volumeBestZPtr = _volumeBestZ->getDataWritable().data();
-    for(int z = 0; z < volDimZ; z++)
+    // each thread owns the output chunks of its own zs values; iterating z in
+    // ascending order inside a chunk keeps the original '<=' tie-breaking
+#pragma omp parallel for
+    for(int zs = 0; zs < volDimZ / volStepZ; zs++)
     {
-        for(int y = 0; y < volDimY; y++)
+        for(int z = zs * volStepZ; z < (zs + 1) * volStepZ; z++)
         {
-            for(int x = 0; x < volDimX; x++)
+            for(int y = 0; y < volDimY; y++)
             {
-                if((z / volStepZ) < (volDimZ / volStepZ))
+                for(int x = 0; x < volDimX; x++)
                 {
-                    int offs = (z / volStepZ) * volDimX * volDimY + y * volDimX + x;
+                    int offs = zs * volDimX * volDimY + y * volDimX + x;
                     unsigned char oldSim = _volumeStepZPtr[offs];
                     unsigned char newSim = _volumeSecondBestPtr[z * volDimX * volDimY + y * volDimX + x];
                     if(newSim <= oldSim)
@@ -133,6 +145,10 @@ void SemiGlobalMatchingVolume::cloneVolumeSecondStepZ()
         }
     }
 
+    // the second-best volume is never read after this reduction: hand its
+    // pages back to the kernel now instead of holding them until destruction
+    _volumeSecondBest->freeMem();
+
     if (sp->mp->verbose)
         mvsUtils::printfElapsedTime(tall, "SemiGlobalMatchingVolume::cloneVolumeSecondStepZ ");
 }
@@ -161,9 +177,12 @@ StaticVector<IdValue>* SemiGlobalMatchingVolume::getOrigVolumeBestIdValFromVolum
     unsigned char* _volumeStepZPtr = _volumeStepZ->getDataWritable().data();
     int* _volumeBestZPtr = _volumeBestZ->getDataWritable().data();
     IdValue* volumeBestIdValPtr = volumeBestIdVal->getDataWritable().data();
-    for(int z = zborder; z < volDimZ / volStepZ - zborder; z++)
+    // the y rows of the output are independent: each thread reduces the whole
+    // z range of its own rows, keeping the ascending z order of the updates
+#pragma omp parallel for
+    for(int y = 1; y < volDimY - 1; y++)
     {
-        for(int y = 1; y < volDimY - 1; y++)
+        for(int z = zborder; z < volDimZ / volStepZ - zborder; z++)
         {
             for(int x = 1; x < volDimX - 1; x++)
             {
@@ -6,15 +6,19 @@
 
 #include "PlaneSweepingCuda.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Telemetry.hpp>
+#include <aliceVision/system/nvtx.hpp>
 #include <aliceVision/mvsData/Matrix3x3.hpp>
 #include <aliceVision/mvsData/Matrix3x4.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/stl/indexedSort.hpp>
 #include <aliceVision/depthMap/cuda/commonStructures.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/plane_sweeping_cuda.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/host_utils.h>
 
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
@@ -141,15 +145,30 @@ void cps_fillCameraData(mvsUtils::ImagesCache* ic, cameraStruct* cam, int c, mvs
     // ic.refreshData(c);
     mvsUtils::ImagesCache::ImgPtr img = ic->getImg( c );
 
-    Pixel pix;
+    const int width = mp->getWidth(c);
+    const int height = mp->getHeight(c);
+
+    // the conversion to 8-bit RGBA is memory bound, run the rows in parallel
+    // and keep the branch on the pixel layout out of the inner loop
+    if(ic->transposed)
     {
-        for(pix.y = 0; pix.y < mp->getHeight(c); pix.y++)
+#pragma omp parallel for
+        for(int x = 0; x < width; x++)
         {
-            for(pix.x = 0; pix.x < mp->getWidth(c); pix.x++)
+            for(int y = 0; y < height; y++)
             {
-                uchar4& pix_rgba = ic->transposed ? (*cam->tex_rgba_hmh)(pix.x, pix.y) : (*cam->tex_rgba_hmh)(pix.y, pix.x);
-                const uchar4 pc = get( img, pix.x, pix.y ); //  ic.getPixelValue(pix, c);
-                pix_rgba = pc;
+                (*cam->tex_rgba_hmh)(x, y) = get( img, x, y );
+            }
+        }
+    }
+    else
+    {
+#pragma omp parallel for
+        for(int y = 0; y < height; y++)
+        {
+            for(int x = 0; x < width; x++)
+            {
+                (*cam->tex_rgba_hmh)(y, x) = get( img, x, y );
             }
         }
     }
@@ -191,7 +210,12 @@ PlaneSweepingCuda::PlaneSweepingCuda( int CUDADeviceNo,
     {
         oneimagemb += 4.0 * (((float)((maxImageWidth / scale) * (maxImageHeight / scale)) / 1024.0) / 1024.0);
     }
-    float maxmbGPU = 100.0f;
+    // size the GPU image cache from the free memory of the device, keeping
+    // half of it as a reserve for the similarity volumes and working buffers;
+    // images of the whole dataset can stay resident on large devices, so a tc
+    // image shared by many reference cameras is uploaded only once
+    const float freembGPU = ps_getFreeDeviceMemoryMB(_CUDADeviceNo);
+    float maxmbGPU = (float)mp->userParams.get<double>("global.imageCacheGPUMemoryMB", freembGPU * 0.5);
     _nImgsInGPUAtTime = (int)(maxmbGPU / oneimagemb);
     _nImgsInGPUAtTime = std::max(2, std::min(mp->ncams, _nImgsInGPUAtTime));
 
@@ -204,6 +228,7 @@ PlaneSweepingCuda::PlaneSweepingCuda( int CUDADeviceNo,
     subPixel = mp->userParams.get<bool>("global.subPixel", true);
 
     ALICEVISION_LOG_INFO("PlaneSweepingCuda:" << std::endl
+                         << "\t- imageCacheGPUMemoryMB: " << maxmbGPU << std::endl
                          << "\t- _nImgsInGPUAtTime: " << _nImgsInGPUAtTime << std::endl
                          << "\t- scales: " << _scales << std::endl
                          << "\t- subPixel: " << (subPixel ? "Yes" : "No") << std::endl
@@ -212,6 +237,9 @@ PlaneSweepingCuda::PlaneSweepingCuda( int CUDADeviceNo,
     // allocate global on the device
     ps_deviceAllocate((CudaArray<uchar4, 2>***)&ps_texs_arr, _nImgsInGPUAtTime, maxImageWidth, maxImageHeight, scales, _CUDADeviceNo);
 
+    _sweepState = ps_createSweepState();
+    _sweepPendingVolume = nullptr;
+
     cams = new StaticVector<void*>();
     cams->reserve(_nImgsInGPUAtTime);
     cams->resize(_nImgsInGPUAtTime);
@@ -276,6 +304,8 @@ int PlaneSweepingCuda::addCam(int rc, float** H, int scale)
 
 PlaneSweepingCuda::~PlaneSweepingCuda(void)
 {
+    ps_deleteSweepState((ps_sweepState*)_sweepState);
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // deallocate global on the device
     ps_deviceDeallocate((CudaArray<uchar4, 2>***)&ps_texs_arr, _CUDADeviceNo, _nImgsInGPUAtTime, _scales);
@@ -611,7 +641,9 @@ StaticVector<float>* PlaneSweepingCuda::getDepthsRcTc(int rc, int tc, int scale,
 
             if(out->size() > 1)
             {
-                qsort(&(*out)[0], out->size(), sizeof(float), qSortCompareFloatAsc);
+                StaticVector<float> buffer(out->size());
+                stl::indexed_sort::radix_sort_by_key(&(*out)[0], &buffer[0], out->size(),
+                                                     [](float v) { return stl::indexed_sort::radix_key_bits(v); });
             }
         }
     }
@@ -628,6 +660,10 @@ bool PlaneSweepingCuda::refineRcTcDepthMap(bool useTcOrRcPixSize, int nStepsToRe
                                              StaticVector<float>* rcDepthMap, int rc, int tc, int scale, int wsh,
                                              float gammaC, float gammaP, float epipShift, int xFrom, int wPart)
 {
+    const NvtxScope nvtxScope("refineRcTcDepthMap rc=" + std::to_string(rc) + " tc=" + std::to_string(tc)
+                              + " scale=" + std::to_string(scale));
+    const system::Telemetry::ScopedTimer telemetryTimer("refineRcTcDepthMap");
+
     // int w = mp->getWidth(rc)/scale;
     int w = wPart;
     int h = mp->getHeight(rc) / scale;
@@ -695,10 +731,31 @@ bool PlaneSweepingCuda::refineRcTcDepthMap(bool useTcOrRcPixSize, int nStepsToRe
 }
 
 float PlaneSweepingCuda::sweepPixelsToVolume(int nDepthsToSearch, StaticVector<unsigned char>* volume, int volDimX,
+                                               int volDimY, int volDimZ, int volStepXY, int volLUX, int volLUY,
+                                               int volLUZ, const std::vector<float>* depths, int rc, int wsh, float gammaC,
+                                               float gammaP, StaticVector<Voxel>* pixels, int scale, int step,
+                                               StaticVector<int>* tcams, float epipShift)
+{
+    const float volumeMBinGPUMem =
+        sweepPixelsToVolumeBegin(nDepthsToSearch, volume, volDimX, volDimY, volDimZ, volStepXY, volLUX, volLUY, volLUZ,
+                                 depths, rc, wsh, gammaC, gammaP, pixels, scale, step, tcams, epipShift);
+    sweepPixelsToVolumeWait();
+    return volumeMBinGPUMem;
+}
+
+float PlaneSweepingCuda::sweepPixelsToVolumeBegin(int nDepthsToSearch, StaticVector<unsigned char>* volume, int volDimX,
                                                int volDimY, int volDimZ, int volStepXY, int volLUX, int volLUY,
                                                int volLUZ, const std::vector<float>* depths, int rc, int wsh, float gammaC,
                                                float gammaP, StaticVector<Voxel>* pixels, int scale, int step,
                                                StaticVector<int>* tcams, float epipShift) {
+    const NvtxScope nvtxScope("sweepPixelsToVolumeBegin rc=" + std::to_string(rc) + " scale=" + std::to_string(scale)
+                              + " step=" + std::to_string(step));
+    const system::Telemetry::ScopedTimer telemetryTimer("sweepPixelsToVolumeBegin");
+
+    // finish the previous sweep first, its output volume must be unpacked before
+    // the staging buffers are reused
+    sweepPixelsToVolumeWait();
+
     if(_verbose)
         ALICEVISION_LOG_DEBUG("sweepPixelsVolume:" << std::endl
                               << "\t- scale: " << scale << std::endl
@@ -749,7 +806,18 @@ float PlaneSweepingCuda::sweepPixelsToVolume(int nDepthsToSearch, StaticVector<u
 
     int npixs = pixels->size();
     int ntimes = npixs / slicesAtTime + 1;
-    CudaHostMemoryHeap<int4, 2> volPixs_hmh(CudaSize<2>(slicesAtTime, ntimes));
+
+    ps_sweepState* sweepState = (ps_sweepState*)_sweepState;
+
+    // the pinned staging buffers live in the sweep state: freeing pinned memory
+    // synchronizes the device, it must not happen while a sweep is in flight
+    if((sweepState->volPixs_hmh == nullptr) || (sweepState->volPixs_hmh->getSize() != CudaSize<2>(slicesAtTime, ntimes)))
+    {
+        ps_sweepStateWait(sweepState);
+        delete sweepState->volPixs_hmh;
+        sweepState->volPixs_hmh = new CudaHostMemoryHeap<int4, 2>(CudaSize<2>(slicesAtTime, ntimes));
+    }
+    CudaHostMemoryHeap<int4, 2>& volPixs_hmh = *sweepState->volPixs_hmh;
 
     int4 *_volPixs = volPixs_hmh.getBuffer();
     const Voxel *_pixels = pixels->getData().data();
@@ -781,20 +849,28 @@ float PlaneSweepingCuda::sweepPixelsToVolume(int nDepthsToSearch, StaticVector<u
             }
     }
 
-    CudaHostMemoryHeap<float, 2> depths_hmh(CudaSize<2>(depths->size(), 1));
+    if((sweepState->depths_hmh == nullptr) || (sweepState->depths_hmh->getSize() != CudaSize<2>(depths->size(), 1)))
+    {
+        ps_sweepStateWait(sweepState);
+        delete sweepState->depths_hmh;
+        sweepState->depths_hmh = new CudaHostMemoryHeap<float, 2>(CudaSize<2>(depths->size(), 1));
+    }
+    CudaHostMemoryHeap<float, 2>& depths_hmh = *sweepState->depths_hmh;
 
     for(int x = 0; x < depths->size(); x++)
     {
         depths_hmh(x, 0) = (*depths)[x];
     }
 
-    // sweep
+    // sweep, the kernels and the volume copy back are enqueued on the sweep stream
     float volumeMBinGPUMem = ps_planeSweepingGPUPixelsVolume(
-        (CudaArray<uchar4, 2>**)ps_texs_arr, volume->getDataWritable().data(), ttcams, camsids->size(), w, h, volStepXY, volDimX, volDimY,
+        sweepState, (CudaArray<uchar4, 2>**)ps_texs_arr, ttcams, camsids->size(), w, h, volStepXY, volDimX, volDimY,
         volDimZ, volLUX, volLUY, volLUZ, volPixs_hmh, depths_hmh, nDepthsToSearch, slicesAtTime, ntimes, npixs, wsh,
         _nbestkernelSizeHalf, depths->size(), scale - 1, _CUDADeviceNo, _nImgsInGPUAtTime, _scales, _verbose, false, _nbest,
         true, gammaC, gammaP, subPixel, epipShift);
 
+    _sweepPendingVolume = volume;
+
     for(int i = 0; i < camsids->size(); i++)
     {
         ttcams[i] = NULL;
@@ -808,6 +884,24 @@ float PlaneSweepingCuda::sweepPixelsToVolume(int nDepthsToSearch, StaticVector<u
     return volumeMBinGPUMem;
 }
 
+void PlaneSweepingCuda::sweepPixelsToVolumeWait()
+{
+    if(_sweepPendingVolume == nullptr)
+        return;
+
+    // this wait accounts for the GPU time of the asynchronous sweep
+    const NvtxScope nvtxScope("sweepPixelsToVolumeWait");
+    const system::Telemetry::ScopedTimer telemetryTimer("sweepPixelsToVolumeWait");
+
+    ps_sweepState* sweepState = (ps_sweepState*)_sweepState;
+    ps_sweepStateWait(sweepState);
+
+    // unpack the pinned staging buffer into the output volume
+    memcpy(_sweepPendingVolume->getDataWritable().data(), sweepState->vol_hmh->getBuffer(),
+           sweepState->vol_hmh->getBytesUnpadded());
+    _sweepPendingVolume = nullptr;
+}
+
 /**
  * @param[inout] volume input similarity volume (after Z reduction)
  */
@@ -822,6 +916,9 @@ bool PlaneSweepingCuda::SGMoptimizeSimVolume(int rc, StaticVector<unsigned char>
                               << "\t- volDimY: " << volDimY << std::endl
                               << "\t- volDimZ: " << volDimZ);
 
+    const NvtxScope nvtxScope("SGMoptimizeSimVolume rc=" + std::to_string(rc) + " scale=" + std::to_string(scale));
+    const system::Telemetry::ScopedTimer telemetryTimer("SGMoptimizeSimVolume");
+
     long t1 = clock();
 
     ps_SGMoptimizeSimVolume((CudaArray<uchar4, 2>**)ps_texs_arr, (cameraStruct*)(*cams)[addCam(rc, NULL, scale)],
@@ -845,6 +942,9 @@ bool PlaneSweepingCuda::fuseDepthSimMapsGaussianKernelVoting(int w, int h, Stati
                                                                const StaticVector<StaticVector<DepthSim>*>* dataMaps,
                                                                int nSamplesHalf, int nDepthsToRefine, float sigma)
 {
+    const NvtxScope nvtxScope("fuseDepthSimMapsGaussianKernelVoting");
+    const system::Telemetry::ScopedTimer telemetryTimer("fuseDepthSimMapsGaussianKernelVoting");
+
     long t1 = clock();
 
     // sweep
@@ -892,6 +992,96 @@ bool PlaneSweepingCuda::fuseDepthSimMapsGaussianKernelVoting(int w, int h, Stati
     return true;
 }
 
+bool PlaneSweepingCuda::refineAndFuseDepthSimMapsGaussianKernelVoting(bool useTcOrRcPixSize, int nStepsToRefine,
+                                                                        StaticVector<DepthSim>* oDepthSimMap,
+                                                                        const StaticVector<DepthSim>* rcDepthPixSizeMap,
+                                                                        int rc, const StaticVector<int>& tcams,
+                                                                        int scale, int wsh, float gammaC, float gammaP,
+                                                                        float epipShift, int nSamplesHalf,
+                                                                        int nDepthsToRefine, float sigma)
+{
+    const NvtxScope nvtxScope("refineAndFuseDepthSimMapsGaussianKernelVoting rc=" + std::to_string(rc));
+    const system::Telemetry::ScopedTimer telemetryTimer("refineAndFuseDepthSimMapsGaussianKernelVoting");
+
+    int w = mp->getWidth(rc) / scale;
+    int h = mp->getHeight(rc) / scale;
+
+    long t1 = clock();
+
+    StaticVector<int>* camsids = new StaticVector<int>();
+    camsids->reserve(tcams.size() + 1);
+    camsids->push_back(addCam(rc, NULL, scale));
+
+    if(_verbose)
+        ALICEVISION_LOG_DEBUG("\t- rc: " << rc << std::endl << "\t- tcams: ");
+
+    for(int c = 0; c < tcams.size(); c++)
+    {
+        if(_verbose)
+            ALICEVISION_LOG_DEBUG("\t- " << tcams[c]);
+        camsids->push_back(addCam(tcams[c], NULL, scale));
+    }
+
+    cameraStruct** ttcams = new cameraStruct*[camsids->size()];
+    for(int i = 0; i < camsids->size(); i++)
+    {
+        ttcams[i] = (cameraStruct*)(*cams)[(*camsids)[i]];
+        ttcams[i]->camId = (*camsids)[i];
+        if(i == 0)
+        {
+            ttcams[i]->rc = rc;
+        }
+        else
+        {
+            ttcams[i]->rc = tcams[i - 1];
+        }
+    }
+
+    // only the rc depth/pixSize map goes to the device, the per-tc refined
+    // maps stay resident there until the fused map comes back
+    CudaHostMemoryHeap<float2, 2> rcDepthPixSizeMap_hmh(CudaSize<2>(w, h));
+    for(int y = 0; y < h; y++)
+    {
+        for(int x = 0; x < w; x++)
+        {
+            float2& data_hmh = rcDepthPixSizeMap_hmh(x, y);
+            const DepthSim& data = (*rcDepthPixSizeMap)[y * w + x];
+            data_hmh.x = data.depth;
+            data_hmh.y = data.sim;
+        }
+    }
+
+    CudaHostMemoryHeap<float2, 2> oDepthSimMap_hmh(CudaSize<2>(w, h));
+
+    ps_refineAndFuseRcTcDepthSimMaps((CudaArray<uchar4, 2>**)ps_texs_arr, &oDepthSimMap_hmh, &rcDepthPixSizeMap_hmh,
+                                     nStepsToRefine, ttcams, camsids->size(), w, h, scale - 1, _CUDADeviceNo,
+                                     _nImgsInGPUAtTime, _scales, _verbose, wsh, gammaC, gammaP, epipShift,
+                                     useTcOrRcPixSize, nSamplesHalf, nDepthsToRefine, sigma);
+
+    for(int y = 0; y < h; y++)
+    {
+        for(int x = 0; x < w; x++)
+        {
+            const float2& oDepthSim_hmh = oDepthSimMap_hmh(x, y);
+            DepthSim& oDepthSim = (*oDepthSimMap)[y * w + x];
+            oDepthSim.depth = oDepthSim_hmh.x;
+            oDepthSim.sim = oDepthSim_hmh.y;
+        }
+    }
+
+    for(int i = 0; i < camsids->size(); i++)
+    {
+        ttcams[i] = NULL;
+    }
+    delete[] ttcams;
+    delete camsids;
+
+    if(_verbose)
+        mvsUtils::printfElapsedTime(t1);
+
+    return true;
+}
+
 bool PlaneSweepingCuda::optimizeDepthSimMapGradientDescent(StaticVector<DepthSim>* oDepthSimMap,
                                                              StaticVector<StaticVector<DepthSim>*>* dataMaps, int rc,
                                                              int nSamplesHalf, int nDepthsToRefine, float sigma,
@@ -900,6 +1090,9 @@ bool PlaneSweepingCuda::optimizeDepthSimMapGradientDescent(StaticVector<DepthSim
     if(_verbose)
         ALICEVISION_LOG_DEBUG("optimizeDepthSimMapGradientDescent.");
 
+    const NvtxScope nvtxScope("optimizeDepthSimMapGradientDescent rc=" + std::to_string(rc));
+    const system::Telemetry::ScopedTimer telemetryTimer("optimizeDepthSimMapGradientDescent");
+
     int scale = 1;
     int w = mp->getWidth(rc);
     int h = hPart;
@@ -54,6 +54,10 @@ public:
     const int _CUDADeviceNo;
     void** ps_texs_arr;
 
+    // asynchronous similarity volume sweep (see sweepPixelsToVolumeBegin)
+    void* _sweepState; // ps_sweepState*, persistent stream and staging buffers
+    StaticVector<unsigned char>* _sweepPendingVolume; // host output of the sweep in flight
+
     StaticVector<void*>* cams;
     StaticVector<int>* camsRcs;
     StaticVector<long>* camsTimes;
@@ -113,6 +117,14 @@ public:
                               const std::vector<float>* depths, int rc, int wsh, float gammaC, float gammaP,
                               StaticVector<Voxel>* pixels, int scale, int step, StaticVector<int>* tcams,
                               float epipShift);
+    /// start the similarity volume computation on the GPU and return immediately,
+    /// the volume content is only valid after sweepPixelsToVolumeWait()
+    float sweepPixelsToVolumeBegin(int nDepthsToSearch, StaticVector<unsigned char>* volume, int volDimX, int volDimY,
+                                   int volDimZ, int volStepXY, int volLUX, int volLUY, int volLUZ,
+                                   const std::vector<float>* depths, int rc, int wsh, float gammaC, float gammaP,
+                                   StaticVector<Voxel>* pixels, int scale, int step, StaticVector<int>* tcams,
+                                   float epipShift);
+    void sweepPixelsToVolumeWait();
     bool SGMoptimizeSimVolume(int rc, StaticVector<unsigned char>* volume, int volDimX, int volDimY, int volDimZ,
                               int volStepXY, int volLUX, int volLUY, int scale, unsigned char P1, unsigned char P2);
     Point3d getDeviceMemoryInfo();
@@ -137,6 +149,14 @@ public:
     bool fuseDepthSimMapsGaussianKernelVoting(int w, int h, StaticVector<DepthSim> *oDepthSimMap,
                                               const StaticVector<StaticVector<DepthSim> *> *dataMaps, int nSamplesHalf,
                                               int nDepthsToRefine, float sigma);
+    /// refine the rc depth map against all tc cameras and fuse the results in a
+    /// single GPU pass, the per-tc depth/sim maps never leave the device
+    bool refineAndFuseDepthSimMapsGaussianKernelVoting(bool useTcOrRcPixSize, int nStepsToRefine,
+                                                       StaticVector<DepthSim>* oDepthSimMap,
+                                                       const StaticVector<DepthSim>* rcDepthPixSizeMap, int rc,
+                                                       const StaticVector<int>& tcams, int scale, int wsh, float gammaC,
+                                                       float gammaP, float epipShift, int nSamplesHalf,
+                                                       int nDepthsToRefine, float sigma);
     bool optimizeDepthSimMapGradientDescent(StaticVector<DepthSim> *oDepthSimMap,
                                             StaticVector<StaticVector<DepthSim> *> *dataMaps, int rc, int nSamplesHalf,
                                             int nDepthsToRefine, float sigma, int nIters, int yFrom, int hPart);
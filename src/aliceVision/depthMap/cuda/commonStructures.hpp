@@ -14,6 +14,8 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <map>
+#include <mutex>
 
 #define THROW_ON_CUDA_ERROR(rcode, message) \
   if (rcode != cudaSuccess) {  \
@@ -331,6 +333,7 @@ public:
 
     // see below with copy() functions
     void copyFrom( const CudaDeviceMemoryPitched<Type, Dim>& src );
+    void copyFrom( const CudaDeviceMemoryPitched<Type, Dim>& src, cudaStream_t stream );
 
     inline Type *getBuffer()
     {
@@ -384,6 +387,151 @@ public:
     }
 };
 
+/*********************************************************************************
+ * CudaDeviceMemoryPool
+ *********************************************************************************/
+
+/* Size-bucketed pool of device memory blocks.
+ *
+ * SemiGlobalMatchingRc and RefineRc construct and destroy their volumes and
+ * maps once per reference camera. Going through cudaMalloc/cudaFree each time
+ * serializes all host threads on the device allocator and fragments device
+ * memory on long runs. The pool rounds each request up to a bucket size and
+ * keeps the freed blocks in per-device free lists, so at steady state the
+ * processing of a camera reuses the blocks freed by the previous one instead
+ * of hitting the allocator.
+ *
+ * A freed block may still be read by kernels in flight, which is safe for its
+ * next owner because all the work touching pooled blocks is issued in stream
+ * order: the writes of the new owner cannot overtake the reads of the old one.
+ */
+class CudaDeviceMemoryPool
+{
+public:
+    static CudaDeviceMemoryPool& getInstance()
+    {
+        static CudaDeviceMemoryPool pool;
+        return pool;
+    }
+
+    void* allocate( size_t bytes )
+    {
+        const size_t bucket = bucketSize( bytes );
+
+        int device;
+        cudaGetDevice( &device );
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::vector<void*>& freeList = _freeLists[device][bucket];
+            if( !freeList.empty() )
+            {
+                void* ptr = freeList.back();
+                freeList.pop_back();
+                return ptr;
+            }
+        }
+
+        void* ptr = nullptr;
+        cudaError_t err = cudaMalloc( &ptr, bucket );
+        if( err != cudaSuccess )
+        {
+            // the cached blocks may be what prevents this allocation: release
+            // them all and retry once before giving up
+            clear();
+            err = cudaMalloc( &ptr, bucket );
+        }
+        if( err != cudaSuccess )
+        {
+            std::stringstream ss;
+            ss << "Could not allocate pooled device memory.\n"
+               << "Device " << device << " alloc " << bucket << " bytes failed in " << __FILE__ << ":" << __LINE__ << ", " << cudaGetErrorString(err);
+            throw std::runtime_error(ss.str());
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _blocks[ptr] = std::make_pair( device, bucket );
+        return ptr;
+    }
+
+    void deallocate( void* ptr )
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::map<void*, std::pair<int, size_t> >::const_iterator it = _blocks.find( ptr );
+        if( it == _blocks.end() )
+        {
+            std::stringstream ss;
+            ss << "Returned a block to the device memory pool that it does not own, " << __FILE__ << ":" << __LINE__;
+            throw std::runtime_error(ss.str());
+        }
+        _freeLists[it->second.first][it->second.second].push_back( ptr );
+    }
+
+    /* Release all the cached blocks back to the driver. Blocks still in use
+     * stay owned by their CudaDeviceMemoryPitched and are unaffected.
+     */
+    void clear( )
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        int current;
+        cudaGetDevice( &current );
+
+        for( std::map<int, std::map<size_t, std::vector<void*> > >::iterator dev = _freeLists.begin(); dev != _freeLists.end(); dev++ )
+        {
+            cudaSetDevice( dev->first );
+            for( std::map<size_t, std::vector<void*> >::iterator bucket = dev->second.begin(); bucket != dev->second.end(); bucket++ )
+            {
+                for( size_t i = 0; i < bucket->second.size(); i++ )
+                {
+                    cudaFree( bucket->second[i] );
+                    _blocks.erase( bucket->second[i] );
+                }
+                bucket->second.clear();
+            }
+        }
+
+        cudaSetDevice( current );
+    }
+
+    /* Pitch used for the pooled pitched allocations, a multiple of the
+     * alignment returned by cudaMallocPitch on all supported devices.
+     */
+    static size_t alignPitch( size_t rowBytes )
+    {
+        const size_t alignment = 512;
+        return ( ( rowBytes + alignment - 1 ) / alignment ) * alignment;
+    }
+
+private:
+    CudaDeviceMemoryPool( )
+    { }
+
+    CudaDeviceMemoryPool( const CudaDeviceMemoryPool& );
+    CudaDeviceMemoryPool& operator=( const CudaDeviceMemoryPool& );
+
+    /* Small requests share power-of-two buckets; above 4 MB the sizes are
+     * rounded up to the next 4 MB so that a large volume wastes at most one
+     * bucket step instead of almost doubling.
+     */
+    static size_t bucketSize( size_t bytes )
+    {
+        const size_t step = 4 * 1024 * 1024;
+        if( bytes >= step )
+            return ( ( bytes + step - 1 ) / step ) * step;
+        size_t bucket = 256;
+        while( bucket < bytes )
+            bucket *= 2;
+        return bucket;
+    }
+
+    std::mutex _mutex;
+    /// free blocks, indexed by device id and bucket size
+    std::map<int, std::map<size_t, std::vector<void*> > > _freeLists;
+    /// device id and bucket size of every block handed out or cached
+    std::map<void*, std::pair<int, size_t> > _blocks;
+};
+
 /*********************************************************************************
  * CudaDeviceMemoryPitched
  *********************************************************************************/
@@ -489,63 +637,18 @@ public:
     {
         this->setSize( size, false );
 
-        if(Dim == 2)
-        {
-            cudaError_t err = cudaMallocPitch<Type>(&buffer,
-                                                    &this->getPitchRef(),
-                                                    this->getUnpaddedBytesInRow(),
-                                                    this->getUnitsInDim(1) );
-            if( err != cudaSuccess )
-            {
-                int devid;
-                cudaGetDevice( &devid );
-                std::stringstream ss;
-                ss << "Could not allocate pitched device memory.\n"
-                   << "Device " << devid << " alloc " << this->getBytesUnpadded() << " bytes failed in " << __FILE__ << ":" << __LINE__ << ", " << cudaGetErrorString(err);
-                throw std::runtime_error(ss.str());
-            }
-        }
-        else if(Dim == 3)
-        {
-            cudaExtent extent;
-            extent.width  = this->getUnpaddedBytesInRow();
-            extent.height = this->getUnitsInDim(1);
-            extent.depth  = this->getUnitsInDim(2);
-            cudaPitchedPtr pitchDevPtr;
-            cudaError_t err = cudaMalloc3D(&pitchDevPtr, extent);
-            if( err != cudaSuccess )
-            {
-                int devid;
-                cudaGetDevice( &devid );
-                size_t bytes = this->getBytesUnpadded();
-                size_t sx    = this->getUnitsInDim(0);
-                size_t sy    = this->getUnitsInDim(1);
-                size_t sz    = this->getUnitsInDim(2);
-                std::stringstream ss;
-                ss << "Could not allocate 3D device memory.\n"
-                   << "Device " << devid << " alloc "
-                                    << sx << "x" << sy << "x" << sz << "x" << sizeof(Type) << " = "
-                                    << bytes << " bytes ("
-                << (int)(bytes/1024.0f/1024.0f) << " MB) failed in " << __FILE__ << ":" << __LINE__ << ", " << cudaGetErrorString(err);
-                throw std::runtime_error(ss.str());
-            }
+        // a pitch computed on the host lets the pool hand out plain byte
+        // blocks, so blocks can be reused across element types and dimensions
+        this->setPitch( CudaDeviceMemoryPool::alignPitch( this->getUnpaddedBytesInRow() ) );
 
-            buffer = (Type*)pitchDevPtr.ptr;
-            this->setPitch( pitchDevPtr.pitch );
-        }
+        buffer = (Type*)CudaDeviceMemoryPool::getInstance().allocate( this->getBytesPadded() );
     }
 
     void deallocate()
     {
         if( buffer == nullptr ) return;
 
-        cudaError_t err = cudaFree(buffer);
-        if( err != cudaSuccess )
-        {
-            std::stringstream ss;
-            ss << "Device free failed, " << cudaGetErrorString(err);
-            throw std::runtime_error(ss.str());
-        }
+        CudaDeviceMemoryPool::getInstance().deallocate( buffer );
 
         buffer = nullptr;
     }
@@ -860,6 +963,37 @@ void CudaHostMemoryHeap<Type, Dim>::copyFrom( const CudaDeviceMemoryPitched<Type
     }
 }
 
+template<class Type, unsigned Dim>
+void CudaHostMemoryHeap<Type, Dim>::copyFrom( const CudaDeviceMemoryPitched<Type, Dim>& src, cudaStream_t stream )
+{
+    const cudaMemcpyKind kind = cudaMemcpyDeviceToHost;
+    if(Dim == 1)
+    {
+        cudaError_t err = cudaMemcpyAsync( this->getBytePtr(),
+                                           src.getBytePtr(),
+                                           this->getUnpaddedBytesInRow(),
+                                           kind,
+                                           stream);
+        THROW_ON_CUDA_ERROR(err, "Failed to copy (" << __FILE__ << " " << __LINE__ << ")");
+    }
+    else if(Dim >= 2)
+    {
+        size_t number_of_rows = 1;
+        for( int i=1; i<Dim; i++ ) number_of_rows *= this->getUnitsInDim(i);
+
+        cudaError_t err = cudaMemcpy2DAsync( this->getBytePtr(),
+                                             this->getPitch(),
+                                             src.getBytePtr(),
+                                             src.getPitch(),
+                                             this->getUnpaddedBytesInRow(),
+                                             number_of_rows,
+                                             kind,
+                                             stream);
+
+        THROW_ON_CUDA_ERROR(err, "Failed to copy (" << __FILE__ << " " << __LINE__ << ")");
+    }
+}
+
 /*********************************************************************************
  * copy functions
  *********************************************************************************/
@@ -869,6 +1003,11 @@ template<class Type, unsigned Dim> void copy(CudaHostMemoryHeap<Type, Dim>& dst,
     dst.copyFrom( src );
 }
 
+template<class Type, unsigned Dim> void copy(CudaHostMemoryHeap<Type, Dim>& dst, const CudaDeviceMemoryPitched<Type, Dim>& src, cudaStream_t stream)
+{
+    dst.copyFrom( src, stream );
+}
+
 template<class Type> void copy(CudaHostMemoryHeap<Type,1>& _dst, const CudaDeviceMemory<Type>& _src)
 {
   cudaMemcpyKind kind = cudaMemcpyDeviceToHost;
@@ -1040,6 +1179,53 @@ template<class Type, unsigned Dim> void copy(CudaArray<Type, Dim>& _dst, const C
   }
 }
 
+template<class Type, unsigned Dim> void copy(CudaArray<Type, Dim>& _dst, const CudaHostMemoryHeap<Type, Dim>& _src, cudaStream_t stream)
+{
+  const cudaMemcpyKind kind = cudaMemcpyHostToDevice;
+  if(Dim == 1) {
+    cudaError_t err = cudaMemcpyToArrayAsync(_dst.getArray(),
+                                             0, 0,
+                                             _src.getBytePtr(),
+                                             _src.getUnpaddedBytesInRow(),
+                                             kind,
+                                             stream);
+    THROW_ON_CUDA_ERROR(err, "Failed to copy (" << __FILE__ << " " << __LINE__ << ")");
+  }
+  else if(Dim == 2) {
+    cudaError_t err = cudaMemcpy2DToArrayAsync(_dst.getArray(),
+                                               0,
+                                               0,
+                                               _src.getBytePtr(),
+                                               _src.getPitch(),
+                                               _src.getUnpaddedBytesInRow(),
+                                               _src.getUnitsInDim(1),
+                                               kind,
+                                               stream);
+    THROW_ON_CUDA_ERROR(err, "Failed to copy (" << __FILE__ << " " << __LINE__ << ")");
+  }
+  else if(Dim >= 3) {
+    size_t number_of_rows = 1;
+    for( int i=1; i<Dim; i++ ) number_of_rows *= _src.getUnitsInDim(i);
+
+    cudaMemcpy3DParms p = { 0 };
+    p.srcPtr.ptr = (void *)_src.getBytePtr();
+    p.srcPtr.pitch = _src.getPitch();
+    p.srcPtr.xsize = _src.getUnitsInDim(0);
+    p.srcPtr.ysize = number_of_rows;
+
+    p.dstArray = _dst.getArray();
+
+    p.extent.width  = _src.getUnitsInDim(0);
+    p.extent.height = _src.getUnitsInDim(1);
+    p.extent.depth  = _src.getUnitsInDim(2);
+    for(unsigned i = 3; i < Dim; ++i)
+      p.extent.depth *= _src.getUnitsInDim(i);
+    p.kind = kind;
+    cudaError_t err = cudaMemcpy3DAsync(&p, stream);
+    THROW_ON_CUDA_ERROR(err, "Failed to copy (" << __FILE__ << " " << __LINE__ << ")");
+  }
+}
+
 template<class Type, unsigned Dim> void copy(CudaArray<Type, Dim>& _dst, const CudaDeviceMemoryPitched<Type, Dim>& _src)
 {
   const cudaMemcpyKind kind = cudaMemcpyDeviceToDevice;
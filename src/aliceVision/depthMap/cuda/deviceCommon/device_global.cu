@@ -27,8 +27,9 @@ texture<unsigned char, 2, cudaReadModeNormalizedFloat> ttex;
 texture<unsigned char, 2, cudaReadModeNormalizedFloat> gtex;
 texture<unsigned char, 2, cudaReadModeNormalizedFloat> btex;
 
-texture<uchar4, 2, cudaReadModeNormalizedFloat> r4tex;
-texture<uchar4, 2, cudaReadModeNormalizedFloat> t4tex;
+// The rc/tc camera images (r4tex/t4tex) are no longer global texture references:
+// they are passed to the kernels as cudaTextureObject_t parameters, so kernels
+// working on different cameras do not have to serialize on a rebind.
 texture<float, 1, cudaReadModeElementType> gaussianTex;
 
 texture<unsigned char, 2, cudaReadModeNormalizedFloat> wshtex;
@@ -267,7 +267,9 @@ __device__ float compNCCbyH(patch& ptch, int wsh)
 
 /**
  * @brief Compute Normalized Cross-Correlation
- * 
+ *
+ * @param[in] r4tex rc camera texture
+ * @param[in] t4tex tc camera texture
  * @param[inout] ptch
  * @param[in] wsh half-width of the similarity homography matrix (width = wsh*2+1)
  * @param[in] width image width
@@ -278,7 +280,8 @@ __device__ float compNCCbyH(patch& ptch, int wsh)
  * 
  * @return similarity value
  */
-__device__ float compNCCby3DptsYK(patch& ptch, int wsh, int width, int height, const float _gammaC, const float _gammaP,
+__device__ float compNCCby3DptsYK(cudaTextureObject_t r4tex, cudaTextureObject_t t4tex, patch& ptch, int wsh,
+                                  int width, int height, const float _gammaC, const float _gammaP,
                                   const float epipShift)
 {
     float3 p = ptch.p;
@@ -303,8 +306,8 @@ __device__ float compNCCby3DptsYK(patch& ptch, int wsh, int width, int height, c
 
     // see CUDA_C_Programming_Guide.pdf ... E.2 pp132-133 ... adding 0.5 caises that tex2D return for point i,j exactly
     // value od I(i,j) ... it is what we want
-    float4 gcr = 255.0f * tex2D(r4tex, rp.x + 0.5f, rp.y + 0.5f);
-    float4 gct = 255.0f * tex2D(t4tex, tp.x + 0.5f, tp.y + 0.5f);
+    float4 gcr = 255.0f * tex2D<float4>(r4tex, rp.x + 0.5f, rp.y + 0.5f);
+    float4 gct = 255.0f * tex2D<float4>(t4tex, tp.x + 0.5f, tp.y + 0.5f);
     // gcr = 255.0f*tex2D(r4tex, rp.x, rp.y);
     // gct = 255.0f*tex2D(t4tex, tp.x, tp.y);
 
@@ -326,8 +329,8 @@ __device__ float compNCCby3DptsYK(patch& ptch, int wsh, int width, int height, c
 
             // see CUDA_C_Programming_Guide.pdf ... E.2 pp132-133 ... adding 0.5 caises that tex2D return for point i,j
             // exactly value od I(i,j) ... it is what we want
-            float4 gcr1f = tex2D(r4tex, rp1.x + 0.5f, rp1.y + 0.5f);
-            float4 gct1f = tex2D(t4tex, tp1.x + 0.5f, tp1.y + 0.5f);
+            float4 gcr1f = tex2D<float4>(r4tex, rp1.x + 0.5f, rp1.y + 0.5f);
+            float4 gct1f = tex2D<float4>(t4tex, tp1.x + 0.5f, tp1.y + 0.5f);
             float4 gcr1 = 255.0f * gcr1f;
             float4 gct1 = 255.0f * gct1f;
             // gcr1 = 255.0f*tex2D(r4tex, rp1.x, rp1.y);
@@ -55,14 +55,14 @@ texture<float4, 2, cudaReadModeElementType> f4Tex;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 
-__device__ unsigned char computeGradientSizeOfL(int x, int y)
+__device__ unsigned char computeGradientSizeOfL(cudaTextureObject_t r4tex, int x, int y)
 
 {
 
-    float xM1 = 255.0f * (tex2D(r4tex, (float)(x - 1) + 0.5f, (float)(y + 0) + 0.5f).x);
-    float xP1 = 255.0f * (tex2D(r4tex, (float)(x + 1) + 0.5f, (float)(y + 0) + 0.5f).x);
-    float yM1 = 255.0f * (tex2D(r4tex, (float)(x + 0) + 0.5f, (float)(y - 1) + 0.5f).x);
-    float yP1 = 255.0f * (tex2D(r4tex, (float)(x + 0) + 0.5f, (float)(y + 1) + 0.5f).x);
+    float xM1 = 255.0f * (tex2D<float4>(r4tex, (float)(x - 1) + 0.5f, (float)(y + 0) + 0.5f).x);
+    float xP1 = 255.0f * (tex2D<float4>(r4tex, (float)(x + 1) + 0.5f, (float)(y + 0) + 0.5f).x);
+    float yM1 = 255.0f * (tex2D<float4>(r4tex, (float)(x + 0) + 0.5f, (float)(y - 1) + 0.5f).x);
+    float yP1 = 255.0f * (tex2D<float4>(r4tex, (float)(x + 0) + 0.5f, (float)(y + 1) + 0.5f).x);
 
     // not divided by 2?
     float2 g = make_float2(xM1 - xP1, yM1 - yP1);
@@ -70,7 +70,8 @@ __device__ unsigned char computeGradientSizeOfL(int x, int y)
     return (unsigned char)size(g);
 }
 
-__global__ void compute_varLofLABtoW_kernel(uchar4* labMap, int labMap_p, int width, int height, int wsh)
+__global__ void compute_varLofLABtoW_kernel(cudaTextureObject_t r4tex, uchar4* labMap, int labMap_p, int width,
+                                            int height, int wsh)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
@@ -81,7 +82,7 @@ __global__ void compute_varLofLABtoW_kernel(uchar4* labMap, int labMap_p, int wi
 
         // unsigned char sigma = computeSigmaOfL(x, y, wsh);
         // val->w = sigma;
-        unsigned char grad = computeGradientSizeOfL(x, y);
+        unsigned char grad = computeGradientSizeOfL(r4tex, x, y);
 
         val->w = grad;
     }
@@ -230,29 +231,30 @@ __global__ void grad_kernel(float2* grad, int grad_p,
     }
 }
 
-__global__ void getRefTexLAB_kernel(uchar4* texs, int texs_p, int width, int height)
+__global__ void getRefTexLAB_kernel(cudaTextureObject_t r4tex, uchar4* texs, int texs_p, int width, int height)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
 
     if((x < width) && (y < height))
     {
-        *get2DBufferAt(texs, texs_p, x, y) = float4_to_uchar4(255.0f * tex2D(r4tex, (float)x + 0.5f, (float)y + 0.5f));
+        *get2DBufferAt(texs, texs_p, x, y) = float4_to_uchar4(255.0f * tex2D<float4>(r4tex, (float)x + 0.5f, (float)y + 0.5f));
     }
 }
 
-__global__ void getTarTexLAB_kernel(uchar4* texs, int texs_p, int width, int height)
+__global__ void getTarTexLAB_kernel(cudaTextureObject_t t4tex, uchar4* texs, int texs_p, int width, int height)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
 
     if((x < width) && (y < height))
     {
-        *get2DBufferAt(texs, texs_p, x, y) = float4_to_uchar4(255.0f * tex2D(t4tex, (float)x + 0.5f, (float)y + 0.5f));
+        *get2DBufferAt(texs, texs_p, x, y) = float4_to_uchar4(255.0f * tex2D<float4>(t4tex, (float)x + 0.5f, (float)y + 0.5f));
     }
 }
 
-__global__ void reprojTarTexLAB_kernel(uchar4* texs, int texs_p, int width, int height, float fpPlaneDepth)
+__global__ void reprojTarTexLAB_kernel(cudaTextureObject_t t4tex, uchar4* texs, int texs_p, int width, int height,
+                                       float fpPlaneDepth)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
@@ -269,7 +271,7 @@ __global__ void reprojTarTexLAB_kernel(uchar4* texs, int texs_p, int width, int
         if(((tpc.x + 0.5f) > 0.0f) && ((tpc.y + 0.5f) > 0.0f) &&
            ((tpc.x + 0.5f) < (float)width - 1.0f) && ((tpc.y + 0.5f) < (float)height - 1.0f))
         {
-            *tex = float4_to_uchar4(255.0f * tex2D(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
+            *tex = float4_to_uchar4(255.0f * tex2D<float4>(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
         }
         else
         {
@@ -604,6 +606,7 @@ __global__ void updateBestDepth_kernel(
 }
 
 __global__ void downscale_gauss_smooth_lab_kernel(
+    cudaTextureObject_t r4tex,
     uchar4* texLab, int texLab_p,
     int width, int height, int scale, int radius)
 {
@@ -618,8 +621,8 @@ __global__ void downscale_gauss_smooth_lab_kernel(
         {
             for(int j = -radius; j <= radius; j++)
             {
-                float4 curPix = 255.0f * tex2D(r4tex, (float)(x * scale + j) + (float)scale / 2.0f,
-                                               (float)(y * scale + i) + (float)scale / 2.0f);
+                float4 curPix = 255.0f * tex2D<float4>(r4tex, (float)(x * scale + j) + (float)scale / 2.0f,
+                                                       (float)(y * scale + i) + (float)scale / 2.0f);
                 float factor = (tex1D(gaussianTex, i + radius) * tex1D(gaussianTex, j + radius)); // domain factor
                 t = t + curPix * factor;
                 sum += factor;
@@ -150,7 +150,8 @@ __global__ void refine_computeDepthsMapFromDepthMap_kernel(float3* depthsMap, in
     };
 }
 
-__global__ void refine_reprojTarTexLABByDepthsMap_kernel(float3* depthsMap, int depthsMap_p, uchar4* tex, int tex_p,
+__global__ void refine_reprojTarTexLABByDepthsMap_kernel(cudaTextureObject_t t4tex, float3* depthsMap,
+                                                         int depthsMap_p, uchar4* tex, int tex_p,
                                                          int width, int height, int id)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
@@ -183,7 +184,7 @@ __global__ void refine_reprojTarTexLABByDepthsMap_kernel(float3* depthsMap, int
             if(((tpc.x + 0.5f) > 0.0f) && ((tpc.y + 0.5f) > 0.0f) && ((tpc.x + 0.5f) < (float)width - 1.0f) &&
                ((tpc.y + 0.5f) < (float)height - 1.0f))
             {
-                tex[y * tex_p + x] = float4_to_uchar4(255.0f * tex2D(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
+                tex[y * tex_p + x] = float4_to_uchar4(255.0f * tex2D<float4>(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
             }
             else
             {
@@ -196,8 +197,8 @@ __global__ void refine_reprojTarTexLABByDepthsMap_kernel(float3* depthsMap, int
     };
 }
 
-__global__ void refine_reprojTarTexLABByDepthMap_kernel(float* depthMap, int depthMap_p, uchar4* tex, int tex_p,
-                                                        int width, int height)
+__global__ void refine_reprojTarTexLABByDepthMap_kernel(cudaTextureObject_t t4tex, float* depthMap, int depthMap_p,
+                                                        uchar4* tex, int tex_p, int width, int height)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
@@ -217,7 +218,7 @@ __global__ void refine_reprojTarTexLABByDepthMap_kernel(float* depthMap, int dep
             if(((tpc.x + 0.5f) > 0.0f) && ((tpc.y + 0.5f) > 0.0f) && ((tpc.x + 0.5f) < (float)width - 1.0f) &&
                ((tpc.y + 0.5f) < (float)height - 1.0f))
             {
-                ocol = float4_to_uchar4(255.0f * tex2D(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
+                ocol = float4_to_uchar4(255.0f * tex2D<float4>(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
             };
         };
 
@@ -225,9 +226,9 @@ __global__ void refine_reprojTarTexLABByDepthMap_kernel(float* depthMap, int dep
     };
 }
 
-__global__ void refine_reprojTarTexLABByDepthMapMovedByStep_kernel(float* depthMap, int depthMap_p, uchar4* tex,
-                                                                   int tex_p, int width, int height, bool moveByTcOrRc,
-                                                                   float step)
+__global__ void refine_reprojTarTexLABByDepthMapMovedByStep_kernel(cudaTextureObject_t t4tex, float* depthMap,
+                                                                   int depthMap_p, uchar4* tex, int tex_p, int width,
+                                                                   int height, bool moveByTcOrRc, float step)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
@@ -263,7 +264,7 @@ __global__ void refine_reprojTarTexLABByDepthMapMovedByStep_kernel(float* depthM
             if(((tpc.x + 0.5f) > 0.0f) && ((tpc.y + 0.5f) > 0.0f) && ((tpc.x + 0.5f) < (float)width - 1.0f) &&
                ((tpc.y + 0.5f) < (float)height - 1.0f))
             {
-                ocol = float4_to_uchar4(255.0f * tex2D(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
+                ocol = float4_to_uchar4(255.0f * tex2D<float4>(t4tex, (float)tpc.x + 0.5f, (float)tpc.y + 0.5f));
             };
         };
 
@@ -490,7 +491,8 @@ __global__ void refine_fuseThreeDepthSimMaps_kernel(float* osim, int osim_p, flo
     };
 }
 
-__global__ void refine_compUpdateYKNCCSimMapPatch_kernel(float* osimMap, int osimMap_p, float* odptMap, int odptMap_p,
+__global__ void refine_compUpdateYKNCCSimMapPatch_kernel(cudaTextureObject_t r4tex, cudaTextureObject_t t4tex,
+                                                         float* osimMap, int osimMap_p, float* odptMap, int odptMap_p,
                                                          float* depthMap, int depthMap_p, int width, int height,
                                                          int wsh, const float gammaC, const float gammaP,
                                                          const float epipShift, const float tcStep, int id,
@@ -522,7 +524,7 @@ __global__ void refine_compUpdateYKNCCSimMapPatch_kernel(float* osimMap, int osi
             ptch.d = computePixSize(p);
             // TODO: we could compute the orientation of the path from the input depth map instead of relying on the cameras orientations
             computeRotCSEpip(ptch, p);
-            osim = compNCCby3DptsYK(ptch, wsh, imWidth, imHeight, gammaC, gammaP, epipShift);
+            osim = compNCCby3DptsYK(r4tex, t4tex, ptch, wsh, imWidth, imHeight, gammaC, gammaP, epipShift);
         }
 
         float* osim_ptr = get2DBufferAt(osimMap, osimMap_p, x, y);
@@ -571,7 +573,8 @@ __global__ void refine_coputeDepthStepMap_kernel(float* depthStepMap, int depthS
     };
 }
 
-__global__ void refine_compYKNCCDepthSimMapPatch_kernel(float2* oDepthSimMap, int oDepthSimMap_p, float* depthMap,
+__global__ void refine_compYKNCCDepthSimMapPatch_kernel(cudaTextureObject_t r4tex, cudaTextureObject_t t4tex,
+                                                        float2* oDepthSimMap, int oDepthSimMap_p, float* depthMap,
                                                         int depthMap_p, int width, int height, int wsh,
                                                         const float gammaC, const float gammaP, const float epipShift,
                                                         const float tcStep, bool moveByTcOrRc)
@@ -599,14 +602,15 @@ __global__ void refine_compYKNCCDepthSimMapPatch_kernel(float2* oDepthSimMap, in
             computeRotCSEpip(ptch, p);
 
             oDepthSim.x = size(sg_s_rC - ptch.p);
-            oDepthSim.y = compNCCby3DptsYK(ptch, wsh, width, height, gammaC, gammaP, epipShift);
+            oDepthSim.y = compNCCby3DptsYK(r4tex, t4tex, ptch, wsh, width, height, gammaC, gammaP, epipShift);
         };
 
         oDepthSimMap[y * oDepthSimMap_p + x] = oDepthSim;
     };
 }
 
-__global__ void refine_compYKNCCSimMapPatch_kernel(float* osimMap, int osimMap_p, float* depthMap, int depthMap_p,
+__global__ void refine_compYKNCCSimMapPatch_kernel(cudaTextureObject_t r4tex, cudaTextureObject_t t4tex,
+                                                   float* osimMap, int osimMap_p, float* depthMap, int depthMap_p,
                                                    int width, int height, int wsh, const float gammaC,
                                                    const float gammaP, const float epipShift, const float tcStep,
                                                    bool moveByTcOrRc, int xFrom, int imWidth, int imHeight)
@@ -633,13 +637,14 @@ __global__ void refine_compYKNCCSimMapPatch_kernel(float* osimMap, int osimMap_p
             ptch.p = p;
             ptch.d = computePixSize(p);
             computeRotCSEpip(ptch, p);
-            osim = compNCCby3DptsYK(ptch, wsh, imWidth, imHeight, gammaC, gammaP, epipShift);
+            osim = compNCCby3DptsYK(r4tex, t4tex, ptch, wsh, imWidth, imHeight, gammaC, gammaP, epipShift);
         };
         *get2DBufferAt(osimMap, osimMap_p, x, y) = osim;
     };
 }
 
-__global__ void refine_compYKNCCSimMapPatchDMS_kernel(float* osimMap, int osimMap_p, float* depthMap, int depthMap_p,
+__global__ void refine_compYKNCCSimMapPatchDMS_kernel(cudaTextureObject_t r4tex, cudaTextureObject_t t4tex,
+                                                      float* osimMap, int osimMap_p, float* depthMap, int depthMap_p,
                                                       int width, int height, int wsh, const float gammaC,
                                                       const float gammaP, const float epipShift,
                                                       const float depthMapShift)
@@ -663,7 +668,7 @@ __global__ void refine_compYKNCCSimMapPatchDMS_kernel(float* osimMap, int osimMa
             ptch.p = p;
             ptch.d = computePixSize(p);
             computeRotCSEpip(ptch, p);
-            osim = compNCCby3DptsYK(ptch, wsh, width, height, gammaC, gammaP, epipShift);
+            osim = compNCCby3DptsYK(r4tex, t4tex, ptch, wsh, width, height, gammaC, gammaP, epipShift);
         };
 
         osimMap[y * osimMap_p + x] = osim;
@@ -739,6 +744,31 @@ __global__ void refine_computeDepthSimMapFromLastThreeSimsMap_kernel(float* osim
     };
 }
 
+__global__ void refine_packDepthSimMap_kernel(float2* out, int out_p, float* bestSimMap, int bestSimMap_p,
+                                              float* bestDptMap, int bestDptMap_p, float* rcDepthMap,
+                                              int rcDepthMap_p, int width, int height)
+{
+    int x = blockIdx.x * blockDim.x + threadIdx.x;
+    int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if((x < width) && (y < height))
+    {
+        float sim = *get2DBufferAt(bestSimMap, bestSimMap_p, x, y);
+        float depth = *get2DBufferAt(bestDptMap, bestDptMap_p, x, y);
+        float2* out_ptr = get2DBufferAt(out, out_p, x, y);
+
+        if((depth > 0.0f) && (sim < 1.0f))
+        {
+            *out_ptr = make_float2(depth, sim);
+        }
+        else
+        {
+            // keep the input depth, as the per-tc maps were initialized on the host
+            *out_ptr = make_float2(*get2DBufferAt(rcDepthMap, rcDepthMap_p, x, y), 1.0f);
+        }
+    };
+}
+
 __global__ void refine_updateLastThreeSimsMap_kernel(float3* lastThreeSimsMap, int lastThreeSimsMap_p, float* simMap,
                                                      int simMap_p, int width, int height, int id)
 {
@@ -883,9 +913,9 @@ __global__ void refine_computeDepthSimMapFromBestStatMap_kernel(float* simMap, i
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-__global__ void refine_reprojTarTexLABByRcTcDepthsMap_kernel(uchar4* tex, int tex_p, float* rcDepthMap,
-                                                             int rcDepthMap_p, int width, int height,
-                                                             float depthMapShift)
+__global__ void refine_reprojTarTexLABByRcTcDepthsMap_kernel(cudaTextureObject_t t4tex, uchar4* tex, int tex_p,
+                                                             float* rcDepthMap, int rcDepthMap_p, int width,
+                                                             int height, float depthMapShift)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
@@ -919,7 +949,7 @@ __global__ void refine_reprojTarTexLABByRcTcDepthsMap_kernel(uchar4* tex, int te
                 {
                     // col = float4_to_uchar4(255.0f*tex2D(t4tex, (float)tpc.x+0.5f, (float)tpc.y+0.5f));
                     // col = float4_to_uchar4(255.0f*tex2D(t4tex, tpc.x, tpc.y));
-                    col = float4_to_uchar4(255.0f * tex2D(t4tex, tpcS.x, tpcS.y));
+                    col = float4_to_uchar4(255.0f * tex2D<float4>(t4tex, tpcS.x, tpcS.y));
                 };
             };
         };
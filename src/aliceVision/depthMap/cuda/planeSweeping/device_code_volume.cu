@@ -21,7 +21,8 @@ __device__ void volume_computePatch(patch& ptch, int depthid, int2& pix)
     computeRotCSEpip(ptch, p);
 }
 
-__global__ void volume_slice_kernel(unsigned char* slice, int slice_p,
+__global__ void volume_slice_kernel(cudaTextureObject_t r4tex, cudaTextureObject_t t4tex,
+                                    unsigned char* slice, int slice_p,
                                     // float3* slicePts, int slicePts_p,
                                     int nsearchdepths, int ndepths, int slicesAtTime, int width, int height, int wsh,
                                     int t, int npixs, const float gammaC, const float gammaP, const float epipShift)
@@ -40,7 +41,7 @@ __global__ void volume_slice_kernel(unsigned char* slice, int slice_p,
             patch ptcho;
             volume_computePatch(ptcho, depthid, pix);
 
-            float fsim = compNCCby3DptsYK(ptcho, wsh, width, height, gammaC, gammaP, epipShift);
+            float fsim = compNCCby3DptsYK(r4tex, t4tex, ptcho, wsh, width, height, gammaC, gammaP, epipShift);
             // unsigned char sim = (unsigned char)(((fsim+1.0f)/2.0f)*255.0f);
 
             float fminVal = -1.0f;
@@ -156,6 +157,44 @@ __global__ void volume_transposeVolume_kernel(T* volumeT, int volumeT_s, int vol
     }
 }
 
+/**
+ * Same as volume_transposeVolume_kernel but the input is a single XY slice of
+ * the volume (the slice at depth z), so the untransposed volume does not have
+ * to be resident on the device.
+ */
+template <typename T>
+__global__ void volume_transposeVolumeSlice_kernel(T* volumeT, int volumeT_s, int volumeT_p,
+                                                   const T* sliceZ, int sliceZ_p,
+                                                   int volDimX, int volDimY, int volDimZ,
+                                                   int dimTrnX, int dimTrnY, int dimTrnZ,
+                                                   int z)
+{
+    int vx = blockIdx.x * blockDim.x + threadIdx.x;
+    int vy = blockIdx.y * blockDim.y + threadIdx.y;
+    int vz = z;
+
+    if((vx >= 0) && (vx < volDimX) && (vy >= 0) && (vy < volDimY) && (vz >= 0) && (vz < volDimZ))
+    {
+        int v[3];
+        v[0] = vx;
+        v[1] = vy;
+        v[2] = vz;
+
+        int dimsTrn[3];
+        dimsTrn[0] = dimTrnX;
+        dimsTrn[1] = dimTrnY;
+        dimsTrn[2] = dimTrnZ;
+
+        int vTx = v[dimsTrn[0]];
+        int vTy = v[dimsTrn[1]];
+        int vTz = v[dimsTrn[2]];
+
+        T* oldVal_ptr = get3DBufferAt(volumeT, volumeT_s, volumeT_p, vTx, vTy, vTz);
+        T newVal = *get2DBufferAt(sliceZ, sliceZ_p, vx, vy);
+        *oldVal_ptr = newVal;
+    }
+}
+
 template <typename T>
 __global__ void volume_shiftZVolumeTempl_kernel(T* volume, int volume_s, int volume_p, int volDimX, int volDimY,
                                                 int volDimZ, int vz)
@@ -291,7 +330,8 @@ __global__ void volume_computeBestXSliceUInt_kernel(unsigned int* xsliceBestInCo
  * @param[in] xSliceBestInColCst
  * @param[out] volSimT output similarity volume
  */
-__global__ void volume_agregateCostVolumeAtZinSlices_kernel(unsigned int* xySliceForZ, int xySliceForZ_p,
+__global__ void volume_agregateCostVolumeAtZinSlices_kernel(cudaTextureObject_t r4tex,
+                                                            unsigned int* xySliceForZ, int xySliceForZ_p,
                                                             const unsigned int* xySliceForZM1, int xySliceForZM1_p,
                                                             const unsigned int* xSliceBestInColSimForZM1,
                                                             unsigned char* volSimT, int volSimT_s, int volSimT_p, 
@@ -317,8 +357,8 @@ __global__ void volume_agregateCostVolumeAtZinSlices_kernel(unsigned int* xySlic
             int imY0 = volLUY + (dimTrnX == 0) ?  z : vx;
             int imX1 = volLUX + (dimTrnX == 0) ? vx : z1; // M1
             int imY1 = volLUY + (dimTrnX == 0) ? z1 : vx;
-            float4 gcr0 = 255.0f * tex2D(r4tex, (float)imX0 + 0.5f, (float)imY0 + 0.5f);
-            float4 gcr1 = 255.0f * tex2D(r4tex, (float)imX1 + 0.5f, (float)imY1 + 0.5f);
+            float4 gcr0 = 255.0f * tex2D<float4>(r4tex, (float)imX0 + 0.5f, (float)imY0 + 0.5f);
+            float4 gcr1 = 255.0f * tex2D<float4>(r4tex, (float)imX1 + 0.5f, (float)imY1 + 0.5f);
             float deltaC = Euclidean3(gcr0, gcr1);
             // unsigned int P1 = (unsigned int)sigmoid(5.0f,20.0f,60.0f,10.0f,deltaC);
             unsigned int P1 = _P1;
@@ -17,6 +17,7 @@
 
 #include <math_constants.h>
 
+#include <cstring>
 #include <iostream>
 #include <algorithm>
 
@@ -36,6 +37,36 @@ namespace depthMap {
 }
 
 
+
+/**
+ * @brief Create a texture object over a camera image array (in Lab colorspace).
+ *
+ * The descriptor replicates the settings of the former global r4tex/t4tex
+ * texture references: bilinear filtering, unnormalized coordinates, uchar4
+ * texels read as normalized floats and clamp addressing. The object is passed
+ * to the kernels as a parameter, so kernels reading different cameras can run
+ * concurrently instead of serializing on a global rebind.
+ */
+__host__ cudaTextureObject_t ps_createCamTexObject(CudaArray<uchar4, 2>* arr)
+{
+    cudaResourceDesc resDesc;
+    memset(&resDesc, 0, sizeof(cudaResourceDesc));
+    resDesc.resType = cudaResourceTypeArray;
+    resDesc.res.array.array = arr->getArray();
+
+    cudaTextureDesc texDesc;
+    memset(&texDesc, 0, sizeof(cudaTextureDesc));
+    texDesc.addressMode[0] = cudaAddressModeClamp;
+    texDesc.addressMode[1] = cudaAddressModeClamp;
+    texDesc.filterMode = cudaFilterModeLinear;
+    texDesc.readMode = cudaReadModeNormalizedFloat;
+    texDesc.normalizedCoords = 0;
+
+    cudaTextureObject_t tex = 0;
+    cudaCreateTextureObject(&tex, &resDesc, &texDesc, NULL);
+    return tex;
+}
+
 __host__ float3 ps_M3x3mulV3(float* M3x3, const float3& V)
 {
     return make_float3(M3x3[0] * V.x + M3x3[3] * V.y + M3x3[6] * V.z, M3x3[1] * V.x + M3x3[4] * V.y + M3x3[7] * V.z,
@@ -67,6 +98,17 @@ void pr_printfDeviceMemoryInfo()
     printf("Device %i memory - used: %f, free: %f, total: %f\n", CUDAdeviceNo, used, avail, total);
 }
 
+float ps_getFreeDeviceMemoryMB(int CUDAdeviceNo)
+{
+    cudaSetDevice(CUDAdeviceNo);
+
+    size_t iavail;
+    size_t itotal;
+    cudaMemGetInfo(&iavail, &itotal);
+
+    return (float)iavail / (1024.0f * 1024.0f);
+}
+
 float3 ps_getDeviceMemoryInfo()
 {
     size_t iavail;
@@ -251,11 +293,6 @@ void ps_deviceAllocate(CudaArray<uchar4, 2>*** ps_texs_arr, int ncams, int width
     ttex.filterMode = cudaFilterModeLinear;
     ttex.normalized = false;
 
-    r4tex.filterMode = cudaFilterModeLinear;
-    r4tex.normalized = false;
-    t4tex.filterMode = cudaFilterModeLinear;
-    t4tex.normalized = false;
-
     rTexU4.filterMode = cudaFilterModePoint;
     rTexU4.normalized = false;
     tTexU4.filterMode = cudaFilterModePoint;
@@ -346,17 +383,19 @@ void ps_deviceUpdateCam(CudaArray<uchar4, 2>** ps_texs_arr, cameraStruct* cam, i
 
         if(varianceWsh > 0)
         {
-            cudaBindTextureToArray(r4tex, ps_texs_arr[camId * scales + 0]->getArray(), cudaCreateChannelDesc<uchar4>());
-            compute_varLofLABtoW_kernel<<<grid, block>>>(tex_lab_dmp.getBuffer(),
+            cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[camId * scales + 0]);
+            compute_varLofLABtoW_kernel<<<grid, block>>>(r4tex,
+                                                         tex_lab_dmp.getBuffer(),
                                                          tex_lab_dmp.getPitch(),
                                                          w, h,
                                                          varianceWsh);
-            cudaUnbindTexture(r4tex);
+            cudaDestroyTextureObject(r4tex);
             copy((*ps_texs_arr[camId * scales + 0]), tex_lab_dmp);
         }
     }
 
-    cudaBindTextureToArray(r4tex, ps_texs_arr[camId * scales + 0]->getArray(), cudaCreateChannelDesc<uchar4>());
+    // texture object over the full-scale image, read by the downscale kernel
+    cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[camId * scales + 0]);
 
     // for each scale
     for(int scale = 1; scale < scales; scale++)
@@ -373,6 +412,7 @@ void ps_deviceUpdateCam(CudaArray<uchar4, 2>** ps_texs_arr, cameraStruct* cam, i
         // downscale_bilateral_smooth_lab_kernel<<<grid, block>>>(
         downscale_gauss_smooth_lab_kernel<<<grid, block>>>(
             // downscale_mean_smooth_lab_kernel<<<grid, block>>>(
+            r4tex,
             tex_lab_dmp.getBuffer(),
             tex_lab_dmp.getPitch(),
             w / (scale + 1), h / (scale + 1), scale + 1,
@@ -382,23 +422,21 @@ void ps_deviceUpdateCam(CudaArray<uchar4, 2>** ps_texs_arr, cameraStruct* cam, i
 
         if(varianceWsh > 0)
         {
-            cudaUnbindTexture(r4tex);
-            cudaBindTextureToArray(r4tex, ps_texs_arr[camId * scales + scale]->getArray(),
-                                   cudaCreateChannelDesc<uchar4>());
+            cudaTextureObject_t r4texAtScale = ps_createCamTexObject(ps_texs_arr[camId * scales + scale]);
             compute_varLofLABtoW_kernel<<<grid, block>>>(
+                r4texAtScale,
                 tex_lab_dmp.getBuffer(),
                 tex_lab_dmp.getPitch(),
                 w / (scale + 1), h / (scale + 1), varianceWsh);
-            cudaUnbindTexture(r4tex);
+            cudaDestroyTextureObject(r4texAtScale);
             copy((*ps_texs_arr[camId * scales + scale]), tex_lab_dmp);
-            cudaBindTextureToArray(r4tex, ps_texs_arr[camId * scales + 0]->getArray(), cudaCreateChannelDesc<uchar4>());
         }
 
         cudaUnbindTexture(gaussianTex);
         cudaFreeArray(gaussian_arr);
     }
 
-    cudaUnbindTexture(r4tex);
+    cudaDestroyTextureObject(r4tex);
 
     CHECK_CUDA_ERROR();
 }
@@ -412,6 +450,9 @@ void ps_deviceDeallocate(CudaArray<uchar4, 2>*** ps_texs_arr, int CUDAdeviceNo,
         delete(*ps_texs_arr)[c];
     }
     delete[](*ps_texs_arr);
+
+    // release the device memory blocks cached by the pool during the runs
+    CudaDeviceMemoryPool::getInstance().clear();
 }
 
 void ps_aggregatePathVolume2(CudaDeviceMemoryPitched<unsigned char, 3>& vol_dmp, int volDimX, int volDimY,
@@ -467,7 +508,8 @@ void ps_aggregatePathVolume2(CudaDeviceMemoryPitched<unsigned char, 3>& vol_dmp,
 /**
  * @param[inout] d_volSimT similarity volume with some transposition applied
  */
-void ps_aggregatePathVolume(CudaDeviceMemoryPitched<unsigned char, 3>& d_volSimT,
+void ps_aggregatePathVolume(cudaTextureObject_t r4tex,
+                            CudaDeviceMemoryPitched<unsigned char, 3>& d_volSimT,
                             int volDimX, int volDimY, int volDimZ,
                             float P1, float P2, bool transfer,
                             int volLUX, int volLUY,
@@ -535,6 +577,7 @@ void ps_aggregatePathVolume(CudaDeviceMemoryPitched<unsigned char, 3>& d_volSimT
         CHECK_CUDA_ERROR();
 
         volume_agregateCostVolumeAtZinSlices_kernel<<<gridvolrowAllCols, blockvolrow>>>(
+            r4tex,
             d_xySliceForZ.getBuffer(), d_xySliceForZ.getPitch(),              // inout: xySliceForZ
             d_xySliceForZM1.getBuffer(), d_xySliceForZM1.getPitch(),          // in:    xySliceForZM1
             d_xSliceBestInColSimForZM1.getBuffer(),                          // in:    xSliceBestInColSimForZM1
@@ -553,10 +596,12 @@ void ps_aggregatePathVolume(CudaDeviceMemoryPitched<unsigned char, 3>& d_volSimT
 
 /**
  * @param[out] volAgr_dmp output volume where we will aggregate the best XXX
- * @param[in] d_volSim input similarity volume
+ * @param[in] ivol_hmh input similarity volume, on the host; it is uploaded
+ *            slice by slice so that only its transposed copy lives on the device
  */
-void ps_updateAggrVolume(CudaDeviceMemoryPitched<unsigned char, 3>& volAgr_dmp,
-                         const CudaDeviceMemoryPitched<unsigned char, 3>& d_volSim,
+void ps_updateAggrVolume(cudaTextureObject_t r4tex,
+                         CudaDeviceMemoryPitched<unsigned char, 3>& volAgr_dmp,
+                         const unsigned char* ivol_hmh,
                          int volDimX, int volDimY, int volDimZ,
                          int volStepXY, int volLUX, int volLUY,
                          int dimTrnX, int dimTrnY, int dimTrnZ,
@@ -594,15 +639,23 @@ void ps_updateAggrVolume(CudaDeviceMemoryPitched<unsigned char, 3>& volAgr_dmp,
     // clock_t tall = tic();
     CudaDeviceMemoryPitched<unsigned char, 3> d_volSimT(
         CudaSize<3>(volDims[dimsTrn[0]], volDims[dimsTrn[1]], volDims[dimsTrn[2]]));
+    CudaDeviceMemoryPitched<unsigned char, 2> volSlice_dmp(CudaSize<2>(volDimX, volDimY));
     for(int z = 0; z < volDimZ; z++)
     {
-        volume_transposeVolume_kernel<<<grid, block>>>(
+        cudaError_t err = cudaMemcpy2D(volSlice_dmp.getBytePtr(),
+                                       volSlice_dmp.getPitch(),
+                                       ivol_hmh + (size_t)z * volDimX * volDimY,
+                                       volDimX * sizeof(unsigned char),
+                                       volDimX * sizeof(unsigned char),
+                                       volDimY,
+                                       cudaMemcpyHostToDevice);
+        THROW_ON_CUDA_ERROR(err, "Failed to copy (" << __FILE__ << " " << __LINE__ << ")");
+        volume_transposeVolumeSlice_kernel<<<grid, block>>>(
             d_volSimT.getBuffer(),
             d_volSimT.getBytesPaddedUpToDim(1),
             d_volSimT.getBytesPaddedUpToDim(0), // output
-            d_volSim.getBuffer(),
-            d_volSim.getBytesPaddedUpToDim(1),
-            d_volSim.getBytesPaddedUpToDim(0), // input
+            volSlice_dmp.getBuffer(),
+            volSlice_dmp.getPitch(), // input slice at depth z
             volDimX, volDimY, volDimZ,
             dimTrnX, dimTrnY, dimTrnZ,
             z);
@@ -629,6 +682,7 @@ void ps_updateAggrVolume(CudaDeviceMemoryPitched<unsigned char, 3>& volAgr_dmp,
 
     // clock_t tall = tic();
     ps_aggregatePathVolume(
+        r4tex,
         d_volSimT, volDims[dimsTrn[0]], volDims[dimsTrn[1]], volDims[dimsTrn[2]],
         P1, P2, false,
         volLUX, volLUY,
@@ -694,13 +748,8 @@ void ps_SGMoptimizeSimVolume(CudaArray<uchar4, 2>** ps_texs_arr,
 
     ps_init_reference_camera_matrices(rccam->P, rccam->iP, rccam->R, rccam->iR, rccam->K, rccam->iK, rccam->C);
 
-    // bind 'r4tex' from the image in Lab colorspace at the scale used
-    cudaBindTextureToArray(r4tex, ps_texs_arr[rccam->camId * scales + scale]->getArray(),
-                           cudaCreateChannelDesc<uchar4>());
-
-    //CudaDeviceMemoryPitched<unsigned char, 3> volSim_dmp(*iovol_hmh);
-    CudaDeviceMemoryPitched<unsigned char, 3> volSim_dmp(CudaSize<3>(volDimX, volDimY, volDimZ));
-    copy(volSim_dmp, iovol_hmh, volDimX, volDimY, volDimZ);
+    // texture object over the image in Lab colorspace at the scale used
+    cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[rccam->camId * scales + scale]);
 
     clock_t tall = tic();
 
@@ -715,14 +764,17 @@ void ps_SGMoptimizeSimVolume(CudaArray<uchar4, 2>** ps_texs_arr,
     // Don't need to initialize this buffer
     // ps_updateAggrVolume multiplies the initial value by npaths, which is 0 at first call
     CudaDeviceMemoryPitched<unsigned char, 3> volAgr_dmp(CudaSize<3>(volDimX, volDimY, volDimZ));
-    
+
     // update aggregation volume
+    // the input similarity volume stays on the host, ps_updateAggrVolume uploads
+    // it slice by slice, so only two full volumes are resident on the device
     int npaths = 0;
 
-    const auto updateAggrVolume = [&](int dimTrnX, int dimTrnY, int dimTrnZ, bool invZ) 
+    const auto updateAggrVolume = [&](int dimTrnX, int dimTrnY, int dimTrnZ, bool invZ)
                                   {
-                                      ps_updateAggrVolume(volAgr_dmp,
-                                                          volSim_dmp,
+                                      ps_updateAggrVolume(r4tex,
+                                                          volAgr_dmp,
+                                                          iovol_hmh,
                                                           volDimX, volDimY, volDimZ,
                                                           volStepXY, volLUX, volLUY,
                                                           dimTrnX, dimTrnY, dimTrnZ,
@@ -750,7 +802,7 @@ void ps_SGMoptimizeSimVolume(CudaArray<uchar4, 2>** ps_texs_arr,
     //copy((*iovol_hmh), volAgr_dmp);
     copy(iovol_hmh, volDimX, volDimY, volDimZ, volAgr_dmp);
 
-    cudaUnbindTexture(r4tex);
+    cudaDestroyTextureObject(r4tex);
 
     if(verbose)
         printf("ps_SGMoptimizeSimVolume done\n");
@@ -800,22 +852,21 @@ void ps_transposeVolume(CudaHostMemoryHeap<unsigned char, 3>* ovol_hmh,
 }
 
 void ps_computeSimilarityVolume(CudaArray<uchar4, 2>** ps_texs_arr,
-                                CudaDeviceMemoryPitched<unsigned char, 3>& vol_dmp, cameraStruct** cams, int ncams,
+                                CudaDeviceMemoryPitched<unsigned char, 3>& vol_dmp,
+                                CudaDeviceMemoryPitched<unsigned char, 2>& slice_dmp, cameraStruct** cams, int ncams,
                                 int width, int height, int volStepXY, int volDimX, int volDimY, int volDimZ, int volLUX,
-                                int volLUY, int volLUZ, CudaHostMemoryHeap<int4, 2>& volPixs_hmh,
-                                CudaHostMemoryHeap<float, 2>& depths_hmh, int nDepthsToSearch, int slicesAtTime,
+                                int volLUY, int volLUZ, CudaArray<int4, 2>& volPixs_arr,
+                                CudaArray<float, 2>& depths_arr, int nDepthsToSearch, int slicesAtTime,
                                 int ntimes, int npixs, int wsh, int kernelSizeHalf, int nDepths, int scale,
                                 int CUDAdeviceNo, int ncamsAllocated, int scales, bool verbose, bool doUsePixelsDepths,
                                 int nbest, bool useTcOrRcPixSize, float gammaC, float gammaP, bool subPixel,
-                                float epipShift)
+                                float epipShift, cudaStream_t stream)
 {
     clock_t tall = tic();
     testCUDAdeviceNo(CUDAdeviceNo);
 
     if(verbose)
         printf("nDepths %i, nDepthsToSearch %i \n", nDepths, nDepthsToSearch);
-    CudaArray<int4, 2> volPixs_arr(volPixs_hmh);
-    CudaArray<float, 2> depths_arr(depths_hmh);
 
     cudaBindTextureToArray(volPixsTex, volPixs_arr.getArray(), cudaCreateChannelDesc<int4>());
     cudaBindTextureToArray(depthsTex, depths_arr.getArray(), cudaCreateChannelDesc<float>());
@@ -829,20 +880,18 @@ void ps_computeSimilarityVolume(CudaArray<uchar4, 2>** ps_texs_arr,
     // setup cameras matrices to the constant memory
     ps_init_reference_camera_matrices(cams[0]->P, cams[0]->iP, cams[0]->R, cams[0]->iR, cams[0]->K, cams[0]->iK,
                                       cams[0]->C);
-    cudaBindTextureToArray(r4tex, ps_texs_arr[cams[0]->camId * scales + scale]->getArray(),
-                           cudaCreateChannelDesc<uchar4>());
+    cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[cams[0]->camId * scales + scale]);
 
     int c = 1;
     ps_init_target_camera_matrices(cams[c]->P, cams[c]->iP, cams[c]->R, cams[c]->iR, cams[c]->K, cams[c]->iK,
                                    cams[c]->C);
-    cudaBindTextureToArray(t4tex, ps_texs_arr[cams[c]->camId * scales + scale]->getArray(),
-                           cudaCreateChannelDesc<uchar4>());
+    cudaTextureObject_t t4tex = ps_createCamTexObject(ps_texs_arr[cams[c]->camId * scales + scale]);
 
     //--------------------------------------------------------------------------------------------------
     // init similarity volume
     for(int z = 0; z < volDimZ; z++)
     {
-        volume_initVolume_kernel<unsigned char><<<gridvol, blockvol>>>(
+        volume_initVolume_kernel<unsigned char><<<gridvol, blockvol, 0, stream>>>(
             vol_dmp.getBuffer(),
             vol_dmp.getBytesPaddedUpToDim(1),
             vol_dmp.getBytesPaddedUpToDim(0),
@@ -851,15 +900,15 @@ void ps_computeSimilarityVolume(CudaArray<uchar4, 2>** ps_texs_arr,
 
     //--------------------------------------------------------------------------------------------------
     // compute similarity volume
-    CudaDeviceMemoryPitched<unsigned char, 2> slice_dmp(CudaSize<2>(nDepthsToSearch, slicesAtTime));
     for(int t = 0; t < ntimes; t++)
     {
-        volume_slice_kernel<<<grid, block>>>(slice_dmp.getBuffer(),
+        volume_slice_kernel<<<grid, block, 0, stream>>>(r4tex, t4tex,
+                                             slice_dmp.getBuffer(),
                                              slice_dmp.getPitch(),
                                              nDepthsToSearch, nDepths,
                                              slicesAtTime, width, height, wsh, t, npixs, gammaC, gammaP, epipShift);
 
-        volume_saveSliceToVolume_kernel<<<grid, block>>>(vol_dmp.getBuffer(),
+        volume_saveSliceToVolume_kernel<<<grid, block, 0, stream>>>(vol_dmp.getBuffer(),
                                                          vol_dmp.getBytesPaddedUpToDim(1),
                                                          vol_dmp.getBytesPaddedUpToDim(0),
                                                          slice_dmp.getBuffer(),
@@ -870,8 +919,11 @@ void ps_computeSimilarityVolume(CudaArray<uchar4, 2>** ps_texs_arr,
         CHECK_CUDA_ERROR();
     }
 
-    cudaUnbindTexture(r4tex);
-    cudaUnbindTexture(t4tex);
+    // the kernels on the stream may still be running: wait for them before
+    // destroying the texture objects they read from
+    cudaStreamSynchronize(stream);
+    cudaDestroyTextureObject(r4tex);
+    cudaDestroyTextureObject(t4tex);
     cudaUnbindTexture(volPixsTex);
     cudaUnbindTexture(depthsTex);
 
@@ -879,8 +931,43 @@ void ps_computeSimilarityVolume(CudaArray<uchar4, 2>** ps_texs_arr,
         printf("ps_computeSimilarityVolume elapsed time: %f ms \n", toc(tall));
 }
 
-float ps_planeSweepingGPUPixelsVolume(CudaArray<uchar4, 2>** ps_texs_arr,
-                                      unsigned char* ovol_hmh, cameraStruct** cams, int ncams,
+ps_sweepState* ps_createSweepState()
+{
+    ps_sweepState* state = new ps_sweepState;
+    cudaError_t err = cudaStreamCreate(&state->stream);
+    THROW_ON_CUDA_ERROR(err, "Failed to create a sweep stream (" << __FILE__ << " " << __LINE__ << ")");
+    state->volSim_dmp = NULL;
+    state->slice_dmp = NULL;
+    state->volPixs_arr = NULL;
+    state->depths_arr = NULL;
+    state->vol_hmh = NULL;
+    state->volPixs_hmh = NULL;
+    state->depths_hmh = NULL;
+    return state;
+}
+
+void ps_sweepStateWait(ps_sweepState* state)
+{
+    cudaError_t err = cudaStreamSynchronize(state->stream);
+    THROW_ON_CUDA_ERROR(err, "Failed to synchronize the sweep stream (" << __FILE__ << " " << __LINE__ << ")");
+}
+
+void ps_deleteSweepState(ps_sweepState* state)
+{
+    ps_sweepStateWait(state);
+    delete state->volSim_dmp;
+    delete state->slice_dmp;
+    delete state->volPixs_arr;
+    delete state->depths_arr;
+    delete state->vol_hmh;
+    delete state->volPixs_hmh;
+    delete state->depths_hmh;
+    cudaStreamDestroy(state->stream);
+    delete state;
+}
+
+float ps_planeSweepingGPUPixelsVolume(ps_sweepState* state, CudaArray<uchar4, 2>** ps_texs_arr,
+                                      cameraStruct** cams, int ncams,
                                       int width, int height, int volStepXY, int volDimX, int volDimY, int volDimZ,
                                       int volLUX, int volLUY, int volLUZ, CudaHostMemoryHeap<int4, 2>& volPixs_hmh,
                                       CudaHostMemoryHeap<float, 2>& depths_hmh, int nDepthsToSearch, int slicesAtTime,
@@ -891,7 +978,41 @@ float ps_planeSweepingGPUPixelsVolume(CudaArray<uchar4, 2>** ps_texs_arr,
 {
     testCUDAdeviceNo(CUDAdeviceNo);
 
-    CudaDeviceMemoryPitched<unsigned char, 3> volSim_dmp(CudaSize<3>(volDimX, volDimY, volDimZ));
+    // the buffers of the previous sweep cannot be reused before its completion
+    ps_sweepStateWait(state);
+
+    if((state->volSim_dmp == NULL) || (state->volSim_dmp->getSize() != CudaSize<3>(volDimX, volDimY, volDimZ)))
+    {
+        delete state->volSim_dmp;
+        state->volSim_dmp = new CudaDeviceMemoryPitched<unsigned char, 3>(CudaSize<3>(volDimX, volDimY, volDimZ));
+        delete state->vol_hmh;
+        state->vol_hmh = new CudaHostMemoryHeap<unsigned char, 3>(CudaSize<3>(volDimX, volDimY, volDimZ));
+    }
+    if((state->slice_dmp == NULL) || (state->slice_dmp->getSize() != CudaSize<2>(nDepthsToSearch, slicesAtTime)))
+    {
+        delete state->slice_dmp;
+        state->slice_dmp = new CudaDeviceMemoryPitched<unsigned char, 2>(CudaSize<2>(nDepthsToSearch, slicesAtTime));
+    }
+    if((state->volPixs_arr == NULL) || (state->volPixs_arr->getSize() != volPixs_hmh.getSize()))
+    {
+        delete state->volPixs_arr;
+        state->volPixs_arr = new CudaArray<int4, 2>(volPixs_hmh);
+    }
+    else
+    {
+        copy(*state->volPixs_arr, volPixs_hmh, state->stream);
+    }
+    if((state->depths_arr == NULL) || (state->depths_arr->getSize() != depths_hmh.getSize()))
+    {
+        delete state->depths_arr;
+        state->depths_arr = new CudaArray<float, 2>(depths_hmh);
+    }
+    else
+    {
+        copy(*state->depths_arr, depths_hmh, state->stream);
+    }
+
+    CudaDeviceMemoryPitched<unsigned char, 3>& volSim_dmp = *state->volSim_dmp;
 
     if(verbose)
         pr_printfDeviceMemoryInfo();
@@ -900,14 +1021,16 @@ float ps_planeSweepingGPUPixelsVolume(CudaArray<uchar4, 2>** ps_texs_arr,
 
     //--------------------------------------------------------------------------------------------------
     // compute similarity volume
-    ps_computeSimilarityVolume(ps_texs_arr, volSim_dmp, cams, ncams, width, height, volStepXY, volDimX, volDimY,
-                               volDimZ, volLUX, volLUY, volLUZ, volPixs_hmh, depths_hmh, nDepthsToSearch, slicesAtTime,
+    ps_computeSimilarityVolume(ps_texs_arr, volSim_dmp, *state->slice_dmp, cams, ncams, width, height, volStepXY,
+                               volDimX, volDimY, volDimZ, volLUX, volLUY, volLUZ, *state->volPixs_arr,
+                               *state->depths_arr, nDepthsToSearch, slicesAtTime,
                                ntimes, npixs, wsh, kernelSizeHalf, nDepths, scale, CUDAdeviceNo, ncamsAllocated, scales,
-                               verbose, doUsePixelsDepths, nbest, useTcOrRcPixSize, gammaC, gammaP, subPixel, epipShift);
+                               verbose, doUsePixelsDepths, nbest, useTcOrRcPixSize, gammaC, gammaP, subPixel, epipShift,
+                               state->stream);
 
     //--------------------------------------------------------------------------------------------------
-    // copy to host
-    copy(ovol_hmh, volDimX, volDimY, volDimZ, volSim_dmp);
+    // enqueue the copy to the pinned host buffer, the caller waits with ps_sweepStateWait()
+    copy(*state->vol_hmh, volSim_dmp, state->stream);
 
     return (float)volSim_dmp.getBytesPadded() / (1024.0f * 1024.0f);
 }
@@ -1140,7 +1263,8 @@ void ps_dilateMaskMap(CudaDeviceMemoryPitched<float, 2>& depthMap_dmp, int width
         width, height);
 }
 
-void ps_refineDepthMapInternal(CudaDeviceMemoryPitched<float, 2>& osimMap_dmp,
+void ps_refineDepthMapInternal(cudaTextureObject_t t4tex,
+                               CudaDeviceMemoryPitched<float, 2>& osimMap_dmp,
                                CudaDeviceMemoryPitched<float, 2>& odepthMap_dmp,
                                CudaDeviceMemoryPitched<float, 2>& idepthMap_dmp,
                                CudaDeviceMemoryPitched<float, 2>& idepthMapMask_dmp, int width, int height,
@@ -1166,6 +1290,7 @@ void ps_refineDepthMapInternal(CudaDeviceMemoryPitched<float, 2>& osimMap_dmp,
     for(int id = 0; id < 3; id++)
     {
         refine_reprojTarTexLABByDepthsMap_kernel<<<grid, block>>>(
+            t4tex,
             dsm_dmp.getBuffer(), dsm_dmp.getPitch(),
             timg_dmp.getBuffer(), timg_dmp.getPitch(),
             width, height, id);
@@ -1191,7 +1316,8 @@ void ps_refineDepthMapInternal(CudaDeviceMemoryPitched<float, 2>& osimMap_dmp,
         width, height, simThr);
 }
 
-void ps_computeSimMapForDepthMapInternal(CudaDeviceMemoryPitched<float, 2>& osimMap_dmp,
+void ps_computeSimMapForDepthMapInternal(cudaTextureObject_t t4tex,
+                                         CudaDeviceMemoryPitched<float, 2>& osimMap_dmp,
                                          CudaDeviceMemoryPitched<float, 2>& idepthMapMask_dmp, int width, int height,
                                          bool verbose, int wsh, float gammaC, float gammaP,
                                          CudaArray<uchar4, 2>& tTexU4_arr,
@@ -1204,6 +1330,7 @@ void ps_computeSimMapForDepthMapInternal(CudaDeviceMemoryPitched<float, 2>& osim
     dim3 grid(divUp(width, block_size), divUp(height, block_size), 1);
 
     reprojTarTexLAB_kernel<<<grid, block>>>(
+        t4tex,
         timg_dmp.getBuffer(), timg_dmp.getPitch(),
         width, height, fpPlaneDepth);
 
@@ -1233,14 +1360,12 @@ void ps_refineRcDepthMap(CudaArray<uchar4, 2>** ps_texs_arr, float* osimMap_hmh,
 
     ps_init_reference_camera_matrices(cams[0]->P, cams[0]->iP, cams[0]->R, cams[0]->iR, cams[0]->K, cams[0]->iK,
                                       cams[0]->C);
-    cudaBindTextureToArray(r4tex, ps_texs_arr[cams[0]->camId * scales + scale]->getArray(),
-                           cudaCreateChannelDesc<uchar4>());
+    cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[cams[0]->camId * scales + scale]);
 
     int c = 1;
     ps_init_target_camera_matrices(cams[c]->P, cams[c]->iP, cams[c]->R, cams[c]->iR, cams[c]->K, cams[c]->iK,
                                    cams[c]->C);
-    cudaBindTextureToArray(t4tex, ps_texs_arr[cams[c]->camId * scales + scale]->getArray(),
-                           cudaCreateChannelDesc<uchar4>());
+    cudaTextureObject_t t4tex = ps_createCamTexObject(ps_texs_arr[cams[c]->camId * scales + scale]);
 
     CudaDeviceMemoryPitched<float3, 2> lastThreeSimsMap(CudaSize<2>(width, height));
     CudaDeviceMemoryPitched<float, 2> simMap_dmp(CudaSize<2>(width, height));
@@ -1254,6 +1379,7 @@ void ps_refineRcDepthMap(CudaArray<uchar4, 2>** ps_texs_arr, float* osimMap_hmh,
     for(int i = 0; i < ntcsteps; i++) // Default ntcsteps = 31
     {
         refine_compUpdateYKNCCSimMapPatch_kernel<<<grid, block>>>(
+            r4tex, t4tex,
             bestSimMap_dmp.getBuffer(), bestSimMap_dmp.getPitch(),
             bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
             rcDepthMap_dmp.getBuffer(), rcDepthMap_dmp.getPitch(),
@@ -1267,6 +1393,7 @@ void ps_refineRcDepthMap(CudaArray<uchar4, 2>** ps_texs_arr, float* osimMap_hmh,
         width, height, 1);
 
     refine_compYKNCCSimMapPatch_kernel<<<grid, block>>>(
+        r4tex, t4tex,
         simMap_dmp.getBuffer(), simMap_dmp.getPitch(),
         bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
         width,
@@ -1279,6 +1406,7 @@ void ps_refineRcDepthMap(CudaArray<uchar4, 2>** ps_texs_arr, float* osimMap_hmh,
         width, height, 0);
 
     refine_compYKNCCSimMapPatch_kernel<<<grid, block>>>(
+        r4tex, t4tex,
         simMap_dmp.getBuffer(), simMap_dmp.getPitch(),
         bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
         width,
@@ -1299,6 +1427,9 @@ void ps_refineRcDepthMap(CudaArray<uchar4, 2>** ps_texs_arr, float* osimMap_hmh,
     copy(osimMap_hmh, width, height, bestSimMap_dmp);
     copy(rcDepthMap_hmh, width, height, bestDptMap_dmp);
 
+    cudaDestroyTextureObject(r4tex);
+    cudaDestroyTextureObject(t4tex);
+
     if(verbose)
         printf("gpu elapsed time: %f ms \n", toc(tall));
 }
@@ -1377,6 +1508,172 @@ void ps_fuseDepthSimMapsGaussianKernelVoting(CudaHostMemoryHeap<float2, 2>* odep
         printf("gpu elapsed time: %f ms \n", toc(tall));
 }
 
+/**
+ * @brief Refine the rc depth map against every tc camera and fuse the refined
+ * maps, keeping all the per-tc depth/sim maps resident on the device.
+ *
+ * The separate refineRcTcDepthMap/fuseDepthSimMapsGaussianKernelVoting path
+ * downloads every per-tc map to the host only to upload it again for the
+ * fusion; here only the rc depth/pixSize map goes up and the fused map comes
+ * back down.
+ *
+ * @param[in] cams rc camera followed by the ncams-1 tc cameras
+ * @param[in] rcDepthPixSizeMap_hmh rc depth and pixSize, fusion input 0
+ * @param[out] odepthSimMap_hmh fused depth/sim map
+ */
+void ps_refineAndFuseRcTcDepthSimMaps(CudaArray<uchar4, 2>** ps_texs_arr,
+                                      CudaHostMemoryHeap<float2, 2>* odepthSimMap_hmh,
+                                      CudaHostMemoryHeap<float2, 2>* rcDepthPixSizeMap_hmh, int ntcsteps,
+                                      cameraStruct** cams, int ncams, int width, int height, int scale,
+                                      int CUDAdeviceNo, int ncamsAllocated, int scales, bool verbose, int wsh,
+                                      float gammaC, float gammaP, float epipShift, bool moveByTcOrRc,
+                                      int nSamplesHalf, int nDepthsToRefine, float sigma)
+{
+    clock_t tall = tic();
+    testCUDAdeviceNo(CUDAdeviceNo);
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // setup block and grid
+    int block_size = 16;
+    dim3 block(block_size, block_size, 1);
+    dim3 grid(divUp(width, block_size), divUp(height, block_size), 1);
+
+    // the per-tc refined maps stay resident on the device for the fusion
+    CudaDeviceMemoryPitched<float2, 2>** depthSimMaps_dmp;
+    depthSimMaps_dmp = new CudaDeviceMemoryPitched<float2, 2>*[ncams];
+    for(int i = 0; i < ncams; i++)
+    {
+        depthSimMaps_dmp[i] = new CudaDeviceMemoryPitched<float2, 2>(CudaSize<2>(width, height));
+    }
+    copy((*depthSimMaps_dmp[0]), (*rcDepthPixSizeMap_hmh));
+
+    ps_init_reference_camera_matrices(cams[0]->P, cams[0]->iP, cams[0]->R, cams[0]->iR, cams[0]->K, cams[0]->iK,
+                                      cams[0]->C);
+    cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[cams[0]->camId * scales + scale]);
+
+    CudaDeviceMemoryPitched<float3, 2> lastThreeSimsMap(CudaSize<2>(width, height));
+    CudaDeviceMemoryPitched<float, 2> simMap_dmp(CudaSize<2>(width, height));
+    CudaDeviceMemoryPitched<float, 2> rcDepthMap_dmp(CudaSize<2>(width, height));
+    CudaDeviceMemoryPitched<float, 2> bestSimMap_dmp(CudaSize<2>(width, height));
+    CudaDeviceMemoryPitched<float, 2> bestDptMap_dmp(CudaSize<2>(width, height));
+
+    // extract the rc depths once from the uploaded depth/pixSize map
+    fuse_getOptDeptMapFromOPtDepthSimMap_kernel<<<grid, block>>>(
+        rcDepthMap_dmp.getBuffer(), rcDepthMap_dmp.getPitch(),
+        depthSimMaps_dmp[0]->getBuffer(), depthSimMaps_dmp[0]->getPitch(),
+        width, height);
+
+    for(int c = 1; c < ncams; c++) // number of Tc cameras
+    {
+        ps_init_target_camera_matrices(cams[c]->P, cams[c]->iP, cams[c]->R, cams[c]->iR, cams[c]->K, cams[c]->iK,
+                                       cams[c]->C);
+        cudaTextureObject_t t4tex = ps_createCamTexObject(ps_texs_arr[cams[c]->camId * scales + scale]);
+
+        for(int i = 0; i < ntcsteps; i++) // Default ntcsteps = 31
+        {
+            refine_compUpdateYKNCCSimMapPatch_kernel<<<grid, block>>>(
+                r4tex, t4tex,
+                bestSimMap_dmp.getBuffer(), bestSimMap_dmp.getPitch(),
+                bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
+                rcDepthMap_dmp.getBuffer(), rcDepthMap_dmp.getPitch(),
+                width, height, wsh, gammaC, gammaP, epipShift,
+                (float)(i - (ntcsteps - 1) / 2), i, moveByTcOrRc, 0, width, height);
+        }
+
+        refine_setLastThreeSimsMap_kernel<<<grid, block>>>(
+            lastThreeSimsMap.getBuffer(), lastThreeSimsMap.getPitch(),
+            bestSimMap_dmp.getBuffer(), bestSimMap_dmp.getPitch(),
+            width, height, 1);
+
+        refine_compYKNCCSimMapPatch_kernel<<<grid, block>>>(
+            r4tex, t4tex,
+            simMap_dmp.getBuffer(), simMap_dmp.getPitch(),
+            bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
+            width,
+            height, wsh, gammaC, gammaP, epipShift, -1.0f, moveByTcOrRc, 0, width, height);
+
+        refine_setLastThreeSimsMap_kernel<<<grid, block>>>(
+            lastThreeSimsMap.getBuffer(), lastThreeSimsMap.getPitch(),
+            simMap_dmp.getBuffer(), simMap_dmp.getPitch(),
+            width, height, 0);
+
+        refine_compYKNCCSimMapPatch_kernel<<<grid, block>>>(
+            r4tex, t4tex,
+            simMap_dmp.getBuffer(), simMap_dmp.getPitch(),
+            bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
+            width,
+            height, wsh, gammaC, gammaP, epipShift, +1.0f, moveByTcOrRc, 0, width, height);
+
+        refine_setLastThreeSimsMap_kernel<<<grid, block>>>(
+            lastThreeSimsMap.getBuffer(), lastThreeSimsMap.getPitch(),
+            simMap_dmp.getBuffer(), simMap_dmp.getPitch(),
+            width, height, 2);
+
+        refine_computeDepthSimMapFromLastThreeSimsMap_kernel<<<grid, block>>>(
+            bestSimMap_dmp.getBuffer(), bestSimMap_dmp.getPitch(),
+            bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
+            lastThreeSimsMap.getBuffer(), lastThreeSimsMap.getPitch(),
+            width, height, moveByTcOrRc, 0);
+
+        // keep refined values only where they beat the initial similarity,
+        // like the host-side merge of RcTc::refineRcTcDepthSimMap
+        refine_packDepthSimMap_kernel<<<grid, block>>>(
+            depthSimMaps_dmp[c]->getBuffer(), depthSimMaps_dmp[c]->getPitch(),
+            bestSimMap_dmp.getBuffer(), bestSimMap_dmp.getPitch(),
+            bestDptMap_dmp.getBuffer(), bestDptMap_dmp.getPitch(),
+            rcDepthMap_dmp.getBuffer(), rcDepthMap_dmp.getPitch(),
+            width, height);
+        CHECK_CUDA_ERROR();
+
+        cudaDestroyTextureObject(t4tex);
+    }
+
+    cudaDestroyTextureObject(r4tex);
+
+    //--------------------------------------------------------------------------------------------------
+    // fuse the resident per-tc maps by Gaussian kernel voting
+    float samplesPerPixSize = (float)(nSamplesHalf / ((nDepthsToRefine - 1) / 2));
+    float twoTimesSigmaPowerTwo = 2.0f * sigma * sigma;
+
+    CudaDeviceMemoryPitched<float2, 2> bestDepthSimMap_dmp(CudaSize<2>(width, height));
+    CudaDeviceMemoryPitched<float2, 2> bestGsvSampleMap_dmp(CudaSize<2>(width, height));
+    CudaDeviceMemoryPitched<float, 2> gsvSampleMap_dmp(CudaSize<2>(width, height));
+
+    for(int s = -nSamplesHalf; s <= nSamplesHalf; s++) // (-150, 150)
+    {
+        for(int c = 1; c < ncams; c++) // number of Tc cameras
+        {
+            fuse_computeGaussianKernelVotingSampleMap_kernel<<<grid, block>>>(
+                gsvSampleMap_dmp.getBuffer(), gsvSampleMap_dmp.getPitch(),
+                depthSimMaps_dmp[c]->getBuffer(), depthSimMaps_dmp[c]->getPitch(),
+                depthSimMaps_dmp[0]->getBuffer(), depthSimMaps_dmp[0]->getPitch(),
+                width, height, (float)s, c - 1, samplesPerPixSize, twoTimesSigmaPowerTwo);
+        }
+        fuse_updateBestGaussianKernelVotingSampleMap_kernel<<<grid, block>>>(
+            bestGsvSampleMap_dmp.getBuffer(), bestGsvSampleMap_dmp.getPitch(),
+            gsvSampleMap_dmp.getBuffer(), gsvSampleMap_dmp.getPitch(),
+            width, height, (float)s, s + nSamplesHalf);
+    }
+
+    fuse_computeFusedDepthSimMapFromBestGaussianKernelVotingSampleMap_kernel<<<grid, block>>>(
+        bestDepthSimMap_dmp.getBuffer(), bestDepthSimMap_dmp.getPitch(),
+        bestGsvSampleMap_dmp.getBuffer(), bestGsvSampleMap_dmp.getPitch(),
+        depthSimMaps_dmp[0]->getBuffer(), depthSimMaps_dmp[0]->getPitch(),
+        width, height, samplesPerPixSize);
+    CHECK_CUDA_ERROR();
+
+    copy((*odepthSimMap_hmh), bestDepthSimMap_dmp);
+
+    for(int i = 0; i < ncams; i++)
+    {
+        delete depthSimMaps_dmp[i];
+    }
+    delete[] depthSimMaps_dmp;
+
+    if(verbose)
+        printf("gpu elapsed time: %f ms \n", toc(tall));
+}
+
 void ps_optimizeDepthSimMapGradientDescent(CudaArray<uchar4, 2>** ps_texs_arr,
                                            CudaHostMemoryHeap<float2, 2>* odepthSimMap_hmh,
                                            CudaHostMemoryHeap<float2, 2>** dataMaps_hmh, int ndataMaps,
@@ -1396,8 +1693,7 @@ void ps_optimizeDepthSimMapGradientDescent(CudaArray<uchar4, 2>** ps_texs_arr,
 
     ps_init_reference_camera_matrices(cams[0]->P, cams[0]->iP, cams[0]->R, cams[0]->iR, cams[0]->K, cams[0]->iK,
                                       cams[0]->C);
-    cudaBindTextureToArray(r4tex, ps_texs_arr[cams[0]->camId * scales + scale]->getArray(),
-                           cudaCreateChannelDesc<uchar4>());
+    cudaTextureObject_t r4tex = ps_createCamTexObject(ps_texs_arr[cams[0]->camId * scales + scale]);
 
     CudaDeviceMemoryPitched<float2, 2>** dataMaps_dmp;
     dataMaps_dmp = new CudaDeviceMemoryPitched<float2, 2>*[ndataMaps];
@@ -1425,6 +1721,7 @@ void ps_optimizeDepthSimMapGradientDescent(CudaArray<uchar4, 2>** ps_texs_arr,
 
         // Adjust depth/sim by using previously computed depths (depthTex is accessed inside this kernel)
         fuse_optimizeDepthSimMap_kernel<<<grid, block>>>(
+            r4tex,
             optDepthSimMap_dmp.getBuffer(), optDepthSimMap_dmp.getPitch(),
             dataMaps_dmp[0]->getBuffer(), dataMaps_dmp[0]->getPitch(),
             dataMaps_dmp[1]->getBuffer(), dataMaps_dmp[1]->getPitch(),
@@ -1441,7 +1738,7 @@ void ps_optimizeDepthSimMapGradientDescent(CudaArray<uchar4, 2>** ps_texs_arr,
     }
     delete[] dataMaps_dmp;
 
-    cudaUnbindTexture(r4tex);
+    cudaDestroyTextureObject(r4tex);
 
     if(verbose)
         printf("gpu elapsed time: %f ms \n", toc(tall));
@@ -13,9 +13,41 @@ namespace depthMap {
 
 float3 ps_getDeviceMemoryInfo();
 
+/// select the given device and return its free memory in MB
+float ps_getFreeDeviceMemoryMB(int CUDAdeviceNo);
+
+/**
+ * Persistent buffers of an asynchronous similarity volume sweep.
+ * The sweep kernels and the volume copy to the host are enqueued on the stream,
+ * the buffers stay alive between the sweeps and are reused when the sizes match.
+ */
+struct ps_sweepState
+{
+    cudaStream_t stream;
+    CudaDeviceMemoryPitched<unsigned char, 3>* volSim_dmp;
+    CudaDeviceMemoryPitched<unsigned char, 2>* slice_dmp;
+    CudaArray<int4, 2>* volPixs_arr;
+    CudaArray<float, 2>* depths_arr;
+    CudaHostMemoryHeap<unsigned char, 3>* vol_hmh; // pinned output volume
+    CudaHostMemoryHeap<int4, 2>* volPixs_hmh; // pinned staging of the volume pixels
+    CudaHostMemoryHeap<float, 2>* depths_hmh; // pinned staging of the depths
+};
+
+ps_sweepState* ps_createSweepState();
+
+/// wait until the kernels and copies enqueued on the sweep stream are finished
+void ps_sweepStateWait(ps_sweepState* state);
+
+void ps_deleteSweepState(ps_sweepState* state);
+
+/**
+ * Enqueue the similarity volume computation and its copy back on the sweep
+ * stream and return without waiting. The content of state->vol_hmh is only
+ * valid after ps_sweepStateWait().
+ */
 float ps_planeSweepingGPUPixelsVolume(
+    ps_sweepState* state,
     CudaArray<uchar4, 2>** ps_texs_arr,
-    unsigned char* ovol_hmh,
     cameraStruct** cams,
     int ncams,
     int width, int height,
@@ -117,6 +149,27 @@ void ps_fuseDepthSimMapsGaussianKernelVoting(
     int width, int height,
     bool verbose);
 
+void ps_refineAndFuseRcTcDepthSimMaps(
+    CudaArray<uchar4, 2>** ps_texs_arr,
+    CudaHostMemoryHeap<float2, 2>* odepthSimMap_hmh,
+    CudaHostMemoryHeap<float2, 2>* rcDepthPixSizeMap_hmh,
+    int ntcsteps,
+    cameraStruct** cams,
+    int ncams,
+    int width, int height,
+    int scale,
+    int CUDAdeviceNo,
+    int ncamsAllocated,
+    int scales,
+    bool verbose,
+    int wsh,
+    float gammaC, float gammaP,
+    float epipShift,
+    bool moveByTcOrRc,
+    int nSamplesHalf,
+    int nDepthsToRefine,
+    float sigma);
+
 void ps_optimizeDepthSimMapGradientDescent(
     CudaArray<uchar4, 2>** ps_texs_arr,
     CudaHostMemoryHeap<float2, 2>* odepthSimMap_hmh,
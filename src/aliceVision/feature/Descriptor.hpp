@@ -13,6 +13,7 @@
 #include <iterator>
 #include <fstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <exception>
 
@@ -282,12 +283,23 @@ inline void loadDescsFromBinFile(
   // Compute the memory size of one descriptor
   constexpr std::size_t oneDescSize = FileDescriptorT::static_size * sizeof(typename FileDescriptorT::bin_type);
 
-  FileDescriptorT fileDescriptor;
-  for (typename std::vector<DescriptorT>::iterator iter = begin;
-    iter != vec_desc.end(); ++iter)
+  if(std::is_same<DescriptorT, FileDescriptorT>::value)
   {
-    fileIn.read((char*)fileDescriptor.getData(), oneDescSize);
-    convertDesc<FileDescriptorT, DescriptorT>(fileDescriptor, *iter);
+    // no type conversion needed: read the whole descriptor block with a
+    // single call instead of millions of small stream reads
+    const std::size_t nbDescToRead = vec_desc.size() - previousSize;
+    if(nbDescToRead > 0)
+      fileIn.read((char*)begin->getData(), nbDescToRead * oneDescSize);
+  }
+  else
+  {
+    FileDescriptorT fileDescriptor;
+    for (typename std::vector<DescriptorT>::iterator iter = begin;
+      iter != vec_desc.end(); ++iter)
+    {
+      fileIn.read((char*)fileDescriptor.getData(), oneDescSize);
+      convertDesc<FileDescriptorT, DescriptorT>(fileDescriptor, *iter);
+    }
   }
 
   if(fileIn.bad())
@@ -12,6 +12,10 @@
 #include <aliceVision/feature/sift/ImageDescriber_SIFT_vlfeatFloat.hpp>
 #include <aliceVision/feature/akaze/ImageDescriber_AKAZE.hpp>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+#include <aliceVision/feature/sift/ImageDescriber_SIFT_popSIFT.hpp>
+#endif //ALICEVISION_HAVE_POPSIFT
+
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
 #include <aliceVision/feature/cctag/ImageDescriber_CCTAG.hpp>
 #endif //ALICEVISION_HAVE_CCTAG
@@ -94,6 +98,11 @@ std::unique_ptr<ImageDescriber> createImageDescriber(EImageDescriberType imageDe
     case EImageDescriberType::SIFT:           describerPtr.reset(new ImageDescriber_SIFT(SiftParams(), true)); break;
     case EImageDescriberType::SIFT_FLOAT:     describerPtr.reset(new ImageDescriber_SIFT_vlfeatFloat(SiftParams())); break;
     case EImageDescriberType::SIFT_UPRIGHT:   describerPtr.reset(new ImageDescriber_SIFT(SiftParams(), false)); break;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+    case EImageDescriberType::SIFT_POPSIFT:   describerPtr.reset(new ImageDescriber_SIFT_popSIFT(SiftParams(), true)); break;
+#endif //ALICEVISION_HAVE_POPSIFT
+
     case EImageDescriberType::AKAZE:          describerPtr.reset(new ImageDescriber_AKAZE(AKAZEParams(AKAZEOptions(), feature::AKAZE_MSURF))); break;
     case EImageDescriberType::AKAZE_MLDB:     describerPtr.reset(new ImageDescriber_AKAZE(AKAZEParams(AKAZEOptions(), feature::AKAZE_MLDB))); break;
     case EImageDescriberType::AKAZE_LIOP:     describerPtr.reset(new ImageDescriber_AKAZE(AKAZEParams(AKAZEOptions(), feature::AKAZE_LIOP))); break;
@@ -0,0 +1,104 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/feature/Descriptor.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <string>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * @brief Read-only view over the descriptors stored in a binary .desc file,
+ * backed by a memory mapping of the file.
+ *
+ * Unlike loadDescsFromBinFile() no deserialization or copy is performed:
+ * the descriptor array is used directly from the OS page cache, so opening
+ * a file is O(1) in memory and several processes matching against the same
+ * descriptors share a single physical copy.
+ *
+ * @warning The view is only valid for files written by saveDescsToBinFile()
+ * with the same \p DescriptorT (no on-the-fly type conversion).
+ */
+template<typename DescriptorT>
+class MappedDescriptorFile
+{
+public:
+
+  MappedDescriptorFile() = default;
+
+  explicit MappedDescriptorFile(const std::string& sfileNameDescs)
+  {
+    open(sfileNameDescs);
+  }
+
+  /**
+   * @brief Map the given .desc file into memory.
+   * @param[in] sfileNameDescs The descriptor file path (usually .desc)
+   */
+  void open(const std::string& sfileNameDescs)
+  {
+    constexpr std::size_t oneDescSize = DescriptorT::static_size * sizeof(typename DescriptorT::bin_type);
+
+    try
+    {
+      _fileMapping = boost::interprocess::file_mapping(sfileNameDescs.c_str(), boost::interprocess::read_only);
+      _mappedRegion = boost::interprocess::mapped_region(_fileMapping, boost::interprocess::read_only);
+    }
+    catch(const boost::interprocess::interprocess_exception&)
+    {
+      throw std::runtime_error("Can't map descriptor binary file, can't open '" + sfileNameDescs + "' !");
+    }
+
+    if(_mappedRegion.get_size() < sizeof(std::size_t))
+      throw std::runtime_error("Can't map descriptor binary file, '" + sfileNameDescs + "' is incorrect !");
+
+    // the file starts with the number of descriptors, the descriptor array follows
+    const char* address = static_cast<const char*>(_mappedRegion.get_address());
+    _size = *reinterpret_cast<const std::size_t*>(address);
+    _descriptors = reinterpret_cast<const DescriptorT*>(address + sizeof(std::size_t));
+
+    if(_mappedRegion.get_size() < sizeof(std::size_t) + _size * oneDescSize)
+      throw std::runtime_error("Can't map descriptor binary file, '" + sfileNameDescs + "' is incorrect !");
+  }
+
+  void close()
+  {
+    _mappedRegion = boost::interprocess::mapped_region();
+    _fileMapping = boost::interprocess::file_mapping();
+    _descriptors = nullptr;
+    _size = 0;
+  }
+
+  /// Pointer to the first descriptor of the mapped array
+  const DescriptorT* data() const { return _descriptors; }
+
+  /// Number of descriptors stored in the file
+  std::size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  const DescriptorT& operator[](std::size_t i) const { return _descriptors[i]; }
+
+  const DescriptorT* begin() const { return _descriptors; }
+  const DescriptorT* end() const { return _descriptors + _size; }
+
+private:
+
+  boost::interprocess::file_mapping _fileMapping;
+  boost::interprocess::mapped_region _mappedRegion;
+  const DescriptorT* _descriptors = nullptr;
+  std::size_t _size = 0;
+};
+
+} // namespace feature
+} // namespace aliceVision
@@ -0,0 +1,110 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "PagedRegionsPerView.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace aliceVision {
+namespace feature {
+
+void PagedRegionsPerView::addRegions(IndexT viewId, feature::EImageDescriberType descType, feature::Regions* regionsPtr, const std::string& descFilename, bool descriptorsLoaded)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  _regionsPerView.addRegions(viewId, descType, regionsPtr);
+
+  ViewPage& page = _pagePerView[viewId];
+  page.descFilenames[descType] = descFilename;
+
+  if(descriptorsLoaded && !page.resident)
+  {
+    page.resident = true;
+    _residentViews.push_back(viewId);
+  }
+  else if(!descriptorsLoaded && page.resident)
+  {
+    // the view is now partially loaded: demote it, the next acquire reloads every describer type
+    for(auto& regionsIt : _regionsPerView.getData().at(viewId))
+      regionsIt.second->clearDescriptors();
+    page.resident = false;
+    _residentViews.remove(viewId);
+  }
+  evict();
+}
+
+PagedRegionsPerView::PagedRegionsHandle PagedRegionsPerView::acquireRegionsPerDesc(IndexT viewId)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  ViewPage& page = _pagePerView.at(viewId);
+
+  if(!page.resident)
+  {
+    // page the descriptors back in from their .desc files
+    MapRegionsPerDesc& regionsPerDesc = _regionsPerView.getData().at(viewId);
+    for(const auto& descFilenameIt : page.descFilenames)
+      regionsPerDesc.at(descFilenameIt.first)->LoadDescriptors(descFilenameIt.second);
+    page.resident = true;
+    _residentViews.push_back(viewId);
+  }
+  else
+  {
+    touch(viewId);
+  }
+
+  ++page.pinCount;
+  evict();
+
+  return PagedRegionsHandle(*this, viewId);
+}
+
+void PagedRegionsPerView::unpin(IndexT viewId)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  ViewPage& page = _pagePerView.at(viewId);
+  assert(page.pinCount > 0);
+  --page.pinCount;
+  evict();
+}
+
+void PagedRegionsPerView::touch(IndexT viewId)
+{
+  const auto it = std::find(_residentViews.begin(), _residentViews.end(), viewId);
+  if(it != _residentViews.end())
+    _residentViews.splice(_residentViews.end(), _residentViews, it);
+}
+
+void PagedRegionsPerView::evict()
+{
+  if(_residentViews.size() <= _maxResidentViews)
+    return;
+
+  for(auto it = _residentViews.begin(); it != _residentViews.end() && _residentViews.size() > _maxResidentViews; )
+  {
+    ViewPage& page = _pagePerView.at(*it);
+    if(page.pinCount > 0)
+    {
+      // a pinned view can't be evicted, try a less recently used one
+      ++it;
+      continue;
+    }
+
+    ALICEVISION_LOG_TRACE("PagedRegionsPerView: release descriptors of view " << *it);
+    for(auto& regionsIt : _regionsPerView.getData().at(*it))
+      regionsIt.second->clearDescriptors();
+
+    page.resident = false;
+    it = _residentViews.erase(it);
+  }
+}
+
+} // namespace feature
+} // namespace aliceVision
@@ -0,0 +1,158 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * @brief Container for the Regions of each View with descriptors paged in and out on demand.
+ *
+ * The features (positions) of every view stay resident for the whole run, but only the
+ * descriptors of the most recently used views are kept in memory: the other descriptor
+ * blocks are released and reloaded from their .desc file on the next access.
+ * Most reconstruction steps after matching never touch descriptors, so a small resident
+ * set is enough to keep large scenes within the memory budget of a single node.
+ *
+ * Descriptor accesses must go through acquireRegionsPerDesc(), which pins the view
+ * descriptors in memory for the lifetime of the returned handle. Feature-only accesses
+ * can use the underlying RegionsPerView directly.
+ */
+class PagedRegionsPerView
+{
+public:
+
+  /**
+   * @brief Pin the descriptors of one view in memory.
+   * A pinned view is never evicted; the pin is released by the handle destructor.
+   */
+  class PagedRegionsHandle
+  {
+  public:
+    PagedRegionsHandle(PagedRegionsPerView& store, IndexT viewId)
+      : _store(store)
+      , _viewId(viewId)
+    {}
+
+    ~PagedRegionsHandle()
+    {
+      if(_viewId != UndefinedIndexT)
+        _store.unpin(_viewId);
+    }
+
+    PagedRegionsHandle(PagedRegionsHandle&& other)
+      : _store(other._store)
+      , _viewId(other._viewId)
+    {
+      other._viewId = UndefinedIndexT;
+    }
+
+    PagedRegionsHandle(const PagedRegionsHandle&) = delete;
+    PagedRegionsHandle& operator=(const PagedRegionsHandle&) = delete;
+
+    const MapRegionsPerDesc& get() const
+    {
+      return _store._regionsPerView.getRegionsPerDesc(_viewId);
+    }
+
+  private:
+    PagedRegionsPerView& _store;
+    IndexT _viewId;
+  };
+
+  /**
+   * @param[in] maxResidentViews The maximum number of views with resident descriptors
+   *            (pinned views can exceed it temporarily).
+   */
+  explicit PagedRegionsPerView(std::size_t maxResidentViews = 50)
+    : _maxResidentViews(maxResidentViews)
+  {}
+
+  /**
+   * @brief Add the Regions of one view to the store.
+   * @param[in] viewId The view id
+   * @param[in] descType The describer type
+   * @param[in,out] regionsPtr The Regions, the store takes the ownership.
+   * @param[in] descFilename The .desc file the descriptors can be reloaded from
+   * @param[in] descriptorsLoaded True if regionsPtr already holds its descriptors,
+   *            false if only the features are loaded
+   */
+  void addRegions(IndexT viewId, feature::EImageDescriberType descType, feature::Regions* regionsPtr, const std::string& descFilename, bool descriptorsLoaded = false);
+
+  /**
+   * @brief Get the Regions of one view with its descriptors pinned in memory.
+   * Reload the descriptors from file if they have been evicted.
+   * @param[in] viewId The view id
+   * @return handle keeping the descriptors resident, see PagedRegionsHandle
+   */
+  PagedRegionsHandle acquireRegionsPerDesc(IndexT viewId);
+
+  /**
+   * @brief Access to the underlying container.
+   * Only the features are guaranteed to be loaded; never keep a reference
+   * to descriptors outside of a PagedRegionsHandle.
+   */
+  const RegionsPerView& getRegionsPerView() const
+  {
+    return _regionsPerView;
+  }
+
+  bool viewExist(IndexT viewId) const
+  {
+    return _regionsPerView.viewExist(viewId);
+  }
+
+  bool isEmpty() const
+  {
+    return _regionsPerView.isEmpty();
+  }
+
+  std::vector<feature::EImageDescriberType> getCommonDescTypes(const Pair& pair) const
+  {
+    return _regionsPerView.getCommonDescTypes(pair);
+  }
+
+private:
+
+  /// Per view paging state
+  struct ViewPage
+  {
+    /// .desc file per describer type, used to reload evicted descriptors
+    std::map<feature::EImageDescriberType, std::string> descFilenames;
+    /// number of handles currently pinning this view
+    std::size_t pinCount = 0;
+    /// true if the descriptors are currently loaded
+    bool resident = false;
+  };
+
+  /// Release the pin of one view, called by the handle destructor
+  void unpin(IndexT viewId);
+
+  /// Mark the view as most recently used, _mutex must be held
+  void touch(IndexT viewId);
+
+  /// Evict unpinned descriptors until the resident set fits, _mutex must be held
+  void evict();
+
+  RegionsPerView _regionsPerView;
+  std::map<IndexT, ViewPage> _pagePerView;
+  /// resident views from least to most recently used
+  std::list<IndexT> _residentViews;
+  std::size_t _maxResidentViews;
+  std::mutex _mutex;
+};
+
+} // namespace feature
+} // namespace aliceVision
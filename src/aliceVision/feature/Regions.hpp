@@ -66,6 +66,9 @@ public:
   virtual void LoadFeatures(
     const std::string& sfileNameFeats) = 0;
 
+  virtual void LoadDescriptors(
+    const std::string& sfileNameDescs) = 0;
+
   //--
   //- Basic description of a descriptor [Type, Length]
   //--
@@ -239,6 +242,12 @@ public:
     saveDescsToBinFile(sfileNameDescs, _vec_descs);
   }
 
+  /// Read only the descriptors (the features are left untouched).
+  void LoadDescriptors(const std::string& sfileNameDescs) override
+  {
+    loadDescsFromBinFile(sfileNameDescs, _vec_descs);
+  }
+
   /// Mutable and non-mutable DescriptorT getters.
   inline std::vector<DescriptorT> & Descriptors() { return _vec_descs; }
   inline const std::vector<DescriptorT> & Descriptors() const { return _vec_descs; }
@@ -115,75 +115,91 @@ float computeAutomaticContrastFactor(const image::Image<float>& image,
 }
 
 /**
- * @brief Compute an AKAZE slice
- * @param[in] src Input image for the given octave
+ * @brief Compute the diffusion image of an AKAZE slice
+ * @param[in] src Input image for the given octave (previous slice of the evolution)
  * @param[in] p Octave index
  * @param[in] q Slice index
  * @param[in] nbSlice Slices per octave
  * @param[in] sigma0 First octave initial scale
  * @param[in] contrastFactor
  * @param Li Diffusion image
- * @param Lx X derivatives
- * @param Ly Y derivatives
- * @param Lhess Det(Hessian)
  */
-void computeAKAZESlice(const image::Image<float>& src,
-                       const int p,
-                       const int q,
-                       const int nbSlice,
-                       const float sigma0,
-                       const float contrastFactor,
-                       image::Image<float>& Li,
-                       image::Image<float>& Lx,
-                       image::Image<float>& Ly,
-                       image::Image<float>& Lhess)
+void computeAKAZESliceDiffusion(const image::Image<float>& src,
+                                const int p,
+                                const int q,
+                                const int nbSlice,
+                                const float sigma0,
+                                const float contrastFactor,
+                                image::Image<float>& Li)
 {
-  const float sigmaCur = sigma(sigma0, p, q, nbSlice);
-  const float ratio = 1 << p; //pow(2,p);
-  const int sigmaScale = MathTrait<float>::round(sigmaCur * derivativeFactor / ratio);
-
-  image::Image<float> smoothed;
-
   if(p == 0 && q == 0)
   {
     // compute new image
     image::ImageGaussianFilter(src , sigma0 , Li, 0, 0);
+    return;
+  }
+
+  // general case
+  image::Image<float> in;
+  if( q == 0 )
+  {
+    image::ImageHalfSample(src , in);
   }
   else
   {
-    // general case
-    image::Image<float> in;
-    if( q == 0 )
-    {
-      image::ImageHalfSample(src , in);
-    }
-    else
-    {
-      in = src;
-    }
-
-    const float sigmaPrev = ( q == 0 ) ? sigma(sigma0, p - 1, nbSlice - 1, nbSlice) : sigma(sigma0, p, q - 1, nbSlice);
-
-    // compute non linear timing between two consecutive slices
-    const float t_prev = 0.5f * (sigmaPrev * sigmaPrev);
-    const float t_cur  = 0.5f * (sigmaCur * sigmaCur);
-    const float total_cycle_time = t_cur - t_prev;
+    in = src;
+  }
 
-    // compute first derivatives (Scharr scale 1, non normalized) for diffusion coef
-    image::ImageGaussianFilter(in , 1.f , smoothed, 0, 0 );
-    image::ImageScharrXDerivative(smoothed, Lx, false);
-    image::ImageScharrYDerivative(smoothed, Ly, false);
+  const float sigmaCur = sigma(sigma0, p, q, nbSlice);
+  const float sigmaPrev = ( q == 0 ) ? sigma(sigma0, p - 1, nbSlice - 1, nbSlice) : sigma(sigma0, p, q - 1, nbSlice);
+
+  // compute non linear timing between two consecutive slices
+  const float t_prev = 0.5f * (sigmaPrev * sigmaPrev);
+  const float t_cur  = 0.5f * (sigmaCur * sigmaCur);
+  const float total_cycle_time = t_cur - t_prev;
+
+  // compute first derivatives (Scharr scale 1, non normalized) for diffusion coef
+  image::Image<float> smoothed, Lx, Ly;
+  image::ImageGaussianFilter(in , 1.f , smoothed, 0, 0 );
+  image::ImageScharrXDerivative(smoothed, Lx, false);
+  image::ImageScharrYDerivative(smoothed, Ly, false);
+
+  // compute diffusion coefficient
+  image::Image<float> & diff = smoothed; // diffusivity image (reuse existing memory)
+  image::ImagePeronaMalikG2DiffusionCoef(Lx, Ly, contrastFactor, diff) ;
+
+  // compute FED cycles
+  std::vector<float> tau ;
+  image::FEDCycleTimings(total_cycle_time, 0.25f, tau);
+  image::ImageFEDCycle(in, diff, tau);
+  Li = in ; // evolution image
+}
 
-    // compute diffusion coefficient
-    image::Image<float> & diff = smoothed; // diffusivity image (reuse existing memory)
-    image::ImagePeronaMalikG2DiffusionCoef(Lx, Ly, contrastFactor, diff) ;
+/**
+ * @brief Compute the derivatives and the Det(Hessian) response of an AKAZE slice
+ * @param[in] Li Diffusion image of the slice
+ * @param[in] p Octave index
+ * @param[in] q Slice index
+ * @param[in] nbSlice Slices per octave
+ * @param[in] sigma0 First octave initial scale
+ * @param Lx X derivatives
+ * @param Ly Y derivatives
+ * @param Lhess Det(Hessian)
+ */
+void computeAKAZESliceHessian(const image::Image<float>& Li,
+                              const int p,
+                              const int q,
+                              const int nbSlice,
+                              const float sigma0,
+                              image::Image<float>& Lx,
+                              image::Image<float>& Ly,
+                              image::Image<float>& Lhess)
+{
+  const float sigmaCur = sigma(sigma0, p, q, nbSlice);
+  const float ratio = 1 << p; //pow(2,p);
+  const int sigmaScale = MathTrait<float>::round(sigmaCur * derivativeFactor / ratio);
 
-    // compute FED cycles
-    std::vector<float> tau ;
-    image::FEDCycleTimings(total_cycle_time, 0.25f, tau);
-    image::ImageFEDCycle(in, diff, tau);
-    Li = in ; // evolution image
-  }
+  image::Image<float> smoothed;
 
   // compute Hessian response
   if(p == 0 && q == 0)
@@ -241,7 +257,7 @@ void AKAZE::computeScaleSpace()
   float contrastFactor = computeAutomaticContrastFactor( _input, 0.7f);
   image::Image<float> input = _input;
 
-  // octave computation
+  // diffusion images: each slice is diffused from the previous one, so this chain is sequential
   for(int p = 0; p < _options.nbOctaves; ++p)
   {
     contrastFactor *= (p == 0) ? 1.f : 0.75f;
@@ -251,9 +267,9 @@ void AKAZE::computeScaleSpace()
       _evolution.emplace_back(TEvolution());
       TEvolution& evo = _evolution.back();
 
-      // compute Slice at (p,q) index
-      computeAKAZESlice(input, p, q, _options.nbSlicePerOctave, _options.sigma0, contrastFactor,
-        evo.cur, evo.Lx, evo.Ly, evo.Lhess);
+      // compute the diffusion image at (p,q) index
+      computeAKAZESliceDiffusion(input, p, q, _options.nbSlicePerOctave, _options.sigma0, contrastFactor,
+        evo.cur);
 
       // Prepare inputs for next slice
       input = evo.cur;
@@ -269,6 +285,19 @@ void AKAZE::computeScaleSpace()
 #endif // DEBUG_OCTAVE
     }
   }
+
+  // derivatives and Det(Hessian) responses only depend on the diffusion image
+  // of their own slice, so they are computed in parallel
+  #pragma omp parallel for schedule(dynamic)
+  for(int k = 0; k < static_cast<int>(_evolution.size()); ++k)
+  {
+    const int p = k / _options.nbSlicePerOctave;
+    const int q = k % _options.nbSlicePerOctave;
+    TEvolution& evo = _evolution[k];
+
+    computeAKAZESliceHessian(evo.cur, p, q, _options.nbSlicePerOctave, _options.sigma0,
+      evo.Lx, evo.Ly, evo.Lhess);
+  }
 }
 
 void detectDuplicates(std::vector<std::pair<AKAZEKeypoint, bool>>& previous,
@@ -110,7 +110,7 @@ bool ImageDescriber_CCTAG::describe(const image::Image<unsigned char>& image,
   regionsCasted->Descriptors().reserve(regionsCasted->Descriptors().size() + 50);
 
   boost::ptr_list<cctag::ICCTag> cctags;
-  cctag::logtime::Mgmt* durations = new cctag::logtime::Mgmt( 25 );
+  std::unique_ptr<cctag::logtime::Mgmt> durations(new cctag::logtime::Mgmt( 25 ));
   // cctag::CCTagMarkersBank bank(_params._nCrowns);
 
 #ifndef CPU_ADAPT_OF_GPU_PART
@@ -118,12 +118,12 @@ bool ImageDescriber_CCTAG::describe(const image::Image<unsigned char>& image,
   //// Invert the image
   //cv::Mat invertImg;
   //cv::bitwise_not(graySrc,invertImg);
-  cctag::cctagDetection(cctags, _cudaPipe, 1,graySrc, *_params._internalParams, durations);
+  cctag::cctagDetection(cctags, _cudaPipe, 1,graySrc, *_params._internalParams, durations.get());
 #else //todo: #ifdef depreciated
   cctag::MemoryPool::instance().updateMemoryAuthorizedWithRAM();
   cctag::View cctagView((const unsigned char *) image.data(), image.Width(), image.Height(), image.Depth()*image.Width());
   boost::ptr_list<cctag::ICCTag> cctags;
-  cctag::cctagDetection(cctags, _cudaPipe, 1 ,cctagView._grayView ,*_params._internalParams, durations );
+  cctag::cctagDetection(cctags, _cudaPipe, 1 ,cctagView._grayView ,*_params._internalParams, durations.get() );
 #endif
   durations->print( std::cerr );
 
@@ -93,6 +93,10 @@ public:
    * @param[in] mask 8-bit grayscale image for keypoint filtering (optional)
    *    Non-zero values depict the region of interest.
    * @return True if detection succed.
+   *
+   * The detection keeps no state in the describer, so several images can be
+   * described concurrently on CPU. On CUDA each pipe (see setCudaPipe) must
+   * be fed from a single thread at a time.
    */
   bool describe(const image::Image<unsigned char>& image,
     std::unique_ptr<Regions> &regions,
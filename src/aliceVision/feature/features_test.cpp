@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "aliceVision/feature/feature.hpp"
+#include "aliceVision/feature/MappedDescriptorFile.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -122,3 +123,32 @@ BOOST_AUTO_TEST_CASE(descriptorIO_BINARY) {
       BOOST_CHECK_EQUAL(vec_descs[i][j], vec_descs_read[i][j]);
   }
 }
+
+//Test zero-copy memory-mapped access to a binary descriptor file
+BOOST_AUTO_TEST_CASE(descriptorIO_MAPPED) {
+  // Try to map a non-existing descriptor file
+  BOOST_CHECK_THROW(MappedDescriptorFile<Desc_T>("x.desc"), std::exception);
+
+  // Create an input series of descriptor
+  Descs_T vec_descs;
+  for(int i = 0; i < CARD; ++i)
+  {
+    Desc_T desc;
+    for (int j = 0; j < DESC_LENGTH; ++j)
+      desc[j] = i*DESC_LENGTH+j;
+    vec_descs.push_back(desc);
+  }
+
+  //Save them to a file
+  BOOST_CHECK_NO_THROW(saveDescsToBinFile("tempDescsMapped.desc", vec_descs));
+
+  //Map the saved file and compare to input without deserialization
+  MappedDescriptorFile<Desc_T> mappedDescs;
+  BOOST_CHECK_NO_THROW(mappedDescs.open("tempDescsMapped.desc"));
+  BOOST_CHECK_EQUAL(CARD, mappedDescs.size());
+
+  for(int i = 0; i < CARD; ++i) {
+    for (int j = 0; j < DESC_LENGTH; ++j)
+      BOOST_CHECK_EQUAL(vec_descs[i][j], mappedDescs[i][j]);
+  }
+}
@@ -22,6 +22,9 @@ std::string EImageDescriberType_informations()
           "* sift: Scale-invariant feature transform.\n"
           "* sift_float: SIFT stored as float.\n"
           "* sift_upright: SIFT with upright feature.\n"
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+          "* sift_popsift: GPU implementation of SIFT describer (PopSIFT).\n"
+#endif
           "* akaze: A-KAZE with floating point descriptors.\n"
           "* akaze_liop: A-KAZE with Local Intensity Order Pattern descriptors.\n"
           "* akaze_mldb: A-KAZE with Modified-Local Difference Binary descriptors.\n"
@@ -45,6 +48,11 @@ std::string EImageDescriberType_enumToString(EImageDescriberType imageDescriberT
     case EImageDescriberType::SIFT:          return "sift";
     case EImageDescriberType::SIFT_FLOAT:    return "sift_float";
     case EImageDescriberType::SIFT_UPRIGHT:  return "sift_upright";
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+    case EImageDescriberType::SIFT_POPSIFT:  return "sift_popsift";
+#endif
+
     case EImageDescriberType::AKAZE:         return "akaze";
     case EImageDescriberType::AKAZE_LIOP:    return "akaze_liop";
     case EImageDescriberType::AKAZE_MLDB:    return "akaze_mldb";
@@ -75,6 +83,11 @@ EImageDescriberType EImageDescriberType_stringToEnum(const std::string& imageDes
   if(type == "sift")          return EImageDescriberType::SIFT;
   if(type == "sift_float")    return EImageDescriberType::SIFT_FLOAT;
   if(type == "sift_upright")  return EImageDescriberType::SIFT_UPRIGHT;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+  if(type == "sift_popsift")  return EImageDescriberType::SIFT_POPSIFT;
+#endif
+
   if(type == "akaze")         return EImageDescriberType::AKAZE;
   if(type == "akaze_liop")    return EImageDescriberType::AKAZE_LIOP;
   if(type == "akaze_mldb")    return EImageDescriberType::AKAZE_MLDB;
@@ -23,6 +23,11 @@ enum class EImageDescriberType: unsigned char
   , SIFT = 10
   , SIFT_FLOAT = 11
   , SIFT_UPRIGHT = 12
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+  , SIFT_POPSIFT = 13
+#endif
+
   , AKAZE = 20
   , AKAZE_LIOP = 21
   , AKAZE_MLDB = 22
@@ -79,6 +84,11 @@ inline float getStrongSupportCoeff(EImageDescriberType imageDescriberType)
     case EImageDescriberType::SIFT:          return 0.14f;
     case EImageDescriberType::SIFT_FLOAT:    return 0.14f;
     case EImageDescriberType::SIFT_UPRIGHT:  return 0.14f;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_POPSIFT)
+    case EImageDescriberType::SIFT_POPSIFT:  return 0.14f;
+#endif
+
     case EImageDescriberType::AKAZE:         return 0.14f;
     case EImageDescriberType::AKAZE_LIOP:    return 0.14f;
     case EImageDescriberType::AKAZE_MLDB:    return 0.14f;
@@ -46,6 +46,20 @@ std::string describerTypeColor(feature::EImageDescriberType descType )
   return "magenta";
 }
 
+matching::IndMatches sampleMatches(const matching::IndMatches& matches, std::size_t maxMatches)
+{
+  if (maxMatches == 0 || matches.size() <= maxMatches)
+    return matches;
+
+  matching::IndMatches sampled;
+  sampled.reserve(maxMatches);
+  // constant stride keeps the sampling spatially unbiased whatever the ordering
+  const double stride = double(matches.size()) / double(maxMatches);
+  for (std::size_t i = 0; i < maxMatches; ++i)
+    sampled.push_back(matches[std::size_t(i * stride)]);
+  return sampled;
+}
+
 float getRadiusEstimate(const std::pair<size_t,size_t> & imgSize)
 {
   // heuristic for the radius of the feature according to the size of the image
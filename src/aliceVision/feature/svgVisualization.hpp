@@ -35,6 +35,16 @@ static const std::array<std::string,16> sixteenColors {"aqua","blue","fuchsia","
 
 std::string describerTypeColor(feature::EImageDescriberType descType);
 
+/**
+ * @brief Uniformly sample the matches when there are more than \p maxMatches:
+ * above a few thousand lines an svg becomes unreadable and very slow to
+ * generate, so the exporters decimate through this fast-path.
+ * @param[in] matches The matches to sample.
+ * @param[in] maxMatches The maximum number of matches to keep, 0 means no limit.
+ * @return The decimated matches (a plain copy when already under the limit).
+ */
+matching::IndMatches sampleMatches(const matching::IndMatches& matches, std::size_t maxMatches);
+
 /**
  * @brief It saves a svg file containing two images (as linked images) and their
  * feature matches: the two images are showed side by side and each feature in each
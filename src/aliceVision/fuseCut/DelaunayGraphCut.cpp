@@ -7,14 +7,17 @@
 #include "DelaunayGraphCut.hpp"
 // #include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
 #include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_PushRelabel.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/jetColorMap.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
 #include <aliceVision/mvsData/Point2d.hpp>
+#include <aliceVision/mvsData/StaticVectorOfVector.hpp>
 #include <aliceVision/mvsData/Universe.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/imageIO/image.hpp>
+#include <aliceVision/system/hugePages.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
 #include "nanoflann.hpp"
@@ -480,6 +483,9 @@ void DelaunayGraphCut::initCells()
 
     _cellsAttr.resize(_tetrahedralization->nb_cells()); // or nb_finite_cells() if keeps_infinite()
 
+    // the graph-fill loops walk this array for every ray: back it with huge pages
+    system::adviseHugePages(_cellsAttr.data(), _cellsAttr.size() * sizeof(GC_cellInfo));
+
     ALICEVISION_LOG_INFO(_cellsAttr.size() << " cells created by tetrahedralization.");
     for(int i = 0; i < _cellsAttr.size(); ++i)
     {
@@ -799,6 +805,10 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
     std::vector<double> pixSizePrepare(realMaxVertices);
     std::vector<float> simScorePrepare(realMaxVertices);
 
+    // multi-GB point arrays: huge pages take the dTLB pressure out of the fuse loops
+    system::adviseHugePages(verticesCoordsPrepare.data(), verticesCoordsPrepare.size() * sizeof(Point3d));
+    system::adviseHugePages(pixSizePrepare.data(), pixSizePrepare.size() * sizeof(double));
+
     ALICEVISION_LOG_INFO("simFactor: " << params.simFactor);
     ALICEVISION_LOG_INFO("nbPixels: " << nbPixels);
     ALICEVISION_LOG_INFO("maxVertices: " << params.maxPoints);
@@ -1054,23 +1064,19 @@ void DelaunayGraphCut::loadPrecomputedDensePoints(const StaticVector<int>* voxel
     {
         ALICEVISION_LOG_INFO("Add points from voxel " << i << " of " << voxelsIds->size() << ".");
 
-        std::string folderName = ls->getVoxelFolderName((*voxelsIds)[i]);
-        std::string fileNameTracksPts = folderName + "tracksGridPts.bin";
-        std::string fileNameTracksPtsCams = folderName + "tracksGridPtsCams.bin";
+        StaticVector<int>* voxCams = nullptr;
+        StaticVector<OctreeTracks::trackStruct*>* tracks = ls->loadTracksFromVoxelFiles(&voxCams, (*voxelsIds)[i]);
 
-        if(mvsUtils::FileExists(fileNameTracksPts))
+        if(tracks != nullptr)
         {
-            StaticVector<Point3d>* tracksPoints = loadArrayFromFile<Point3d>(fileNameTracksPts);
-            StaticVector<StaticVector<Pixel>*>* tracksPointsCams =
-                loadArrayOfArraysFromFile<Pixel>(fileNameTracksPtsCams);
-
             long t1 = mvsUtils::initEstimate();
-            for(int j = 0; j < tracksPoints->size(); j++)
+            for(int j = 0; j < tracks->size(); j++)
             {
-                Point3d tp = (*tracksPoints)[j];
-                StaticVector<Pixel>* cams = (*tracksPointsCams)[j];
-                if((mvsUtils::isPointInHexahedron(tp, voxel)) && (cams != nullptr) &&
-                   ((!doFilterOctreeTracks) || ((doFilterOctreeTracks) && (cams->size() >= minNumOfConsistentCams))))
+                OctreeTracks::trackStruct* t = (*tracks)[j];
+                const Point3d& tp = t->point;
+                int nbCams = t->cams.size();
+                if((mvsUtils::isPointInHexahedron(tp, voxel)) && (nbCams > 0) &&
+                   ((!doFilterOctreeTracks) || ((doFilterOctreeTracks) && (nbCams >= minNumOfConsistentCams))))
                 {
                     cgpt = cgpt + tp;
                     ncgpt++;
@@ -1081,12 +1087,12 @@ void DelaunayGraphCut::loadPrecomputedDensePoints(const StaticVector<int>* voxel
                     newv.segSize = 0;
                     newv.segId = -1;
 
-                    newv.cams.reserve(cams->size());
+                    newv.cams.reserve(nbCams);
 
-                    for(int c = 0; c < cams->size(); c++)
+                    for(int c = 0; c < nbCams; c++)
                     {
-                        int rc = (*cams)[c].x;
-                        int nptsrc = (*cams)[c].y;
+                        int rc = t->cams[c].x;
+                        int nptsrc = t->cams[c].y;
                         newv.cams.push_back(rc);
                         newv.nrc += nptsrc;
                     }
@@ -1094,15 +1100,17 @@ void DelaunayGraphCut::loadPrecomputedDensePoints(const StaticVector<int>* voxel
                     _verticesAttr.push_back(newv);
                 }
 
-                mvsUtils::printfEstimate(j, tracksPoints->size(), t1);
+                mvsUtils::printfEstimate(j, tracks->size(), t1);
             } // for j
             mvsUtils::finishEstimate();
 
-            // delete randIds;
-
-            delete tracksPoints;
-            deleteArrayOfArrays<Pixel>(&tracksPointsCams);
-        } // if fileexists
+            for(int j = 0; j < tracks->size(); j++)
+            {
+                delete(*tracks)[j];
+            }
+            delete tracks;
+            delete voxCams;
+        } // if tracks
     }
 
     ALICEVISION_LOG_INFO("Dense points loaded.\n");
@@ -1161,31 +1169,26 @@ void DelaunayGraphCut::computeVerticesSegSize(bool allPoints, float alpha) // al
     }
     // mvsUtils::finishEstimate();
 
-    Universe* u = new Universe(_verticesAttr.size());
+    ConcurrentUniverse* u = new ConcurrentUniverse(_verticesAttr.size());
 
-    // t1 = mvsUtils::initEstimate();
     int s = (int)edges.size(); // Fuse all edges collected to be merged
+#pragma omp parallel for
     for(int i = 0; i < s; i++)
     {
-        int a = u->find(edges[i].x);
-        int b = u->find(edges[i].y);
-        if(a != b) // TODO FACA: Are they not different in all cases?
-        {
-            u->join(a, b);
-        }
-        // mvsUtils::printfEstimate(i, s, t1);
+        u->addEdge(edges[i].x, edges[i].y);
     }
-    // mvsUtils::finishEstimate();
+    u->computeSizes();
 
     // Last loop over vertices to update segId
-    for(int vi = 0; vi < _verticesAttr.size(); ++vi)
+#pragma omp parallel for
+    for(int vi = 0; vi < (int)_verticesAttr.size(); ++vi)
     {
         GC_vertexInfo& v = _verticesAttr[vi];
         if(v.isVirtual())
             continue;
 
         int a = u->find(vi);
-        v.segSize = u->elts[a].size;
+        v.segSize = u->size(a);
         v.segId = a;
     }
 
@@ -1239,28 +1242,23 @@ bool DelaunayGraphCut::rayCellIntersection(const Point3d& camC, const Point3d& p
 
     // go thru all triangles
     bool existsTriOnRay = false;
-    const Point3d* A = &(_verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 0)]);
-    const Point3d* B = &(_verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 1)]);
-    const Point3d* C = &(_verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 2)]);
-    const Point3d* D = &(_verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 3)]);
-
-    // All the facets of the tetrahedron
-    std::array<std::array<const Point3d*, 3>, 4> facets {{
-        {B, C, D}, // opposite vertex A, index 0
-        {A, C, D}, // opposite vertex B, index 1
-        {A, B, D}, // opposite vertex C, index 2
-        {A, B, C}  // opposite vertex D, index 3
-    }};
+    const Point3d& A = _verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 0)];
+    const Point3d& B = _verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 1)];
+    const Point3d& C = _verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 2)];
+    const Point3d& D = _verticesCoords[_tetrahedralization->cell_vertex(tetrahedron, 3)];
+
+    // Test all facets of the tetrahedron in one batch, facet i is opposite to vertex i
+    Point3d lpis[4];
+    bool hits[4];
+    lineTetrahedronIntersections(lpis, hits, A, B, C, D, linePoint, lineVect);
+
     int oppositeVertexIndex = -1;
-    Point3d lpi;
-    double dist;
-    // Test all facets of the tetrahedron
     for(int i = 0; i < 4; ++i)
     {
-        const auto& facet= facets[i];
-        if(isLineInTriangle(&lpi, facet[0], facet[1], facet[2], &linePoint, &lineVect))
+        if(hits[i])
         {
-            dist = (camC - lpi).size();
+            const Point3d& lpi = lpis[i];
+            const double dist = (camC - lpi).size();
             if(nearestFarest)
             {
                 if(dist < mind) // between the camera and the point
@@ -1558,35 +1556,71 @@ void DelaunayGraphCut::fillGraph(bool fixesSigma, float nPixelSizeBehind, bool a
     int avCams = 0;
     int nAvCams = 0;
 
-#pragma omp parallel for reduction(+:avStepsFront,aAvStepsFront,avStepsBehind,nAvStepsBehind,avCams,nAvCams)
-    for(int i = 0; i < vetexesToProcessIdsRand->size(); i++)
+    // each thread accumulates the cell weights of its vertices into its own copy of the cell
+    // attributes instead of doing atomic updates on the shared ones (the rays of different
+    // vertices cross the same cells all the time), the copies are merged afterwards
+    std::vector<std::vector<GC_cellInfo>> cellsAttrPerThread(omp_get_max_threads());
+
+    ALICEVISION_LOG_DEBUG("fillGraph: " << cellsAttrPerThread.size() << " thread-local copies of the cell attributes of "
+                          << ((_cellsAttr.size() * sizeof(GC_cellInfo)) / (1024 * 1024)) << " MB each.");
+
+#pragma omp parallel reduction(+:avStepsFront,aAvStepsFront,avStepsBehind,nAvStepsBehind,avCams,nAvCams)
     {
-        int iV = (*vetexesToProcessIdsRand)[i];
-        const GC_vertexInfo& v = _verticesAttr[iV];
+        std::vector<GC_cellInfo>& localCellsAttr = cellsAttrPerThread.at(omp_get_thread_num());
+        localCellsAttr.resize(_cellsAttr.size());
 
-        if(v.isReal() && (allPoints || v.isOnSurface) && (v.nrc > 0))
+#pragma omp for
+        for(int i = 0; i < vetexesToProcessIdsRand->size(); i++)
         {
-            for(int c = 0; c < v.cams.size(); c++)
+            int iV = (*vetexesToProcessIdsRand)[i];
+            const GC_vertexInfo& v = _verticesAttr[iV];
+
+            if(v.isReal() && (allPoints || v.isOnSurface) && (v.nrc > 0))
             {
-                // "weight" is called alpha(p) in the paper
-                float weight = weightFcn((float)v.nrc, labatutWeights, v.getNbCameras()); // number of cameras
+                for(int c = 0; c < v.cams.size(); c++)
+                {
+                    // "weight" is called alpha(p) in the paper
+                    float weight = weightFcn((float)v.nrc, labatutWeights, v.getNbCameras()); // number of cameras
 
-                assert(v.cams[c] >= 0);
-                assert(v.cams[c] < mp->ncams);
+                    assert(v.cams[c] >= 0);
+                    assert(v.cams[c] < mp->ncams);
 
-                int nstepsFront = 0;
-                int nstepsBehind = 0;
-                fillGraphPartPtRc(nstepsFront, nstepsBehind, iV, v.cams[c], weight, fixesSigma, nPixelSizeBehind,
-                                  allPoints, behind, fillOut, distFcnHeight);
+                    int nstepsFront = 0;
+                    int nstepsBehind = 0;
+                    fillGraphPartPtRc(localCellsAttr.data(), nstepsFront, nstepsBehind, iV, v.cams[c], weight,
+                                      fixesSigma, nPixelSizeBehind, allPoints, behind, fillOut, distFcnHeight);
 
-                avStepsFront += nstepsFront;
-                aAvStepsFront += 1;
-                avStepsBehind += nstepsBehind;
-                nAvStepsBehind += 1;
-            } // for c
+                    avStepsFront += nstepsFront;
+                    aAvStepsFront += 1;
+                    avStepsBehind += nstepsBehind;
+                    nAvStepsBehind += 1;
+                } // for c
 
-            avCams += v.cams.size();
-            nAvCams += 1;
+                avCams += v.cams.size();
+                nAvCams += 1;
+            }
+        }
+
+        // merge the thread-local copies, each thread sums up its own stripe of the cells
+#pragma omp for
+        for(int ci = 0; ci < (int)_cellsAttr.size(); ci++)
+        {
+            GC_cellInfo& c = _cellsAttr[ci];
+            for(const std::vector<GC_cellInfo>& threadCellsAttr: cellsAttrPerThread)
+            {
+                if(threadCellsAttr.empty()) // thread never entered the parallel region
+                    continue;
+                const GC_cellInfo& tc = threadCellsAttr[ci];
+                c.cellSWeight = std::max(c.cellSWeight, tc.cellSWeight);
+                c.cellTWeight += tc.cellTWeight;
+                c.in += tc.in;
+                c.out += tc.out;
+                c.on += tc.on;
+                for(int s = 0; s < 4; s++)
+                {
+                    c.gEdgeVisWeight[s] += tc.gEdgeVisWeight[s];
+                }
+            }
         }
     }
 
@@ -1600,7 +1634,8 @@ void DelaunayGraphCut::fillGraph(bool fixesSigma, float nPixelSizeBehind, bool a
     mvsUtils::printfElapsedTime(t1, "s-t graph weights computed : ");
 }
 
-void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBehind, int vertexIndex, int cam,
+void DelaunayGraphCut::fillGraphPartPtRc(GC_cellInfo* cellsAttr, int& out_nstepsFront, int& out_nstepsBehind,
+                                       int vertexIndex, int cam,
                                        float weight, bool fixesSigma, float nPixelSizeBehind, bool allPoints,
                                        bool behind, bool fillOut, float distFcnHeight)  // fixesSigma=true nPixelSizeBehind=2*spaceSteps allPoints=1 behind=0 fillOut=1 distFcnHeight=0
 {
@@ -1635,10 +1670,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
         bool ok = ci != GEO::NO_CELL;
         while(ok)
         {
-            {
-#pragma OMP_ATOMIC_UPDATE
-                _cellsAttr[ci].out += weight;
-            }
+            cellsAttr[ci].out += weight;
 
             ++out_nstepsFront;
             ++nsteps;
@@ -1655,10 +1687,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
             {
                 float dist = distFcn(maxDist, (po - pold).size(), distFcnHeight);
 
-                {
-#pragma OMP_ATOMIC_UPDATE
-                    _cellsAttr[f1.cellIndex].gEdgeVisWeight[f1.localVertexIndex] += weight * dist;
-                }
+                cellsAttr[f1.cellIndex].gEdgeVisWeight[f1.localVertexIndex] += weight * dist;
 
                 if(f2.cellIndex == GEO::NO_CELL)
                     ok = false;
@@ -1670,8 +1699,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
         // get the outer tetrahedron of camera c for the ray to p = the last tetrahedron
         if(lastFinite != GEO::NO_CELL)
         {
-#pragma OMP_ATOMIC_WRITE
-            _cellsAttr[lastFinite].cellSWeight = (float)maxint;
+            cellsAttr[lastFinite].cellSWeight = (float)maxint;
         }
     }
 
@@ -1684,8 +1712,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
         CellIndex ci = f1.cellIndex;
         if(ci != GEO::NO_CELL)
         {
-#pragma OMP_ATOMIC_UPDATE
-            _cellsAttr[ci].on += weight;
+            cellsAttr[ci].on += weight;
         }
 
         Point3d p = po; // HAS TO BE HERE !!!
@@ -1693,14 +1720,12 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
         bool ok = (ci != GEO::NO_CELL) && allPoints;
         while(ok)
         {
-            GC_cellInfo& c = _cellsAttr[ci];
+            GC_cellInfo& c = cellsAttr[ci];
             {
                 if(behind)
                 {
-#pragma OMP_ATOMIC_UPDATE
                     c.cellTWeight += weight;
                 }
-#pragma OMP_ATOMIC_UPDATE
                 c.in += weight;
             }
 
@@ -1731,8 +1756,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
                 }
                 else
                 {
-#pragma OMP_ATOMIC_UPDATE
-                    _cellsAttr[f2.cellIndex].gEdgeVisWeight[f2.localVertexIndex] += weight * dist;
+                    cellsAttr[f2.cellIndex].gEdgeVisWeight[f2.localVertexIndex] += weight * dist;
                 }
                 ci = f2.cellIndex;
             }
@@ -1743,8 +1767,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBe
         {
             if(ci != GEO::NO_CELL)
             {
-#pragma OMP_ATOMIC_UPDATE
-                _cellsAttr[ci].cellTWeight += weight;
+                cellsAttr[ci].cellTWeight += weight;
             }
         }
     }
@@ -2509,12 +2532,28 @@ void DelaunayGraphCut::reconstructGC(const Point3d* hexah)
 }
 
 void DelaunayGraphCut::maxflow()
+{
+    const std::string maxFlowAlg = mp->userParams.get<std::string>("delaunaycut.maxFlowAlg", "boykovKolmogorov");
+    ALICEVISION_LOG_INFO("maxFlowAlg: " << maxFlowAlg);
+
+    if(maxFlowAlg == "parallelPushRelabel")
+    {
+        maxflowGraph<MaxFlow_PushRelabel>();
+    }
+    else
+    {
+        // MaxFlow_CSR uses less memory
+        maxflowGraph<MaxFlow_AdjList>();
+    }
+}
+
+template<class MaxFlowT>
+void DelaunayGraphCut::maxflowGraph()
 {
     long t_maxflow = clock();
 
     ALICEVISION_LOG_INFO("Maxflow: start allocation.");
-    // MaxFlow_CSR maxFlowGraph(_cellsAttr.size());
-    MaxFlow_AdjList maxFlowGraph(_cellsAttr.size());
+    MaxFlowT maxFlowGraph(_cellsAttr.size());
 
     ALICEVISION_LOG_INFO("Maxflow: add nodes.");
     // fill s-t edges
@@ -290,7 +290,10 @@ public:
 
     virtual void fillGraph(bool fixesSigma, float nPixelSizeBehind, bool allPoints, bool behind, bool labatutWeights,
                            bool fillOut, float distFcnHeight = 0.0f);
-    void fillGraphPartPtRc(int& out_nstepsFront, int& out_nstepsBehind, int vertexIndex, int cam, float weight,
+    /// accumulate the weights of the rays of one vertex/camera pair into the given cell
+    /// attributes (a thread-local copy of _cellsAttr in fillGraph)
+    void fillGraphPartPtRc(GC_cellInfo* cellsAttr, int& out_nstepsFront, int& out_nstepsBehind, int vertexIndex,
+                           int cam, float weight,
                            bool fixesSigma, float nPixelSizeBehind, bool allPoints, bool behind, bool fillOut,
                            float distFcnHeight);
 
@@ -310,8 +313,12 @@ public:
 
     void reconstructGC(const Point3d* hexah);
 
+    /// run the maxflow solver selected by delaunaycut.maxFlowAlg on the s-t graph
     void maxflow();
 
+    template<class MaxFlowT>
+    void maxflowGraph();
+
     void reconstructExpetiments(const StaticVector<int>& cams, const std::string& folderName,
                                 bool update, Point3d hexahInflated[8], const std::string& tmpCamsPtsFolderName,
                                 const Point3d& spaceSteps);
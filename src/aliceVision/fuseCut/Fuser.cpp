@@ -21,6 +21,7 @@
 #include <boost/accumulators/statistics.hpp>
 
 #include <iostream>
+#include <limits>
 
 namespace aliceVision {
 namespace fuseCut {
@@ -131,18 +132,123 @@ bool Fuser::updateInSurr(int pixSizeBall, int pixSizeBallWSP, Point3d& p, int rc
     return true;
 }
 
+std::shared_ptr<StaticVector<float>> Fuser::getTcDepthMap(int tc)
+{
+    // serialize the loads of the same tc, concurrent loads of different tcs stay parallel
+    std::lock_guard<std::mutex> lockTc(_tcDepthMapMutexes.at(tc));
+
+    {
+        std::lock_guard<std::mutex> lock(_tcDepthMapCacheMutex);
+        auto it = _tcDepthMapCache.find(tc);
+        if(it != _tcDepthMapCache.end())
+            return it->second;
+    }
+
+    auto tcdepthMap = std::make_shared<StaticVector<float>>();
+
+    {
+        int width, height;
+
+        imageIO::readImage(getFileNameFromIndex(mp, tc, mvsUtils::EFileType::depthMap, 1), width, height, tcdepthMap->getDataWritable());
+
+        // transpose image in-place, width/height are no more valid after this function.
+        imageIO::transposeImage(width, height, tcdepthMap->getDataWritable());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_tcDepthMapCacheMutex);
+        _tcDepthMapCache[tc] = tcdepthMap;
+    }
+
+    return tcdepthMap;
+}
+
+void Fuser::releaseTcDepthMap(int tc)
+{
+    std::lock_guard<std::mutex> lock(_tcDepthMapCacheMutex);
+
+    auto it = _tcDepthMapRefCount.find(tc);
+    if(it == _tcDepthMapRefCount.end())
+        return;
+
+    --it->second;
+    if(it->second <= 0)
+    {
+        _tcDepthMapRefCount.erase(it);
+        _tcDepthMapCache.erase(tc);
+    }
+}
+
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 void Fuser::filterGroups(const StaticVector<int>& cams, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
 {
     ALICEVISION_LOG_INFO("Precomputing groups.");
     long t1 = clock();
-#pragma omp parallel for
+
+    // tc sets of all reference cameras, used to group the rcs sharing target
+    // cameras and to count the consumers of each tc depth map
+    std::vector<StaticVector<int>> tcamsPerRc(cams.size());
     for(int c = 0; c < cams.size(); c++)
+        tcamsPerRc[c] = mp->findNearestCamsFromLandmarks(cams[c], nNearestCams);
+
+    std::map<int, std::vector<int>> tcConsumers;
+    for(int c = 0; c < cams.size(); c++)
+        for(int i = 0; i < tcamsPerRc[c].size(); i++)
+            tcConsumers[tcamsPerRc[c][i]].push_back(c);
+
+    // reorder the rcs so that the consumers of a tc depth map run close to each
+    // other: breadth-first traversal of the graph connecting rcs with common tcs
+    std::vector<int> order;
+    order.reserve(cams.size());
     {
-        int rc = cams[c];
-        filterGroupsRC(rc, pixSizeBall, pixSizeBallWSP, nNearestCams);
+        std::vector<bool> queued(cams.size(), false);
+        for(int seed = 0; seed < cams.size(); seed++)
+        {
+            if(queued[seed])
+                continue;
+            queued[seed] = true;
+            order.push_back(seed);
+            for(std::size_t head = order.size() - 1; head < order.size(); head++)
+            {
+                const int c = order[head];
+                for(int i = 0; i < tcamsPerRc[c].size(); i++)
+                {
+                    for(const int c2 : tcConsumers[tcamsPerRc[c][i]])
+                    {
+                        if(!queued[c2])
+                        {
+                            queued[c2] = true;
+                            order.push_back(c2);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // consumer counts of the tc depth maps, they enable the shared cache in filterGroupsRC
+    _tcDepthMapCache.clear();
+    _tcDepthMapRefCount.clear();
+    _tcDepthMapMutexes.clear();
+    for(const auto& consumers : tcConsumers)
+    {
+        _tcDepthMapRefCount[consumers.first] = (int)consumers.second.size();
+        _tcDepthMapMutexes[consumers.first]; // default construct the per-tc mutex
+    }
+
+    // dynamic schedule keeps the threads on neighbouring entries of the
+    // overlap-grouped order, so the cached working set stays small
+#pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < cams.size(); i++)
+    {
+        const int c = order[i];
+        filterGroupsRC(cams[c], pixSizeBall, pixSizeBallWSP, tcamsPerRc[c]);
     }
 
+    _tcDepthMapCache.clear();
+    _tcDepthMapRefCount.clear();
+    _tcDepthMapMutexes.clear();
+
     mvsUtils::printfElapsedTime(t1);
 }
 
@@ -154,6 +260,19 @@ bool Fuser::filterGroupsRC(int rc, int pixSizeBall, int pixSizeBallWSP, int nNea
         return true;
     }
 
+    return filterGroupsRC(rc, pixSizeBall, pixSizeBallWSP, mp->findNearestCamsFromLandmarks(rc, nNearestCams));
+}
+
+bool Fuser::filterGroupsRC(int rc, int pixSizeBall, int pixSizeBallWSP, const StaticVector<int>& tcams)
+{
+    if(mvsUtils::FileExists(getFileNameFromIndex(mp, rc, mvsUtils::EFileType::nmodMap)))
+    {
+        // this rc will not consume its tc depth maps
+        for(int c = 0; c < tcams.size(); c++)
+            releaseTcDepthMap(tcams[c]);
+        return true;
+    }
+
     long t1 = clock();
     int w = mp->getWidth(rc);
     int h = mp->getHeight(rc);
@@ -185,35 +304,125 @@ bool Fuser::filterGroupsRC(int rc, int pixSizeBall, int pixSizeBallWSP, int nNea
     numOfPtsMap->reserve(w * h);
     numOfPtsMap->resize_with(w * h, 0);
 
-    StaticVector<int> tcams = mp->findNearestCamsFromLandmarks(rc, nNearestCams);
+    // depth range of rc, bounds the frustum slab used to window the tc depth map reads
+    float rcMinDepth = std::numeric_limits<float>::max();
+    float rcMaxDepth = -1.0f;
+    for(int i = 0; i < depthMap.size(); i++)
+    {
+        const float depth = depthMap[i];
+        if(depth > 0.0f)
+        {
+            rcMinDepth = std::min(rcMinDepth, depth);
+            rcMaxDepth = std::max(rcMaxDepth, depth);
+        }
+    }
 
     for(int c = 0; c < tcams.size(); c++)
     {
         numOfPtsMap->resize_with(w * h, 0);
         int tc = tcams[c];
 
+        // window of tc pixels whose points can fall into the frustum slab of rc,
+        // computed by projecting the slab corners into tc; a point outside the
+        // slab cannot match any rc depth, so the rest of the tc map is not read
+        int winLUX = 0;
+        int winLUY = 0;
+        int winW = mp->getWidth(tc);
+        int winH = mp->getHeight(tc);
+        if(rcMaxDepth > 0.0f)
+        {
+            // depth range slightly extended to cover the matching tolerance
+            const double dMin = rcMinDepth * 0.95;
+            const double dMax = rcMaxDepth * 1.05;
+            const Point2d rcCorners[4] = {Point2d(0.0, 0.0), Point2d((double)(w - 1), 0.0),
+                                          Point2d(0.0, (double)(h - 1)), Point2d((double)(w - 1), (double)(h - 1))};
+
+            double minx = std::numeric_limits<double>::max();
+            double miny = std::numeric_limits<double>::max();
+            double maxx = std::numeric_limits<double>::lowest();
+            double maxy = std::numeric_limits<double>::lowest();
+            bool projectionsValid = true;
+
+            for(int ci = 0; ci < 4 && projectionsValid; ci++)
+            {
+                const Point3d ray = (mp->iCamArr[rc] * rcCorners[ci]).normalize();
+                for(int di = 0; di < 2; di++)
+                {
+                    const Point3d p = mp->CArr[rc] + ray * ((di == 0) ? dMin : dMax);
+                    const Point3d pt = mp->camArr[tc] * p;
+                    if(pt.z <= 0.0)
+                    {
+                        // a slab corner is behind tc, fall back to the full map
+                        projectionsValid = false;
+                        break;
+                    }
+                    minx = std::min(minx, pt.x / pt.z);
+                    miny = std::min(miny, pt.y / pt.z);
+                    maxx = std::max(maxx, pt.x / pt.z);
+                    maxy = std::max(maxy, pt.y / pt.z);
+                }
+            }
+
+            if(projectionsValid)
+            {
+                const int margin = 10;
+                winLUX = std::min(std::max((int)std::floor(minx) - margin, 0), mp->getWidth(tc));
+                winLUY = std::min(std::max((int)std::floor(miny) - margin, 0), mp->getHeight(tc));
+                winW = std::min(std::max((int)std::ceil(maxx) + margin + 1, 0), mp->getWidth(tc)) - winLUX;
+                winH = std::min(std::max((int)std::ceil(maxy) + margin + 1, 0), mp->getHeight(tc)) - winLUY;
+            }
+        }
+
+        // transposed tc depths, either the full map from the shared cache (when
+        // running under filterGroups) or only the window read from disk
+        std::shared_ptr<StaticVector<float>> cachedTcDepthMap;
         StaticVector<float> tcdepthMap;
+        const float* tcDepths = nullptr;
+        int tcDepthsLUX = 0;
+        int tcDepthsLUY = 0;
+        int tcDepthsColH = 0;
 
+        bool useCache;
         {
-            int width, height;
+            std::lock_guard<std::mutex> lock(_tcDepthMapCacheMutex);
+            useCache = (_tcDepthMapRefCount.count(tc) != 0);
+        }
 
-            imageIO::readImage(getFileNameFromIndex(mp, tc, mvsUtils::EFileType::depthMap, 1), width, height, tcdepthMap.getDataWritable());
+        if((winW > 0) && (winH > 0))
+        {
+            if(useCache)
+            {
+                cachedTcDepthMap = getTcDepthMap(tc);
+                tcDepths = cachedTcDepthMap->getData().data();
+                tcDepthsColH = mp->getHeight(tc);
+            }
+            else
+            {
+                imageIO::readImageWindow(getFileNameFromIndex(mp, tc, mvsUtils::EFileType::depthMap, 1), winLUX, winLUY,
+                                         winW, winH, tcdepthMap.getDataWritable());
+
+                // transpose image in-place, width/height are no more valid after this function.
+                imageIO::transposeImage(winW, winH, tcdepthMap.getDataWritable());
 
-            // transpose image in-place, width/height are no more valid after this function.
-            imageIO::transposeImage(width, height, tcdepthMap.getDataWritable());
+                tcDepths = tcdepthMap.getData().data();
+                tcDepthsLUX = winLUX;
+                tcDepthsLUY = winLUY;
+                tcDepthsColH = winH;
+            }
         }
 
-        if(!tcdepthMap.empty())
+        if(tcDepths != nullptr)
         {
-            for(int i = 0; i < sizeOfStaticVector<float>(&tcdepthMap); i++)
+            for(int x = winLUX; x < winLUX + winW; x++)
             {
-                int x = i / h;
-                int y = i % h;
-                float depth = tcdepthMap[i];
-                if(depth > 0.0f)
+                for(int y = winLUY; y < winLUY + winH; y++)
                 {
-                    Point3d p = mp->CArr[tc] + (mp->iCamArr[tc] * Point2d((float)x, (float)y)).normalize() * depth;
-                    updateInSurr(pixSizeBall, pixSizeBallWSP, p, rc, tc, numOfPtsMap, &depthMap, &simMap, 1);
+                    float depth = tcDepths[(x - tcDepthsLUX) * tcDepthsColH + (y - tcDepthsLUY)];
+                    if(depth > 0.0f)
+                    {
+                        Point3d p = mp->CArr[tc] + (mp->iCamArr[tc] * Point2d((float)x, (float)y)).normalize() * depth;
+                        updateInSurr(pixSizeBall, pixSizeBallWSP, p, rc, tc, numOfPtsMap, &depthMap, &simMap, 1);
+                    }
                 }
             }
 
@@ -222,6 +431,9 @@ bool Fuser::filterGroupsRC(int rc, int pixSizeBall, int pixSizeBallWSP, int nNea
                 numOfModalsMap.at(i) += static_cast<int>((*numOfPtsMap)[i] > 0);
             }
         }
+
+        if(useCache)
+            releaseTcDepthMap(tc);
     }
 
     {
@@ -877,8 +1089,10 @@ std::string generateTempPtsSimsFiles(std::string tmpDir, mvsUtils::MultiViewPara
                     mvsUtils::printfElapsedTime(t1);
             }
 
-            saveArrayToFile<Point3d>(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "pts.bin", pts);
-            saveArrayToFile<float>(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "sims.bin", sims);
+            // mappable layout: the fusion stage reads these back through ArrayFileView,
+            // straight out of the page cache without a decompression pass
+            saveArrayToFileMappable<Point3d>(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "pts.bin", pts);
+            saveArrayToFileMappable<float>(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "sims.bin", sims);
             delete pts;
             delete sims;
         }
@@ -12,6 +12,10 @@
 #include <aliceVision/mvsData/Universe.hpp>
 #include <aliceVision/mvsData/Voxel.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 namespace aliceVision {
 
 namespace sfmData {
@@ -47,6 +51,21 @@ public:
 private:
     bool updateInSurr(int pixSizeBall, int pixSizeBallWSP, Point3d& p, int rc, int tc, StaticVector<int>* numOfPtsMap,
                       StaticVector<float>* depthMap, StaticVector<float>* simMap, int scale);
+
+    bool filterGroupsRC(int rc, int pixSizeBall, int pixSizeBallWSP, const StaticVector<int>& tcams);
+
+    /// load (or get from the cache) the decoded, transposed depth map of tc
+    std::shared_ptr<StaticVector<float>> getTcDepthMap(int tc);
+    /// one consumer of the tc depth map is done, drop the map once all are
+    void releaseTcDepthMap(int tc);
+
+    // shared cache of decoded tc depth maps used by filterGroups(): each map
+    // stays resident until all the reference cameras that consume it have been
+    // processed (_tcDepthMapRefCount holds the remaining consumer counts)
+    std::map<int, std::shared_ptr<StaticVector<float>>> _tcDepthMapCache;
+    std::map<int, int> _tcDepthMapRefCount;
+    std::map<int, std::mutex> _tcDepthMapMutexes;
+    std::mutex _tcDepthMapCacheMutex;
 };
 
 unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams* mp, int scale);
@@ -0,0 +1,276 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MaxFlow_PushRelabel.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace fuseCut {
+
+void MaxFlow_PushRelabel::buildGraph()
+{
+    const std::size_t nbEdges = _inputEdges.size();
+
+    _firstEdge.assign(_numNodes + 1, 0);
+    for(const auto& edge: _inputEdges)
+    {
+        ++_firstEdge[edge.first + 1];
+    }
+    for(std::size_t n = 0; n < _numNodes; ++n)
+    {
+        _firstEdge[n + 1] += _firstEdge[n];
+    }
+
+    _edgeDst.resize(nbEdges);
+    _edgeReverse.resize(nbEdges);
+    _residual.resize(nbEdges);
+
+    // CSR position of every input edge, needed to link the reverse edges without
+    // the lookup map which makes the memory peak of MaxFlow_CSR
+    std::vector<std::size_t> csrIndex(nbEdges);
+    {
+        std::vector<std::size_t> nextEdge(_firstEdge.begin(), _firstEdge.end() - 1);
+        for(std::size_t i = 0; i < nbEdges; ++i)
+        {
+            const std::size_t e = nextEdge[_inputEdges[i].first]++;
+            csrIndex[i] = e;
+            _edgeDst[e] = _inputEdges[i].second;
+            _residual[e] = _inputCapacities[i];
+        }
+    }
+    for(std::size_t i = 0; i < nbEdges; ++i)
+    {
+        _edgeReverse[csrIndex[i]] = csrIndex[i ^ 1]; // the reverse of the input edge i is the input edge i^1
+    }
+
+    // force clear
+    std::vector<std::pair<NodeType, NodeType>>().swap(_inputEdges);
+    std::vector<ValueType>().swap(_inputCapacities);
+}
+
+void MaxFlow_PushRelabel::globalRelabel()
+{
+    _label.assign(_numNodes, (int)_numNodes);
+    _label[_T] = 0;
+
+    std::vector<unsigned char> visited(_numNodes, 0);
+    visited[_T] = 1;
+
+    // level synchronous reverse BFS from the sink along the residual edges
+    std::vector<NodeType> frontier;
+    frontier.push_back(_T);
+    int dist = 0;
+
+    while(!frontier.empty())
+    {
+        ++dist;
+        std::vector<NodeType> nextFrontier;
+
+#pragma omp parallel
+        {
+            std::vector<NodeType> localFrontier;
+
+#pragma omp for nowait
+            for(int i = 0; i < (int)frontier.size(); ++i)
+            {
+                const NodeType u = frontier[i];
+                for(std::size_t e = _firstEdge[u]; e < _firstEdge[u + 1]; ++e)
+                {
+                    if(_residual[_edgeReverse[e]] <= 0.0f) // no residual edge towards u
+                        continue;
+                    const NodeType v = _edgeDst[e];
+
+                    unsigned char wasVisited;
+#pragma omp atomic capture
+                    { wasVisited = visited[v]; visited[v] = 1; }
+
+                    if(wasVisited == 0)
+                    {
+                        _label[v] = dist; // only the winning thread writes the node
+                        localFrontier.push_back(v);
+                    }
+                }
+            }
+
+#pragma omp critical
+            nextFrontier.insert(nextFrontier.end(), localFrontier.begin(), localFrontier.end());
+        }
+
+        frontier.swap(nextFrontier);
+    }
+
+    _label[_S] = (int)_numNodes; // the source never pushes back
+}
+
+void MaxFlow_PushRelabel::collectActiveNodes(std::vector<NodeType>& activeNodes)
+{
+    activeNodes.clear();
+    std::fill(_inActiveList.begin(), _inActiveList.end(), 0);
+    for(std::size_t n = 0; n < _numNodes; ++n)
+    {
+        if((NodeType(n) == _S) || (NodeType(n) == _T))
+            continue;
+        if((_excess[n] > 0.0f) && (_label[n] < (int)_numNodes))
+        {
+            activeNodes.push_back(NodeType(n));
+            _inActiveList[n] = 1;
+        }
+    }
+}
+
+MaxFlow_PushRelabel::ValueType MaxFlow_PushRelabel::compute()
+{
+    ALICEVISION_LOG_INFO("MaxFlow_PushRelabel: build graph.");
+    buildGraph();
+    ALICEVISION_LOG_INFO("# nodes: " << _numNodes << ", # directed edges: " << _edgeDst.size());
+
+    _excess.assign(_numNodes, 0.0f);
+    _inActiveList.assign(_numNodes, 0);
+
+    // saturate the source edges
+    for(std::size_t e = _firstEdge[_S]; e < _firstEdge[_S + 1]; ++e)
+    {
+        const ValueType delta = _residual[e];
+        if(delta <= 0.0f)
+            continue;
+        _residual[e] = 0.0f;
+        _residual[_edgeReverse[e]] += delta;
+        _excess[_edgeDst[e]] += delta;
+    }
+
+    globalRelabel();
+
+    std::vector<NodeType> activeNodes;
+    collectActiveNodes(activeNodes);
+
+    // redo an exact relabeling after this amount of discharge work, the usual heuristic
+    const std::size_t relabelWorkThreshold = 6 * _numNodes + _edgeDst.size();
+    std::size_t workSinceRelabel = 0;
+    std::size_t nbRounds = 0;
+
+    ALICEVISION_LOG_INFO("MaxFlow_PushRelabel: compute.");
+    while(!activeNodes.empty())
+    {
+        if(workSinceRelabel > relabelWorkThreshold)
+        {
+            globalRelabel();
+            collectActiveNodes(activeNodes);
+            workSinceRelabel = 0;
+            if(activeNodes.empty())
+                break;
+        }
+        ++nbRounds;
+
+        std::vector<NodeType> touchedNodes;
+        std::size_t work = 0;
+
+        // the labels are frozen during the pushes and only raised afterwards, so an edge
+        // admissible for one thread cannot be admissible in the other direction for
+        // another one; each active node is discharged by a single thread, which is the
+        // only one to decrease its excess and the residuals of its out-edges
+#pragma omp parallel reduction(+:work)
+        {
+            std::vector<NodeType> localTouched;
+
+#pragma omp for nowait
+            for(int i = 0; i < (int)activeNodes.size(); ++i)
+            {
+                const NodeType u = activeNodes[i];
+                ValueType excess = _excess[u];
+                work += (_firstEdge[u + 1] - _firstEdge[u]) + 1;
+
+                for(std::size_t e = _firstEdge[u]; (e < _firstEdge[u + 1]) && (excess > 0.0f); ++e)
+                {
+                    const NodeType v = _edgeDst[e];
+                    if(_label[u] != _label[v] + 1)
+                        continue;
+                    const ValueType delta = std::min(excess, _residual[e]);
+                    if(delta <= 0.0f)
+                        continue;
+
+#pragma omp atomic update
+                    _residual[e] -= delta;
+#pragma omp atomic update
+                    _residual[_edgeReverse[e]] += delta;
+#pragma omp atomic update
+                    _excess[v] += delta;
+#pragma omp atomic update
+                    _excess[u] -= delta;
+                    excess -= delta;
+
+                    if((v != _S) && (v != _T))
+                    {
+                        unsigned char wasInList;
+#pragma omp atomic capture
+                        { wasInList = _inActiveList[v]; _inActiveList[v] = 1; }
+                        if(wasInList == 0)
+                            localTouched.push_back(v);
+                    }
+                }
+            }
+
+#pragma omp critical
+            touchedNodes.insert(touchedNodes.end(), localTouched.begin(), localTouched.end());
+        }
+        workSinceRelabel += work;
+
+        // raise the labels of the nodes with a leftover excess; the labels only grow,
+        // so the validity of the labeling survives the concurrent reads
+#pragma omp parallel for
+        for(int i = 0; i < (int)activeNodes.size(); ++i)
+        {
+            const NodeType u = activeNodes[i];
+            if(_excess[u] <= 0.0f)
+                continue;
+            int minLabel = (int)_numNodes;
+            for(std::size_t e = _firstEdge[u]; e < _firstEdge[u + 1]; ++e)
+            {
+                if(_residual[e] > 0.0f)
+                    minLabel = std::min(minLabel, _label[_edgeDst[e]] + 1);
+            }
+            if(minLabel > _label[u])
+                _label[u] = minLabel;
+        }
+
+        // next round: the nodes which received some excess plus the ones with a leftover
+        std::vector<NodeType> nextActiveNodes;
+        nextActiveNodes.reserve(activeNodes.size() + touchedNodes.size());
+        for(int pass = 0; pass < 2; ++pass)
+        {
+            for(const NodeType u: ((pass == 0) ? activeNodes : touchedNodes))
+            {
+                if((_excess[u] > 0.0f) && (_label[u] < (int)_numNodes))
+                {
+                    nextActiveNodes.push_back(u);
+                }
+                else
+                {
+                    _inActiveList[u] = 0;
+                }
+            }
+        }
+        activeNodes.swap(nextActiveNodes);
+    }
+
+    ALICEVISION_LOG_INFO("MaxFlow_PushRelabel: converged after " << nbRounds << " rounds.");
+
+    // the cut: the nodes which can still reach the sink are on the target side
+    globalRelabel();
+    _isTarget.resize(_numNodes);
+    for(std::size_t n = 0; n < _numNodes; ++n)
+    {
+        _isTarget[n] = (_label[n] < (int)_numNodes);
+    }
+
+    return _excess[_T];
+}
+
+} // namespace fuseCut
+} // namespace aliceVision
@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Maxflow computation based on a parallel push-relabel algorithm.
+ *
+ * The pushes of one round use frozen distance labels and only atomic updates on the
+ * residual capacities and excesses, so the active nodes can be discharged by all the
+ * OpenMP threads at once; the labels are then raised and the rounds are interleaved
+ * with exact global relabelings (a reverse BFS from the sink). The min-cut is the same
+ * as with the Boykov-Kolmogorov solvers, only the run time differs: push-relabel scales
+ * with the cores but does more work per node, so it pays off on the large graphs.
+ *
+ * @see MaxFlow_AdjList for the single-threaded default.
+ */
+class MaxFlow_PushRelabel
+{
+public:
+    using NodeType = int;
+    using ValueType = float;
+
+public:
+    explicit MaxFlow_PushRelabel(std::size_t numNodes)
+        : _numNodes(numNodes + 2)
+        , _S(NodeType(numNodes))
+        , _T(NodeType(numNodes + 1))
+    {
+        const std::size_t nbEdgesEstimation = numNodes * 9 + numNodes * 2;
+        _inputEdges.reserve(nbEdgesEstimation);
+        _inputCapacities.reserve(nbEdgesEstimation);
+    }
+
+    inline void addNode(NodeType n, ValueType source, ValueType sink)
+    {
+        assert(source >= 0 && sink >= 0);
+        ValueType score = source - sink;
+        if(score > 0)
+        {
+            this->addEdge(_S, n, score, score);
+        }
+        else //if(score <= 0)
+        {
+            this->addEdge(n, _T, -score, -score);
+        }
+    }
+
+    inline void addEdge(NodeType n1, NodeType n2, ValueType capacity, ValueType reverseCapacity)
+    {
+        assert(capacity >= 0 && reverseCapacity >= 0);
+
+        // the reverse of the edge at index i is always at index i^1
+        _inputEdges.push_back(std::make_pair(n1, n2));
+        _inputCapacities.push_back(capacity);
+
+        _inputEdges.push_back(std::make_pair(n2, n1));
+        _inputCapacities.push_back(reverseCapacity);
+    }
+
+    ValueType compute();
+
+    /// is empty
+    inline bool isSource(NodeType n) const
+    {
+        return !_isTarget[n];
+    }
+    /// is full
+    inline bool isTarget(NodeType n) const
+    {
+        return _isTarget[n];
+    }
+
+private:
+    /// build the CSR arrays from the input edges and free the input arrays
+    void buildGraph();
+    /// set the labels to the exact distance to the sink in the residual graph (_numNodes if unreachable)
+    void globalRelabel();
+    /// collect all the nodes with some excess and a label below _numNodes
+    void collectActiveNodes(std::vector<NodeType>& activeNodes);
+
+    std::size_t _numNodes; // including source and sink
+    const NodeType _S;  //< emptyness
+    const NodeType _T;  //< fullness
+
+    std::vector<std::pair<NodeType, NodeType>> _inputEdges;
+    std::vector<ValueType> _inputCapacities;
+
+    // graph in CSR layout
+    std::vector<std::size_t> _firstEdge; // per node index of its first out-edge, _numNodes + 1 entries
+    std::vector<NodeType> _edgeDst;
+    std::vector<std::size_t> _edgeReverse;
+    std::vector<ValueType> _residual;
+
+    std::vector<ValueType> _excess;
+    std::vector<int> _label;
+    std::vector<unsigned char> _inActiveList;
+    std::vector<bool> _isTarget;
+};
+
+} // namespace fuseCut
+} // namespace aliceVision
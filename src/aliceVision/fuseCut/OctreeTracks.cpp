@@ -6,6 +6,7 @@
 
 #include "OctreeTracks.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mvsData/ArrayFileView.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
@@ -13,7 +14,10 @@
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 namespace aliceVision {
 namespace fuseCut {
@@ -23,6 +27,20 @@ OctreeTracks::Node::Node(NodeType type)
     type_ = type;
 }
 
+uint64_t OctreeTracks::mortonCode(int x, int y, int z) const
+{
+    // interleave the x, y and z bits from the most significant one, so that
+    // sorting by code reproduces the depth-first traversal order of the
+    // pointer octree (x is the outermost child index, z the innermost)
+    uint64_t code = 0;
+    for(int size = size_ / 2; size > 0; size /= 2)
+    {
+        code = (code << 3) |
+               (uint64_t)((!((x & size) == 0)) << 2 | (!((y & size) == 0)) << 1 | (!((z & size) == 0)));
+    }
+    return code;
+}
+
 OctreeTracks::trackStruct* OctreeTracks::getTrack(int x, int y, int z)
 {
     if(!((x >= 0 && x < size_) && (y >= 0 && y < size_) && (z >= 0 && z < size_)))
@@ -30,6 +48,12 @@ OctreeTracks::trackStruct* OctreeTracks::getTrack(int x, int y, int z)
         return nullptr;
     }
 
+    if(useHashGrid_)
+    {
+        auto it = grid_.find(mortonCode(x, y, z));
+        return (it == grid_.end()) ? nullptr : it->second;
+    }
+
     Node** n = &root_;
     int size = size_;
 
@@ -58,6 +82,24 @@ void OctreeTracks::addPoint(int x, int y, int z, float sim, float pixSize, Point
     assert(y >= 0 && y < size_);
     assert(z >= 0 && z < size_);
 
+    if(useHashGrid_)
+    {
+        trackStruct*& t = grid_[mortonCode(x, y, z)];
+        if(t == nullptr)
+        {
+            // the pool keeps the track addresses stable, the callers hold
+            // raw pointers into it until the octree is deleted
+            pool_.emplace_back(sim, pixSize, p, rc);
+            t = &pool_.back();
+            leafsNumber_++;
+        }
+        else
+        {
+            t->addPoint(sim, pixSize, p, rc);
+        }
+        return;
+    }
+
     Node** n = &root_;
     int size = size_;
 
@@ -91,6 +133,22 @@ void OctreeTracks::addTrack(int x, int y, int z, OctreeTracks::trackStruct* t)
     assert(y >= 0 && y < size_);
     assert(z >= 0 && z < size_);
 
+    if(useHashGrid_)
+    {
+        trackStruct*& nt = grid_[mortonCode(x, y, z)];
+        if(nt == nullptr)
+        {
+            pool_.emplace_back(t);
+            nt = &pool_.back();
+            leafsNumber_++;
+        }
+        else
+        {
+            nt->addTrack(t);
+        }
+        return;
+    }
+
     Node** n = &root_;
     int size = size_;
 
@@ -122,6 +180,18 @@ StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::getAllPoints()
 {
     StaticVector<trackStruct*>* out = new StaticVector<trackStruct*>();
     out->reserve(leafsNumber_);
+    if(useHashGrid_)
+    {
+        // export in Morton order to reproduce the depth-first traversal
+        // order of the pointer octree
+        std::vector<std::pair<uint64_t, trackStruct*>> leafs(grid_.begin(), grid_.end());
+        std::sort(leafs.begin(), leafs.end());
+        for(const auto& leaf : leafs)
+        {
+            out->push_back(leaf.second);
+        }
+        return out;
+    }
     if(root_ != nullptr)
     {
         getAllPointsRecursive(out, root_);
@@ -488,6 +558,7 @@ OctreeTracks::OctreeTracks(const Point3d* _voxel, mvsUtils::MultiViewParams* _mp
     sz = svz / (float)numSubVoxsZ;
 
     doFilterOctreeTracks = mp->userParams.get<bool>("LargeScale.doFilterOctreeTracks", true);
+    useHashGrid_ = mp->userParams.get<bool>("LargeScale.doUseOctreeHashGrid", true);
     doUseWeaklySupportedPoints = mp->userParams.get<bool>("LargeScale.doUseWeaklySupportedPoints", false);
     doUseWeaklySupportedPointCam = mp->userParams.get<bool>("LargeScale.doUseWeaklySupportedPointCam", false);
     minNumOfConsistentCams = mp->userParams.get<int>("filter.minNumOfConsistentCams", 2);
@@ -680,20 +751,34 @@ StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::fillOctree(int maxPts, s
     t1 = clock();
 
 
-    // long t1=initEstimate();
+    // The per-camera work (file loading, voxel mapping and pixel size
+    // computation) only reads shared data, so it runs in parallel into
+    // thread-local buffers; only the merge of each buffer into the shared
+    // octree is serialized.
+    bool tooManyPts = false;
+
+    #pragma omp parallel for schedule(dynamic)
     for(int camid = 0; camid < cams.size(); camid++)
     {
-        int rc = cams[camid];
-        StaticVector<Point3d>* pts =
-            loadArrayFromFile<Point3d>(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "pts.bin");
-        StaticVector<float>* sims =
-            loadArrayFromFile<float>(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "sims.bin");
+        if(tooManyPts)
+            continue;
 
-        // long tpts=initEstimate();
-        for(int i = 0; i < pts->size(); i++)
+        int rc = cams[camid];
+        // read-only pass over the per-camera dumps: map them instead of copying
+        const ArrayFileView<Point3d> pts(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "pts.bin");
+        const ArrayFileView<float> sims(depthMapsPtsSimsTmpDir + std::to_string(mp->getViewId(rc)) + "sims.bin");
+
+        // prepare the insertions of this camera into thread-local buffers
+        std::vector<Voxel> ptsVoxels;
+        std::vector<Point3d> ptsCoords;
+        std::vector<float> ptsSims;
+        std::vector<float> ptsPixSizes;
+        ptsVoxels.reserve(pts.size());
+
+        for(int i = 0; i < pts.size(); i++)
         {
-            float sim = (*sims)[i];
-            Point3d p = (*pts)[i];
+            float sim = sims[i];
+            Point3d p = pts[i];
 
             Voxel otVox;
             if(((doUseWeaklySupportedPoints) || (sim < simWspThr)) && (getVoxelOfOctreeFor3DPoint(otVox, p))) // doUseWeaklySupportedPoints: false by default
@@ -705,24 +790,33 @@ StaticVector<OctreeTracks::trackStruct*>* OctreeTracks::fillOctree(int maxPts, s
                         sim -= 2.0f;
                     }
                 }
-                float pixSize = mp->getCamPixelSize(p, rc);
-                addPoint(otVox.x, otVox.y, otVox.z, sim, pixSize, p, rc);
-            }
-            if(leafsNumber_ > 2 * maxPts)
-            {
-                return nullptr;
+                ptsVoxels.push_back(otVox);
+                ptsCoords.push_back(p);
+                ptsSims.push_back(sim);
+                ptsPixSizes.push_back(mp->getCamPixelSize(p, rc));
             }
-
-            // printfEstimate(i, pts->size(), tpts);
         } // for i
-          // finishEstimate();
-
-        delete pts;
-        delete sims;
 
-        // printfEstimate(camid, cams.size(), t1);
+        // merge the prepared points of this camera into the shared octree
+        #pragma omp critical(octreeTracksFill)
+        {
+            if(!tooManyPts)
+            {
+                for(std::size_t i = 0; i < ptsVoxels.size(); i++)
+                {
+                    addPoint(ptsVoxels[i].x, ptsVoxels[i].y, ptsVoxels[i].z, ptsSims[i], ptsPixSizes[i], ptsCoords[i], rc);
+                    if(leafsNumber_ > 2 * maxPts)
+                    {
+                        tooManyPts = true;
+                        break;
+                    }
+                }
+            }
+        }
     }
-    // finishEstimate();
+
+    if(tooManyPts)
+        return nullptr;
 
     StaticVector<trackStruct*>* tracks = getAllPoints();
     if(mp->verbose)
@@ -13,6 +13,10 @@
 #include <aliceVision/mvsData/Voxel.hpp>
 #include <aliceVision/fuseCut/Fuser.hpp>
 
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
 namespace aliceVision {
 namespace fuseCut {
 
@@ -67,6 +71,16 @@ public:
     int size_;
     int leafsNumber_;
 
+    /// flat alternative to the pointer octree: the tracks are pooled with
+    /// stable addresses and indexed by the Morton code of their voxel, which
+    /// avoids the per-node heap allocations and the cache-hostile pointer
+    /// chasing of the tree (see LargeScale.doUseOctreeHashGrid)
+    bool useHashGrid_;
+    std::unordered_map<uint64_t, trackStruct*> grid_;
+    std::deque<trackStruct> pool_;
+
+    uint64_t mortonCode(int x, int y, int z) const;
+
     // trackStruct* at( int x, int y, int z );
     trackStruct* getTrack(int x, int y, int z);
     void addTrack(int x, int y, int z, trackStruct* t);
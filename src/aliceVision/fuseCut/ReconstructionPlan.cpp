@@ -9,6 +9,7 @@
 #include <aliceVision/mvsData/Rgb.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/mesh/MeshBinView.hpp>
 #include <aliceVision/mesh/meshPostProcessing.hpp>
 #include <aliceVision/fuseCut/VoxelsGrid.hpp>
 #include <aliceVision/fuseCut/DelaunayGraphCut.hpp>
@@ -248,19 +249,27 @@ void ReconstructionPlan::getHexahedronForID(float dist, int id, Point3d* out)
     mvsUtils::inflateHexahedron(&(*voxels)[id * 8], out, dist);
 }
 
-void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileName, LargeScale* ls)
+void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileName, LargeScale* ls, int rangeStart, int rangeSize)
 {
     StaticVector<Point3d>* voxelsArray = loadArrayFromFile<Point3d>(voxelsArrayFileName);
 
     ReconstructionPlan* rp =
         new ReconstructionPlan(ls->dimensions, &ls->space[0], ls->mp, ls->spaceVoxelsFolderName);
 
-    StaticVector<Point3d>* hexahsToExcludeFromResultingMesh = new StaticVector<Point3d>();
-    hexahsToExcludeFromResultingMesh->reserve(voxelsArray->size());
+    const int nVoxels = voxelsArray->size() / 8;
+    int rangeEnd = nVoxels;
+    if(rangeStart < 0)
+    {
+        rangeStart = 0;
+    }
+    else if(rangeSize > 0)
+    {
+        rangeEnd = std::min(rangeStart + rangeSize, nVoxels);
+    }
 
-    for(int i = 0; i < voxelsArray->size() / 8; i++)
+    for(int i = rangeStart; i < rangeEnd; i++)
     {
-        ALICEVISION_LOG_INFO("Reconstructing " << (voxelsArray->size() / 8) << "-th Voxel of " <<  i << ".");
+        ALICEVISION_LOG_INFO("Reconstructing " << nVoxels << "-th Voxel of " <<  i << ".");
 
         const std::string folderName = ls->getReconstructionVoxelFolder(i);
         bfs::create_directory(folderName);
@@ -281,6 +290,23 @@ void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileNa
             delaunayGC.createGraphCut(hexah, cams, (VoxelsGrid*)rp, folderName, ls->getSpaceCamsTracksDir(), false, ls->getSpaceSteps());
             delete voxelsIds;
 
+            // exclude the interiors of all the other voxels so that the parts overlap in the
+            // same way whatever machine or order reconstructed them, and the borders trimmed
+            // in joinMeshes() stitch consistently
+            StaticVector<Point3d>* hexahsToExcludeFromResultingMesh = new StaticVector<Point3d>();
+            hexahsToExcludeFromResultingMesh->reserve((nVoxels - 1) * 8);
+            for(int j = 0; j < nVoxels; j++)
+            {
+                if(j == i)
+                    continue;
+                Point3d hexahThin[8];
+                mvsUtils::inflateHexahedron(&(*voxelsArray)[j * 8], hexahThin, 0.9);
+                for(int k = 0; k < 8; k++)
+                {
+                    hexahsToExcludeFromResultingMesh->push_back(hexahThin[k]);
+                }
+            }
+
             // Save mesh as .bin and .obj
             mesh::Mesh* mesh = delaunayGC.createMesh();
             StaticVector<StaticVector<int>*>* ptsCams = delaunayGC.createPtsCams();
@@ -293,6 +319,7 @@ void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileNa
             saveArrayOfArraysToFile<int>(folderName + "meshPtsCamsFromDGC.bin", ptsCams);
             deleteArrayOfArrays<int>(&ptsCams);
 
+            delete hexahsToExcludeFromResultingMesh;
             delete mesh;
         }
 
@@ -303,13 +330,6 @@ void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileNa
             computeColoredMesh(resultFolderName, ls);
         }
         */
-        Point3d hexahThin[8];
-        mvsUtils::inflateHexahedron(&(*voxelsArray)[i * 8], hexahThin, 0.9);
-        for(int k = 0; k < 8; k++)
-        {
-            hexahsToExcludeFromResultingMesh->push_back(hexahThin[k]);
-        }
-        delete hexahsToExcludeFromResultingMesh;
     }
     delete rp;
     delete voxelsArray;
@@ -378,15 +398,14 @@ mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Po
         std::string fileName = folderName + "mesh.bin";
         if(mvsUtils::FileExists(fileName))
         {
-            mesh::Mesh* mei = new mesh::Mesh();
-            mei->loadFromBin(fileName);
-            npts += mei->pts->size();
-            ntris += mei->tris->size();
-
-            ALICEVISION_LOG_DEBUG("npts: " << npts << " " << mei->pts->size());
-            ALICEVISION_LOG_DEBUG("ntris: " << ntris << " " << mei->tris->size());
-
-            delete mei;
+            // only the counts are needed here, the mapped view does not read the arrays
+            mesh::MeshBinView meiView;
+            meiView.open(fileName);
+            npts += meiView.nbPts();
+            ntris += meiView.nbTris();
+
+            ALICEVISION_LOG_DEBUG("npts: " << npts << " " << meiView.nbPts());
+            ALICEVISION_LOG_DEBUG("ntris: " << ntris << " " << meiView.nbTris());
         }
     }
 
@@ -414,8 +433,10 @@ mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Po
         std::string fileName = folderName + "mesh.bin";
         if(mvsUtils::FileExists(fileName))
         {
-            mesh::Mesh* mei = new mesh::Mesh();
-            mei->loadFromBin(fileName);
+            mesh::MeshBinView meiView;
+            meiView.open(fileName);
+            // the part is filtered and merged, so promote the view to a mutable mesh
+            mesh::Mesh* mei = meiView.promote();
 
             // to remove artefacts on the border
             Point3d hexah[8];
@@ -33,7 +33,21 @@ public:
 };
 
 void reconstructAccordingToOptimalReconstructionPlan(int gl, LargeScale* ls);
-void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileName, LargeScale* ls);
+
+/**
+ * @brief Reconstruct the voxels of the given array independently of each other.
+ *
+ * Each voxel tetrahedralization and graph-cut only needs the tracks of its own hexahedron,
+ * its result is written to its own folder and already reconstructed voxels are skipped,
+ * so the voxels can be distributed over several machines (each one computing a disjoint
+ * [rangeStart, rangeStart+rangeSize) sub-range) and joined afterwards with joinMeshes().
+ *
+ * @param[in] voxelsArrayFileName file with the hexahedra of the voxels to reconstruct
+ * @param[in] ls the large scale environment
+ * @param[in] rangeStart first voxel index to reconstruct, -1 to reconstruct all voxels
+ * @param[in] rangeSize number of voxels to reconstruct, ignored if rangeStart is -1
+ */
+void reconstructSpaceAccordingToVoxelsArray(const std::string& voxelsArrayFileName, LargeScale* ls, int rangeStart = -1, int rangeSize = -1);
 mesh::Mesh* joinMeshes(const std::vector<std::string>& recsDirs, StaticVector<Point3d>* voxelsArray, LargeScale* ls);
 mesh::Mesh* joinMeshes(int gl, LargeScale* ls);
 mesh::Mesh* joinMeshes(const std::string& voxelsArrayFileName, LargeScale* ls);
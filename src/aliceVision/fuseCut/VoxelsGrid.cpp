@@ -19,6 +19,97 @@ namespace fuseCut {
 
 namespace bfs = boost::filesystem;
 
+namespace {
+
+template <class T>
+void writePackedArray(FILE* f, const StaticVector<T>* a)
+{
+    const int n = a->size();
+    fwrite(&n, sizeof(int), 1, f);
+    if(n > 0)
+    {
+        fwrite(&(*a)[0], sizeof(T), n, f);
+    }
+}
+
+template <class T>
+StaticVector<T>* readPackedArray(FILE* f)
+{
+    int n = 0;
+    if(fread(&n, sizeof(int), 1, f) != 1)
+    {
+        ALICEVISION_THROW_ERROR("[IO] readPackedArray: can't read array size");
+    }
+    StaticVector<T>* a = new StaticVector<T>();
+    a->resize(n);
+    if((n > 0) && (fread(&(*a)[0], sizeof(T), n, f) != n))
+    {
+        delete a;
+        ALICEVISION_THROW_ERROR("[IO] readPackedArray: can't read " << n << " elements");
+    }
+    return a;
+}
+
+template <class T>
+void writePackedArrayOfArrays(FILE* f, StaticVector<StaticVector<T>*>* aa)
+{
+    const int n = aa->size();
+    fwrite(&n, sizeof(int), 1, f);
+    for(int i = 0; i < n; i++)
+    {
+        int m = 0;
+        StaticVector<T>* a = (*aa)[i];
+        if(a == NULL)
+        {
+            fwrite(&m, sizeof(int), 1, f);
+        }
+        else
+        {
+            m = a->size();
+            fwrite(&m, sizeof(int), 1, f);
+            if(m > 0)
+            {
+                fwrite(&(*a)[0], sizeof(T), m, f);
+            }
+        }
+    }
+}
+
+template <class T>
+StaticVector<StaticVector<T>*>* readPackedArrayOfArrays(FILE* f)
+{
+    int n = 0;
+    if(fread(&n, sizeof(int), 1, f) != 1)
+    {
+        ALICEVISION_THROW_ERROR("[IO] readPackedArrayOfArrays: can't read outer array size");
+    }
+    StaticVector<StaticVector<T>*>* aa = new StaticVector<StaticVector<T>*>();
+    aa->reserve(n);
+    aa->resize_with(n, NULL);
+    for(int i = 0; i < n; i++)
+    {
+        int m = 0;
+        if(fread(&m, sizeof(int), 1, f) != 1)
+        {
+            ALICEVISION_THROW_ERROR("[IO] readPackedArrayOfArrays: can't read inner array size");
+        }
+        if(m > 0)
+        {
+            StaticVector<T>* a = new StaticVector<T>();
+            a->resize(m);
+            if(fread(&(*a)[0], sizeof(T), m, f) != m)
+            {
+                delete a;
+                ALICEVISION_THROW_ERROR("[IO] readPackedArrayOfArrays: can't read vector element");
+            }
+            (*aa)[i] = a;
+        }
+    }
+    return aa;
+}
+
+} // namespace
+
 VoxelsGrid::VoxelsGrid()
 {
 }
@@ -77,18 +168,21 @@ StaticVector<int>* VoxelsGrid::getNVoxelsTracks()
 
     StaticVector<int>* nVoxelsTracks = new StaticVector<int>();
     nVoxelsTracks->reserve(voxels->size() / 8);
-    //long t1 = mvsUtils::initEstimate();
+
+#pragma omp critical(voxelsGridPackedTracks)
+    {
+        loadTracksIndex();
+    }
+
     for(int i = 0; i < voxels->size() / 8; i++)
     {
-        std::string folderName = getVoxelFolderName(i);
-        std::string fileNameTracksPts;
-        fileNameTracksPts = folderName + "tracksGridPts.bin";
-        int n = getArrayLengthFromFile(fileNameTracksPts);
+        const auto it = tracksIndex.find(i);
+        int n = (it != tracksIndex.end())
+                    ? it->second.ntracks
+                    : getArrayLengthFromFile(getVoxelFolderName(i) + "tracksGridPts.bin");
         // printf("%i %i\n",i,n);
         nVoxelsTracks->push_back(n);
-        //mvsUtils::printfEstimate(i, voxels->size() / 8, t1);
     }
-    //mvsUtils::finishEstimate();
 
     return nVoxelsTracks;
 }
@@ -98,18 +192,21 @@ unsigned long VoxelsGrid::getNTracks() const
     ALICEVISION_LOG_DEBUG("computing number of all tracks.");
 
     unsigned long ntracks = 0;
-    //long t1 = mvsUtils::initEstimate();
+
+#pragma omp critical(voxelsGridPackedTracks)
+    {
+        loadTracksIndex();
+    }
+
     for(int i = 0; i < voxels->size() / 8; i++)
     {
-        const std::string folderName = getVoxelFolderName(i);
-        std::string fileNameTracksPts;
-        fileNameTracksPts = folderName + "tracksGridPts.bin";
-        int n = getArrayLengthFromFile(fileNameTracksPts);
+        const auto it = tracksIndex.find(i);
+        int n = (it != tracksIndex.end())
+                    ? it->second.ntracks
+                    : getArrayLengthFromFile(getVoxelFolderName(i) + "tracksGridPts.bin");
         // printf("%i %i\n",i,n);
         ntracks += (unsigned long)n;
-        //mvsUtils::printfEstimate(i, voxels->size() / 8, t1);
     }
-    //mvsUtils::finishEstimate();
 
     return ntracks;
 }
@@ -153,22 +250,113 @@ std::string VoxelsGrid::getVoxelFolderName(int id) const
     return fnxyz;
 }
 
+std::string VoxelsGrid::getTracksContainerName() const
+{
+    return spaceRootDir + "tracksGridPacked.bin";
+}
+
+std::string VoxelsGrid::getTracksIndexName() const
+{
+    return spaceRootDir + "tracksGridPacked.idx";
+}
+
+void VoxelsGrid::loadTracksIndex() const
+{
+    if(tracksIndexLoaded)
+        return;
+
+    const std::string indexName = getTracksIndexName();
+    if(mvsUtils::FileExists(indexName))
+    {
+        FILE* f = fopen(indexName.c_str(), "rb");
+        if(f == nullptr)
+        {
+            ALICEVISION_THROW_ERROR("loadTracksIndex: can't open file " << indexName);
+        }
+        TracksIndexEntry entry;
+        while(fread(&entry, sizeof(TracksIndexEntry), 1, f) == 1)
+        {
+            tracksIndex[entry.voxelId] = entry; // the last written blob of a voxel wins
+        }
+        fclose(f);
+    }
+    tracksIndexLoaded = true;
+}
+
+bool VoxelsGrid::hasVoxelTracks(int id) const
+{
+#pragma omp critical(voxelsGridPackedTracks)
+    {
+        loadTracksIndex();
+    }
+    if(tracksIndex.find(id) != tracksIndex.end())
+    {
+        return true;
+    }
+    return mvsUtils::FileExists(getVoxelFolderName(id) + "tracksGridPts.bin");
+}
+
+bool VoxelsGrid::readTracksFromContainer(int id, StaticVector<int>** cams, StaticVector<Point3d>** tracksPoints,
+                                         StaticVector<Point3d>** tracksStat,
+                                         StaticVector<StaticVector<Pixel>*>** tracksPointsCams) const
+{
+#pragma omp critical(voxelsGridPackedTracks)
+    {
+        loadTracksIndex();
+    }
+
+    const auto it = tracksIndex.find(id);
+    if(it == tracksIndex.end())
+    {
+        return false;
+    }
+
+    // concurrent reads are safe, each gets its own read position
+    FILE* f = fopen(getTracksContainerName().c_str(), "rb");
+    if(f == nullptr)
+    {
+        ALICEVISION_THROW_ERROR("readTracksFromContainer: can't open file " << getTracksContainerName());
+    }
+    if(fseek(f, it->second.offset, SEEK_SET) != 0)
+    {
+        fclose(f);
+        ALICEVISION_THROW_ERROR("readTracksFromContainer: can't seek to voxel " << id << " in "
+                                << getTracksContainerName());
+    }
+
+    *cams = readPackedArray<int>(f);
+    *tracksPoints = readPackedArray<Point3d>(f);
+    *tracksStat = readPackedArray<Point3d>(f); // minPixSize, minSim, npts
+    *tracksPointsCams = readPackedArrayOfArrays<Pixel>(f);
+    fclose(f);
+
+    return true;
+}
+
 StaticVector<OctreeTracks::trackStruct*>* VoxelsGrid::loadTracksFromVoxelFiles(StaticVector<int>** cams, int id)
 {
-    const std::string folderName = getVoxelFolderName(id);
+    StaticVector<Point3d>* tracksStat = nullptr;
+    StaticVector<Point3d>* tracksPoints = nullptr;
+    StaticVector<StaticVector<Pixel>*>* tracksPointsCams = nullptr;
 
-    const std::string fileNameTracksCams = folderName + "tracksGridCams.bin";
-    const std::string fileNameTracksPts = folderName + "tracksGridPts.bin";
-    const std::string fileNameTracksPtsCams = folderName + "tracksGridPtsCams.bin";
-    const std::string fileNameTracksStat = folderName + "tracksGridStat.bin";
+    if(!readTracksFromContainer(id, cams, &tracksPoints, &tracksStat, &tracksPointsCams))
+    {
+        // fallback to the legacy one-folder-per-voxel layout
+        const std::string folderName = getVoxelFolderName(id);
 
-    if(!mvsUtils::FileExists(fileNameTracksPts))
-        return nullptr;
+        const std::string fileNameTracksCams = folderName + "tracksGridCams.bin";
+        const std::string fileNameTracksPts = folderName + "tracksGridPts.bin";
+        const std::string fileNameTracksPtsCams = folderName + "tracksGridPtsCams.bin";
+        const std::string fileNameTracksStat = folderName + "tracksGridStat.bin";
 
-    StaticVector<Point3d>* tracksStat = loadArrayFromFile<Point3d>(fileNameTracksStat); // minPixSize, minSim, npts
-    StaticVector<Point3d>* tracksPoints = loadArrayFromFile<Point3d>(fileNameTracksPts);
-    StaticVector<StaticVector<Pixel>*>* tracksPointsCams = loadArrayOfArraysFromFile<Pixel>(fileNameTracksPtsCams);
-    *cams = loadArrayFromFile<int>(fileNameTracksCams);
+        if(!mvsUtils::FileExists(fileNameTracksPts))
+            return nullptr;
+
+        tracksStat = loadArrayFromFile<Point3d>(fileNameTracksStat); // minPixSize, minSim, npts
+        tracksPoints = loadArrayFromFile<Point3d>(fileNameTracksPts);
+        tracksPointsCams = loadArrayOfArraysFromFile<Pixel>(fileNameTracksPtsCams);
+        *cams = loadArrayFromFile<int>(fileNameTracksCams);
+    }
 
     StaticVector<OctreeTracks::trackStruct*>* tracks = new StaticVector<OctreeTracks::trackStruct*>();
     tracks->reserve(tracksPoints->size());
@@ -200,14 +388,6 @@ bool VoxelsGrid::saveTracksToVoxelFiles(StaticVector<int>* cams, StaticVector<Oc
         return false;
     }
 
-    std::string folderName = getVoxelFolderName(id);
-
-    bfs::create_directory(folderName);
-    if(!mvsUtils::FolderExists(folderName))
-    {
-        ALICEVISION_LOG_WARNING("Folder '" << folderName << "' does not exist.");
-    }
-
     StaticVector<Point3d>* tracksPoints = new StaticVector<Point3d>();
     tracksPoints->reserve(tracks->size());
     StaticVector<StaticVector<Pixel>*>* tracksPointsCams = new StaticVector<StaticVector<Pixel>*>();
@@ -230,19 +410,41 @@ bool VoxelsGrid::saveTracksToVoxelFiles(StaticVector<int>* cams, StaticVector<Oc
         tracksPointsCams->push_back(tcams);
     }
 
-    // printf("SAVING %i-th VOXEL TRACKS\n",i);
-    std::string fileNameTracksCams, fileNameTracksPts,
-        fileNameTracksPtsCams, fileNameTracksStat;
+    // append the voxel blob to the packed per-space container instead of
+    // creating a folder with four files per voxel, concurrent writers are
+    // serialized on the container
+#pragma omp critical(voxelsGridPackedTracks)
+    {
+        loadTracksIndex();
 
-    fileNameTracksCams = folderName + "tracksGridCams.bin";
-    fileNameTracksPts = folderName + "tracksGridPts.bin";
-    fileNameTracksPtsCams = folderName + "tracksGridPtsCams.bin";
-    fileNameTracksStat = folderName + "tracksGridStat.bin";
+        FILE* f = fopen(getTracksContainerName().c_str(), "ab");
+        if(f == nullptr)
+        {
+            ALICEVISION_THROW_ERROR("saveTracksToVoxelFiles: can't open file " << getTracksContainerName());
+        }
+        fseek(f, 0, SEEK_END);
+
+        TracksIndexEntry entry;
+        entry.voxelId = id;
+        entry.ntracks = tracks->size();
+        entry.offset = ftell(f);
+
+        writePackedArray<int>(f, cams);
+        writePackedArray<Point3d>(f, tracksPoints);
+        writePackedArray<Point3d>(f, tracksStat);
+        writePackedArrayOfArrays<Pixel>(f, tracksPointsCams);
+        fclose(f);
+
+        FILE* fi = fopen(getTracksIndexName().c_str(), "ab");
+        if(fi == nullptr)
+        {
+            ALICEVISION_THROW_ERROR("saveTracksToVoxelFiles: can't open file " << getTracksIndexName());
+        }
+        fwrite(&entry, sizeof(TracksIndexEntry), 1, fi);
+        fclose(fi);
 
-    saveArrayToFile<int>(fileNameTracksCams, cams);
-    saveArrayToFile<Point3d>(fileNameTracksPts, tracksPoints);
-    saveArrayToFile<Point3d>(fileNameTracksStat, tracksStat);
-    saveArrayOfArraysToFile<Pixel>(fileNameTracksPtsCams, tracksPointsCams);
+        tracksIndex[id] = entry;
+    }
 
     delete tracksPoints;
     delete tracksStat;
@@ -368,6 +570,10 @@ void VoxelsGrid::generateSpace(VoxelsGrid* vgnew, const Voxel& LU, const Voxel&
                               << "\t- RD: " << RD.x << " " << RD.y << " " << RD.z);
 
     int nvoxs = voxels->size() / 8;
+
+    // each voxel only reads its own tracks and redistributes them into vgnew,
+    // the writes into the shared container of vgnew are serialized internally
+#pragma omp parallel for schedule(dynamic)
     for(int voxid = 0; voxid < nvoxs; voxid++)
     {
         std::string folderName = getVoxelFolderName(voxid);
@@ -476,10 +682,7 @@ void VoxelsGrid::generateSpace(VoxelsGrid* vgnew, const Voxel& LU, const Voxel&
 
 void VoxelsGrid::cloneSpaceVoxel(int voxelId, int numSubVoxs, VoxelsGrid* newSpace)
 {
-    std::string folderName = getVoxelFolderName(voxelId);
-    std::string fileNameTracksPts = folderName + "tracksGridPts.bin";
-
-    if(mvsUtils::FileExists(fileNameTracksPts))
+    if(hasVoxelTracks(voxelId))
     {
         OctreeTracks* ott =
             new OctreeTracks(&(*voxels)[voxelId * 8], mp, Voxel(numSubVoxs, numSubVoxs, numSubVoxs));
@@ -506,13 +709,13 @@ VoxelsGrid* VoxelsGrid::cloneSpace(int numSubVoxs, std::string newSpaceRootDir)
 
     VoxelsGrid* out = clone(newSpaceRootDir);
 
-    long t1 = mvsUtils::initEstimate();
+    long t1 = clock();
+#pragma omp parallel for schedule(dynamic)
     for(int i = 0; i < voxels->size() / 8; i++)
     {
         cloneSpaceVoxel(i, numSubVoxs, out);
-        mvsUtils::printfEstimate(i, voxels->size() / 8, t1);
     }
-    mvsUtils::finishEstimate();
+    mvsUtils::printfElapsedTime(t1, "cloneSpace");
 
     if(doVisualize)
         out->vizualize();
@@ -522,10 +725,7 @@ VoxelsGrid* VoxelsGrid::cloneSpace(int numSubVoxs, std::string newSpaceRootDir)
 
 void VoxelsGrid::copySpaceVoxel(int voxelId, VoxelsGrid* newSpace)
 {
-    std::string folderName = getVoxelFolderName(voxelId);
-    std::string fileNameTracksPts = folderName + "tracksGridPts.bin";
-
-    if(mvsUtils::FileExists(fileNameTracksPts))
+    if(hasVoxelTracks(voxelId))
     {
         StaticVector<int>* tcams;
         StaticVector<OctreeTracks::trackStruct*>* tracksOld = loadTracksFromVoxelFiles(&tcams, voxelId);
@@ -547,13 +747,13 @@ VoxelsGrid* VoxelsGrid::copySpace(std::string newSpaceRootDir)
 
     VoxelsGrid* out = clone(newSpaceRootDir);
 
-    long t1 = mvsUtils::initEstimate();
+    long t1 = clock();
+#pragma omp parallel for schedule(dynamic)
     for(int i = 0; i < voxels->size() / 8; i++)
     {
         copySpaceVoxel(i, out);
-        mvsUtils::printfEstimate(i, voxels->size() / 8, t1);
     }
-    mvsUtils::finishEstimate();
+    mvsUtils::printfElapsedTime(t1, "copySpace");
 
     if(doVisualize)
         out->vizualize();
@@ -570,22 +770,28 @@ void VoxelsGrid::generateCamsPtsFromVoxelsTracks()
     int nvoxs = voxels->size() / 8;
     for(int i = 0; i < nvoxs; i++)
     {
-        std::string folderName = getVoxelFolderName(i);
-        std::string fileNameTracksCams, fileNameTracksPts,
-            fileNameTracksPtsCams;
-        fileNameTracksCams = folderName + "tracksGridCams.bin";
-        fileNameTracksPts = folderName + "tracksGridPts.bin";
-        fileNameTracksPtsCams = folderName + "tracksGridPtsCams.bin";
-
         // printf("SAVING %i-th VOXEL POINTS TO CAMS FILES\n",i);
 
-        if(mvsUtils::FileExists(fileNameTracksPts))
+        StaticVector<int>* cams = nullptr;
+        StaticVector<Point3d>* tracksPoints = nullptr;
+        StaticVector<Point3d>* tracksStat = nullptr;
+        StaticVector<StaticVector<Pixel>*>* tracksPointsCams = nullptr;
+
+        if(!readTracksFromContainer(i, &cams, &tracksPoints, &tracksStat, &tracksPointsCams))
         {
-            StaticVector<Point3d>* tracksPoints = loadArrayFromFile<Point3d>(fileNameTracksPts);
-            StaticVector<StaticVector<Pixel>*>* tracksPointsCams =
-                loadArrayOfArraysFromFile<Pixel>(fileNameTracksPtsCams);
-            StaticVector<int>* cams = loadArrayFromFile<int>(fileNameTracksCams);
+            // fallback to the legacy one-folder-per-voxel layout
+            const std::string folderName = getVoxelFolderName(i);
+            const std::string fileNameTracksPts = folderName + "tracksGridPts.bin";
+            if(mvsUtils::FileExists(fileNameTracksPts))
+            {
+                tracksPoints = loadArrayFromFile<Point3d>(fileNameTracksPts);
+                tracksPointsCams = loadArrayOfArraysFromFile<Pixel>(folderName + "tracksGridPtsCams.bin");
+                cams = loadArrayFromFile<int>(folderName + "tracksGridCams.bin");
+            }
+        }
 
+        if(cams != nullptr)
+        {
             // printf("distributing %i tracks to %i camspts files  \n", tracksPoints->size(), cams->size());
             StaticVector<StaticVector<Pixel>*>* camsTracksPoints =
                 convertObjectsCamsToCamsObjects(mp, tracksPointsCams);
@@ -615,6 +821,7 @@ void VoxelsGrid::generateCamsPtsFromVoxelsTracks()
 
             delete cams;
             delete tracksPoints;
+            delete tracksStat;
             deleteArrayOfArrays<Pixel>(&camsTracksPoints);
             deleteArrayOfArrays<Pixel>(&tracksPointsCams);
         }
@@ -12,12 +12,23 @@
 #include <aliceVision/mvsData/Voxel.hpp>
 #include <aliceVision/fuseCut/OctreeTracks.hpp>
 
+#include <map>
+
 namespace aliceVision {
 namespace fuseCut {
 
 class VoxelsGrid
 {
 public:
+    /// location of the tracks of one voxel in the packed container file,
+    /// see saveTracksToVoxelFiles
+    struct TracksIndexEntry
+    {
+        int voxelId;
+        int ntracks;
+        long offset;
+    };
+
     mvsUtils::MultiViewParams* mp;
 
     Voxel voxelDim;
@@ -27,6 +38,13 @@ public:
     std::string spaceCamsTracksDir;
     bool doVisualize;
 
+    /// the tracks of all voxels of the space are packed into a single
+    /// container file plus an index file instead of four files per voxel,
+    /// which keeps the filesystem metadata load independent of the grid
+    /// resolution; old per-voxel files are still readable as a fallback
+    mutable std::map<int, TracksIndexEntry> tracksIndex;
+    mutable bool tracksIndexLoaded = false;
+
     VoxelsGrid();
     VoxelsGrid(const Voxel& dimensions, Point3d* _space, mvsUtils::MultiViewParams* _mp, const std::string& _spaceRootDir, bool _doVisualize = false);
     ~VoxelsGrid();
@@ -34,6 +52,13 @@ public:
     VoxelsGrid* clone(const std::string& _spaceRootDir);
 
     std::string getVoxelFolderName(int id) const;
+    std::string getTracksContainerName() const;
+    std::string getTracksIndexName() const;
+    void loadTracksIndex() const; // only call from inside the voxelsGridPackedTracks critical section
+    bool hasVoxelTracks(int id) const;
+    bool readTracksFromContainer(int id, StaticVector<int>** cams, StaticVector<Point3d>** tracksPoints,
+                                 StaticVector<Point3d>** tracksStat,
+                                 StaticVector<StaticVector<Pixel>*>** tracksPointsCams) const;
     Voxel getVoxelForId(int id) const;
     int getIdForVoxel(const Voxel& v) const;
     StaticVector<int>* getNVoxelsTracks();
@@ -11,12 +11,130 @@
 #include <aliceVision/types.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/graph/graph.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
+#include <algorithm>
+#include <numeric>
 #include <set>
+#include <vector>
 
 namespace aliceVision {
 namespace graph {
 
+/**
+ * @brief Connected components of a graph given as a flat edge array,
+ * computed with a union-find forest.
+ *
+ * Each thread merges a slice of the edges into a local forest and the local
+ * forests are reduced into the shared one, the same scheme as the tracks
+ * fusion. The components are then relabeled contiguously, so the component
+ * of a node and the size of a component are O(1) lookups with no per
+ * component container built.
+ */
+class FlatConnectedComponents
+{
+public:
+  /**
+   * @param[in] nbNodes number of nodes, the edges link nodes in [0, nbNodes)
+   * @param[in] edges the edges of the graph
+   */
+  FlatConnectedComponents(const std::size_t nbNodes, const std::vector<Pair>& edges)
+    : _componentIds(nbNodes, 0)
+  {
+    std::vector<IndexT> parent(nbNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    #pragma omp parallel
+    {
+      std::vector<IndexT> threadParent(nbNodes);
+      std::iota(threadParent.begin(), threadParent.end(), 0);
+
+      #pragma omp for schedule(static)
+      for(long e = 0; e < static_cast<long>(edges.size()); ++e)
+        join(threadParent, edges[e].first, edges[e].second);
+
+      // merge the thread forest into the shared one
+      #pragma omp critical
+      {
+        for(std::size_t i = 0; i < nbNodes; ++i)
+        {
+          const IndexT root = find(threadParent, i);
+          if(root != i)
+            join(parent, i, root);
+        }
+      }
+    }
+
+    // relabel the components contiguously and count their nodes
+    std::vector<IndexT> rootToComponent(nbNodes, UndefinedIndexT);
+    for(std::size_t i = 0; i < nbNodes; ++i)
+    {
+      const IndexT root = find(parent, i);
+      if(rootToComponent[root] == UndefinedIndexT)
+      {
+        rootToComponent[root] = _componentSizes.size();
+        _componentSizes.push_back(0);
+      }
+      _componentIds[i] = rootToComponent[root];
+      ++_componentSizes[_componentIds[i]];
+    }
+
+    if(!_componentSizes.empty())
+      _largestComponent = std::distance(_componentSizes.begin(), std::max_element(_componentSizes.begin(), _componentSizes.end()));
+  }
+
+  /// Number of connected components
+  std::size_t nbComponents() const
+  {
+    return _componentSizes.size();
+  }
+
+  /// Component id of one node, component ids are contiguous in [0, nbComponents)
+  IndexT componentOf(std::size_t node) const
+  {
+    return _componentIds[node];
+  }
+
+  /// Number of nodes of each component
+  const std::vector<std::size_t>& componentSizes() const
+  {
+    return _componentSizes;
+  }
+
+  /// Component id of the component with the most nodes, UndefinedIndexT if the graph is empty
+  IndexT largestComponent() const
+  {
+    return _largestComponent;
+  }
+
+private:
+  /// Root of one node, with path halving
+  static IndexT find(std::vector<IndexT>& parent, IndexT i)
+  {
+    while(parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
+
+  /// Merge the components of two nodes
+  static void join(std::vector<IndexT>& parent, IndexT a, IndexT b)
+  {
+    a = find(parent, a);
+    b = find(parent, b);
+    if(a != b)
+      parent[std::max(a, b)] = std::min(a, b);
+  }
+
+  /// component id per node
+  std::vector<IndexT> _componentIds;
+  /// number of nodes per component
+  std::vector<std::size_t> _componentSizes;
+  IndexT _largestComponent = UndefinedIndexT;
+};
+
 /// Export node of each CC (Connected Component) in a map
 template <typename GraphT, typename IndexT>
 std::map<IndexT, std::set<lemon::ListGraph::Node> >  exportGraphToMapSubgraphs(
@@ -80,46 +198,34 @@ std::set<IndexT> CleanGraph_KeepLargestBiEdge_Nodes(
     // - list all CC size
     // - if the largest one is meet, keep all the edges that belong to this node
 
-    const std::map<IndexT, std::set<Graph::Node> > map_subgraphs = exportGraphToMapSubgraphs<Graph,IndexT>(putativeGraph.g);
-    size_t count = std::numeric_limits<size_t>::min();
-    typename std::map<IndexT, std::set<Graph::Node> >::const_iterator iterLargestCC = map_subgraphs.end();
-    for(typename std::map<IndexT, std::set<Graph::Node> >::const_iterator iter = map_subgraphs.begin();
-        iter != map_subgraphs.end(); ++iter)
-    {
-      if (iter->second.size() > count)  {
-        count = iter->second.size();
-        iterLargestCC = iter;
-      }
-      ALICEVISION_LOG_DEBUG("Connected component of size: " << iter->second.size());
-    }
+    // Compute the components over the remaining edges with the flat
+    // union-find instead of a lemon traversal: the per component std::set
+    // bookkeeping dominated this step at large scale
+    std::vector<Pair> flatEdges;
+    for (Graph::EdgeIt e(putativeGraph.g); e != lemon::INVALID; ++e)
+      flatEdges.emplace_back(putativeGraph.g.id(putativeGraph.g.u(e)), putativeGraph.g.id(putativeGraph.g.v(e)));
+
+    const graph::FlatConnectedComponents components(putativeGraph.g.maxNodeId() + 1, flatEdges);
+
+    for (std::size_t i = 0; i < components.nbComponents(); ++i)
+      ALICEVISION_LOG_DEBUG("Connected component of size: " << components.componentSizes()[i]);
 
     //-- Keep only the nodes that are in the largest CC
-    for(typename std::map<IndexT, std::set<lemon::ListGraph::Node> >::const_iterator iter = map_subgraphs.begin();
-        iter != map_subgraphs.end(); ++iter)
+    for (Graph::NodeIt n(putativeGraph.g); n != lemon::INVALID; ++n)
     {
-      if (iter == iterLargestCC)
+      if (components.componentOf(putativeGraph.g.id(n)) == components.largestComponent())
       {
-        // list all nodes that belong to the current CC and update the Node Ids list
-        const std::set<lemon::ListGraph::Node> & ccSet = iter->second;
-        for (std::set<lemon::ListGraph::Node>::const_iterator iter2 = ccSet.begin();
-          iter2 != ccSet.end(); ++iter2)
-        {
-          const IndexT Id = (*putativeGraph.map_nodeMapIndex)[*iter2];
-          largestBiEdgeCC.insert(Id);
-        }
+        // the node belongs to the largest CC, update the Node Ids list
+        const IndexT Id = (*putativeGraph.map_nodeMapIndex)[n];
+        largestBiEdgeCC.insert(Id);
       }
       else
       {
         // remove the edges from the graph
-        const std::set<lemon::ListGraph::Node> & ccSet = iter->second;
-        for (std::set<lemon::ListGraph::Node>::const_iterator iter2 = ccSet.begin();
-          iter2 != ccSet.end(); ++iter2)
+        typedef Graph::OutArcIt OutArcIt;
+        for (OutArcIt e(putativeGraph.g, n); e!=lemon::INVALID; ++e)
         {
-          typedef Graph::OutArcIt OutArcIt;
-          for (OutArcIt e(putativeGraph.g, *iter2); e!=lemon::INVALID; ++e)
-          {
-            putativeGraph.g.erase(e);
-          }
+          putativeGraph.g.erase(e);
         }
       }
     }
@@ -110,3 +110,44 @@ BOOST_AUTO_TEST_CASE(exportGraphToMapSubgraphs_CC_Subgraph) {
   BOOST_CHECK_EQUAL(2, map_subgraphs.at(2).size());
   BOOST_CHECK_EQUAL(1, map_subgraphs.at(3).size());
 }
+
+// Same component layout as exportGraphToMapSubgraphs_CC_Subgraph,
+// computed from the flat edge array
+BOOST_AUTO_TEST_CASE(FlatConnectedComponents_Subgraph) {
+  // single: 0
+  // two: 1-2
+  // four: 3-4-5-6-3
+  // five: 7-8-9-10, 8-11, 9-11
+  const std::vector<aliceVision::Pair> edges = {
+    {1,2},
+    {3,4}, {4,5}, {5,6}, {6,3},
+    {7,8}, {8,9}, {9,10}, {8,11}, {9,11}
+  };
+
+  const aliceVision::graph::FlatConnectedComponents components(12, edges);
+
+  BOOST_CHECK_EQUAL(4, components.nbComponents());
+  BOOST_CHECK_EQUAL(5, components.componentSizes().at(components.largestComponent()));
+  BOOST_CHECK_EQUAL(components.componentOf(7), components.largestComponent());
+
+  // each node of a component shares its component id
+  BOOST_CHECK_EQUAL(components.componentOf(1), components.componentOf(2));
+  BOOST_CHECK_EQUAL(components.componentOf(3), components.componentOf(6));
+  BOOST_CHECK_EQUAL(components.componentOf(8), components.componentOf(11));
+  BOOST_CHECK(components.componentOf(0) != components.componentOf(1));
+  BOOST_CHECK(components.componentOf(2) != components.componentOf(3));
+  BOOST_CHECK(components.componentOf(6) != components.componentOf(7));
+
+  // the component ids are contiguous and the sizes sum up to the nodes
+  std::size_t nbNodes = 0;
+  for(const std::size_t size : components.componentSizes())
+    nbNodes += size;
+  BOOST_CHECK_EQUAL(12, nbNodes);
+}
+
+BOOST_AUTO_TEST_CASE(FlatConnectedComponents_Empty) {
+  const aliceVision::graph::FlatConnectedComponents components(0, {});
+
+  BOOST_CHECK_EQUAL(0, components.nbComponents());
+  BOOST_CHECK_EQUAL(aliceVision::UndefinedIndexT, components.largestComponent());
+}
@@ -10,6 +10,8 @@
 #include "aliceVision/image/Image.hpp"
 #include "aliceVision/image/pixelTypes.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
+
 namespace aliceVision{
 namespace image {
 
@@ -64,6 +66,7 @@ void ConvertPixelType(const ImageIn& imaIn, ImageOut *imaOut)
 {
   (*imaOut) = ImageOut(imaIn.Width(), imaIn.Height());
   // Convert each input pixel to destination pixel
+#pragma omp parallel for
   for(int j = 0; j < imaIn.Height(); ++j)
     for(int i = 0; i < imaIn.Width(); ++i)
       Convert(imaIn(j,i), (*imaOut)(j,i));
@@ -90,11 +93,46 @@ void rgb2Float( const ImageIn& imaIn,
   assert( imaIn.Depth() == 3 );
   (*imaOut).resize(imaIn.Width(), imaIn.Height());
   // Convert each int RGB to float RGB values
+#pragma omp parallel for
   for( int j = 0; j < imaIn.Height(); ++j )
     for( int i = 0; i < imaIn.Width(); ++i )
       convertRGB2Float( imaIn( j, i ), ( *imaOut )( j, i ), factor );
 }
 
+/**
+ * @brief Fused one-pass conversion of a decoded RGB buffer to a normalized
+ * grayscale float image: the luminance and the scaling are applied in a
+ * single multi-threaded sweep instead of chaining two conversion passes.
+ */
+template< typename ImageIn >
+void rgb2GrayFloat( const ImageIn& imaIn,
+                    Image< float > *imaOut, float factor = 1.0f / 255.f )
+{
+  assert( imaIn.Depth() == 3 );
+  (*imaOut).resize(imaIn.Width(), imaIn.Height());
+#pragma omp parallel for
+  for( int j = 0; j < imaIn.Height(); ++j )
+    for( int i = 0; i < imaIn.Width(); ++i )
+    {
+      const auto& pixel = imaIn( j, i );
+      ( *imaOut )( j, i ) = Rgb2Gray( (float)pixel(0), (float)pixel(1), (float)pixel(2) ) * factor;
+    }
+}
+
+/**
+ * @brief Fused one-pass conversion of a normalized grayscale float image to
+ * an 8 bit grayscale image, multi-threaded over the rows.
+ */
+inline void grayFloat2grayUChar( const Image< float >& imaIn,
+                                 Image< unsigned char > *imaOut, float factor = 255.f )
+{
+  (*imaOut).resize(imaIn.Width(), imaIn.Height());
+#pragma omp parallel for
+  for( int j = 0; j < imaIn.Height(); ++j )
+    for( int i = 0; i < imaIn.Width(); ++i )
+      ( *imaOut )( j, i ) = static_cast<unsigned char>( imaIn( j, i ) * factor );
+}
+
 //--------------------------------------------------------------------------
 // Float to RGB ( unsigned char or int )
 //--------------------------------------------------------------------------
@@ -116,6 +154,7 @@ inline void rgbFloat2rgbInt(
   assert( imaIn.Depth() == 3 );
   (*imaOut).resize(imaIn.Width(), imaIn.Height());
   // Convert each int RGB to float RGB values
+#pragma omp parallel for
   for( int j = 0; j < imaIn.Height(); ++j )
     for( int i = 0; i < imaIn.Width(); ++i )
       convertFloatToInt( imaIn( j, i ), (*imaOut)( j, i ), factor  );
@@ -7,9 +7,47 @@
 
 #include "convolution.hpp"
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
 namespace aliceVision {
 namespace image {
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+
+namespace optim_avx2{
+
+  // Convolve a padded line: out[i] = sum_k kernel[k] * in[i + k].
+  // All the taps are accumulated in a single pass over each 8-wide chunk,
+  // instead of one pass over the whole line per tap.
+  inline void convolveLine_avx2(const float* in, const float* kernel, int ksize, float* out, int size)
+  {
+    int i = 0;
+    for(; i + 8 <= size; i += 8)
+    {
+      __m256 acc = _mm256_setzero_ps();
+      for(int k = 0; k < ksize; ++k)
+      {
+        const __m256 src = _mm256_loadu_ps(in + i + k);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(kernel[k]), src));
+      }
+      _mm256_storeu_ps(out + i, acc);
+    }
+    //-- Process the last 0-7 values
+    for(; i < size; ++i)
+    {
+      float acc = 0.0f;
+      for(int k = 0; k < ksize; ++k)
+        acc += kernel[k] * in[i + k];
+      out[i] = acc;
+    }
+  }
+
+} // namespace optim_avx2
+
+#endif // ALICEVISION_HAVE_AVX2
+
 void SeparableConvolution2d(const RowMatrixXf& image,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y,
@@ -42,11 +80,48 @@ void SeparableConvolution2d(const RowMatrixXf& image,
   }
 
   // Applying the rest of the y filter.
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+  // Accumulate the sigma_y taps in a single pass over each 8-wide column
+  // chunk. Columns are processed in blocks, so that the sigma_y source row
+  // segments being combined stay resident in cache.
+  const int block_cols = 4096;
+  #pragma omp parallel for schedule(dynamic)
+  for (int row = half_sigma_y; row < image.rows() - half_sigma_y; row++)
+  {
+    const int cols = static_cast<int>(image.cols());
+    const float* src = image.data() + (row - half_sigma_y) * cols;
+    float* out_row = out->data() + row * cols;
+    for (int x_begin = 0; x_begin < cols; x_begin += block_cols)
+    {
+      const int x_end = std::min(cols, x_begin + block_cols);
+      int x = x_begin;
+      for (; x + 8 <= x_end; x += 8)
+      {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < sigma_y; ++k)
+        {
+          const __m256 src_row = _mm256_loadu_ps(src + k * cols + x);
+          acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(kernel_y(k)), src_row));
+        }
+        _mm256_storeu_ps(out_row + x, acc);
+      }
+      //-- Process the last 0-7 columns of the block
+      for (; x < x_end; ++x)
+      {
+        float acc = 0.0f;
+        for (int k = 0; k < sigma_y; ++k)
+          acc += kernel_y(k) * src[k * cols + x];
+        out_row[x] = acc;
+      }
+    }
+  }
+#else
   #pragma omp parallel for schedule(dynamic)
   for (int row = half_sigma_y; row < image.rows() - half_sigma_y; row++)
   {
     out->row(row) =  kernel_y * image.block(row - half_sigma_y, 0, sigma_y, out->cols());
   }
+#endif // ALICEVISION_HAVE_AVX2
 
   const int sigma_x = static_cast<int>(kernel_x.cols());
   const int half_sigma_x = static_cast<int>(kernel_x.cols() / 2);
@@ -68,12 +143,18 @@ void SeparableConvolution2d(const RowMatrixXf& image,
       .segment(image.cols() - 2 - half_sigma_x, half_sigma_x)
       .reverse();
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+    // Convolve the padded row with all the taps in a single pass.
+    optim_avx2::convolveLine_avx2(temp_row.data(), kernel_x.data(), sigma_x,
+                                  out->data() + row * out->cols(), static_cast<int>(image.cols()));
+#else
     // Convolve the row. We perform the first step here explicitly so that we
     // avoid setting the row equal to zero.
     out->row(row) = kernel_x(0) * temp_row.head(image.cols());
     for (int i = 1; i < sigma_x; i++) {
       out->row(row) += kernel_x(i) * temp_row.segment(i, image.cols());
     }
+#endif // ALICEVISION_HAVE_AVX2
   }
 }
 
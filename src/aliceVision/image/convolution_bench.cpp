@@ -0,0 +1,75 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/image/all.hpp>
+#include <aliceVision/system/Benchmark.hpp>
+
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::image;
+
+// a synthetic grayscale image of typical pyramid level size
+static const int IMAGE_WIDTH = 1024;
+static const int IMAGE_HEIGHT = 768;
+
+const Image<float>& inputImage()
+{
+  static Image<float> image;
+  if(image.Width() == 0)
+  {
+    std::mt19937 randomEngine(42);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    image.resize(IMAGE_WIDTH, IMAGE_HEIGHT);
+    for(int y = 0; y < IMAGE_HEIGHT; ++y)
+      for(int x = 0; x < IMAGE_WIDTH; ++x)
+        image(y, x) = distribution(randomEngine);
+  }
+  return image;
+}
+
+void convolution_gaussianFilter(std::size_t nbIterations)
+{
+  const Image<float>& image = inputImage();
+  Image<float> out;
+  for(std::size_t i = 0; i < nbIterations; ++i)
+  {
+    ImageGaussianFilter(image, 1.6, out);
+    system::benchmarkDoNotOptimize(out(0, 0));
+  }
+}
+
+void convolution_separable5x5(std::size_t nbIterations)
+{
+  const Image<float>& image = inputImage();
+  Vec kernel(5);
+  kernel << 1.0, 4.0, 6.0, 4.0, 1.0;
+  kernel /= kernel.sum();
+
+  Image<float> out;
+  for(std::size_t i = 0; i < nbIterations; ++i)
+  {
+    ImageSeparableConvolution(image, kernel, kernel, out);
+    system::benchmarkDoNotOptimize(out(0, 0));
+  }
+}
+
+void resampling_halfSample(std::size_t nbIterations)
+{
+  const Image<float>& image = inputImage();
+  Image<float> out;
+  for(std::size_t i = 0; i < nbIterations; ++i)
+  {
+    ImageHalfSample(image, out);
+    system::benchmarkDoNotOptimize(out(0, 0));
+  }
+}
+
+ALICEVISION_BENCHMARK(convolution_gaussianFilter)
+ALICEVISION_BENCHMARK(convolution_separable5x5)
+ALICEVISION_BENCHMARK(resampling_halfSample)
+
+ALICEVISION_BENCHMARK_MAIN()
@@ -231,7 +231,13 @@ void ImageFEDCycle( Image & self , const Image & diff , const std::vector< typen
   for( int i = 0 ; i < tau.size() ; ++i )
   {
     ImageFED( self , diff , tau[i] , tmp ) ;
-    self.array() += tmp.array();
+
+    // accumulate the FED step in parallel, row by row
+    #pragma omp parallel for
+    for( int r = 0 ; r < static_cast<int>( self.rows() ) ; ++r )
+    {
+      self.row( r ) += tmp.row( r ) ;
+    }
   }
 }
 
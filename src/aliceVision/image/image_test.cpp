@@ -86,3 +86,22 @@ BOOST_AUTO_TEST_CASE(Image_ImageConverter)
   imaColorRGBA.fill(RGBAColor(10,10,10, 255));
   ConvertPixelType(imaColorRGBA, &imaGray);
 }
+
+BOOST_AUTO_TEST_CASE(Image_FusedGrayConverter)
+{
+  Image<RGBColor> imaColorRGB(5,5);
+  imaColorRGB.fill(RGBColor(10,20,30));
+
+  // fused rgb -> normalized gray float
+  Image<float> imaGrayFloat;
+  rgb2GrayFloat(imaColorRGB, &imaGrayFloat);
+  const float expected = Rgb2Gray(10.f, 20.f, 30.f) / 255.f;
+  BOOST_CHECK_EQUAL(5, imaGrayFloat.Width());
+  BOOST_CHECK_EQUAL(5, imaGrayFloat.Height());
+  BOOST_CHECK_SMALL(imaGrayFloat(2,2) - expected, 1e-6f);
+
+  // fused gray float -> 8 bit gray
+  Image<unsigned char> imaGrayUChar;
+  grayFloat2grayUChar(imaGrayFloat, &imaGrayUChar);
+  BOOST_CHECK_EQUAL(static_cast<unsigned char>(expected * 255.f), imaGrayUChar(2,2));
+}
@@ -11,6 +11,7 @@
 #include <OpenImageIO/imageio.h>
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/imagecache.h>
 
 #include <OpenEXR/half.h>
 
@@ -26,6 +27,26 @@ namespace fs = boost::filesystem;
 namespace aliceVision {
 namespace image {
 
+namespace {
+
+/**
+ * @brief Process-wide OpenImageIO ImageCache backing readImageWindow,
+ * created on first use. The shared instance is also reused by the OIIO
+ * ImageBuf machinery of the other read functions.
+ */
+oiio::ImageCache* getImageCache()
+{
+  static oiio::ImageCache* cache = []() {
+    oiio::ImageCache* c = oiio::ImageCache::create(true); // shared
+    c->attribute("max_memory_MB", 1024.0f);
+    c->attribute("autotile", 64); // serve scanline formats by tiles too, so windows stay cheap
+    return c;
+  }();
+  return cache;
+}
+
+} // namespace
+
 std::string EImageFileType_informations()
 {
   return "Image file type :\n"
@@ -207,6 +228,36 @@ void writeImage(const std::string& path,
   fs::rename(tmpPath, path);
 }
 
+template<typename T>
+void readImageWindow(const std::string& path, oiio::TypeDesc format, int nchannels,
+                     int xBegin, int yBegin, int winWidth, int winHeight, Image<T>& image)
+{
+  oiio::ImageCache* cache = getImageCache();
+  const oiio::ustring uPath(path);
+
+  oiio::ImageSpec spec;
+  if(!cache->get_imagespec(uPath, spec))
+    throw std::runtime_error("Can't find/open image file '" + path + "'.");
+
+  if(xBegin < 0 || yBegin < 0 || winWidth <= 0 || winHeight <= 0 ||
+     xBegin + winWidth > spec.width || yBegin + winHeight > spec.height)
+    throw std::runtime_error("Invalid window requested from image file '" + path + "'.");
+
+  image.resize(winWidth, winHeight, false);
+
+  if(!cache->get_pixels(uPath, 0, 0,
+                        xBegin, xBegin + winWidth,
+                        yBegin, yBegin + winHeight,
+                        0, 1, 0, nchannels,
+                        format, image.data()))
+    throw std::runtime_error("Can't read image window from file '" + path + "': " + cache->geterror());
+}
+
+void setImageCacheMemory(float maxMemoryMB)
+{
+  getImageCache()->attribute("max_memory_MB", maxMemoryMB);
+}
+
 void readImage(const std::string& path, Image<float>& image)
 {
   readImage(path, oiio::TypeDesc::FLOAT, 1, image);
@@ -232,6 +283,31 @@ void readImage(const std::string& path, Image<RGBColor>& image)
   readImage(path, oiio::TypeDesc::UINT8, 3, image);
 }
 
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<float>& image)
+{
+  readImageWindow(path, oiio::TypeDesc::FLOAT, 1, xBegin, yBegin, winWidth, winHeight, image);
+}
+
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<unsigned char>& image)
+{
+  readImageWindow(path, oiio::TypeDesc::UINT8, 1, xBegin, yBegin, winWidth, winHeight, image);
+}
+
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<RGBAColor>& image)
+{
+  readImageWindow(path, oiio::TypeDesc::UINT8, 4, xBegin, yBegin, winWidth, winHeight, image);
+}
+
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<RGBfColor>& image)
+{
+  readImageWindow(path, oiio::TypeDesc::FLOAT, 3, xBegin, yBegin, winWidth, winHeight, image);
+}
+
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<RGBColor>& image)
+{
+  readImageWindow(path, oiio::TypeDesc::UINT8, 3, xBegin, yBegin, winWidth, winHeight, image);
+}
+
 void writeImage(const std::string& path, const Image<unsigned char>& image, const oiio::ParamValueList& metadata)
 {
   writeImage(path, oiio::TypeDesc::UINT8, 1, image, metadata);
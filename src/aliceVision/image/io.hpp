@@ -86,6 +86,32 @@ void readImage(const std::string& path, Image<RGBAColor>& image);
 void readImage(const std::string& path, Image<RGBfColor>& image);
 void readImage(const std::string& path, Image<RGBColor>& image);
 
+/**
+ * @brief set the memory budget (in MB) of the process-wide OpenImageIO ImageCache
+ * backing readImageWindow (1024 MB until changed)
+ * @param[in] maxMemoryMB The tile cache capacity in megabytes
+ */
+void setImageCacheMemory(float maxMemoryMB);
+
+/**
+ * @brief read a rectangular window of an image through a process-wide tile cache:
+ * repeated reads of the same file (track colorization, visualization exports, ...)
+ * reuse the cached tiles instead of reopening and re-decoding the file each time.
+ * Unlike readImage, the first channels are read as stored without grayscale or
+ * colorspace conversion.
+ * @param[in] path The given path to the image
+ * @param[in] xBegin The x coordinate of the top-left corner of the window
+ * @param[in] yBegin The y coordinate of the top-left corner of the window
+ * @param[in] winWidth The window width
+ * @param[in] winHeight The window height
+ * @param[out] image The output image buffer, resized to the window
+ */
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<float>& image);
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<unsigned char>& image);
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<RGBAColor>& image);
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<RGBfColor>& image);
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, Image<RGBColor>& image);
+
 /**
  * @brief write an image with a given path and buffer
  * @param[in] path The given path to the image
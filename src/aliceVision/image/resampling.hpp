@@ -25,14 +25,16 @@ namespace image {
 
     out.resize( new_width , new_height ) ;
 
-    const Sampler2d<SamplerLinear> sampler;
-
+    // With the .5f offset the sampling positions are exactly ( 2i+1 , 2j+1 ) :
+    // the bilinear weights degenerate to ( 1 , 0 ) and the generic sampler reduces
+    // to picking every odd row/column pixel. Do that directly, row by row, so the
+    // half sampling is a memory-bound strided copy instead of per-pixel weighting.
+    #pragma omp parallel for
     for( int i = 0 ; i < new_height ; ++i )
     {
       for( int j = 0 ; j < new_width ; ++j )
       {
-        // Use .5f offset to ensure mid pixel and correct bilinear sampling
-        out( i , j ) =  sampler( src, 2.f * (i+.5f), 2.f * (j+.5f) );
+        out( i , j ) = src( 2 * i + 1 , 2 * j + 1 ) ;
       }
     }
   }
@@ -59,14 +61,15 @@ namespace image {
 
     out.resize( output_width , output_height );
 
-    std::vector< std::pair< float , float > >::const_iterator it_pos = sampling_pos.begin();
-
+    // every output pixel only depends on its own sampling position, process rows in parallel
+    #pragma omp parallel for
     for( int i = 0 ; i < output_height ; ++i )
     {
-      for( int j = 0 ; j < output_width ; ++j , ++it_pos )
+      for( int j = 0 ; j < output_width ; ++j )
       {
-        const float input_x = it_pos->second ;
-        const float input_y = it_pos->first ;
+        const std::pair< float , float > & pos = sampling_pos[ i * output_width + j ] ;
+        const float input_x = pos.second ;
+        const float input_y = pos.first ;
 
         out( i , j ) = sampling_func( src , input_y , input_x ) ;
       }
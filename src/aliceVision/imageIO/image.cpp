@@ -17,8 +17,15 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 #include <memory>
+#include <thread>
 
 namespace fs = boost::filesystem;
 
@@ -211,6 +218,86 @@ void readImage(const std::string& path, int& width, int& height, std::vector<Col
     readImage(path, oiio::TypeDesc::FLOAT, 3, width, height, buffer);
 }
 
+template<typename T>
+void readImageWindow(const std::string& path,
+                     oiio::TypeDesc typeDesc,
+                     int nchannels,
+                     int xBegin,
+                     int yBegin,
+                     int winWidth,
+                     int winHeight,
+                     std::vector<T>& buffer)
+{
+    ALICEVISION_LOG_DEBUG("[IO] Read Image Window: " << path << std::endl
+      << "\t- x: " << xBegin << std::endl
+      << "\t- y: " << yBegin << std::endl
+      << "\t- width: " << winWidth << std::endl
+      << "\t- height: " << winHeight);
+
+    oiio::ImageBuf inBuf(path);
+
+    if(!inBuf.initialized())
+        throw std::runtime_error("Can't find/open image file '" + path + "'.");
+
+    const oiio::ImageSpec& inSpec = inBuf.spec();
+
+    if(xBegin < 0 || yBegin < 0 || winWidth <= 0 || winHeight <= 0 ||
+       xBegin + winWidth > inSpec.width || yBegin + winHeight > inSpec.height)
+        throw std::runtime_error("Invalid window requested from image file '" + path + "'.");
+
+    buffer.resize(winWidth * winHeight * nchannels);
+
+    const oiio::ROI exportROI(xBegin, xBegin + winWidth, yBegin, yBegin + winHeight, 0, 1, 0, nchannels);
+    inBuf.get_pixels(exportROI, typeDesc, buffer.data());
+}
+
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, std::vector<float>& buffer)
+{
+    readImageWindow(path, oiio::TypeDesc::FLOAT, 1, xBegin, yBegin, winWidth, winHeight, buffer);
+}
+
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, std::vector<Color>& buffer)
+{
+    readImageWindow(path, oiio::TypeDesc::FLOAT, 3, xBegin, yBegin, winWidth, winHeight, buffer);
+}
+
+void readImageTransposed(const std::string& path, int width, int height, Color* buffer)
+{
+    ALICEVISION_LOG_DEBUG("[IO] Read Image Transposed: " << path);
+
+    oiio::ImageBuf inBuf(path);
+
+    if(!inBuf.initialized())
+        throw std::runtime_error("Can't find/open image file '" + path + "'.");
+
+    const oiio::ImageSpec& inSpec = inBuf.spec();
+
+    if(inSpec.width != width || inSpec.height != height)
+    {
+        std::stringstream s;
+        s << "Bad dimension for image file '" << path << "':\n";
+        s << "\t- expected dimension: " << width << "x" << height << "\n";
+        s << "\t- real dimension: " << inSpec.width << "x" << inSpec.height << "\n";
+        throw std::runtime_error(s.str());
+    }
+
+    // stream the image by blocks of rows and scatter them into the column-major
+    // destination, so only a small block is ever duplicated in memory
+    const int blockHeight = 64;
+    std::vector<Color> block(static_cast<std::size_t>(width) * blockHeight);
+
+    for(int yBegin = 0; yBegin < height; yBegin += blockHeight)
+    {
+        const int nbRows = std::min(blockHeight, height - yBegin);
+        const oiio::ROI blockROI(0, width, yBegin, yBegin + nbRows, 0, 1, 0, 3);
+        inBuf.get_pixels(blockROI, oiio::TypeDesc::FLOAT, block.data());
+
+        for(int y = 0; y < nbRows; ++y)
+            for(int x = 0; x < width; ++x)
+                buffer[x * height + (yBegin + y)] = block.at(y * width + x);
+    }
+}
+
 template<typename T>
 void writeImage(const std::string& path,
                 oiio::TypeDesc typeDesc,
@@ -237,6 +324,9 @@ void writeImage(const std::string& path,
     if(isEXR)
     {
         imageSpec.attribute("compression", "piz");   // if possible, PIZ compression for openEXR
+        // tiled layout, so that readImageWindow() only decodes the tiles it needs
+        imageSpec.tile_width = 64;
+        imageSpec.tile_height = 64;
     }
     else
     {
@@ -296,6 +386,143 @@ void writeImage(const std::string& path, int width, int height, const std::vecto
     writeImage(path, oiio::TypeDesc::FLOAT, width, height, 3, buffer, imageQuality, metadata);
 }
 
+namespace {
+
+/**
+ * @brief Background encode pool shared by all writeImageAsync() calls.
+ * A few worker threads pull staged images from a bounded queue and run the regular
+ * writeImage() on them, so compute threads do not block on compression. The queue
+ * bound keeps the staged images from piling up in memory: submit() blocks instead.
+ */
+class ImageWritePool
+{
+public:
+    static ImageWritePool& get()
+    {
+        static ImageWritePool pool;
+        return pool;
+    }
+
+    void submit(std::function<void()> job)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this]{ return _jobs.size() < maxPendingJobs; });
+        _jobs.push_back(std::move(job));
+        _notEmpty.notify_one();
+    }
+
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this]{ return _jobs.empty() && (_nbRunning == 0); });
+        if(_error != nullptr)
+        {
+            std::exception_ptr error = _error;
+            _error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    ImageWritePool()
+    {
+        // let openEXR spread the compression of a single file over the machine
+        oiio::attribute("exr_threads", 0);
+
+        const unsigned int nbThreads = std::max(2u, std::thread::hardware_concurrency() / 4);
+        for(unsigned int i = 0; i < nbThreads; ++i)
+            _threads.emplace_back(&ImageWritePool::run, this);
+    }
+
+    ~ImageWritePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _notEmpty.notify_all();
+        for(std::thread& thread : _threads)
+            thread.join();
+    }
+
+    void run()
+    {
+        for(;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _notEmpty.wait(lock, [this]{ return _stop || !_jobs.empty(); });
+                if(_jobs.empty())
+                    return; // stopped and drained
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+                ++_nbRunning;
+                _notFull.notify_one();
+            }
+
+            try
+            {
+                job();
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(_error == nullptr)
+                    _error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_nbRunning;
+                if(_jobs.empty() && (_nbRunning == 0))
+                    _idle.notify_all();
+            }
+        }
+    }
+
+    static const std::size_t maxPendingJobs = 4;
+
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::condition_variable _idle;
+    std::deque<std::function<void()>> _jobs;
+    std::vector<std::thread> _threads;
+    std::size_t _nbRunning = 0;
+    bool _stop = false;
+    std::exception_ptr _error = nullptr;
+};
+
+} // namespace
+
+template<typename T>
+void writeImageAsyncT(const std::string& path, int width, int height, std::vector<T>&& buffer, EImageQuality imageQuality, const oiio::ParamValueList& metadata)
+{
+    // stage the buffer in a shared_ptr, so the lambda stays copyable (the buffer is not copied)
+    std::shared_ptr<std::vector<T>> staged = std::make_shared<std::vector<T>>(std::move(buffer));
+
+    ImageWritePool::get().submit([path, width, height, staged, imageQuality, metadata]()
+    {
+        writeImage(path, width, height, *staged, imageQuality, metadata);
+    });
+}
+
+void writeImageAsync(const std::string& path, int width, int height, std::vector<float>&& buffer, EImageQuality imageQuality, const oiio::ParamValueList& metadata)
+{
+    writeImageAsyncT(path, width, height, std::move(buffer), imageQuality, metadata);
+}
+
+void writeImageAsync(const std::string& path, int width, int height, std::vector<Color>&& buffer, EImageQuality imageQuality, const oiio::ParamValueList& metadata)
+{
+    writeImageAsyncT(path, width, height, std::move(buffer), imageQuality, metadata);
+}
+
+void flushImageWrites()
+{
+    ImageWritePool::get().flush();
+}
+
 template<typename T>
 void transposeImage(oiio::TypeDesc typeDesc,
                     int width,
@@ -101,6 +101,51 @@ void readImage(const std::string& path, int& width, int& height, std::vector<rgb
 void readImage(const std::string& path, int& width, int& height, std::vector<float>& buffer);
 void readImage(const std::string& path, int& width, int& height, std::vector<Color>& buffer);
 
+/**
+ * @brief read a window of an image with a given path
+ * Only the tiles overlapping the window are decoded from tiled files (see writeImage),
+ * scanline files are supported too but more data than requested may be read.
+ * @param[in] path The given path to the image
+ * @param[in] xBegin The x coordinate of the upper-left corner of the window
+ * @param[in] yBegin The y coordinate of the upper-left corner of the window
+ * @param[in] winWidth The window width, the window must fit inside the image
+ * @param[in] winHeight The window height, the window must fit inside the image
+ * @param[out] buffer The output image window buffer
+ */
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, std::vector<float>& buffer);
+void readImageWindow(const std::string& path, int xBegin, int yBegin, int winWidth, int winHeight, std::vector<Color>& buffer);
+
+/**
+ * @brief read an image directly into a column-major buffer (buffer[x * height + y])
+ * The image is streamed by blocks of rows and scattered into the destination,
+ * so only a small block is ever held in memory next to the destination buffer.
+ * @param[in] path The given path to the image
+ * @param[in] width The expected image width, reading fails if the file differs
+ * @param[in] height The expected image height, reading fails if the file differs
+ * @param[out] buffer The destination buffer, must hold width * height pixels
+ */
+void readImageTransposed(const std::string& path, int width, int height, Color* buffer);
+
+/**
+ * @brief write an image from a background encode thread
+ * The buffer is taken over by the writer and the call returns as soon as the image
+ * is staged, so the compute thread does not block on compression. The staging queue
+ * is bounded: when too many writes are pending the call blocks until a slot frees up.
+ * Call flushImageWrites() before reading the written files back or exiting.
+ * @param[in] path The given path to the image
+ * @param[in] width The input image width
+ * @param[in] height The input image height
+ * @param[in] buffer The input image buffer, taken over by the writer
+ */
+void writeImageAsync(const std::string& path, int width, int height, std::vector<float>&& buffer, EImageQuality imageQuality = EImageQuality::OPTIMIZED, const oiio::ParamValueList& metadata = oiio::ParamValueList());
+void writeImageAsync(const std::string& path, int width, int height, std::vector<Color>&& buffer, EImageQuality imageQuality = EImageQuality::OPTIMIZED, const oiio::ParamValueList& metadata = oiio::ParamValueList());
+
+/**
+ * @brief wait until every image submitted to writeImageAsync has been written
+ * Rethrows the first write error, if any.
+ */
+void flushImageWrites();
+
 /**
  * @brief write an image with a given path and buffer
  * @param[in] path The given path to the image
@@ -9,12 +9,14 @@
 #include <aliceVision/sensorDB/parseDatabase.hpp>
 #include <aliceVision/feature/sift/ImageDescriber_SIFT.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/filesystem.hpp>
 
 #include <random>
 #include <tuple>
 #include <cassert>
+#include <cmath>
 #include <cstdlib>
 
 namespace fs = boost::filesystem;
@@ -170,52 +172,85 @@ void KeyframeSelector::process()
   // iteration process
   _keyframeIndexes.clear();
   std::size_t currentFrameStep = _minFrameStep + 1; // start directly (dont skip minFrameStep first frames)
-  
+
+  // decoded frames of the current evaluation window,
+  // one half resolution grayscale image per (frame, media)
+  std::vector< std::vector< image::Image<float> > > windowImages;
+
   for(std::size_t frameIndex = 0; frameIndex < _framesData.size(); ++frameIndex)
   {
-    ALICEVISION_LOG_INFO("frame : " << frameIndex);
-    bool frameSelected = true;
-    auto& frameData = _framesData.at(frameIndex);
-    frameData.mediasData.resize(_feeds.size());
-
-    for(std::size_t mediaIndex = 0; mediaIndex < _feeds.size(); ++mediaIndex)
+    // number of frames to evaluate before the next keyframe selection
+    const std::size_t windowSize = std::min(static_cast<std::size_t>(_maxFrameStep - currentFrameStep + 1),
+                                            _framesData.size() - frameIndex);
+
+    // decode the window frames sequentially,
+    // only the half resolution grayscale images are kept for scoring
+    windowImages.resize(windowSize);
+    for(std::size_t i = 0; i < windowSize; ++i)
     {
-      ALICEVISION_LOG_DEBUG("media : " << _mediaPaths.at(mediaIndex));
-      auto& feed = *_feeds.at(mediaIndex);
+      auto& mediaImages = windowImages.at(i);
+      mediaImages.resize(_feeds.size());
 
-      if(frameSelected) // false if a camera of a rig is not selected
+      for(std::size_t mediaIndex = 0; mediaIndex < _feeds.size(); ++mediaIndex)
       {
+        ALICEVISION_LOG_DEBUG("media : " << _mediaPaths.at(mediaIndex));
+        auto& feed = *_feeds.at(mediaIndex);
+
         if(!feed.readImage(image, queryIntrinsics, currentImgName, hasIntrinsics))
         {
           ALICEVISION_LOG_ERROR("Cannot read frame '" << currentImgName << "' !");
           throw std::invalid_argument("Cannot read frame '" + currentImgName + "' !");
         }
 
+        image::Image<float> imageGray;
+        image::ConvertPixelType(image, &imageGray);
+        image::ImageHalfSample(imageGray, mediaImages.at(mediaIndex));
+
+        feed.goToNextFrame();
+      }
+    }
+
+    // score the window frames in parallel,
+    // each frame only reads the keyframe history and the history only changes at selection time
+    #pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < static_cast<int>(windowSize); ++i)
+    {
+      bool frameSelected = true;
+      auto& frameData = _framesData.at(frameIndex + i);
+      frameData.mediasData.resize(_feeds.size());
+
+      for(std::size_t mediaIndex = 0; mediaIndex < _feeds.size(); ++mediaIndex)
+      {
         // compute sharpness and sparse distance
-        if(!computeFrameData(image, frameIndex, mediaIndex, tileSharpSubset))
+        if(!computeFrameData(windowImages.at(i).at(mediaIndex), frameIndex + i, mediaIndex, tileSharpSubset))
         {
           frameSelected = false;
+          break; // the other cameras of the rig are not scored
         }
       }
 
-      feed.goToNextFrame();
-    }
-
-    {
       if(frameSelected)
       {
-        ALICEVISION_LOG_INFO(" > selected" << std::endl);
         frameData.selected = true;
         if(_hasSharpnessSelection)
           frameData.computeAvgSharpness();
       }
       else
       {
-        ALICEVISION_LOG_INFO(" > skipped" << std::endl);
         frameData.mediasData.clear(); // remove unselected mediasData
       }
     }
 
+    for(std::size_t i = 0; i < windowSize; ++i)
+    {
+      ALICEVISION_LOG_INFO("frame : " << (frameIndex + i)
+                           << (_framesData.at(frameIndex + i).selected ? " > selected" : " > skipped") << std::endl);
+    }
+
+    // last evaluated frame of the window
+    frameIndex += windowSize - 1;
+    currentFrameStep += windowSize - 1;
+
     // selection process
     if(currentFrameStep >= _maxFrameStep)
     {
@@ -281,6 +316,11 @@ void KeyframeSelector::process()
         _keyframeIndexes.push_back(keyframeIndex);
 
         frameIndex = keyframeIndex + _minFrameStep - 1;
+
+        // the keyframe write moved the feeds back to the keyframe,
+        // reposition them on the next frame to evaluate
+        for(std::size_t mediaIndex = 0; mediaIndex < _feeds.size(); ++mediaIndex)
+          _feeds.at(mediaIndex)->goToFrame(frameIndex + 1 + _cameraInfos.at(mediaIndex).frameOffset);
       }
       else
       {
@@ -335,31 +375,54 @@ float KeyframeSelector::computeSharpness(const image::Image<float>& imageGray,
   image::ImageScharrXDerivative(imageGray, scharrXDer); // normalized
   image::ImageScharrYDerivative(imageGray, scharrYDer); // normalized
 
-  scharrXDer = scharrXDer.cwiseAbs(); // absolute value
-  scharrYDer = scharrYDer.cwiseAbs(); // absolute value
+  const std::size_t usedHeight = _nbTileSide * tileHeight;
+  const std::size_t usedWidth = _nbTileSide * tileWidth;
+
+  // summed-area table of the absolute derivatives, one extra zero row and
+  // column so the sum of any window is four lookups whatever its size
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> integral(usedHeight + 1, usedWidth + 1);
+  integral.row(0).setZero();
 
-  // image tiles
+  for(std::size_t y = 0; y < usedHeight; ++y)
+  {
+    double rowSum = 0.0;
+    integral(y + 1, 0) = 0.0;
+    for(std::size_t x = 0; x < usedWidth; ++x)
+    {
+      rowSum += std::abs(scharrXDer(y, x)) + std::abs(scharrYDer(y, x));
+      integral(y + 1, x + 1) = integral(y, x + 1) + rowSum;
+    }
+  }
+
+  // evaluate the tile windows densely with a half tile stride,
+  // overlapping windows catch sharp areas sitting across the tile grid
   std::vector<float> averageTileIntensity;
   const float tileSizeInv = 1 / static_cast<float>(tileHeight * tileWidth);
+  const std::size_t strideHeight = std::max(tileHeight / 2, 1u);
+  const std::size_t strideWidth = std::max(tileWidth / 2, 1u);
 
-  for(std::size_t y =  0; y < (_nbTileSide * tileHeight); y += tileHeight)
+  for(std::size_t y = 0; y + tileHeight <= usedHeight; y += strideHeight)
   {
-    for(std::size_t x =  0; x < (_nbTileSide * tileWidth); x += tileWidth)
+    for(std::size_t x = 0; x + tileWidth <= usedWidth; x += strideWidth)
     {
-      const auto sum = scharrXDer.block(y, x, tileHeight, tileWidth).sum() + scharrYDer.block(y, x, tileHeight, tileWidth).sum();
-      averageTileIntensity.push_back(sum * tileSizeInv);
+      const double sum = integral(y + tileHeight, x + tileWidth) - integral(y, x + tileWidth)
+                       - integral(y + tileHeight, x) + integral(y, x);
+      averageTileIntensity.push_back(static_cast<float>(sum) * tileSizeInv);
     }
   }
 
   // sort tiles average pixel intensity
   std::sort(averageTileIntensity.begin(), averageTileIntensity.end());
 
+  // keep the same sharp fraction as the non-overlapping tile grid
+  const std::size_t subsetSize = std::max<std::size_t>((averageTileIntensity.size() * tileSharpSubset) / (_nbTileSide * _nbTileSide), 1);
+
   // return the sum of the subset average pixel intensity
-  return std::accumulate(averageTileIntensity.end() - tileSharpSubset, averageTileIntensity.end(), 0.0f) / tileSharpSubset;
+  return std::accumulate(averageTileIntensity.end() - subsetSize, averageTileIntensity.end(), 0.0f) / subsetSize;
 }
 
 
-bool KeyframeSelector::computeFrameData(const image::Image<image::RGBColor>& image,
+bool KeyframeSelector::computeFrameData(const image::Image<float>& imageGrayHalfSample,
                                         std::size_t frameIndex,
                                         std::size_t mediaIndex,
                                         unsigned int tileSharpSubset)
@@ -367,17 +430,10 @@ bool KeyframeSelector::computeFrameData(const image::Image<image::RGBColor>& ima
   if(!_hasSharpnessSelection && !_hasSparseDistanceSelection)
     return true; // nothing to do
 
-  image::Image<float> imageGray;           // grayscale image
-  image::Image<float> imageGrayHalfSample; // half resolution grayscale image
-  
   const auto& currMediaInfo = _mediasInfo.at(mediaIndex);
   auto& currframeData = _framesData.at(frameIndex);
   auto& currMediaData = currframeData.mediasData.at(mediaIndex);
 
-  // get grayscale image and resize
-  image::ConvertPixelType(image, &imageGray);
-  image::ImageHalfSample(imageGray, imageGrayHalfSample);
-
   // compute sharpness
   if(_hasSharpnessSelection)
   {
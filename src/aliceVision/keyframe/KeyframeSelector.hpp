@@ -331,13 +331,13 @@ private:
 
   /**
    * @brief Compute sharpness and distance score for a given image
-   * @param[in] image an image of the media
+   * @param[in] imageGrayHalfSample a half resolution grayscale image of the media
    * @param[in] frameIndex the image index in the media sequence
    * @param[in] mediaIndex the media index
    * @param[in] tileSharpSubset number of sharp tiles
    * @return true if the frame is selected
    */
-  bool computeFrameData(const image::Image<image::RGBColor>& image,
+  bool computeFrameData(const image::Image<float>& imageGrayHalfSample,
                         std::size_t frameIndex,
                         std::size_t mediaIndex,
                         unsigned int tileSharpSubset);
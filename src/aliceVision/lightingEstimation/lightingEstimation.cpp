@@ -9,6 +9,7 @@
 
 #include <Eigen/Dense>
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -16,36 +17,72 @@ namespace aliceVision {
 namespace lightingEstimation {
 
 /**
- * @brief Evaluate albedo and normal product for one channel
+ * @brief Evaluate albedo and normal product for one channel over a tile of pixels
  */
-void albedoNormalsProduct(MatrixXf& rhoTimesN, const MatrixXf& albedoChannel, const image::Image<AugmentedNormal>& augmentedNormals)
+void albedoNormalsProduct(MatrixXf& rhoTimesN, const MatrixXf& albedoChannel, const image::Image<AugmentedNormal>& augmentedNormals, int pixelStart, int nbRows)
 {
-    for (int i = 0; i < augmentedNormals.size(); ++i)
+    for (int i = 0; i < nbRows; ++i)
     {
-        rhoTimesN(i, 0) = albedoChannel(i) * augmentedNormals(i).nx();
-        rhoTimesN(i, 1) = albedoChannel(i) * augmentedNormals(i).ny();
-        rhoTimesN(i, 2) = albedoChannel(i) * augmentedNormals(i).nz();
-        rhoTimesN(i, 3) = albedoChannel(i) * augmentedNormals(i).nambiant();
-        rhoTimesN(i, 4) = albedoChannel(i) * augmentedNormals(i).nx_ny();
-        rhoTimesN(i, 5) = albedoChannel(i) * augmentedNormals(i).nx_nz();
-        rhoTimesN(i, 6) = albedoChannel(i) * augmentedNormals(i).ny_nz();
-        rhoTimesN(i, 7) = albedoChannel(i) * augmentedNormals(i).nx2_ny2();
-        rhoTimesN(i, 8) = albedoChannel(i) * augmentedNormals(i).nz2();
+        const int p = pixelStart + i;
+        rhoTimesN(i, 0) = albedoChannel(p) * augmentedNormals(p).nx();
+        rhoTimesN(i, 1) = albedoChannel(p) * augmentedNormals(p).ny();
+        rhoTimesN(i, 2) = albedoChannel(p) * augmentedNormals(p).nz();
+        rhoTimesN(i, 3) = albedoChannel(p) * augmentedNormals(p).nambiant();
+        rhoTimesN(i, 4) = albedoChannel(p) * augmentedNormals(p).nx_ny();
+        rhoTimesN(i, 5) = albedoChannel(p) * augmentedNormals(p).nx_nz();
+        rhoTimesN(i, 6) = albedoChannel(p) * augmentedNormals(p).ny_nz();
+        rhoTimesN(i, 7) = albedoChannel(p) * augmentedNormals(p).nx2_ny2();
+        rhoTimesN(i, 8) = albedoChannel(p) * augmentedNormals(p).nz2();
     }
 }
 
 /**
  * @brief Resolve lighting estimation problem for one channel
  */
- 
+
 void estimateLigthingOneChannel(Eigen::Matrix<float, 9, 1>& lighting, const MatrixXf& albedoChannel, const MatrixXf& pictureChannel, const image::Image<AugmentedNormal>& augNormals)
 {
-    const auto nbPoints = augNormals.size();
+    const int nbPoints = augNormals.size();
+
+    // Accumulate the normal equations of the nbPoints x 9 least squares system
+    // instead of materializing and factorizing it: the accumulation is a single
+    // pass over the pixels, done by tiles so that each tile reduces to a small
+    // matrix product and the tiles spread over the threads.
+    const int tileSize = 4096;
+    const int nbTiles = (nbPoints + tileSize - 1) / tileSize;
+
+    Eigen::Matrix<double, 9, 9> normalMatrix = Eigen::Matrix<double, 9, 9>::Zero();
+    Eigen::Matrix<double, 9, 1> rhs = Eigen::Matrix<double, 9, 1>::Zero();
 
-    MatrixXf rhoTimesN(nbPoints, 9);
-    albedoNormalsProduct(rhoTimesN, albedoChannel, augNormals);
+    #pragma omp parallel
+    {
+        Eigen::Matrix<double, 9, 9> localNormalMatrix = Eigen::Matrix<double, 9, 9>::Zero();
+        Eigen::Matrix<double, 9, 1> localRhs = Eigen::Matrix<double, 9, 1>::Zero();
+        MatrixXf rhoTimesN(tileSize, 9);
+
+        #pragma omp for schedule(dynamic)
+        for (int t = 0; t < nbTiles; ++t)
+        {
+            const int tileStart = t * tileSize;
+            const int tileRows = std::min(tileSize, nbPoints - tileStart);
+
+            albedoNormalsProduct(rhoTimesN, albedoChannel, augNormals, tileStart, tileRows);
+
+            // the products are evaluated in double: the normal equations square
+            // the conditioning of the system
+            const Eigen::MatrixXd tile = rhoTimesN.topRows(tileRows).cast<double>();
+            localNormalMatrix += tile.transpose() * tile;
+            localRhs += tile.transpose() * pictureChannel.block(tileStart, 0, tileRows, 1).cast<double>();
+        }
+
+        #pragma omp critical
+        {
+            normalMatrix += localNormalMatrix;
+            rhs += localRhs;
+        }
+    }
 
-    lighting = rhoTimesN.colPivHouseholderQr().solve(pictureChannel);
+    lighting = normalMatrix.ldlt().solve(rhs).cast<float>();
 }
 
 void estimateLigthing(LightingVector& lighting, const image::Image<image::RGBfColor>& albedo, const image::Image<image::RGBfColor>& picture, const image::Image<image::RGBfColor>& normals)
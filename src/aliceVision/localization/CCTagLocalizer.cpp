@@ -18,6 +18,7 @@
 
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <cctag/ICCTag.hpp>
 
@@ -126,6 +127,26 @@ bool CCTagLocalizer::loadReconstructionDescriptors(const sfmData::SfMData & sfm_
     }
   }
 
+  ALICEVISION_LOG_DEBUG("Build the marker id indexes");
+
+  // Build once per view its marker visibility descriptor and the inverted
+  // marker id -> views index used by the keyframe retrieval
+  for(const auto& viewRegions : _regionsPerView.getData())
+  {
+    const IndexT id_view = viewRegions.first;
+    const auto itRegions = viewRegions.second.find(_cctagDescType);
+    if(itRegions == viewRegions.second.end())
+      continue;
+    const feature::CCTAG_Regions& cctagRegions = dynamic_cast<const feature::CCTAG_Regions&>(*itRegions->second);
+    const std::bitset<128> viewDescriptor = constructCCTagViewDescriptor(cctagRegions.Descriptors());
+    _cctagViewDescriptorPerView[id_view] = viewDescriptor;
+    for(std::size_t cctagId = 0; cctagId < viewDescriptor.size(); ++cctagId)
+    {
+      if(viewDescriptor.test(cctagId))
+        _viewsPerCCTagId[cctagId].push_back(id_view);
+    }
+  }
+
 
   {
     std::set<int> presentCCtagIds;
@@ -246,6 +267,40 @@ void CCTagLocalizer::setCudaPipe( int i )
     _cudaPipe = i;
 }
 
+void CCTagLocalizer::extractRegions(const std::vector<image::Image<float>> & vec_imageGrey,
+                                    const LocalizerParameters &param,
+                                    std::vector<feature::MapRegionsPerDesc> &out_queryRegions,
+                                    std::vector<std::pair<std::size_t, std::size_t>> &out_imageSize)
+{
+  const int nbFrames = static_cast<int>(vec_imageGrey.size());
+  out_queryRegions.resize(nbFrames);
+  out_imageSize.resize(nbFrames);
+
+  // the describer configuration is shared by all the frames, set it once before
+  // the detection loop
+  _imageDescriber.setCudaPipe(_cudaPipe);
+  _imageDescriber.setConfigurationPreset(param._featurePreset);
+
+  // a CUDA pipe cannot be fed from several threads at a time, only the CPU
+  // detection is run over the frames in parallel
+  const bool parallelDetection = !_imageDescriber.useCuda();
+
+  system::Timer timer;
+
+  #pragma omp parallel for if(parallelDetection)
+  for(int i = 0; i < nbFrames; ++i)
+  {
+    image::Image<unsigned char> imageGrayUChar; // cctag image describer don't support float image
+    imageGrayUChar = (vec_imageGrey.at(i).GetMat() * 255.f).cast<unsigned char>();
+
+    _imageDescriber.describe(imageGrayUChar, out_queryRegions.at(i)[_cctagDescType]);
+    out_imageSize.at(i) = std::make_pair(vec_imageGrey.at(i).Width(), vec_imageGrey.at(i).Height());
+  }
+
+  ALICEVISION_LOG_DEBUG("[features]\tExtract CCTAG done for " << nbFrames
+                        << " frame(s): " << timer.elapsedMs() << "ms");
+}
+
 bool CCTagLocalizer::localize(const feature::MapRegionsPerDesc & genQueryRegions,
                               const std::pair<std::size_t, std::size_t> &imageSize,
                               const LocalizerParameters *parameters,
@@ -382,6 +437,49 @@ bool CCTagLocalizer::localize(const feature::MapRegionsPerDesc & genQueryRegions
   
 }
 
+bool CCTagLocalizer::localizeBatch(const std::vector<image::Image<float>> & vec_imageGrey,
+                                   const LocalizerParameters *parameters,
+                                   bool useInputIntrinsics,
+                                   std::vector<camera::PinholeRadialK3> &vec_queryIntrinsics,
+                                   std::vector<LocalizationResult> &vec_locResults,
+                                   const std::vector<std::string> &vec_imagePath)
+{
+  const CCTagLocalizer::Parameters *param = dynamic_cast<const CCTagLocalizer::Parameters *>(parameters);
+  if(!param)
+  {
+    throw std::invalid_argument("The CCTag localizer parameters are not in the right format.");
+  }
+
+  const std::size_t nbFrames = vec_imageGrey.size();
+  assert(vec_queryIntrinsics.size() == nbFrames);
+  assert(vec_imagePath.empty() || vec_imagePath.size() == nbFrames);
+
+  // extract the markers from all the frames of the batch up front
+  std::vector<feature::MapRegionsPerDesc> vec_queryRegions;
+  std::vector<std::pair<std::size_t, std::size_t>> vec_imageSize;
+  extractRegions(vec_imageGrey, *param, vec_queryRegions, vec_imageSize);
+
+  vec_locResults.clear();
+  vec_locResults.resize(nbFrames);
+
+  bool atLeastOneLocalized = false;
+  for(std::size_t i = 0; i < nbFrames; ++i)
+  {
+    const std::string imagePath = vec_imagePath.empty() ? std::string() : vec_imagePath.at(i);
+    if(localize(vec_queryRegions.at(i),
+                vec_imageSize.at(i),
+                parameters,
+                useInputIntrinsics,
+                vec_queryIntrinsics.at(i),
+                vec_locResults.at(i),
+                imagePath))
+    {
+      atLeastOneLocalized = true;
+    }
+  }
+  return atLeastOneLocalized;
+}
+
 CCTagLocalizer::~CCTagLocalizer()
 {
 }
@@ -404,23 +502,10 @@ bool CCTagLocalizer::localizeRig(const std::vector<image::Image<float>> & vec_im
   assert(numCams == vec_queryIntrinsics.size());
   assert(numCams == vec_subPoses.size() + 1);
 
-  std::vector<feature::MapRegionsPerDesc> vec_queryRegions(numCams);
+  // extract descriptors and features from all the images of the rig at once
+  std::vector<feature::MapRegionsPerDesc> vec_queryRegions;
   std::vector<std::pair<std::size_t, std::size_t> > vec_imageSize;
-  
-  //@todo parallelize?
-  for(size_t i = 0; i < numCams; ++i)
-  {
-    image::Image<unsigned char> imageGrayUChar; // cctag image describer don't support float image
-    imageGrayUChar = (vec_imageGrey.at(i).GetMat() * 255.f).cast<unsigned char>();
-
-    // extract descriptors and features from each image
-    ALICEVISION_LOG_DEBUG("[features]\tExtract CCTag from query image...");
-    _imageDescriber.setConfigurationPreset(param->_featurePreset);
-    _imageDescriber.describe(imageGrayUChar, vec_queryRegions[i][_imageDescriber.getDescriberType()]);
-    ALICEVISION_LOG_DEBUG("[features]\tExtract CCTAG done: found " <<  vec_queryRegions[i].at(_imageDescriber.getDescriberType())->RegionCount() << " features");
-    // add the image size for this image
-    vec_imageSize.emplace_back(vec_imageGrey[i].Width(), vec_imageGrey[i].Height());
-  }
+  extractRegions(vec_imageGrey, *param, vec_queryRegions, vec_imageSize);
   assert(vec_imageSize.size() == vec_queryRegions.size());
           
   return localizeRig(vec_queryRegions,
@@ -770,30 +855,42 @@ void CCTagLocalizer::getAllAssociations(const feature::CCTAG_Regions &queryRegio
   nearestKeyFrames.reserve(param._nNearestKeyFrames);
   
   kNearestKeyFrames(queryRegions,
-                    _cctagDescType,
-                    _regionsPerView,
+                    _cctagViewDescriptorPerView,
+                    _viewsPerCCTagId,
                     param._nNearestKeyFrames,
                     nearestKeyFrames);
-  
+
   out_matchedImages.clear();
   out_matchedImages.reserve(nearestKeyFrames.size());
-  
+
   ALICEVISION_LOG_DEBUG("nearestKeyFrames.size() = " << nearestKeyFrames.size());
-  for(const IndexT keyframeId : nearestKeyFrames)
+
+  // Match the query against the candidate keyframes in parallel, each
+  // iteration only writes its own slot
+  std::vector<std::vector<matching::IndMatch>> featureMatchesPerKeyFrame(nearestKeyFrames.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for(int i = 0; i < static_cast<int>(nearestKeyFrames.size()); ++i)
   {
+    const IndexT keyframeId = nearestKeyFrames[i];
+    const feature::Regions& matchedRegions = _regionsPerView.getRegions(keyframeId, _cctagDescType);
+    const feature::CCTAG_Regions& matchedCCtagRegions = dynamic_cast<const feature::CCTAG_Regions&>(matchedRegions);
+    viewMatching(queryRegions, matchedCCtagRegions, featureMatchesPerKeyFrame[i]);
+  }
+
+  // Collect the associations serially, in the keyframe order
+  for(std::size_t i = 0; i < nearestKeyFrames.size(); ++i)
+  {
+    const IndexT keyframeId = nearestKeyFrames[i];
+    const std::vector<matching::IndMatch>& vec_featureMatches = featureMatchesPerKeyFrame[i];
+
     ALICEVISION_LOG_DEBUG(keyframeId);
     ALICEVISION_LOG_DEBUG(_sfm_data.getViews().at(keyframeId)->getImagePath());
-    const feature::Regions& matchedRegions = _regionsPerView.getRegions(keyframeId, _cctagDescType);
     const ReconstructedRegionsMapping& regionsMapping = _reconstructedRegionsMappingPerView.at(keyframeId).at(_cctagDescType);
-    const feature::CCTAG_Regions & matchedCCtagRegions = dynamic_cast<const feature::CCTAG_Regions &>(matchedRegions);
-
-    // Matching
-    std::vector<matching::IndMatch> vec_featureMatches;
-    viewMatching(queryRegions, matchedCCtagRegions, vec_featureMatches);
     ALICEVISION_LOG_DEBUG("[matching]\tFound "<< vec_featureMatches.size() <<" matches.");
-    
+
     out_matchedImages.emplace_back(keyframeId, vec_featureMatches.size());
-    
+
     if(!param._visualDebug.empty() && !imagePath.empty())
     {
       namespace bfs = boost::filesystem;
@@ -817,16 +914,19 @@ void CCTagLocalizer::getAllAssociations(const feature::CCTAG_Regions &queryRegio
       outputName += matchedImage;
       outputName += ".svg";
       
+      const feature::CCTAG_Regions& matchedCCtagRegions =
+        dynamic_cast<const feature::CCTAG_Regions&>(_regionsPerView.getRegions(keyframeId, _cctagDescType));
+
       const bool showNotMatched = true;
-      feature::saveCCTagMatches2SVG(imagePath, 
-                                     imageSize, 
+      feature::saveCCTagMatches2SVG(imagePath,
+                                     imageSize,
                                      queryRegions,
                                      matchedPath,
                                      std::make_pair(mview->getWidth(), mview->getHeight()),
                                      matchedCCtagRegions,
                                      vec_featureMatches,
                                      outputName.string(),
-                                     showNotMatched ); 
+                                     showNotMatched );
     }
     
     // Recover the 2D-3D associations from the matches 
@@ -944,7 +1044,58 @@ void kNearestKeyFrames(const feature::CCTAG_Regions & queryRegions,
       break;
   }
 }
- 
+
+void kNearestKeyFrames(const feature::CCTAG_Regions & queryRegions,
+                       const std::map<IndexT, std::bitset<128>> & viewDescriptorPerView,
+                       const std::map<IndexT, std::vector<IndexT>> & viewsPerCCTagId,
+                       std::size_t nNearestKeyFrames,
+                       std::vector<IndexT> & out_kNearestFrames,
+                       float similarityThreshold /*=1.0f*/)
+{
+  out_kNearestFrames.clear();
+
+  const std::bitset<128> queryDescriptor = constructCCTagViewDescriptor(queryRegions.Descriptors());
+
+  // use the inverted index to collect only the views sharing at least one
+  // marker with the query: the other views have a zero similarity anyway
+  std::set<IndexT> candidateViews;
+  for(std::size_t cctagId = 0; cctagId < queryDescriptor.size(); ++cctagId)
+  {
+    if(!queryDescriptor.test(cctagId))
+      continue;
+    const auto itViews = viewsPerCCTagId.find(cctagId);
+    if(itViews == viewsPerCCTagId.end())
+      continue;
+    candidateViews.insert(itViews->second.begin(), itViews->second.end());
+  }
+
+  // A std::multimap is used instead of a std::map because is very likely that the
+  // similarity measure is equal for a subset of views in the CCTag regions case.
+  std::multimap<float, IndexT> sortedViewSimilarities;
+
+  for(const IndexT id_view : candidateViews)
+  {
+    const float similarity = (float)(queryDescriptor & viewDescriptorPerView.at(id_view)).count();
+    sortedViewSimilarities.emplace(similarity, id_view);
+  }
+
+  std::size_t counter = 0;
+  out_kNearestFrames.reserve(nNearestKeyFrames);
+  for (auto rit = sortedViewSimilarities.crbegin(); rit != sortedViewSimilarities.crend(); ++rit)
+  {
+    if(rit->first < similarityThreshold)
+      // since it is ordered, the first having smaller similarity guarantees that
+      // there won't be other useful kframes
+      break;
+
+    out_kNearestFrames.push_back(rit->second);
+    ++counter;
+
+    if (counter == nNearestKeyFrames)
+      break;
+  }
+}
+
 void viewMatching(const feature::CCTAG_Regions & regionsA,
                   const feature::CCTAG_Regions & regionsB,
                   std::vector<matching::IndMatch> & out_featureMatches)
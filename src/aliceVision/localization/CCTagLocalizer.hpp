@@ -74,6 +74,28 @@ public:
                 LocalizationResult & localizationResult,
                 const std::string& imagePath = std::string()) override;
 
+  /**
+   * @brief Localize a batch of frames at once: the markers are first detected
+   * in all the frames (in parallel on CPU, the CUDA pipeline already processes
+   * a full frame on the device), then each frame is localized from its regions.
+   * For a localization feed this hides the per-frame detection latency.
+   *
+   * @param[in] vec_imageGrey The input greyscale frames.
+   * @param[in] parameters The parameters for the localization.
+   * @param[in] useInputIntrinsics Uses the \p vec_queryIntrinsics as known calibration
+   * (assumed uniform over the batch, as for a single feed).
+   * @param[in,out] vec_queryIntrinsics Intrinsic parameters of the camera for each frame.
+   * @param[out] vec_locResults The localization result for each frame.
+   * @param[in] vec_imagePath Optional complete path to each frame, used only for debugging.
+   * @return true if at least one frame has been successfully localized.
+   */
+  bool localizeBatch(const std::vector<image::Image<float>> & vec_imageGrey,
+                     const LocalizerParameters *parameters,
+                     bool useInputIntrinsics,
+                     std::vector<camera::PinholeRadialK3> &vec_queryIntrinsics,
+                     std::vector<LocalizationResult> &vec_locResults,
+                     const std::vector<std::string> &vec_imagePath = std::vector<std::string>());
+
   /**
    * @brief Naive implementation of the localizer using the rig. Each image from
    * the rig is localized and then a bundle adjustment is run for optimizing the 
@@ -149,16 +171,37 @@ public:
   virtual ~CCTagLocalizer();
 
 private:
-  
+
   bool loadReconstructionDescriptors(
     const sfmData::SfMData & sfm_data,
     const std::string & feat_directory);
+
+  /**
+   * @brief Detect the markers in a set of frames. The detection runs over the
+   * frames in parallel when the describer uses the CPU; with CUDA the frames
+   * are submitted one by one to the pipe, which already processes a full frame
+   * on the device.
+   *
+   * @param[in] vec_imageGrey The input greyscale frames.
+   * @param[in] param The parameters to use (for the feature preset).
+   * @param[out] out_queryRegions The detected regions for each frame.
+   * @param[out] out_imageSize The size of each frame.
+   */
+  void extractRegions(const std::vector<image::Image<float>> & vec_imageGrey,
+                      const LocalizerParameters &param,
+                      std::vector<feature::MapRegionsPerDesc> &out_queryRegions,
+                      std::vector<std::pair<std::size_t, std::size_t>> &out_imageSize);
   
   // for each view index, it contains the cctag features and descriptors that have an
   // associated 3D point
   feature::RegionsPerView _regionsPerView;
   ReconstructedRegionsMappingPerView _reconstructedRegionsMappingPerView;
 
+  // for each view index, its 128 bit marker visibility descriptor (built once at init)
+  std::map<IndexT, std::bitset<128>> _cctagViewDescriptorPerView;
+  // inverted index: for each marker id, the views where it is reconstructed
+  std::map<IndexT, std::vector<IndexT>> _viewsPerCCTagId;
+
   // the feature extractor
   feature::ImageDescriber_CCTAG _imageDescriber;
   /// @warning: descType needs to be a CCTAG_Regions
@@ -191,6 +234,28 @@ void kNearestKeyFrames(
           std::vector<IndexT> & out_kNearestFrames,
           float similarityThreshold = 1.0f);
 
+ /**
+   * @brief Retrieve the k nearest views using precomputed view descriptors and
+   *        an inverted marker id -> views index: only the views sharing at least
+   *        one marker with the query are scored.
+   *
+   * @param[in] queryRegions Set of CCTag regions in the query.
+   * @param[in] viewDescriptorPerView For each view, its 128 bit marker visibility descriptor.
+   * @param[in] viewsPerCCTagId For each marker id, the views where it is reconstructed.
+   * @param[in] nNearestKeyFrames Number of nearest neighbours to return.
+   * @param[out] out_kNearestFrames Set of computed indices associated to the k nearest views.
+   * @param[in] similarityThreshold A threshold to retrieve only the kframes having
+   *  at least \p similarityThreshold similarity score (views sharing no marker with
+   *  the query are never returned, whatever the threshold).
+   */
+void kNearestKeyFrames(
+          const feature::CCTAG_Regions & queryRegions,
+          const std::map<IndexT, std::bitset<128>> & viewDescriptorPerView,
+          const std::map<IndexT, std::vector<IndexT>> & viewsPerCCTagId,
+          std::size_t nNearestKeyFrames,
+          std::vector<IndexT> & out_kNearestFrames,
+          float similarityThreshold = 1.0f);
+
 /**
  * @brief Given a set of CCTag descriptors seen in a view, it creates a descriptor for the view: the
  * view descriptor is a 128 bit array (ie the number of possible markers) whose 
@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <thread>
 
 namespace aliceVision {
 namespace localization {
@@ -121,7 +122,8 @@ VoctreeLocalizer::VoctreeLocalizer(const sfmData::SfMData &sfmData,
                                    const std::string &descriptorsFolder,
                                    const std::string &vocTreeFilepath,
                                    const std::string &weightsFilepath,
-                                   const std::vector<feature::EImageDescriberType>& matchingDescTypes)
+                                   const std::vector<feature::EImageDescriberType>& matchingDescTypes,
+                                   const std::string &databaseFilepath)
   : ILocalizer()
   , _frameBuffer(5)
 {
@@ -141,7 +143,7 @@ VoctreeLocalizer::VoctreeLocalizer(const sfmData::SfMData &sfmData,
   // then we can store only those associated to 3D points
   //? can we use Feature_Provider to load the features and filter them later?
 
-  _isInit = initDatabase(vocTreeFilepath, weightsFilepath, descriptorsFolder);
+  _isInit = initDatabase(vocTreeFilepath, weightsFilepath, descriptorsFolder, databaseFilepath);
 }
 
 bool VoctreeLocalizer::localize(const feature::MapRegionsPerDesc & queryRegions,
@@ -183,16 +185,12 @@ bool VoctreeLocalizer::localize(const feature::MapRegionsPerDesc & queryRegions,
   }
 }
 
-bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
-                                const LocalizerParameters *param,
-                                bool useInputIntrinsics,
-                                camera::PinholeRadialK3 &queryIntrinsics,
-                                LocalizationResult &localizationResult,
-                                const std::string& imagePath /* = std::string() */)
+void VoctreeLocalizer::extractRegions(const image::Image<float> & imageGrey,
+                                      const LocalizerParameters *param,
+                                      feature::MapRegionsPerDesc & queryRegionsPerDesc,
+                                      const std::string& imagePath /* = std::string() */) const
 {
-  // A. extract descriptors and features from image
   ALICEVISION_LOG_DEBUG("[features]\tExtract Regions from query image");
-  feature::MapRegionsPerDesc queryRegionsPerDesc;
 
   image::Image<unsigned char> imageGrayUChar; // uchar image copy for uchar image describer
 
@@ -222,8 +220,6 @@ bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
     ALICEVISION_LOG_DEBUG("[features]\tExtract " << feature::EImageDescriberType_enumToString(descType) << " done: found " << queryRegions->RegionCount() << " features in " << timer.elapsedMs() << " [ms]");
   }
 
-  const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(imageGrey.Width(), imageGrey.Height());
-
   // if debugging is enable save the svg image with the extracted features
   if(!param->_visualDebug.empty() && !imagePath.empty())
   {
@@ -237,10 +233,24 @@ bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
 
     namespace bfs = boost::filesystem;
     feature::saveFeatures2SVG(imagePath,
-                     queryImageSize,
+                     std::make_pair(imageGrey.Width(), imageGrey.Height()),
                      extractedFeatures,
                      param->_visualDebug + "/" + bfs::path(imagePath).stem().string() + ".svg");
   }
+}
+
+bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
+                                const LocalizerParameters *param,
+                                bool useInputIntrinsics,
+                                camera::PinholeRadialK3 &queryIntrinsics,
+                                LocalizationResult &localizationResult,
+                                const std::string& imagePath /* = std::string() */)
+{
+  // A. extract descriptors and features from image
+  feature::MapRegionsPerDesc queryRegionsPerDesc;
+  extractRegions(imageGrey, param, queryRegionsPerDesc, imagePath);
+
+  const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(imageGrey.Width(), imageGrey.Height());
 
   return localize(queryRegionsPerDesc,
                   queryImageSize,
@@ -251,6 +261,78 @@ bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
                   imagePath);
 }
 
+std::size_t VoctreeLocalizer::localizeSequence(const std::vector<image::Image<float>> & vec_imageGrey,
+                                               const LocalizerParameters *param,
+                                               bool useInputIntrinsics,
+                                               camera::PinholeRadialK3 &queryIntrinsics,
+                                               std::vector<LocalizationResult> & vec_localizationResults,
+                                               const std::vector<std::string>& vec_imagePath /* = std::vector<std::string>() */)
+{
+  const std::size_t numFrames = vec_imageGrey.size();
+  vec_localizationResults.clear();
+  vec_localizationResults.resize(numFrames);
+  if(numFrames == 0)
+    return 0;
+
+  const auto getImagePath = [&vec_imagePath](std::size_t frame) -> std::string
+  {
+    return frame < vec_imagePath.size() ? vec_imagePath[frame] : std::string();
+  };
+
+  // Two region slots used in ping-pong: while the regions of the current frame
+  // are matched and resected, the extraction of the next frame fills the other
+  // slot on a background thread. Matching and resection stay sequential, so the
+  // intrinsics refinement and the frame buffer see the frames in order.
+  feature::MapRegionsPerDesc regionsSlots[2];
+  std::thread extractionThread;
+  std::exception_ptr extractionError;
+
+  // extract the first frame synchronously to prime the pipeline
+  extractRegions(vec_imageGrey[0], param, regionsSlots[0], getImagePath(0));
+
+  std::size_t numLocalized = 0;
+  for(std::size_t frame = 0; frame < numFrames; ++frame)
+  {
+    feature::MapRegionsPerDesc & currRegions = regionsSlots[frame % 2];
+
+    if(frame + 1 < numFrames)
+    {
+      feature::MapRegionsPerDesc & nextRegions = regionsSlots[(frame + 1) % 2];
+      nextRegions.clear();
+      extractionThread = std::thread([this, &vec_imageGrey, param, &nextRegions, &getImagePath, frame, &extractionError]()
+      {
+        try
+        {
+          extractRegions(vec_imageGrey[frame + 1], param, nextRegions, getImagePath(frame + 1));
+        }
+        catch(...)
+        {
+          extractionError = std::current_exception();
+        }
+      });
+    }
+
+    const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(vec_imageGrey[frame].Width(), vec_imageGrey[frame].Height());
+    const bool localized = localize(currRegions,
+                                    queryImageSize,
+                                    param,
+                                    useInputIntrinsics,
+                                    queryIntrinsics,
+                                    vec_localizationResults[frame],
+                                    getImagePath(frame));
+    if(localized)
+      ++numLocalized;
+
+    if(extractionThread.joinable())
+    {
+      extractionThread.join();
+      if(extractionError)
+        std::rethrow_exception(extractionError);
+    }
+  }
+  return numLocalized;
+}
+
 bool VoctreeLocalizer::loadReconstructionDescriptors(const sfmData::SfMData & sfm_data,
                                                      const std::string & feat_directory)
 {
@@ -265,10 +347,13 @@ bool VoctreeLocalizer::loadReconstructionDescriptors(const sfmData::SfMData & sf
  */
 bool VoctreeLocalizer::initDatabase(const std::string & vocTreeFilepath,
                                     const std::string & weightsFilepath,
-                                    const std::string & featFolder)
+                                    const std::string & featFolder,
+                                    const std::string & databaseFilepath)
 {
+  namespace bfs = boost::filesystem;
 
   bool withWeights = !weightsFilepath.empty();
+  const bool withDatabaseImage = !databaseFilepath.empty() && bfs::exists(databaseFilepath);
 
   // Load vocabulary tree
   ALICEVISION_LOG_DEBUG("Loading vocabulary tree...");
@@ -281,7 +366,14 @@ bool VoctreeLocalizer::initDatabase(const std::string & vocTreeFilepath,
   ALICEVISION_LOG_DEBUG("Creating the database...");
   // Add each object (document) to the database
   _database = voctree::Database(_voctree->words());
-  if(withWeights)
+  if(withDatabaseImage)
+  {
+    // the saved image contains the weights and the quantized documents,
+    // so the quantization of the descriptors below can be skipped entirely
+    ALICEVISION_LOG_DEBUG("Loading database from " << databaseFilepath << "...");
+    _database.load(databaseFilepath);
+  }
+  else if(withWeights)
   {
     ALICEVISION_LOG_DEBUG("Loading weights...");
     _database.loadWeights(weightsFilepath);
@@ -359,7 +451,7 @@ bool VoctreeLocalizer::initDatabase(const std::string & vocTreeFilepath,
       // Load from files
       std::unique_ptr<feature::Regions> currRegions = sfm::loadRegions(featuresFolders, id_view, *imageDescriber);
 
-      if(descType == _voctreeDescType)
+      if(descType == _voctreeDescType && !withDatabaseImage)
       {
         voctree::SparseHistogram histo = _voctree->quantizeToSparse(currRegions->blindDescriptors());
 #pragma omp critical
@@ -382,6 +474,12 @@ bool VoctreeLocalizer::initDatabase(const std::string & vocTreeFilepath,
       ++my_progress_bar;
     }
   }
+
+  if(!databaseFilepath.empty() && !withDatabaseImage)
+  {
+    ALICEVISION_LOG_DEBUG("Saving database to " << databaseFilepath << "...");
+    _database.save(databaseFilepath);
+  }
   return true;
 }
 
@@ -612,8 +710,12 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc &quer
                                           const std::string& imagePath)
 {
   
+  // whether the candidate images have been seeded from the previous frame
+  // instead of being retrieved from the database
+  const bool seededFromTracking = param._useTracking && !_trackingCandidates.empty();
+
   sfm::ImageLocalizerMatchData resectionData;
-  // a map containing for each pair <pt3D_id, pt2D_id> the number of times that 
+  // a map containing for each pair <pt3D_id, pt2D_id> the number of times that
   // the association has been seen
   OccurenceMap occurences;
   
@@ -661,6 +763,19 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc &quer
   if(!bResection)
   {
     ALICEVISION_LOG_DEBUG("[poseEstimation]\tResection failed");
+    if(seededFromTracking)
+    {
+      // the tracking is lost, retry the frame against the whole database
+      ALICEVISION_LOG_DEBUG("[poseEstimation]\tTracking lost, falling back to a full database query");
+      _trackingCandidates.clear();
+      return localizeAllResults(queryRegions,
+                                queryImageSize,
+                                param,
+                                useInputIntrinsics,
+                                queryIntrinsics,
+                                localizationResult,
+                                imagePath);
+    }
     if(!param._visualDebug.empty() && !imagePath.empty())
     {
       namespace bfs = boost::filesystem;
@@ -736,6 +851,35 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc &quer
     _frameBuffer.emplace_back(localizationResult, queryRegions);
   }
 
+  if(param._useTracking)
+  {
+    _trackingCandidates.clear();
+    if(localizationResult.isValid())
+    {
+      // vote for the database views observing the inlier points: they are the
+      // candidate images for the next frame of the sequence
+      std::map<IndexT, std::size_t> viewVotes;
+      const std::vector<IndMatch3D2D> &indMatch3D2D = localizationResult.getIndMatch3D2D();
+      for(const std::size_t inlierIdx : localizationResult.getInliers())
+      {
+        const sfmData::Landmark &landmark = _sfm_data.getLandmarks().at(indMatch3D2D[inlierIdx].landmarkId);
+        for(const auto &observation : landmark.observations)
+          ++viewVotes[observation.first];
+      }
+      const std::size_t numInliers = localizationResult.getInliers().size();
+      _trackingCandidates.reserve(viewVotes.size());
+      for(const auto &vote : viewVotes)
+      {
+        // map the votes to the [0,2] best-to-worst range of the database scores,
+        // a view observing every inlier gets a score of 0
+        _trackingCandidates.emplace_back(vote.first, 2.f - (2.f * vote.second) / numInliers);
+      }
+      std::sort(_trackingCandidates.begin(), _trackingCandidates.end());
+      if((param._numResults != 0) && (_trackingCandidates.size() > param._numResults))
+        _trackingCandidates.resize(param._numResults);
+    }
+  }
+
   return localizationResult.isValid();
 }
 
@@ -762,10 +906,21 @@ void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc &quer
     ALICEVISION_LOG_WARNING("[database]\t No feature type " << feature::EImageDescriberType_enumToString(_voctreeDescType) << " in query region.");
     return;
   }
-  voctree::SparseHistogram requestImageWords = _voctree->quantizeToSparse(queryRegions.at(_voctreeDescType)->blindDescriptors());
-  
-  // Request closest images from voctree
-  _database.find(requestImageWords, (param._numResults==0) ? (_database.size()) : (param._numResults) , out_matchedImages);
+  if(param._useTracking && !_trackingCandidates.empty())
+  {
+    // tracking mode: consecutive frames of a sequence see nearly the same views,
+    // reuse the views observing the inliers of the previous frame and skip both
+    // the quantization of the query descriptors and the database query
+    ALICEVISION_LOG_DEBUG("[database]\tSeeding " << _trackingCandidates.size() << " candidate images from the previous frame inliers");
+    out_matchedImages = _trackingCandidates;
+  }
+  else
+  {
+    voctree::SparseHistogram requestImageWords = _voctree->quantizeToSparse(queryRegions.at(_voctreeDescType)->blindDescriptors());
+
+    // Request closest images from voctree
+    _database.find(requestImageWords, (param._numResults==0) ? (_database.size()) : (param._numResults) , out_matchedImages);
+  }
 
 //  // Debugging log
 //  // for each similar image found print score and number of features
@@ -1162,34 +1317,18 @@ bool VoctreeLocalizer::localizeRig(const std::vector<image::Image<float>> & vec_
   std::vector<feature::MapRegionsPerDesc> vec_queryRegions(numCams);
   std::vector<std::pair<std::size_t, std::size_t> > vec_imageSize;
 
-  //@todo parallelize?
   for(size_t i = 0; i < numCams; ++i)
   {
     // add the image size for this image
     vec_imageSize.emplace_back(vec_imageGrey[i].Width(), vec_imageGrey[i].Height());
+  }
 
-    image::Image<unsigned char> imageGrayUChar; // uchar image copy for uchar image describer
-
-    // extract descriptors and features from each image
-    for(auto& imageDescriber: _imageDescribers)
-    {
-      ALICEVISION_LOG_DEBUG("[features]\tExtract " << feature::EImageDescriberType_enumToString(imageDescriber->getDescriberType()) << " from query image...");
-      imageDescriber->describe(vec_imageGrey[i], vec_queryRegions[i][imageDescriber->getDescriberType()]);
-
-      if(imageDescriber->useFloatImage())
-      {
-        imageDescriber->describe(vec_imageGrey[i], vec_queryRegions[i][imageDescriber->getDescriberType()]);
-      }
-      else
-      {
-        // image descriptor can't use float image
-        if(imageGrayUChar.Width() == 0) // the first time, convert the float buffer to uchar
-          imageGrayUChar = (vec_imageGrey.at(i).GetMat() * 255.f).cast<unsigned char>();
-        imageDescriber->describe(imageGrayUChar, vec_queryRegions[i][imageDescriber->getDescriberType()]);
-      }
-      ALICEVISION_LOG_DEBUG("[features]\tExtract done: found " <<  vec_queryRegions[i][imageDescriber->getDescriberType()]->RegionCount() << " features");
-    }
-    ALICEVISION_LOG_DEBUG("[features]\tAll descriptors extracted. Found " <<  vec_queryRegions[i].getNbAllRegions() << " features");
+  // the extraction of each camera is independent, they only join at the rig resection
+  #pragma omp parallel for
+  for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(numCams); ++i)
+  {
+    extractRegions(vec_imageGrey[i], parameters, vec_queryRegions[i]);
+    ALICEVISION_LOG_DEBUG("[features]\tAll descriptors extracted for camera " << i << ". Found " <<  vec_queryRegions[i].getNbAllRegions() << " features");
   }
   assert(vec_imageSize.size() == vec_queryRegions.size());
           
@@ -1269,10 +1408,12 @@ bool VoctreeLocalizer::localizeRig_opengv(const std::vector<feature::MapRegionsP
   std::vector<Mat> vec_pts3D(numCams);
   std::vector<Mat> vec_pts2D(numCams);
 
-  // for each camera retrieve the associations
-  //@todo parallelize?
+  // for each camera retrieve the associations: the cameras only share read-only
+  // structures (voctree, database, reconstructed regions), so they can be
+  // processed in parallel, they only join at the rig resection below
   size_t numAssociations = 0;
-  for(std::size_t camID = 0; camID < numCams; ++camID)
+  #pragma omp parallel for reduction(+:numAssociations)
+  for(ptrdiff_t camID = 0; camID < static_cast<ptrdiff_t>(numCams); ++camID)
   {
 
     // this map is used to collect the 2d-3d associations as we go through the images
@@ -1518,7 +1659,8 @@ bool VoctreeLocalizer::localizeRig_naive(const std::vector<feature::MapRegionsPe
   vec_localizationResults.resize(numCams);
     
   // this is basic, just localize each camera alone
-  //@todo parallelize?
+  // note: this cannot be parallelized over the cameras as localize() updates the
+  // frame buffer and the tracking state of the localizer
   std::vector<bool> isLocalized(numCams, false);
   for(size_t i = 0; i < numCams; ++i)
   {
@@ -55,6 +55,7 @@ public:
       , _ccTagUseCuda(true)
       , _matchingError(std::numeric_limits<double>::infinity())
       , _nbFrameBufferMatching(10)
+      , _useTracking(false)
     {}
     
     /// Enable/disable guided matching when matching images
@@ -75,6 +76,10 @@ public:
     double _matchingError;
     /// maximum capacity of the frame buffer
     std::size_t _nbFrameBufferMatching;
+    /// when localizing a sequence, seed the candidate images of each frame from
+    /// the inliers of the previous frame instead of querying the whole database
+    /// (a full database query is still performed whenever the tracking is lost)
+    bool _useTracking;
   };
   
 public:
@@ -92,6 +97,10 @@ public:
    * when all the documents are added.
    * @param[in] matchingDescTypes List of descriptor types to use for feature matching.
    * @param[in] voctreeDescType Descriptor type used for image matching with voctree.
+   * @param[in] databaseFilepath Optional path to a database image written by
+   * voctree::Database::save(): if the file exists the database is loaded from it
+   * instead of re-quantizing all the descriptors, otherwise the built database
+   * is saved there for the next run.
    *
    * It enable the use of combined SIFT and CCTAG features.
    */
@@ -99,7 +108,8 @@ public:
                    const std::string &descriptorsFolder,
                    const std::string &vocTreeFilepath,
                    const std::string &weightsFilepath,
-                   const std::vector<feature::EImageDescriberType>& matchingDescTypes
+                   const std::vector<feature::EImageDescriberType>& matchingDescTypes,
+                   const std::string &databaseFilepath = std::string()
                   );
   
   void setCudaPipe( int i ) override
@@ -150,8 +160,31 @@ public:
                 camera::PinholeRadialK3 &queryIntrinsics,
                 LocalizationResult & localizationResult,
                 const std::string& imagePath = std::string()) override;
-  
-  
+
+  /**
+   * @brief Localize a sequence of frames, pipelining the work: while frame N is
+   * being matched and resected, the features of frame N+1 are extracted on a
+   * background thread. The frames are processed in order, so the sequential uses
+   * of the localization (intrinsics refinement, frame buffer matching) behave as
+   * if localize() had been called frame by frame.
+   *
+   * @param[in] vec_imageGrey The input greyscale frames, in sequence order.
+   * @param[in] param The parameters for the localization.
+   * @param[in] useInputIntrinsics Uses the \p queryIntrinsics as known calibration.
+   * @param[in,out] queryIntrinsics Intrinsic parameters of the camera, shared by all
+   * the frames of the sequence and possibly refined along it.
+   * @param[out] vec_localizationResults A localization result per input frame.
+   * @param[in] vec_imagePath Optional complete path of each frame, used only for debugging purposes.
+   * @return the number of successfully localized frames.
+   */
+  std::size_t localizeSequence(const std::vector<image::Image<float>> & vec_imageGrey,
+                               const LocalizerParameters *param,
+                               bool useInputIntrinsics,
+                               camera::PinholeRadialK3 &queryIntrinsics,
+                               std::vector<LocalizationResult> & vec_localizationResults,
+                               const std::vector<std::string>& vec_imagePath = std::vector<std::string>());
+
+
   bool localizeRig(const std::vector<image::Image<float>> & vec_imageGrey,
                    const LocalizerParameters *param,
                    std::vector<camera::PinholeRadialK3 > &vec_queryIntrinsics,
@@ -273,13 +306,29 @@ private:
    * @param[in] weightsFilepath weightsFilepath Optional path to the weights of the vocabulary 
    * tree (usually a .weights file), if not provided the weights will be recomputed 
    * when all the documents are added.
-   * @param[in] feat_directory The path to the directory containing the features 
+   * @param[in] feat_directory The path to the directory containing the features
    * of the scene (.desc and .feat files).
+   * @param[in] databaseFilepath Optional path to a database image: loaded when the
+   * file exists, written after building the database otherwise.
    * @return true if everything went ok
    */
   bool initDatabase(const std::string & vocTreeFilepath,
                     const std::string & weightsFilepath,
-                    const std::string & featFolder);
+                    const std::string & featFolder,
+                    const std::string & databaseFilepath = std::string());
+
+  /**
+   * @brief Extract the query regions of an image with every image describer.
+   *
+   * @param[in] imageGrey The input greyscale image.
+   * @param[in] param The parameters for the localization, for the feature preset.
+   * @param[out] queryRegionsPerDesc The extracted regions, per describer type.
+   * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+   */
+  void extractRegions(const image::Image<float> & imageGrey,
+                      const LocalizerParameters *param,
+                      feature::MapRegionsPerDesc & queryRegionsPerDesc,
+                      const std::string& imagePath = std::string()) const;
 
   /**
    * @brief robustMatching
@@ -354,6 +403,11 @@ public:
   /// Last frames buffer
   BoundedBuffer<FrameData> _frameBuffer;
 
+  /// candidate images for the next frame, seeded from the views observing the
+  /// inlier points of the previous frame (only used when Parameters::_useTracking
+  /// is enabled, empty whenever the tracking is lost)
+  std::vector<voctree::DocMatch> _trackingCandidates;
+
   matching::EMatcherType _matcherType = matching::ANN_L2;
 };
 
@@ -20,6 +20,8 @@
 #include <boost/accumulators/statistics/max.hpp>
 #include <boost/accumulators/statistics/sum.hpp>
 
+#include <deque>
+
 namespace aliceVision{
 namespace localization{
 
@@ -337,6 +339,202 @@ bool refineSequence(std::vector<LocalizationResult> & vec_localizationResult,
   return b_BA_Status;
 }
 
+bool refineSequenceFixedLag(std::vector<LocalizationResult> & vec_localizationResult,
+                            std::size_t windowSize /*= 10*/,
+                            bool allTheSameIntrinsics /*= true*/,
+                            bool b_refine_intrinsic /*= true*/,
+                            bool b_no_distortion /*= false*/,
+                            bool b_refine_pose /*= true*/,
+                            bool b_refine_structure /*= false*/)
+{
+  const std::size_t numViews = vec_localizationResult.size();
+  assert(numViews > 0);
+  assert(windowSize > 1);
+
+  // the id for the instrinsic group
+  const IndexT intrinsicID = 0;
+
+  // the single camera shared by all the frames: it is refined incrementally,
+  // each window solve starting from the result of the previous one
+  std::shared_ptr<camera::IntrinsicBase> sharedIntrinsics;
+  if(allTheSameIntrinsics)
+  {
+    // find the first valid localization result and use its intrinsics
+    std::size_t intrinsicIndex = 0;
+    for(std::size_t viewID = 0; viewID < numViews; ++viewID, ++intrinsicIndex)
+    {
+      if(vec_localizationResult[viewID].isValid())
+        break;
+    }
+    // it may be the case that all the localization result are invalid...
+    if(intrinsicIndex == numViews)
+    {
+      ALICEVISION_CERR("Apparently all the vec_localizationResult are invalid! Aborting...");
+      return false;
+    }
+
+    ALICEVISION_CERR("allTheSameIntrinsics mode: using the intrinsics of the " << intrinsicIndex << " result");
+
+    const camera::PinholeRadialK3 &currIntrinsics = vec_localizationResult.at(intrinsicIndex).getIntrinsics();
+
+    if(b_no_distortion)
+    {
+      // no distortion refinement
+      ALICEVISION_LOG_DEBUG("Optical distortion won't be considered");
+      // just add a simple pinhole camera with the same K as the input camera
+      const Vec2 pp = currIntrinsics.principal_point();
+      sharedIntrinsics = std::make_shared<camera::Pinhole>(currIntrinsics._w, currIntrinsics._h, currIntrinsics.focal(), pp(0), pp(1));
+    }
+    else
+    {
+      sharedIntrinsics = std::make_shared<camera::PinholeRadialK3>(currIntrinsics);
+    }
+  }
+
+  sfm::BundleAdjustment::ERefineOptions refineOptions = sfm::BundleAdjustment::REFINE_NONE;
+  if(b_refine_pose)
+    refineOptions |= sfm::BundleAdjustment::REFINE_ROTATION | sfm::BundleAdjustment::REFINE_TRANSLATION;
+  if(b_refine_intrinsic)
+    refineOptions |= sfm::BundleAdjustment::REFINE_INTRINSICS_ALL;
+  if(b_refine_structure)
+    refineOptions |= sfm::BundleAdjustment::REFINE_STRUCTURE;
+
+  // the localized frames currently inside the window
+  std::deque<std::size_t> window;
+  bool b_BA_Status = true;
+
+  for(std::size_t currViewID = 0; currViewID < numViews; ++currViewID)
+  {
+    // skip invalid poses
+    if(!vec_localizationResult[currViewID].isValid())
+    {
+      ALICEVISION_LOG_DEBUG("\n*****\nskipping invalid View " << currViewID);
+      continue;
+    }
+
+    window.push_back(currViewID);
+    if(window.size() > windowSize)
+      window.pop_front();
+
+    // the first localized frame is just the anchor, there is nothing to refine yet
+    if(window.size() < 2)
+      continue;
+
+    // Setup a tiny SfM scene with the 2D-3D data of the frames inside the window
+    sfmData::SfMData tinyScene;
+    IndexT currIntrinsicID = intrinsicID;
+
+    if(allTheSameIntrinsics)
+      tinyScene.intrinsics[intrinsicID] = sharedIntrinsics;
+
+    for(const std::size_t viewID : window)
+    {
+      LocalizationResult &currResult = vec_localizationResult[viewID];
+
+      // view
+      std::shared_ptr<sfmData::View> view = std::make_shared<sfmData::View>("", viewID, currIntrinsicID, viewID);
+      tinyScene.views.insert(std::make_pair(viewID, view));
+      // pose: the oldest frame of the window plays the role of the marginalized
+      // older frames and is kept constant
+      sfmData::CameraPose pose(currResult.getPose());
+      if(viewID == window.front())
+        pose.lock();
+      tinyScene.setPose(*view, pose);
+
+      if(!allTheSameIntrinsics)
+      {
+        camera::PinholeRadialK3* currIntrinsics = &currResult.getIntrinsics();
+        // intrinsic (the shared_ptr does not take the ownership, will not release the input pointer)
+        tinyScene.intrinsics[currIntrinsicID] = std::shared_ptr<camera::PinholeRadialK3>(currIntrinsics, [](camera::PinholeRadialK3*){});
+        ++currIntrinsicID;
+      }
+
+      // structure data (2D-3D correspondences)
+      const std::vector<IndMatch3D2D> &matches = currResult.getIndMatch3D2D();
+
+      for(const size_t idx : currResult.getInliers())
+      {
+        // the idx should be in the size range of the data
+        assert(idx < currResult.getPt3D().cols());
+        const IndMatch3D2D& match = matches[idx];
+        // get the corresponding feature
+        const Vec2 &feature = currResult.getPt2D().col(idx);
+        // check if the point exists already
+        if(tinyScene.structure.count(match.landmarkId))
+        {
+          sfmData::Landmark& landmark = tinyScene.structure.at(match.landmarkId);
+          assert(landmark.descType == match.descType);
+          // normally there should be no other features already associated to this
+          // 3D point in this view
+          if(landmark.observations.count(viewID) != 0)
+            continue;
+
+          // the 3D point exists already, add the observation
+          landmark.observations[viewID] = sfmData::Observation(feature, match.featId);
+        }
+        else
+        {
+          // create a new 3D point
+          sfmData::Landmark newLandmark;
+          newLandmark.descType = match.descType;
+          newLandmark.X = currResult.getPt3D().col(idx);
+          newLandmark.observations[viewID] = sfmData::Observation(feature, match.featId);
+          tinyScene.structure[match.landmarkId] = std::move(newLandmark);
+        }
+      }
+    }
+
+    sfm::BundleAdjustmentCeres bundle_adjustment_obj;
+    const bool windowStatus = bundle_adjustment_obj.adjust(tinyScene, refineOptions);
+    if(!windowStatus)
+    {
+      ALICEVISION_CERR("Bundle adjustment failed for the window ending at view " << currViewID);
+      b_BA_Status = false;
+      continue;
+    }
+
+    // get back the results and update the localization results with the refined poses
+    for(const auto &pose : tinyScene.getPoses())
+    {
+      const IndexT idPose = pose.first;
+      vec_localizationResult[idPose].setPose(pose.second.getTransform());
+    }
+  }
+
+  if(allTheSameIntrinsics)
+  {
+    // if we used the same intrinsics for all the localization results we need to
+    // update the intrinsics of each localization result
+
+    // get its optimized parameters
+    std::vector<double> params = sharedIntrinsics->getParams();
+    if(params.size() == 3)
+    {
+      // this means that the b_no_distortion has been passed
+      // set distortion to 0
+      params.push_back(0);
+      params.push_back(0);
+      params.push_back(0);
+    }
+    assert(params.size() == 6);
+    ALICEVISION_LOG_DEBUG("K after bundle: " << params[0] << " " << params[1] << " "<< params[2]);
+    ALICEVISION_LOG_DEBUG("Distortion after bundle " << params[3] << " " << params[4] << " "<< params[5]);
+
+    // update the intrinsics of the each localization result
+    for(size_t viewID = 0; viewID < numViews; ++viewID)
+    {
+      LocalizationResult &currResult = vec_localizationResult[viewID];
+      if(!currResult.isValid())
+      {
+        continue;
+      }
+      currResult.updateIntrinsics(params);
+    }
+  }
+
+  return b_BA_Status;
+}
+
 bool refineRigPose(const std::vector<geometry::Pose3 > &vec_subPoses,
                    const std::vector<localization::LocalizationResult> & vec_localizationResults,
                    geometry::Pose3 & rigPose)
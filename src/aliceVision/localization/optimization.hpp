@@ -49,6 +49,34 @@ bool refineSequence(std::vector<LocalizationResult> & vec_localizationResult,
                     const std::string & outputFilename = "",
                     std::size_t minPointVisibility = 0);
 
+/**
+ * @brief Incremental version of \p refineSequence performing a fixed-lag bundle
+ * adjustment: the frames are processed in order and each new frame triggers a
+ * bundle adjustment over the last \p windowSize localized frames only, the pose
+ * of the oldest frame of the window being kept fixed as the anchor of the frames
+ * that already left the window. The cost is then constant per frame and the
+ * refined poses are available as soon as their frame leaves the window, instead
+ * of at the end of the whole take.
+ *
+ * @param[in,out] vec_localizationResult The series of camera poses and point correspondences.
+ * @param[in] windowSize The number of localized frames to refine at each step.
+ * @param[in] allTheSameIntrinsics If true a single camera having constant internal
+ * parameters during the whole sequence is assumed.
+ * @param[in] b_refine_intrinsic Whether to refine the camera parameters.
+ * @param[in] b_no_distortion If b_refine_intrinsic is true, this allow to not consider
+ * the optical distortion, setting it to 0.
+ * @param[in] b_refine_pose Whether to refine the camera poses.
+ * @param[in] b_refine_structure Whether to refine the 3D points.
+ * @return true if all the bundle adjustments have success.
+ */
+bool refineSequenceFixedLag(std::vector<LocalizationResult> & vec_localizationResult,
+                            std::size_t windowSize = 10,
+                            bool allTheSameIntrinsics = true,
+                            bool b_refine_intrinsic = true,
+                            bool b_no_distortion = false,
+                            bool b_refine_pose = true,
+                            bool b_refine_structure = false);
+
 /**
  * @brief refine the pose of a camera rig by minimizing the reprojection error in
  * each camera with the bundle adjustment.
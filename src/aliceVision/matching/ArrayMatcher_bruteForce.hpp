@@ -68,11 +68,7 @@ class ArrayMatcher_bruteForce  : public ArrayMatcher<Scalar, Metric>
       Eigen::Map<BaseMat> mat_query((Scalar*)query, 1, (*memMapping).cols() );
       Metric metric;
       std::vector<DistanceType> vec_dist((*memMapping).rows(), 0.0);
-    for (int i = 0; i < (*memMapping).rows(); ++i)
-    {
-        // Compute Distance Metric
-        vec_dist[i] = metric( (Scalar*)query, (*memMapping).row(i).data(), (*memMapping).cols() );
-      }
+      computeRowDistances(metric, (const Scalar*)query, (*memMapping).data(), vec_dist, 0);
       if (!vec_dist.empty())
       {
         // Find the minimum distance :
@@ -126,13 +122,7 @@ class ArrayMatcher_bruteForce  : public ArrayMatcher<Scalar, Metric>
     {
       std::vector<DistanceType> vec_distance((*memMapping).rows(), 0.0);
       const Scalar * queryPtr = mat_query.row(queryIndex).data();
-      const Scalar * rowPtr = (*memMapping).data();
-      for (int i = 0; i < (*memMapping).rows(); ++i)
-      {
-        vec_distance[i] = metric( queryPtr,
-          rowPtr, (*memMapping).cols() );
-        rowPtr += (*memMapping).cols();
-      }
+      computeRowDistances(metric, queryPtr, (*memMapping).data(), vec_distance, 0);
 
       // Find the N minimum distances:
       const int maxMinFound = (int) std::min( size_t(NN), vec_distance.size());
@@ -150,6 +140,40 @@ class ArrayMatcher_bruteForce  : public ArrayMatcher<Scalar, Metric>
   };
 
 private:
+
+  /**
+   * Compute the distances between a query descriptor and all the rows of
+   * the dataset. This overload is selected for metrics providing a
+   * blockedDistances() kernel (e.g. Hamming): the dataset is streamed by
+   * blocks of Metric::blockSize descriptors against the same query.
+   */
+  template <typename M>
+  inline auto computeRowDistances(const M& metric, const Scalar* queryPtr, const Scalar* rowPtr,
+                                  std::vector<typename M::ResultType>& vec_distance, int) const
+    -> decltype(metric.blockedDistances(queryPtr, rowPtr, size_t(0), vec_distance.data()), void())
+  {
+    const int nbRows = (*memMapping).rows();
+    const int dimension = (*memMapping).cols();
+    const int blockSize = static_cast<int>(M::blockSize);
+    int i = 0;
+    for (; i + blockSize <= nbRows; i += blockSize, rowPtr += blockSize * dimension)
+      metric.blockedDistances(queryPtr, rowPtr, dimension, &vec_distance[i]);
+    for (; i < nbRows; ++i, rowPtr += dimension)
+      vec_distance[i] = metric(queryPtr, rowPtr, dimension);
+  }
+
+  /// Generic fallback: one metric evaluation per dataset row.
+  template <typename M>
+  inline void computeRowDistances(const M& metric, const Scalar* queryPtr, const Scalar* rowPtr,
+                                  std::vector<typename M::ResultType>& vec_distance, long) const
+  {
+    for (int i = 0; i < (*memMapping).rows(); ++i)
+    {
+      vec_distance[i] = metric(queryPtr, rowPtr, (*memMapping).cols());
+      rowPtr += (*memMapping).cols();
+    }
+  }
+
   typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
   /// Use a memory mapping in order to avoid memory re-allocation
   std::unique_ptr< Eigen::Map<BaseMat> > memMapping;
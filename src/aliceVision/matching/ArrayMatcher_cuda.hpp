@@ -0,0 +1,162 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "aliceVision/matching/ArrayMatcher.hpp"
+#include "aliceVision/matching/metric.hpp"
+#include "aliceVision/matching/cuda/bruteForceMatcherCuda.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * @brief Exhaustive GPU matcher (squared L2 distance).
+ *
+ * The database descriptors are converted to float once at Build() time and
+ * batched by descriptor tiles onto the GPU. When several CUDA devices are
+ * available, the query set is split evenly and the devices are driven in
+ * parallel. Results are identical to ArrayMatcher_bruteForce with an L2
+ * metric.
+ */
+template < typename Scalar = float, typename Metric = L2_Simple<Scalar> >
+class ArrayMatcher_cuda : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+  typedef typename Metric::ResultType DistanceType;
+
+  ArrayMatcher_cuda() {}
+  virtual ~ArrayMatcher_cuda() {}
+
+  /**
+   * Build the matching structure
+   *
+   * \param[in] dataset   Input data.
+   * \param[in] nbRows    The number of component.
+   * \param[in] dimension Length of the data contained in the dataset.
+   *
+   * \return True if success.
+   */
+  bool Build(const Scalar * dataset, int nbRows, int dimension)
+  {
+    if (nbRows < 1 || cuda::getDeviceCount() < 1)
+      return false;
+
+    _dimension = dimension;
+    _dataset.resize(size_t(nbRows) * dimension);
+    std::copy(dataset, dataset + _dataset.size(), _dataset.begin());
+    return true;
+  }
+
+  /**
+   * Search the nearest Neighbor of the scalar array query.
+   *
+   * \param[in]   query     The query array
+   * \param[out]  indice    The indice of array in the dataset that
+   *  have been computed as the nearest array.
+   * \param[out]  distance  The distance between the two arrays.
+   *
+   * \return True if success.
+   */
+  bool SearchNeighbour( const Scalar * query,
+                        int * indice, DistanceType * distance)
+  {
+    if (_dataset.empty())
+      return false;
+
+    std::vector<float> queryFloat(query, query + _dimension);
+    int foundIndex = -1;
+    float foundDistance = 0.f;
+
+    if (!cuda::bruteForceKnnL2(0, _dataset.data(), int(_dataset.size() / _dimension),
+                               queryFloat.data(), 1, _dimension, 1,
+                               &foundIndex, &foundDistance))
+      return false;
+
+    *indice = foundIndex;
+    *distance = static_cast<DistanceType>(foundDistance);
+    return true;
+  }
+
+  /**
+   * Search the N nearest Neighbor of the scalar array query.
+   *
+   * \param[in]   query     The query array
+   * \param[in]   nbQuery   The number of query rows
+   * \param[out]  indices   The corresponding (query, neighbor) indices
+   * \param[out]  distances The distances between the matched arrays.
+   * \param[out]  NN        The number of maximal neighbor that will be searched.
+   *
+   * \return True if success.
+   */
+  bool SearchNeighbours
+  (
+    const Scalar * query, int nbQuery,
+    IndMatches * pvec_indices,
+    std::vector<DistanceType> * pvec_distances,
+    size_t NN
+  )
+  {
+    const int nbRows = _dataset.empty() ? 0 : int(_dataset.size() / _dimension);
+
+    if (nbRows < 1 || nbQuery < 1)
+      return false;
+
+    if (NN > size_t(nbRows) || NN > size_t(cuda::BRUTE_FORCE_CUDA_MAX_NN))
+      return false;
+
+    std::vector<float> queriesFloat(query, query + size_t(nbQuery) * _dimension);
+    std::vector<int> foundIndices(size_t(nbQuery) * NN);
+    std::vector<float> foundDistances(size_t(nbQuery) * NN);
+
+    // split the query set across the available CUDA devices
+    const int nbDevices = std::min(cuda::getDeviceCount(), nbQuery);
+    bool success = true;
+
+    #pragma omp parallel for num_threads(nbDevices) schedule(static) reduction(&&:success)
+    for (int deviceId = 0; deviceId < nbDevices; ++deviceId)
+    {
+      const int queryStart = deviceId * nbQuery / nbDevices;
+      const int queryEnd = (deviceId + 1) * nbQuery / nbDevices;
+
+      success = success && cuda::bruteForceKnnL2(deviceId,
+          _dataset.data(), nbRows,
+          queriesFloat.data() + size_t(queryStart) * _dimension, queryEnd - queryStart,
+          _dimension, int(NN),
+          foundIndices.data() + size_t(queryStart) * NN,
+          foundDistances.data() + size_t(queryStart) * NN);
+    }
+
+    if (!success)
+      return false;
+
+    pvec_indices->reserve(size_t(nbQuery) * NN);
+    pvec_distances->reserve(size_t(nbQuery) * NN);
+
+    for (int queryIndex = 0; queryIndex < nbQuery; ++queryIndex)
+    {
+      for (size_t k = 0; k < NN; ++k)
+      {
+        pvec_indices->emplace_back(queryIndex, foundIndices[size_t(queryIndex) * NN + k]);
+        pvec_distances->emplace_back(static_cast<DistanceType>(foundDistances[size_t(queryIndex) * NN + k]));
+      }
+    }
+    return true;
+  }
+
+private:
+  /// Database descriptors, converted to float for the GPU kernels
+  std::vector<float> _dataset;
+  int _dimension = 0;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
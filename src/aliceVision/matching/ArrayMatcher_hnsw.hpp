@@ -0,0 +1,394 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/matching/ArrayMatcher.hpp>
+#include <aliceVision/matching/metric.hpp>
+#include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+/// Implement ArrayMatcher as a Hierarchical Navigable Small World graph matcher.
+// "Efficient and robust approximate nearest neighbor search using Hierarchical
+// Navigable Small World graphs", Y. Malkov, D. Yashunin.
+//
+// Contrary to the FLANN kd-trees, the search cost grows logarithmically with
+// the number of descriptors, which makes it suitable for views with a very
+// large number of features (aerial datasets).
+//
+// By default use squared L2 metric, as the other scalar matchers.
+
+template < typename Scalar = float, typename Metric = L2_Simple<Scalar> >
+class ArrayMatcher_hnsw : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+  typedef typename Metric::ResultType DistanceType;
+
+  /**
+   * @param[in] M              Number of links per node per layer (level 0 uses 2*M).
+   * @param[in] efConstruction Size of the candidate list used at build time.
+   * @param[in] efSearch       Size of the candidate list used at query time.
+   */
+  ArrayMatcher_hnsw(int M = 16, int efConstruction = 100, int efSearch = 128)
+    : _M(M)
+    , _efConstruction(efConstruction)
+    , _efSearch(efSearch)
+    , _levelMult(1.0 / std::log(double(M)))
+  {}
+
+  virtual ~ArrayMatcher_hnsw() = default;
+
+  /**
+   * Build the matching structure
+   *
+   * \param[in] dataset   Input data.
+   * \param[in] nbRows    The number of component.
+   * \param[in] dimension Length of the data contained in the each
+   *  row of the dataset.
+   *
+   * \return True if success.
+   */
+  bool Build(const Scalar * dataset, int nbRows, int dimension)
+  {
+    if (nbRows <= 0)
+      return false;
+
+    _dataset = dataset;
+    _nbRows = nbRows;
+    _dimension = dimension;
+    _entryPoint = -1;
+    _maxLevel = -1;
+    _links.clear();
+    _links.resize(nbRows);
+
+    // fixed seed: the graph (and so the matching output) is the same across runs
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+
+    SearchContext context(nbRows);
+
+    for (int i = 0; i < nbRows; ++i)
+    {
+      // draw the maximum layer of the node with an exponentially decaying probability
+      const int level = int(-std::log(std::max(dis(gen), 1e-12)) * _levelMult);
+      insert(i, level, context);
+    }
+    return true;
+  }
+
+  /**
+   * Search the nearest Neighbor of the scalar array query.
+   *
+   * \param[in]   query     The query array
+   * \param[out]  indice    The indice of array in the dataset that
+   *  have been computed as the nearest array.
+   * \param[out]  distance  The distance between the two arrays.
+   *
+   * \return True if success.
+   */
+  bool SearchNeighbour( const Scalar * query, int * indice, DistanceType * distance)
+  {
+    if (_entryPoint < 0)
+      return false;
+
+    SearchContext context(_nbRows);
+    std::vector<std::pair<DistanceType, int> > found;
+    search(query, 1, context, found);
+    if (found.empty())
+      return false;
+
+    *indice = found.front().second;
+    *distance = found.front().first;
+    return true;
+  }
+
+  /**
+   * Search the N nearest Neighbor of the scalar array query.
+   *
+   * \param[in]   query           The query array
+   * \param[in]   nbQuery         The number of query rows
+   * \param[out]  pvec_indices    The corresponding (query, neighbor) indices
+   * \param[out]  pvec_distances  The distances between the matched arrays.
+   * \param[out]  NN              The number of maximal neighbor that will be searched.
+   *
+   * \return True if success.
+   */
+  bool SearchNeighbours
+  (
+    const Scalar * query, int nbQuery,
+    IndMatches * pvec_indices,
+    std::vector<DistanceType> * pvec_distances,
+    size_t NN
+  )
+  {
+    if (_entryPoint < 0 || NN > size_t(_nbRows))
+      return false;
+
+    std::vector<int> vec_indices(nbQuery * NN, -1);
+    std::vector<DistanceType> vec_distances(nbQuery * NN);
+
+    #pragma omp parallel
+    {
+      SearchContext context(_nbRows);
+      std::vector<std::pair<DistanceType, int> > found;
+
+      #pragma omp for schedule(dynamic, 16)
+      for (int i = 0; i < nbQuery; ++i)
+      {
+        search(query + size_t(i) * _dimension, NN, context, found);
+        for (size_t j = 0; j < NN; ++j)
+        {
+          // the downstream ratio test expects exactly NN entries per query,
+          // pad with the farthest found node in the unlikely short case
+          const std::pair<DistanceType, int>& f = found[std::min(j, found.size() - 1)];
+          vec_indices[i * NN + j] = f.second;
+          vec_distances[i * NN + j] = f.first;
+        }
+      }
+    }
+
+    // Save the resulting found indices
+    pvec_indices->reserve(nbQuery * NN);
+    pvec_distances->reserve(nbQuery * NN);
+    for (int i = 0; i < nbQuery; ++i)
+    {
+      for (size_t j = 0; j < NN; ++j)
+      {
+        if (vec_indices[i * NN + j] < 0)
+          continue;
+        pvec_indices->emplace_back(i, vec_indices[i * NN + j]);
+        pvec_distances->emplace_back(vec_distances[i * NN + j]);
+      }
+    }
+    return true;
+  }
+
+  private:
+
+  // (distance, node) pair ordered structures:
+  // min-heap for the candidates to expand, max-heap for the results to keep
+  typedef std::pair<DistanceType, int> HeapEntry;
+  typedef std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > MinHeap;
+  typedef std::priority_queue<HeapEntry> MaxHeap;
+
+  // Per search scratch data: the visited flags are tagged with a generation
+  // counter so they do not need to be cleared between two searches.
+  struct SearchContext
+  {
+    explicit SearchContext(int nbRows)
+      : visited(nbRows, 0)
+      , tag(0)
+    {}
+
+    void newSearch() { ++tag; }
+    bool isVisited(int node) const { return visited[node] == tag; }
+    void setVisited(int node) { visited[node] = tag; }
+
+    std::vector<std::uint32_t> visited;
+    std::uint32_t tag;
+  };
+
+  DistanceType distance(const Scalar * query, int node) const
+  {
+    Metric metric;
+    return metric(query, _dataset + size_t(node) * _dimension, _dimension);
+  }
+
+  const std::vector<int>& neighbors(int node, int level) const
+  {
+    return _links[node][level];
+  }
+
+  // Greedy descent on one layer: move to the closest neighbor until no
+  // neighbor improves the distance.
+  int greedySearch(const Scalar * query, int entry, int level, DistanceType & entryDist) const
+  {
+    int current = entry;
+    bool changed = true;
+    while (changed)
+    {
+      changed = false;
+      for (const int neighbor : neighbors(current, level))
+      {
+        const DistanceType d = distance(query, neighbor);
+        if (d < entryDist)
+        {
+          entryDist = d;
+          current = neighbor;
+          changed = true;
+        }
+      }
+    }
+    return current;
+  }
+
+  // Beam search on one layer, keeping the ef closest nodes found.
+  void searchLayer
+  (
+    const Scalar * query,
+    int entry,
+    DistanceType entryDist,
+    int level,
+    size_t ef,
+    SearchContext & context,
+    MaxHeap & results
+  ) const
+  {
+    context.newSearch();
+    context.setVisited(entry);
+
+    MinHeap candidates;
+    candidates.emplace(entryDist, entry);
+    results.emplace(entryDist, entry);
+
+    while (!candidates.empty())
+    {
+      const HeapEntry candidate = candidates.top();
+      if (candidate.first > results.top().first && results.size() >= ef)
+        break;
+      candidates.pop();
+
+      for (const int neighbor : neighbors(candidate.second, level))
+      {
+        if (context.isVisited(neighbor))
+          continue;
+        context.setVisited(neighbor);
+
+        const DistanceType d = distance(query, neighbor);
+        if (results.size() < ef || d < results.top().first)
+        {
+          candidates.emplace(d, neighbor);
+          results.emplace(d, neighbor);
+          if (results.size() > ef)
+            results.pop();
+        }
+      }
+    }
+  }
+
+  // Keep the M closest nodes of a candidate heap, closest first.
+  static void selectClosest(MaxHeap & candidates, size_t M, std::vector<HeapEntry> & selection)
+  {
+    while (candidates.size() > M)
+      candidates.pop();
+    selection.resize(candidates.size());
+    for (std::size_t i = candidates.size(); i > 0; --i)
+    {
+      selection[i - 1] = candidates.top();
+      candidates.pop();
+    }
+  }
+
+  void insert(int node, int level, SearchContext & context)
+  {
+    _links[node].resize(level + 1);
+
+    if (_entryPoint < 0)
+    {
+      _entryPoint = node;
+      _maxLevel = level;
+      return;
+    }
+
+    int entry = _entryPoint;
+    DistanceType entryDist = distance(_dataset + size_t(node) * _dimension, entry);
+
+    // greedy descent through the layers above the node level
+    for (int l = _maxLevel; l > level; --l)
+      entry = greedySearch(_dataset + size_t(node) * _dimension, entry, l, entryDist);
+
+    // link the node on each of its layers
+    std::vector<HeapEntry> selection;
+    for (int l = std::min(level, _maxLevel); l >= 0; --l)
+    {
+      MaxHeap results;
+      searchLayer(_dataset + size_t(node) * _dimension, entry, entryDist, l, _efConstruction, context, results);
+
+      const size_t maxM = (l == 0) ? size_t(2 * _M) : size_t(_M);
+      selectClosest(results, size_t(_M), selection);
+
+      // restart the next layer from the closest node found on this one
+      entry = selection.front().second;
+      entryDist = selection.front().first;
+
+      std::vector<int>& nodeLinks = _links[node][l];
+      nodeLinks.reserve(selection.size());
+      for (const HeapEntry& selected : selection)
+      {
+        nodeLinks.push_back(selected.second);
+
+        // add the back link and shrink the neighbor list if it exceeds maxM
+        std::vector<int>& backLinks = _links[selected.second][l];
+        backLinks.push_back(node);
+        if (backLinks.size() > maxM)
+        {
+          MaxHeap backCandidates;
+          for (const int backLink : backLinks)
+            backCandidates.emplace(distance(_dataset + size_t(selected.second) * _dimension, backLink), backLink);
+
+          std::vector<HeapEntry> backSelection;
+          selectClosest(backCandidates, maxM, backSelection);
+          backLinks.clear();
+          for (const HeapEntry& backSelected : backSelection)
+            backLinks.push_back(backSelected.second);
+        }
+      }
+    }
+
+    if (level > _maxLevel)
+    {
+      _entryPoint = node;
+      _maxLevel = level;
+    }
+  }
+
+  void search
+  (
+    const Scalar * query,
+    size_t NN,
+    SearchContext & context,
+    std::vector<std::pair<DistanceType, int> > & found
+  ) const
+  {
+    int entry = _entryPoint;
+    DistanceType entryDist = distance(query, entry);
+
+    for (int l = _maxLevel; l > 0; --l)
+      entry = greedySearch(query, entry, l, entryDist);
+
+    MaxHeap results;
+    searchLayer(query, entry, entryDist, 0, std::max(size_t(_efSearch), NN), context, results);
+    selectClosest(results, NN, found);
+  }
+
+  const Scalar * _dataset = nullptr;
+  int _nbRows = 0;
+  int _dimension = 0;
+
+  int _M;
+  int _efConstruction;
+  int _efSearch;
+  double _levelMult;
+
+  // _links[node][level] = neighbor node indices
+  std::vector<std::vector<std::vector<int> > > _links;
+  int _entryPoint = -1;
+  int _maxLevel = -1;
+};
+
+} // namespace matching
+} // namespace aliceVision
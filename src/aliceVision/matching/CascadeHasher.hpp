@@ -73,12 +73,16 @@ private:
 public:
   CascadeHasher() {}
 
-  // Creates the hashing projections (cascade of two level of hash codes)
+  // Creates the hashing projections (cascade of two level of hash codes).
+  // The random generator is seeded with a fixed value so that the projections
+  // are identical across runs and processes: hashed descriptions computed once
+  // can be cached and reused (see ImageCollectionMatcher_cascadeHashing).
   bool Init
   (
     const uint8_t nb_hash_code = 128,
     const uint8_t nb_bucket_groups = 6,
-    const uint8_t nb_bits_per_bucket = 10)
+    const uint8_t nb_bits_per_bucket = 10,
+    const unsigned int seed = 57)
   {
     nb_bucket_groups_= nb_bucket_groups;
     nb_hash_code_ = nb_hash_code;
@@ -89,8 +93,7 @@ public:
     // Box Muller transform is used in the original paper to get fast random number
     // from a normal distribution with <mean = 0> and <variance = 1>.
     // Here we use C++11 normal distribution random number generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seed);
     std::normal_distribution<> d(0,1);
 
     primary_hash_projection_.resize(nb_hash_code, nb_hash_code);
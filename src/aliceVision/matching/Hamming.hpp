@@ -23,6 +23,11 @@ typedef unsigned __int64 uint64_t;
 #include "arm_neon.h"
 #endif
 
+#if defined __POPCNT__ || defined __SSE4_2__ || defined __AVX2__
+#define ALICEVISION_HARDWARE_POPCNT
+#include <nmmintrin.h>
+#endif
+
 // Brief:
 // Hamming distance count the number of bits in common between descriptors
 //  by using a XOR operation + a count.
@@ -84,6 +89,9 @@ struct Hamming
 #ifdef _MSC_VER
     return __popcnt(n);
 #else
+#ifdef ALICEVISION_HARDWARE_POPCNT
+    return _mm_popcnt_u32(n);
+#endif
 #if (defined __GNUC__ || defined __clang__)
     return __builtin_popcountl(n);
 #endif
@@ -98,6 +106,9 @@ struct Hamming
 #if defined _MSC_VER && defined PLATFORM_64_BIT
     return __popcnt64(n);
 #else
+#if defined ALICEVISION_HARDWARE_POPCNT && defined PLATFORM_64_BIT
+    return _mm_popcnt_u64(n);
+#endif
 #if (defined __GNUC__ || defined __clang__)
     return __builtin_popcountll(n);
 #endif
@@ -164,6 +175,45 @@ struct Hamming
 #endif // PLATFORM_64_BIT
     return result;
   }
+
+  /// Number of database descriptors processed per blockedDistances() call
+  static const std::size_t blockSize = 8;
+
+  /**
+   * @brief Compute the Hamming distances between one query descriptor and a
+   * block of 8 database descriptors stored contiguously in memory (row major).
+   * Each query word is loaded once and streamed against the 8 rows, which
+   * keeps the XOR + popcount units busy instead of re-reading the query for
+   * every single pair.
+   * @param[in] a The query descriptor
+   * @param[in] b The first descriptor of the database block
+   * @param[in] size Number of ElementType per descriptor
+   * @param[out] results The 8 computed distances
+   */
+  template <typename Iterator1, typename Iterator2>
+  inline void blockedDistances(Iterator1 a, Iterator2 b, size_t size, ResultType* results) const
+  {
+#ifdef PLATFORM_64_BIT
+    if(size % sizeof(uint64_t) == 0)
+    {
+      const size_t nbWords = size / sizeof(uint64_t);
+      const uint64_t* pa = reinterpret_cast<const uint64_t*>(a);
+      const uint64_t* pb = reinterpret_cast<const uint64_t*>(b);
+      ResultType acc[blockSize] = {0, 0, 0, 0, 0, 0, 0, 0};
+      for(size_t w = 0; w < nbWords; ++w)
+      {
+        const uint64_t qa = pa[w];
+        for(size_t r = 0; r < blockSize; ++r)
+          acc[r] += popcnt64(qa ^ pb[r * nbWords + w]);
+      }
+      for(size_t r = 0; r < blockSize; ++r)
+        results[r] = acc[r];
+      return;
+    }
+#endif // PLATFORM_64_BIT
+    for(size_t r = 0; r < blockSize; ++r)
+      results[r] = (*this)(a, b + r * size, size);
+  }
 };
 
 
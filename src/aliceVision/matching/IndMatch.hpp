@@ -9,7 +9,10 @@
 
 #include <aliceVision/types.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/stl/FlatMap.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <set>
@@ -57,8 +60,13 @@ struct IndMatch
   static bool getDeduplicated(std::vector<IndMatch> & vec_match)
   {
     const size_t sizeBefore = vec_match.size();
-    std::set<IndMatch> set_deduplicated( vec_match.begin(), vec_match.end());
-    vec_match.assign(set_deduplicated.begin(), set_deduplicated.end());
+    // in-place sort on the (_i, _j) pair packed in a 64 bit key, then unique:
+    // no temporary std::set allocation
+    std::sort(vec_match.begin(), vec_match.end(),
+      [](const IndMatch& m1, const IndMatch& m2) {
+        return ((std::uint64_t(m1._i) << 32) | m1._j) < ((std::uint64_t(m2._i) << 32) | m2._j);
+      });
+    vec_match.erase(std::unique(vec_match.begin(), vec_match.end()), vec_match.end());
     return sizeBefore != vec_match.size();
   }
 
@@ -99,12 +107,27 @@ struct MatchesPerDescType: public std::map<feature::EImageDescriberType, IndMatc
     }
 };
 
+/// Compare image pairs on their packed 64-bit id: a single comparison instead of
+/// the two of the lexicographical std::pair ordering, with the same result.
+struct PairPackedCompare
+{
+    bool operator()(const Pair& a, const Pair& b) const
+    {
+        return ((std::uint64_t(a.first) << 32) | a.second) < ((std::uint64_t(b.first) << 32) | b.second);
+    }
+};
+
 /// Pairwise matches (indexed matches for a pair <I,J>)
 /// The structure used to store corresponding point indexes per images pairs
+///
+/// Stored in a sorted flat container: iteration order stays the one of the former
+/// std::map (the save paths rely on it), but lookups scan a contiguous vector
+/// instead of chasing red-black tree nodes and the container does not pay one
+/// allocation per pair.
 
-typedef std::map<Pair, MatchesPerDescType> PairwiseMatches;
+typedef stl::flat_map<Pair, MatchesPerDescType, PairPackedCompare> PairwiseMatches;
 
-typedef std::map<Pair, IndMatches> PairwiseSimpleMatches;
+typedef stl::flat_map<Pair, IndMatches, PairPackedCompare> PairwiseSimpleMatches;
 
 inline PairSet getImagePairs(const PairwiseMatches & matches)
 {
@@ -11,65 +11,35 @@
 #include "aliceVision/matching/IndMatch.hpp"
 #include "aliceVision/feature/feature.hpp"
 
+#include <algorithm>
+#include <array>
+#include <functional>
+
 namespace aliceVision {
 namespace matching {
 
 /// IndMatch decorator.
-/// Use sorting over x,y coordinates.
+/// Use sorting over x,y coordinates to remove the matches that share a
+/// feature position. The dedup is done in-place on the match vector, the
+/// feature containers are only referenced and must outlive the decorator.
 template<class T = float>
 class IndMatchDecorator
 {
-  struct IndMatchDecoratorStruct
-  {
-    IndMatchDecoratorStruct(
-      T xa, T ya,
-      T xb, T yb,
-      const IndMatch & ind) {
-
-      x1 = xa; y1 = ya;
-      x2 = xb; y2 = yb;
-      index = ind;
-    }
-
-    /// Lexicographical ordering of matches. Used to remove duplicates.
-    friend bool operator<(const IndMatchDecoratorStruct& m1,
-      const IndMatchDecoratorStruct& m2)  {
-
-      if (m1 == m2) return false;
-
-      if (m1.x1 < m2.x1)
-        return m1.y1 < m2.y1;
-      else
-        if (m1.x1 > m2.x1)
-          return m1.y1 < m2.y1;
-      return m1.x1 < m2.x1;
-    }
-
-    /// Comparison Operator
-    friend bool operator==(const IndMatchDecoratorStruct& m1,
-      const IndMatchDecoratorStruct& m2)  {
-
-      return (m1.x1==m2.x1 && m1.y1==m2.y1 &&
-        m1.x2==m2.x2 && m1.y2==m2.y2);
-    }
-
-    T x1,y1, x2,y2;
-    IndMatch index;
-  };
 public:
 
+  /// Feature positions of a match: (x1, y1, x2, y2)
+  typedef std::array<T, 4> MatchPosition;
+
   IndMatchDecorator(const std::vector<IndMatch> & vec_matches,
     const std::vector<feature::SIOPointFeature> & leftFeat,
     const std::vector<feature::SIOPointFeature> & rightFeat)
     :_vec_matches(vec_matches)
   {
-    for (size_t i = 0; i < vec_matches.size(); ++i) {
-      const size_t I = vec_matches[i]._i;
-      const size_t J = vec_matches[i]._j;
-      _vecDecoredMatches.push_back(
-        IndMatchDecoratorStruct(leftFeat[I].x(),leftFeat[I].y(),
-        rightFeat[J].x(), rightFeat[J].y(), vec_matches[i]));
-    }
+    _position = [&leftFeat, &rightFeat](const IndMatch & m) -> MatchPosition
+    {
+      return MatchPosition{{leftFeat[m._i].x(), leftFeat[m._i].y(),
+                            rightFeat[m._j].x(), rightFeat[m._j].y()}};
+    };
   }
 
   IndMatchDecorator(const std::vector<IndMatch> & vec_matches,
@@ -77,13 +47,11 @@ public:
     const std::vector<feature::PointFeature> & rightFeat)
     :_vec_matches(vec_matches)
   {
-    for (size_t i = 0; i < vec_matches.size(); ++i) {
-      const size_t I = vec_matches[i]._i;
-      const size_t J = vec_matches[i]._j;
-      _vecDecoredMatches.push_back(
-        IndMatchDecoratorStruct(leftFeat[I].x(),leftFeat[I].y(),
-        rightFeat[J].x(), rightFeat[J].y(), vec_matches[i]));
-    }
+    _position = [&leftFeat, &rightFeat](const IndMatch & m) -> MatchPosition
+    {
+      return MatchPosition{{leftFeat[m._i].x(), leftFeat[m._i].y(),
+                            rightFeat[m._j].x(), rightFeat[m._j].y()}};
+    };
   }
 
   IndMatchDecorator(const std::vector<IndMatch> & vec_matches,
@@ -91,28 +59,31 @@ public:
     const Mat & rightFeat)
     :_vec_matches(vec_matches)
   {
-    for (size_t i = 0; i < vec_matches.size(); ++i) {
-      const size_t I = vec_matches[i]._i;
-      const size_t J = vec_matches[i]._j;
-      _vecDecoredMatches.push_back(
-        IndMatchDecoratorStruct(leftFeat.col(I)(0),leftFeat.col(I)(1),
-        rightFeat.col(J)(0), rightFeat.col(J)(1), vec_matches[i]));
-    }
+    _position = [&leftFeat, &rightFeat](const IndMatch & m) -> MatchPosition
+    {
+      return MatchPosition{{static_cast<T>(leftFeat.col(m._i)(0)), static_cast<T>(leftFeat.col(m._i)(1)),
+                            static_cast<T>(rightFeat.col(m._j)(0)), static_cast<T>(rightFeat.col(m._j)(1))}};
+    };
   }
 
   /// Remove duplicates (same (x1,y1) coords that appears multiple times)
   size_t getDeduplicated(std::vector<IndMatch> & vec_matches)
   {
-    size_t sizeBefore = _vecDecoredMatches.size();
-    std::set<IndMatchDecoratorStruct> set_deduplicated(
-      _vecDecoredMatches.begin(),_vecDecoredMatches.end());
-    _vecDecoredMatches.assign(set_deduplicated.begin(), set_deduplicated.end());
-
-    vec_matches.resize(_vecDecoredMatches.size());
-    for (size_t i = 0; i < _vecDecoredMatches.size(); ++i)  {
-      const IndMatch & idxM = _vecDecoredMatches[i].index;
-      vec_matches[i] = idxM;
-    }
+    const size_t sizeBefore = vec_matches.size();
+
+    // sort the matches on their feature positions and unique them in-place:
+    // no decorated copy of the matches and no temporary std::set
+    const std::function<MatchPosition(const IndMatch&)>& position = _position;
+    std::sort(vec_matches.begin(), vec_matches.end(),
+      [&position](const IndMatch & m1, const IndMatch & m2) {
+        return position(m1) < position(m2);
+      });
+    vec_matches.erase(
+      std::unique(vec_matches.begin(), vec_matches.end(),
+        [&position](const IndMatch & m1, const IndMatch & m2) {
+          return position(m1) == position(m2);
+        }),
+      vec_matches.end());
 
     return sizeBefore != vec_matches.size();
   }
@@ -126,20 +97,20 @@ public:
     bool saveMatch(const char* nameFile) const  {
       std::ofstream f(nameFile);
       if( f.is_open() ) {
-        std::copy(_vecDecoredMatches.begin(), _vecDecoredMatches.end(),
-          std::ostream_iterator<IndMatchDecoratorStruct>(f, ""));
+        for (const IndMatch & m: _vec_matches) {
+          const MatchPosition position = _position(m);
+          f << position[0] << " " << position[1] << " "
+            << position[2] << " " << position[3] << "\n";
+        }
       }
       return f.is_open();
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const IndMatchDecoratorStruct & m)
-    {
-      return os << m.x1 << " " << m.y1 << " " << m.x2 << " " << m.y2 << "\n";
-    }
-
 private :
-  std::vector<IndMatch> _vec_matches;
-  std::vector<IndMatchDecoratorStruct> _vecDecoredMatches;
+  /// matches given at construction (only referenced, used by saveMatch)
+  const std::vector<IndMatch> & _vec_matches;
+  /// return the feature positions of a match
+  std::function<MatchPosition(const IndMatch&)> _position;
 };
 
 }  // namespace matching
@@ -9,8 +9,13 @@
 #include "aliceVision/matching/RegionsMatcher.hpp"
 #include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
 #include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
+#include "aliceVision/matching/ArrayMatcher_hnsw.hpp"
 #include "aliceVision/matching/ArrayMatcher_cascadeHashing.hpp"
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+#include "aliceVision/matching/ArrayMatcher_cuda.hpp"
+#endif //ALICEVISION_HAVE_CUDA
+
 #include <aliceVision/system/Logger.hpp>
 
 namespace aliceVision {
@@ -87,6 +92,13 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(const feature::Regions & r
           out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
         }
         break;
+        case HNSW_L2:
+        {
+          typedef L2_Vectorized<unsigned char> MetricT;
+          typedef ArrayMatcher_hnsw<unsigned char, MetricT> MatcherT;
+          out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
+        }
+        break;
         case CASCADE_HASHING_L2:
         {
           typedef L2_Vectorized<unsigned char> MetricT;
@@ -94,6 +106,17 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(const feature::Regions & r
           out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
         }
         break;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+        case BRUTE_FORCE_CUDA_L2:
+        {
+          typedef L2_Vectorized<unsigned char> MetricT;
+          typedef ArrayMatcher_cuda<unsigned char, MetricT> MatcherT;
+          out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
+        }
+        break;
+#endif //ALICEVISION_HAVE_CUDA
+
         default:
           ALICEVISION_LOG_WARNING("Using unknown matcher type");
       }
@@ -116,6 +139,13 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(const feature::Regions & r
           out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
         }
         break;
+        case HNSW_L2:
+        {
+          typedef L2_Vectorized<float> MetricT;
+          typedef ArrayMatcher_hnsw<float, MetricT> MatcherT;
+          out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
+        }
+        break;
         case CASCADE_HASHING_L2:
         {
           typedef L2_Vectorized<float> MetricT;
@@ -123,6 +153,17 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(const feature::Regions & r
           out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
         }
         break;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+        case BRUTE_FORCE_CUDA_L2:
+        {
+          typedef L2_Vectorized<float> MetricT;
+          typedef ArrayMatcher_cuda<float, MetricT> MatcherT;
+          out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
+        }
+        break;
+#endif //ALICEVISION_HAVE_CUDA
+
         default:
           ALICEVISION_LOG_WARNING("Using unknown matcher type");
       }
@@ -145,6 +186,13 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(const feature::Regions & r
           out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
         }
         break;
+        case HNSW_L2:
+        {
+          typedef L2_Vectorized<double> MetricT;
+          typedef ArrayMatcher_hnsw<double, MetricT> MatcherT;
+          out.reset(new matching::RegionsMatcher<MatcherT>(regions, true));
+        }
+        break;
         case CASCADE_HASHING_L2:
         {
           ALICEVISION_LOG_WARNING("Not yet implemented");
@@ -0,0 +1,160 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "bruteForceMatcherCuda.hpp"
+
+#include <cuda_runtime.h>
+
+#include <cfloat>
+
+namespace aliceVision {
+namespace matching {
+namespace cuda {
+
+#define BRUTE_FORCE_CUDA_BLOCK_SIZE 128
+// number of dataset descriptors staged in shared memory per tile,
+// bounded by the 48KB shared memory budget for 128 float components
+#define BRUTE_FORCE_CUDA_TILE_ROWS 64
+
+/**
+ * One thread per query descriptor. The dataset is processed by tiles: each
+ * tile of descriptors is loaded cooperatively into shared memory, then every
+ * thread accumulates the distances between its query (kept in registers /
+ * local memory) and all the rows of the tile, maintaining its K best
+ * candidates with an insertion sort.
+ */
+__global__ void knnL2Kernel(const float* dataset, int nbRows,
+                            const float* queries, int nbQueries,
+                            int dimension, int K,
+                            int* indices, float* distances)
+{
+    extern __shared__ float sharedTile[]; // BRUTE_FORCE_CUDA_TILE_ROWS * dimension
+
+    const int queryIndex = blockIdx.x * blockDim.x + threadIdx.x;
+
+    float bestDist[BRUTE_FORCE_CUDA_MAX_NN];
+    int bestIndex[BRUTE_FORCE_CUDA_MAX_NN];
+    for(int k = 0; k < K; ++k)
+    {
+        bestDist[k] = FLT_MAX;
+        bestIndex[k] = -1;
+    }
+
+    const float* query = (queryIndex < nbQueries) ? (queries + size_t(queryIndex) * dimension) : nullptr;
+
+    for(int tileStart = 0; tileStart < nbRows; tileStart += BRUTE_FORCE_CUDA_TILE_ROWS)
+    {
+        const int tileRows = min(BRUTE_FORCE_CUDA_TILE_ROWS, nbRows - tileStart);
+
+        // cooperative load of the tile
+        const int tileSize = tileRows * dimension;
+        for(int i = threadIdx.x; i < tileSize; i += blockDim.x)
+            sharedTile[i] = dataset[size_t(tileStart) * dimension + i];
+        __syncthreads();
+
+        if(query != nullptr)
+        {
+            for(int row = 0; row < tileRows; ++row)
+            {
+                const float* rowPtr = sharedTile + row * dimension;
+                float dist = 0.0f;
+                for(int d = 0; d < dimension; ++d)
+                {
+                    const float diff = query[d] - rowPtr[d];
+                    dist += diff * diff;
+                }
+
+                if(dist < bestDist[K - 1])
+                {
+                    // insertion sort into the K best candidates
+                    int k = K - 1;
+                    while(k > 0 && bestDist[k - 1] > dist)
+                    {
+                        bestDist[k] = bestDist[k - 1];
+                        bestIndex[k] = bestIndex[k - 1];
+                        --k;
+                    }
+                    bestDist[k] = dist;
+                    bestIndex[k] = tileStart + row;
+                }
+            }
+        }
+        __syncthreads();
+    }
+
+    if(queryIndex < nbQueries)
+    {
+        for(int k = 0; k < K; ++k)
+        {
+            indices[size_t(queryIndex) * K + k] = bestIndex[k];
+            distances[size_t(queryIndex) * K + k] = bestDist[k];
+        }
+    }
+}
+
+int getDeviceCount()
+{
+    int nbDevices = 0;
+    if(cudaGetDeviceCount(&nbDevices) != cudaSuccess)
+        return 0;
+    return nbDevices;
+}
+
+bool bruteForceKnnL2(int deviceId,
+                     const float* dataset, int nbRows,
+                     const float* queries, int nbQueries,
+                     int dimension, int K,
+                     int* indices, float* distances)
+{
+    if(K < 1 || K > BRUTE_FORCE_CUDA_MAX_NN || nbRows < 1 || nbQueries < 1)
+        return false;
+
+    if(cudaSetDevice(deviceId) != cudaSuccess)
+        return false;
+
+    float* d_dataset = nullptr;
+    float* d_queries = nullptr;
+    int* d_indices = nullptr;
+    float* d_distances = nullptr;
+
+    bool success =
+        (cudaMalloc(&d_dataset, size_t(nbRows) * dimension * sizeof(float)) == cudaSuccess) &&
+        (cudaMalloc(&d_queries, size_t(nbQueries) * dimension * sizeof(float)) == cudaSuccess) &&
+        (cudaMalloc(&d_indices, size_t(nbQueries) * K * sizeof(int)) == cudaSuccess) &&
+        (cudaMalloc(&d_distances, size_t(nbQueries) * K * sizeof(float)) == cudaSuccess);
+
+    if(success)
+    {
+        success =
+            (cudaMemcpy(d_dataset, dataset, size_t(nbRows) * dimension * sizeof(float), cudaMemcpyHostToDevice) == cudaSuccess) &&
+            (cudaMemcpy(d_queries, queries, size_t(nbQueries) * dimension * sizeof(float), cudaMemcpyHostToDevice) == cudaSuccess);
+    }
+
+    if(success)
+    {
+        const int nbBlocks = (nbQueries + BRUTE_FORCE_CUDA_BLOCK_SIZE - 1) / BRUTE_FORCE_CUDA_BLOCK_SIZE;
+        const size_t sharedMemSize = size_t(BRUTE_FORCE_CUDA_TILE_ROWS) * dimension * sizeof(float);
+
+        knnL2Kernel<<<nbBlocks, BRUTE_FORCE_CUDA_BLOCK_SIZE, sharedMemSize>>>(
+            d_dataset, nbRows, d_queries, nbQueries, dimension, K, d_indices, d_distances);
+
+        success =
+            (cudaGetLastError() == cudaSuccess) &&
+            (cudaMemcpy(indices, d_indices, size_t(nbQueries) * K * sizeof(int), cudaMemcpyDeviceToHost) == cudaSuccess) &&
+            (cudaMemcpy(distances, d_distances, size_t(nbQueries) * K * sizeof(float), cudaMemcpyDeviceToHost) == cudaSuccess);
+    }
+
+    cudaFree(d_dataset);
+    cudaFree(d_queries);
+    cudaFree(d_indices);
+    cudaFree(d_distances);
+
+    return success;
+}
+
+} // namespace cuda
+} // namespace matching
+} // namespace aliceVision
@@ -0,0 +1,49 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace matching {
+namespace cuda {
+
+/// Maximum number of nearest neighbors supported by bruteForceKnnL2()
+static const int BRUTE_FORCE_CUDA_MAX_NN = 16;
+
+/**
+ * @brief Get the number of available CUDA devices.
+ * @return number of devices, 0 if no device or no driver
+ */
+int getDeviceCount();
+
+/**
+ * @brief Exhaustive K nearest neighbors search (squared L2 distance) on one
+ * CUDA device. The dataset descriptors are streamed by tiles through shared
+ * memory while each thread keeps the K best candidates of its query in
+ * registers, so the search behaves like a blocked GEMM.
+ *
+ * @param[in] deviceId CUDA device to run on
+ * @param[in] dataset The database descriptors (nbRows x dimension, row major)
+ * @param[in] nbRows Number of database descriptors
+ * @param[in] queries The query descriptors (nbQueries x dimension, row major)
+ * @param[in] nbQueries Number of query descriptors
+ * @param[in] dimension Number of components per descriptor
+ * @param[in] K Number of neighbors to search (<= BRUTE_FORCE_CUDA_MAX_NN)
+ * @param[out] indices The nbQueries x K found database indices
+ * @param[out] distances The nbQueries x K corresponding squared distances
+ * @return true if the search succeeded
+ */
+bool bruteForceKnnL2(int deviceId,
+                     const float* dataset, int nbRows,
+                     const float* queries, int nbQueries,
+                     int dimension, int K,
+                     int* indices, float* distances);
+
+} // namespace cuda
+} // namespace matching
+} // namespace aliceVision
@@ -8,8 +8,15 @@
 #pragma once
 
 #include "aliceVision/matching/IndMatch.hpp"
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iterator>
 #include <set>
 #include <vector>
@@ -64,11 +71,138 @@ inline void NNdistanceRatio
     {
       vec_ratioOkIndex.push_back(static_cast<int>(i));
       if (vec_distanceRatio != nullptr)
-        vec_distanceRatio->push_back((*iter)/(*iter2)); 
+        vec_distanceRatio->push_back((*iter)/(*iter2));
     }
   }
 }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+
+namespace optim_avx2{
+
+  // Nearest neighbor distance ratio test over the contiguous (best, second)
+  // pair layout produced with NN == 2: 8 ratios are compared per iteration
+  // and the accepted indexes are compacted from the comparison mask.
+  inline void nnDistanceRatio_avx2(const float * distances,
+                                   std::size_t nbPairs,
+                                   std::vector<int> & vec_ratioOkIndex,
+                                   float fratio,
+                                   std::vector<float> * vec_distanceRatio)
+  {
+    const __m256 fratioV = _mm256_set1_ps(fratio);
+    std::size_t i = 0;
+    for(; i + 8 <= nbPairs; i += 8)
+    {
+      const float * d = distances + 2 * i;
+      const __m256 a = _mm256_loadu_ps(d);
+      const __m256 b = _mm256_loadu_ps(d + 8);
+      //-- De-interleave the 8 (best, second) pairs
+      const __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+      const __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+      const __m256 best = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m256 second = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+
+      const int mask = _mm256_movemask_ps(
+        _mm256_cmp_ps(best, _mm256_mul_ps(fratioV, second), _CMP_LT_OQ));
+      if(mask == 0)
+        continue;
+
+      float ratios[8];
+      _mm256_storeu_ps(ratios, _mm256_div_ps(best, second));
+      for(int lane = 0; lane < 8; ++lane)
+      {
+        if(mask & (1 << lane))
+        {
+          vec_ratioOkIndex.push_back(static_cast<int>(i) + lane);
+          if(vec_distanceRatio != nullptr)
+            vec_distanceRatio->push_back(ratios[lane]);
+        }
+      }
+    }
+    //-- Process the last 0-7 pairs
+    for(; i < nbPairs; ++i)
+    {
+      const float best = distances[2 * i];
+      const float second = distances[2 * i + 1];
+      if(best < fratio * second)
+      {
+        vec_ratioOkIndex.push_back(static_cast<int>(i));
+        if(vec_distanceRatio != nullptr)
+          vec_distanceRatio->push_back(best / second);
+      }
+    }
+  }
+
+} // namespace optim_avx2
+
+/**
+  * Nearest neighbor distance ratio filtering over a contiguous float
+  * sequence: the NN == 2 layout used by the descriptor matchers is filtered
+  * 8 ratios at a time, other strides fall back on the generic version.
+  */
+inline void NNdistanceRatio
+(
+  const float * first,
+  const float * last,
+  int NN,
+  std::vector<int> & vec_ratioOkIndex,
+  float fratio = 0.6f,
+  std::vector<float> * vec_distanceRatio = nullptr
+)
+{
+  assert( NN >= 2);
+
+  if (NN != 2)
+  {
+    NNdistanceRatio<const float*>(first, last, NN, vec_ratioOkIndex, fratio, vec_distanceRatio);
+    return;
+  }
+
+  const size_t nbPairs = std::distance(first, last) / 2;
+  vec_ratioOkIndex.clear();
+  vec_ratioOkIndex.reserve(nbPairs);
+  if (vec_distanceRatio != nullptr)
+  {
+    vec_distanceRatio->clear();
+    vec_distanceRatio->reserve(nbPairs);
+  }
+  optim_avx2::nnDistanceRatio_avx2(first, nbPairs, vec_ratioOkIndex, fratio, vec_distanceRatio);
+}
+
+/// Redirect the float vector iterators given by the matchers on the
+/// contiguous overload above.
+inline void NNdistanceRatio
+(
+  std::vector<float>::const_iterator first,
+  std::vector<float>::const_iterator last,
+  int NN,
+  std::vector<int> & vec_ratioOkIndex,
+  float fratio = 0.6f,
+  std::vector<float> * vec_distanceRatio = nullptr
+)
+{
+  const float * data = (first == last) ? nullptr : &(*first);
+  NNdistanceRatio(data, data + std::distance(first, last), NN, vec_ratioOkIndex, fratio, vec_distanceRatio);
+}
+
+/// Redirect the float vector iterators given by the matchers on the
+/// contiguous overload above.
+inline void NNdistanceRatio
+(
+  std::vector<float>::iterator first,
+  std::vector<float>::iterator last,
+  int NN,
+  std::vector<int> & vec_ratioOkIndex,
+  float fratio = 0.6f,
+  std::vector<float> * vec_distanceRatio = nullptr
+)
+{
+  const float * data = (first == last) ? nullptr : &(*first);
+  NNdistanceRatio(data, data + std::distance(first, last), NN, vec_ratioOkIndex, fratio, vec_distanceRatio);
+}
+
+#endif // ALICEVISION_HAVE_AVX2
+
 /**
   * Symmetric matches filtering :
   * Suppose matches from dataset A to B stored in vec_matches
@@ -36,3 +36,35 @@ BOOST_AUTO_TEST_CASE(matching_setIntersection)
   BOOST_CHECK_EQUAL(6, vec_intersect[4]);
   BOOST_CHECK_EQUAL(7, vec_intersect[5]);
 }
+
+/// NN distance ratio filtering over the contiguous NN == 2 layout
+BOOST_AUTO_TEST_CASE(matching_nnDistanceRatio)
+{
+  // 37 pairs: not a multiple of 8, so a vectorized implementation also
+  // exercises its scalar tail
+  std::vector<float> distances;
+  std::vector<int> expectedIndexes;
+  std::vector<float> expectedRatios;
+  for (int i = 0; i < 37; ++i)
+  {
+    const float second = 10.f + i;
+    const float best = (i % 3 == 0) ? 0.5f * second : 0.9f * second;
+    distances.push_back(best);
+    distances.push_back(second);
+    if (best < 0.6f * second)
+    {
+      expectedIndexes.push_back(i);
+      expectedRatios.push_back(best / second);
+    }
+  }
+
+  std::vector<int> vec_ratioOkIndex;
+  std::vector<float> vec_distanceRatio;
+  NNdistanceRatio(distances.begin(), distances.end(), 2,
+    vec_ratioOkIndex, 0.6f, &vec_distanceRatio);
+
+  BOOST_CHECK(vec_ratioOkIndex == expectedIndexes);
+  BOOST_CHECK_EQUAL(expectedRatios.size(), vec_distanceRatio.size());
+  for (size_t i = 0; i < vec_distanceRatio.size(); ++i)
+    BOOST_CHECK_EQUAL(expectedRatios[i], vec_distanceRatio[i]);
+}
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "aliceVision/matching/IndMatch.hpp"
+#include "aliceVision/matching/IndMatchDecorator.hpp"
 #include "aliceVision/matching/io.hpp"
 
 #include <boost/filesystem/operations.hpp>
@@ -87,6 +88,49 @@ BOOST_AUTO_TEST_CASE(IndMatch_IO)
   boost::filesystem::remove_all(testFolder);
 }
 
+BOOST_AUTO_TEST_CASE(IndMatch_IO_bin)
+{
+  const std::string testFolder = "matchingTestBin";
+  boost::filesystem::create_directory(testFolder);
+  {
+    std::set<IndexT> viewsKeys = {0, 1, 2};
+    PairwiseMatches matches;
+    // Test export with not empty data
+    matches[std::make_pair(0,1)][EImageDescriberType::UNKNOWN] = {{0,0},{1,1}};
+    matches[std::make_pair(1,2)][EImageDescriberType::UNKNOWN] = {{0,0},{1,1}, {2,2}};
+
+    BOOST_CHECK(Save(matches, testFolder, "bin", false));
+    matches.clear();
+    BOOST_CHECK(Load(matches, viewsKeys, {testFolder}, {EImageDescriberType::UNKNOWN}));
+    BOOST_CHECK_EQUAL(2, matches.size());
+    BOOST_CHECK_EQUAL(1, matches.count(std::make_pair(0,1)));
+    BOOST_CHECK_EQUAL(1, matches.count(std::make_pair(1,2)));
+    BOOST_CHECK_EQUAL(2, matches.at(std::make_pair(0,1)).at(EImageDescriberType::UNKNOWN).size());
+    BOOST_CHECK_EQUAL(3, matches.at(std::make_pair(1,2)).at(EImageDescriberType::UNKNOWN).size());
+  }
+  boost::filesystem::remove_all(testFolder);
+  boost::filesystem::create_directory(testFolder);
+  {
+    std::set<IndexT> viewsKeys = {0, 1, 2, 3};
+    PairwiseMatches matches;
+    matches[std::make_pair(0,1)][EImageDescriberType::UNKNOWN] = {{0,0},{1,1}};
+
+    // Test the incremental append mode used by ranged executions
+    BOOST_CHECK(Save(matches, testFolder, "bin", false));
+
+    PairwiseMatches appendedMatches;
+    appendedMatches[std::make_pair(2,3)][EImageDescriberType::UNKNOWN] = {{0,0},{1,1},{2,2}};
+    BOOST_CHECK(Save(appendedMatches, testFolder, "bin", false, true));
+
+    matches.clear();
+    BOOST_CHECK(Load(matches, viewsKeys, {testFolder}, {EImageDescriberType::UNKNOWN}));
+    BOOST_CHECK_EQUAL(2, matches.size());
+    BOOST_CHECK_EQUAL(2, matches.at(std::make_pair(0,1)).at(EImageDescriberType::UNKNOWN).size());
+    BOOST_CHECK_EQUAL(3, matches.at(std::make_pair(2,3)).at(EImageDescriberType::UNKNOWN).size());
+  }
+  boost::filesystem::remove_all(testFolder);
+}
+
 BOOST_AUTO_TEST_CASE(IndMatch_DuplicateRemoval_NoRemoval)
 {
   std::vector<IndMatch> vec_indMatch;
@@ -141,3 +185,23 @@ BOOST_AUTO_TEST_CASE(IndMatch_DuplicateRemoval)
   BOOST_CHECK_EQUAL(IndMatch(2,3), vec_indMatch[3]);
   BOOST_CHECK_EQUAL(IndMatch(3,3), vec_indMatch[4]);
 }
+
+BOOST_AUTO_TEST_CASE(IndMatch_DuplicateRemoval_SamePosition)
+{
+  // features 1 and 2 share the same position on both sides: the two matches
+  // towards them must be reduced to a single one
+  const std::vector<PointFeature> leftFeat = {{0.f, 0.f}, {1.f, 1.f}, {1.f, 1.f}};
+  const std::vector<PointFeature> rightFeat = {{2.f, 2.f}, {3.f, 3.f}, {3.f, 3.f}};
+
+  std::vector<IndMatch> vec_indMatch;
+  vec_indMatch.push_back(IndMatch(0,0));
+  vec_indMatch.push_back(IndMatch(1,1));
+  vec_indMatch.push_back(IndMatch(2,2)); // same positions as the match (1,1)
+
+  IndMatchDecorator<float> matchDeduplicator(vec_indMatch, leftFeat, rightFeat);
+  BOOST_CHECK(matchDeduplicator.getDeduplicated(vec_indMatch));
+
+  BOOST_CHECK_EQUAL(2, vec_indMatch.size());
+  BOOST_CHECK_EQUAL(IndMatch(0,0), vec_indMatch[0]);
+  BOOST_CHECK(vec_indMatch[1] == IndMatch(1,1) || vec_indMatch[1] == IndMatch(2,2));
+}
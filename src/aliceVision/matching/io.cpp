@@ -12,6 +12,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
 #include <fstream>
 #include <iterator>
@@ -23,6 +25,70 @@ namespace fs = boost::filesystem;
 namespace aliceVision {
 namespace matching {
 
+// Binary match file layout:
+//   magic (4 bytes) + version (1 byte)
+// followed by self-contained, length-prefixed pair records:
+//   I J (2 x uint32)
+//   nbDescType (uint32)
+//   per descType: descType (uint8), nbMatches (uint64), nbMatches x (i, j) (2 x uint32)
+// Records can simply be appended to an existing file, so ranged executions
+// can merge their results without rewriting the whole file.
+static const char MATCH_FILE_MAGIC[4] = {'A', 'V', 'M', 'F'};
+static const unsigned char MATCH_FILE_VERSION = 1;
+
+static bool loadBinMatchFile(PairwiseMatches& matches, const std::string& filepath)
+{
+  std::ifstream stream(filepath.c_str(), std::ios::in | std::ios::binary);
+  if(!stream.is_open())
+    return false;
+
+  char magic[4];
+  unsigned char version = 0;
+  stream.read(magic, sizeof(magic));
+  stream.read((char*)&version, sizeof(version));
+
+  if(!stream ||
+     !std::equal(magic, magic + sizeof(magic), MATCH_FILE_MAGIC) ||
+     version != MATCH_FILE_VERSION)
+  {
+    ALICEVISION_LOG_WARNING("Invalid binary matching file: " << filepath);
+    return false;
+  }
+
+  std::uint32_t I = 0;
+  std::uint32_t J = 0;
+  std::uint32_t nbDescType = 0;
+  std::vector<std::uint32_t> indexes;
+
+  while(stream.read((char*)&I, sizeof(I)))
+  {
+    if(!stream.read((char*)&J, sizeof(J)) ||
+       !stream.read((char*)&nbDescType, sizeof(nbDescType)))
+      return false;
+
+    for(std::uint32_t i = 0; i < nbDescType; ++i)
+    {
+      unsigned char descTypeValue = 0;
+      std::uint64_t nbMatches = 0;
+
+      if(!stream.read((char*)&descTypeValue, sizeof(descTypeValue)) ||
+         !stream.read((char*)&nbMatches, sizeof(nbMatches)))
+        return false;
+
+      indexes.resize(2 * nbMatches);
+      if(nbMatches > 0 && !stream.read((char*)indexes.data(), indexes.size() * sizeof(std::uint32_t)))
+        return false;
+
+      const feature::EImageDescriberType descType = feature::EImageDescriberType(descTypeValue);
+      IndMatches& matchesPerDesc = matches[std::make_pair(I,J)][descType];
+      matchesPerDesc.reserve(matchesPerDesc.size() + nbMatches);
+      for(std::uint64_t m = 0; m < nbMatches; ++m)
+        matchesPerDesc.emplace_back(indexes[2 * m], indexes[2 * m + 1]);
+    }
+  }
+  return true;
+}
+
 bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
 {
   const std::string ext = fs::extension(filepath);
@@ -30,7 +96,11 @@ bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
   if(!fs::exists(filepath))
     return false;
 
-  if(ext == ".txt")
+  if(ext == ".bin")
+  {
+    return loadBinMatchFile(matches, filepath);
+  }
+  else if(ext == ".txt")
   {
     std::ifstream stream(filepath.c_str());
     if (!stream.is_open())
@@ -192,16 +262,23 @@ bool Load(
   const int maxNbMatches)
 {
   bool res = false;
-  const std::string fileName = "matches.txt";
+  // the binary format is preferred over the text one when both are present
+  const std::vector<std::string> fileNames = {"matches.bin", "matches.txt"};
 
   for(const std::string& folder : folders)
   {
-    const fs::path filePath = fs::path(folder) / fileName;
+    for(const std::string& fileName : fileNames)
+    {
+      const fs::path filePath = fs::path(folder) / fileName;
 
-    if(fs::exists(filePath))
-      res = LoadMatchFile(matches, filePath.string());
-    else
-      res = LoadMatchFilePerImage(matches, viewsKeysFilter, folder, fileName);
+      if(fs::exists(filePath))
+        res = LoadMatchFile(matches, filePath.string());
+      else
+        res = LoadMatchFilePerImage(matches, viewsKeysFilter, folder, fileName);
+
+      if(res)
+        break;
+    }
   }
 
   if(!res)
@@ -267,6 +344,70 @@ private:
     fs::rename(tmpPath, filepath);
   }
 
+  void saveBin(
+    const std::string& filepath,
+    const PairwiseMatches::const_iterator& matchBegin,
+    const PairwiseMatches::const_iterator& matchEnd,
+    bool append)
+  {
+    const fs::path bPath = fs::path(filepath);
+    const bool appendToExisting = append && fs::exists(bPath);
+    // in append mode new records are directly added at the end of the
+    // existing file, so ranged executions can merge without rewriting
+    const std::string outPath = appendToExisting
+      ? filepath
+      : (bPath.parent_path() / bPath.stem()).string() + "." + fs::unique_path().string() + bPath.extension().string();
+
+    {
+      std::ofstream stream(outPath.c_str(), appendToExisting
+        ? (std::ios::out | std::ios::binary | std::ios::app)
+        : (std::ios::out | std::ios::binary));
+
+      if(!appendToExisting)
+      {
+        stream.write(MATCH_FILE_MAGIC, sizeof(MATCH_FILE_MAGIC));
+        stream.write((const char*)&MATCH_FILE_VERSION, sizeof(MATCH_FILE_VERSION));
+      }
+
+      std::vector<std::uint32_t> indexes;
+      for(PairwiseMatches::const_iterator match = matchBegin;
+        match != matchEnd;
+        ++match)
+      {
+        const std::uint32_t I = match->first.first;
+        const std::uint32_t J = match->first.second;
+        const MatchesPerDescType& matchesPerDesc = match->second;
+        const std::uint32_t nbDescType = matchesPerDesc.size();
+
+        stream.write((const char*)&I, sizeof(I));
+        stream.write((const char*)&J, sizeof(J));
+        stream.write((const char*)&nbDescType, sizeof(nbDescType));
+
+        for(const auto& m: matchesPerDesc)
+        {
+          const unsigned char descTypeValue = static_cast<unsigned char>(m.first);
+          const std::uint64_t nbMatches = m.second.size();
+
+          stream.write((const char*)&descTypeValue, sizeof(descTypeValue));
+          stream.write((const char*)&nbMatches, sizeof(nbMatches));
+
+          indexes.clear();
+          indexes.reserve(2 * nbMatches);
+          for(const IndMatch& indMatch: m.second)
+          {
+            indexes.push_back(indMatch._i);
+            indexes.push_back(indMatch._j);
+          }
+          stream.write((const char*)indexes.data(), indexes.size() * sizeof(std::uint32_t));
+        }
+      }
+    }
+
+    // rename temporary file
+    if(!appendToExisting)
+      fs::rename(outPath, filepath);
+  }
+
 public:
   MatchExporter(
     const PairwiseMatches& matches,
@@ -281,18 +422,20 @@ public:
   ~MatchExporter()
   {}
   
-  void saveGlobalFile()
+  void saveGlobalFile(bool append)
   {
     const std::string filepath = (fs::path(m_directory) / m_filename).string();
 
     if(m_ext == ".txt")
       saveTxt(filepath, m_matches.begin(), m_matches.end());
+    else if(m_ext == ".bin")
+      saveBin(filepath, m_matches.begin(), m_matches.end(), append);
     else
       throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
   }
 
   /// Export matches into separate files, one for each image.
-  void saveOneFilePerImage()
+  void saveOneFilePerImage(bool append)
   {
     std::set<IndexT> keys;
     std::transform(
@@ -312,6 +455,8 @@ public:
       
       if(m_ext == ".txt")
         saveTxt(filepath, matchBegin, match);
+      else if(m_ext == ".bin")
+        saveBin(filepath, matchBegin, match, append);
       else
         throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
 
@@ -331,15 +476,16 @@ bool Save(
   const PairwiseMatches & matches,
   const std::string & folder,
   const std::string & extension,
-  bool matchFilePerImage)
+  bool matchFilePerImage,
+  bool append)
 {
   const std::string filename = "matches." + extension;
   MatchExporter exporter(matches, folder, filename);
 
   if(matchFilePerImage)
-    exporter.saveOneFilePerImage();
+    exporter.saveOneFilePerImage(append);
   else
-    exporter.saveGlobalFile();
+    exporter.saveGlobalFile(append);
 
   return true;
 }
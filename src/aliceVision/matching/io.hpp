@@ -75,12 +75,15 @@ void filterTopMatches(
  * @param[in] extension: txt or bin file format
  * @param[in] matchFilePerImage: do we store a global match file
  *            or one match file per image
+ * @param[in] append: add the matches at the end of an existing bin file
+ *            instead of rewriting it (used by ranged executions)
  */
 bool Save(
   const PairwiseMatches& matches,
   const std::string& folder,
   const std::string& extension,
-  bool matchFilePerImage);
+  bool matchFilePerImage,
+  bool append = false);
 
 }  // namespace matching
 }  // namespace aliceVision
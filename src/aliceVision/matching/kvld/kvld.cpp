@@ -257,7 +257,11 @@ float KVLD( const Image< float >& I1,
     fill( scoretable.begin(), scoretable.end(), 0.0 );
     fill( result.begin(), result.end(), 0 );
     //========substep 1: search foreach match its neighbors and verify if they are gvld-consistent ============//
-    for( int it1 = 0; it1 < size - 1; it1++ )
+    // the pairwise VLD verification dominates the filter cost: the rows are
+    // processed in parallel, each (it1, it2) pair only touches its own E
+    // entries and the neighbor counters are updated atomically
+    #pragma omp parallel for schedule(dynamic)
+    for( int it1 = 0; it1 < int( size ) - 1; it1++ )
     {
       if( valide[ it1 ] )
       {
@@ -299,11 +303,19 @@ float KVLD( const Image< float >& I1,
               }
               if( E( it1, it2 ) >= 0 )
               {
+                #pragma omp atomic
                 result[ it1 ] += 1;
+                #pragma omp atomic
                 result[ it2 ] += 1;
+                #pragma omp atomic
                 scoretable[ it1 ] += double( E( it1, it2 ) );
+                #pragma omp atomic
                 scoretable[ it2 ] += double( E( it1, it2 ) );
-                if( result[ it1 ] >= max_connection )
+
+                size_t nbConnection;
+                #pragma omp atomic read
+                nbConnection = result[ it1 ];
+                if( nbConnection >= max_connection )
                   break;
               }
             }
@@ -373,10 +385,11 @@ float KVLD( const Image< float >& I1,
       for( int i = 0; i < size; i++ )
         scoretable[ i ]=0;
 
-      vector< bool > switching;
-      for( int i = 0; i < size; i++ )
-        switching.push_back( false );
+      // vector<char> as the flags are written concurrently (vector<bool> packs bits)
+      vector< char > switching( size, 0 );
 
+      // each row only writes its own score and switching flag
+      #pragma omp parallel for schedule(dynamic)
       for( int it1 = 0; it1 < size; it1++ )
       {
         if( valide[ it1 ] )
@@ -412,13 +425,15 @@ float KVLD( const Image< float >& I1,
           if( good_index < 0.3f * float( index ) && scoretable[ it1 ] > 1.2 )
           {
             switching[ it1 ] = true;
-            change = true;
           }
         }
       }
       for( int it1 = 0; it1 < size; it1++ )
         if( switching[ it1 ] )
+        {
           valide[ it1 ] = false;
+          change = true;
+        }
     }
   }
   //=============== generating output list ===================//
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <aliceVision/config.hpp>
+
 #include <string>
 
 namespace aliceVision {
@@ -16,9 +18,14 @@ enum EMatcherType
 {
   BRUTE_FORCE_L2,
   ANN_L2,
+  HNSW_L2,
   CASCADE_HASHING_L2,
   FAST_CASCADE_HASHING_L2,
   BRUTE_FORCE_HAMMING
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+  , BRUTE_FORCE_CUDA_L2
+#endif
 };
 
 /**
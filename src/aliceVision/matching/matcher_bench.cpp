@@ -0,0 +1,63 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
+#include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
+#include <aliceVision/system/Benchmark.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace matching;
+
+// k-NN matching of SIFT like descriptors between two views
+static const std::size_t DESC_DIMENSION = 128;
+static const std::size_t NB_DATASET = 2000;
+static const std::size_t NB_QUERY = 256;
+static const std::size_t KNN = 2;
+
+const std::vector<float>& descriptors(std::size_t nbDescriptors, unsigned int seed)
+{
+  static std::vector<float> dataset;
+  static std::vector<float> query;
+  std::vector<float>& data = (seed == 0) ? dataset : query;
+  if(data.empty())
+  {
+    std::mt19937 randomEngine(seed);
+    std::uniform_real_distribution<float> distribution(0.f, 255.f);
+    data.resize(DESC_DIMENSION * nbDescriptors);
+    for(std::size_t i = 0; i < data.size(); ++i)
+      data[i] = distribution(randomEngine);
+  }
+  return data;
+}
+
+template<typename Matcher>
+void knnBench(std::size_t nbIterations)
+{
+  const std::vector<float>& dataset = descriptors(NB_DATASET, 0);
+  const std::vector<float>& query = descriptors(NB_QUERY, 1);
+
+  for(std::size_t i = 0; i < nbIterations; ++i)
+  {
+    Matcher matcher;
+    matcher.Build(&dataset[0], NB_DATASET, DESC_DIMENSION);
+
+    IndMatches indices;
+    std::vector<typename Matcher::DistanceType> distances;
+    matcher.SearchNeighbours(&query[0], NB_QUERY, &indices, &distances, KNN);
+    system::benchmarkDoNotOptimize(indices);
+  }
+}
+
+void matcher_bruteForce_L2(std::size_t nbIterations)  { knnBench<ArrayMatcher_bruteForce<float>>(nbIterations); }
+void matcher_kdtreeFlann_L2(std::size_t nbIterations) { knnBench<ArrayMatcher_kdtreeFlann<float>>(nbIterations); }
+
+ALICEVISION_BENCHMARK(matcher_bruteForce_L2)
+ALICEVISION_BENCHMARK(matcher_kdtreeFlann_L2)
+
+ALICEVISION_BENCHMARK_MAIN()
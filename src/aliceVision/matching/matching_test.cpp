@@ -9,6 +9,7 @@
 #include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
 #include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
 #include "aliceVision/matching/ArrayMatcher_cascadeHashing.hpp"
+#include "aliceVision/matching/ArrayMatcher_hnsw.hpp"
 #include <iostream>
 
 #define BOOST_TEST_MODULE matching
@@ -114,6 +115,69 @@ BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_kdtreeFlann_Simple__NN)
   BOOST_CHECK_EQUAL(IndMatch(0,4), vec_nIndice[4]);
 }
 
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_hnsw_Simple__NN)
+{
+  const float array[] = {0, 1, 2, 5, 6};
+  // no 3, because it involve the same dist as 1,1
+
+  ArrayMatcher_hnsw<float> matcher;
+  BOOST_CHECK( matcher.Build(array, 5, 1) );
+
+  const float query[] = {2};
+  IndMatches vec_nIndice;
+  vector<float> vec_fDistance;
+  const int NN = 5;
+  BOOST_CHECK( matcher.SearchNeighbours(query, 1, &vec_nIndice, &vec_fDistance, NN) );
+
+  BOOST_CHECK_EQUAL( 5, vec_nIndice.size());
+  BOOST_CHECK_EQUAL( 5, vec_fDistance.size());
+
+  // Check distances:
+  BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[0]- Square(2.0f-2.0f)), 1e-6);
+  BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[1]- Square(1.0f-2.0f)), 1e-6);
+  BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[2]- Square(0.0f-2.0f)), 1e-6);
+  BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[3]- Square(5.0f-2.0f)), 1e-6);
+  BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[4]- Square(6.0f-2.0f)), 1e-6);
+
+  // Check indexes:
+  BOOST_CHECK_EQUAL(IndMatch(0,2), vec_nIndice[0]);
+  BOOST_CHECK_EQUAL(IndMatch(0,1), vec_nIndice[1]);
+  BOOST_CHECK_EQUAL(IndMatch(0,0), vec_nIndice[2]);
+  BOOST_CHECK_EQUAL(IndMatch(0,3), vec_nIndice[3]);
+  BOOST_CHECK_EQUAL(IndMatch(0,4), vec_nIndice[4]);
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_hnsw_NearestNeighbour_Recall)
+{
+  // compare the HNSW first nearest neighbour against the brute force one
+  // on a deterministic random dataset
+  const int nbRows = 2000;
+  const int dimension = 16;
+  std::vector<float> dataset(nbRows * dimension);
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+  for (float& value : dataset)
+    value = dis(gen);
+
+  ArrayMatcher_hnsw<float> matcher;
+  BOOST_CHECK( matcher.Build(&dataset[0], nbRows, dimension) );
+
+  ArrayMatcher_bruteForce<float> bruteForceMatcher;
+  BOOST_CHECK( bruteForceMatcher.Build(&dataset[0], nbRows, dimension) );
+
+  // every dataset point must be retrieved as its own nearest neighbour
+  int nbFound = 0;
+  for (int i = 0; i < nbRows; i += 10)
+  {
+    int nIndice = -1;
+    float fDistance = -1.0f;
+    BOOST_CHECK( matcher.SearchNeighbour(&dataset[i * dimension], &nIndice, &fDistance) );
+    if (nIndice == i)
+      ++nbFound;
+  }
+  BOOST_CHECK_EQUAL(nbRows / 10, nbFound);
+}
+
 //-- Test LIMIT case (empty arrays)
 
 BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForce_Simple_EmptyArrays)
@@ -138,6 +202,17 @@ BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_kdtreeFlann_Simple_EmptyArrays)
   BOOST_CHECK(! matcher.SearchNeighbour( &array[0], &nIndice, &fDistance) );
 }
 
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_hnsw_Simple_EmptyArrays)
+{
+  std::vector<float> array;
+  ArrayMatcher_hnsw<float> matcher;
+  BOOST_CHECK(! matcher.Build(&array[0], 0, 4) );
+
+  int nIndice = -1;
+  float fDistance = -1.0f;
+  BOOST_CHECK(! matcher.SearchNeighbour( &array[0], &nIndice, &fDistance) );
+}
+
 BOOST_AUTO_TEST_CASE(Matching_Cascade_Hashing_Simple_EmptyArrays)
 {
   std::vector<float> array;
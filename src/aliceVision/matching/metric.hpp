@@ -11,7 +11,9 @@
 #include "aliceVision/numeric/Accumulator.hpp"
 #include <aliceVision/config.hpp>
 
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+#include <immintrin.h>
+#elif ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
 #include <aliceVision/system/Logger.hpp>
 #include <xmmintrin.h>
 #endif
@@ -75,7 +77,98 @@ struct L2_Vectorized
   }
 };
 
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+
+namespace optim_avx2{
+
+  // Euclidean distance (AVX2 method) (squared result)
+  inline float l2_avx2(const float * b1, const float * b2, int size)
+  {
+    __m256 cumSum = _mm256_setzero_ps();
+    int i = 0;
+    for(; i + 8 <= size; i += 8)
+    {
+      const __m256 srcA = _mm256_loadu_ps(b1 + i);
+      const __m256 srcB = _mm256_loadu_ps(b2 + i);
+      //-- Subtract
+      const __m256 diff = _mm256_sub_ps(srcA, srcB);
+      //-- Multiply and sum
+      cumSum = _mm256_add_ps(cumSum, _mm256_mul_ps(diff, diff));
+    }
+    //-- Horizontal sum of the 8 lanes
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(cumSum), _mm256_extractf128_ps(cumSum, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    float result = _mm_cvtss_f32(sum);
+    //-- Process the last 0-7 values (not needed for standard descriptor lengths)
+    for(; i < size; ++i)
+    {
+      const float diff = b1[i] - b2[i];
+      result += diff * diff;
+    }
+    return result;
+  }
+
+  // Euclidean distance between uint8 descriptors (AVX2 method) (squared result)
+  // 16 components are processed per iteration: the uint8 values are widened
+  // to int16, and _mm256_madd_epi16 computes diff*diff pairs summed to int32.
+  inline float l2_avx2(const unsigned char * b1, const unsigned char * b2, int size)
+  {
+    __m256i cumSum = _mm256_setzero_si256();
+    int i = 0;
+    for(; i + 16 <= size; i += 16)
+    {
+      const __m256i srcA = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b1 + i)));
+      const __m256i srcB = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b2 + i)));
+      const __m256i diff = _mm256_sub_epi16(srcA, srcB);
+      cumSum = _mm256_add_epi32(cumSum, _mm256_madd_epi16(diff, diff));
+    }
+    //-- Horizontal sum of the 8 int32 lanes
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(cumSum), _mm256_extracti128_si256(cumSum, 1));
+    sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+    sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+    int result = _mm_cvtsi128_si32(sum);
+    //-- Process the last 0-15 values (not needed for standard descriptor lengths)
+    for(; i < size; ++i)
+    {
+      const int diff = int(b1[i]) - int(b2[i]);
+      result += diff * diff;
+    }
+    return static_cast<float>(result);
+  }
+} // namespace optim_avx2
+
+// Template specification to run AVX2 L2 squared distance
+//  on float vector
+template<>
+struct L2_Vectorized<float>
+{
+  typedef float ElementType;
+  typedef Accumulator<float>::Type ResultType;
+
+  template <typename Iterator1, typename Iterator2>
+  inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+  {
+    return optim_avx2::l2_avx2(a, b, size);
+  }
+};
+
+// Template specification to run AVX2 L2 squared distance
+//  on uint8 vector (the default SIFT descriptor representation)
+template<>
+struct L2_Vectorized<unsigned char>
+{
+  typedef unsigned char ElementType;
+  typedef Accumulator<unsigned char>::Type ResultType;
+
+  template <typename Iterator1, typename Iterator2>
+  inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+  {
+    return optim_avx2::l2_avx2(a, b, size);
+  }
+};
+
+#elif ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
 
 namespace optim_ss2{
 
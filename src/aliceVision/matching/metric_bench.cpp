@@ -0,0 +1,64 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/matching/metric.hpp"
+#include <aliceVision/system/Benchmark.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace matching;
+
+// SIFT like descriptors: 128 dimensions, a query against a small dataset
+static const std::size_t DESC_DIMENSION = 128;
+static const std::size_t NB_DESCRIPTORS = 1024;
+
+template<typename T>
+const std::vector<T>& descriptors()
+{
+  static std::vector<T> data;
+  if(data.empty())
+  {
+    std::mt19937 randomEngine(42);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    data.resize(DESC_DIMENSION * (NB_DESCRIPTORS + 1));
+    for(std::size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<T>(distribution(randomEngine));
+  }
+  return data;
+}
+
+template<typename Metric>
+void distanceBench(std::size_t nbIterations)
+{
+  typedef typename Metric::ElementType T;
+  const std::vector<T>& data = descriptors<T>();
+  const T* query = &data[DESC_DIMENSION * NB_DESCRIPTORS];
+  Metric metric;
+
+  for(std::size_t i = 0; i < nbIterations; ++i)
+  {
+    typename Metric::ResultType sum = 0;
+    for(std::size_t d = 0; d < NB_DESCRIPTORS; ++d)
+      sum += metric(query, &data[DESC_DIMENSION * d], DESC_DIMENSION);
+    system::benchmarkDoNotOptimize(sum);
+  }
+}
+
+void metric_L2_Simple_uchar(std::size_t nbIterations)     { distanceBench<L2_Simple<unsigned char>>(nbIterations); }
+void metric_L2_Simple_float(std::size_t nbIterations)     { distanceBench<L2_Simple<float>>(nbIterations); }
+void metric_L2_Vectorized_uchar(std::size_t nbIterations) { distanceBench<L2_Vectorized<unsigned char>>(nbIterations); }
+void metric_L2_Vectorized_float(std::size_t nbIterations) { distanceBench<L2_Vectorized<float>>(nbIterations); }
+void metric_Hamming_uchar(std::size_t nbIterations)       { distanceBench<Hamming<unsigned char>>(nbIterations); }
+
+ALICEVISION_BENCHMARK(metric_L2_Simple_uchar)
+ALICEVISION_BENCHMARK(metric_L2_Simple_float)
+ALICEVISION_BENCHMARK(metric_L2_Vectorized_uchar)
+ALICEVISION_BENCHMARK(metric_L2_Vectorized_float)
+ALICEVISION_BENCHMARK(metric_Hamming_uchar)
+
+ALICEVISION_BENCHMARK_MAIN()
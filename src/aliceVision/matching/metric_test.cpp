@@ -62,6 +62,27 @@ BOOST_AUTO_TEST_CASE(Metric_HAMMING_BITSET)
   BOOST_CHECK_EQUAL(2, metricHammingUchar(reinterpret_cast<unsigned char *>(&a),reinterpret_cast<unsigned char *>(&c),1));
 }
 
+BOOST_AUTO_TEST_CASE(Metric_HAMMING_BLOCKED)
+{
+  // 8 database descriptors of 8 bytes each, stored contiguously
+  const int DESC_SIZE = 8;
+  unsigned char query[DESC_SIZE];
+  unsigned char database[8 * DESC_SIZE];
+
+  for(int i = 0; i < DESC_SIZE; ++i)
+    query[i] = static_cast<unsigned char>(i * 37);
+  for(int i = 0; i < 8 * DESC_SIZE; ++i)
+    database[i] = static_cast<unsigned char>(i * 101 + 7);
+
+  Hamming<unsigned char> metric;
+  Hamming<unsigned char>::ResultType blockedResults[8];
+  metric.blockedDistances(query, database, DESC_SIZE, blockedResults);
+
+  // the blocked kernel must give the same distances as the per-pair operator
+  for(int r = 0; r < 8; ++r)
+    BOOST_CHECK_EQUAL(metric(query, &database[r * DESC_SIZE], DESC_SIZE), blockedResults[r]);
+}
+
 BOOST_AUTO_TEST_CASE(Metric_HAMMING_BITSET_RAW_MEMORY_64BITS)
 {
   const int COUNT = 4;
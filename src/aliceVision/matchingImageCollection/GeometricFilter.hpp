@@ -15,6 +15,7 @@
 
 #include <boost/progress.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <map>
 
@@ -49,21 +50,37 @@ void robustModelEstimation(
   out_geometricMatches.clear();
 
   boost::progress_display progressBar(putativeMatches.size(), std::cout, "Robust Model Estimation\n");
-  
-#pragma omp parallel for schedule(dynamic)
-  for (int i = 0; i < (int)putativeMatches.size(); ++i)
-  {
-    PairwiseMatches::const_iterator iter = putativeMatches.begin();
-    std::advance(iter, i);
 
-    const Pair currentPair = iter->first;
-    const MatchesPerDescType& putativeMatchesPerType = iter->second;
-    const Pair& imagePair = iter->first;
+  // Flatten the pairs into a work list sorted by decreasing number of putative
+  // matches: the expensive pairs are scheduled first and the many small ones
+  // fill the tail of the stage, which keeps all the cores busy until the end.
+  std::vector<PairwiseMatches::const_iterator> workList;
+  workList.reserve(putativeMatches.size());
+  for (PairwiseMatches::const_iterator iter = putativeMatches.begin(); iter != putativeMatches.end(); ++iter)
+    workList.push_back(iter);
+  std::sort(workList.begin(), workList.end(),
+    [](const PairwiseMatches::const_iterator& a, const PairwiseMatches::const_iterator& b)
+    {
+      return a->second.getNbAllMatches() > b->second.getNbAllMatches();
+    });
 
-    // apply the geometric filter (robust model estimation)
+#pragma omp parallel
+  {
+    // per-thread functor copy and output accumulation: the functor (and its
+    // internal buffers) is reused across all the pairs of the thread and the
+    // results are merged once at the end, so the only synchronization inside
+    // the loop is the progress bar update
+    GeometryFunctor geometricFilter = functor;
+    std::vector<std::pair<Pair, MatchesPerDescType>> threadMatches;
+
+#pragma omp for schedule(dynamic)
+    for (int i = 0; i < (int)workList.size(); ++i)
     {
+      const Pair& imagePair = workList[i]->first;
+      const MatchesPerDescType& putativeMatchesPerType = workList[i]->second;
+
+      // apply the geometric filter (robust model estimation)
       MatchesPerDescType inliers;
-      GeometryFunctor geometricFilter = functor; // use a copy since we are in a multi-thread context
       const EstimationStatus state = geometricFilter.geometricEstimation(sfmData, regionsPerView, imagePair, putativeMatchesPerType, inliers);
       if(state.hasStrongSupport)
       {
@@ -75,17 +92,20 @@ void robustModelEstimation(
           std::swap(inliers, guidedGeometricInliers);
         }
 
-#pragma omp critical
-        {
-          out_geometricMatches.emplace(currentPair, std::move(inliers));
-        }
+        threadMatches.emplace_back(imagePair, std::move(inliers));
+      }
 
+#pragma omp critical
+      {
+        ++progressBar;
       }
     }
 
+    // merge the per-thread accumulated matches
 #pragma omp critical
     {
-      ++progressBar;
+      for (auto& threadMatch : threadMatches)
+        out_geometricMatches.emplace(threadMatch.first, std::move(threadMatch.second));
     }
   }
 }
@@ -19,6 +19,7 @@
 #include "aliceVision/sfmData/SfMData.hpp"
 #include "aliceVision/feature/RegionsPerView.hpp"
 #include "aliceVision/matchingImageCollection/GeometricFilterMatrix.hpp"
+#include "aliceVision/matchingImageCollection/geometricFilterUtils.hpp"
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -70,9 +71,14 @@ struct GeometricFilterMatrix_E_AC : public GeometricFilterMatrix
     if ( !isPinhole(cam_I->getType()) || !isPinhole(cam_J->getType()))
       return EstimationStatus(false, false);
 
-    // Get corresponding point regions arrays
-    Mat xI,xJ;
-    MatchesPairToMat(pairIndex, putativeMatchesPerType, sfmData, regionsPerView, descTypes, xI, xJ);
+    // Get corresponding point regions arrays, assembled in per-thread
+    // scratch memory (this runs for every image pair)
+    system::ScratchArena& arena = system::ScratchArena::threadLocal();
+    const system::ScratchArena::Scope scratch(arena);
+
+    const auto xIJ = MatchesPairToMat(pairIndex, putativeMatchesPerType, sfmData, regionsPerView, descTypes, arena);
+    const Eigen::Map<Mat>& xI = xIJ.first;
+    const Eigen::Map<Mat>& xJ = xIJ.second;
 
     // Define the AContrario adapted Essential matrix solver
     typedef ACKernelAdaptorEssential<
@@ -31,10 +31,12 @@ struct GeometricFilterMatrix_F_AC: public GeometricFilterMatrix
   GeometricFilterMatrix_F_AC(
     double dPrecision = std::numeric_limits<double>::infinity(),
     size_t iteration = 1024,
-    robustEstimation::ERobustEstimator estimator = robustEstimation::ERobustEstimator::ACRANSAC)
+    robustEstimation::ERobustEstimator estimator = robustEstimation::ERobustEstimator::ACRANSAC,
+    bool adaptiveIterations = false)
     : GeometricFilterMatrix(dPrecision, std::numeric_limits<double>::infinity(), iteration)
     , m_F(Mat3::Identity())
     , m_estimator(estimator)
+    , m_adaptiveIterations(adaptiveIterations)
   {}
 
   /**
@@ -98,15 +100,18 @@ struct GeometricFilterMatrix_F_AC: public GeometricFilterMatrix
     if(descTypes.empty())
       return EstimationStatus(false, false);
 
-    // Retrieve all 2D features as undistorted positions into flat arrays
-    Mat xI, xJ;
-    MatchesPairToMat(putativeMatchesPerType, cam_I, cam_J,
-                     region_I, region_J,
-                     descTypes, xI, xJ);
+    // Retrieve all 2D features as undistorted positions into flat arrays,
+    // assembled in per-thread scratch memory (this runs for every image pair)
+    system::ScratchArena& arena = system::ScratchArena::threadLocal();
+    const system::ScratchArena::Scope scratch(arena);
+
+    const auto xIJ = MatchesPairToMat(putativeMatchesPerType, cam_I, cam_J,
+                                      region_I, region_J,
+                                      descTypes, arena);
     std::vector<size_t> inliers;
 
     std::pair<bool, std::size_t> estimationPair = geometricEstimation_Mat(
-        xI, xJ,
+        xIJ.first, xIJ.second,
         imageSizeI,
         imageSizeJ,
         inliers);
@@ -134,16 +139,17 @@ struct GeometricFilterMatrix_F_AC: public GeometricFilterMatrix
    * @brief Given two sets of image points, it estimates the fundamental matrix
    * relating them using a robust method (like A Contrario Ransac).
    * 
-   * @param[in] xI The first set of points
+   * @param[in] xI The first set of points (Mat or compatible expression, e.g. an Eigen::Map)
    * @param[in] xJ The second set of points
    * @param[in] imageSizeI The size of the first image (used for normalizing the points)
    * @param[in] imageSizeJ The size of the second image
    * @param[out] geometric_inliers A vector containing the indices of the inliers
    * @return true if geometric_inliers is not empty
    */
+  template<typename MatT>
   std::pair<bool, std::size_t> geometricEstimation_Mat(
-    const Mat& xI,       // points of the first image
-    const Mat& xJ,       // points of the second image
+    const MatT& xI,      // points of the first image
+    const MatT& xJ,      // points of the second image
     const std::pair<size_t,size_t> & imageSizeI,     // size of the first image  
     const std::pair<size_t,size_t> & imageSizeJ,     // size of the first image
     std::vector<size_t> & out_inliers)
@@ -172,7 +178,7 @@ struct GeometricFilterMatrix_F_AC: public GeometricFilterMatrix
         // Robustly estimate the Fundamental matrix with A Contrario ransac
         const double upper_bound_precision = Square(m_dPrecision);
         const std::pair<double,double> ACRansacOut =
-          ACRANSAC(kernel, out_inliers, m_stIteration, &m_F, upper_bound_precision);
+          ACRANSAC(kernel, out_inliers, m_stIteration, &m_F, upper_bound_precision, false, m_adaptiveIterations);
 
         if(out_inliers.empty())
           return std::make_pair(false, KernelType::MINIMUM_SAMPLES);
@@ -270,6 +276,8 @@ struct GeometricFilterMatrix_F_AC: public GeometricFilterMatrix
   //-- Stored data
   Mat3 m_F;
   robustEstimation::ERobustEstimator m_estimator;
+  // stop the ACRansac iterations early from the inlier ratio found so far
+  bool m_adaptiveIterations;
 };
 
 } // namespace matchingImageCollection
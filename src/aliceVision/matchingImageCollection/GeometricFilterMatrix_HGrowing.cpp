@@ -61,12 +61,72 @@ std::size_t GeometricFilterMatrix_HGrowing::getNbAllVerifiedMatches() const
 
 
 
+MatchSpatialGrid::MatchSpatialGrid(const std::vector<feature::SIOPointFeature>& featuresI,
+                                   const matching::IndMatches& matches,
+                                   std::size_t nbCellsPerSide)
+  : _nbCellsPerSide(nbCellsPerSide)
+{
+  assert(nbCellsPerSide > 0);
+  _cells.resize(nbCellsPerSide * nbCellsPerSide);
+
+  if (matches.empty())
+    return;
+
+  // bounding box of the I-features of the matches
+  double maxX = std::numeric_limits<double>::lowest(), maxY = std::numeric_limits<double>::lowest();
+  _minX = std::numeric_limits<double>::max();
+  _minY = std::numeric_limits<double>::max();
+  for (const matching::IndMatch& match : matches)
+  {
+    const feature::SIOPointFeature& featI = featuresI.at(match._i);
+    _minX = std::min(_minX, double(featI.x()));
+    _minY = std::min(_minY, double(featI.y()));
+    maxX = std::max(maxX, double(featI.x()));
+    maxY = std::max(maxY, double(featI.y()));
+  }
+  _cellSizeX = std::max((maxX - _minX) / nbCellsPerSide, 1.0);
+  _cellSizeY = std::max((maxY - _minY) / nbCellsPerSide, 1.0);
+
+  for (IndexT iMatch = 0; iMatch < matches.size(); ++iMatch)
+  {
+    const feature::SIOPointFeature& featI = featuresI.at(matches.at(iMatch)._i);
+    const std::size_t cx = std::min(std::size_t((featI.x() - _minX) / _cellSizeX), nbCellsPerSide - 1);
+    const std::size_t cy = std::min(std::size_t((featI.y() - _minY) / _cellSizeY), nbCellsPerSide - 1);
+    _cells[cy * nbCellsPerSide + cx].push_back(iMatch);
+  }
+}
+
+void MatchSpatialGrid::getMatchesInRegion(double xMin, double yMin, double xMax, double yMax,
+                                          double margin, std::vector<IndexT>& matchesId) const
+{
+  matchesId.clear();
+
+  const auto toCell = [this](double value, double origin, double cellSize) -> std::ptrdiff_t
+  {
+    return std::ptrdiff_t((value - origin) / cellSize);
+  };
+  const std::size_t cxMin = std::size_t(std::max<std::ptrdiff_t>(toCell(xMin - margin, _minX, _cellSizeX), 0));
+  const std::size_t cyMin = std::size_t(std::max<std::ptrdiff_t>(toCell(yMin - margin, _minY, _cellSizeY), 0));
+  const std::size_t cxMax = std::min<std::size_t>(std::max<std::ptrdiff_t>(toCell(xMax + margin, _minX, _cellSizeX), 0), _nbCellsPerSide - 1);
+  const std::size_t cyMax = std::min<std::size_t>(std::max<std::ptrdiff_t>(toCell(yMax + margin, _minY, _cellSizeY), 0), _nbCellsPerSide - 1);
+
+  for (std::size_t cy = cyMin; cy <= cyMax; ++cy)
+  {
+    for (std::size_t cx = cxMin; cx <= cxMax; ++cx)
+    {
+      const std::vector<IndexT>& cell = _cells[cy * _nbCellsPerSide + cx];
+      matchesId.insert(matchesId.end(), cell.begin(), cell.end());
+    }
+  }
+}
+
 bool growHomography(const std::vector<feature::SIOPointFeature> &featuresI,
                     const std::vector<feature::SIOPointFeature> &featuresJ,
                     const matching::IndMatches &matches,
                     const IndexT &seedMatchId,
                     std::set<IndexT> &planarMatchesIndices, Mat3 &transformation,
-                    const GrowParameters& param)
+                    const GrowParameters& param,
+                    const MatchSpatialGrid* spatialGrid)
 {
   assert(seedMatchId <= matches.size());
 
@@ -78,6 +138,7 @@ bool growHomography(const std::vector<feature::SIOPointFeature> &featuresI,
   const feature::SIOPointFeature & seedFeatureJ = featuresJ.at(seedMatch._j);
 
   double currTolerance;
+  std::vector<IndexT> candidatesId;
 
   for (IndexT iRefineStep = 0; iRefineStep < param._nbRefiningIterations; ++iRefineStep)
   {
@@ -97,7 +158,29 @@ bool growHomography(const std::vector<feature::SIOPointFeature> &featuresI,
       currTolerance = param._homographyTolerance;
     }
 
-    findTransformationInliers(featuresI, featuresJ, matches, transformation, currTolerance, planarMatchesIndices);
+    if (spatialGrid == nullptr)
+    {
+      findTransformationInliers(featuresI, featuresJ, matches, transformation, currTolerance, planarMatchesIndices);
+    }
+    else
+    {
+      // only test the spatial neighborhood of the current plane support: the
+      // bounding box of the supporting I-features (the seed on the 1st step),
+      // expanded by two grid cells so the plane can keep growing.
+      double xMin = seedFeatureI.x(), xMax = seedFeatureI.x();
+      double yMin = seedFeatureI.y(), yMax = seedFeatureI.y();
+      for (const IndexT id : planarMatchesIndices)
+      {
+        const feature::SIOPointFeature& featI = featuresI.at(matches.at(id)._i);
+        xMin = std::min(xMin, double(featI.x()));
+        xMax = std::max(xMax, double(featI.x()));
+        yMin = std::min(yMin, double(featI.y()));
+        yMax = std::max(yMax, double(featI.y()));
+      }
+      const double margin = 2.0 * spatialGrid->cellSize() + currTolerance;
+      spatialGrid->getMatchesInRegion(xMin, yMin, xMax, yMax, margin, candidatesId);
+      findTransformationInliers(featuresI, featuresJ, matches, candidatesId, transformation, currTolerance, planarMatchesIndices);
+    }
 
     if (planarMatchesIndices.size() < param._minInliersToRefine)
       return false;
@@ -130,13 +213,20 @@ void filterMatchesByHGrowing(const std::vector<feature::SIOPointFeature>& siofea
     std::set<IndexT> usedMatchesId, bestMatchesId;
     Mat3 bestHomography;
 
+    // spatial index of the remaining matches, so each growth iteration only
+    // tests the neighborhood of the current plane support
+    const MatchSpatialGrid spatialGrid(siofeatures_I, remainingMatches);
+
     // -- Estimate H using homography-growing approach
-    #pragma omp parallel for // (huge optimization but modify results a little)
+    #pragma omp parallel for schedule(dynamic) // (huge optimization but modify results a little)
     for(int iMatch = 0; iMatch < remainingMatches.size(); ++iMatch)
     {
       // Growing a homography from one match ([F.Srajer, 2016] algo. 1, p. 20)
       // each match is used once only per homography estimation (increases computation time) [1st improvement ([F.Srajer, 2016] p. 20) ]
-      if (usedMatchesId.find(iMatch) != usedMatchesId.end())
+      bool alreadyUsed;
+      #pragma omp critical(usedMatches)
+      alreadyUsed = (usedMatchesId.find(iMatch) != usedMatchesId.end());
+      if (alreadyUsed)
         continue;
       std::set<IndexT> planarMatchesId; // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
       Mat3 homography;
@@ -147,19 +237,19 @@ void filterMatchesByHGrowing(const std::vector<feature::SIOPointFeature>& siofea
                           iMatch,
                           planarMatchesId,
                           homography,
-                          param._growParam))
+                          param._growParam,
+                          &spatialGrid))
       {
         continue;
       }
 
-      #pragma omp critical
+      #pragma omp critical(usedMatches)
       usedMatchesId.insert(planarMatchesId.begin(), planarMatchesId.end());
 
-      if (planarMatchesId.size() > bestMatchesId.size())
+      #pragma omp critical(bestMatches)
       {
-        #pragma omp critical
+        if (planarMatchesId.size() > bestMatchesId.size())
         {
-          if(iH == 3) std::cout << "best iMatch" << iMatch << std::endl;
           bestMatchesId = planarMatchesId; // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
           bestHomography = homography;
         }
@@ -70,6 +70,40 @@ struct GrowParameters
     double _maxFractionPlanarMatches{0.7};
 };
 
+/**
+ * @brief Uniform grid over the image-I positions of the matches.
+ * @details Each cell stores the ids of the matches whose I-feature falls inside it,
+ * so a growth iteration can fetch the spatial neighborhood of the current plane
+ * instead of rescanning all the matches.
+ */
+class MatchSpatialGrid
+{
+public:
+  MatchSpatialGrid(const std::vector<feature::SIOPointFeature>& featuresI,
+                   const matching::IndMatches& matches,
+                   std::size_t nbCellsPerSide = 16);
+
+  /**
+   * @brief Collect the ids of the matches whose I-feature lies inside the given
+   * region expanded by \c margin pixels.
+   * @param[in] xMin,yMin,xMax,yMax The region of interest in image I.
+   * @param[in] margin The expansion of the region, in pixels.
+   * @param[out] matchesId The ids (in the \c matches vector given at construction).
+   */
+  void getMatchesInRegion(double xMin, double yMin, double xMax, double yMax,
+                          double margin, std::vector<IndexT>& matchesId) const;
+
+  /// Span of a cell in pixels (the larger of the two axes).
+  double cellSize() const { return std::max(_cellSizeX, _cellSizeY); }
+
+private:
+  double _minX{0}, _minY{0};
+  double _cellSizeX{1}, _cellSizeY{1};
+  std::size_t _nbCellsPerSide{0};
+  /// Row-major _nbCellsPerSide x _nbCellsPerSide cells of match ids.
+  std::vector<std::vector<IndexT>> _cells;
+};
+
 /**
  * @brief Return all the matches in the same plane as the match \c seedMatchId with the corresponding homography.
  * @details This algorithm is detailed in [F.Srajer, 2016] algo. 1, p. 20.
@@ -80,6 +114,9 @@ struct GrowParameters
  * @param[out] planarMatchesIndices The indices (in the \c matches vector) of the really planar matches.
  * @param[out] transformation The homography associated to the plane.
  * @param[in] param The parameters of the algorihm.
+ * @param[in] spatialGrid Optional grid over the matches: when given, each growth
+ * iteration only tests the matches in the spatial neighborhood of the current
+ * plane support instead of all of them.
  * @return true if the \c transformation is different than the identity matrix.
  */
 bool growHomography(const std::vector<feature::SIOPointFeature> &featuresI,
@@ -88,7 +125,8 @@ bool growHomography(const std::vector<feature::SIOPointFeature> &featuresI,
                     const IndexT &seedMatchId,
                     std::set<IndexT> &planarMatchesIndices,
                     Mat3 &transformation,
-                    const GrowParameters& param);
+                    const GrowParameters& param,
+                    const MatchSpatialGrid* spatialGrid = nullptr);
 
 struct HGrowingFilteringParam
 {
@@ -17,6 +17,7 @@
 #include "aliceVision/sfmData/SfMData.hpp"
 #include "aliceVision/feature/RegionsPerView.hpp"
 #include "aliceVision/matchingImageCollection/GeometricFilterMatrix.hpp"
+#include "aliceVision/matchingImageCollection/geometricFilterUtils.hpp"
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -55,9 +56,14 @@ struct GeometricFilterMatrix_H_AC : public GeometricFilterMatrix
     if(descTypes.empty())
       return EstimationStatus(false, false);
 
-    // Retrieve all 2D features as undistorted positions into flat arrays
-    Mat xI, xJ;
-    MatchesPairToMat(pairIndex, putativeMatchesPerType, sfmData, regionsPerView, descTypes, xI, xJ);
+    // Retrieve all 2D features as undistorted positions into flat arrays,
+    // assembled in per-thread scratch memory (this runs for every image pair)
+    system::ScratchArena& arena = system::ScratchArena::threadLocal();
+    const system::ScratchArena::Scope scratch(arena);
+
+    const auto xIJ = MatchesPairToMat(pairIndex, putativeMatchesPerType, sfmData, regionsPerView, descTypes, arena);
+    const Eigen::Map<Mat>& xI = xIJ.first;
+    const Eigen::Map<Mat>& xJ = xIJ.second;
 
     // Define the AContrario adapted Homography matrix solver
     typedef ACKernelAdaptor<
@@ -31,13 +31,28 @@ class IImageCollectionMatcher
 
   virtual ~IImageCollectionMatcher() = default;
 
+  /// Folder usable to persist matcher internal data between runs (optional).
+  /// Matchers without precomputed structures can ignore it.
+  virtual void setCachePath(const std::string& folder) {}
+
   /// Find corresponding points between some pair of view Ids
   virtual void Match(
     const feature::RegionsPerView& regionsPerView,
-    const PairSet & pairs, // list of pair to consider for matching
+    const IPairsSource& pairs, // source of the pairs to consider for matching
     feature::EImageDescriberType descType,
     matching::PairwiseMatches & map_putatives_matches // the output pairwise photometric corresponding points
     ) const = 0;
+
+  /// Find corresponding points between some pair of view Ids
+  void Match(
+    const feature::RegionsPerView& regionsPerView,
+    const PairSet & pairs, // list of pair to consider for matching
+    feature::EImageDescriberType descType,
+    matching::PairwiseMatches & map_putatives_matches // the output pairwise photometric corresponding points
+    ) const
+  {
+    Match(regionsPerView, StaticPairsSource(pairs), descType, map_putatives_matches);
+  }
 };
 
 } // namespace aliceVision
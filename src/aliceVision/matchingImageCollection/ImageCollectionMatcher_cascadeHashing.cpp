@@ -12,6 +12,12 @@
 #include <aliceVision/config.hpp>
 
 #include <boost/progress.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <fstream>
+
+namespace fs = boost::filesystem;
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -29,13 +35,144 @@ ImageCollectionMatcher_cascadeHashing
 
 namespace impl
 {
+
+// On-disk cache of the hashed descriptions of one view.
+// The hashing projections are seeded deterministically (see CascadeHasher::Init)
+// and the zero mean descriptor is persisted next to the cache files, so the
+// cached hashes stay valid across pair partitions and across re-runs: growing
+// the dataset only requires hashing the new images.
+static const char HASHED_DESC_CACHE_MAGIC[4] = {'A', 'V', 'H', 'D'};
+static const unsigned char HASHED_DESC_CACHE_VERSION = 1;
+
+inline std::string hashedDescriptionsCachePath(const std::string& cacheFolder, IndexT viewId, EImageDescriberType descType)
+{
+  return (fs::path(cacheFolder) / (std::to_string(viewId) + "." + EImageDescriberType_enumToString(descType) + ".hashDesc")).string();
+}
+
+inline bool saveHashedDescriptions(const HashedDescriptions& hashedDescriptions, const std::string& filepath)
+{
+  std::ofstream stream(filepath.c_str(), std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+    return false;
+
+  stream.write(HASHED_DESC_CACHE_MAGIC, 4);
+  stream.write((const char*)&HASHED_DESC_CACHE_VERSION, sizeof(unsigned char));
+
+  const std::uint64_t nbDesc = hashedDescriptions.hashed_desc.size();
+  const std::uint32_t nbBits = (nbDesc == 0) ? 0 : hashedDescriptions.hashed_desc.front().hash_code.size();
+  const std::uint32_t nbBucketGroups = hashedDescriptions.buckets.size();
+  const std::uint32_t nbBucketsPerGroup = hashedDescriptions.buckets.empty() ? 0 : hashedDescriptions.buckets.front().size();
+  stream.write((const char*)&nbDesc, sizeof(std::uint64_t));
+  stream.write((const char*)&nbBits, sizeof(std::uint32_t));
+  stream.write((const char*)&nbBucketGroups, sizeof(std::uint32_t));
+  stream.write((const char*)&nbBucketsPerGroup, sizeof(std::uint32_t));
+
+  for (const auto& hashedDesc : hashedDescriptions.hashed_desc)
+  {
+    stream.write((const char*)hashedDesc.hash_code.data(), hashedDesc.hash_code.num_blocks() * sizeof(stl::dynamic_bitset::BlockType));
+    stream.write((const char*)hashedDesc.bucket_ids.data(), hashedDesc.bucket_ids.size() * sizeof(uint16_t));
+  }
+  return stream.good();
+}
+
+inline bool loadHashedDescriptions(HashedDescriptions& hashedDescriptions,
+                                   const std::string& filepath,
+                                   std::size_t expectedNbDesc,
+                                   std::size_t expectedNbBits)
+{
+  std::ifstream stream(filepath.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    return false;
+
+  char magic[4];
+  unsigned char version = 0;
+  stream.read(magic, 4);
+  stream.read((char*)&version, sizeof(unsigned char));
+  if (!stream.good()
+      || !std::equal(magic, magic + 4, HASHED_DESC_CACHE_MAGIC)
+      || version != HASHED_DESC_CACHE_VERSION)
+    return false;
+
+  std::uint64_t nbDesc = 0;
+  std::uint32_t nbBits = 0;
+  std::uint32_t nbBucketGroups = 0;
+  std::uint32_t nbBucketsPerGroup = 0;
+  stream.read((char*)&nbDesc, sizeof(std::uint64_t));
+  stream.read((char*)&nbBits, sizeof(std::uint32_t));
+  stream.read((char*)&nbBucketGroups, sizeof(std::uint32_t));
+  stream.read((char*)&nbBucketsPerGroup, sizeof(std::uint32_t));
+
+  // the cache is only reusable if it describes the same regions
+  if (!stream.good()
+      || nbDesc != expectedNbDesc
+      || (nbDesc != 0 && nbBits != expectedNbBits))
+    return false;
+
+  hashedDescriptions.hashed_desc.resize(nbDesc);
+  for (auto& hashedDesc : hashedDescriptions.hashed_desc)
+  {
+    hashedDesc.hash_code = stl::dynamic_bitset(nbBits);
+    stream.read((char*)const_cast<stl::dynamic_bitset::BlockType*>(hashedDesc.hash_code.data()),
+                hashedDesc.hash_code.num_blocks() * sizeof(stl::dynamic_bitset::BlockType));
+    hashedDesc.bucket_ids.resize(nbBucketGroups);
+    stream.read((char*)hashedDesc.bucket_ids.data(), nbBucketGroups * sizeof(uint16_t));
+  }
+  if (!stream.good())
+    return false;
+
+  // the buckets are rebuilt from the bucket ids rather than stored
+  hashedDescriptions.buckets.resize(nbBucketGroups);
+  for (std::size_t groupId = 0; groupId < nbBucketGroups; ++groupId)
+  {
+    hashedDescriptions.buckets[groupId].clear();
+    hashedDescriptions.buckets[groupId].resize(nbBucketsPerGroup);
+  }
+  for (std::size_t descId = 0; descId < nbDesc; ++descId)
+  {
+    const auto& bucketIds = hashedDescriptions.hashed_desc[descId].bucket_ids;
+    for (std::size_t groupId = 0; groupId < nbBucketGroups; ++groupId)
+    {
+      if (bucketIds[groupId] >= nbBucketsPerGroup)
+        return false;
+      hashedDescriptions.buckets[groupId][bucketIds[groupId]].push_back(descId);
+    }
+  }
+  return true;
+}
+
+inline bool loadZeroMeanDescriptor(Eigen::VectorXf& zeroMeanDescriptor, const std::string& filepath, std::size_t expectedDimension)
+{
+  std::ifstream stream(filepath.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    return false;
+  std::uint32_t dimension = 0;
+  stream.read((char*)&dimension, sizeof(std::uint32_t));
+  if (!stream.good() || dimension != expectedDimension)
+    return false;
+  zeroMeanDescriptor.resize(dimension);
+  stream.read((char*)zeroMeanDescriptor.data(), dimension * sizeof(float));
+  return stream.good();
+}
+
+inline bool saveZeroMeanDescriptor(const Eigen::VectorXf& zeroMeanDescriptor, const std::string& filepath)
+{
+  std::ofstream stream(filepath.c_str(), std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+    return false;
+  const std::uint32_t dimension = zeroMeanDescriptor.size();
+  stream.write((const char*)&dimension, sizeof(std::uint32_t));
+  stream.write((const char*)zeroMeanDescriptor.data(), dimension * sizeof(float));
+  return stream.good();
+}
+
 template <typename ScalarT>
 void Match
 (
   const feature::RegionsPerView& regionsPerView,
-  const PairSet & pairs,
+  const IPairsSource& pairs,
   EImageDescriberType descType,
   float fDistRatio,
+  const std::string& cacheFolder,
   PairwiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
 )
 {
@@ -43,14 +180,15 @@ void Match
 
   // Collect used view indexes
   std::set<IndexT> used_index;
-  // Sort pairs according the first index to minimize later memory swapping
+  // Group pairs according the first index to minimize later memory swapping
   typedef std::map<IndexT, std::vector<IndexT> > Map_vectorT;
   Map_vectorT map_Pairs;
-  for (PairSet::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
+  for (std::size_t p = 0; p < pairs.size(); ++p)
   {
-    map_Pairs[iter->first].push_back(iter->second);
-    used_index.insert(iter->first);
-    used_index.insert(iter->second);
+    const Pair pair = pairs.at(p);
+    map_Pairs[pair.first].push_back(pair.second);
+    used_index.insert(pair.first);
+    used_index.insert(pair.second);
   }
 
   typedef Eigen::Matrix<ScalarT, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
@@ -67,8 +205,22 @@ void Match
 
   std::map<IndexT, HashedDescriptions> hashed_base_;
 
-  // Compute the zero mean descriptor that will be used for hashing (one for all the image regions)
+  if (!cacheFolder.empty())
+    fs::create_directories(cacheFolder);
+
+  // Compute the zero mean descriptor that will be used for hashing (one for all the image regions).
+  // When a cache folder is set, the zero mean descriptor of the first run is persisted and reused,
+  // so that the hashed descriptions cached on disk stay valid while the dataset grows.
+  const std::string zeroMeanFilepath = cacheFolder.empty() ?
+    std::string() : (fs::path(cacheFolder) / "zeroMeanDescriptor.bin").string();
   Eigen::VectorXf zero_mean_descriptor;
+  bool zeroMeanFromCache = false;
+  if (!zeroMeanFilepath.empty() && !used_index.empty())
+  {
+    const feature::Regions& regions = regionsPerView.getRegions(*used_index.begin(), descType);
+    zeroMeanFromCache = loadZeroMeanDescriptor(zero_mean_descriptor, zeroMeanFilepath, regions.DescriptorLength());
+  }
+  if (!zeroMeanFromCache)
   {
     Eigen::MatrixXf matForZeroMean;
     for (int i =0; i < used_index.size(); ++i)
@@ -92,9 +244,12 @@ void Match
       }
     }
     zero_mean_descriptor = CascadeHasher::GetZeroMeanDescriptor(matForZeroMean);
+    if (!zeroMeanFilepath.empty())
+      saveZeroMeanDescriptor(zero_mean_descriptor, zeroMeanFilepath);
   }
 
-  // Index the input regions
+  // Index the input regions, reusing the hashed descriptions cached on disk
+  // by previous runs so that only the new views are hashed
   #pragma omp parallel for schedule(dynamic)
   for (int i =0; i < used_index.size(); ++i)
   {
@@ -106,9 +261,19 @@ void Match
       reinterpret_cast<const ScalarT*>(regionsI.DescriptorRawData());
     const size_t dimension = regionsI.DescriptorLength();
 
-    Eigen::Map<BaseMat> mat_I( (ScalarT*)tabI, regionsI.RegionCount(), dimension);
-    HashedDescriptions hashed_description = cascade_hasher.CreateHashedDescriptions(mat_I,
-      zero_mean_descriptor);
+    const std::string cacheFilepath = cacheFolder.empty() ?
+      std::string() : hashedDescriptionsCachePath(cacheFolder, I, descType);
+
+    HashedDescriptions hashed_description;
+    if (cacheFilepath.empty()
+        || !loadHashedDescriptions(hashed_description, cacheFilepath, regionsI.RegionCount(), dimension))
+    {
+      Eigen::Map<BaseMat> mat_I( (ScalarT*)tabI, regionsI.RegionCount(), dimension);
+      hashed_description = cascade_hasher.CreateHashedDescriptions(mat_I,
+        zero_mean_descriptor);
+      if (!cacheFilepath.empty())
+        saveHashedDescriptions(hashed_description, cacheFilepath);
+    }
     #pragma omp critical
     {
       hashed_base_[I] = std::move(hashed_description);
@@ -210,7 +375,7 @@ void Match
 void ImageCollectionMatcher_cascadeHashing::Match
 (
   const feature::RegionsPerView& regionsPerView,
-  const PairSet & pairs,
+  const IPairsSource& pairs,
   feature::EImageDescriberType descType,
   PairwiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
 ) const
@@ -234,6 +399,7 @@ void ImageCollectionMatcher_cascadeHashing::Match
       pairs,
       descType,
       f_dist_ratio_,
+      cache_folder_,
       map_PutativesMatches);
   }
   else
@@ -244,6 +410,7 @@ void ImageCollectionMatcher_cascadeHashing::Match
       pairs,
       descType,
       f_dist_ratio_,
+      cache_folder_,
       map_PutativesMatches);
   }
   else
@@ -29,17 +29,25 @@ class ImageCollectionMatcher_cascadeHashing : public IImageCollectionMatcher
     float dist_ratio
   );
 
+  /// Folder where the hashed descriptions of each view are persisted, so that
+  /// re-runs on a growing dataset only hash the new images.
+  void setCachePath(const std::string& folder) override { cache_folder_ = folder; }
+
+  using IImageCollectionMatcher::Match;
+
   /// Find corresponding points between some pair of view Ids
   void Match(
     const feature::RegionsPerView& regionsPerView,
-    const PairSet & pairs,
+    const IPairsSource& pairs,
     feature::EImageDescriberType descType,
     matching::PairwiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
-  ) const;
+  ) const override;
 
   private:
   // Distance ratio used to discard spurious correspondence
   float f_dist_ratio_;
+  // Folder for the on-disk hashed descriptions cache (empty: no cache)
+  std::string cache_folder_;
 };
 
 } // namespace aliceVision
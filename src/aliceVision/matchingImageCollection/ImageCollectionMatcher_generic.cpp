@@ -31,50 +31,41 @@ ImageCollectionMatcher_generic::ImageCollectionMatcher_generic(
 
 void ImageCollectionMatcher_generic::Match(
   const feature::RegionsPerView& regionsPerView,
-  const PairSet & pairs,
+  const IPairsSource& pairs,
   feature::EImageDescriberType descType,
   matching::PairwiseMatches & map_PutativesMatches)const // the pairwise photometric corresponding points
 {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENMP)
   ALICEVISION_LOG_DEBUG("Using the OPENMP thread interface");
 #endif
-  const bool b_multithreaded_pair_search = (_matcherType == CASCADE_HASHING_L2);
-  // -> set to true for CASCADE_HASHING_L2, since OpenMP instructions are not used in this matcher
-
   boost::progress_display my_progress_bar( pairs.size() );
 
-  // Sort pairs according the first index to minimize the MatcherT build operations
-  typedef std::map<size_t, std::vector<size_t> > Map_vectorT;
-  Map_vectorT map_Pairs;
-  for (PairSet::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
+  #pragma omp parallel
   {
-    map_Pairs[iter->first].push_back(iter->second);
-  }
+    // each thread caches the matcher of the last left view it has processed
+    // and accumulates its matches locally, merged once at the end, so the
+    // only synchronization inside the loop is the progress bar update.
+    // The pairs are generated on demand by the source, sorted by left view
+    // index, so consecutive iterations mostly share the same left view and
+    // the per-thread database matcher can be reused.
+    std::unique_ptr<matching::RegionsDatabaseMatcher> matcher;
+    IndexT matcherViewId = UndefinedIndexT;
+    std::vector<std::pair<Pair, IndMatches>> threadMatches;
 
-  // Perform matching between all the pairs
-  for (Map_vectorT::const_iterator iter = map_Pairs.begin();
-    iter != map_Pairs.end(); ++iter)
-  {
-    const size_t I = iter->first;
-    const std::vector<size_t> & indexToCompare = iter->second;
-
-    const feature::Regions & regionsI = regionsPerView.getRegions(I, descType);
-    if (regionsI.RegionCount() == 0)
+    // dynamic scheduling across all the pairs avoids idle cores at the tail
+    // of the stage when some left views have few candidate pairs
+    #pragma omp for schedule(dynamic)
+    for (int p = 0; p < (int)pairs.size(); ++p)
     {
-      my_progress_bar += indexToCompare.size();
-      continue;
-    }
+      const Pair pair = pairs.at(p);
+      const IndexT I = pair.first;
+      const IndexT J = pair.second;
 
-    // Initialize the matching interface
-    matching::RegionsDatabaseMatcher matcher(_matcherType, regionsI);
+      const feature::Regions & regionsI = regionsPerView.getRegions(I, descType);
+      const feature::Regions & regionsJ = regionsPerView.getRegions(J, descType);
 
-    #pragma omp parallel for schedule(dynamic) if(b_multithreaded_pair_search)
-    for (int j = 0; j < (int)indexToCompare.size(); ++j)
-    {
-      const size_t J = indexToCompare[j];
-
-      const feature::Regions &regionsJ = regionsPerView.getRegions(J, descType);
-      if (regionsJ.RegionCount() == 0
+      if (regionsI.RegionCount() == 0
+          || regionsJ.RegionCount() == 0
           || regionsI.Type_id() != regionsJ.Type_id())
       {
         #pragma omp critical
@@ -82,15 +73,32 @@ void ImageCollectionMatcher_generic::Match(
         continue;
       }
 
+      // Initialize the matching interface, or reuse the one of the previous
+      // iteration when the left view is unchanged
+      if (matcher == nullptr || matcherViewId != I)
+      {
+        matcher.reset(new matching::RegionsDatabaseMatcher(_matcherType, regionsI));
+        matcherViewId = I;
+      }
+
       IndMatches vec_putatives_matches;
-      matcher.Match(_f_dist_ratio, regionsJ, vec_putatives_matches);
+      matcher->Match(_f_dist_ratio, regionsJ, vec_putatives_matches);
+
       #pragma omp critical
+      ++my_progress_bar;
+
+      if (!vec_putatives_matches.empty())
       {
-        ++my_progress_bar;
-        if (!vec_putatives_matches.empty())
-        {
-          map_PutativesMatches[std::make_pair(I,J)].emplace(descType, std::move(vec_putatives_matches));
-        }
+        threadMatches.emplace_back(std::make_pair(I,J), std::move(vec_putatives_matches));
+      }
+    }
+
+    // merge the per-thread accumulated matches
+    #pragma omp critical
+    {
+      for (auto& threadMatch : threadMatches)
+      {
+        map_PutativesMatches[threadMatch.first].emplace(descType, std::move(threadMatch.second));
       }
     }
   }
@@ -28,13 +28,15 @@ class ImageCollectionMatcher_generic : public IImageCollectionMatcher
     matching::EMatcherType matcherType
   );
 
+  using IImageCollectionMatcher::Match;
+
   /// Find corresponding points between some pair of view Ids
   void Match(
     const feature::RegionsPerView& regionsPerView,
-    const PairSet & pairs,
+    const IPairsSource& pairs,
     feature::EImageDescriberType descType,
     matching::PairwiseMatches & map_PutativesMatches // the pairwise photometric corresponding points
-    ) const;
+    ) const override;
 
   private:
   // Distance ratio used to discard spurious correspondence
@@ -36,26 +36,6 @@ void copyInlierMatches(const std::vector<size_t> &inliers,
   }
 }
 
-void centerMatrix(const Eigen::Matrix2Xf & points2d, Mat3 & t)
-{
-  t = Mat3::Identity();
-
-  const Vec2f mean = points2d.rowwise().mean();
-  const auto nbPoints = points2d.cols();
-
-  Vec2f stdDev = ((points2d.colwise() - mean).cwiseAbs2().rowwise().sum()/(nbPoints - 1)).cwiseSqrt();
-
-  if(stdDev(0) < 0.1)
-    stdDev(0) = 0.1;
-  if(stdDev(1) < 0.1)
-    stdDev(1) = 0.1;
-
-  t << 1./stdDev(0), 0.,            -mean(0)/stdDev(0),
-          0.,            1./stdDev(1),  -mean(1)/stdDev(1),
-          0.,            0.,            1.;
-}
-
-
 void centeringMatrices(const std::vector<feature::SIOPointFeature> & featuresI,
                        const std::vector<feature::SIOPointFeature> & featuresJ,
                        const matching::IndMatches & matches,
@@ -79,9 +59,14 @@ void centeringMatrices(const std::vector<feature::SIOPointFeature> & featuresI,
       matchesId.insert(i);
   }
 
+  // this runs for every candidate transformation of the homography growing,
+  // keep the point matrices in per-thread scratch memory
+  system::ScratchArena& arena = system::ScratchArena::threadLocal();
+  const system::ScratchArena::Scope scratch(arena);
+
   int iMatch = 0;
-  Matf ptsI(2, nbMatches);
-  Matf ptsJ(2, nbMatches);
+  Eigen::Map<Matf> ptsI = system::mapMatrix<Matf>(arena, 2, nbMatches);
+  Eigen::Map<Matf> ptsJ = system::mapMatrix<Matf>(arena, 2, nbMatches);
 
   for (IndexT matchId : matchesId)
   {
@@ -150,8 +135,12 @@ void estimateAffinity(const std::vector<feature::SIOPointFeature> & featuresI,
       matchesId.insert(i);
   }
 
-  Mat M(Mat::Zero(2*nbMatches,6));
-  Vec b(2*nbMatches);
+  system::ScratchArena& arena = system::ScratchArena::threadLocal();
+  const system::ScratchArena::Scope scratch(arena);
+
+  Eigen::Map<Mat> M = system::mapMatrix<Mat>(arena, 2*nbMatches, 6);
+  Eigen::Map<Vec> b = system::mapMatrix<Vec>(arena, 2*nbMatches, 1);
+  M.setZero();
   int iMatch = 0;
   for (IndexT matchId : matchesId)
   {
@@ -203,7 +192,11 @@ void estimateHomography(const std::vector<feature::SIOPointFeature> &featuresI,
   Mat3 CI, CJ;
   centeringMatrices(featuresI, featuresJ, matches, CI, CJ, matchesId);
 
-  Mat A(Mat::Zero(2*nbMatches,9));
+  system::ScratchArena& arena = system::ScratchArena::threadLocal();
+  const system::ScratchArena::Scope scratch(arena);
+
+  Eigen::Map<Mat> A = system::mapMatrix<Mat>(arena, 2*nbMatches, 9);
+  A.setZero();
 
   IndexT iMatch = 0;
   for(IndexT matchId : matchesId)
@@ -222,7 +215,7 @@ void estimateHomography(const std::vector<feature::SIOPointFeature> &featuresI,
     ++iMatch;
   }
 
-  Eigen::JacobiSVD<Mat> svd(A, Eigen::ComputeThinU | Eigen::ComputeFullV);
+  const Eigen::JacobiSVD<Mat> svd = A.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeFullV);
   Vec h = svd.matrixV().rightCols(1);
   Mat3 H0;
   H0.row(0) = h.topRows(3).transpose();
@@ -265,6 +258,39 @@ void findTransformationInliers(const std::vector<feature::SIOPointFeature> &feat
   }
 }
 
+void findTransformationInliers(const std::vector<feature::SIOPointFeature> &featuresI,
+                               const std::vector<feature::SIOPointFeature> &featuresJ,
+                               const matching::IndMatches &matches,
+                               const std::vector<IndexT> &candidatesId,
+                               const Mat3 &transformation,
+                               double tolerance,
+                               std::set<IndexT> &inliersId)
+{
+  inliersId.clear();
+  const double squaredTolerance = Square(tolerance);
+
+#pragma omp parallel for
+  for (int iCandidate = 0; iCandidate < candidatesId.size(); ++iCandidate)
+  {
+    const IndexT iMatch = candidatesId.at(iCandidate);
+    const feature::SIOPointFeature & featI = featuresI.at(matches.at(iMatch)._i);
+    const feature::SIOPointFeature & featJ = featuresJ.at(matches.at(iMatch)._j);
+
+    const Vec2 ptI(featI.x(), featI.y());
+    const Vec2 ptJ(featJ.x(), featJ.y());
+
+    const Vec3 ptIp_hom = transformation * ptI.homogeneous();
+
+    const double dist = (ptJ - ptIp_hom.hnormalized()).squaredNorm();
+
+    if (dist < squaredTolerance)
+    {
+#pragma omp critical
+      inliersId.insert(iMatch);
+    }
+  }
+}
+
 void findTransformationInliers(const Mat2X& featuresI,
                                const Mat2X& featuresJ,
                                const matching::IndMatches &matches,
@@ -12,6 +12,9 @@
 #include <aliceVision/camera/IntrinsicBase.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/system/ScratchArena.hpp>
+
+#include <utility>
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -73,30 +76,26 @@ void fillMatricesWithUndistortFeaturesMatches(const matching::IndMatches &putati
 }
 
 /**
- * @brief Get un-distorted feature positions for the pair pairIndex from the Features_Provider interface
+ * @brief Fill pre-sized matrices with the un-distorted feature positions of all matches
  * @param[in] putativeMatchesPerType Matches of the 'pairIndex' pair
  * @param[in] cam_I
  * @param[in] cam_J
  * @param[in] features_I
  * @param[in] features_J
  * @param[in] descTypes
- * @param[out] x_I Pixel perfect features from the Inth image putativeMatches matches
- * @param[out] x_J Pixel perfect features from the Jnth image putativeMatches matches
+ * @param[out] x_I Pre-sized (2, getNbAllMatches()) matrix to fill for the Inth image
+ * @param[out] x_J Pre-sized (2, getNbAllMatches()) matrix to fill for the Jnth image
  */
 template<typename MatT, class MapFeatOrRegionPerDesc>
-void MatchesPairToMat(const matching::MatchesPerDescType &putativeMatchesPerType,
-                      const camera::IntrinsicBase *cam_I,
-                      const camera::IntrinsicBase *cam_J,
-                      const MapFeatOrRegionPerDesc &features_I,
-                      const MapFeatOrRegionPerDesc &features_J,
-                      const std::vector<feature::EImageDescriberType> &descTypes,
-                      MatT &x_I, MatT &x_J)
+void fillMatricesWithMatches(const matching::MatchesPerDescType &putativeMatchesPerType,
+                             const camera::IntrinsicBase *cam_I,
+                             const camera::IntrinsicBase *cam_J,
+                             const MapFeatOrRegionPerDesc &features_I,
+                             const MapFeatOrRegionPerDesc &features_J,
+                             const std::vector<feature::EImageDescriberType> &descTypes,
+                             MatT &x_I, MatT &x_J)
 {
-  // Create the output matrices with all matched features for images I and J
-  const size_t n = putativeMatchesPerType.getNbAllMatches();
-  x_I.resize(2, n);
-  x_J.resize(2, n);
-
+  // x_I and x_J are expected to be sized (2, getNbAllMatches()) already
   size_t y = 0;
   for (const auto& descType : descTypes)
   {
@@ -128,6 +127,59 @@ void MatchesPairToMat(const matching::MatchesPerDescType &putativeMatchesPerType
   }
 }
 
+/**
+ * @brief Get un-distorted feature positions for the pair pairIndex from the Features_Provider interface
+ * @param[in] putativeMatchesPerType Matches of the 'pairIndex' pair
+ * @param[in] cam_I
+ * @param[in] cam_J
+ * @param[in] features_I
+ * @param[in] features_J
+ * @param[in] descTypes
+ * @param[out] x_I Pixel perfect features from the Inth image putativeMatches matches
+ * @param[out] x_J Pixel perfect features from the Jnth image putativeMatches matches
+ */
+template<typename MatT, class MapFeatOrRegionPerDesc>
+void MatchesPairToMat(const matching::MatchesPerDescType &putativeMatchesPerType,
+                      const camera::IntrinsicBase *cam_I,
+                      const camera::IntrinsicBase *cam_J,
+                      const MapFeatOrRegionPerDesc &features_I,
+                      const MapFeatOrRegionPerDesc &features_J,
+                      const std::vector<feature::EImageDescriberType> &descTypes,
+                      MatT &x_I, MatT &x_J)
+{
+  // Create the output matrices with all matched features for images I and J
+  const size_t n = putativeMatchesPerType.getNbAllMatches();
+  x_I.resize(2, n);
+  x_J.resize(2, n);
+
+  fillMatricesWithMatches(putativeMatchesPerType, cam_I, cam_J, features_I, features_J, descTypes, x_I, x_J);
+}
+
+/**
+ * @brief Variant of MatchesPairToMat backed by per-thread scratch memory: the
+ * matrices are mapped onto the arena instead of being heap-allocated, so the
+ * per-pair temporaries of the geometric filters cost a pointer bump only.
+ * The returned maps live until the enclosing system::ScratchArena::Scope is destroyed.
+ */
+template<class MapFeatOrRegionPerDesc>
+std::pair<Eigen::Map<Mat>, Eigen::Map<Mat>>
+MatchesPairToMat(const matching::MatchesPerDescType &putativeMatchesPerType,
+                 const camera::IntrinsicBase *cam_I,
+                 const camera::IntrinsicBase *cam_J,
+                 const MapFeatOrRegionPerDesc &features_I,
+                 const MapFeatOrRegionPerDesc &features_J,
+                 const std::vector<feature::EImageDescriberType> &descTypes,
+                 system::ScratchArena &arena)
+{
+  const size_t n = putativeMatchesPerType.getNbAllMatches();
+  Eigen::Map<Mat> x_I = system::mapMatrix<Mat>(arena, 2, n);
+  Eigen::Map<Mat> x_J = system::mapMatrix<Mat>(arena, 2, n);
+
+  fillMatricesWithMatches(putativeMatchesPerType, cam_I, cam_J, features_I, features_J, descTypes, x_I, x_J);
+
+  return std::make_pair(x_I, x_J);
+}
+
 /**
  * @brief Get un-distorted feature positions for the pair pairIndex from the RegionsPerView interface
  * @param[in] pairIndex Pair from which you need to extract the corresponding points
@@ -162,6 +214,35 @@ void MatchesPairToMat(const Pair &pairIndex,
       x_I, x_J);
 }
 
+/**
+ * @brief Variant of the RegionsPerView overload backed by per-thread scratch memory.
+ * The returned maps live until the enclosing system::ScratchArena::Scope is destroyed.
+ */
+inline std::pair<Eigen::Map<Mat>, Eigen::Map<Mat>>
+MatchesPairToMat(const Pair &pairIndex,
+                 const matching::MatchesPerDescType &putativeMatchesPerType,
+                 const sfmData::SfMData *sfmData,
+                 const feature::RegionsPerView &regionsPerView,
+                 const std::vector<feature::EImageDescriberType> &descTypes,
+                 system::ScratchArena &arena)
+{
+  const sfmData::View * view_I = sfmData->views.at(pairIndex.first).get();
+  const sfmData::View * view_J = sfmData->views.at(pairIndex.second).get();
+
+  // Retrieve corresponding pair camera intrinsic if any
+  const camera::IntrinsicBase * cam_I = sfmData->getIntrinsicPtr(view_I->getIntrinsicId());
+  const camera::IntrinsicBase * cam_J = sfmData->getIntrinsicPtr(view_J->getIntrinsicId());
+
+  return MatchesPairToMat(
+      putativeMatchesPerType,
+      cam_I,
+      cam_J,
+      regionsPerView.getRegionsPerDesc(pairIndex.first),
+      regionsPerView.getRegionsPerDesc(pairIndex.second),
+      descTypes,
+      arena);
+}
+
 /**
 * @brief copyInlierMatches
 * @param[in] inliers
@@ -177,10 +258,31 @@ void copyInlierMatches(const std::vector<size_t> &inliers,
 /**
  * @brief Compute the transformation that standardize the input points so that
  * they are z-scores (i.e. zero mean and unit standard deviation).
- * @param[in] points2d The 2D inputs points.
+ * @param[in] points2d The 2D inputs points (2 x n matrix or expression).
  * @param[out] t the transformation that standardize the points.
  */
-void centerMatrix(const Eigen::Matrix2Xf & points2d, Mat3 & t);
+template<typename Derived>
+void centerMatrix(const Eigen::MatrixBase<Derived> & points2d, Mat3 & t)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef Eigen::Matrix<Scalar, 2, 1> Vec2T;
+
+  t = Mat3::Identity();
+
+  const Vec2T mean = points2d.rowwise().mean();
+  const auto nbPoints = points2d.cols();
+
+  Vec2T stdDev = ((points2d.colwise() - mean).cwiseAbs2().rowwise().sum()/(nbPoints - 1)).cwiseSqrt();
+
+  if(stdDev(0) < 0.1)
+    stdDev(0) = 0.1;
+  if(stdDev(1) < 0.1)
+    stdDev(1) = 0.1;
+
+  t << 1./stdDev(0), 0.,            -mean(0)/stdDev(0),
+          0.,            1./stdDev(1),  -mean(1)/stdDev(1),
+          0.,            0.,            1.;
+}
 
 /**
  * @brief Compute the standardizing tranformation for the input features.
@@ -249,8 +351,27 @@ void estimateHomography(const std::vector<feature::SIOPointFeature> & featuresI,
  * @param[in] inliersId The index in the \c matches vector.
  */
 void findTransformationInliers(const std::vector<feature::SIOPointFeature> & featuresI,
-                               const std::vector<feature::SIOPointFeature> & featuresJ, 
+                               const std::vector<feature::SIOPointFeature> & featuresJ,
+                               const matching::IndMatches & matches,
+                               const Mat3 & transformation,
+                               double tolerance,
+                               std::set<IndexT> & inliersId);
+
+/**
+ * @brief Same as above restricted to a subset of the matches: only the ids listed
+ * in \c candidatesId are tested against the transformation.
+ * @param[in] featuresI
+ * @param[in] featuresJ
+ * @param[in] matches The matches to test.
+ * @param[in] candidatesId The ids (in the \c matches vector) of the matches to test.
+ * @param[in] transformation The 3x3 transformation matrix.
+ * @param[in] tolerance The tolerated pixel error.
+ * @param[out] inliersId The found inliers ids (in the \c matches vector).
+ */
+void findTransformationInliers(const std::vector<feature::SIOPointFeature> & featuresI,
+                               const std::vector<feature::SIOPointFeature> & featuresJ,
                                const matching::IndMatches & matches,
+                               const std::vector<IndexT> & candidatesId,
                                const Mat3 & transformation,
                                double tolerance,
                                std::set<IndexT> & inliersId);
@@ -11,13 +11,55 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <cstdint>
 #include <set>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 namespace aliceVision {
 
+ExhaustivePairsSource::ExhaustivePairsSource(const sfmData::Views& views, int rangeStart, int rangeSize)
+{
+  _viewIds.reserve(views.size());
+  for(const auto& viewPair : views)
+    _viewIds.push_back(viewPair.first);
+  std::sort(_viewIds.begin(), _viewIds.end());
+
+  _rangeStart = 0;
+  _rangeEnd = _viewIds.size();
+
+  // If we have a rangeStart, only generate the pairs (rangeStart, X).
+  if(rangeStart != -1 && rangeSize != 0)
+  {
+    _rangeStart = std::min(static_cast<std::size_t>(rangeStart), _viewIds.size());
+    _rangeEnd = std::min(static_cast<std::size_t>(rangeStart + rangeSize), _viewIds.size());
+  }
+
+  _cumulatedPairs.reserve(_rangeEnd - _rangeStart + 1);
+  _cumulatedPairs.push_back(0);
+  for(std::size_t i = _rangeStart; i < _rangeEnd; ++i)
+    _cumulatedPairs.push_back(_cumulatedPairs.back() + (_viewIds.size() - i - 1));
+}
+
+Pair ExhaustivePairsSource::at(std::size_t index) const
+{
+  // the left view is the last one with a cumulated pair count <= index
+  const auto it = std::upper_bound(_cumulatedPairs.begin(), _cumulatedPairs.end(), index);
+  const std::size_t left = _rangeStart + std::distance(_cumulatedPairs.begin(), it) - 1;
+  const std::size_t right = left + 1 + (index - *(it - 1));
+  return Pair(_viewIds[left], _viewIds[right]);
+}
+
+void ExhaustivePairsSource::getUsedViews(std::set<IndexT>& viewIds) const
+{
+  if(_rangeStart >= _rangeEnd)
+    return;
+  // every view from the first left view of the range on is a right view candidate
+  viewIds.insert(_viewIds.begin() + _rangeStart, _viewIds.end());
+}
+
 /// Generate all the (I,J) pairs of the upper diagonal of the NxN matrix
 PairSet exhaustivePairs(const sfmData::Views& views, int rangeStart, int rangeSize)
 {
@@ -45,17 +87,90 @@ PairSet exhaustivePairs(const sfmData::Views& views, int rangeStart, int rangeSi
   return pairs;
 }
 
+// Compact binary pair list format: each view id list is stored as raw
+// 32 bit unsigned integers, a group per left image like the text format.
+static const char PAIR_LIST_MAGIC[4] = {'A', 'V', 'P', 'L'};
+static const unsigned char PAIR_LIST_VERSION = 1;
+
+/// Read a binary pair list, the stream is positioned after the magic
+static bool loadPairsFromBinary(std::istream& in,
+                                const std::string& sFileName,
+                                PairSet& pairs,
+                                int rangeStart,
+                                int rangeSize)
+{
+  unsigned char version = 0;
+  std::uint64_t nbGroups = 0;
+  in.read((char*)&version, sizeof(unsigned char));
+  in.read((char*)&nbGroups, sizeof(std::uint64_t));
+  if(!in.good() || version != PAIR_LIST_VERSION)
+  {
+    ALICEVISION_LOG_WARNING("loadPairs: Invalid binary pair list: \"" << sFileName << "\".");
+    return false;
+  }
+
+  // the range applies per left image group, like the lines of the text format
+  for(std::uint64_t nbGroup = 0; nbGroup < nbGroups; ++nbGroup)
+  {
+    std::uint32_t I = 0;
+    std::uint32_t nbNeighbors = 0;
+    in.read((char*)&I, sizeof(std::uint32_t));
+    in.read((char*)&nbNeighbors, sizeof(std::uint32_t));
+    if(!in.good())
+    {
+      ALICEVISION_LOG_WARNING("loadPairs: Truncated binary pair list: \"" << sFileName << "\".");
+      return false;
+    }
+
+    if((rangeStart != -1 && rangeSize != 0) &&
+       (nbGroup < std::uint64_t(rangeStart) || nbGroup >= std::uint64_t(rangeStart + rangeSize)))
+    {
+      in.seekg(nbNeighbors * sizeof(std::uint32_t), std::ios::cur);
+      continue;
+    }
+
+    std::vector<std::uint32_t> neighbors(nbNeighbors);
+    in.read((char*)neighbors.data(), nbNeighbors * sizeof(std::uint32_t));
+    if(!in.good())
+    {
+      ALICEVISION_LOG_WARNING("loadPairs: Truncated binary pair list: \"" << sFileName << "\".");
+      return false;
+    }
+
+    for(const std::uint32_t J : neighbors)
+    {
+      if(I == J)
+      {
+        ALICEVISION_LOG_WARNING("loadPairs: Invalid input file. Image " << I << " see itself. File: \"" << sFileName << "\".");
+        return false;
+      }
+      pairs.insert((I < J) ? std::make_pair(I, J) : std::make_pair(J, I));
+    }
+  }
+  return true;
+}
+
 bool loadPairs(const std::string &sFileName,
                PairSet & pairs,
                int rangeStart,
                int rangeSize)
 {
-  std::ifstream in(sFileName.c_str());
+  std::ifstream in(sFileName.c_str(), std::ios::in | std::ios::binary);
   if(!in.is_open())
   {
     ALICEVISION_LOG_WARNING("loadPairs: Impossible to read the specified file: \"" << sFileName << "\".");
     return false;
   }
+
+  // binary pair lists are identified by their magic, anything else is text
+  char magic[4];
+  in.read(magic, 4);
+  if(in.good() && std::equal(magic, magic + 4, PAIR_LIST_MAGIC))
+    return loadPairsFromBinary(in, sFileName, pairs, rangeStart, rangeSize);
+
+  in.clear();
+  in.seekg(0, std::ios::beg);
+
   std::size_t nbLine = 0;
   std::string sValue;
 
@@ -106,6 +221,36 @@ bool loadPairs(const std::string &sFileName,
   return true;
 }
 
+bool savePairsToBinary(const std::string &sFileName, const std::map<IndexT, std::vector<IndexT> >& pairsPerImage)
+{
+  std::ofstream outStream(sFileName.c_str(), std::ios::out | std::ios::binary);
+  if(!outStream.is_open())
+  {
+    ALICEVISION_LOG_WARNING("savePairsToBinary: Impossible to open the output specified file: \"" << sFileName << "\".");
+    return false;
+  }
+
+  outStream.write(PAIR_LIST_MAGIC, 4);
+  outStream.write((const char*)&PAIR_LIST_VERSION, sizeof(unsigned char));
+
+  const std::uint64_t nbGroups = pairsPerImage.size();
+  outStream.write((const char*)&nbGroups, sizeof(std::uint64_t));
+
+  for(const auto& group : pairsPerImage)
+  {
+    const std::uint32_t I = group.first;
+    const std::uint32_t nbNeighbors = group.second.size();
+    outStream.write((const char*)&I, sizeof(std::uint32_t));
+    outStream.write((const char*)&nbNeighbors, sizeof(std::uint32_t));
+    for(const IndexT neighbor : group.second)
+    {
+      const std::uint32_t J = neighbor;
+      outStream.write((const char*)&J, sizeof(std::uint32_t));
+    }
+  }
+  return !outStream.bad();
+}
+
 bool savePairs(const std::string &sFileName, const PairSet & pairs)
 {
   std::ofstream outStream(sFileName.c_str());
@@ -11,13 +11,110 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 
 #include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace aliceVision {
 
+/**
+ * @brief Random access source of candidate image pairs.
+ *
+ * The image collection matchers iterate the pairs by index, so a source can
+ * generate them on demand instead of materializing a PairSet: with tens of
+ * thousands of views the exhaustive pair set alone does not fit in memory.
+ * The pairs are expected to be sorted by left view id so that consecutive
+ * indexes mostly share the same left view.
+ */
+class IPairsSource
+{
+public:
+  virtual ~IPairsSource() = default;
+
+  /// Number of candidate pairs
+  virtual std::size_t size() const = 0;
+
+  /// i-th candidate pair
+  virtual Pair at(std::size_t index) const = 0;
+
+  /// Collect the view ids referenced by at least one pair
+  virtual void getUsedViews(std::set<IndexT>& viewIds) const = 0;
+};
+
+/**
+ * @brief Pairs source over an already materialized list of pairs
+ * (predefined pair list, incremental matching work list, ...).
+ */
+class StaticPairsSource : public IPairsSource
+{
+public:
+  explicit StaticPairsSource(PairVec pairs)
+    : _pairs(std::move(pairs))
+  {}
+
+  explicit StaticPairsSource(const PairSet& pairs)
+    : _pairs(pairs.begin(), pairs.end())
+  {}
+
+  std::size_t size() const override
+  {
+    return _pairs.size();
+  }
+
+  Pair at(std::size_t index) const override
+  {
+    return _pairs[index];
+  }
+
+  void getUsedViews(std::set<IndexT>& viewIds) const override
+  {
+    for(const auto& pair : _pairs)
+    {
+      viewIds.insert(pair.first);
+      viewIds.insert(pair.second);
+    }
+  }
+
+private:
+  PairVec _pairs;
+};
+
+/**
+ * @brief Lazily generates all the (I,J) pairs of the upper diagonal of the
+ * NxN view matrix, restricted to an optional range of left views.
+ *
+ * Only the sorted view ids and the cumulated pair counts of the range are
+ * stored, each pair is computed on demand from its index.
+ */
+class ExhaustivePairsSource : public IPairsSource
+{
+public:
+  ExhaustivePairsSource(const sfmData::Views& views, int rangeStart = -1, int rangeSize = 0);
+
+  std::size_t size() const override
+  {
+    return _cumulatedPairs.back();
+  }
+
+  Pair at(std::size_t index) const override;
+
+  void getUsedViews(std::set<IndexT>& viewIds) const override;
+
+private:
+  /// sorted view ids
+  std::vector<IndexT> _viewIds;
+  /// first left view of the range
+  std::size_t _rangeStart = 0;
+  /// one past the last left view of the range
+  std::size_t _rangeEnd = 0;
+  /// number of pairs before each left view of the range, plus the total
+  std::vector<std::size_t> _cumulatedPairs;
+};
+
 /// Generate all the (I,J) pairs of the upper diagonal of the NxN matrix
 PairSet exhaustivePairs(const sfmData::Views& views, int rangeStart=-1, int rangeSize=0);
 
-/// Load a set of PairSet from a file
+/// Load a set of PairSet from a file (text pair list or compact binary pair list)
 /// I J K L (pair that link I)
 bool loadPairs(
      const std::string &sFileName, // filename of the list file,
@@ -25,6 +122,10 @@ bool loadPairs(
      int rangeStart=-1,
      int rangeSize=0);
 
+/// Save pairs grouped per left image to the compact binary pair list format,
+/// readable back by loadPairs
+bool savePairsToBinary(const std::string &sFileName, const std::map<IndexT, std::vector<IndexT> >& pairsPerImage);
+
 /// Save a set of PairSet to a file (one pair per line)
 /// I J
 /// I K
@@ -9,9 +9,12 @@
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
+#include <aliceVision/stl/indexedSort.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/filesystem.hpp>
 
+#include <cmath>
 #include <fstream>
 #include <map>
 
@@ -30,6 +33,68 @@ Mesh::~Mesh()
     delete tris;
 }
 
+void Mesh::PointsSoA::fromPoints(const StaticVector<Point3d>* pts)
+{
+    const int npts = (pts == nullptr) ? 0 : pts->size();
+    x.resize(npts);
+    y.resize(npts);
+    z.resize(npts);
+    for(int i = 0; i < npts; ++i)
+    {
+        const Point3d& p = (*pts)[i];
+        x[i] = static_cast<float>(p.x);
+        y[i] = static_cast<float>(p.y);
+        z[i] = static_cast<float>(p.z);
+    }
+}
+
+void Mesh::PointsSoA::toPoints(StaticVector<Point3d>* pts) const
+{
+    for(int i = 0; i < size(); ++i)
+    {
+        Point3d& p = (*pts)[i];
+        p.x = x[i];
+        p.y = y[i];
+        p.z = z[i];
+    }
+}
+
+void Mesh::PointsSoA::applyTransform(const Matrix3x4& t)
+{
+    const int npts = size();
+    float* xs = x.getDataWritable().data();
+    float* ys = y.getDataWritable().data();
+    float* zs = z.getDataWritable().data();
+    // plain per-component arithmetic over contiguous floats, auto-vectorizes
+    for(int i = 0; i < npts; ++i)
+    {
+        const float px = xs[i];
+        const float py = ys[i];
+        const float pz = zs[i];
+        xs[i] = static_cast<float>(t.m11 * px + t.m12 * py + t.m13 * pz + t.m14);
+        ys[i] = static_cast<float>(t.m21 * px + t.m22 * py + t.m23 * pz + t.m24);
+        zs[i] = static_cast<float>(t.m31 * px + t.m32 * py + t.m33 * pz + t.m34);
+    }
+}
+
+const Mesh::PointsSoA& Mesh::getPtsSoA()
+{
+    // pts is public, so stale views cannot be caught automatically: rebuild when
+    // flagged or when the vertex count visibly changed under us
+    const int npts = (pts == nullptr) ? 0 : pts->size();
+    if(_ptsSoADirty || (_ptsSoA.size() != npts))
+    {
+        _ptsSoA.fromPoints(pts);
+        _ptsSoADirty = false;
+    }
+    return _ptsSoA;
+}
+
+void Mesh::invalidatePtsSoA()
+{
+    _ptsSoADirty = true;
+}
+
 void Mesh::saveToObj(const std::string& filename)
 {
   ALICEVISION_LOG_INFO("Save mesh to obj: " << filename);
@@ -65,16 +130,39 @@ bool Mesh::loadFromBin(std::string binFileName)
     }
 
     int npts;
-    fread(&npts, sizeof(int), 1, f);
-    pts = new StaticVector<Point3d>();
-    pts->resize(npts);
-    fread(&(*pts)[0], sizeof(Point3d), npts, f);
     int ntris;
-    fread(&ntris, sizeof(int), 1, f);
-    tris = new StaticVector<Mesh::triangle>();
-    tris->resize(ntris);
-    fread(&(*tris)[0], sizeof(Mesh::triangle), ntris, f);
+    fread(&npts, sizeof(int), 1, f);
+    if(npts == -1) // versioned header, see saveToBin
+    {
+        int version;
+        fread(&version, sizeof(int), 1, f);
+        if(version != binFileVersion)
+        {
+            ALICEVISION_LOG_ERROR("loadFromBin: unsupported mesh file version " << version << ": " << binFileName);
+            fclose(f);
+            return false;
+        }
+        fread(&npts, sizeof(int), 1, f);
+        fread(&ntris, sizeof(int), 1, f);
+        pts = new StaticVector<Point3d>();
+        pts->resize(npts);
+        fread(&(*pts)[0], sizeof(Point3d), npts, f);
+        tris = new StaticVector<Mesh::triangle>();
+        tris->resize(ntris);
+        fread(&(*tris)[0], sizeof(Mesh::triangle), ntris, f);
+    }
+    else // legacy layout: counts interleaved with the arrays
+    {
+        pts = new StaticVector<Point3d>();
+        pts->resize(npts);
+        fread(&(*pts)[0], sizeof(Point3d), npts, f);
+        fread(&ntris, sizeof(int), 1, f);
+        tris = new StaticVector<Mesh::triangle>();
+        tris->resize(ntris);
+        fread(&(*tris)[0], sizeof(Mesh::triangle), ntris, f);
+    }
     fclose(f);
+    invalidatePtsSoA();
 
     return true;
 }
@@ -83,21 +171,21 @@ void Mesh::saveToBin(std::string binFileName)
 {
     long t = std::clock();
     ALICEVISION_LOG_DEBUG("Save mesh to bin.");
-    // printf("open\n");
     FILE* f = fopen(binFileName.c_str(), "wb");
+    // header of 4 ints so that both arrays are naturally aligned in the file and
+    // MeshBinView can map them directly; the -1 marker distinguishes versioned
+    // files from legacy ones, which start with the point count
+    int marker = -1;
+    int version = binFileVersion;
     int npts = pts->size();
-    // printf("write npts %i\n",npts);
-    fwrite(&npts, sizeof(int), 1, f);
-    // printf("write pts\n");
-    fwrite(&(*pts)[0], sizeof(Point3d), npts, f);
     int ntris = tris->size();
-    // printf("write ntris %i\n",ntris);
+    fwrite(&marker, sizeof(int), 1, f);
+    fwrite(&version, sizeof(int), 1, f);
+    fwrite(&npts, sizeof(int), 1, f);
     fwrite(&ntris, sizeof(int), 1, f);
-    // printf("write tris\n");
+    fwrite(&(*pts)[0], sizeof(Point3d), npts, f);
     fwrite(&(*tris)[0], sizeof(Mesh::triangle), ntris, f);
-    // printf("close\n");
     fclose(f);
-    // printf("done\n");
     mvsUtils::printfElapsedTime(t, "Save mesh to bin ");
 }
 
@@ -182,6 +270,7 @@ void Mesh::addMesh(Mesh* me)
         }
         pts = ptsnew;
         tris = trisnew;
+        invalidatePtsSoA();
     }
 }
 
@@ -519,7 +608,13 @@ StaticVector<StaticVector<int>*>* Mesh::getPtsNeighborTriangles()
         vertexNeighborhoodPairs.push_back(Voxel((*tris)[i].v[1], i, 0));
         vertexNeighborhoodPairs.push_back(Voxel((*tris)[i].v[2], i, 0));
     }
-    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    {
+        // parallel radix sort by vertex index: the pair array is three entries
+        // per triangle, far too large for a single threaded comparison sort
+        StaticVector<Voxel> buffer(vertexNeighborhoodPairs.size());
+        stl::indexed_sort::radix_sort_by_key(&vertexNeighborhoodPairs[0], &buffer[0], vertexNeighborhoodPairs.size(),
+                                             [](const Voxel& v) { return stl::indexed_sort::radix_key_bits(v.x); });
+    }
 
     int i = 0; // index of the unique pair of <vertex, neighborhood>
     int j = 0; // index of the vertex
@@ -566,6 +661,80 @@ StaticVector<StaticVector<int>*>* Mesh::getPtsNeighborTriangles()
     return out_ptsNeighTris;
 }
 
+void Mesh::getPtsNeighborTriangles(StaticVectorOfVector<int>& out_ptsNeighTris)
+{
+    // array of tuples <x: vertexIndex, y: triangleIndex, z: numberOfNeighbors>
+    StaticVector<Voxel> vertexNeighborhoodPairs;
+    vertexNeighborhoodPairs.reserve(tris->size() * 3);
+    for(int i = 0; i < tris->size(); ++i)
+    {
+        vertexNeighborhoodPairs.push_back(Voxel((*tris)[i].v[0], i, 0));
+        vertexNeighborhoodPairs.push_back(Voxel((*tris)[i].v[1], i, 0));
+        vertexNeighborhoodPairs.push_back(Voxel((*tris)[i].v[2], i, 0));
+    }
+    {
+        // parallel radix sort by vertex index: the pair array is three entries
+        // per triangle, far too large for a single threaded comparison sort
+        StaticVector<Voxel> buffer(vertexNeighborhoodPairs.size());
+        stl::indexed_sort::radix_sort_by_key(&vertexNeighborhoodPairs[0], &buffer[0], vertexNeighborhoodPairs.size(),
+                                             [](const Voxel& v) { return stl::indexed_sort::radix_key_bits(v.x); });
+    }
+
+    int i = 0; // index of the unique pair of <vertex, neighborhood>
+    int j = 0; // index of the vertex
+    int k = 0; // number of neighbors
+    int firstid = 0;
+    while(i < vertexNeighborhoodPairs.size())
+    {
+        k++;
+        if((i == vertexNeighborhoodPairs.size() - 1) || (vertexNeighborhoodPairs[i].x != vertexNeighborhoodPairs[i + 1].x))
+        {
+            vertexNeighborhoodPairs[firstid].z = k; // store the number of neighbors
+            ++j;
+            firstid = i + 1;
+            k = 0;
+        }
+        ++i;
+    }
+    int npts = j;
+
+    out_ptsNeighTris.clear();
+    out_ptsNeighTris.reserve(pts->size(), vertexNeighborhoodPairs.size());
+
+    // the pairs are sorted by vertex index, so the groups can be appended in order
+    StaticVector<int> triTmp;
+    i = 0;
+    int nextPtId = 0;
+    for(j = 0; j < npts; ++j)
+    {
+        int middlePtId = vertexNeighborhoodPairs[i].x;
+        int nbNeighbors = vertexNeighborhoodPairs[i].z;
+        int i0 = i;
+        int i1 = i + nbNeighbors;
+        i = i1;
+
+        while(nextPtId < middlePtId) // points without any neighbor triangle
+        {
+            out_ptsNeighTris.addEmptyVector();
+            ++nextPtId;
+        }
+
+        triTmp.clear();
+        triTmp.reserve(nbNeighbors);
+        for(int l = i0; l < i1; ++l)
+        {
+            triTmp.push_back(vertexNeighborhoodPairs[l].y); // index of triangle
+        }
+        out_ptsNeighTris.addVector(triTmp);
+        ++nextPtId;
+    }
+    while(nextPtId < pts->size())
+    {
+        out_ptsNeighTris.addEmptyVector();
+        ++nextPtId;
+    }
+}
+
 StaticVector<StaticVector<int>*>* Mesh::getPtsNeighPtsOrdered()
 {
     StaticVector<StaticVector<int>*>* ptsNeighborTriangles = getPtsNeighborTriangles();
@@ -1176,7 +1345,12 @@ void Mesh::getNotOrientedEdges(StaticVector<StaticVector<int>*>** edgesNeighTris
         edges->push_back(Voxel(std::min(c, a), std::max(c, a), i));
     }
 
-    qsort(&(*edges)[0], edges->size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    {
+        // parallel radix sort by the lower vertex index of each edge
+        StaticVector<Voxel> buffer(edges->size());
+        stl::indexed_sort::radix_sort_by_key(&(*edges)[0], &buffer[0], edges->size(),
+                                             [](const Voxel& v) { return stl::indexed_sort::radix_key_bits(v.x); });
+    }
 
     StaticVector<StaticVector<int>*>* _edgesNeighTris = new StaticVector<StaticVector<int>*>();
     StaticVector<Pixel>* _edgesPointsPairs = new StaticVector<Pixel>();
@@ -1308,6 +1482,7 @@ void Mesh::laplacianSmoothPts(StaticVector<StaticVector<int>*>* ptsNeighPts, dou
     {
         (*pts)[i] = (*pts)[i] + (*nms)[i];
     }
+    invalidatePtsSoA();
 
     delete nms;
 }
@@ -1319,6 +1494,52 @@ Point3d Mesh::computeTriangleNormal(int idTri)
         .normalize();
 }
 
+void Mesh::computeTriangleNormalsSoA(StaticVector<float>& nx, StaticVector<float>& ny, StaticVector<float>& nz)
+{
+    const PointsSoA& soa = getPtsSoA();
+    const float* xs = soa.x.getData().data();
+    const float* ys = soa.y.getData().data();
+    const float* zs = soa.z.getData().data();
+
+    const int ntris = tris->size();
+    nx.resize(ntris);
+    ny.resize(ntris);
+    nz.resize(ntris);
+
+    for(int i = 0; i < ntris; ++i)
+    {
+        const int a = (*tris)[i].v[0];
+        const int b = (*tris)[i].v[1];
+        const int c = (*tris)[i].v[2];
+
+        // same construction as computeTriangleNormal: normalized edges, cross, normalize
+        float e1x = xs[b] - xs[a];
+        float e1y = ys[b] - ys[a];
+        float e1z = zs[b] - zs[a];
+        const float d1 = std::sqrt(e1x * e1x + e1y * e1y + e1z * e1z);
+        e1x /= d1;
+        e1y /= d1;
+        e1z /= d1;
+
+        float e2x = xs[c] - xs[a];
+        float e2y = ys[c] - ys[a];
+        float e2z = zs[c] - zs[a];
+        const float d2 = std::sqrt(e2x * e2x + e2y * e2y + e2z * e2z);
+        e2x /= d2;
+        e2y /= d2;
+        e2z /= d2;
+
+        const float cx = e1y * e2z - e1z * e2y;
+        const float cy = e1z * e2x - e1x * e2z;
+        const float cz = e1x * e2y - e1y * e2x;
+        const float d = std::sqrt(cx * cx + cy * cy + cz * cz);
+
+        nx[i] = cx / d;
+        ny[i] = cy / d;
+        nz[i] = cz / d;
+    }
+}
+
 Point3d Mesh::computeTriangleCenterOfGravity(int idTri) const
 {
     return ((*pts)[(*tris)[idTri].v[0]] + (*pts)[(*tris)[idTri].v[1]] + (*pts)[(*tris)[idTri].v[2]]) / 3.0f;
@@ -1333,10 +1554,9 @@ double Mesh::computeTriangleMaxEdgeLength(int idTri) const
 
 StaticVector<Point3d>* Mesh::computeNormalsForPts()
 {
-    StaticVector<StaticVector<int>*>* ptsNeighTris = getPtsNeighborTriangles();
-    StaticVector<Point3d>* nms = computeNormalsForPts(ptsNeighTris);
-    deleteArrayOfArrays<int>(&ptsNeighTris);
-    return nms;
+    StaticVectorOfVector<int> ptsNeighTris;
+    getPtsNeighborTriangles(ptsNeighTris);
+    return computeNormalsForPts(ptsNeighTris);
 }
 
 StaticVector<Point3d>* Mesh::computeNormalsForPts(StaticVector<StaticVector<int>*>* ptsNeighTris)
@@ -1383,6 +1603,57 @@ StaticVector<Point3d>* Mesh::computeNormalsForPts(StaticVector<StaticVector<int>
     return nms;
 }
 
+StaticVector<Point3d>* Mesh::computeNormalsForPts(const StaticVectorOfVector<int>& ptsNeighTris)
+{
+    StaticVector<Point3d>* nms = new StaticVector<Point3d>();
+    nms->reserve(pts->size());
+    nms->resize_with(pts->size(), Point3d(0.0f, 0.0f, 0.0f));
+
+    // each triangle is adjacent to its three vertices: compute every triangle
+    // normal once from the SoA view instead of once per adjacent vertex
+    StaticVector<float> tnx;
+    StaticVector<float> tny;
+    StaticVector<float> tnz;
+    computeTriangleNormalsSoA(tnx, tny, tnz);
+
+    for(int i = 0; i < pts->size(); i++)
+    {
+        int nbNeighTris = ptsNeighTris.sizeOfVector(i);
+        if(nbNeighTris > 0)
+        {
+            Point3d n = Point3d(0.0f, 0.0f, 0.0f);
+            float nn = 0.0f;
+            for(int j = 0; j < nbNeighTris; j++)
+            {
+                const int idTri = ptsNeighTris(i, j);
+                const Point3d n1 = Point3d(tnx[idTri], tny[idTri], tnz[idTri]);
+                if(std::isnan(n1.x) || std::isnan(n1.y) || std::isnan(n1.z) || (n1.x != n1.x) || (n1.y != n1.y) ||
+                   (n1.z != n1.z)) // check if is not NaN
+                {
+                    //
+                }
+                else
+                {
+                    n = n + n1;
+                    nn += 1.0f;
+                }
+            }
+            n = n / nn;
+
+            n = n.normalize();
+            if(std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z) || (n.x != n.x) || (n.y != n.y) ||
+               (n.z != n.z)) // check if is not NaN
+            {
+                n = Point3d(0.0f, 0.0f, 0.0f);
+            }
+
+            (*nms)[i] = n;
+        }
+    }
+
+    return nms;
+}
+
 void Mesh::smoothNormals(StaticVector<Point3d>* nms, StaticVector<StaticVector<int>*>* ptsNeighPts)
 {
     StaticVector<Point3d>* nmss = new StaticVector<Point3d>();
@@ -1430,6 +1701,7 @@ void Mesh::removeFreePointsFromMesh(StaticVector<int>** out_ptIdToNewPtId)
 
     std::swap(cleanedMesh->pts, pts);
     std::swap(cleanedMesh->tris, tris);
+    invalidatePtsSoA();
 
     delete cleanedMesh;
 }
@@ -1955,6 +2227,7 @@ int Mesh::subdivideMesh(const mvsUtils::MultiViewParams* mp, float maxTriArea, f
     delete tris;
     pts = pts1;
     tris = tris1;
+    invalidatePtsSoA();
 
     delete(*trisCamsId);
     (*trisCamsId) = trisCamsId1;
@@ -2066,25 +2339,36 @@ StaticVector<StaticVector<int>*>* Mesh::computeTrisCams(const mvsUtils::MultiVie
 
 StaticVector<StaticVector<int>*>* Mesh::computeTrisCamsFromPtsCams(StaticVector<StaticVector<int>*>* ptsCams) const
 {
-    // TODO: try intersection
     StaticVector<StaticVector<int>*>* trisCams = new StaticVector<StaticVector<int>*>();
-    trisCams->reserve(tris->size());
+    trisCams->resize(tris->size());
 
-    for(int idTri = 0; idTri < tris->size(); idTri++)
+    // each triangle fills its own slot, the camera lists come out sorted
+#pragma omp parallel
     {
-        int maxcams = sizeOfStaticVector<int>((*ptsCams)[(*tris)[idTri].v[0]]) +
-                      sizeOfStaticVector<int>((*ptsCams)[(*tris)[idTri].v[1]]) +
-                      sizeOfStaticVector<int>((*ptsCams)[(*tris)[idTri].v[2]]);
-        StaticVector<int>* cams = new StaticVector<int>();
-        cams->reserve(maxcams);
-        for(int k = 0; k < 3; k++)
+        // per-thread buffer to merge the three per-point camera lists
+        std::vector<int> camsBuffer;
+
+#pragma omp for
+        for(int idTri = 0; idTri < tris->size(); idTri++)
         {
-            for(int i = 0; i < sizeOfStaticVector<int>((*ptsCams)[(*tris)[idTri].v[k]]); i++)
+            camsBuffer.clear();
+            for(int k = 0; k < 3; k++)
             {
-                cams->push_back_distinct((*(*ptsCams)[(*tris)[idTri].v[k]])[i]);
+                StaticVector<int>* ptCams = (*ptsCams)[(*tris)[idTri].v[k]];
+                for(int i = 0; i < sizeOfStaticVector<int>(ptCams); i++)
+                {
+                    camsBuffer.push_back((*ptCams)[i]);
+                }
             }
+            std::sort(camsBuffer.begin(), camsBuffer.end());
+            camsBuffer.erase(std::unique(camsBuffer.begin(), camsBuffer.end()), camsBuffer.end());
+
+            StaticVector<int>* cams = new StaticVector<int>();
+            cams->reserve(camsBuffer.size());
+            for(std::size_t i = 0; i < camsBuffer.size(); ++i)
+                cams->push_back(camsBuffer[i]);
+            (*trisCams)[idTri] = cams;
         }
-        trisCams->push_back(cams);
     }
 
     return trisCams;
@@ -2680,6 +2964,7 @@ bool Mesh::loadFromObjAscii(int& nmtls, StaticVector<int>& trisMtlIds, StaticVec
         nmtls = materialCache.size();
     }
     ALICEVISION_LOG_INFO("Mesh loaded: \n\t- #points: " << npts << "\n\t- # triangles: " << ntris);
+    invalidatePtsSoA();
     return npts != 0 && ntris != 0;
 }
 
@@ -11,6 +11,7 @@
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/Rgb.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
+#include <aliceVision/mvsData/StaticVectorOfVector.hpp>
 #include <aliceVision/mvsData/Voxel.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 
@@ -102,7 +103,36 @@ public:
         }
     };
 
+    /**
+     * @brief Structure-of-arrays float view over the mesh vertices.
+     *
+     * The x/y/z components live in three separate contiguous arrays, so bulk
+     * kernels iterate plain float streams instead of gathering from the
+     * Point3d layout. The view is rebuilt lazily from pts by getPtsSoA();
+     * pts stays the reference representation and consumers can migrate one
+     * loop at a time.
+     */
+    struct PointsSoA
+    {
+        StaticVector<float> x;
+        StaticVector<float> y;
+        StaticVector<float> z;
+
+        int size() const { return x.size(); }
+
+        /// gather from the reference AoS layout
+        void fromPoints(const StaticVector<Point3d>* pts);
+        /// scatter back into the reference layout, sizes must match
+        void toPoints(StaticVector<Point3d>* pts) const;
+        /// transform all vertices in place, one vectorizable loop over the components
+        void applyTransform(const Matrix3x4& t);
+    };
+
 public:
+    /// version of the .bin file format written by saveToBin, bumped on layout changes.
+    /// Versioned files start with a -1 marker (legacy files start with the point count, which is never negative).
+    static const int binFileVersion = 1;
+
     StaticVector<Point3d>* pts = nullptr;
     StaticVector<Mesh::triangle>* tris = nullptr;
     Matrix3x4 transformGlobal;
@@ -128,6 +158,8 @@ public:
                      int scale, int w, int h);
 
     StaticVector<StaticVector<int>*>* getPtsNeighborTriangles();
+    /// flattened variant for build-use-delete callers, avoids one allocation per point
+    void getPtsNeighborTriangles(StaticVectorOfVector<int>& out_ptsNeighTris);
     StaticVector<StaticVector<int>*>* getPtsNeighPtsOrdered();
 
     StaticVector<int>* getVisibleTrianglesIndexes(std::string tmpDir, const mvsUtils::MultiViewParams* mp, int rc, int w, int h);
@@ -150,6 +182,13 @@ public:
     void laplacianSmoothPts(StaticVector<StaticVector<int>*>* ptsNeighPts, double maximalNeighDist = -1.0f);
     StaticVector<Point3d>* computeNormalsForPts();
     StaticVector<Point3d>* computeNormalsForPts(StaticVector<StaticVector<int>*>* ptsNeighTris);
+    StaticVector<Point3d>* computeNormalsForPts(const StaticVectorOfVector<int>& ptsNeighTris);
+    /// SoA view over pts, rebuilt when stale; callers that modify pts directly
+    /// must call invalidatePtsSoA() before the next read
+    const PointsSoA& getPtsSoA();
+    void invalidatePtsSoA();
+    /// normals of all triangles in one pass over the SoA view
+    void computeTriangleNormalsSoA(StaticVector<float>& nx, StaticVector<float>& ny, StaticVector<float>& nz);
     void smoothNormals(StaticVector<Point3d>* nms, StaticVector<StaticVector<int>*>* ptsNeighPts);
     Point3d computeTriangleNormal(int idTri);
     Point3d computeTriangleCenterOfGravity(int idTri) const;
@@ -213,6 +252,10 @@ public:
 
     bool getEdgeNeighTrisInterval(Pixel& itr, Pixel edge, StaticVector<Voxel>* edgesXStat,
                                   StaticVector<Voxel>* edgesXYStat);
+
+private:
+    PointsSoA _ptsSoA;
+    bool _ptsSoADirty = true;
 };
 
 } // namespace mesh
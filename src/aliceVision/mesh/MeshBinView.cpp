@@ -0,0 +1,103 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MeshBinView.hpp"
+#include <aliceVision/system/Logger.hpp>
+
+#include <cstring>
+
+namespace aliceVision {
+namespace mesh {
+
+bool MeshBinView::open(const std::string& binFileName)
+{
+    close();
+
+    try
+    {
+        _file.open(binFileName);
+    }
+    catch(...)
+    {
+        return false;
+    }
+    if(!_file.is_open() || (_file.size() < sizeof(int)))
+    {
+        close();
+        return false;
+    }
+
+    const char* data = _file.data();
+    int first;
+    std::memcpy(&first, data, sizeof(int));
+
+    if(first == -1) // versioned header, see Mesh::saveToBin
+    {
+        int version, npts, ntris;
+        std::memcpy(&version, data + 1 * sizeof(int), sizeof(int));
+        std::memcpy(&npts, data + 2 * sizeof(int), sizeof(int));
+        std::memcpy(&ntris, data + 3 * sizeof(int), sizeof(int));
+        if(version != Mesh::binFileVersion)
+        {
+            ALICEVISION_LOG_ERROR("MeshBinView: unsupported mesh file version " << version << ": " << binFileName);
+            close();
+            return false;
+        }
+        // the header is 4 ints, so both arrays are naturally aligned in the mapping
+        _nbPts = npts;
+        _nbTris = ntris;
+        _pts = reinterpret_cast<const Point3d*>(data + 4 * sizeof(int));
+        _tris = reinterpret_cast<const Mesh::triangle*>(data + 4 * sizeof(int) + npts * sizeof(Point3d));
+    }
+    else // legacy layout: counts interleaved with the arrays, not aligned, copy them out
+    {
+        ALICEVISION_LOG_DEBUG("MeshBinView: legacy mesh file, copying: " << binFileName);
+        _nbPts = first;
+        _ownedPts.resize(_nbPts);
+        const char* p = data + sizeof(int);
+        if(_nbPts > 0)
+            std::memcpy(&_ownedPts[0], p, _nbPts * sizeof(Point3d));
+        p += _nbPts * sizeof(Point3d);
+        std::memcpy(&_nbTris, p, sizeof(int));
+        p += sizeof(int);
+        _ownedTris.resize(_nbTris);
+        if(_nbTris > 0)
+            std::memcpy(&_ownedTris[0], p, _nbTris * sizeof(Mesh::triangle));
+        _pts = _ownedPts.getData().data();
+        _tris = _ownedTris.getData().data();
+        _file.close();
+    }
+    return true;
+}
+
+void MeshBinView::close()
+{
+    if(_file.is_open())
+        _file.close();
+    _ownedPts.clear();
+    _ownedTris.clear();
+    _pts = nullptr;
+    _tris = nullptr;
+    _nbPts = 0;
+    _nbTris = 0;
+}
+
+Mesh* MeshBinView::promote() const
+{
+    Mesh* me = new Mesh();
+    me->pts = new StaticVector<Point3d>();
+    me->pts->resize(_nbPts);
+    if(_nbPts > 0)
+        std::memcpy(&(*me->pts)[0], _pts, _nbPts * sizeof(Point3d));
+    me->tris = new StaticVector<Mesh::triangle>();
+    me->tris->resize(_nbTris);
+    if(_nbTris > 0)
+        std::memcpy(&(*me->tris)[0], _tris, _nbTris * sizeof(Mesh::triangle));
+    return me;
+}
+
+} // namespace mesh
+} // namespace aliceVision
@@ -0,0 +1,56 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <string>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Read-only view of a mesh .bin file.
+ *
+ * For files written in the current versioned format the points and triangles are read
+ * straight out of a memory mapping, so opening a large mesh costs no copy and only the
+ * pages actually touched are loaded. Legacy files (no header) are copied on open because
+ * their arrays are not aligned in the file. A stage that needs to mutate the geometry
+ * calls promote() to get its own mutable Mesh.
+ */
+class MeshBinView
+{
+public:
+    MeshBinView() = default;
+
+    /// map the given .bin file, returns false if the file cannot be opened (same contract as Mesh::loadFromBin)
+    bool open(const std::string& binFileName);
+    void close();
+
+    int nbPts() const { return _nbPts; }
+    int nbTris() const { return _nbTris; }
+    const Point3d* pts() const { return _pts; }
+    const Mesh::triangle* tris() const { return _tris; }
+
+    /// copy the viewed geometry into a new mutable Mesh (caller takes ownership)
+    Mesh* promote() const;
+
+private:
+    boost::iostreams::mapped_file_source _file;
+    StaticVector<Point3d> _ownedPts;         // filled only for legacy files
+    StaticVector<Mesh::triangle> _ownedTris; // filled only for legacy files
+    const Point3d* _pts = nullptr;
+    const Mesh::triangle* _tris = nullptr;
+    int _nbPts = 0;
+    int _nbTris = 0;
+};
+
+} // namespace mesh
+} // namespace aliceVision
@@ -535,6 +535,63 @@ int MeshClean::path::deployAll()
     return nNewPts;
 }
 
+/// Apply the same per-point updates as deployAll when the point is manifold
+/// (all its neighbouring triangles form a single fan). A manifold point only
+/// reads the shared cleaning attributes and writes into its own rows, so
+/// distinct points can be processed concurrently. Returns false without
+/// modifying anything when the point has to be split by deployAll.
+bool MeshClean::path::updateOnlyIfManifold()
+{
+    StaticVector<int>* ptNeighTrisSortedAsc = (*m_me->ptsNeighTrisSortedAsc)[m_ptId];
+    if(sizeOfStaticVector<int>(ptNeighTrisSortedAsc) == 0)
+    {
+        return true;
+    }
+
+    StaticVector<int>* ptNeighTrisSortedAscToProcess = new StaticVector<int>();
+    ptNeighTrisSortedAscToProcess->reserve(ptNeighTrisSortedAsc->size());
+    ptNeighTrisSortedAscToProcess->push_back_arr(ptNeighTrisSortedAsc);
+    StaticVector<MeshClean::path::pathPart>* pth = createPath(ptNeighTrisSortedAscToProcess);
+
+    // not connected triangles are left over: the point has to be duplicated
+    bool isManifold = (ptNeighTrisSortedAscToProcess->size() == 0);
+
+    if(isManifold && (pth->size() > 0))
+    {
+        StaticVector<MeshClean::path::pathPart>* pthNew = removeCycleFromPath(pth);
+
+        if(pth->size() > 0)
+        {
+            // more than one cycle: the point has to be duplicated
+            isManifold = false;
+        }
+        else
+        {
+            // the whole neighbourhood is a single path or cycle, update the
+            // rows of this point exactly as the last-path branch of deployAll
+            StaticVector<int>* toUpdate = (*m_me->ptsNeighTrisSortedAsc)[m_ptId];
+            toUpdate->resize(0);
+            for(int i = 0; i < pthNew->size(); i++)
+            {
+                toUpdate->push_back((*pthNew)[i].triId);
+            }
+            if(pthNew->size() > 0)
+            {
+                qsort(&(*toUpdate)[0], toUpdate->size(), sizeof(int), qSortCompareIntAsc);
+            }
+
+            (*m_me->ptsBoundary)[m_ptId] = (!isClodePath(pthNew));
+            updatePtNeighPtsOrderedByPath(m_ptId, pthNew);
+        }
+        delete pthNew;
+    }
+
+    delete ptNeighTrisSortedAscToProcess;
+    delete pth;
+
+    return isManifold;
+}
+
 bool MeshClean::path::isWrongPt()
 {
     int nNewPtsNeededToAdd = 0;
@@ -665,6 +722,7 @@ void MeshClean::init()
     deallocateCleaningAttributes();
 
     ptsNeighTrisSortedAsc = getPtsNeighborTriangles();
+#pragma omp parallel for
     for(int i = 0; i < pts->size(); i++)
     {
         StaticVector<int>* ptNeigTris = (*ptsNeighTrisSortedAsc)[i];
@@ -892,10 +950,28 @@ int MeshClean::cleanMesh()
 {
     int nWrongPts = 0;
     int nv = pts->size();
+
+    // manifold points only update their own rows of the cleaning attributes,
+    // so they are processed in parallel; the non-manifold points are collected
+    // and split serially below since splitting grows the shared arrays
+    StaticVectorBool ptsToSplit;
+    ptsToSplit.reserve(nv);
+    ptsToSplit.resize_with(nv, false);
+
+#pragma omp parallel for
     for(int i = 0; i < nv; i++)
     {
         path pth(this, i);
-        nWrongPts += static_cast<int>(pth.deployAll() > 0);
+        ptsToSplit[i] = (!pth.updateOnlyIfManifold());
+    }
+
+    for(int i = 0; i < nv; i++)
+    {
+        if(ptsToSplit[i])
+        {
+            path pth(this, i);
+            nWrongPts += static_cast<int>(pth.deployAll() > 0);
+        }
     }
     ALICEVISION_LOG_INFO("cleanMesh:" << std::endl
                       << "\t- # wrong points: " << nWrongPts << std::endl
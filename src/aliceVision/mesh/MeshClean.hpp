@@ -66,6 +66,7 @@ public:
         void updatePtNeighPtsOrderedByPath(int _ptId, StaticVector<pathPart>* _pth);
         StaticVector<pathPart>* createPath(StaticVector<int>* ptNeighTrisSortedAscToProcess);
         int deployAll();
+        bool updateOnlyIfManifold();
         bool isWrongPt();
     };
 
@@ -28,7 +28,6 @@ StaticVector<Point3d>* MeshEnergyOpt::computeLaplacianPtsParallel()
     StaticVector<Point3d>* lapPts = new StaticVector<Point3d>();
     lapPts->reserve(pts->size());
     lapPts->resize_with(pts->size(), Point3d(0.0f, 0.0f, 0.f));
-    int nlabpts = 0;
 
 #pragma omp parallel for
     for(int i = 0; i < pts->size(); i++)
@@ -37,7 +36,6 @@ StaticVector<Point3d>* MeshEnergyOpt::computeLaplacianPtsParallel()
         if(getLaplacianSmoothingVector(i, lapPt))
         {
             (*lapPts)[i] = lapPt;
-            nlabpts++;
         }
     }
 
@@ -51,25 +49,29 @@ void MeshEnergyOpt::updateGradientParallel(float lambda, const Point3d& LU,
     StaticVector<Point3d>* lapPts = computeLaplacianPtsParallel();
 
     StaticVector<Point3d>* newPts = new StaticVector<Point3d>();
-    newPts->reserve(pts->size());
-    newPts->push_back_arr(pts);
+    newPts->resize(pts->size());
 
+    // Jacobi-style update: every point is computed from the previous iterate, so all
+    // points can be updated concurrently; the copy of unmoved points happens in the
+    // same parallel loop instead of a sequential full-array copy beforehand
 #pragma omp parallel for
     for(int i = 0; i < pts->size(); ++i)
     {
+        Point3d p = (*pts)[i];
         if((ptsCanMove == nullptr) || ((*ptsCanMove)[i]))
         {
             Point3d n;
 
             if(getBiLaplacianSmoothingVector(i, lapPts, n))
             {
-                Point3d p = (*newPts)[i] + n * lambda;
-                if((p.x > LU.x) && (p.y > LU.y) && (p.z > LU.z) && (p.x < RD.x) && (p.y < RD.y) && (p.z < RD.z))
+                Point3d np = p + n * lambda;
+                if((np.x > LU.x) && (np.y > LU.y) && (np.z > LU.z) && (np.x < RD.x) && (np.y < RD.y) && (np.z < RD.z))
                 {
-                    (*newPts)[i] = p;
+                    p = np;
                 }
             }
         }
+        (*newPts)[i] = p;
     }
 
     delete pts;
@@ -89,14 +91,29 @@ bool MeshEnergyOpt::optimizeSmooth(float lambda, int niter, StaticVectorBool* pt
     Point3d LU, RD;
     LU = (*pts)[0];
     RD = (*pts)[0];
-    for(int i = 0; i < pts->size(); i++)
+#pragma omp parallel
     {
-        LU.x = std::min(LU.x, (*pts)[i].x);
-        LU.y = std::min(LU.y, (*pts)[i].y);
-        LU.z = std::min(LU.z, (*pts)[i].z);
-        RD.x = std::max(RD.x, (*pts)[i].x);
-        RD.y = std::max(RD.y, (*pts)[i].y);
-        RD.z = std::max(RD.z, (*pts)[i].z);
+        Point3d localLU = (*pts)[0];
+        Point3d localRD = (*pts)[0];
+#pragma omp for nowait
+        for(int i = 0; i < pts->size(); i++)
+        {
+            localLU.x = std::min(localLU.x, (*pts)[i].x);
+            localLU.y = std::min(localLU.y, (*pts)[i].y);
+            localLU.z = std::min(localLU.z, (*pts)[i].z);
+            localRD.x = std::max(localRD.x, (*pts)[i].x);
+            localRD.y = std::max(localRD.y, (*pts)[i].y);
+            localRD.z = std::max(localRD.z, (*pts)[i].z);
+        }
+#pragma omp critical
+        {
+            LU.x = std::min(LU.x, localLU.x);
+            LU.y = std::min(LU.y, localLU.y);
+            LU.z = std::min(LU.z, localLU.z);
+            RD.x = std::max(RD.x, localRD.x);
+            RD.y = std::max(RD.y, localRD.y);
+            RD.z = std::max(RD.z, localRD.z);
+        }
     }
 
     ALICEVISION_LOG_INFO("Optimizing mesh smooth: " << std::endl
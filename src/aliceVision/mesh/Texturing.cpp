@@ -278,7 +278,6 @@ void Texturing::generateTexture(const mvsUtils::MultiViewParams& mp,
         throw std::runtime_error("Invalid atlas ID " + std::to_string(atlasID));
 
     unsigned int textureSize = texParams.textureSide * texParams.textureSide;
-    std::vector<int> colorIDs(textureSize, -1);
 
     std::vector<std::vector<unsigned int>> camTriangles(mp.ncams);
 
@@ -394,8 +393,19 @@ void Texturing::generateTexture(const mvsUtils::MultiViewParams& mp,
         }
     }
 
+    if(texParams.blockSize > 0)
+    {
+        // memory-bounded path: per-block accumulation buffers and windowed source reads
+        std::vector<Color> colorBuffer;
+        std::vector<float> alphaBuffer;
+        generateTextureBlocked(mp, camTriangles, colorBuffer, alphaBuffer);
+        writeTexture(colorBuffer, alphaBuffer, atlasID, outPath, textureFileType);
+        return;
+    }
+
     ALICEVISION_LOG_INFO("Reading pixel color.");
 
+    std::vector<int> colorIDs(textureSize, -1);
     std::vector<AccuColor> perPixelColors(textureSize);
 
     // iterate over triangles for each camera
@@ -551,6 +561,232 @@ void Texturing::generateTexture(const mvsUtils::MultiViewParams& mp,
     perPixelColors.clear();
     colorIDs.clear();
 
+    writeTexture(colorBuffer, alphaBuffer, atlasID, outPath, textureFileType);
+}
+
+void Texturing::generateTextureBlocked(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<std::vector<unsigned int>>& camTriangles,
+                                       std::vector<Color>& colorBuffer, std::vector<float>& alphaBuffer)
+{
+    const int texSide = static_cast<int>(texParams.textureSide);
+    const int blockRows = static_cast<int>(texParams.blockSize);
+    const int nbBlocks = (texSide + blockRows - 1) / blockRows;
+    const unsigned int textureSize = texParams.textureSide * texParams.textureSide;
+
+    colorBuffer.assign(textureSize, Color());
+    std::vector<unsigned char> filled(textureSize, 0);
+
+    ALICEVISION_LOG_INFO("Reading pixel color in " << nbBlocks << " blocks of " << blockRows << " rows.");
+
+    // group every camera's triangles by the blocks their UV bounding box spans
+    std::vector<std::map<int, std::vector<unsigned int>>> blockCamTriangles(nbBlocks);
+    for(int camId = 0; camId < camTriangles.size(); ++camId)
+    {
+        for(const unsigned int triangleId : camTriangles[camId])
+        {
+            int yMin = texSide;
+            int yMax = 0;
+            for(int k = 0; k < 3; k++)
+            {
+                const int uvPointIndex = trisUvIds[triangleId].m[k];
+                const double y = uvCoords[uvPointIndex].y * texParams.textureSide;
+                yMin = std::min(yMin, static_cast<int>(std::floor(y)));
+                yMax = std::max(yMax, static_cast<int>(std::ceil(y)));
+            }
+            yMin = clamp(yMin, 0, texSide);
+            yMax = clamp(yMax, 0, texSide);
+            for(int b = std::max(0, yMin / blockRows); (b <= (yMax - 1) / blockRows) && (b < nbBlocks); ++b)
+                blockCamTriangles[b][camId].push_back(triangleId);
+        }
+    }
+
+    std::vector<AccuColor> blockColors;
+    std::vector<Color> camWindow;
+
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        const int blockYBegin = b * blockRows;
+        const int blockYEnd = std::min(texSide, blockYBegin + blockRows);
+        blockColors.assign((blockYEnd - blockYBegin) * texSide, AccuColor());
+
+        for(const auto& itCam : blockCamTriangles[b])
+        {
+            const int camId = itCam.first;
+            const std::vector<unsigned int>& triangles = itCam.second;
+
+            const int camWidth = mp.getWidth(camId);
+            const int camHeight = mp.getHeight(camId);
+
+            // source window: union of the projected triangle vertices, with one pixel
+            // of margin for the bilinear interpolation
+            Pixel winLU(camWidth, camHeight);
+            Pixel winRD(0, 0);
+            for(const unsigned int triangleId : triangles)
+            {
+                for(int k = 0; k < 3; k++)
+                {
+                    const int pointIndex = (*me->tris)[triangleId].v[k];
+                    Point2d pix;
+                    mp.getPixelFor3DPoint(&pix, (*me->pts)[pointIndex], camId);
+                    winLU.x = std::min(winLU.x, static_cast<int>(std::floor(pix.x)));
+                    winLU.y = std::min(winLU.y, static_cast<int>(std::floor(pix.y)));
+                    winRD.x = std::max(winRD.x, static_cast<int>(std::ceil(pix.x)) + 2);
+                    winRD.y = std::max(winRD.y, static_cast<int>(std::ceil(pix.y)) + 2);
+                }
+            }
+            winLU.x = clamp(winLU.x, 0, camWidth);
+            winLU.y = clamp(winLU.y, 0, camHeight);
+            winRD.x = clamp(winRD.x, 0, camWidth);
+            winRD.y = clamp(winRD.y, 0, camHeight);
+            const int winWidth = winRD.x - winLU.x;
+            const int winHeight = winRD.y - winLU.y;
+            if((winWidth <= 0) || (winHeight <= 0))
+                continue;
+
+            imageIO::readImageWindow(mp.getImagePath(camId), winLU.x, winLU.y, winWidth, winHeight, camWindow);
+
+            #pragma omp parallel for
+            for(int ti = 0; ti < triangles.size(); ++ti)
+            {
+                const unsigned int triangleId = triangles[ti];
+                // retrieve triangle 3D and UV coordinates
+                Point2d triPixs[3];
+                Point3d triPts[3];
+
+                for(int k = 0; k < 3; k++)
+                {
+                    const int pointIndex = (*me->tris)[triangleId].v[k];
+                    triPts[k] = (*me->pts)[pointIndex];                            // 3D coordinates
+                    const int uvPointIndex = trisUvIds[triangleId].m[k];
+                    triPixs[k] = uvCoords[uvPointIndex] * texParams.textureSide;   // UV coordinates
+                }
+
+                // compute triangle bounding box in pixel indexes
+                // min values: floor(value)
+                // max values: ceil(value)
+                Pixel LU, RD;
+                LU.x = static_cast<int>(std::floor(std::min(std::min(triPixs[0].x, triPixs[1].x), triPixs[2].x)));
+                LU.y = static_cast<int>(std::floor(std::min(std::min(triPixs[0].y, triPixs[1].y), triPixs[2].y)));
+                RD.x = static_cast<int>(std::ceil(std::max(std::max(triPixs[0].x, triPixs[1].x), triPixs[2].x)));
+                RD.y = static_cast<int>(std::ceil(std::max(std::max(triPixs[0].y, triPixs[1].y), triPixs[2].y)));
+
+                // clamp to the active block
+                LU.x = clamp(LU.x, 0, texSide);
+                RD.x = clamp(RD.x, 0, texSide);
+                LU.y = clamp(LU.y, blockYBegin, blockYEnd);
+                RD.y = clamp(RD.y, blockYBegin, blockYEnd);
+
+                // iterate over bounding box's pixels
+                for(int y = LU.y; y < RD.y; y++)
+                {
+                    for(int x = LU.x; x < RD.x; x++)
+                    {
+                        Pixel pix(x, y); // top-left corner of the pixel
+                        Point2d barycCoords;
+
+                        // test if the pixel is inside triangle
+                        // and retrieve its barycentric coordinates
+                        if(!isPixelInTriangle(triPixs, pix, barycCoords))
+                        {
+                            continue;
+                        }
+
+                        // get 3D coordinates
+                        Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
+                        // get 2D coordinates in source image
+                        Point2d pixRC;
+                        mp.getPixelFor3DPoint(&pixRC, pt3d, camId);
+                        // exclude out of bounds pixels
+                        if(!mp.isPixelInImage(pixRC, camId))
+                            continue;
+
+                        // bilinear interpolation inside the mapped window
+                        const int xp = static_cast<int>(pixRC.x);
+                        const int yp = static_cast<int>(pixRC.y);
+                        if((xp < winLU.x) || (xp + 1 >= winRD.x) || (yp < winLU.y) || (yp + 1 >= winRD.y))
+                            continue;
+                        const float ui = pixRC.x - static_cast<float>(xp);
+                        const float vi = pixRC.y - static_cast<float>(yp);
+                        const std::size_t winOffset = (yp - winLU.y) * winWidth + (xp - winLU.x);
+                        const Color lu = camWindow[winOffset];
+                        const Color ru = camWindow[winOffset + 1];
+                        const Color ld = camWindow[winOffset + winWidth];
+                        const Color rd = camWindow[winOffset + winWidth + 1];
+                        const Color u = lu + (ru - lu) * ui;
+                        const Color d = ld + (rd - ld) * ui;
+                        const Color color = u + (d - u) * vi;
+
+                        // If the color is pure zero, we consider it as an invalid pixel.
+                        if(color == Color(0.f, 0.f, 0.f))
+                            continue;
+                        // fill the accumulated color map for this pixel
+                        blockColors[(y - blockYBegin) * texSide + x] += color;
+                    }
+                }
+            }
+        }
+
+        // flush the finished block into the final buffer ('y' remapped to image coordinates system)
+        for(int y = blockYBegin; y < blockYEnd; ++y)
+        {
+            const int y_ = (texSide - 1) - y;
+            for(int x = 0; x < texSide; ++x)
+            {
+                const AccuColor& accu = blockColors[(y - blockYBegin) * texSide + x];
+                if(accu.count == 0)
+                    continue;
+                const unsigned int xyoffset = y_ * texSide + x;
+                colorBuffer[xyoffset] = accu.average();
+                filled[xyoffset] = 1;
+            }
+        }
+    }
+
+    if(!texParams.fillHoles && texParams.padding > 0)
+    {
+        ALICEVISION_LOG_INFO("Edge padding (" << texParams.padding << " pixels).");
+        // same dilation as the in-core path, applied directly to the final colors
+        std::vector<std::pair<unsigned int, unsigned int>> toFill;
+        for(unsigned int g = 0; g < texParams.padding; ++g)
+        {
+            toFill.clear();
+            for(unsigned int y = 1; y < texParams.textureSide - 1; ++y)
+            {
+                const unsigned int yoffset = y * texParams.textureSide;
+                for(unsigned int x = 1; x < texParams.textureSide - 1; ++x)
+                {
+                    const unsigned int xyoffset = yoffset + x;
+                    if(filled[xyoffset])
+                        continue;
+                    else if(filled[xyoffset - 1])
+                        toFill.emplace_back(xyoffset, xyoffset - 1);
+                    else if(filled[xyoffset + 1])
+                        toFill.emplace_back(xyoffset, xyoffset + 1);
+                    else if(filled[xyoffset + texParams.textureSide])
+                        toFill.emplace_back(xyoffset, xyoffset + texParams.textureSide);
+                    else if(filled[xyoffset - texParams.textureSide])
+                        toFill.emplace_back(xyoffset, xyoffset - texParams.textureSide);
+                }
+            }
+            for(const auto& df : toFill)
+            {
+                colorBuffer[df.first] = colorBuffer[df.second];
+                filled[df.first] = 1;
+            }
+        }
+    }
+
+    if(texParams.fillHoles)
+    {
+        alphaBuffer.resize(textureSize);
+        for(unsigned int i = 0; i < textureSize; ++i)
+            alphaBuffer[i] = filled[i] ? 1.0f : 0.0f;
+    }
+}
+
+void Texturing::writeTexture(std::vector<Color>& colorBuffer, std::vector<float>& alphaBuffer,
+                             size_t atlasID, const bfs::path& outPath, EImageFileType textureFileType)
+{
     std::string textureName = "texture_" + std::to_string(atlasID) + "." + EImageFileType_enumToString(textureFileType);
     bfs::path texturePath = outPath / textureName;
     ALICEVISION_LOG_INFO("Writing texture file: " << texturePath.string());
@@ -74,6 +74,8 @@ struct TexturingParams
     unsigned int padding = 15;
     unsigned int downscale = 2;
     bool fillHoles = false;
+    unsigned int blockSize = 0; //< nb of texture rows accumulated at once (0: whole texture);
+                                //  bounds memory usage and switches source images to windowed reads
 };
 
 struct Texturing
@@ -152,6 +154,26 @@ public:
                          size_t atlasID, mvsUtils::ImagesCache& imageCache,
                          const bfs::path &outPath, EImageFileType textureFileType = EImageFileType::PNG);
 
+    /**
+     * @brief Accumulate the texture of one atlas in blocks of texParams.blockSize rows.
+     *
+     * Memory-bounded alternative to the in-core accumulation in generateTexture: only one
+     * block of accumulation buffers is alive at a time and the source images are accessed
+     * through windowed reads restricted to the active block.
+     *
+     * @param[in] mp the multi-view parameters
+     * @param[in] camTriangles per-camera triangles selected for texturing
+     * @param[out] colorBuffer the final texture colors
+     * @param[out] alphaBuffer per-pixel coverage, filled only when texParams.fillHoles is set
+     */
+    void generateTextureBlocked(const mvsUtils::MultiViewParams& mp,
+                                const std::vector<std::vector<unsigned int>>& camTriangles,
+                                std::vector<Color>& colorBuffer, std::vector<float>& alphaBuffer);
+
+    /// Hole filling, downscaling and writing of a final texture image
+    void writeTexture(std::vector<Color>& colorBuffer, std::vector<float>& alphaBuffer,
+                      size_t atlasID, const bfs::path& outPath, EImageFileType textureFileType);
+
     /// Save textured mesh as an OBJ + MTL file
     void saveAsOBJ(const bfs::path& dir, const std::string& basename, EImageFileType textureFileType = EImageFileType::PNG);
 };
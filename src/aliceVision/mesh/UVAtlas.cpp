@@ -62,12 +62,11 @@ void UVAtlas::createCharts(vector<Chart>& charts, mvsUtils::MultiViewParams& mp,
                     || !mp.isPixelInImage(Pixel(tp.tp2ds[1]), 10, cameraID)
                     || !mp.isPixelInImage(Pixel(tp.tp2ds[2]), 10, cameraID))
                 continue;
-            // store this camera ID
+            // store this camera ID (the per triangle camera lists are sorted,
+            // so commonCameraIDs stays sorted for the set intersections)
             chart.commonCameraIDs.emplace_back(cameraID);
             tCamIds.emplace_back(cameraID);
         }
-        // sort camera IDs
-        std::sort(chart.commonCameraIDs.begin(), chart.commonCameraIDs.end());
         // store triangle ID
         chart.triangleIDs.emplace_back(i);
     }
@@ -90,25 +89,23 @@ void UVAtlas::packCharts(vector<Chart>& charts, mvsUtils::MultiViewParams& mp)
         return cid;
     };
 
-    // list mesh edges (with duplicates)
-    vector<Edge> alledges;
+    // list mesh edges (with duplicates), each triangle writes its own 3 slots
+    vector<Edge> alledges(_mesh.tris->size() * 3);
+    #pragma omp parallel for
     for(int i = 0; i < _mesh.tris->size(); ++i)
     {
         int a = (*_mesh.tris)[i].v[0];
         int b = (*_mesh.tris)[i].v[1];
         int c = (*_mesh.tris)[i].v[2];
-        Edge e1;
+        Edge& e1 = alledges[i * 3];
         e1.pointIDs = make_pair(min(a, b), max(a, b));
         e1.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e1);
-        Edge e2;
+        Edge& e2 = alledges[i * 3 + 1];
         e2.pointIDs = make_pair(min(b, c), max(b, c));
         e2.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e2);
-        Edge e3;
+        Edge& e3 = alledges[i * 3 + 2];
         e3.pointIDs = make_pair(min(c, a), max(c, a));
         e3.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e3);
     }
     sort(alledges.begin(), alledges.end());
 
@@ -245,6 +242,8 @@ void UVAtlas::createTextureAtlases(vector<Chart>& charts, mvsUtils::MultiViewPar
         root->LU.y = 0;
         root->RD.x = _textureSide - 1;
         root->RD.y = _textureSide - 1;
+        root->freeW = root->RD.x - root->LU.x;
+        root->freeH = root->RD.y - root->LU.y;
 
         const auto insertChart = [&](size_t idx) -> bool
         {
@@ -286,22 +285,43 @@ void UVAtlas::ChartRect::clear()
     delete child[1];
 }
 
+void UVAtlas::ChartRect::updateFree()
+{
+    freeW = 0;
+    freeH = 0;
+    if(child[0])
+    {
+        freeW = child[0]->freeW;
+        freeH = child[0]->freeH;
+    }
+    if(child[1])
+    {
+        freeW = std::max(freeW, child[1]->freeW);
+        freeH = std::max(freeH, child[1]->freeH);
+    }
+}
+
 UVAtlas::ChartRect* UVAtlas::ChartRect::insert(Chart& chart, size_t gutter)
 {
+    size_t chartWidth = chart.width() + gutter * 2;
+    size_t chartHeight = chart.height() + gutter * 2;
+    // no free rectangle of this subtree can hold the chart, skip it entirely
+    // instead of walking every leaf (freeW/freeH are conservative bounds)
+    if(chartWidth > freeW || chartHeight > freeH)
+        return nullptr;
     if(child[0] || child[1]) // not a leaf
     {
+        ChartRect* rect = nullptr;
         if(child[0])
-            if(ChartRect* rect = child[0]->insert(chart, gutter))
-                return rect;
-        if(child[1])
-            if(ChartRect* rect = child[1]->insert(chart, gutter))
-                return rect;
-        return nullptr;
+            rect = child[0]->insert(chart, gutter);
+        if(!rect && child[1])
+            rect = child[1]->insert(chart, gutter);
+        if(rect)
+            updateFree();
+        return rect;
     }
     else
     {
-        size_t chartWidth = chart.width() + gutter * 2;
-        size_t chartHeight = chart.height() + gutter * 2;
         // if there is already a chart here
         if(c) return nullptr;
         // not enough space
@@ -348,8 +368,18 @@ UVAtlas::ChartRect* UVAtlas::ChartRect::insert(Chart& chart, size_t gutter)
                 child[1]->RD.y = RD.y;
             }
         }
+        // initialize the pruning bounds of the new free rectangles
+        for(int k = 0; k < 2; ++k)
+        {
+            if(child[k])
+            {
+                child[k]->freeW = child[k]->RD.x - child[k]->LU.x;
+                child[k]->freeH = child[k]->RD.y - child[k]->LU.y;
+            }
+        }
         // insert chart
         c = &chart;
+        updateFree();
         return this;
     }
 }
@@ -44,7 +44,10 @@ public:
         ChartRect* child[2] {nullptr, nullptr};
         Pixel LU;
         Pixel RD;
+        size_t freeW = 0;                                       // largest free rectangle width in this subtree
+        size_t freeH = 0;                                       // largest free rectangle height in this subtree
         void clear();
+        void updateFree();
         ChartRect* insert(Chart& chart, size_t gutter);
     };
 
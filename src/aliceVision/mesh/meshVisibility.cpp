@@ -15,6 +15,9 @@
 #include <geogram/mesh/mesh_AABB.h>
 #include <geogram/mesh/mesh_reorder.h>
 
+#include <array>
+#include <mutex>
+
 
 namespace aliceVision {
 namespace mesh {
@@ -24,7 +27,9 @@ int getNearestVertices(const Mesh& refMesh, const Mesh& mesh, StaticVector<int>&
     ALICEVISION_LOG_DEBUG("getNearestVertices start.");
     out_nearestVertex.resize(mesh.pts->size(), -1);
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
+    // balanced kd-tree: the subtrees are built in parallel, unlike the
+    // serially built adaptive one, and the dense reference mesh is large
+    GEO::BalancedKdTree refMesh_kdTree(3);
     refMesh_kdTree.set_points(refMesh.pts->size(), refMesh.pts->front().m);
 
     #pragma omp parallel for
@@ -43,7 +48,8 @@ void remapMeshVisibilities_pullVerticesVisibility(
 {
     ALICEVISION_LOG_DEBUG("remapMeshVisibility based on closest vertex start.");
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
+    // balanced kd-tree: built in parallel, see getNearestVertices
+    GEO::BalancedKdTree refMesh_kdTree(3);
     refMesh_kdTree.set_points(refMesh.pts->size(), refMesh.pts->front().m);
 
     out_ptsVisibilities.resize(mesh.pts->size(), nullptr);
@@ -109,6 +115,11 @@ void remapMeshVisibilities_pushVerticesVisibilityToTriangles(
         }
     }
 
+    // striped locks instead of one global critical section around the merge: threads
+    // only wait for each other when their target vertices fall in the same stripe,
+    // so the AABB queries and the visibility merges both run concurrently
+    std::array<std::mutex, 256> vertexLocks;
+
     #pragma omp parallel for
     for (int rvi = 0; rvi < refMesh.pts->size(); ++rvi)
     {
@@ -129,18 +140,17 @@ void remapMeshVisibilities_pushVerticesVisibilityToTriangles(
         if(std::sqrt(dist2) > avgEdgeLength)
             continue;
 
-        #pragma omp critical
+        for (int i = 0; i < 3; ++i)
         {
-            for (int i = 0; i < 3; ++i)
-            {
-                GEO::index_t v = meshG.facets.vertex(f, i);
-                if (v == GEO::NO_VERTEX)
-                    continue;
-                PointVisibility* pOut = out_ptsVisibilities[reorderedVertices[v]];
-                
-                for(int j = 0; j < rpVis->size(); ++j)
-                    pOut->push_back_distinct((*rpVis)[j]);
-            }
+            GEO::index_t v = meshG.facets.vertex(f, i);
+            if (v == GEO::NO_VERTEX)
+                continue;
+            const int outVertexId = reorderedVertices[v];
+            PointVisibility* pOut = out_ptsVisibilities[outVertexId];
+
+            std::lock_guard<std::mutex> lock(vertexLocks[outVertexId % vertexLocks.size()]);
+            for(int j = 0; j < rpVis->size(); ++j)
+                pOut->push_back_distinct((*rpVis)[j]);
         }
     }
 
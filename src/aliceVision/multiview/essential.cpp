@@ -118,6 +118,45 @@ int MotionFromEssentialChooseSolution(const std::vector<Mat3> &Rs,
   return -1;
 }
 
+void MotionFromEssentialCheiralityCount(const std::vector<Mat3> &Rs,
+                                        const std::vector<Vec3> &ts,
+                                        const Mat3 &K1,
+                                        const Mat &x1,
+                                        const Mat3 &K2,
+                                        const Mat &x2,
+                                        std::vector<size_t> *counts) {
+  assert(Rs.size() == 4);
+  assert(ts.size() == 4);
+  assert(x1.cols() == x2.cols());
+
+  // Bearing vectors of all the correspondences (the third row of K^-1 is
+  // (0 0 1), so the rays are scaled to z = 1 and the ray depth equals the
+  // camera depth).
+  const Mat3X f1 = K1.inverse() * x1.colwise().homogeneous();
+  const Mat3X f2 = K2.inverse() * x2.colwise().homogeneous();
+
+  counts->assign(4, 0);
+  for (int i = 0; i < 4; ++i) {
+    // Solve the two ray depths of every point in one least squares batch:
+    // z1 (R f1) - z2 f2 = -t, whose normal equations give
+    //   z1 det = (p.q)(q.t) - (q.q)(p.t)
+    //   z2 det = (p.p)(q.t) - (p.q)(p.t)
+    // with p = R f1, q = f2 and det = (p.p)(q.q) - (p.q)^2 >= 0.
+    const Mat3X p = Rs[i] * f1;
+    const Eigen::ArrayXd pp = p.colwise().squaredNorm().transpose().array();
+    const Eigen::ArrayXd qq = f2.colwise().squaredNorm().transpose().array();
+    const Eigen::ArrayXd pq = p.cwiseProduct(f2).colwise().sum().transpose().array();
+    const Eigen::ArrayXd pt = (p.transpose() * ts[i]).array();
+    const Eigen::ArrayXd qt = (f2.transpose() * ts[i]).array();
+    const Eigen::ArrayXd det = pp * qq - pq * pq;
+
+    // Both depths must be positive (det is zero only for parallel rays).
+    (*counts)[i] = ((pq * qt - qq * pt > 0.0) &&
+                    (pp * qt - pq * pt > 0.0) &&
+                    (det > std::numeric_limits<double>::epsilon())).count();
+  }
+}
+
 bool MotionFromEssentialAndCorrespondence(const Mat3 &E,
                                           const Mat3 &K1,
                                           const Vec2 &x1,
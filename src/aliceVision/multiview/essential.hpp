@@ -73,5 +73,18 @@ void MotionFromEssential(const Mat3 &E,
   std::vector<Mat3> *Rs,
   std::vector<Vec3> *ts);
 
+/// Count for each of the four R|t solutions how many of the given
+/// correspondences have a positive depth in both cameras (cheirality).
+/// x1, x2 are 2xN pixel positions; all the points are evaluated against all
+/// the solutions in one vectorized batch, the depths come from the two ray
+/// least squares instead of a per point DLT triangulation.
+void MotionFromEssentialCheiralityCount(const std::vector<Mat3> &Rs,
+                                        const std::vector<Vec3> &ts,
+                                        const Mat3 &K1,
+                                        const Mat &x1,
+                                        const Mat3 &K2,
+                                        const Mat &x2,
+                                        std::vector<size_t> *counts);
+
 
 } // namespace aliceVision
@@ -23,17 +23,22 @@ namespace aliceVision {
 void FivePointsRelativePose(const Mat2X &x1, const Mat2X &x2,
                             std::vector<Mat3> *E);
 
+// Polynomials are stored as a fixed 20 coefficients vector (see the monomial
+// basis below); fixed sizes keep the solver free of heap allocations, it is
+// called once per RANSAC iteration.
+typedef Eigen::Matrix<double, 20, 1> Vec20;
+
 // Compute the nullspace of the linear constraints given by the matches.
-Mat FivePointsNullspaceBasis(const Mat2X &x1, const Mat2X &x2);
+Eigen::Matrix<double, 9, 4> FivePointsNullspaceBasis(const Mat2X &x1, const Mat2X &x2);
 
 // Multiply two polynomials of degree 1.
-Vec o1(const Vec &a, const Vec &b);
+Vec20 o1(const Vec20 &a, const Vec20 &b);
 
 // Multiply a polynomial of degree 2, a, by a polynomial of degree 1, b.
-Vec o2(const Vec &a, const Vec &b);
+Vec20 o2(const Vec20 &a, const Vec20 &b);
 
 // Builds the polynomial constraint matrix M.
-Mat FivePointsPolynomialConstraints(const Mat &E_basis);
+Eigen::Matrix<double, 10, 20> FivePointsPolynomialConstraints(const Eigen::Matrix<double, 9, 4> &E_basis);
 
 // In the following code, polynomials are expressed as vectors containing
 // their coeficients in the basis of monomials:
@@ -79,6 +79,45 @@ BOOST_AUTO_TEST_CASE(EightPointsRelativePose_EightPointsRelativePose_Kernel_IdFo
   }
 }
 
+BOOST_AUTO_TEST_CASE(MotionFromEssential_CheiralityCount) {
+
+  //-- Setup a circular camera rig: the batched cheirality count must designate
+  // the same solution as the per correspondence test.
+  const int iNviews = 5;
+  const int nbPoints = 8;
+  NViewDataSet d = NRealisticCamerasRing(iNviews, nbPoints,
+    NViewDatasetConfigurator(1,1,0,0,5,0)); // Suppose a camera with Unit matrix as K
+
+  for(int i=0; i <iNviews; ++i)
+  {
+    const int j = (i+1)%iNviews;
+
+    //-- Compute Ground Truth motion and its essential matrix
+    Mat3 R;
+    Vec3 t;
+    RelativeCameraMotion(d._R[i], d._t[i], d._R[j], d._t[j], &R, &t);
+    Mat3 E;
+    EssentialFromRt(d._R[i], d._t[i], d._R[j], d._t[j], &E);
+
+    std::vector<Mat3> Rs;
+    std::vector<Vec3> ts;
+    MotionFromEssential(E, &Rs, &ts);
+
+    std::vector<size_t> counts;
+    MotionFromEssentialCheiralityCount(Rs, ts, d._K[i], d._x[i], d._K[j], d._x[j], &counts);
+    BOOST_CHECK_EQUAL(4, counts.size());
+
+    // The winning solution must see every point in front of both cameras and
+    // match both the single correspondence test and the ground truth motion.
+    const int best = std::distance(counts.begin(), std::max_element(counts.begin(), counts.end()));
+    BOOST_CHECK_EQUAL(nbPoints, counts[best]);
+    const int solution = MotionFromEssentialChooseSolution(Rs, ts, d._K[i], d._x[i].col(0), d._K[j], d._x[j].col(0));
+    BOOST_CHECK_EQUAL(solution, best);
+    BOOST_CHECK_SMALL(FrobeniusDistance(R, Rs[best]), 1e-8);
+    BOOST_CHECK_SMALL((t / t.norm() - ts[best] / ts[best].norm()).norm(), 1e-8);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(EightPointsRelativePose_EightPointsRelativePose_Kernel) {
 
   typedef essential::kernel::EightPointKernel Kernel;
@@ -26,7 +26,7 @@ void SevenPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *F) {
     typedef Eigen::Matrix<double, 9, 9> Mat9;
     // In the minimal solution use fixed sized matrix to let Eigen and the
     //  compiler doing the maximum of optimization.
-    Mat9 A = Mat::Zero(9,9);
+    Mat9 A = Mat9::Zero();
     EncodeEpipolarEquation(x1, x2, &A);
 //    Eigen::FullPivLU<Mat9> luA(A);
 //    ALICEVISION_LOG_DEBUG("\n rank(A) = " << luA.rank()); 
@@ -100,7 +100,7 @@ void EightPointSolver::Solve(const Mat &x1, const Mat &x2, vector<Mat3> *Fs, con
     typedef Eigen::Matrix<double, 9, 9> Mat9;
     // In the minimal solution use fixed sized matrix to let Eigen and the
     //  compiler doing the maximum of optimization.
-    Mat9 A = Mat::Zero(9,9);
+    Mat9 A = Mat9::Zero();
     EncodeEpipolarEquation(x1, x2, &A, weights);
     Nullspace(&A, &f);
   }
@@ -97,6 +97,16 @@ struct SampsonError {
     return Square(y.dot(F_x)) / (  F_x.head<2>().squaredNorm()
                                 + Ft_y.head<2>().squaredNorm());
   }
+  /// Batched version: residuals of all the correspondences (one per column)
+  /// for a single F, computed with vectorized expressions.
+  static void Errors(const Mat3 &F, const Mat &x1, const Mat &x2, Vec &errors) {
+    const Mat3X F_x = F * x1.colwise().homogeneous();
+    const Mat3X Ft_y = F.transpose() * x2.colwise().homogeneous();
+    const Vec y_F_x = (x2.colwise().homogeneous().cwiseProduct(F_x)).colwise().sum().transpose();
+    errors = y_F_x.array().square()
+           / (F_x.topRows<2>().colwise().squaredNorm()
+            + Ft_y.topRows<2>().colwise().squaredNorm()).transpose().array();
+  }
 };
 
 struct SymmetricEpipolarDistanceError {
@@ -110,6 +120,17 @@ struct SymmetricEpipolarDistanceError {
                                 + 1.0 / Ft_y.head<2>().squaredNorm())
       / 4.0;  // The divide by 4 is to make this match the Sampson distance.
   }
+  /// Batched version: residuals of all the correspondences (one per column)
+  /// for a single F, computed with vectorized expressions.
+  static void Errors(const Mat3 &F, const Mat &x1, const Mat &x2, Vec &errors) {
+    const Mat3X F_x = F * x1.colwise().homogeneous();
+    const Mat3X Ft_y = F.transpose() * x2.colwise().homogeneous();
+    const Vec y_F_x = (x2.colwise().homogeneous().cwiseProduct(F_x)).colwise().sum().transpose();
+    errors = y_F_x.array().square()
+           * (F_x.topRows<2>().colwise().squaredNorm().cwiseInverse()
+            + Ft_y.topRows<2>().colwise().squaredNorm().cwiseInverse()).transpose().array()
+           / 4.0;
+  }
 };
 
 struct EpipolarDistanceError {
@@ -121,6 +142,14 @@ struct EpipolarDistanceError {
     Vec3 F_x = F * x;
     return Square(F_x.dot(y)) /  F_x.head<2>().squaredNorm();
   }
+  /// Batched version: residuals of all the correspondences (one per column)
+  /// for a single F, computed with vectorized expressions.
+  static void Errors(const Mat3 &F, const Mat &x1, const Mat &x2, Vec &errors) {
+    const Mat3X F_x = F * x1.colwise().homogeneous();
+    const Vec y_F_x = (x2.colwise().homogeneous().cwiseProduct(F_x)).colwise().sum().transpose();
+    errors = y_F_x.array().square()
+           / F_x.topRows<2>().colwise().squaredNorm().transpose().array();
+  }
 };
 typedef EpipolarDistanceError SimpleError;
 
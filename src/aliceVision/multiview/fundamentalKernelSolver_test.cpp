@@ -121,3 +121,32 @@ BOOST_AUTO_TEST_CASE(EightPointTest_Normalized_EasyCase) {
   typedef fundamental::kernel::NormalizedEightPointKernel Kernel;
   BOOST_CHECK(ExpectKernelProperties<Kernel>(x1, x2));
 }
+
+// Check that the batched Errors() of the epipolar error functors matches the
+// per-correspondence Error() evaluation.
+template<typename ErrorT>
+bool ExpectBatchedErrorsMatch(const Mat3 &F, const Mat &x1, const Mat &x2) {
+  Vec errors;
+  ErrorT::Errors(F, x1, x2, errors);
+  if (errors.size() != x1.cols())
+    return false;
+  bool bOk = true;
+  for (int i = 0; i < x1.cols(); ++i)
+    bOk &= std::abs(errors(i) - ErrorT::Error(F, x1.col(i), x2.col(i))) < 1e-12;
+  return bOk;
+}
+
+BOOST_AUTO_TEST_CASE(BatchedErrors_MatchPerSampleEvaluation) {
+  Mat3 F;
+  F << 0,  1, -2,
+      -1,  0,  3,
+       2, -3,  1;
+  Mat x1(2, 8), x2(2, 8);
+  x1 << 0, 0, 0, 1, 1, 1, 2, 2,
+        0, 1, 2, 0, 1, 2, 0, 1;
+  x2 << 0, 0, 0, 1, 1, 1, 2, 2,
+        1, 2, 3, 1, 2, 3, 1, 2;
+  BOOST_CHECK(ExpectBatchedErrorsMatch<fundamental::kernel::SampsonError>(F, x1, x2));
+  BOOST_CHECK(ExpectBatchedErrorsMatch<fundamental::kernel::SymmetricEpipolarDistanceError>(F, x1, x2));
+  BOOST_CHECK(ExpectBatchedErrorsMatch<fundamental::kernel::EpipolarDistanceError>(F, x1, x2));
+}
@@ -77,10 +77,8 @@ void solveQuartic(const Vec5 & factors, Vec4 & realRoots)
  *                    false if world points aligned
  */
 
-bool compute_P3P_Poses(const Mat3 & featureVectors, const Mat3 & worldPoints, Mat & solutions)
+bool compute_P3P_Poses(const Mat3 & featureVectors, const Mat3 & worldPoints, Mat316 & solutions)
 {
-  solutions = Mat(3, 4 * 4);
-
   // Extraction of world points
 
   Vec3 P1 = worldPoints.col(0);
@@ -261,7 +259,7 @@ void P3PSolver::Solve(const Mat &pt2D, const Mat &pt3D, std::vector<Mat34> *mode
   assert(2 == pt2D.rows());
   assert(3 == pt3D.rows());
   assert(pt2D.cols() == pt3D.cols());
-  Mat solutions = Mat(3, 4 * 4);
+  Mat316 solutions;
   Mat3 pt2D_3x3;
   pt2D_3x3.block<2, 3>(0, 0) = pt2D;
   pt2D_3x3.row(2).fill(1);
@@ -304,7 +302,7 @@ void P3P_ResectionKernel_K::Fit(const std::vector<size_t> &samples, std::vector<
 {
   const Mat3 pt2D_3x3(ExtractColumns(x_camera_, samples));
   const Mat3 pt3D_3x3(ExtractColumns(X_, samples));
-  Mat solutions(3, 4 * 4);
+  Mat316 solutions;
   if(compute_P3P_Poses(pt2D_3x3, pt3D_3x3, solutions))
   {
     Mat34 P;
@@ -16,6 +16,9 @@ namespace aliceVision {
 namespace resection {
 
 typedef Eigen::Matrix<double, 5, 1> Vec5;
+// Fixed-size solution storage: [ C1,R1, C2,R2, C3,R3, C4,R4 ], avoids a heap
+// allocation per solver invocation under RANSAC.
+typedef Eigen::Matrix<double, 3, 16> Mat316;
 
 void solveQuartic(const Vec5 & factors, Vec4 & realRoots);
 
@@ -38,7 +41,7 @@ void solveQuartic(const Vec5 & factors, Vec4 & realRoots);
  * Author: Laurent Kneip, adapted to the project by Pierre Moulon
  */
 
-bool compute_P3P_Poses(const Mat3 & featureVectors, const Mat3 & worldPoints, Mat & solutions);
+bool compute_P3P_Poses(const Mat3 & featureVectors, const Mat3 & worldPoints, Mat316 & solutions);
 
 struct P3PSolver
 {
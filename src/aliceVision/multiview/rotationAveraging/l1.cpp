@@ -7,6 +7,9 @@
 
 #include "l1.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <Eigen/SparseCholesky>
 
 #ifdef ALICEVISION_ROTATION_AVERAGING_WITH_BOOST
 #include <boost/graph/adjacency_list.hpp>
@@ -280,13 +283,74 @@ bool IterativelyReweightedLeastSquares(
 {
   return TIterativelyReweightedLeastSquares(A, b, x, sigma, eps);
 }
+// Sparse IRLS specialization: A never changes across the sweeps, only the robust
+// weights do, so the transpose is computed once and the non-zero pattern of the
+// normal matrix At*W*A is analyzed a single time; each sweep only refreshes the
+// values and refactorizes. The weight update is embarrassingly parallel.
+inline bool TIterativelyReweightedLeastSquaresSparse(
+  const Eigen::SparseMatrix<REAL, Eigen::ColMajor>& A,
+  const Eigen::Matrix<REAL, Eigen::Dynamic, 1>& b,
+  Eigen::Matrix<REAL, Eigen::Dynamic, 1>& x,
+  REAL sigma, REAL eps)
+{
+  typedef Eigen::SparseMatrix<REAL, Eigen::ColMajor> SparseMat;
+  typedef Eigen::Matrix<REAL, Eigen::Dynamic, 1> Vector;
+  const unsigned m = (unsigned)b.size();
+  const unsigned n = (unsigned)x.size();
+  assert(A.rows() == m && A.cols() == n);
+
+  const SparseMat At(A.transpose());
+  Eigen::SimplicialLDLT<SparseMat> solver;
+  bool bPatternAnalyzed = false;
+
+  // iterate optimization till the desired precision is reached
+  Vector xp(n), e(m);
+  const REAL sigmaSq(Square(sigma));
+  unsigned iter = 0;
+  REAL delta = std::numeric_limits<REAL>::max(), deltap;
+  do {
+    xp = x;
+    // compute error vector
+    e = A*x-b;
+    // compute robust errors using the Huber-like loss function
+    #pragma omp parallel for
+    for (int i=0; i<(int)m; ++i) {
+      REAL& err = e(i);
+      const REAL errSq(Square(err));
+      err = sigmaSq / (errSq + sigmaSq);
+    }
+    // solve the linear system using l2 norm; the weights are strictly positive,
+    // so At*W*A keeps the same pattern on every sweep
+    const SparseMat AtF(At*e.asDiagonal());
+    const SparseMat AtFA(AtF*A);
+    if (!bPatternAnalyzed) {
+      solver.analyzePattern(AtFA);
+      bPatternAnalyzed = true;
+    }
+    solver.factorize(AtFA);
+    if (solver.info() != Eigen::Success) {
+      ALICEVISION_LOG_WARNING("error: decomposing linear system failed");
+      return false;
+    }
+    x = solver.solve(AtF*b);
+    if (solver.info() != Eigen::Success) {
+      ALICEVISION_LOG_WARNING("error: solving linear system failed");
+      return false;
+    }
+    if (++iter > 32)
+      break;
+    deltap = delta; delta = (xp-x).norm();
+  } while (delta > eps && (deltap-delta)/delta > 1e-2);
+  return true;
+}
+
 bool IterativelyReweightedLeastSquares(
   const Eigen::SparseMatrix<REAL, Eigen::ColMajor>& A,
   const Eigen::Matrix<REAL, Eigen::Dynamic, 1>& b,
   Eigen::Matrix<REAL, Eigen::Dynamic, 1>& x,
   REAL sigma, REAL eps)
 {
-  return TIterativelyReweightedLeastSquares(A, b, x, sigma, eps);
+  return TIterativelyReweightedLeastSquaresSparse(A, b, x, sigma, eps);
 }
 
 /////////////////////////
@@ -434,7 +498,8 @@ unsigned int FilterRelativeRotations(
   assert(threshold >= 0);
   // compute errors for each relative rotation
   std::vector<float> errors(RelRs.size());
-  for(int r= 0; r<RelRs.size(); ++r) {
+  #pragma omp parallel for
+  for(int r= 0; r<(int)RelRs.size(); ++r) {
     const RelativeRotation& relR = RelRs[r];
     const Matrix3x3& Ri = Rs[relR.i];
     const Matrix3x3& Rj = Rs[relR.j];
@@ -605,7 +670,8 @@ inline void _FillErrorMatrix(
   const Matrix3x3Arr& Rs,
   Eigen::Matrix<REAL,Eigen::Dynamic,1>& b)
 {
-  for (size_t r = 0; r < RelRs.size(); ++r) {
+  #pragma omp parallel for
+  for (int r = 0; r < (int)RelRs.size(); ++r) {
     const RelativeRotation& relR = RelRs[r];
     const Matrix3x3& Ri = Rs[relR.i];
     const Matrix3x3& Rj = Rs[relR.j];
@@ -11,9 +11,41 @@
 #include <aliceVision/multiview/projection.hpp>
 #include <aliceVision/robustEstimation/LORansac.hpp>
 #include <aliceVision/robustEstimation/ScoreEvaluator.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 namespace aliceVision {
 
+namespace {
+
+/**
+ * @brief Fixed-size DLT for the common small view counts: the design matrix and
+ * its SVD live on the stack, no heap allocation per call. The minimal fits of
+ * the LO-RANSAC kernel (2 views) and most tracks (2-4 observations) go through
+ * here.
+ */
+template<int NbViews>
+inline void triangulateAlgebraicFixed(const Mat2X& x,
+                                      const std::vector<Mat34>& Ps,
+                                      Vec4* X,
+                                      const std::vector<double>* weights)
+{
+  typedef Eigen::Matrix<double, 2 * NbViews, 4> DesignMat;
+  DesignMat design;
+  for(int i = 0; i < NbViews; ++i)
+  {
+    design.template block<2, 4>(2 * i, 0) = SkewMatMinimal(x.col(i)) * Ps[i];
+    if(weights != nullptr)
+    {
+      design.template block<2, 4>(2 * i, 0) *= (*weights)[i];
+    }
+  }
+  // same construction as Nullspace(), on the fixed-size type
+  const Eigen::JacobiSVD<DesignMat> svd(design, Eigen::ComputeFullV);
+  (*X) = svd.matrixV().col(3);
+}
+
+} // namespace
+
 void TriangulateNView(const Mat2X &x,
                       const std::vector< Mat34 > &Ps,
                       Vec4 *X, 
@@ -44,6 +76,15 @@ void TriangulateNViewAlgebraic(const Mat2X &x,
   Mat2X::Index nviews = x.cols();
   assert(static_cast<std::size_t>(nviews) == Ps.size());
 
+  // small view counts dominate: dispatch to the heap-free fixed-size kernels
+  switch(nviews)
+  {
+    case 2: triangulateAlgebraicFixed<2>(x, Ps, X, weights); return;
+    case 3: triangulateAlgebraicFixed<3>(x, Ps, X, weights); return;
+    case 4: triangulateAlgebraicFixed<4>(x, Ps, X, weights); return;
+    default: break;
+  }
+
   Mat design(2 * nviews, 4);
   for(Mat2X::Index i = 0; i < nviews; ++i)
   {
@@ -56,7 +97,21 @@ void TriangulateNViewAlgebraic(const Mat2X &x,
   Nullspace(&design, X);
 }
 
-void TriangulateNViewLORANSAC(const Mat2X &x, 
+void TriangulateNViewAlgebraicBatch(const std::vector<Mat2X>& xPerTrack,
+                                    const std::vector<std::vector<Mat34>>& PsPerTrack,
+                                    std::vector<Vec4>& X)
+{
+  assert(xPerTrack.size() == PsPerTrack.size());
+  X.resize(xPerTrack.size());
+
+  #pragma omp parallel for
+  for(int i = 0; i < static_cast<int>(xPerTrack.size()); ++i)
+  {
+    TriangulateNViewAlgebraic(xPerTrack[i], PsPerTrack[i], &X[i]);
+  }
+}
+
+void TriangulateNViewLORANSAC(const Mat2X &x,
                               const std::vector< Mat34 > &Ps,
                               Vec4 *X, 
                               std::vector<std::size_t> *inliersIndex, 
@@ -48,6 +48,19 @@ void TriangulateNViewAlgebraic(const Mat2X &x,
                                Vec4 *X, 
                                const std::vector<double> *weights = nullptr);
 
+/**
+ * @brief Triangulate a whole array of tracks at once with TriangulateNViewAlgebraic,
+ * distributing the tracks over the OpenMP threads. Tracks with 2 to 4 observations
+ * go through heap-free fixed-size kernels.
+ *
+ * @param[in] xPerTrack per track, the 2D coordinates in each image (2 x nbViews)
+ * @param[in] PsPerTrack per track, the projective matrix of each camera
+ * @param[out] X one estimated 3D point per track
+ */
+void TriangulateNViewAlgebraicBatch(const std::vector<Mat2X>& xPerTrack,
+                                    const std::vector<std::vector<Mat34>>& PsPerTrack,
+                                    std::vector<Vec4>& X);
+
 /**
  * @brief Compute a 3D position of a point from several images of it. In particular,
  * compute the projective point X in R^4 such that x ~ PX.
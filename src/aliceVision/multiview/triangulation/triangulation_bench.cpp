@@ -0,0 +1,97 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/multiview/triangulation/Triangulation.hpp"
+#include "aliceVision/multiview/triangulation/triangulationDLT.hpp"
+#include "aliceVision/multiview/NViewDataSet.hpp"
+#include <aliceVision/system/Benchmark.hpp>
+
+#include <vector>
+
+using namespace aliceVision;
+
+// a realistic camera ring, every point is triangulated from all the views
+static const int NB_VIEWS = 5;
+static const int NB_POINTS = 64;
+
+const NViewDataSet& dataset()
+{
+  static const NViewDataSet d = NRealisticCamerasRing(NB_VIEWS, NB_POINTS);
+  return d;
+}
+
+void triangulation_nView(std::size_t nbIterations)
+{
+  const NViewDataSet& d = dataset();
+
+  std::vector<Mat34> Ps(NB_VIEWS);
+  for(int j = 0; j < NB_VIEWS; ++j)
+    Ps[j] = d.P(j);
+
+  for(std::size_t it = 0; it < nbIterations; ++it)
+  {
+    for(int i = 0; i < NB_POINTS; ++i)
+    {
+      Mat2X xs(2, NB_VIEWS);
+      for(int j = 0; j < NB_VIEWS; ++j)
+        xs.col(j) = d._x[j].col(i);
+
+      Vec4 X;
+      TriangulateNView(xs, Ps, &X);
+      system::benchmarkDoNotOptimize(X);
+    }
+  }
+}
+
+void triangulation_nViewAlgebraic(std::size_t nbIterations)
+{
+  const NViewDataSet& d = dataset();
+
+  std::vector<Mat34> Ps(NB_VIEWS);
+  for(int j = 0; j < NB_VIEWS; ++j)
+    Ps[j] = d.P(j);
+
+  for(std::size_t it = 0; it < nbIterations; ++it)
+  {
+    for(int i = 0; i < NB_POINTS; ++i)
+    {
+      Mat2X xs(2, NB_VIEWS);
+      for(int j = 0; j < NB_VIEWS; ++j)
+        xs.col(j) = d._x[j].col(i);
+
+      Vec4 X;
+      TriangulateNViewAlgebraic(xs, Ps, &X);
+      system::benchmarkDoNotOptimize(X);
+    }
+  }
+}
+
+void triangulation_DLT(std::size_t nbIterations)
+{
+  const NViewDataSet& d = dataset();
+
+  const Mat34 P1 = d.P(0);
+  const Mat34 P2 = d.P(1);
+
+  for(std::size_t it = 0; it < nbIterations; ++it)
+  {
+    for(int i = 0; i < NB_POINTS; ++i)
+    {
+      const Vec2 x1 = d._x[0].col(i);
+      const Vec2 x2 = d._x[1].col(i);
+
+      Vec3 X;
+      TriangulateDLT(P1, x1, P2, x2, &X);
+      system::benchmarkDoNotOptimize(X);
+    }
+  }
+}
+
+ALICEVISION_BENCHMARK(triangulation_nView)
+ALICEVISION_BENCHMARK(triangulation_nViewAlgebraic)
+ALICEVISION_BENCHMARK(triangulation_DLT)
+
+ALICEVISION_BENCHMARK_MAIN()
@@ -86,6 +86,78 @@ BOOST_AUTO_TEST_CASE(Triangulate_NViewAlgebraic_FiveViews) {
   }
 }
 
+// exercise the fixed-size 2/3/4-view kernels and the dynamic fallback
+BOOST_AUTO_TEST_CASE(Triangulate_NViewAlgebraic_SmallViewCounts) {
+  for (int nviews = 2; nviews <= 5; ++nviews)
+  {
+    const int npoints = 6;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints);
+
+    std::vector<Mat34> Ps(nviews);
+    for (int j = 0; j < nviews; ++j)
+    {
+      Ps[j] = d.P(j);
+    }
+
+    for (int i = 0; i < npoints; ++i)
+    {
+      Mat2X xs(2, nviews);
+      for (int j = 0; j < nviews; ++j)
+      {
+        xs.col(j) = d._x[j].col(i);
+      }
+      Vec4 X;
+      TriangulateNViewAlgebraic(xs, Ps, &X);
+
+      for (int j = 0; j < nviews; ++j)
+      {
+        Vec3 x_reprojected = Ps[j]*X;
+        x_reprojected /= x_reprojected(2);
+        const double error = (x_reprojected.head<2>() - xs.col(j)).norm();
+        BOOST_CHECK_SMALL(error, 1e-9);
+      }
+    }
+  }
+}
+
+// batch triangulation must give the same result as the per-track calls
+BOOST_AUTO_TEST_CASE(Triangulate_NViewAlgebraic_Batch) {
+  const int nviews = 3;
+  const int npoints = 6;
+  const NViewDataSet d = NRealisticCamerasRing(nviews, npoints);
+
+  std::vector<Mat34> Ps(nviews);
+  for (int j = 0; j < nviews; ++j)
+  {
+    Ps[j] = d.P(j);
+  }
+
+  std::vector<Mat2X> xPerTrack(npoints);
+  std::vector<std::vector<Mat34>> PsPerTrack(npoints, Ps);
+  for (int i = 0; i < npoints; ++i)
+  {
+    xPerTrack[i].resize(2, nviews);
+    for (int j = 0; j < nviews; ++j)
+    {
+      xPerTrack[i].col(j) = d._x[j].col(i);
+    }
+  }
+
+  std::vector<Vec4> X;
+  TriangulateNViewAlgebraicBatch(xPerTrack, PsPerTrack, X);
+  BOOST_CHECK_EQUAL(npoints, X.size());
+
+  for (int i = 0; i < npoints; ++i)
+  {
+    Vec4 Xsingle;
+    TriangulateNViewAlgebraic(xPerTrack[i], Ps, &Xsingle);
+    // the nullspace vector is defined up to sign
+    if (X[i].dot(Xsingle) < 0.0)
+      Xsingle = -Xsingle;
+    BOOST_CHECK_SMALL((X[i] - Xsingle).norm(), 1e-12);
+  }
+}
+
 // test DLT triangulation using weights, it generates some random projection
 // matrices, a random 3D points and its corresponding 2d image points. Some of these
 // points are considered as outliers. Inliers are assigned a max weight, outliers
@@ -0,0 +1,112 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2019 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/StaticVector.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace aliceVision {
+
+/**
+ * @brief Read-only view of an array file written by saveArrayToFile / saveArrayToFileMappable.
+ *
+ * Files in the mappable format are read straight out of a memory mapping: opening costs
+ * no copy and only the pages actually touched get faulted in, which is what the
+ * filtering and fusion stages want when they stream depth, seed and visibility arrays
+ * from network storage. Compressed and legacy files are loaded into an owned buffer on
+ * open, so callers do not have to care which format is on disk.
+ */
+template <class T>
+class ArrayFileView
+{
+public:
+    ArrayFileView() = default;
+
+    explicit ArrayFileView(const std::string& fileName)
+    {
+        open(fileName);
+    }
+
+    /// map or load the given array file, throws on missing or malformed files
+    /// (same contract as loadArrayFromFile)
+    void open(const std::string& fileName)
+    {
+        close();
+
+        int marker = 0;
+        try
+        {
+            _file.open(fileName);
+        }
+        catch(const std::exception&)
+        {
+            ALICEVISION_THROW_ERROR("ArrayFileView: can't open file " << fileName);
+        }
+        if(!_file.is_open() || _file.size() < sizeof(int))
+        {
+            ALICEVISION_THROW_ERROR("ArrayFileView: can't open file " << fileName);
+        }
+        std::memcpy(&marker, _file.data(), sizeof(int));
+
+        if(marker == arrayFileMappableMarker)
+        {
+            int header[3]; // version, count, padding
+            if(_file.size() < 4 * sizeof(int))
+            {
+                ALICEVISION_THROW_ERROR("ArrayFileView: truncated header: " << fileName);
+            }
+            std::memcpy(header, _file.data() + sizeof(int), 3 * sizeof(int));
+            if(header[0] != arrayFileVersion)
+            {
+                ALICEVISION_THROW_ERROR("ArrayFileView: unsupported array file version " << header[0] << ": " << fileName);
+            }
+            const int n = header[1];
+            if(_file.size() < 4 * sizeof(int) + sizeof(T) * static_cast<std::size_t>(n))
+            {
+                ALICEVISION_THROW_ERROR("ArrayFileView: truncated payload: " << fileName);
+            }
+            _data = reinterpret_cast<const T*>(_file.data() + 4 * sizeof(int));
+            _size = n;
+        }
+        else
+        {
+            // compressed or legacy layout: the payload is either not raw or not aligned
+            // in the file, fall back to an owned copy through the regular loader
+            _file.close();
+            loadArrayFromFile(_owned, fileName);
+            _data = _owned.getData().data();
+            _size = _owned.size();
+        }
+    }
+
+    void close()
+    {
+        if(_file.is_open())
+            _file.close();
+        _owned.clear();
+        _data = nullptr;
+        _size = 0;
+    }
+
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    const T* data() const { return _data; }
+
+    const T& operator[](int index) const { return _data[index]; }
+
+private:
+    boost::iostreams::mapped_file_source _file;
+    StaticVector<T> _owned; // filled only for compressed and legacy files
+    const T* _data = nullptr;
+    int _size = 0;
+};
+
+} // namespace aliceVision
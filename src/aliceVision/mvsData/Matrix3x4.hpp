@@ -6,10 +6,15 @@
 
 #pragma once
 
+#include <aliceVision/config.hpp>
 #include <aliceVision/mvsData/Matrix3x3.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
 namespace aliceVision {
 
 class Matrix3x4
@@ -43,9 +48,60 @@ public:
 
     inline Point3d operator*(const Point3d& _p) const
     {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+        // one matrix row per 256 bit register against {x, y, z, 1}; the loads stay
+        // unaligned because the mvsData types keep their packed layout: they are
+        // written to disk as raw bytes and stored in std::vector, which does not
+        // over-align its buffer
+        const __m256d p = _mm256_set_pd(1.0, _p.z, _p.y, _p.x);
+        const __m256d r0 = _mm256_mul_pd(_mm256_loadu_pd(m + 0), p);
+        const __m256d r1 = _mm256_mul_pd(_mm256_loadu_pd(m + 4), p);
+        const __m256d r2 = _mm256_mul_pd(_mm256_loadu_pd(m + 8), p);
+        const __m256d s01 = _mm256_hadd_pd(r0, r1); // {x partials, y partials}
+        const __m256d xy = _mm256_add_pd(s01, _mm256_permute2f128_pd(s01, s01, 0x01));
+        const __m256d s22 = _mm256_hadd_pd(r2, r2);
+        const __m256d zz = _mm256_add_pd(s22, _mm256_permute2f128_pd(s22, s22, 0x01));
+        const __m128d xyLow = _mm256_castpd256_pd128(xy);
+        return Point3d(_mm_cvtsd_f64(xyLow), _mm_cvtsd_f64(_mm_unpackhi_pd(xyLow, xyLow)),
+                       _mm256_cvtsd_f64(zz));
+#else
         return Point3d(m11 * _p.x + m12 * _p.y + m13 * _p.z + m14,
                        m21 * _p.x + m22 * _p.y + m23 * _p.z + m24,
                        m31 * _p.x + m32 * _p.y + m33 * _p.z + m34);
+#endif
+    }
+
+    /**
+     * @brief Apply the transform to an array of points at once, keeping the matrix
+     * rows in registers across the whole array instead of reloading them per point.
+     */
+    inline void mapPoints(Point3d* out, const Point3d* in, int n) const
+    {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+        const __m256d row0 = _mm256_loadu_pd(m + 0);
+        const __m256d row1 = _mm256_loadu_pd(m + 4);
+        const __m256d row2 = _mm256_loadu_pd(m + 8);
+        for(int i = 0; i < n; ++i)
+        {
+            const __m256d p = _mm256_set_pd(1.0, in[i].z, in[i].y, in[i].x);
+            const __m256d r0 = _mm256_mul_pd(row0, p);
+            const __m256d r1 = _mm256_mul_pd(row1, p);
+            const __m256d r2 = _mm256_mul_pd(row2, p);
+            const __m256d s01 = _mm256_hadd_pd(r0, r1);
+            const __m256d xy = _mm256_add_pd(s01, _mm256_permute2f128_pd(s01, s01, 0x01));
+            const __m256d s22 = _mm256_hadd_pd(r2, r2);
+            const __m256d zz = _mm256_add_pd(s22, _mm256_permute2f128_pd(s22, s22, 0x01));
+            const __m128d xyLow = _mm256_castpd256_pd128(xy);
+            out[i].x = _mm_cvtsd_f64(xyLow);
+            out[i].y = _mm_cvtsd_f64(_mm_unpackhi_pd(xyLow, xyLow));
+            out[i].z = _mm256_cvtsd_f64(zz);
+        }
+#else
+        for(int i = 0; i < n; ++i)
+        {
+            out[i] = *this * in[i];
+        }
+#endif
     }
 
     inline double deteminant() const
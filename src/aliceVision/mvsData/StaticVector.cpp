@@ -25,7 +25,17 @@ int getArrayLengthFromFile(std::string fileName)
     {
         ALICEVISION_LOG_WARNING("[IO] getArrayLengthFromFile: can't read array length (1)");
     }
-    if(n == -1)
+    if(n == arrayFileMappableMarker)
+    {
+        int header[2]; // version, count
+        retval = fread(header, sizeof(int), 2, f);
+        if( retval != 2 )
+        {
+            ALICEVISION_LOG_WARNING("[IO] getArrayLengthFromFile: can't read mappable header");
+        }
+        n = header[1];
+    }
+    else if(n == -1)
     {
         retval = fread(&n, sizeof(int), 1, f);
         if( retval != sizeof(int) )
@@ -6,12 +6,14 @@
 
 #pragma once
 
+#include <aliceVision/system/hugePages.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 #include <algorithm>
 #include <assert.h>
 #include <cstdlib>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 #include <zlib.h>
 #include <iostream>
@@ -20,6 +22,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace aliceVision {
 
 template <class T>
@@ -82,6 +89,32 @@ public:
         _data.shrink_to_fit();
     }
 
+    /**
+     * @brief Opt-in: ask the kernel to back the buffer with transparent huge
+     * pages, reducing dTLB pressure on multi-GB arrays (similarity volumes,
+     * fused point arrays). Call it once after the big reserve/resize; buffers
+     * below the huge-page size are left alone.
+     */
+    void adviseHugePages()
+    {
+        const std::size_t nbBytes = capacity() * sizeof(T);
+        if(nbBytes >= system::hugePageSize())
+            system::adviseHugePages(_data.data(), nbBytes);
+    }
+
+    /**
+     * @brief Drop the buffer and return its physical pages to the kernel right
+     * away (madvise MADV_DONTNEED before the free), instead of letting the
+     * allocator cache a multi-GB block. The vector is empty afterwards.
+     */
+    void freeMem()
+    {
+        // dropping page content is only safe when no destructor will read it
+        if(std::is_trivially_destructible<T>::value)
+            system::releasePages(_data.data(), capacity() * sizeof(T));
+        std::vector<T>().swap(_data);
+    }
+
     void reserveAddIfNeeded(int nplanned, int ntoallocated)
     {
         if(size() + nplanned > capacity())
@@ -202,6 +235,15 @@ int indexOf(T* arr, int n, const T& what)
     return isthereindex;
 }
 
+// saveArrayToFile writes one of three layouts, distinguished by the first int:
+//   n >= 0 : legacy, the count directly followed by the raw payload
+//   -1     : zlib-compressed, see the docompress parameter of saveArrayToFile
+//   -2     : mappable, a versioned 16-byte header ([-2][version][n][pad]) followed
+//            by the raw payload; the payload is then 16-byte aligned in the file
+//            so ArrayFileView can read it in place from a memory mapping
+static const int arrayFileMappableMarker = -2;
+static const int arrayFileVersion = 1;
+
 template <class T>
 void saveArrayOfArraysToFile(std::string fileName, StaticVector<StaticVector<T>*>* aa)
 {
@@ -426,6 +468,71 @@ void saveArrayToFile(std::string fileName, const StaticVector<T>* a, bool docomp
     };
 }
 
+/**
+ * @brief Write the array uncompressed with the versioned, alignment-friendly header
+ * so that ArrayFileView can map it directly. The payload is streamed out in bounded
+ * chunks; with dropPageCache the written pages are flushed and evicted right away,
+ * which keeps multi-GB intermediate dumps from pushing working data out of the
+ * page cache.
+ */
+template <class T>
+void saveArrayToFileMappable(std::string fileName, const StaticVector<T>* a, bool dropPageCache = false)
+{
+    ALICEVISION_LOG_DEBUG("[IO] saveArrayToFileMappable: " << fileName);
+
+    boost::filesystem::path filepath = fileName;
+    boost::filesystem::create_directories( filepath.parent_path() );
+
+    if( !a )
+    {
+        ALICEVISION_LOG_DEBUG("[IO] saveArrayToFileMappable called with NULL static vector");
+        return;
+    }
+
+    if( a->size() == 0 )
+    {
+        ALICEVISION_LOG_WARNING("[IO] saveArrayToFileMappable called with 0-sized static vector");
+        return;
+    }
+
+    FILE* f = fopen(fileName.c_str(), "wb");
+    if( f == NULL )
+    {
+        ALICEVISION_THROW_ERROR( "[IO] file " << fileName << " could not be opened, msg: " << strerror(errno) );
+    }
+    const int header[4] = {arrayFileMappableMarker, arrayFileVersion, a->size(), 0};
+    int items = fwrite(header, sizeof(int), 4, f);
+    if( items < 4 && ferror(f) != 0 )
+    {
+        fclose(f);
+        ALICEVISION_THROW_ERROR( "[IO] failed to write header to " << fileName << ", msg: " << strerror(errno) );
+    }
+    const char* src = reinterpret_cast<const char*>(&(*a)[0]);
+    size_t remaining = sizeof(T) * a->size();
+    const size_t chunkSize = 4 * 1024 * 1024;
+    while( remaining > 0 )
+    {
+        const size_t nbBytes = std::min(remaining, chunkSize);
+        items = fwrite(src, 1, nbBytes, f);
+        if( items < nbBytes && ferror(f) != 0 )
+        {
+            fclose(f);
+            ALICEVISION_THROW_ERROR( "[IO] failed to write payload to " << fileName << ", msg: " << strerror(errno) );
+        }
+        src += nbBytes;
+        remaining -= nbBytes;
+    }
+#if defined(__linux__)
+    if( dropPageCache )
+    {
+        fflush(f);
+        fdatasync(fileno(f));
+        posix_fadvise(fileno(f), 0, 0, POSIX_FADV_DONTNEED);
+    }
+#endif
+    fclose(f);
+}
+
 template <class T>
 StaticVector<T>* loadArrayFromFile(std::string fileName, bool printfWarning = false)
 {
@@ -447,7 +554,32 @@ StaticVector<T>* loadArrayFromFile(std::string fileName, bool printfWarning = fa
         }
         StaticVector<T>* a = NULL;
 
-        if(n == -1)
+        if(n == arrayFileMappableMarker)
+        {
+            int header[3]; // version, count, padding
+            retval = fread(header, sizeof(int), 3, f);
+            if( retval != 3 )
+            {
+                fclose(f);
+                ALICEVISION_THROW_ERROR("[IO] loadArrayFromFile: can't read mappable header from " << fileName);
+            }
+            if( header[0] != arrayFileVersion )
+            {
+                fclose(f);
+                ALICEVISION_THROW_ERROR("[IO] loadArrayFromFile: unsupported array file version " << header[0] << ": " << fileName);
+            }
+            n = header[1];
+            a = new StaticVector<T>();
+            a->resize(n);
+            retval = fread(&(*a)[0], sizeof(T), n, f);
+            if( retval != n )
+            {
+                delete a;
+                fclose(f);
+                ALICEVISION_THROW_ERROR("[IO] loadArrayFromFile: can't read n elements");
+            }
+        }
+        else if(n == -1)
         {
             retval = fread(&n, sizeof(int), 1, f);
             if( retval != 1 )
@@ -531,7 +663,24 @@ bool loadArrayFromFile( StaticVector<T>& out, std::string fileName, bool printfW
             ALICEVISION_LOG_WARNING("[IO] loadArrayFromFile: can't read array size (1) from " << fileName);
         out.clear();
 
-        if(n == -1)
+        if(n == arrayFileMappableMarker)
+        {
+            int header[3]; // version, count, padding
+            retval = fread(header, sizeof(int), 3, f);
+            if( retval != 3 )
+                ALICEVISION_LOG_WARNING("[IO] loadArrayFromFile: can't read mappable header from " << fileName);
+            if( header[0] != arrayFileVersion )
+            {
+                fclose(f);
+                throw std::runtime_error("loadArrayFromFile: unsupported array file version: " + fileName);
+            }
+            n = header[1];
+            out.resize(n);
+            retval = fread(out.getDataWritable().data(), sizeof(T), n, f);
+            if( retval != n )
+                ALICEVISION_LOG_WARNING("[IO] loadArrayFromFile: can't read n elements");
+        }
+        else if(n == -1)
         {
             retval = fread(&n, sizeof(int), 1, f);
             if( retval != 1 )
@@ -589,8 +738,25 @@ void loadArrayFromFileIntoArray(StaticVector<T>* a, std::string fileName, bool p
     }
     int n = 0;
     fread(&n, sizeof(int), 1, f);
- 
-    if(n == -1)
+
+    if(n == arrayFileMappableMarker)
+    {
+        int header[3]; // version, count, padding
+        fread(header, sizeof(int), 3, f);
+        if(header[0] != arrayFileVersion)
+        {
+            fclose(f);
+            ALICEVISION_THROW_ERROR("loadArrayFromFileIntoArray: unsupported array file version " << header[0] << ": " << fileName);
+        }
+        n = header[1];
+        if(a->size() != n)
+        {
+            fclose(f);
+            ALICEVISION_THROW_ERROR("loadArrayFromFileIntoArray: expected length " << a->size() << " loaded length " << n);
+        }
+        fread(&(*a)[0], sizeof(T), n, f);
+    }
+    else if(n == -1)
     {
         fread(&n, sizeof(int), 1, f);
         if(a->size() != n)
@@ -0,0 +1,149 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/StaticVector.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Flattened replacement for StaticVector<StaticVector<T>*>.
+ *
+ * All the inner vectors live in one arena indexed by an offset table, so building and
+ * destroying millions of small vectors costs two allocations instead of one each, the
+ * elements of consecutive vectors are contiguous in memory and there is no pointer to
+ * chase per entry. The inner vectors are appended once and keep their size afterwards.
+ */
+template <class T>
+class StaticVectorOfVector
+{
+    std::vector<std::size_t> _offsets; // offset of the first element of every inner vector, plus one past-the-end entry
+    std::vector<T> _arena;
+
+public:
+    StaticVectorOfVector()
+    {
+        _offsets.push_back(0);
+    }
+
+    void clear()
+    {
+        _offsets.clear();
+        _offsets.push_back(0);
+        _arena.clear();
+    }
+
+    void reserve(int nbVectors, std::size_t nbElemsTotal)
+    {
+        _offsets.reserve(nbVectors + 1);
+        _arena.reserve(nbElemsTotal);
+    }
+
+    /// append one inner vector, n may be 0
+    void addVector(const T* data, int n)
+    {
+        if(n > 0)
+            _arena.insert(_arena.end(), data, data + n);
+        _offsets.push_back(_arena.size());
+    }
+
+    void addVector(const StaticVector<T>& v)
+    {
+        addVector(v.getData().data(), v.size());
+    }
+
+    void addEmptyVector()
+    {
+        _offsets.push_back(_arena.size());
+    }
+
+    /// number of inner vectors
+    int size() const { return (int)_offsets.size() - 1; }
+    /// total number of elements over all the inner vectors
+    std::size_t nbElems() const { return _arena.size(); }
+
+    int sizeOfVector(int i) const { return (int)(_offsets[i + 1] - _offsets[i]); }
+    bool emptyVector(int i) const { return _offsets[i + 1] == _offsets[i]; }
+
+    const T& operator()(int i, int j) const { return _arena[_offsets[i] + j]; }
+    T& operator()(int i, int j) { return _arena[_offsets[i] + j]; }
+
+    const T* vectorData(int i) const { return _arena.data() + _offsets[i]; }
+};
+
+/// same file format as the StaticVector<StaticVector<T>*> overload
+template <class T>
+void saveArrayOfArraysToFile(std::string fileName, const StaticVectorOfVector<T>& aa)
+{
+    ALICEVISION_LOG_DEBUG("[IO] saveArrayOfArraysToFile: " << fileName);
+    FILE* f = fopen(fileName.c_str(), "wb");
+    int n = aa.size();
+    fwrite(&n, sizeof(int), 1, f);
+    for(int i = 0; i < n; i++)
+    {
+        int m = aa.sizeOfVector(i);
+        fwrite(&m, sizeof(int), 1, f);
+        if(m > 0)
+        {
+            fwrite(aa.vectorData(i), sizeof(T), m, f);
+        }
+    }
+    fclose(f);
+}
+
+template <class T>
+void loadArrayOfArraysFromFile(StaticVectorOfVector<T>& out, std::string fileName)
+{
+    ALICEVISION_LOG_DEBUG("[IO] loadArrayOfArraysFromFile: " << fileName);
+    FILE* f = fopen(fileName.c_str(), "rb");
+    if(f == nullptr)
+    {
+        ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't open file " << fileName);
+    }
+
+    int n = 0;
+    size_t retval = fread(&n, sizeof(int), 1, f);
+    if( retval != 1 )
+    {
+        fclose(f);
+        ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't read outer array size");
+    }
+    out.clear();
+    out.reserve(n, 0);
+    std::vector<T> buffer;
+    for(int i = 0; i < n; i++)
+    {
+        int m = 0;
+        retval = fread(&m, sizeof(int), 1, f);
+        if( retval != 1 )
+        {
+            fclose(f);
+            ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't read inner array size");
+        }
+        if(m > 0)
+        {
+            buffer.resize(m);
+            retval = fread(buffer.data(), sizeof(T), m, f);
+            if( retval != m )
+            {
+                fclose(f);
+                ALICEVISION_THROW_ERROR("[IO] loadArrayOfArraysFromFile: can't read vector element");
+            }
+            out.addVector(buffer.data(), m);
+        }
+        else
+        {
+            out.addEmptyVector();
+        }
+    }
+    fclose(f);
+}
+
+} // namespace aliceVision
@@ -69,4 +69,78 @@ void Universe::addEdge(int x, int y)
     }
 }
 
+ConcurrentUniverse::ConcurrentUniverse(int elements)
+{
+    parents = new std::atomic<int>[elements];
+    sizes = new int[elements];
+    allelems = elements;
+    initialize();
+}
+
+ConcurrentUniverse::~ConcurrentUniverse()
+{
+    delete[] parents;
+    delete[] sizes;
+}
+
+void ConcurrentUniverse::initialize()
+{
+    for(int i = 0; i < allelems; i++)
+    {
+        parents[i].store(i, std::memory_order_relaxed); // initialized to the index
+        sizes[i] = 1;
+    }
+}
+
+int ConcurrentUniverse::find(int x)
+{
+    while(true)
+    {
+        int p = parents[x].load(std::memory_order_relaxed);
+        int gp = parents[p].load(std::memory_order_relaxed);
+        if(p == gp) // p is a root
+            return p;
+        // path halving: a failed exchange only means another thread already
+        // shortened the path of x
+        parents[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+void ConcurrentUniverse::addEdge(int x, int y)
+{
+    while(true)
+    {
+        x = find(x);
+        y = find(y);
+        if(x == y) // already in the same component
+            return;
+        if(x > y)
+        {
+            const int tmp = x;
+            x = y;
+            y = tmp;
+        }
+        // y is a root iff parents[y] == y, and parent indexes only ever decrease,
+        // so a successful exchange means y was still a root
+        int expected = y;
+        if(parents[y].compare_exchange_strong(expected, x, std::memory_order_relaxed))
+            return;
+    }
+}
+
+void ConcurrentUniverse::computeSizes()
+{
+    for(int i = 0; i < allelems; i++)
+        sizes[i] = 0;
+
+#pragma omp parallel for
+    for(int i = 0; i < allelems; i++)
+    {
+        const int root = find(i);
+#pragma omp atomic
+        ++sizes[root];
+    }
+}
+
 } // namespace aliceVision
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <atomic>
+
 namespace aliceVision {
 
 typedef struct
@@ -41,4 +43,39 @@ public:
     int num, allelems;
 };
 
+/**
+ * @brief Lock-free variant of Universe: find and addEdge can be called concurrently
+ * from multiple threads, so the edges of a segmentation can be fused in parallel.
+ *
+ * Unions attach the root with the highest index below the one with the lowest index,
+ * so the parent indexes only ever decrease and a single compare-and-swap per union
+ * is enough. Sizes are not maintained during the unions: call computeSizes() once
+ * all the edges have been added, before using size().
+ */
+class ConcurrentUniverse
+{
+public:
+    explicit ConcurrentUniverse(int elements);
+    ~ConcurrentUniverse();
+    /// Initialize all elements to the default values
+    void initialize();
+    /// Retrieve the smallest index of the elements connected to x.
+    /// Thread-safe, it shortens the visited paths along the way.
+    int find(int x);
+    /// Connect the components of x and y. Thread-safe.
+    void addEdge(int x, int y);
+    /// Compute the size of each component, to call once after all the edges.
+    void computeSizes();
+
+    inline int size(int x) const
+    {
+        return sizes[x]; // x must be a root returned by find
+    }
+
+private:
+    std::atomic<int>* parents;
+    int* sizes;
+    int allelems;
+};
+
 } // namespace aliceVision
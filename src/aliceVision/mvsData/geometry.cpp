@@ -5,8 +5,13 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "geometry.hpp"
+#include <aliceVision/config.hpp>
 #include <aliceVision/mvsData/geometryTriTri.hpp>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
 #include <cfloat>
 
 namespace aliceVision {
@@ -334,6 +339,140 @@ bool isLineInTriangle(Point3d* P, const Point3d* A, const Point3d* B, const Poin
     return isPointInTriangle(getLineTriangleIntersectBarycCoords(P, A, B, C, linePoint, lineVect));
 }
 
+void lineTetrahedronIntersections(Point3d out_lpi[4], bool out_hit[4], const Point3d& A, const Point3d& B,
+                                  const Point3d& C, const Point3d& D, const Point3d& linePoint,
+                                  const Point3d& lineVect)
+{
+    // facet i is opposite to vertex i: {B,C,D}, {A,C,D}, {A,B,D}, {A,B,C}, each one
+    // expressed as a base vertex and two edge vectors like in
+    // getLineTriangleIntersectBarycCoords; the four facets only involve five distinct
+    // edge vectors
+    const float ax = A.x, ay = A.y, az = A.z;
+    const float bx = B.x, by = B.y, bz = B.z;
+
+    const float baseX[4] = {bx, ax, ax, ax};
+    const float baseY[4] = {by, ay, ay, ay};
+    const float baseZ[4] = {bz, az, az, az};
+    // the edge vectors are computed from the double precision coordinates and then
+    // rounded, like in getLineTriangleIntersectBarycCoords
+    const float v0X[4] = {float(D.x - bx), float(D.x - ax), float(D.x - ax), float(C.x - ax)};
+    const float v0Y[4] = {float(D.y - by), float(D.y - ay), float(D.y - ay), float(C.y - ay)};
+    const float v0Z[4] = {float(D.z - bz), float(D.z - az), float(D.z - az), float(C.z - az)};
+    const float v1X[4] = {float(C.x - bx), float(C.x - ax), float(B.x - ax), float(B.x - ax)};
+    const float v1Y[4] = {float(C.y - by), float(C.y - ay), float(B.y - ay), float(B.y - ay)};
+    const float v1Z[4] = {float(C.z - bz), float(C.z - az), float(B.z - az), float(B.z - az)};
+
+    const float linePoint_x = linePoint.x;
+    const float linePoint_y = linePoint.y;
+    const float linePoint_z = linePoint.z;
+    const float lineVect_x = lineVect.x;
+    const float lineVect_y = lineVect.y;
+    const float lineVect_z = lineVect.z;
+
+    float P_X[4];
+    float P_Y[4];
+    float P_Z[4];
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+    {
+        const __m128 base_x = _mm_loadu_ps(baseX);
+        const __m128 base_y = _mm_loadu_ps(baseY);
+        const __m128 base_z = _mm_loadu_ps(baseZ);
+        const __m128 v0_x = _mm_loadu_ps(v0X);
+        const __m128 v0_y = _mm_loadu_ps(v0Y);
+        const __m128 v0_z = _mm_loadu_ps(v0Z);
+        const __m128 v1_x = _mm_loadu_ps(v1X);
+        const __m128 v1_y = _mm_loadu_ps(v1Y);
+        const __m128 v1_z = _mm_loadu_ps(v1Z);
+        const __m128 lp_x = _mm_set1_ps(linePoint_x);
+        const __m128 lp_y = _mm_set1_ps(linePoint_y);
+        const __m128 lp_z = _mm_set1_ps(linePoint_z);
+        const __m128 lv_x = _mm_set1_ps(lineVect_x);
+        const __m128 lv_y = _mm_set1_ps(lineVect_y);
+        const __m128 lv_z = _mm_set1_ps(lineVect_z);
+
+        const __m128 n_x = _mm_sub_ps(_mm_mul_ps(v0_y, v1_z), _mm_mul_ps(v0_z, v1_y));
+        const __m128 n_y = _mm_sub_ps(_mm_mul_ps(v0_z, v1_x), _mm_mul_ps(v0_x, v1_z));
+        const __m128 n_z = _mm_sub_ps(_mm_mul_ps(v0_x, v1_y), _mm_mul_ps(v0_y, v1_x));
+
+        const __m128 baseDotN =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(base_x, n_x), _mm_mul_ps(base_y, n_y)), _mm_mul_ps(base_z, n_z));
+        const __m128 lpDotN =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(n_x, lp_x), _mm_mul_ps(n_y, lp_y)), _mm_mul_ps(n_z, lp_z));
+        const __m128 lvDotN =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(n_x, lv_x), _mm_mul_ps(n_y, lv_y)), _mm_mul_ps(n_z, lv_z));
+        const __m128 k = _mm_div_ps(_mm_sub_ps(baseDotN, lpDotN), lvDotN);
+
+        const __m128 P_x = _mm_add_ps(lp_x, _mm_mul_ps(lv_x, k));
+        const __m128 P_y = _mm_add_ps(lp_y, _mm_mul_ps(lv_y, k));
+        const __m128 P_z = _mm_add_ps(lp_z, _mm_mul_ps(lv_z, k));
+
+        const __m128 v2_x = _mm_sub_ps(P_x, base_x);
+        const __m128 v2_y = _mm_sub_ps(P_y, base_y);
+        const __m128 v2_z = _mm_sub_ps(P_z, base_z);
+
+        const __m128 dot00 =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(v0_x, v0_x), _mm_mul_ps(v0_y, v0_y)), _mm_mul_ps(v0_z, v0_z));
+        const __m128 dot01 =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(v0_x, v1_x), _mm_mul_ps(v0_y, v1_y)), _mm_mul_ps(v0_z, v1_z));
+        const __m128 dot02 =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(v0_x, v2_x), _mm_mul_ps(v0_y, v2_y)), _mm_mul_ps(v0_z, v2_z));
+        const __m128 dot11 =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(v1_x, v1_x), _mm_mul_ps(v1_y, v1_y)), _mm_mul_ps(v1_z, v1_z));
+        const __m128 dot12 =
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(v1_x, v2_x), _mm_mul_ps(v1_y, v2_y)), _mm_mul_ps(v1_z, v2_z));
+
+        const __m128 invDenom =
+            _mm_div_ps(_mm_set1_ps(1.0f), _mm_sub_ps(_mm_mul_ps(dot00, dot11), _mm_mul_ps(dot01, dot01)));
+        const __m128 u = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dot11, dot02), _mm_mul_ps(dot01, dot12)), invDenom);
+        const __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dot00, dot12), _mm_mul_ps(dot01, dot02)), invDenom);
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)),
+                                         _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+        const int insideMask = _mm_movemask_ps(inside);
+
+        _mm_storeu_ps(P_X, P_x);
+        _mm_storeu_ps(P_Y, P_y);
+        _mm_storeu_ps(P_Z, P_z);
+        for(int i = 0; i < 4; ++i)
+            out_hit[i] = ((insideMask >> i) & 1) != 0;
+    }
+#else
+    for(int i = 0; i < 4; ++i)
+    {
+        const float _n_x = v0Y[i] * v1Z[i] - v0Z[i] * v1Y[i];
+        const float _n_y = v0Z[i] * v1X[i] - v0X[i] * v1Z[i];
+        const float _n_z = v0X[i] * v1Y[i] - v0Y[i] * v1X[i];
+        const float k = ((baseX[i] * _n_x + baseY[i] * _n_y + baseZ[i] * _n_z) -
+                         (_n_x * linePoint_x + _n_y * linePoint_y + _n_z * linePoint_z)) /
+                        (_n_x * lineVect_x + _n_y * lineVect_y + _n_z * lineVect_z);
+        P_X[i] = linePoint_x + lineVect_x * k;
+        P_Y[i] = linePoint_y + lineVect_y * k;
+        P_Z[i] = linePoint_z + lineVect_z * k;
+        const float v2_x = P_X[i] - baseX[i];
+        const float v2_y = P_Y[i] - baseY[i];
+        const float v2_z = P_Z[i] - baseZ[i];
+        const float dot00 = (v0X[i] * v0X[i] + v0Y[i] * v0Y[i] + v0Z[i] * v0Z[i]);
+        const float dot01 = (v0X[i] * v1X[i] + v0Y[i] * v1Y[i] + v0Z[i] * v1Z[i]);
+        const float dot02 = (v0X[i] * v2_x + v0Y[i] * v2_y + v0Z[i] * v2_z);
+        const float dot11 = (v1X[i] * v1X[i] + v1Y[i] * v1Y[i] + v1Z[i] * v1Z[i]);
+        const float dot12 = (v1X[i] * v2_x + v1Y[i] * v2_y + v1Z[i] * v2_z);
+        const float invDenom = 1.0f / (dot00 * dot11 - dot01 * dot01);
+        const float u = (dot11 * dot02 - dot01 * dot12) * invDenom;
+        const float v = (dot00 * dot12 - dot01 * dot02) * invDenom;
+        out_hit[i] = (u >= 0.0f) && (v >= 0.0f) && (u + v <= 1.0f);
+    }
+#endif
+
+    for(int i = 0; i < 4; ++i)
+    {
+        out_lpi[i].x = P_X[i];
+        out_lpi[i].y = P_Y[i];
+        out_lpi[i].z = P_Z[i];
+    }
+}
+
 bool isLineSegmentInTriangle(Point3d& lpi, const Point3d& A, const Point3d& B, const Point3d& C,
                              const Point3d& linePoint1, const Point3d& linePoint2)
 {
@@ -144,6 +144,21 @@ Point2d getLineTriangleIntersectBarycCoords(Point3d* P, const Point3d* A, const
                                             const Point3d* linePoint, const Point3d* lineVect);
 bool isLineInTriangle(Point3d* P, const Point3d* A, const Point3d* B, const Point3d* C, const Point3d* linePoint,
                       const Point3d* lineVect);
+
+/**
+ * @brief Tests a line against the four facets of the tetrahedron (A, B, C, D) in one batch.
+ *
+ * Facet i is the triangle opposite to vertex i, with the same vertex ordering and the same
+ * arithmetic as isLineInTriangle on each facet. The four facets share their vertices and the
+ * line, so the batch is evaluated in SoA form (AVX2 when available) instead of four
+ * independent scalar calls.
+ *
+ * @param[out] out_lpi the four line/facet-plane intersection points
+ * @param[out] out_hit for each facet, true if the intersection falls inside the triangle
+ */
+void lineTetrahedronIntersections(Point3d out_lpi[4], bool out_hit[4], const Point3d& A, const Point3d& B,
+                                  const Point3d& C, const Point3d& D, const Point3d& linePoint,
+                                  const Point3d& lineVect);
 bool isLineSegmentInTriangle(Point3d& lpi, const Point3d& A, const Point3d& B, const Point3d& C,
                              const Point3d& linePoint1, const Point3d& linePoint2);
 
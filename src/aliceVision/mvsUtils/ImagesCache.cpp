@@ -5,9 +5,13 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ImagesCache.hpp"
+#include <aliceVision/imageIO/image.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/system/MemoryGovernor.hpp>
+#include <aliceVision/system/numa.hpp>
 
+#include <chrono>
 #include <future>
 
 namespace aliceVision {
@@ -37,9 +41,21 @@ ImagesCache::ImagesCache(const MultiViewParams* _mp, int _bandType, std::vector<
 
 void ImagesCache::initIC( std::vector<std::string>& _imagesNames )
 {
-    float oneimagemb = (sizeof(Color) * mp->getMaxImageWidth() * mp->getMaxImageHeight()) / 1024.f / 1024.f;
+    const std::size_t oneImageBytes = sizeof(Color) * mp->getMaxImageWidth() * mp->getMaxImageHeight();
+    float oneimagemb = oneImageBytes / 1024.f / 1024.f;
     float maxmbCPU = (float)mp->userParams.get<int>("images_cache.maxmbCPU", 5000);
-    int _npreload = std::max((int)(maxmbCPU / oneimagemb), mp->userParams.get<int>("grow.minNumOfConsistentCams", 10));
+    const int minPreload = mp->userParams.get<int>("grow.minNumOfConsistentCams", 10);
+    int _npreload = std::max((int)(maxmbCPU / oneimagemb), minPreload);
+
+    // register with the process-wide memory governor and cap the preload
+    // count to our share of the actual free RAM, instead of trusting the
+    // hand-tuned maxmbCPU value alone
+    _governorClientId = system::MemoryGovernor::get().registerClient(
+        "mvsUtils::ImagesCache", [this](std::size_t bytes) { return releaseUnusedImages(bytes); });
+    const std::size_t budget = system::MemoryGovernor::get().suggestedBudget(_governorClientId);
+    if(budget > 0)
+        _npreload = std::min(_npreload, std::max(minPreload, int(budget / oneImageBytes)));
+
     N_PRELOADED_IMAGES = std::min(mp->ncams, _npreload);
 
     for(int rc = 0; rc < mp->ncams; rc++)
@@ -49,59 +65,156 @@ void ImagesCache::initIC( std::vector<std::string>& _imagesNames )
 
     imgs.resize(N_PRELOADED_IMAGES); // = new Color*[N_PRELOADED_IMAGES];
 
-    camIdMapId.resize( mp->ncams, -1 );
-    mapIdCamId.resize( N_PRELOADED_IMAGES, -1 );
-    mapIdClock.resize( N_PRELOADED_IMAGES, clock() );
-
     {
-        // Cannot resize the vector<mutex> directly, as mutex class is not move-constructible.
-        // imagesMutexes.resize(mp->ncams); // cannot compile
-        // So, we do the same with a new vector and swap.
+        // Cannot resize vectors of atomics or mutexes directly, as those classes are
+        // not move-constructible. So, we do the same with a new vector and swap.
+        std::vector<std::atomic<int>> camIdMapIdTmp(mp->ncams);
+        camIdMapId.swap(camIdMapIdTmp);
+        std::vector<std::atomic<long>> mapIdClockTmp(N_PRELOADED_IMAGES);
+        mapIdClock.swap(mapIdClockTmp);
         std::vector<std::mutex> imagesMutexesTmp(mp->ncams);
         imagesMutexes.swap(imagesMutexesTmp);
     }
+    for(int camId = 0; camId < mp->ncams; ++camId)
+        camIdMapId[camId] = -1;
+    for(int mapId = 0; mapId < N_PRELOADED_IMAGES; ++mapId)
+        mapIdClock[mapId] = clock();
 
-
+    mapIdCamId.resize( N_PRELOADED_IMAGES, -1 );
 }
 
 ImagesCache::~ImagesCache()
 {
+    system::MemoryGovernor::get().unregisterClient(_governorClientId);
+}
+
+std::size_t ImagesCache::allocatedBytes() const
+{
+    const std::size_t oneImageBytes = sizeof(Color) * mp->getMaxImageWidth() * mp->getMaxImageHeight();
+    std::size_t bytes = 0;
+    for(const ImgPtr& img : imgs)
+        if(img != nullptr)
+            bytes += oneImageBytes;
+    return bytes;
+}
+
+std::size_t ImagesCache::releaseUnusedImages(std::size_t bytes)
+{
+    const std::size_t oneImageBytes = sizeof(Color) * mp->getMaxImageWidth() * mp->getMaxImageHeight();
+    std::size_t released = 0;
+
+    std::lock_guard<std::mutex> mapLock(_mapMutex);
+    while(released < bytes)
+    {
+        // drop the least recently used slot no caller still references
+        int mapId = -1;
+        for(int i = 0; i < N_PRELOADED_IMAGES; ++i)
+        {
+            if((imgs[i] == nullptr) || (imgs[i].use_count() > 1))
+                continue;
+            if((mapId == -1) || (mapIdClock[i] < mapIdClock[mapId]))
+                mapId = i;
+        }
+        if(mapId == -1)
+            break; // every remaining slot is empty or referenced
+
+        const int camId = mapIdCamId[mapId];
+        if(camId >= 0)
+            camIdMapId[camId] = -1;
+        mapIdCamId[mapId] = -1;
+        imgs[mapId].reset();
+        released += oneImageBytes;
+    }
+
+    if(released > 0)
+    {
+        ALICEVISION_LOG_DEBUG("Image cache released " << (released / (1024 * 1024)) << " MB under memory pressure.");
+        system::MemoryGovernor::get().reportUsage(_governorClientId, allocatedBytes());
+    }
+    return released;
 }
 
 void ImagesCache::refreshData(int camId)
 {
+    // lock-free hit: the image is already in the cache
+    {
+        const int mapId = camIdMapId[camId].load();
+        if(mapId != -1)
+        {
+            mapIdClock[mapId] = clock(); // touch for LRU
+            return;
+        }
+    }
+
+    // per-camera mutex: concurrent misses on different cameras load in parallel
     std::lock_guard<std::mutex> lock(imagesMutexes[camId]);
 
-    // printf("camId %i\n",camId);
-    // test if the image is in the memory
-    if(camIdMapId[camId] == -1)
+    // test again, a concurrent caller may have loaded the image meanwhile
+    if(camIdMapId[camId].load() != -1)
+        return;
+
+    int mapId;
     {
-        // remove the oldest one
-        int mapId = mapIdClock.minValId();
-        int oldCamId = mapIdCamId[mapId];
+        std::lock_guard<std::mutex> mapLock(_mapMutex);
+
+        // evict the least recently used slot, preferring slots no caller still references
+        mapId = -1;
+        long oldestClock = 0;
+        for(int i = 0; i < N_PRELOADED_IMAGES; ++i)
+        {
+            if((imgs[i] != nullptr) && (imgs[i].use_count() > 1))
+                continue; // a caller still holds this image
+            if((mapId == -1) || (mapIdClock[i] < oldestClock))
+            {
+                mapId = i;
+                oldestClock = mapIdClock[i];
+            }
+        }
+        if(mapId == -1)
+        {
+            // every slot is referenced, fall back to the least recently used one
+            mapId = 0;
+            for(int i = 1; i < N_PRELOADED_IMAGES; ++i)
+                if(mapIdClock[i] < mapIdClock[mapId])
+                    mapId = i;
+        }
+
+        const int oldCamId = mapIdCamId[mapId];
         if(oldCamId>=0)
             camIdMapId[oldCamId] = -1;
 
-        // replace with new new
-        camIdMapId[camId] = mapId;
+        // reserve the slot, the fresh clock keeps concurrent misses away from it
         mapIdCamId[mapId] = camId;
         mapIdClock[mapId] = clock();
+    }
 
-        // reload data from files
-        long t1 = clock();
-        if (imgs[mapId] == nullptr)
-        {
-            const std::size_t maxSize = mp->getMaxImageWidth() * mp->getMaxImageHeight();
-            imgs[mapId] = std::make_shared<Img>( maxSize );
-        }
-
-        const std::string imagePath = imagesNames.at(camId);
-        memcpyRGBImageFromFileToArr(camId, imgs[mapId]->data, imagePath, mp, bandType);
-        imgs[mapId]->setWidth(  mp->getWidth(camId) );
-        imgs[mapId]->setHeight( mp->getHeight(camId) );
+    // reload data from files, outside of the bookkeeping lock
+    long t1 = clock();
+    if (imgs[mapId] == nullptr || imgs[mapId].use_count() > 1)
+    {
+        // allocate a fresh buffer instead of overwriting one still in use;
+        // under memory pressure the governor first asks the other caches of
+        // the process to shrink
+        const std::size_t maxSize = mp->getMaxImageWidth() * mp->getMaxImageHeight();
+        system::MemoryGovernor::get().requestAllocation(_governorClientId, maxSize * sizeof(Color));
+        imgs[mapId] = std::make_shared<Img>( maxSize );
+        system::MemoryGovernor::get().reportUsage(_governorClientId, allocatedBytes());
 
-        ALICEVISION_LOG_DEBUG("Add " << imagePath << " to image cache. " << formatElapsedTime(t1));
+        // cached frames are read by workers on every socket: interleave the
+        // pages so no NUMA node pays all the remote accesses
+        if(mp->userParams.get<bool>("images_cache.numaInterleave", true))
+            system::numa::interleaveMemory(imgs[mapId]->data, maxSize * sizeof(Color));
     }
+
+    const std::string imagePath = imagesNames.at(camId);
+    memcpyRGBImageFromFileToArr(camId, imgs[mapId]->data, imagePath, mp, bandType);
+    imgs[mapId]->setWidth(  mp->getWidth(camId) );
+    imgs[mapId]->setHeight( mp->getHeight(camId) );
+
+    // publish last, so that lock-free readers only ever see a fully loaded slot
+    camIdMapId[camId] = mapId;
+
+    ALICEVISION_LOG_DEBUG("Add " << imagePath << " to image cache. " << formatElapsedTime(t1));
 }
 
 std::future<void> ImagesCache::refreshData_async(int camId)
@@ -109,12 +222,85 @@ std::future<void> ImagesCache::refreshData_async(int camId)
     return std::async(&ImagesCache::refreshData, this, camId);
 }
 
+void ImagesCache::prefetchImages(const StaticVector<int>& camIds)
+{
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+
+    // drop the finished requests
+    for(std::size_t i = 0; i < _prefetchFutures.size();)
+    {
+        if(_prefetchFutures[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            _prefetchFutures[i] = std::move(_prefetchFutures.back());
+            _prefetchFutures.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    for(int i = 0; i < camIds.size(); ++i)
+    {
+        const int camId = camIds[i];
+        if(camIdMapId[camId].load() != -1)
+            continue; // already cached
+        _prefetchFutures.push_back(refreshData_async(camId));
+    }
+}
+
+void ImagesCache::getImageWindow(int camId, int xBegin, int yBegin, int winWidth, int winHeight,
+                                 std::vector<Color>& buffer)
+{
+    // the gaussian bands need the whole frame as context, a windowed decode cannot reproduce them
+    if(bandType != 0)
+        refreshData(camId);
+
+    // serve from the cache when the full frame is already loaded
+    const int mapId = camIdMapId[camId].load();
+    if(mapId != -1)
+    {
+        mapIdClock[mapId] = clock(); // touch for LRU
+        const ImgPtr img = imgs[mapId]; // hold a reference so that the slot cannot be evicted
+        buffer.resize(winWidth * winHeight);
+        for(int y = 0; y < winHeight; ++y)
+            for(int x = 0; x < winWidth; ++x)
+                buffer.at(y * winWidth + x) = img->at(xBegin + x, yBegin + y);
+        return;
+    }
+
+    // miss: decode only the requested rectangle, without evicting a cached frame
+    const std::string imagePath = imagesNames.at(camId);
+    const int processScale = mp->getProcessDownscale();
+    if(processScale == 1)
+    {
+        imageIO::readImageWindow(imagePath, xBegin, yBegin, winWidth, winHeight, buffer);
+    }
+    else
+    {
+        // prefer the pyramid sidecar at the process scale: the rectangle can be
+        // decoded directly instead of reading a scaled-up window and resizing it
+        const std::string downscaledPath = getDownscaledImagePath(imagePath, processScale);
+        if(FileExists(downscaledPath))
+        {
+            imageIO::readImageWindow(downscaledPath, xBegin, yBegin, winWidth, winHeight, buffer);
+        }
+        else
+        {
+            std::vector<Color> origWindow;
+            imageIO::readImageWindow(imagePath, xBegin * processScale, yBegin * processScale,
+                                     winWidth * processScale, winHeight * processScale, origWindow);
+            imageIO::resizeImage(winWidth * processScale, winHeight * processScale, processScale, origWindow, buffer);
+        }
+    }
+}
+
 Color ImagesCache::getPixelValueInterpolated(const Point2d* pix, int camId)
 {
     refreshData(camId);
 
     // get the image index in the memory
-    const int i = camIdMapId[camId];
+    const int i = camIdMapId[camId].load();
     const ImgPtr& img = imgs[i];
     
     const int xp = static_cast<int>(pix->x);
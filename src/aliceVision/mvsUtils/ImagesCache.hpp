@@ -12,6 +12,7 @@
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 
+#include <atomic>
 #include <future>
 #include <mutex>
 
@@ -68,13 +69,19 @@ private:
     int N_PRELOADED_IMAGES;
     std::vector<ImgPtr> imgs;
 
-    std::vector<int> camIdMapId;
-    std::vector<int> mapIdCamId;
-    StaticVector<long> mapIdClock;
+    std::vector<std::atomic<int>> camIdMapId; //< -1 or the imgs slot of the camera, published last on load
+    std::vector<int> mapIdCamId;              //< guarded by _mapMutex
+    std::vector<std::atomic<long>> mapIdClock; //< last-use time of every slot, for LRU eviction
 
+    std::mutex _mapMutex; //< guards slot assignment and eviction
     std::vector<std::mutex> imagesMutexes;
     std::vector<std::string> imagesNames;
 
+    std::mutex _prefetchMutex;
+    std::vector<std::future<void>> _prefetchFutures;
+
+    std::size_t _governorClientId; //< registration with the process-wide memory governor
+
     const int  bandType;
 public:
     const bool transposed;
@@ -88,15 +95,43 @@ public:
     ~ImagesCache();
 
     inline ImgPtr getImg( int camId ) {
-        refreshData(camId);
-        const int imageId = camIdMapId[camId];
+        int imageId = camIdMapId[camId].load();
+        while(imageId == -1)
+        {
+            refreshData(camId);
+            imageId = camIdMapId[camId].load();
+        }
         return imgs[imageId];
     }
 
     void refreshData(int camId);
     std::future<void> refreshData_async(int camId);
 
+    /// announce cameras that are about to be requested, missing ones are loaded in the background
+    void prefetchImages(const StaticVector<int>& camIds);
+
+    /**
+     * @brief Get a rectangular window of an image, in process-scale coordinates.
+     *
+     * If the full frame is already cached the window is copied from it, otherwise only
+     * the requested rectangle is decoded from the file, without evicting a cached frame.
+     * The buffer is filled row by row, y-major.
+     */
+    void getImageWindow(int camId, int xBegin, int yBegin, int winWidth, int winHeight, std::vector<Color>& buffer);
+
     Color getPixelValueInterpolated(const Point2d* pix, int camId);
+
+private:
+    /**
+     * @brief Eviction pressure callback of the memory governor: drop cached
+     * frames no caller still references, least recently used first, until
+     * about \p bytes are released.
+     * @return the number of bytes actually released
+     */
+    std::size_t releaseUnusedImages(std::size_t bytes);
+
+    /// number of bytes currently held by the image slots, reported to the governor
+    std::size_t allocatedBytes() const;
 };
 
 } // namespace mvsUtils
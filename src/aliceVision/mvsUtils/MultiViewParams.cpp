@@ -10,6 +10,7 @@
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/Matrix3x4.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
+#include <aliceVision/mvsUtils/cameraTable.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/imageIO/image.hpp>
@@ -100,77 +101,107 @@ MultiViewParams::MultiViewParams(const sfmData::SfMData& sfmData,
     // Resize internal structures
     resizeCams(getNbCameras());
 
+    // consolidated binary camera table written by prepareDenseScene: all the
+    // camera parameters come from a single memory-mapped file instead of
+    // opening every image to probe its metadata
+    std::map<IndexT, CameraTableEntry> cameraTable;
+    if(cameras == nullptr && !readFromDepthMaps && _imagesFolder != "/" && !_imagesFolder.empty())
+    {
+        if(loadCameraTable(_imagesFolder, cameraTable))
+            ALICEVISION_LOG_INFO("Camera parameters read from the consolidated camera table ("
+                                 << cameraTable.size() << " cameras).");
+    }
+
     for(int i = 0; i < getNbCameras(); ++i)
     {
         const ImageParams& imgParams = _imagesParams.at(i);
 
-        oiio::ParamValueList metadata;
-        imageIO::readImageMetadata(imgParams.path, metadata);
-
-        const auto scaleIt = metadata.find("AliceVision:downscale");
-        const auto pIt = metadata.find("AliceVision:P");
+        std::map<IndexT, CameraTableEntry>::const_iterator tableIt = cameraTable.find(getViewId(i));
+        if(tableIt != cameraTable.end() &&
+           (tableIt->second.width != imgParams.width || tableIt->second.height != imgParams.height))
+        {
+            ALICEVISION_LOG_WARNING("Camera table entry of view " << getViewId(i)
+                                    << " does not match the image dimensions, ignoring it.");
+            tableIt = cameraTable.end();
+        }
 
-        // find image scale information
-        if(scaleIt != metadata.end() && scaleIt->type() == oiio::TypeDesc::INT)
+        if(tableIt != cameraTable.end())
         {
-            // use aliceVision image metadata
-            _imagesScale.at(i) = scaleIt->get_int();
+            const CameraTableEntry& entry = tableIt->second;
+            _imagesScale.at(i) = entry.downscale;
+            FocK1K2Arr.at(i) = Point3d(entry.focal, entry.k1, entry.k2);
+            loadMatricesFromRawProjectionMatrix(i, entry.P);
         }
         else
         {
-            // use image dimension
-            int w, h, channels;
-            imageIO::readImageSpec(imgParams.path, w, h, channels);
-            const int widthScale = imgParams.width / w;
-            const int heightScale = imgParams.height / h;
+            oiio::ParamValueList metadata;
+            imageIO::readImageMetadata(imgParams.path, metadata);
+
+            const auto scaleIt = metadata.find("AliceVision:downscale");
+            const auto pIt = metadata.find("AliceVision:P");
 
-            if((widthScale != 1) && (heightScale != 1))
-                ALICEVISION_LOG_INFO("Reading '" << imgParams.path << "' x" << widthScale << "downscale from file dimension" << std::endl
-                                                 << "\t- No 'AliceVision:downscale' metadata found.");
+            // find image scale information
+            if(scaleIt != metadata.end() && scaleIt->type() == oiio::TypeDesc::INT)
+            {
+                // use aliceVision image metadata
+                _imagesScale.at(i) = scaleIt->get_int();
+            }
+            else
+            {
+                // use image dimension
+                int w, h, channels;
+                imageIO::readImageSpec(imgParams.path, w, h, channels);
+                const int widthScale = imgParams.width / w;
+                const int heightScale = imgParams.height / h;
 
-            if(widthScale != heightScale)
-                throw std::runtime_error("Scale of file: '" + imgParams.path + "' is not uniform, check image dimension ratio.");
+                if((widthScale != 1) && (heightScale != 1))
+                    ALICEVISION_LOG_INFO("Reading '" << imgParams.path << "' x" << widthScale << "downscale from file dimension" << std::endl
+                                                     << "\t- No 'AliceVision:downscale' metadata found.");
 
-            _imagesScale.at(i) = widthScale;
-        }
+                if(widthScale != heightScale)
+                    throw std::runtime_error("Scale of file: '" + imgParams.path + "' is not uniform, check image dimension ratio.");
 
-        FocK1K2Arr.at(i) = Point3d(-1.0, -1.0, -1.0);
+                _imagesScale.at(i) = widthScale;
+            }
 
-        // load camera matrices
-        if(cameras != nullptr)
-        {
-            // use constructor cameras input parameter
-            camArr.at(i) = (*cameras)[i].P;
-            KArr.at(i) = (*cameras)[i].K;
-            RArr.at(i) = (*cameras)[i].R;
-            CArr.at(i) = (*cameras)[i].C;
-            iKArr.at(i) = (*cameras)[i].iK;
-            iRArr.at(i) = (*cameras)[i].iR;
-            iCamArr.at(i) = (*cameras)[i].iCam;
-            FocK1K2Arr.at(i) = Point3d((*cameras)[i].f, (*cameras)[i].k1, (*cameras)[i].k2);
-        }
-        else if(pIt != metadata.end() && pIt->type() == oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44))
-        {
-            ALICEVISION_LOG_DEBUG("Reading view " << getViewId(i) << " projection matrix from image metadata.");
-            loadMatricesFromRawProjectionMatrix(i, static_cast<const double*>(pIt->data()));
-        }
-        else
-        {
-            // use P matrix file
-            const std::string fileNameP = getFileNameFromIndex(this, i, EFileType::P);
-            const std::string fileNameD = getFileNameFromIndex(this, i, EFileType::D);
+            FocK1K2Arr.at(i) = Point3d(-1.0, -1.0, -1.0);
 
-            if(fs::exists(fileNameP), fs::exists(fileNameD))
+            // load camera matrices
+            if(cameras != nullptr)
             {
-              ALICEVISION_LOG_DEBUG("Reading view " << getViewId(i) << " projection matrix from file '" << fileNameP << "'.");
-
-              loadMatricesFromTxtFile(i, fileNameP, fileNameD);
+                // use constructor cameras input parameter
+                camArr.at(i) = (*cameras)[i].P;
+                KArr.at(i) = (*cameras)[i].K;
+                RArr.at(i) = (*cameras)[i].R;
+                CArr.at(i) = (*cameras)[i].C;
+                iKArr.at(i) = (*cameras)[i].iK;
+                iRArr.at(i) = (*cameras)[i].iR;
+                iCamArr.at(i) = (*cameras)[i].iCam;
+                FocK1K2Arr.at(i) = Point3d((*cameras)[i].f, (*cameras)[i].k1, (*cameras)[i].k2);
             }
-            else
+            else if(pIt != metadata.end() && pIt->type() == oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44))
             {
-              ALICEVISION_LOG_DEBUG("Reading view " << getViewId(i) << " projection matrix from SfMData.");
-              loadMatricesFromSfM(i);
+                ALICEVISION_LOG_DEBUG("Reading view " << getViewId(i) << " projection matrix from image metadata.");
+                loadMatricesFromRawProjectionMatrix(i, static_cast<const double*>(pIt->data()));
             }
+            else
+            {
+                // use P matrix file
+                const std::string fileNameP = getFileNameFromIndex(this, i, EFileType::P);
+                const std::string fileNameD = getFileNameFromIndex(this, i, EFileType::D);
+
+                if(fs::exists(fileNameP), fs::exists(fileNameD))
+                {
+                  ALICEVISION_LOG_DEBUG("Reading view " << getViewId(i) << " projection matrix from file '" << fileNameP << "'.");
+
+                  loadMatricesFromTxtFile(i, fileNameP, fileNameD);
+                }
+                else
+                {
+                  ALICEVISION_LOG_DEBUG("Reading view " << getViewId(i) << " projection matrix from SfMData.");
+                  loadMatricesFromSfM(i);
+                }
+        }
         }
 
         if(KArr[i].m11 > (float)(getWidth(i) * 100))
@@ -301,7 +332,10 @@ void MultiViewParams::loadMatricesFromSfM(int index)
 }
 
 MultiViewParams::~MultiViewParams()
-{}
+{
+    if(_nbSharedLandmarksPerCamPair != nullptr)
+        deleteArrayOfArrays<int>(&_nbSharedLandmarksPerCamPair);
+}
 
 const std::map<std::string, std::string>& MultiViewParams::getMetadata(int index) const
 {
@@ -316,6 +350,28 @@ bool MultiViewParams::is3DPointInFrontOfCam(const Point3d* X, int rc) const
 }
 
 void MultiViewParams::getMinMaxMidNbDepth(int index, float& min, float& max, float& mid, std::size_t& nbDepths, float percentile) const
+{
+  // the computation scans every landmark of the scene and both the SGM and the
+  // refine stages query it for each reference camera, so cache the statistics
+  const std::pair<int, float> key(index, percentile);
+
+#pragma omp critical(depthStatsPerCam)
+  {
+    std::map<std::pair<int, float>, CameraDepthStats>::const_iterator it = _depthStatsPerCam.find(key);
+    if(it == _depthStatsPerCam.end())
+    {
+      CameraDepthStats stats;
+      computeMinMaxMidNbDepth(index, stats.min, stats.max, stats.mid, stats.nbDepths, percentile);
+      it = _depthStatsPerCam.emplace(key, stats).first;
+    }
+    min = it->second.min;
+    max = it->second.max;
+    mid = it->second.mid;
+    nbDepths = it->second.nbDepths;
+  }
+}
+
+void MultiViewParams::computeMinMaxMidNbDepth(int index, float& min, float& max, float& mid, std::size_t& nbDepths, float percentile) const
 {
   using namespace boost::accumulators;
 
@@ -537,50 +593,128 @@ void MultiViewParams::decomposeProjectionMatrix(Point3d& Co, Matrix3x3& Ro, Matr
 }
 
 
-StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNearestCams) const
+const StaticVector<int>* MultiViewParams::getNbSharedLandmarksPerTc(int rc) const
 {
-  StaticVector<int> out;
-  std::vector<SortedId> ids;
-  ids.reserve(getNbCameras());
+    // lazy initialization, guarded as some stages query their target cameras
+    // from inside parallel loops
+    #pragma omp critical(nbSharedLandmarksPerCamPair)
+    {
+        if(_nbSharedLandmarksPerCamPair == nullptr)
+            computeNbSharedLandmarksPerCamPair();
+    }
+    return (*_nbSharedLandmarksPerCamPair)[rc];
+}
 
-  for(int tc = 0; tc < getNbCameras(); ++tc)
-    ids.push_back(SortedId(tc,0));
+void MultiViewParams::computeNbSharedLandmarksPerCamPair() const
+{
+    const std::string cacheFilepath = _imagesFolder.empty() ? "" : _imagesFolder + "sharedLandmarksPerCamPair.bin";
 
-  const IndexT viewId = getViewId(rc);
-  const sfmData::View& view = *(_sfmData.getViews().at(viewId));
-  const geometry::Pose3 pose = _sfmData.getPose(view).getTransform();
-  const camera::IntrinsicBase* intrinsicPtr = _sfmData.getIntrinsicPtr(view.getIntrinsicId());
+    if(!cacheFilepath.empty() && FileExists(cacheFilepath))
+    {
+        _nbSharedLandmarksPerCamPair = loadArrayOfArraysFromFile<int>(cacheFilepath);
+        if(_nbSharedLandmarksPerCamPair->size() == ncams)
+            return;
+        // stale cache computed from another set of cameras, recompute it
+        ALICEVISION_LOG_WARNING("Camera pairs cache '" << cacheFilepath << "' does not match the scene, recomputing it.");
+        deleteArrayOfArrays<int>(&_nbSharedLandmarksPerCamPair);
+    }
 
-  for(const auto& landmarkPair :_sfmData.getLandmarks())
-  {
-    const auto& observations = landmarkPair.second.observations;
+    ALICEVISION_LOG_INFO("Computing the shared landmarks of all camera pairs.");
+    long t1 = clock();
 
-    auto viewObsIt = observations.find(viewId);
-    if(viewObsIt == observations.end())
-      continue;
+    // per camera data needed to compute the observation rays
+    std::vector<Mat3> camRotationsT(ncams);
+    std::vector<const camera::IntrinsicBase*> camIntrinsics(ncams);
+    for(int c = 0; c < ncams; ++c)
+    {
+        const sfmData::View& view = *(_sfmData.getViews().at(getViewId(c)));
+        camRotationsT[c] = _sfmData.getPose(view).getTransform().rotation().transpose();
+        camIntrinsics[c] = _sfmData.getIntrinsicPtr(view.getIntrinsicId());
+    }
+
+    // count the landmarks seen by both cameras of every pair within the view
+    // angle limits, in a single pass over the landmarks
+    std::vector<std::map<int, int>> countsPerCam(ncams);
+    std::vector<int> cams;
+    std::vector<Vec3> rays;
 
-    for(const auto& observationPair : observations)
+    for(const auto& landmarkPair : _sfmData.getLandmarks())
     {
-      const IndexT otherViewId = observationPair.first;
+      const auto& observations = landmarkPair.second.observations;
 
-      if(otherViewId == viewId)
-       continue;
+      if(observations.size() < 2)
+        continue;
 
-      const sfmData::View& otherView = *(_sfmData.getViews().at(otherViewId));
-      const geometry::Pose3 otherPose = _sfmData.getPose(otherView).getTransform();
-      const camera::IntrinsicBase* otherIntrinsicPtr = _sfmData.getIntrinsicPtr(otherView.getIntrinsicId());
+      cams.clear();
+      rays.clear();
 
-      const double angle = camera::AngleBetweenRays(pose, intrinsicPtr, otherPose, otherIntrinsicPtr, viewObsIt->second.x, observationPair.second.x);
+      for(const auto& observationPair : observations)
+      {
+        const auto it = _imageIdsPerViewId.find(observationPair.first);
+        if(it == _imageIdsPerViewId.end())
+          continue;
 
-      if(angle < _minViewAngle || angle > _maxViewAngle)
-        continue;
+        const int c = it->second;
+        cams.push_back(c);
+        rays.push_back((camRotationsT[c] * (*camIntrinsics[c])(observationPair.second.x)).normalized());
+      }
+
+      for(std::size_t i = 0; i < cams.size(); ++i)
+      {
+        for(std::size_t j = i + 1; j < cams.size(); ++j)
+        {
+          const double angle = camera::AngleBetweenRays(rays[i], rays[j]);
+
+          if(angle < _minViewAngle || angle > _maxViewAngle)
+            continue;
+
+          ++countsPerCam[cams[i]][cams[j]];
+          ++countsPerCam[cams[j]][cams[i]];
+        }
+      }
+    }
+
+    _nbSharedLandmarksPerCamPair = new StaticVector<StaticVector<int>*>();
+    _nbSharedLandmarksPerCamPair->reserve(ncams);
 
-      const int tc = getIndexFromViewId(otherViewId);
-      ++ids.at(tc).value;
+    for(int c = 0; c < ncams; ++c)
+    {
+        StaticVector<int>* row = nullptr;
+        if(!countsPerCam[c].empty())
+        {
+            row = new StaticVector<int>();
+            row->reserve(countsPerCam[c].size() * 2);
+            for(const auto& tcCount : countsPerCam[c])
+            {
+                row->push_back(tcCount.first);
+                row->push_back(tcCount.second);
+            }
+        }
+        _nbSharedLandmarksPerCamPair->push_back(row);
     }
+
+    printfElapsedTime(t1);
+
+    if(!cacheFilepath.empty())
+        saveArrayOfArraysToFile<int>(cacheFilepath, _nbSharedLandmarksPerCamPair);
+}
+
+StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNearestCams) const
+{
+  StaticVector<int> out;
+  const StaticVector<int>* tcCounts = getNbSharedLandmarksPerTc(rc);
+
+  std::vector<SortedId> ids;
+
+  if(tcCounts != nullptr)
+  {
+    ids.reserve(tcCounts->size() / 2);
+    for(int i = 0; i < tcCounts->size(); i += 2)
+      ids.push_back(SortedId((*tcCounts)[i], (*tcCounts)[i + 1]));
   }
 
-  qsort(&ids[0], ids.size(), sizeof(SortedId), qsortCompareSortedIdDesc);
+  if(!ids.empty())
+    qsort(&ids[0], ids.size(), sizeof(SortedId), qsortCompareSortedIdDesc);
 
   // ensure the ideal number of target cameras is not superior to the actual number of cameras
   const int maxTc = std::min(std::min(getNbCameras(), nbNearestCams), static_cast<int>(ids.size()));
@@ -274,6 +274,21 @@ public:
      */
     StaticVector<int> findNearestCamsFromLandmarks(int rc, int nbNearestCams) const;
 
+    /**
+     * @brief Get the number of landmarks seen by both the given camera and each
+     *        target camera within the view angle limits.
+     *
+     * The counts of all camera pairs are computed in a single pass over the
+     * landmarks the first time they are needed and persisted next to the
+     * undistorted images, so the depth-map and fusion stages of later binaries
+     * only pay a file load instead of a per-camera scan of the landmarks.
+     *
+     * @param rc the reference camera
+     * @return interleaved (target camera, count) pairs with non-zero counts,
+     *         nullptr when the camera shares no landmark
+     */
+    const StaticVector<int>* getNbSharedLandmarksPerTc(int rc) const;
+
 
     inline void setMinViewAngle(float minViewAngle)
     {
@@ -310,7 +325,23 @@ private:
     float _maxViewAngle = 70.0f;  // WARNING: may be too low, especially when using seeds from SfM
     /// input sfmData
     const sfmData::SfMData& _sfmData;
+    /// number of landmarks seen by both cameras within the view angle limits,
+    /// one row of interleaved (tc, count) pairs per camera, lazily computed,
+    /// see getNbSharedLandmarksPerTc()
+    mutable StaticVector<StaticVector<int>*>* _nbSharedLandmarksPerCamPair = nullptr;
 
+    /// observed depth statistics of one camera, see getMinMaxMidNbDepth()
+    struct CameraDepthStats
+    {
+        float min, max, mid;
+        std::size_t nbDepths;
+    };
+    /// depth statistics per (camera, percentile), lazily computed from the
+    /// landmarks and shared by all the stages that query the same camera
+    mutable std::map<std::pair<int, float>, CameraDepthStats> _depthStatsPerCam;
+
+    void computeNbSharedLandmarksPerCamPair() const;
+    void computeMinMaxMidNbDepth(int index, float& min, float& max, float& mid, std::size_t& nbDepths, float percentile) const;
     void loadMatricesFromTxtFile(int index, const std::string& fileNameP, const std::string& fileNameD);
     void loadMatricesFromRawProjectionMatrix(int index, const double* rawProjMatix);
     void loadMatricesFromSfM(int index);
@@ -0,0 +1,98 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "cameraTable.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+namespace fs = boost::filesystem;
+
+static const std::int32_t cameraTableMarker = 0x54434156; // "AVCT"
+static const std::int32_t cameraTableVersion = 1;
+
+// the records are mapped straight out of the file
+static_assert(sizeof(CameraTableEntry) == 4 * 4 + 15 * 8, "CameraTableEntry must have no padding");
+
+std::string getCameraTableFilepath(const std::string& folder)
+{
+    return (fs::path(folder) / "cameras.bin").string();
+}
+
+void saveCameraTable(const std::string& folder, const std::vector<CameraTableEntry>& entries)
+{
+    const std::string filepath = getCameraTableFilepath(folder);
+
+    std::ofstream file(filepath, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("saveCameraTable: can't create file: " + filepath);
+
+    const std::int32_t header[4] = {cameraTableMarker, cameraTableVersion,
+                                    static_cast<std::int32_t>(entries.size()), 0};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(CameraTableEntry));
+
+    if(!file)
+        throw std::runtime_error("saveCameraTable: can't write file: " + filepath);
+}
+
+bool loadCameraTable(const std::string& folder, std::map<IndexT, CameraTableEntry>& entries)
+{
+    const std::string filepath = getCameraTableFilepath(folder);
+
+    if(!fs::exists(filepath))
+        return false;
+
+    boost::iostreams::mapped_file_source file;
+    try
+    {
+        file.open(filepath);
+    }
+    catch(const std::exception&)
+    {
+        ALICEVISION_LOG_WARNING("loadCameraTable: can't map file: " << filepath);
+        return false;
+    }
+
+    std::int32_t header[4];
+    if(!file.is_open() || file.size() < sizeof(header))
+    {
+        ALICEVISION_LOG_WARNING("loadCameraTable: truncated header: " << filepath);
+        return false;
+    }
+    std::memcpy(header, file.data(), sizeof(header));
+
+    if(header[0] != cameraTableMarker || header[1] != cameraTableVersion)
+    {
+        ALICEVISION_LOG_WARNING("loadCameraTable: unsupported file format: " << filepath);
+        return false;
+    }
+
+    const std::int32_t nbCameras = header[2];
+    if(nbCameras < 0 || file.size() < sizeof(header) + nbCameras * sizeof(CameraTableEntry))
+    {
+        ALICEVISION_LOG_WARNING("loadCameraTable: truncated payload: " << filepath);
+        return false;
+    }
+
+    const CameraTableEntry* records = reinterpret_cast<const CameraTableEntry*>(file.data() + sizeof(header));
+    for(std::int32_t i = 0; i < nbCameras; ++i)
+        entries[records[i].viewId] = records[i];
+
+    return true;
+}
+
+} // namespace mvsUtils
+} // namespace aliceVision
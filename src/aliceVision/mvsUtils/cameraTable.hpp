@@ -0,0 +1,58 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+/**
+ * @brief One fixed-size record of the consolidated binary camera table.
+ *
+ * The table is written once by prepareDenseScene next to the undistorted
+ * images and replaces the per-camera projection matrix files and metadata
+ * probing: MultiViewParams reads all the camera parameters of a scene from a
+ * single memory-mapped file instead of opening one file per camera.
+ */
+struct CameraTableEntry
+{
+    IndexT viewId;
+    std::int32_t width;     //< full resolution image width
+    std::int32_t height;    //< full resolution image height
+    std::int32_t downscale; //< downscale of the written images
+    double P[12];           //< row major 3x4 projection matrix at scale 1
+    double focal;           //< -1 when unknown, same convention as the D files
+    double k1;
+    double k2;
+};
+
+/// path of the camera table inside a dense scene folder
+std::string getCameraTableFilepath(const std::string& folder);
+
+/**
+ * @brief Write the consolidated camera table of a dense scene folder.
+ * @param[in] folder The dense scene folder
+ * @param[in] entries The camera records
+ */
+void saveCameraTable(const std::string& folder, const std::vector<CameraTableEntry>& entries);
+
+/**
+ * @brief Memory-map the consolidated camera table of a dense scene folder if it exists.
+ * @param[in] folder The dense scene folder
+ * @param[out] entries The camera records per view id
+ * @return false when the folder has no table or the table is malformed
+ */
+bool loadCameraTable(const std::string& folder, std::map<IndexT, CameraTableEntry>& entries);
+
+} // namespace mvsUtils
+} // namespace aliceVision
@@ -287,6 +287,12 @@ std::string getFileNameFromIndex(const MultiViewParams* mp, int index, EFileType
     return getFileNameFromViewId(mp, mp->getViewId(index), mv_file_type, scale);
 }
 
+std::string getDownscaledImagePath(const std::string& imagePath, int downscale)
+{
+    const boost::filesystem::path path(imagePath);
+    return (path.parent_path() / (path.stem().string() + "_d" + std::to_string(downscale) + path.extension().string())).string();
+}
+
 FILE* mv_openFile(const MultiViewParams* mp, int index, EFileType mv_file_type, const char* readWrite)
 {
     const std::string fileName = getFileNameFromIndex(mp, index, mv_file_type);
@@ -324,32 +330,56 @@ Matrix3x4 load3x4MatrixFromFile(FILE* fi)
 
 void memcpyRGBImageFromFileToArr(int camId, Color* imgArr, const std::string& fileNameOrigStr, const MultiViewParams* mp, int bandType)
 {
+    if((mp->getProcessDownscale() == 1) && (bandType == 0))
+    {
+        // common case: no rescale and no band filtering, stream the decoded rows
+        // straight into the transposed destination instead of holding a second
+        // full-frame copy in memory
+        imageIO::readImageTransposed(fileNameOrigStr, mp->getOriginalWidth(camId), mp->getOriginalHeight(camId),
+                                     imgArr);
+        return;
+    }
+
+    // scale choosed by the user and apply during the process
+    const int processScale = mp->getProcessDownscale();
+    const int width = mp->getWidth(camId);
+    const int height = mp->getHeight(camId);
+
+    // pyramid sidecar written by prepareDenseScene (--savePyramidLevels): the
+    // frame at the process scale already exists on disk, so neither the
+    // full-resolution decode nor the downscale has to be redone
+    const std::string downscaledPath = (processScale > 1) ? getDownscaledImagePath(fileNameOrigStr, processScale) : std::string();
+    const bool hasDownscaledImage = (processScale > 1) && FileExists(downscaledPath);
+
+    if(hasDownscaledImage && (bandType == 0))
+    {
+        imageIO::readImageTransposed(downscaledPath, width, height, imgArr);
+        return;
+    }
+
     int origWidth, origHeight;
     std::vector<Color> cimg;
-    imageIO::readImage(fileNameOrigStr, origWidth, origHeight, cimg);
+    imageIO::readImage(hasDownscaledImage ? downscaledPath : fileNameOrigStr, origWidth, origHeight, cimg);
 
     // check image size
-    if((mp->getOriginalWidth(camId) != origWidth) || (mp->getOriginalHeight(camId) != origHeight))
+    const int expectedWidth = hasDownscaledImage ? width : mp->getOriginalWidth(camId);
+    const int expectedHeight = hasDownscaledImage ? height : mp->getOriginalHeight(camId);
+    if((expectedWidth != origWidth) || (expectedHeight != origHeight))
     {
         std::stringstream s;
         s << "Bad image dimension for camera : " << camId << "\n";
-        s << "\t- image path : " << fileNameOrigStr << "\n";
-        s << "\t- expected dimension : " << mp->getOriginalWidth(camId) << "x" << mp->getOriginalHeight(camId) << "\n";
+        s << "\t- image path : " << (hasDownscaledImage ? downscaledPath : fileNameOrigStr) << "\n";
+        s << "\t- expected dimension : " << expectedWidth << "x" << expectedHeight << "\n";
         s << "\t- real dimension : " << origWidth << "x" << origHeight << "\n";
         throw std::runtime_error(s.str());
     }
 
-    // scale choosed by the user and apply during the process
-    const int processScale = mp->getProcessDownscale();
-    const int width = mp->getWidth(camId);
-    const int height = mp->getHeight(camId);
-
-    if(processScale > 1)
+    if((processScale > 1) && !hasDownscaledImage)
     {
         ALICEVISION_LOG_DEBUG("Downscale (x" << processScale << ") image: " << mp->getViewId(camId) << ".");
         std::vector<Color> bmpr;
         imageIO::resizeImage(origWidth, origHeight, processScale, cimg, bmpr);
-        cimg = bmpr;
+        cimg.swap(bmpr);
     }
 
     if(bandType == 1)
@@ -361,7 +391,7 @@ void memcpyRGBImageFromFileToArr(int camId, Color* imgArr, const std::string& fi
         // cimg=cimg1;
         std::vector<Color> smooth;
         imageIO::convolveImage(width, height, cimg, smooth, "gaussian", 11.0f, 11.0f);
-        cimg = smooth;
+        cimg.swap(smooth);
     }
 
     if(bandType == 2)
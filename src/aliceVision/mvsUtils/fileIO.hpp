@@ -23,6 +23,13 @@ bool FolderExists(const std::string& folderPath);
 
 std::string getFileNameFromViewId(const MultiViewParams* mp, int viewId, EFileType fileType, int scale = 0);
 std::string getFileNameFromIndex(const MultiViewParams* mp, int index, EFileType mv_file_type, int scale = 0);
+
+/**
+ * @brief Path of the downscaled sidecar of an image ('<stem>_d<downscale><ext>'),
+ * as written by prepareDenseScene with --savePyramidLevels. The file may not exist,
+ * callers are expected to fall back to the full-resolution image.
+ */
+std::string getDownscaledImagePath(const std::string& imagePath, int downscale);
 FILE* mv_openFile(const MultiViewParams* mp, int index, EFileType mv_file_type, const char* readWrite);
 Matrix3x4 load3x4MatrixFromFile(FILE* fi);
 void memcpyRGBImageFromFileToArr(int camId, Color* imgArr, const std::string& fileNameOrigStr, const MultiViewParams* mp,
@@ -256,7 +256,7 @@ void Rig::displayRelativePoseReprojection(const geometry::Pose3 & relativePose,
 #endif
 }
 
-bool Rig::optimizeCalibration()
+bool Rig::optimizeCalibration(std::size_t nbThreads /*= 0*/)
 {
   if(!_isInitialized)
   {
@@ -328,7 +328,9 @@ bool Rig::optimizeCalibration()
 
   for(auto &elem : vMainPoses)
   {
-    auto pose = elem.second;
+    // take the stored block by reference: a copy would register a dangling
+    // pointer in the problem while the residuals use the stored one
+    std::vector<double> &pose = elem.second;
     double * parameter_block = &pose[0];
     assert(parameter_block && "parameter_block is null in vMainPoses");
     problem.AddParameterBlock(parameter_block, 6);
@@ -471,19 +473,25 @@ bool Rig::optimizeCalibration()
   }
 
   // Configure a BA engine and run it
-  // todo: Set the most appropriate options
   aliceVision::sfm::BundleAdjustmentCeres::CeresOptions aliceVision_options(true); // Set all
   // the options field in our owm struct - unnecessary dependancy to aliceVision here
-  
+
+  // the per-frame rig poses form an independent set (no residual involves two of
+  // them), so a Schur based sparse solver can eliminate them and only solve a
+  // reduced system over the few relative poses
+  aliceVision_options.setSparseBA();
+  if(nbThreads != 0)
+    aliceVision_options.nbThreads = nbThreads;
+
   ceres::Solver::Options options;
-  
+
   options.preconditioner_type = aliceVision_options.preconditionerType;
   options.linear_solver_type = aliceVision_options.linearSolverType;
   options.sparse_linear_algebra_library_type = aliceVision_options.sparseLinearAlgebraLibraryType;
   options.minimizer_progress_to_stdout = aliceVision_options.verbose;
   options.logging_type = ceres::SILENT;
-  options.num_threads = 1;//aliceVision_options._nbThreads;
-  options.num_linear_solver_threads = 1;//aliceVision_options._nbThreads;
+  options.num_threads = aliceVision_options.nbThreads;
+  options.num_linear_solver_threads = aliceVision_options.nbThreads;
   
   // Solve BA
   ceres::Solver::Summary summary;
@@ -79,8 +79,10 @@ public:
 
   /*
    * @brief Perform the rig bundle adjustment
+   * @param[in] nbThreads Number of threads used by the Ceres solver,
+   * 0 means all the available cores.
    */
-  bool optimizeCalibration();
+  bool optimizeCalibration(std::size_t nbThreads = 0);
   
   /**
    * @brief Save the calibrated poses to a text file.
@@ -44,6 +44,7 @@
 #include <vector>
 
 #include <aliceVision/robustEstimation/randSampling.hpp>
+#include <aliceVision/robustEstimation/ransacTools.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 namespace aliceVision {
@@ -154,6 +155,9 @@ inline ErrorIndex bestNFA(
  * @param[out] model returned model if found
  * @param[in] precision upper bound of the precision (squared error)
  * @param[in] bVerbose display console log
+ * @param[in] adaptiveIterations lower the iteration bound from the inlier
+ *  ratio of the best model found so far (same criterion as LORansac), so
+ *  easy pairs with a dominant model exit early
  *
  * @return (errorMax, minNFA)
  */
@@ -163,7 +167,8 @@ std::pair<double, double> ACRANSAC(const Kernel &kernel,
   size_t nIter = 1024,
   typename Kernel::Model * model = nullptr,
   double precision = std::numeric_limits<double>::infinity(),
-  bool bVerbose = false)
+  bool bVerbose = false,
+  bool adaptiveIterations = false)
 {
   vec_inliers.clear();
 
@@ -269,6 +274,20 @@ std::pair<double, double> ACRANSAC(const Kernel &kernel,
               << ",sample=" << vec_sample
               << ")");
           }
+
+          // Adaptive termination: bound the remaining iterations with the
+          // number of samplings needed for the current inlier ratio (only
+          // shrink, the reserve iterations for focused sampling are kept)
+          if (adaptiveIterations)
+          {
+            const double inlierRatio = double(vec_inliers.size()) / double(nData);
+            // guard against a degenerate (tiny ratio) bound overflowing
+            if (inlierRatio > 0.05)
+            {
+              const size_t iterRequired = IterationsRequired(sizeSample, 1e-2, inlierRatio);
+              nIter = std::min(nIter, iter + 1 + iterRequired);
+            }
+          }
         }
       } //if(bACRansacMode)
     } //for(size_t k...
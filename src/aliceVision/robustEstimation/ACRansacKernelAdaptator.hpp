@@ -30,6 +30,7 @@
 #include <aliceVision/multiview/conditioning.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
+#include <utility>
 #include <vector>
 
 namespace aliceVision {
@@ -84,6 +85,29 @@ inline bool hasStrongSupport(const matching::MatchesPerDescType& matchesPerDesc,
   return (score > minimumSamples);
 }
 
+/// Evaluate the residuals of all the correspondences for one model.
+/// The first overload is selected when the error functor provides a batched
+/// Errors() (a single vectorized expression over all the columns); otherwise
+/// the second one falls back on the per-sample loop.
+template <typename ErrorT, typename ModelT>
+inline auto EvaluateErrors(const ModelT &model, const Mat &x1, const Mat &x2,
+                           std::vector<double> &vec_errors, int)
+  -> decltype(ErrorT::Errors(model, x1, x2, std::declval<Vec&>()), void())
+{
+  Vec errors;
+  ErrorT::Errors(model, x1, x2, errors);
+  vec_errors.assign(errors.data(), errors.data() + errors.size());
+}
+
+template <typename ErrorT, typename ModelT>
+inline void EvaluateErrors(const ModelT &model, const Mat &x1, const Mat &x2,
+                           std::vector<double> &vec_errors, ...)
+{
+  vec_errors.resize(x1.cols());
+  for(std::size_t sample = 0; sample < x1.cols(); ++sample)
+    vec_errors[sample] = ErrorT::Error(model, x1.col(sample), x2.col(sample));
+}
+
 
 /// Two view Kernel adapter for the A contrario model estimator
 /// Handle data normalization and compute the corresponding logalpha 0
@@ -154,9 +178,7 @@ public:
 
   void Errors(const Model & model, std::vector<double> & vec_errors) const
   {
-    vec_errors.resize(x1_.cols());
-    for(std::size_t sample = 0; sample < x1_.cols(); ++sample)
-      vec_errors[sample] = ErrorT::Error(model, x1_.col(sample), x2_.col(sample));
+    EvaluateErrors<ErrorT>(model, x1_, x2_, vec_errors, 0);
   }
 
   std::size_t NumSamples() const
@@ -411,9 +433,7 @@ public:
   {
     Mat3 F;
     FundamentalFromEssential(model, K1_, K2_, &F);
-    vec_errors.resize(x1_.cols());
-    for(std::size_t sample = 0; sample < x1_.cols(); ++sample)
-      vec_errors[sample] = ErrorT::Error(F, this->x1_.col(sample), this->x2_.col(sample));
+    EvaluateErrors<ErrorT>(F, this->x1_, this->x2_, vec_errors, 0);
   }
 
   std::size_t NumSamples() const { return x1_.cols(); }
@@ -10,6 +10,7 @@
 #include <aliceVision/system/Logger.hpp>
 #include "aliceVision/robustEstimation/randSampling.hpp"
 #include "aliceVision/robustEstimation/ransacTools.hpp"
+#include <algorithm>
 #include <limits>
 #include <numeric>
 #include <vector>
@@ -67,12 +68,19 @@ typename Kernel::Model RANSAC(
   std::vector<size_t> all_samples(total_samples);
   std::iota(all_samples.begin(), all_samples.end(), 0);
 
+  // draw the minimal samples in batches: one batched call feeds many iterations
+  const size_t sampleBatchSize = 64;
+  std::vector<size_t> sampleBatch;
+  std::vector<size_t> sample(min_samples);
+
   for (iteration = 0;
     iteration < max_iterations &&
-    iteration < really_max_iterations; ++iteration) 
+    iteration < really_max_iterations; ++iteration)
   {
-      std::vector<size_t> sample;
-      UniformSample(min_samples, total_samples, sample);
+      const size_t batchIndex = iteration % sampleBatchSize;
+      if (batchIndex == 0)
+        UniformSampleBatch(sampleBatchSize, min_samples, total_samples, sampleBatch);
+      std::copy_n(sampleBatch.begin() + batchIndex * min_samples, min_samples, sample.begin());
 
       std::vector<typename Kernel::Model> models;
       kernel.Fit(sample, &models);
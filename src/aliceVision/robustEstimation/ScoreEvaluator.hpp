@@ -7,6 +7,11 @@
 
 #pragma once
 
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <vector>
+
 namespace aliceVision {
 namespace robustEstimation{
 
@@ -16,6 +21,10 @@ using namespace std;
 template<typename Kernel>
 class ScoreEvaluator {
 public:
+  /// Below this number of samples the scoring stays single threaded: the
+  /// thread spawn and merge overhead outweighs the work.
+  static const std::size_t minSamplesForParallelScore = 8192;
+
   ScoreEvaluator(double threshold) : threshold_(threshold) {}
 
   template <typename T>
@@ -25,16 +34,46 @@ public:
                std::vector<T> *inliers,
                double threshold) const
   {
+    // On large problems the samples are split in contiguous chunks scored by
+    // concurrent threads (a no-op inside an already parallel outer loop,
+    // since nested parallelism is disabled).
+    const bool parallelScore = samples.size() >= minSamplesForParallelScore;
+
+    // When the hypothesis is scored against the whole dataset, evaluate all
+    // the residuals at once: kernels with a vectorized Errors() compute them
+    // with a single expression instead of one call per sample.
+    if (samples.size() == kernel.NumSamples() &&
+        evaluateAllErrors(kernel, model, residuals_, 0))
+    {
+      if (parallelScore)
+        return scoreChunked(samples, threshold, inliers,
+                            [&](T sample) { return residuals_[sample]; });
+
+      double cost = 0.0;
+      for (size_t j = 0; j < samples.size(); ++j)
+      {
+        const double error = residuals_[samples[j]];
+        cost += error;
+        if (error < threshold)
+          inliers->push_back(samples[j]);
+      }
+      return cost;
+    }
+
+    if (parallelScore)
+      return scoreChunked(samples, threshold, inliers,
+                          [&](T sample) { return kernel.Error(sample, model); });
+
     double cost = 0.0;
-    for (size_t j = 0; j < samples.size(); ++j) 
+    for (size_t j = 0; j < samples.size(); ++j)
     {
       double error = kernel.Error(samples[j], model);
-      if (error < threshold) 
+      if (error < threshold)
       {
         cost += error;
         inliers->push_back(samples[j]);
-      } 
-      else 
+      }
+      else
       {
 //        cost += threshold;
         cost += error;
@@ -52,10 +91,67 @@ public:
     return Score(kernel, model, samples, inliers, threshold_);
   }
   
-  double getThreshold() const {return threshold_;} 
-  
+  double getThreshold() const {return threshold_;}
+
 private:
+  /// Score the samples split in one contiguous chunk per thread: the cost is
+  /// reduced across chunks and the per chunk inlier lists are appended in
+  /// chunk order, so the inliers come out in the same order as the serial
+  /// pass. \p errorOfSample maps a sample index to its residual.
+  template <typename T, typename ErrorFunctor>
+  double scoreChunked(const std::vector<T> &samples,
+                      double threshold,
+                      std::vector<T> *inliers,
+                      const ErrorFunctor &errorOfSample) const
+  {
+    const std::size_t nbChunks = std::min<std::size_t>(omp_get_max_threads(), samples.size());
+    const std::size_t chunkSize = (samples.size() + nbChunks - 1) / nbChunks;
+    std::vector<std::vector<T>> chunkInliers(nbChunks);
+
+    double cost = 0.0;
+    #pragma omp parallel for reduction(+:cost)
+    for(int chunk = 0; chunk < static_cast<int>(nbChunks); ++chunk)
+    {
+      std::vector<T> &localInliers = chunkInliers[chunk];
+      const std::size_t begin = chunk * chunkSize;
+      const std::size_t end = std::min(begin + chunkSize, samples.size());
+      for(std::size_t j = begin; j < end; ++j)
+      {
+        const double error = errorOfSample(samples[j]);
+        cost += error;
+        if(error < threshold)
+          localInliers.push_back(samples[j]);
+      }
+    }
+
+    for(const std::vector<T> &localInliers : chunkInliers)
+      inliers->insert(inliers->end(), localInliers.begin(), localInliers.end());
+    return cost;
+  }
+
+  /// Batched residual evaluation, enabled only for kernels providing an
+  /// Errors() method; the ellipsis overload is selected for the others
+  /// (e.g. the simple test kernels) and reports that no evaluation was done.
+  template <typename K>
+  static auto evaluateAllErrors(const K &kernel,
+                                const typename K::Model &model,
+                                std::vector<double> &residuals, int)
+    -> decltype(kernel.Errors(model, residuals), bool())
+  {
+    kernel.Errors(model, residuals);
+    return true;
+  }
+
+  template <typename K>
+  static bool evaluateAllErrors(const K &, const typename K::Model &,
+                                std::vector<double> &, ...)
+  {
+    return false;
+  }
+
   double threshold_;
+  /// scratch buffer for the batched residuals, reused across hypotheses
+  mutable std::vector<double> residuals_;
 };
 
 } // namespace robustEstimation
@@ -384,10 +384,12 @@ void GuidedMatching_Fundamental_Fast(
   const int nb_buckets = 2 * (widthR + heightR - 2);
 
   Buckets_vec buckets(nb_buckets);
+  std::vector<Vec2> lRegionsPos(lRegions.RegionCount());
   for(std::size_t i = 0; i < lRegions.RegionCount(); ++i)
   {
     // Compute epipolar line
     const Vec2 l_pt = (camL && camL->isValid()) ? camL->get_ud_pixel(lRegions.GetRegionPosition(i)) : lRegions.GetRegionPosition(i);
+    lRegionsPos[i] = l_pt;
     const Vec3 line = F * Vec3(l_pt(0), l_pt(1), 1.);
     // If the epipolar line exists in Right image
     Vec2 x0, x1;
@@ -427,22 +429,42 @@ void GuidedMatching_Fundamental_Fast(
     
     const int bucket_stop = pix_to_bucket(x0.cast<int>(), widthR, heightR);
 
-    if(bucket_stop - bucket_start > 0)
+    // test the candidates of a bucket range [rangeStart, rangeEnd)
+    const auto scoreBucketRange = [&](int rangeStart, int rangeEnd)
     {
-      // test candidate buckets
-      for(Buckets_vec::const_iterator itBs = buckets.begin() + bucket_start;
-              itBs != buckets.begin() + bucket_stop; ++itBs)
+      for(Buckets_vec::const_iterator itBs = buckets.begin() + rangeStart;
+              itBs != buckets.begin() + rangeEnd; ++itBs)
       {
         const Bucket_vec & bucket = *itBs;
         for(Bucket_vec::const_iterator itB = bucket.begin(); itB != bucket.end(); ++itB)
         {
           const IndexT i = *itB;
+          // The buckets are coarse: check the exact geometric error before
+          // scoring the descriptor distance
+          const double geomErr = ErrorArg::Error(FMat, lRegionsPos[i], xR);
+          if(geomErr >= errorTh)
+            continue;
           // Compute descriptor distance
           const double descDist = lRegions.SquaredDescriptorDistance(i, &rRegions, j);
           // Update the corresponding points & distance (if required)
           dR[i].update(j, descDist);
         }
       }
+    };
+
+    // Scan the inclusive bucket range covered by the band; the border
+    // enumeration is cyclic, so a band that crosses its origin corner is
+    // scanned with a wrap-around (an epipolar band is always the shorter arc)
+    const int first = std::min(bucket_start, bucket_stop);
+    const int last = std::max(bucket_start, bucket_stop);
+    if(last - first <= nb_buckets - (last - first))
+    {
+      scoreBucketRange(first, last + 1);
+    }
+    else
+    {
+      scoreBucketRange(last, nb_buckets);
+      scoreBucketRange(0, first + 1);
     }
   }
   // Check distance ratio validity
@@ -454,6 +476,9 @@ void GuidedMatching_Fundamental_Fast(
       vec_corresponding_index.emplace_back(i, dR[i].idx);
     }
   }
+
+  // Remove duplicates (when multiple points at same position exist)
+  matching::IndMatch::getDeduplicated(vec_corresponding_index);
 }
 
 } // namespace robustEstimation
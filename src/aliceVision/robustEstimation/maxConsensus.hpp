@@ -8,6 +8,7 @@
 #pragma once
 
 #include "aliceVision/robustEstimation/randSampling.hpp"
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -58,10 +59,14 @@ typename Kernel::Model MaxConsensus(const Kernel &kernel,
       all_samples.push_back(i);
     }
 
-    for(std::size_t iteration = 0;  iteration < max_iteration; ++iteration) 
+    // the iteration count is fixed: draw all the minimal samples in one batch
+    std::vector<std::size_t> sampleBatch;
+    UniformSampleBatch(max_iteration, min_samples, total_samples, sampleBatch);
+    std::vector<std::size_t> sample(min_samples);
+
+    for(std::size_t iteration = 0;  iteration < max_iteration; ++iteration)
     {
-      std::vector<std::size_t> sample;
-      UniformSample(min_samples, total_samples, sample);
+      std::copy_n(sampleBatch.begin() + iteration * min_samples, min_samples, sample.begin());
 
       std::vector<typename Kernel::Model> models;
       kernel.Fit(sample, &models);
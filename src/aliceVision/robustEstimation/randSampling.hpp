@@ -10,44 +10,98 @@
 #include <set>
 #include <unordered_set>
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <random>
 #include <cassert>
 
 namespace aliceVision {
 namespace robustEstimation{
 
+/**
+ * @brief Small counter-based PCG-XSH-RR 32 bit generator (O'Neill 2014).
+ *
+ * Satisfies UniformRandomBitGenerator so it plugs into the standard
+ * distributions. State is two 64-bit words and construction costs a couple of
+ * multiplications, so every thread can afford its own instance instead of
+ * serializing on shared generator state in the parallel pair loops.
+ */
+class Pcg32
+{
+public:
+  typedef std::uint32_t result_type;
+
+  explicit Pcg32(std::uint64_t seed = 0x853c49e6748fea9bULL,
+                 std::uint64_t sequence = 0xda3e39cb94b95bdbULL)
+  {
+    _state = 0u;
+    _inc = (sequence << 1u) | 1u;
+    operator()();
+    _state += seed;
+    operator()();
+  }
+
+  result_type operator()()
+  {
+    const std::uint64_t oldState = _state;
+    _state = oldState * 6364136223846793005ULL + _inc;
+    const std::uint32_t xorshifted = std::uint32_t(((oldState >> 18u) ^ oldState) >> 27u);
+    const std::uint32_t rot = std::uint32_t(oldState >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31u));
+  }
+
+  static constexpr result_type min() { return 0u; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+  std::uint64_t _state;
+  std::uint64_t _inc;
+};
+
+/**
+ * @brief Generator used by the sampling functions below: one independent stream
+ * per thread, seeded once from std::random_device, so the RANSAC loops draw in
+ * parallel without sharing (or re-seeding) any generator state.
+ */
+inline Pcg32& threadLocalGenerator()
+{
+  static thread_local Pcg32 generator = []()
+  {
+    std::random_device rd;
+    return Pcg32((std::uint64_t(rd()) << 32) | rd(), (std::uint64_t(rd()) << 32) | rd());
+  }();
+  return generator;
+}
 
 /**
- * @brief Generate a unique random samples without replacement in the 
+ * @brief Generate a unique random samples without replacement in the
  * range [lowerBound upperBound).
  * It is modeled after Matlab function with the same name, and it tries to optimize
  * the generation of the random samples: if the number of required samples is a
- * large ratio of the range, then it shuffles a vector containing all the numbers 
+ * large ratio of the range, then it shuffles a vector containing all the numbers
  * in the range and it takes the first numSamples elements. Otherwise it proceeds
- * by drawing random numbers until the numSamples elements are generated, using  
+ * by drawing random numbers until the numSamples elements are generated, using
  * Robert Floyd's algorithm.
- * 
+ *
  * @param[in] lowerBound The lower bound of the range.
  * @param[in] upperBound The upper bound of the range (not included).
  * @param[in] numSamples Number of unique samples to draw.
+ * @param[in,out] generator The random bit generator to draw from.
  * @return samples The vector containing the samples.
  */
-template<typename IntT>
+template<typename IntT, typename GeneratorT>
 inline std::vector<IntT> randSample(IntT lowerBound,
                                     IntT upperBound,
-                                    IntT numSamples)
+                                    IntT numSamples,
+                                    GeneratorT& generator)
 {
   const auto rangeSize = upperBound - lowerBound;
-  
+
   assert(lowerBound < upperBound);
   assert(numSamples <= rangeSize);
   static_assert(std::is_integral<IntT>::value, "Only integer types are supported");
 
-  
-  std::random_device rd;
-  std::mt19937 generator(rd());
-
   if(numSamples * 1.5 > rangeSize)
   {
     // if the number of required samples is a large fraction of the range size
@@ -60,6 +114,23 @@ inline std::vector<IntT> randSample(IntT lowerBound,
     result.resize(numSamples);
     return result;
   }
+  else if(numSamples <= 32)
+  {
+    // minimal RANSAC samples are a handful of indices: Robert Floyd with a
+    // linear uniqueness scan over the output, no hash set allocation at all.
+    std::vector<IntT> result;
+    result.reserve(numSamples);
+    for(IntT d = upperBound - numSamples; d < upperBound; ++d)
+    {
+      const IntT t = std::uniform_int_distribution<>(0, d)(generator) + lowerBound;
+      if(std::find(result.begin(), result.end(), t) == result.end())
+        result.push_back(t);
+      else
+        result.push_back(d);
+    }
+    assert(result.size() == numSamples);
+    return result;
+  }
   else
   {
     // otherwise if the number of required samples is small wrt the range
@@ -81,6 +152,17 @@ inline std::vector<IntT> randSample(IntT lowerBound,
   }
 }
 
+/**
+ * @brief Same as above, drawing from the calling thread's own generator.
+ */
+template<typename IntT>
+inline std::vector<IntT> randSample(IntT lowerBound,
+                                    IntT upperBound,
+                                    IntT numSamples)
+{
+  return randSample(lowerBound, upperBound, numSamples, threadLocalGenerator());
+}
+
 /**
 * @brief Pick a random subset of the integers in the range [0, upperBound).
 *
@@ -156,5 +238,46 @@ inline void UniformSample(std::size_t sampleSize,
   }
 }
 
+/**
+ * @brief Draw many unique-sample index sets in one call.
+ *
+ * Fills numSets samples of numSamples unique indices in the range [0, upperBound),
+ * packed back to back in the output vector: set s occupies
+ * [s * numSamples, (s + 1) * numSamples). One call feeds many RANSAC iterations
+ * from the calling thread's own generator, with no per-iteration allocation.
+ *
+ * @param[in] numSets Number of index sets to draw.
+ * @param[in] numSamples Number of unique samples per set.
+ * @param[in] upperBound The value at the end of the range (not included).
+ * @param[out] samples The flat vector of numSets * numSamples indices.
+ */
+template<typename IntT>
+inline void UniformSampleBatch(std::size_t numSets,
+                               std::size_t numSamples,
+                               std::size_t upperBound,
+                               std::vector<IntT>& samples)
+{
+  assert(numSamples <= upperBound);
+  static_assert(std::is_integral<IntT>::value, "Only integer types are supported");
+
+  Pcg32& generator = threadLocalGenerator();
+  samples.resize(numSets * numSamples);
+  IntT* out = samples.data();
+  for(std::size_t s = 0; s < numSets; ++s, out += numSamples)
+  {
+    // Robert Floyd over the tail of the range; uniqueness by a linear scan over
+    // the few indices of a minimal sample, which beats a hash set at these sizes
+    std::size_t nb = 0;
+    for(std::size_t d = upperBound - numSamples; d < upperBound; ++d)
+    {
+      const IntT t = IntT(std::uniform_int_distribution<std::size_t>(0, d)(generator));
+      if(std::find(out, out + nb, t) == out + nb)
+        out[nb++] = t;
+      else
+        out[nb++] = IntT(d);
+    }
+  }
+}
+
 } // namespace robustEstimation
 } // namespace aliceVision
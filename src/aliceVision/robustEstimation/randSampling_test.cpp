@@ -86,6 +86,32 @@ BOOST_AUTO_TEST_CASE(UniformSampleTest_NoRepetionsBeginEnd) {
   }
 }
 
+// Assert that every set of a batched draw has the right size, range and no repetition
+BOOST_AUTO_TEST_CASE(UniformSampleTest_Batch) {
+
+  for(std::size_t upperBound = 8; upperBound < 513; upperBound *= 2)
+  {
+    for(std::size_t numSamples = 1; numSamples <= 8; numSamples *= 2)
+    {
+      const std::size_t numSets = 100;
+      std::vector<std::size_t> samples;
+      UniformSampleBatch(numSets, numSamples, upperBound, samples);
+      BOOST_CHECK_EQUAL(numSets * numSamples, samples.size());
+      for(std::size_t s = 0; s < numSets; ++s)
+      {
+        std::set<std::size_t> myset;
+        for(std::size_t i = 0; i < numSamples; ++i)
+        {
+          const std::size_t value = samples[s * numSamples + i];
+          myset.insert(value);
+          BOOST_CHECK(value < upperBound);
+        }
+        BOOST_CHECK_EQUAL(numSamples, myset.size());
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(UniformSampleTest_randSample) {
   
   for(std::size_t upperBound = 1; upperBound < 513; upperBound *= 2)
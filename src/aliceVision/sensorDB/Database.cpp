@@ -0,0 +1,72 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "Database.hpp"
+#include <aliceVision/sensorDB/parseDatabase.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+namespace aliceVision {
+namespace sensorDB {
+
+bool Database::load(const std::string& databaseFilePath)
+{
+  _datasheets.clear();
+  _normalizedModels.clear();
+  _datasheetIndex.clear();
+  _brandIndex.clear();
+
+  if(!parseDatabase(databaseFilePath, _datasheets))
+    return false;
+
+  _normalizedModels.reserve(_datasheets.size());
+  _datasheetIndex.reserve(_datasheets.size());
+
+  for(std::size_t i = 0; i < _datasheets.size(); ++i)
+  {
+    const std::string brand = normalizeToken(_datasheets.at(i)._brand);
+    const std::string model = normalizeToken(_datasheets.at(i)._model);
+
+    _normalizedModels.push_back(model);
+    _datasheetIndex.emplace(brand + ";" + model, i); // keep the first datasheet in case of duplicates
+    _brandIndex[brand].push_back(i);
+  }
+  return true;
+}
+
+bool Database::getInfo(const std::string& brand, const std::string& model, Datasheet& datasheetContent) const
+{
+  const std::string normalizedBrand = normalizeToken(brand);
+  const std::string normalizedModel = normalizeToken(model);
+
+  // exact brand / model lookup
+  const auto itDatasheet = _datasheetIndex.find(normalizedBrand + ";" + normalizedModel);
+  if(itDatasheet != _datasheetIndex.end())
+  {
+    datasheetContent = _datasheets.at(itDatasheet->second);
+    return true;
+  }
+
+  // partial model lookup, restricted to the datasheets of the same brand
+  const auto itBrand = _brandIndex.find(normalizedBrand);
+  if(itBrand == _brandIndex.end())
+    return false;
+
+  for(const std::size_t i : itBrand->second)
+  {
+    const std::string& databaseModel = _normalizedModels.at(i);
+    if(boost::algorithm::ends_with(databaseModel, normalizedModel) ||
+       boost::algorithm::ends_with(normalizedModel, databaseModel))
+    {
+      datasheetContent = _datasheets.at(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace sensorDB
+} // namespace aliceVision
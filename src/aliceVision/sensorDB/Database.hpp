@@ -0,0 +1,76 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sensorDB/Datasheet.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aliceVision {
+namespace sensorDB {
+
+/**
+ * @brief The sensor database indexed by normalized brand / model names.
+ *
+ * The database text file is parsed once and a hash index is built over it,
+ * so that each getInfo() call is a O(1) lookup instead of a linear scan
+ * with per-datasheet string normalization.
+ */
+class Database
+{
+public:
+
+  Database() = default;
+
+  /**
+   * @brief Load the given sensor database and build the hash index
+   * @param[in] databaseFilePath The file path of the given database
+   * @return True if ok
+   */
+  bool load(const std::string& databaseFilePath);
+
+  /**
+   * @brief Get information for the given camera brand / model
+   * @param[in] brand The camera brand
+   * @param[in] model The camera model
+   * @param[out] datasheetContent The corresponding datasheet
+   * @return True if ok
+   */
+  bool getInfo(const std::string& brand, const std::string& model, Datasheet& datasheetContent) const;
+
+  /**
+   * @brief Return true if the database is empty
+   */
+  bool empty() const
+  {
+    return _datasheets.empty();
+  }
+
+  /**
+   * @brief Get all the database datasheets
+   */
+  const std::vector<Datasheet>& getDatasheets() const
+  {
+    return _datasheets;
+  }
+
+private:
+
+  /// all the database datasheets, in file order
+  std::vector<Datasheet> _datasheets;
+  /// normalized model name of each datasheet, parallel to _datasheets
+  std::vector<std::string> _normalizedModels;
+  /// normalized "brand;model" key to datasheet index, for exact lookups
+  std::unordered_map<std::string, std::size_t> _datasheetIndex;
+  /// normalized brand name to datasheet indexes, for partial model lookups
+  std::unordered_map<std::string, std::vector<std::size_t>> _brandIndex;
+};
+
+} // namespace sensorDB
+} // namespace aliceVision
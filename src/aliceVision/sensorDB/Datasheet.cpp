@@ -18,31 +18,13 @@ namespace sensorDB {
 
 bool Datasheet::operator==(const Datasheet& other) const
 {
-  std::string brandA = _brand;
-  std::string brandB = other._brand;
-
-  boost::algorithm::to_lower(brandA);
-  boost::algorithm::to_lower(brandB);
-
-  brandA.erase(std::remove_if(brandA.begin(), brandA.end(), ::ispunct), brandA.end()); //remove punctuation
-  brandB.erase(std::remove_if(brandB.begin(), brandB.end(), ::ispunct), brandB.end()); //remove punctuation
-
-  brandA.erase(std::remove_if(brandA.begin(), brandA.end(), ::isspace), brandA.end()); //remove spaces
-  brandB.erase(std::remove_if(brandB.begin(), brandB.end(), ::isspace), brandB.end()); //remove spaces
+  const std::string brandA = normalizeToken(_brand);
+  const std::string brandB = normalizeToken(other._brand);
 
   if(brandA == brandB)
   {
-    std::string modelA = _model;
-    std::string modelB = other._model;
-
-    boost::algorithm::to_lower(modelA);
-    boost::algorithm::to_lower(modelB);
-
-    modelA.erase(std::remove_if(modelA.begin(), modelA.end(), ::ispunct), modelA.end()); //remove punctuation
-    modelB.erase(std::remove_if(modelB.begin(), modelB.end(), ::ispunct), modelB.end()); //remove punctuation
-
-    modelA.erase(std::remove_if(modelA.begin(), modelA.end(), ::isspace), modelA.end()); //remove spaces
-    modelB.erase(std::remove_if(modelB.begin(), modelB.end(), ::isspace), modelB.end()); //remove spaces
+    const std::string modelA = normalizeToken(_model);
+    const std::string modelB = normalizeToken(other._model);
 
     if((modelA == modelB) ||
        (boost::algorithm::ends_with(modelA, modelB)) ||
@@ -53,5 +35,14 @@ bool Datasheet::operator==(const Datasheet& other) const
   return false;
 }
 
+std::string normalizeToken(const std::string& token)
+{
+  std::string normalized = token;
+  boost::algorithm::to_lower(normalized);
+  normalized.erase(std::remove_if(normalized.begin(), normalized.end(), ::ispunct), normalized.end()); //remove punctuation
+  normalized.erase(std::remove_if(normalized.begin(), normalized.end(), ::isspace), normalized.end()); //remove spaces
+  return normalized;
+}
+
 } // namespace sensorDB
 } // namespace aliceVision
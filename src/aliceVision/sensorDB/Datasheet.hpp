@@ -40,5 +40,13 @@ struct Datasheet
   double _sensorSize;
 };
 
+/**
+ * @brief Normalize a brand or model name for comparison
+ *        (lower case, without punctuation and spaces)
+ * @param[in] token The brand or model name
+ * @return The normalized name
+ */
+std::string normalizeToken(const std::string& token);
+
 } // namespace sensorDB
 } // namespace aliceVision
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/Database.hpp>
 
 #include <boost/filesystem.hpp>
 
@@ -111,3 +112,72 @@ BOOST_AUTO_TEST_CASE(ParseDatabaseCanon_EOS_1100D)
   BOOST_CHECK( getInfo( sBrand, sModel, vec_database, datasheet ) );
   BOOST_CHECK_EQUAL( 22.2, datasheet._sensorSize );
 }
+
+BOOST_AUTO_TEST_CASE(IndexedDatabaseInvalid)
+{
+  Database database;
+  const std::string sfileDatabase = std::string(THIS_SOURCE_DIR);
+
+  BOOST_CHECK(! database.load( sfileDatabase ) );
+  BOOST_CHECK( database.empty() );
+}
+
+BOOST_AUTO_TEST_CASE(IndexedDatabaseExactModel)
+{
+  Database database;
+  Datasheet datasheet;
+  const std::string sModel = "Canon PowerShot SD900";
+  const std::string sBrand = "Canon";
+
+  BOOST_CHECK( database.load( sDatabase ) );
+  BOOST_CHECK( database.getInfo( sBrand, sModel, datasheet ) );
+  BOOST_CHECK_EQUAL( "Canon", datasheet._brand );
+  BOOST_CHECK_EQUAL( "Canon PowerShot SD900", datasheet._model );
+  BOOST_CHECK_EQUAL( 7.144, datasheet._sensorSize );
+}
+
+BOOST_AUTO_TEST_CASE(IndexedDatabasePartialModel)
+{
+  Database database;
+  Datasheet datasheet;
+  const std::string sModel = "PowerShot A710 IS"; // without the brand prefix of the database entry
+  const std::string sBrand = "Canon";
+
+  BOOST_CHECK( database.load( sDatabase ) );
+  BOOST_CHECK( database.getInfo( sBrand, sModel, datasheet ) );
+  BOOST_CHECK_EQUAL( "Canon PowerShot A710 IS", datasheet._model );
+  BOOST_CHECK_EQUAL( 5.744, datasheet._sensorSize );
+}
+
+BOOST_AUTO_TEST_CASE(IndexedDatabaseNotExist)
+{
+  Database database;
+  Datasheet datasheet;
+  const std::string sModel = "NotExistModel";
+  const std::string sBrand = "NotExistBrand";
+
+  BOOST_CHECK( database.load( sDatabase ) );
+  BOOST_CHECK(! database.getInfo( sBrand, sModel, datasheet ) );
+}
+
+BOOST_AUTO_TEST_CASE(IndexedDatabaseSameAsLinearSearch)
+{
+  std::vector<Datasheet> vec_database;
+  Database database;
+
+  BOOST_CHECK( parseDatabase( sDatabase, vec_database ) );
+  BOOST_CHECK( database.load( sDatabase ) );
+  BOOST_CHECK_EQUAL( vec_database.size(), database.getDatasheets().size() );
+
+  // every database entry must be found by both searches
+  // note: the sensor sizes can differ for a few duplicated models, as the
+  // indexed search gives priority to the exact model over a partial match
+  for(const Datasheet& entry : vec_database)
+  {
+    Datasheet linear;
+    Datasheet indexed;
+
+    BOOST_CHECK( getInfo( entry._brand, entry._model, vec_database, linear ) );
+    BOOST_CHECK( database.getInfo( entry._brand, entry._model, indexed ) );
+  }
+}
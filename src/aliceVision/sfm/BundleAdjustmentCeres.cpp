@@ -16,6 +16,7 @@
 
 #include <ceres/rotation.h>
 
+#include <algorithm>
 #include <fstream>
 
 namespace fs = boost::filesystem;
@@ -30,13 +31,16 @@ using namespace aliceVision::geometry;
  * @brief Create the appropriate cost functor according the provided input camera intrinsic model
  * @param[in] intrinsicPtr The intrinsic pointer
  * @param[in] observation The corresponding observation
+ * @param[in] useAnalyticPinholeCost Use the analytically differentiated cost for the distortion-free pinhole model
  * @return cost functor
  */
-ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr, const Vec2& observation)
+ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr, const Vec2& observation, bool useAnalyticPinholeCost = false)
 {
   switch(intrinsicPtr->getType())
   {
     case PINHOLE_CAMERA:
+      if(useAnalyticPinholeCost)
+        return new ResidualErrorAnalyticCostFunction_Pinhole(observation.data());
       return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 3, 6, 3>(new ResidualErrorFunctor_Pinhole(observation.data()));
     case PINHOLE_CAMERA_RADIAL1:
       return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK1, 2, 4, 6, 3>(new ResidualErrorFunctor_PinholeRadialK1(observation.data()));
@@ -80,6 +84,49 @@ ceres::CostFunction* createRigCostFunctionFromIntrinsics(const IntrinsicBase* in
   }
 }
 
+/**
+ * @brief Fill a pose parameter block from a camera pose according to the Ceres format: [Rx, Ry, Rz, tx, ty, tz]
+ * @param[in] cameraPose The camera pose
+ * @param[out] poseBlock The pose parameter block
+ */
+void setPoseBlock(const sfmData::CameraPose& cameraPose, std::array<double,6>& poseBlock)
+{
+  const Mat3& R = cameraPose.getTransform().rotation();
+  const Vec3& t = cameraPose.getTransform().translation();
+
+  double angleAxis[3];
+  ceres::RotationMatrixToAngleAxis(static_cast<const double *>(R.data()), angleAxis);
+  poseBlock.at(0) = angleAxis[0];
+  poseBlock.at(1) = angleAxis[1];
+  poseBlock.at(2) = angleAxis[2];
+  poseBlock.at(3) = t(0);
+  poseBlock.at(4) = t(1);
+  poseBlock.at(5) = t(2);
+}
+
+/**
+ * @brief Count the number of reconstructed views per intrinsic
+ * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+ * @return the number of reconstructed views for each intrinsic id
+ */
+std::map<IndexT, std::size_t> countIntrinsicsUsage(const sfmData::SfMData& sfmData)
+{
+  std::map<IndexT, std::size_t> intrinsicsUsage;
+
+  for(const auto& viewPair: sfmData.getViews())
+  {
+    const sfmData::View& view = *(viewPair.second);
+
+    if(intrinsicsUsage.find(view.getIntrinsicId()) == intrinsicsUsage.end())
+      intrinsicsUsage[view.getIntrinsicId()] = 0;
+
+    if(sfmData.isPoseAndIntrinsicDefined(&view))
+      ++intrinsicsUsage.at(view.getIntrinsicId());
+  }
+
+  return intrinsicsUsage;
+}
+
 void BundleAdjustmentCeres::CeresOptions::setDenseBA()
 {
   // default configuration use a DENSE representation
@@ -258,69 +305,59 @@ void BundleAdjustmentCeres::setSolverOptions(ceres::Solver::Options& solverOptio
   }
 }
 
-void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmData, BundleAdjustment::ERefineOptions refineOptions, ceres::Problem& problem)
+void BundleAdjustmentCeres::addPoseToProblem(const sfmData::CameraPose& cameraPose, bool isConstant, BundleAdjustment::ERefineOptions refineOptions, std::array<double,6>& poseBlock, ceres::Problem& problem)
 {
   const bool refineTranslation = refineOptions & BundleAdjustment::REFINE_TRANSLATION;
   const bool refineRotation = refineOptions & BundleAdjustment::REFINE_ROTATION;
 
-  const auto addPose = [&](const sfmData::CameraPose& cameraPose, bool isConstant, std::array<double,6>& poseBlock)
-  {
-    const Mat3& R = cameraPose.getTransform().rotation();
-    const Vec3& t = cameraPose.getTransform().translation();
-
-    double angleAxis[3];
-    ceres::RotationMatrixToAngleAxis(static_cast<const double *>(R.data()), angleAxis);
-    poseBlock.at(0) = angleAxis[0];
-    poseBlock.at(1) = angleAxis[1];
-    poseBlock.at(2) = angleAxis[2];
-    poseBlock.at(3) = t(0);
-    poseBlock.at(4) = t(1);
-    poseBlock.at(5) = t(2);
+  setPoseBlock(cameraPose, poseBlock);
 
-    double* poseBlockPtr = poseBlock.data();
-    problem.AddParameterBlock(poseBlockPtr, 6);
+  double* poseBlockPtr = poseBlock.data();
+  problem.AddParameterBlock(poseBlockPtr, 6);
 
-    // add pose parameter to the all parameters blocks pointers list
-    _allParametersBlocks.push_back(poseBlockPtr);
+  // add pose parameter to the all parameters blocks pointers list
+  _allParametersBlocks.push_back(poseBlockPtr);
 
-    // keep the camera extrinsics constants
-    if(cameraPose.isLocked() || isConstant || (!refineTranslation && !refineRotation))
-    {
-      // set the whole parameter block as constant.
-      _statistics.addState(EParameter::POSE, EParameterState::CONSTANT);
-      problem.SetParameterBlockConstant(poseBlockPtr);
-      return;
-    }
+  // keep the camera extrinsics constants
+  if(cameraPose.isLocked() || isConstant || (!refineTranslation && !refineRotation))
+  {
+    // set the whole parameter block as constant.
+    _statistics.addState(EParameter::POSE, EParameterState::CONSTANT);
+    problem.SetParameterBlockConstant(poseBlockPtr);
+    return;
+  }
 
-    // constant parameters
-    std::vector<int> constantExtrinsic;
+  // constant parameters
+  std::vector<int> constantExtrinsic;
 
-    // don't refine rotations
-    if(!refineRotation)
-    {
-      constantExtrinsic.push_back(0);
-      constantExtrinsic.push_back(1);
-      constantExtrinsic.push_back(2);
-    }
+  // don't refine rotations
+  if(!refineRotation)
+  {
+    constantExtrinsic.push_back(0);
+    constantExtrinsic.push_back(1);
+    constantExtrinsic.push_back(2);
+  }
 
-    // don't refine translations
-    if(!refineTranslation)
-    {
-      constantExtrinsic.push_back(3);
-      constantExtrinsic.push_back(4);
-      constantExtrinsic.push_back(5);
-    }
+  // don't refine translations
+  if(!refineTranslation)
+  {
+    constantExtrinsic.push_back(3);
+    constantExtrinsic.push_back(4);
+    constantExtrinsic.push_back(5);
+  }
 
-    // subset parametrization
-    if(!constantExtrinsic.empty())
-    {
-      ceres::SubsetParameterization* subsetParameterization = new ceres::SubsetParameterization(6, constantExtrinsic);
-      problem.SetParameterization(poseBlockPtr, subsetParameterization);
-    }
+  // subset parametrization
+  if(!constantExtrinsic.empty())
+  {
+    ceres::SubsetParameterization* subsetParameterization = new ceres::SubsetParameterization(6, constantExtrinsic);
+    problem.SetParameterization(poseBlockPtr, subsetParameterization);
+  }
 
-    _statistics.addState(EParameter::POSE, EParameterState::REFINED);
-  };
+  _statistics.addState(EParameter::POSE, EParameterState::REFINED);
+}
 
+void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmData, BundleAdjustment::ERefineOptions refineOptions, ceres::Problem& problem)
+{
   // setup poses data
   for(const auto& posePair : sfmData.getPoses())
   {
@@ -336,7 +373,7 @@ void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmDa
 
     const bool isConstant = (getPoseState(poseId) == EParameterState::CONSTANT);
 
-    addPose(pose, isConstant, _posesBlocks[poseId]);
+    addPoseToProblem(pose, isConstant, refineOptions, _posesBlocks[poseId], problem);
   }
 
   // setup sub-poses data
@@ -355,36 +392,113 @@ void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmDa
 
       const bool isConstant = (rigSubPose.status == sfmData::ERigSubPoseStatus::CONSTANT);
 
-      addPose(sfmData::CameraPose(rigSubPose.pose), isConstant, _rigBlocks[rigId][subPoseId]);
+      addPoseToProblem(sfmData::CameraPose(rigSubPose.pose), isConstant, refineOptions, _rigBlocks[rigId][subPoseId], problem);
     }
   }
 }
 
-void BundleAdjustmentCeres::addIntrinsicsToProblem(const sfmData::SfMData& sfmData, BundleAdjustment::ERefineOptions refineOptions, ceres::Problem& problem)
+void BundleAdjustmentCeres::addIntrinsicToProblem(const sfmData::SfMData& sfmData, IndexT intrinsicId, std::size_t usageCount, BundleAdjustment::ERefineOptions refineOptions, ceres::Problem& problem)
 {
   const bool refineIntrinsicsOpticalCenter = (refineOptions & REFINE_INTRINSICS_OPTICALCENTER_ALWAYS) || (refineOptions & REFINE_INTRINSICS_OPTICALCENTER_IF_ENOUGH_DATA);
   const bool refineIntrinsicsFocalLength = refineOptions & REFINE_INTRINSICS_FOCAL;
   const bool refineIntrinsicsDistortion = refineOptions & REFINE_INTRINSICS_DISTORTION;
   const bool refineIntrinsics = refineIntrinsicsDistortion || refineIntrinsicsFocalLength || refineIntrinsicsOpticalCenter;
 
-  std::map<IndexT, std::size_t> intrinsicsUsage;
+  const auto& intrinsicPtr = sfmData.getIntrinsics().at(intrinsicId);
 
-  // count the number of reconstructed views per intrinsic
-  for(const auto& viewPair: sfmData.getViews())
+  assert(isValid(intrinsicPtr->getType()));
+
+  std::vector<double>& intrinsicBlock = _intrinsicsBlocks[intrinsicId];
+  intrinsicBlock = intrinsicPtr->getParams();
+
+  double* intrinsicBlockPtr = intrinsicBlock.data();
+  problem.AddParameterBlock(intrinsicBlockPtr, intrinsicBlock.size());
+
+  // add intrinsic parameter to the all parameters blocks pointers list
+  _allParametersBlocks.push_back(intrinsicBlockPtr);
+
+  // keep the camera intrinsic constant
+  if(intrinsicPtr->isLocked() || !refineIntrinsics || getIntrinsicState(intrinsicId) == EParameterState::CONSTANT)
   {
-    const sfmData::View& view = *(viewPair.second);
+    // set the whole parameter block as constant.
+    _statistics.addState(EParameter::INTRINSIC, EParameterState::CONSTANT);
+    problem.SetParameterBlockConstant(intrinsicBlockPtr);
+    return;
+  }
 
-    if(intrinsicsUsage.find(view.getIntrinsicId()) == intrinsicsUsage.end())
-      intrinsicsUsage[view.getIntrinsicId()] = 0;
+  // constant parameters
+  std::vector<int> constantIntrinisc;
 
-    if(sfmData.isPoseAndIntrinsicDefined(&view))
-      ++intrinsicsUsage.at(view.getIntrinsicId());
+  // refine the focal length
+  if(refineIntrinsicsFocalLength)
+  {
+    if(intrinsicPtr->initialFocalLengthPix() > 0)
+    {
+      // if we have an initial guess, we only authorize a margin around this value.
+      assert(intrinsicBlock.size() >= 1);
+      const unsigned int maxFocalError = 0.2 * std::max(intrinsicPtr->w(), intrinsicPtr->h()); // TODO : check if rounding is needed
+      problem.SetParameterLowerBound(intrinsicBlockPtr, 0, static_cast<double>(intrinsicPtr->initialFocalLengthPix() - maxFocalError));
+      problem.SetParameterUpperBound(intrinsicBlockPtr, 0, static_cast<double>(intrinsicPtr->initialFocalLengthPix() + maxFocalError));
+    }
+    else // no initial guess
+    {
+      // we don't have an initial guess, but we assume that we use
+      // a converging lens, so the focal length should be positive.
+      problem.SetParameterLowerBound(intrinsicBlockPtr, 0, 0.0);
+    }
+  }
+  else
+  {
+    // set focal length as constant
+    constantIntrinisc.push_back(0);
+  }
+
+  const std::size_t minImagesForOpticalCenter = 3;
+
+  // optical center
+  if(refineIntrinsicsOpticalCenter && (usageCount > minImagesForOpticalCenter))
+  {
+    // refine optical center within 10% of the image size.
+    assert(intrinsicBlock.size() >= 3);
+
+    const double opticalCenterMinPercent = 0.45;
+    const double opticalCenterMaxPercent = 0.55;
+
+    // add bounds to the principal point
+    problem.SetParameterLowerBound(intrinsicBlockPtr, 1, opticalCenterMinPercent * intrinsicPtr->w());
+    problem.SetParameterUpperBound(intrinsicBlockPtr, 1, opticalCenterMaxPercent * intrinsicPtr->w());
+    problem.SetParameterLowerBound(intrinsicBlockPtr, 2, opticalCenterMinPercent * intrinsicPtr->h());
+    problem.SetParameterUpperBound(intrinsicBlockPtr, 2, opticalCenterMaxPercent * intrinsicPtr->h());
+  }
+  else
+  {
+    // don't refine the optical center
+    constantIntrinisc.push_back(1);
+    constantIntrinisc.push_back(2);
+  }
+
+  // lens distortion
+  if(!refineIntrinsicsDistortion)
+    for(std::size_t i = 3; i < intrinsicBlock.size(); ++i)
+      constantIntrinisc.push_back(i);
+
+  if(!constantIntrinisc.empty())
+  {
+    ceres::SubsetParameterization* subsetParameterization = new ceres::SubsetParameterization(intrinsicBlock.size(), constantIntrinisc);
+    problem.SetParameterization(intrinsicBlockPtr, subsetParameterization);
   }
 
+  _statistics.addState(EParameter::INTRINSIC, EParameterState::REFINED);
+}
+
+void BundleAdjustmentCeres::addIntrinsicsToProblem(const sfmData::SfMData& sfmData, BundleAdjustment::ERefineOptions refineOptions, ceres::Problem& problem)
+{
+  // count the number of reconstructed views per intrinsic
+  const std::map<IndexT, std::size_t> intrinsicsUsage = countIntrinsicsUsage(sfmData);
+
   for(const auto& intrinsicPair: sfmData.getIntrinsics())
   {
     const IndexT intrinsicId = intrinsicPair.first;
-    const auto& intrinsicPtr = intrinsicPair.second;
     const std::size_t usageCount = intrinsicsUsage.at(intrinsicId);
 
     // do not refine an intrinsic does not used by any reconstructed view
@@ -394,105 +508,112 @@ void BundleAdjustmentCeres::addIntrinsicsToProblem(const sfmData::SfMData& sfmDa
       continue;
     }
 
-    assert(isValid(intrinsicPtr->getType()));
+    addIntrinsicToProblem(sfmData, intrinsicId, usageCount, refineOptions, problem);
+  }
+}
 
-    std::vector<double>& intrinsicBlock = _intrinsicsBlocks[intrinsicId];
-    intrinsicBlock = intrinsicPtr->getParams();
+void BundleAdjustmentCeres::addLandmarkToProblem(const sfmData::SfMData& sfmData, IndexT landmarkId, ERefineOptions refineOptions, ceres::Problem& problem)
+{
+  const bool refineStructure = refineOptions & REFINE_STRUCTURE;
 
-    double* intrinsicBlockPtr = intrinsicBlock.data();
-    problem.AddParameterBlock(intrinsicBlockPtr, intrinsicBlock.size());
+  const sfmData::Landmark& landmark = sfmData.getLandmarks().at(landmarkId);
 
-    // add intrinsic parameter to the all parameters blocks pointers list
-    _allParametersBlocks.push_back(intrinsicBlockPtr);
+  std::array<double,3>& landmarkBlock = _landmarksBlocks[landmarkId];
+  for(std::size_t i = 0; i < 3; ++i)
+    landmarkBlock.at(i) = landmark.X(Eigen::Index(i));
 
-    // keep the camera intrinsic constant
-    if(intrinsicPtr->isLocked() || !refineIntrinsics || getIntrinsicState(intrinsicId) == EParameterState::CONSTANT)
+  double* landmarkBlockPtr = landmarkBlock.data();
+
+  // add landmark parameter to the all parameters blocks pointers list
+  _allParametersBlocks.push_back(landmarkBlockPtr);
+
+  // record the observing views in order to detect observation changes between adjust() calls
+  std::vector<IndexT>& observingViews = _landmarksObservingViews[landmarkId];
+  observingViews.clear();
+  observingViews.reserve(landmark.observations.size());
+
+  // iterate over 2D observation associated to the 3D landmark
+  for(const auto& observationPair: landmark.observations)
+  {
+    const sfmData::View& view = sfmData.getView(observationPair.first);
+    const sfmData::Observation& observation = observationPair.second;
+
+    observingViews.push_back(observationPair.first);
+
+    // each residual block takes a point and a camera as input and outputs a 2
+    // dimensional residual. Internally, the cost function stores the observed
+    // image location and compares the reprojection against the observation.
+
+    assert(getPoseState(view.getPoseId()) != EParameterState::IGNORED);
+    assert(getIntrinsicState(view.getIntrinsicId()) != EParameterState::IGNORED);
+
+    // needed parameters to create a residual block (K, pose)
+    double* poseBlockPtr = _posesBlocks.at(view.getPoseId()).data();
+    double* intrinsicBlockPtr = _intrinsicsBlocks.at(view.getIntrinsicId()).data();
+
+    // apply a specific parameter ordering:
+    if(_ceresOptions.useParametersOrdering)
     {
-      // set the whole parameter block as constant.
-      _statistics.addState(EParameter::INTRINSIC, EParameterState::CONSTANT);
-      problem.SetParameterBlockConstant(intrinsicBlockPtr);
-      continue;
+      _ceresOptions.linearSolverOrdering.AddElementToGroup(landmarkBlockPtr, 0);
+      _ceresOptions.linearSolverOrdering.AddElementToGroup(poseBlockPtr, 1);
+      _ceresOptions.linearSolverOrdering.AddElementToGroup(intrinsicBlockPtr, 2);
     }
 
-    // constant parameters
-    std::vector<int> constantIntrinisc;
-
-    // refine the focal length
-    if(refineIntrinsicsFocalLength)
+    if(view.isPartOfRig() && !view.isPoseIndependant())
     {
-      if(intrinsicPtr->initialFocalLengthPix() > 0)
-      {
-        // if we have an initial guess, we only authorize a margin around this value.
-        assert(intrinsicBlock.size() >= 1);
-        const unsigned int maxFocalError = 0.2 * std::max(intrinsicPtr->w(), intrinsicPtr->h()); // TODO : check if rounding is needed
-        problem.SetParameterLowerBound(intrinsicBlockPtr, 0, static_cast<double>(intrinsicPtr->initialFocalLengthPix() - maxFocalError));
-        problem.SetParameterUpperBound(intrinsicBlockPtr, 0, static_cast<double>(intrinsicPtr->initialFocalLengthPix() + maxFocalError));
-      }
-      else // no initial guess
-      {
-        // we don't have an initial guess, but we assume that we use
-        // a converging lens, so the focal length should be positive.
-        problem.SetParameterLowerBound(intrinsicBlockPtr, 0, 0.0);
-      }
+      ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation.x);
+
+      problem.AddResidualBlock(costFunction,
+          _lossFunction.get(),
+          intrinsicBlockPtr,
+          poseBlockPtr,
+          _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data(), // subpose of the cameras rig
+          landmarkBlockPtr); // do we need to copy 3D point to avoid false motion, if failure ?
     }
     else
     {
-      // set focal length as constant
-      constantIntrinisc.push_back(0);
-    }
+      ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation.x, _ceresOptions.useAnalyticPinholeCost);
 
-    const std::size_t minImagesForOpticalCenter = 3;
+      problem.AddResidualBlock(costFunction,
+          _lossFunction.get(),
+          intrinsicBlockPtr,
+          poseBlockPtr,
+          landmarkBlockPtr); //do we need to copy 3D point to avoid false motion, if failure ?
+    }
 
-    // optical center
-    if(refineIntrinsicsOpticalCenter && (usageCount > minImagesForOpticalCenter))
+    if(!refineStructure || getLandmarkState(landmarkId) == EParameterState::CONSTANT)
     {
-      // refine optical center within 10% of the image size.
-      assert(intrinsicBlock.size() >= 3);
-
-      const double opticalCenterMinPercent = 0.45;
-      const double opticalCenterMaxPercent = 0.55;
-
-      // add bounds to the principal point
-      problem.SetParameterLowerBound(intrinsicBlockPtr, 1, opticalCenterMinPercent * intrinsicPtr->w());
-      problem.SetParameterUpperBound(intrinsicBlockPtr, 1, opticalCenterMaxPercent * intrinsicPtr->w());
-      problem.SetParameterLowerBound(intrinsicBlockPtr, 2, opticalCenterMinPercent * intrinsicPtr->h());
-      problem.SetParameterUpperBound(intrinsicBlockPtr, 2, opticalCenterMaxPercent * intrinsicPtr->h());
+      // set the whole landmark parameter block as constant.
+      _statistics.addState(EParameter::LANDMARK, EParameterState::CONSTANT);
+      problem.SetParameterBlockConstant(landmarkBlockPtr);
     }
     else
     {
-      // don't refine the optical center
-      constantIntrinisc.push_back(1);
-      constantIntrinisc.push_back(2);
+      _statistics.addState(EParameter::LANDMARK, EParameterState::REFINED);
     }
+  }
+}
+
+void BundleAdjustmentCeres::removeLandmarkFromProblem(IndexT landmarkId, ceres::Problem& problem)
+{
+  double* landmarkBlockPtr = _landmarksBlocks.at(landmarkId).data();
 
-    // lens distortion
-    if(!refineIntrinsicsDistortion)
-      for(std::size_t i = 3; i < intrinsicBlock.size(); ++i)
-        constantIntrinisc.push_back(i);
+  // removing the parameter block also removes the attached residual blocks
+  problem.RemoveParameterBlock(landmarkBlockPtr);
 
-    if(!constantIntrinisc.empty())
-    {
-      ceres::SubsetParameterization* subsetParameterization = new ceres::SubsetParameterization(intrinsicBlock.size(), constantIntrinisc);
-      problem.SetParameterization(intrinsicBlockPtr, subsetParameterization);
-    }
+  if(_ceresOptions.useParametersOrdering)
+    _ceresOptions.linearSolverOrdering.Remove(landmarkBlockPtr);
 
-    _statistics.addState(EParameter::INTRINSIC, EParameterState::REFINED);
-  }
+  _landmarksBlocks.erase(landmarkId);
+  _landmarksObservingViews.erase(landmarkId);
 }
 
 void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem)
 {
-  const bool refineStructure = refineOptions & REFINE_STRUCTURE;
-
-  // set a LossFunction to be less penalized by false measurements.
-  // note: set it to NULL if you don't want use a lossFunction.
-  ceres::LossFunction* lossFunction = new ceres::HuberLoss(Square(4.0)); // TODO: make the LOSS function and the parameter an option
-
   // build the residual blocks corresponding to the track observations
   for(const auto& landmarkPair: sfmData.getLandmarks())
   {
     const IndexT landmarkId = landmarkPair.first;
-    const sfmData::Landmark& landmark = landmarkPair.second;
 
     // do not create a residual block if the landmark
     // have been set as Ignored by the Local BA strategy
@@ -502,73 +623,7 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
       continue;
     }
 
-    std::array<double,3>& landmarkBlock = _landmarksBlocks[landmarkId];
-    for(std::size_t i = 0; i < 3; ++i)
-      landmarkBlock.at(i) = landmark.X(Eigen::Index(i));
-
-    double* landmarkBlockPtr = landmarkBlock.data();
-
-    // add landmark parameter to the all parameters blocks pointers list
-    _allParametersBlocks.push_back(landmarkBlockPtr);
-
-    // iterate over 2D observation associated to the 3D landmark
-    for(const auto& observationPair: landmark.observations)
-    {
-      const sfmData::View& view = sfmData.getView(observationPair.first);
-      const sfmData::Observation& observation = observationPair.second;
-
-      // each residual block takes a point and a camera as input and outputs a 2
-      // dimensional residual. Internally, the cost function stores the observed
-      // image location and compares the reprojection against the observation.
-
-      assert(getPoseState(view.getPoseId()) != EParameterState::IGNORED);
-      assert(getIntrinsicState(view.getIntrinsicId()) != EParameterState::IGNORED);
-
-      // needed parameters to create a residual block (K, pose)
-      double* poseBlockPtr = _posesBlocks.at(view.getPoseId()).data();
-      double* intrinsicBlockPtr = _intrinsicsBlocks.at(view.getIntrinsicId()).data();
-
-      // apply a specific parameter ordering:
-      if(_ceresOptions.useParametersOrdering)
-      {
-        _ceresOptions.linearSolverOrdering.AddElementToGroup(landmarkBlockPtr, 0);
-        _ceresOptions.linearSolverOrdering.AddElementToGroup(poseBlockPtr, 1);
-        _ceresOptions.linearSolverOrdering.AddElementToGroup(intrinsicBlockPtr, 2);
-      }
-
-      if(view.isPartOfRig() && !view.isPoseIndependant())
-      {
-        ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation.x);
-
-        problem.AddResidualBlock(costFunction,
-            lossFunction,
-            intrinsicBlockPtr,
-            poseBlockPtr,
-            _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data(), // subpose of the cameras rig
-            landmarkBlockPtr); // do we need to copy 3D point to avoid false motion, if failure ?
-      }
-      else
-      {
-        ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation.x);
-
-        problem.AddResidualBlock(costFunction,
-            lossFunction,
-            intrinsicBlockPtr,
-            poseBlockPtr,
-            landmarkBlockPtr); //do we need to copy 3D point to avoid false motion, if failure ?
-      }
-
-      if(!refineStructure || getLandmarkState(landmarkId) == EParameterState::CONSTANT)
-      {
-        // set the whole landmark parameter block as constant.
-        _statistics.addState(EParameter::LANDMARK, EParameterState::CONSTANT);
-        problem.SetParameterBlockConstant(landmarkBlockPtr);
-      }
-      else
-      {
-        _statistics.addState(EParameter::LANDMARK, EParameterState::REFINED);
-      }
-    }
+    addLandmarkToProblem(sfmData, landmarkId, refineOptions, problem);
   }
 }
 
@@ -593,6 +648,179 @@ void BundleAdjustmentCeres::createProblem(const sfmData::SfMData& sfmData,
   addLandmarksToProblem(sfmData, refineOptions, problem);
 }
 
+bool BundleAdjustmentCeres::canUpdateProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions) const
+{
+  // no problem built yet
+  if(_problem == nullptr)
+    return false;
+
+  // the refine flags drive which parameters are constant, a change requires a rebuild
+  if(refineOptions != _problemRefineOptions)
+    return false;
+
+  // with the local strategy the parameter states change at each call
+  if(useLocalStrategy())
+    return false;
+
+  // rig sub-pose blocks appear when sub-poses get initialized, their status can
+  // also switch to constant: always rebuild when the scene contains rigs
+  if(!sfmData.getRigs().empty() || !_rigBlocks.empty())
+    return false;
+
+  // a removed pose or intrinsic invalidates the residual blocks bookkeeping
+  for(const auto& poseBlockPair : _posesBlocks)
+    if(sfmData.getPoses().count(poseBlockPair.first) == 0)
+      return false;
+
+  for(const auto& intrinsicBlockPair : _intrinsicsBlocks)
+    if(sfmData.getIntrinsics().count(intrinsicBlockPair.first) == 0)
+      return false;
+
+  return true;
+}
+
+void BundleAdjustmentCeres::buildProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+  // the persistent problem references the parameter blocks and the loss function,
+  // destroy it before clearing them
+  _problem.reset();
+  resetProblem();
+
+  // set a LossFunction to be less penalized by false measurements.
+  // note: set it to NULL if you don't want use a lossFunction.
+  _lossFunction.reset(new ceres::HuberLoss(Square(4.0))); // TODO: make the LOSS function and the parameter an option
+
+  ceres::Problem::Options problemOptions;
+  problemOptions.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+  problemOptions.enable_fast_removal = true; // cheap residual / parameter block removal in updateProblem()
+
+  _problem.reset(new ceres::Problem(problemOptions));
+
+  createProblem(sfmData, refineOptions, *_problem);
+
+  _problemRefineOptions = refineOptions;
+}
+
+void BundleAdjustmentCeres::updateProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+  ceres::Problem& problem = *_problem;
+
+  const bool refineTranslation = refineOptions & REFINE_TRANSLATION;
+  const bool refineRotation = refineOptions & REFINE_ROTATION;
+  const bool refineStructure = refineOptions & REFINE_STRUCTURE;
+  const bool refineIntrinsicsOpticalCenter = (refineOptions & REFINE_INTRINSICS_OPTICALCENTER_ALWAYS) || (refineOptions & REFINE_INTRINSICS_OPTICALCENTER_IF_ENOUGH_DATA);
+  const bool refineIntrinsics = (refineOptions & REFINE_INTRINSICS_FOCAL) || (refineOptions & REFINE_INTRINSICS_DISTORTION) || refineIntrinsicsOpticalCenter;
+
+  // clear the previous iteration statistics, the parameter states are recounted below
+  _statistics = Statistics();
+
+  // add the newly reconstructed poses, refresh the values of the existing blocks
+  for(const auto& posePair : sfmData.getPoses())
+  {
+    const IndexT poseId = posePair.first;
+    const sfmData::CameraPose& pose = posePair.second;
+
+    const auto poseBlockIt = _posesBlocks.find(poseId);
+
+    if(poseBlockIt == _posesBlocks.end())
+    {
+      addPoseToProblem(pose, false, refineOptions, _posesBlocks[poseId], problem);
+      continue;
+    }
+
+    setPoseBlock(pose, poseBlockIt->second);
+
+    _statistics.addState(EParameter::POSE, (pose.isLocked() || (!refineTranslation && !refineRotation)) ?
+                         EParameterState::CONSTANT : EParameterState::REFINED);
+  }
+
+  // count the number of reconstructed views per intrinsic
+  const std::map<IndexT, std::size_t> intrinsicsUsage = countIntrinsicsUsage(sfmData);
+
+  // add the intrinsics entering the problem, refresh the values of the existing blocks
+  for(const auto& intrinsicPair : sfmData.getIntrinsics())
+  {
+    const IndexT intrinsicId = intrinsicPair.first;
+    const std::size_t usageCount = intrinsicsUsage.at(intrinsicId);
+
+    const auto intrinsicBlockIt = _intrinsicsBlocks.find(intrinsicId);
+
+    if(intrinsicBlockIt == _intrinsicsBlocks.end())
+    {
+      // an intrinsic enters the problem when its first view gets reconstructed
+      if(usageCount > 0)
+        addIntrinsicToProblem(sfmData, intrinsicId, usageCount, refineOptions, problem);
+      else
+        _statistics.addState(EParameter::INTRINSIC, EParameterState::IGNORED);
+      continue;
+    }
+
+    const std::vector<double> intrinsicParams = intrinsicPair.second->getParams();
+    assert(intrinsicBlockIt->second.size() == intrinsicParams.size());
+    std::copy(intrinsicParams.begin(), intrinsicParams.end(), intrinsicBlockIt->second.begin());
+
+    _statistics.addState(EParameter::INTRINSIC, (intrinsicPair.second->isLocked() || !refineIntrinsics) ?
+                         EParameterState::CONSTANT : EParameterState::REFINED);
+  }
+
+  // remove the landmarks erased from the scene by the outlier filtering
+  std::vector<IndexT> removedLandmarkIds;
+  for(const auto& landmarkBlockPair : _landmarksBlocks)
+    if(sfmData.getLandmarks().count(landmarkBlockPair.first) == 0)
+      removedLandmarkIds.push_back(landmarkBlockPair.first);
+
+  for(const IndexT landmarkId : removedLandmarkIds)
+    removeLandmarkFromProblem(landmarkId, problem);
+
+  // add the new landmarks, rebuild the ones whose observations changed,
+  // refresh the 3D positions of the others
+  for(const auto& landmarkPair : sfmData.getLandmarks())
+  {
+    const IndexT landmarkId = landmarkPair.first;
+    const sfmData::Landmark& landmark = landmarkPair.second;
+
+    const auto landmarkBlockIt = _landmarksBlocks.find(landmarkId);
+
+    if(landmarkBlockIt == _landmarksBlocks.end())
+    {
+      addLandmarkToProblem(sfmData, landmarkId, refineOptions, problem);
+      continue;
+    }
+
+    // compare the observing views with the ones in the problem (both sorted by view id)
+    const std::vector<IndexT>& observingViews = _landmarksObservingViews.at(landmarkId);
+    bool sameObservations = (observingViews.size() == landmark.observations.size());
+
+    if(sameObservations)
+    {
+      std::size_t observationIndex = 0;
+      for(const auto& observationPair : landmark.observations)
+      {
+        if(observingViews.at(observationIndex++) != observationPair.first)
+        {
+          sameObservations = false;
+          break;
+        }
+      }
+    }
+
+    if(!sameObservations)
+    {
+      // observations added or removed: rebuild the landmark residual blocks
+      removeLandmarkFromProblem(landmarkId, problem);
+      addLandmarkToProblem(sfmData, landmarkId, refineOptions, problem);
+      continue;
+    }
+
+    // refresh the 3D position
+    for(std::size_t i = 0; i < 3; ++i)
+      landmarkBlockIt->second.at(i) = landmark.X(Eigen::Index(i));
+
+    for(std::size_t i = 0; i < landmark.observations.size(); ++i)
+      _statistics.addState(EParameter::LANDMARK, refineStructure ? EParameterState::REFINED : EParameterState::CONSTANT);
+  }
+}
+
 void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefineOptions refineOptions) const
 {
   const bool refinePoses = (refineOptions & REFINE_ROTATION) || (refineOptions & REFINE_TRANSLATION);
@@ -680,8 +908,7 @@ void BundleAdjustmentCeres::createJacobian(const sfmData::SfMData& sfmData,
                                            ceres::CRSMatrix& jacobian)
 {
   // create problem
-  ceres::Problem problem;
-  createProblem(sfmData, refineOptions, problem);
+  buildProblem(sfmData, refineOptions);
 
   // configure Jacobian engine
   double cost = 0.0;
@@ -691,14 +918,18 @@ void BundleAdjustmentCeres::createJacobian(const sfmData::SfMData& sfmData,
   evalOpt.apply_loss_function = true;
 
   // create Jacobain
-  problem.Evaluate(evalOpt, &cost, NULL, NULL, &jacobian);
+  _problem->Evaluate(evalOpt, &cost, NULL, NULL, &jacobian);
 }
 
 bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
 {
-  // create problem
-  ceres::Problem problem;
-  createProblem(sfmData, refineOptions, problem);
+  // create or incrementally update the persistent problem:
+  // sequential SfM calls adjust() on a nearly identical scene at each iteration,
+  // rebuilding the whole problem each time is far more expensive than the update.
+  if(canUpdateProblem(sfmData, refineOptions))
+    updateProblem(sfmData, refineOptions);
+  else
+    buildProblem(sfmData, refineOptions);
 
   // configure a Bundle Adjustment engine and run it
   // make Ceres automatically detect the bundle structure.
@@ -707,7 +938,7 @@ bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions ref
 
   // solve BA
   ceres::Solver::Summary summary;
-  ceres::Solve(options, &problem, &summary);
+  ceres::Solve(options, _problem.get(), &summary);
 
   // print summary
   if(_ceresOptions.summary)
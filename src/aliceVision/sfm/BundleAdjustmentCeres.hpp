@@ -13,6 +13,8 @@
 
 #include <ceres/ceres.h>
 
+#include <memory>
+
 namespace aliceVision {
 
 namespace sfmData {
@@ -48,6 +50,9 @@ public:
     bool useParametersOrdering = true;
     bool summary = false;
     bool verbose = true;
+    /// opt-in: use the hand-derived jacobians for distortion-free pinhole intrinsics
+    /// instead of automatic differentiation (other models always use autodiff)
+    bool useAnalyticPinholeCost = false;
   };
 
   /**
@@ -163,6 +168,7 @@ private:
 
   /**
    * @brief Clear structures for a new problem
+   * @note The persistent Ceres problem references the parameter blocks, it must be destroyed beforehand.
    */
   inline void resetProblem()
   {
@@ -173,14 +179,79 @@ private:
     _intrinsicsBlocks.clear();
     _landmarksBlocks.clear();
     _rigBlocks.clear();
+    _landmarksObservingViews.clear();
+    _ceresOptions.linearSolverOrdering.Clear();
   }
 
+  /**
+   * @brief Return true if the persistent Ceres problem can be incrementally updated with the given scene.
+   *  An incremental update is possible when the problem has already been built with the same refine flags,
+   *  no local strategy is used (the parameter states change at each call) and no parameter block disappeared.
+   * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] refineOptions The chosen refine flag
+   * @return true if updateProblem() can be used instead of buildProblem()
+   */
+  bool canUpdateProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions) const;
+
+  /**
+   * @brief Build the persistent Ceres problem from scratch.
+   * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] refineOptions The chosen refine flag
+   */
+  void buildProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions);
+
+  /**
+   * @brief Incrementally update the persistent Ceres problem:
+   *  - add the newly reconstructed poses, intrinsics and landmarks
+   *  - remove the landmarks erased by the outlier filtering
+   *  - refresh the values of the existing parameter blocks
+   * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] refineOptions The chosen refine flag
+   */
+  void updateProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions);
+
   /**
    * @brief Set user Ceres options to the solver
    * @param[in,out] solverOptions The solver options structure
    */
   void setSolverOptions(ceres::Solver::Options& solverOptions) const;
 
+  /**
+   * @brief Create a parameter block for one pose according to the Ceres format: [Rx, Ry, Rz, tx, ty, tz]
+   * @param[in] cameraPose The camera pose
+   * @param[in] isConstant true if the pose is set as constant by the Local strategy
+   * @param[in] refineOptions The chosen refine flag
+   * @param[out] poseBlock The pose parameter block wrapper
+   * @param[out] problem The Ceres bundle adjustement problem
+   */
+  void addPoseToProblem(const sfmData::CameraPose& cameraPose, bool isConstant, ERefineOptions refineOptions, std::array<double,6>& poseBlock, ceres::Problem& problem);
+
+  /**
+   * @brief Create a parameter block for one intrinsic according to the Ceres format
+   * @param[in] sfmData The input SfMData contains all the information about the reconstruction, notably the intrinsics
+   * @param[in] intrinsicId The intrinsic id
+   * @param[in] usageCount The number of reconstructed views using this intrinsic
+   * @param[in] refineOptions The chosen refine flag
+   * @param[out] problem The Ceres bundle adjustement problem
+   */
+  void addIntrinsicToProblem(const sfmData::SfMData& sfmData, IndexT intrinsicId, std::size_t usageCount, ERefineOptions refineOptions, ceres::Problem& problem);
+
+  /**
+   * @brief Create a parameter block and the observation residual blocks for one landmark
+   * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] landmarkId The landmark id
+   * @param[in] refineOptions The chosen refine flag
+   * @param[out] problem The Ceres bundle adjustement problem
+   */
+  void addLandmarkToProblem(const sfmData::SfMData& sfmData, IndexT landmarkId, ERefineOptions refineOptions, ceres::Problem& problem);
+
+  /**
+   * @brief Remove the parameter block and the residual blocks of one landmark from the problem
+   * @param[in] landmarkId The landmark id
+   * @param[out] problem The Ceres bundle adjustement problem
+   */
+  void removeLandmarkFromProblem(IndexT landmarkId, ceres::Problem& problem);
+
   /**
    * @brief Create a parameter block for each extrinsics according to the Ceres format: [Rx, Ry, Rz, tx, ty, tz]
    * @param[in] sfmData The input SfMData contains all the information about the reconstruction, notably the poses and sub-poses
@@ -263,6 +334,15 @@ private:
   /// last adjustment iteration statisics
   Statistics _statistics;
 
+  /// persistent Ceres problem, incrementally updated between adjust() calls when possible
+  std::unique_ptr<ceres::Problem> _problem;
+
+  /// loss function shared by all residual blocks (owned here, the problem does not take ownership)
+  std::unique_ptr<ceres::LossFunction> _lossFunction;
+
+  /// refine flags used to build the persistent problem
+  ERefineOptions _problemRefineOptions = REFINE_NONE;
+
   // data wrappers for refinement
 
   /// all parameters blocks pointers
@@ -279,6 +359,9 @@ private:
   /// rig sub-poses blocks wrapper
   /// block: ceres angleAxis(3) + translation(3)
   HashMap<IndexT, HashMap<IndexT, std::array<double,6>>> _rigBlocks;
+  /// ids of the views observing each landmark in the problem (sorted)
+  /// used to detect observation changes between adjust() calls
+  HashMap<IndexT, std::vector<IndexT>> _landmarksObservingViews;
 };
 
 } // namespace sfm
@@ -0,0 +1,216 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/BundleAdjustmentPCG.hpp>
+#include <aliceVision/sfm/BundleAdjustmentCeres.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <ceres/rotation.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+namespace aliceVision {
+namespace sfm {
+
+using namespace aliceVision::camera;
+using namespace aliceVision::geometry;
+
+void BundleAdjustmentPCG::Statistics::show() const
+{
+  ALICEVISION_LOG_INFO("GPU bundle adjustment statistics:" << std::endl
+    << "\t- adjustment took: " << std::fixed << std::setprecision(2) << time << " s" << std::endl
+    << "\t- ran on device: " << (ranOnDevice ? "yes" : "no (Ceres backend)") << std::endl
+    << "\t- # observations: " << nbObservations << std::endl
+    << "\t- # successful iterations: " << nbSuccessfullIterations << std::endl
+    << "\t- # unsuccessful iterations: " << nbUnsuccessfullIterations << std::endl
+    << "\t- initial RMSE: " << RMSEinitial << std::endl
+    << "\t- final RMSE: " << RMSEfinal);
+}
+
+bool BundleAdjustmentPCG::isSupported(const sfmData::SfMData& sfmData, ERefineOptions refineOptions) const
+{
+  if(refineOptions != (REFINE_ROTATION | REFINE_TRANSLATION | REFINE_STRUCTURE))
+  {
+    ALICEVISION_LOG_DEBUG("The GPU bundle adjustment backend only refines poses and structure, "
+                          "use the Ceres backend for the requested refine options.");
+    return false;
+  }
+
+  if(!sfmData.getRigs().empty())
+  {
+    ALICEVISION_LOG_DEBUG("The GPU bundle adjustment backend does not handle rigs, use the Ceres backend.");
+    return false;
+  }
+
+  if(sfmData.getPoses().size() < _options.minNbPosesForGPU)
+  {
+    ALICEVISION_LOG_DEBUG("Not enough poses (" << sfmData.getPoses().size() << " < " << _options.minNbPosesForGPU
+                          << ") to amortize the GPU transfers, use the Ceres backend.");
+    return false;
+  }
+
+  for(const auto& intrinsicPair : sfmData.getIntrinsics())
+  {
+    switch(intrinsicPair.second->getType())
+    {
+      case PINHOLE_CAMERA:
+      case PINHOLE_CAMERA_RADIAL1:
+      case PINHOLE_CAMERA_RADIAL3:
+        break;
+      default:
+        ALICEVISION_LOG_DEBUG("Intrinsic " << intrinsicPair.first << " is not a radial distortion pinhole model, "
+                              "use the Ceres backend.");
+        return false;
+    }
+  }
+
+  if(cuda::getDeviceCount() < 1)
+  {
+    ALICEVISION_LOG_WARNING("No CUDA device available for the GPU bundle adjustment, use the Ceres backend.");
+    return false;
+  }
+
+  return true;
+}
+
+bool BundleAdjustmentPCG::adjustWithCeres(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+  BundleAdjustmentCeres::CeresOptions options;
+
+  if(sfmData.getPoses().size() > 100)
+    options.setSparseBA();
+  else
+    options.setDenseBA();
+
+  BundleAdjustmentCeres BA(options);
+  const bool success = BA.adjust(sfmData, refineOptions);
+
+  const BundleAdjustmentCeres::Statistics& ceresStatistics = BA.getStatistics();
+  _statistics.ranOnDevice = false;
+  _statistics.nbSuccessfullIterations = ceresStatistics.nbSuccessfullIterations;
+  _statistics.nbUnsuccessfullIterations = ceresStatistics.nbUnsuccessfullIterations;
+  _statistics.nbObservations = ceresStatistics.nbResidualBlocks;
+  _statistics.RMSEinitial = ceresStatistics.RMSEinitial;
+  _statistics.RMSEfinal = ceresStatistics.RMSEfinal;
+  _statistics.time = ceresStatistics.time;
+
+  return success;
+}
+
+bool BundleAdjustmentPCG::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+  _statistics = Statistics();
+
+  if(!isSupported(sfmData, refineOptions))
+    return adjustWithCeres(sfmData, refineOptions);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  // build the device problem: one device camera per reconstructed pose
+  std::map<IndexT, int> poseIdToCamera;
+  std::vector<cuda::Camera> cameras;
+  std::vector<double> points;
+  std::vector<IndexT> landmarkIds; //< landmark of each device point, for the write back
+  std::vector<cuda::Observation> observations;
+
+  for(const auto& landmarkPair : sfmData.getLandmarks())
+  {
+    const sfmData::Landmark& landmark = landmarkPair.second;
+    const int pointIndex = int(points.size() / 3);
+    std::size_t nbPointObservations = 0;
+
+    for(const auto& observationPair : landmark.observations)
+    {
+      const sfmData::View& view = *(sfmData.getViews().at(observationPair.first));
+
+      if(!sfmData.isPoseAndIntrinsicDefined(&view))
+        continue;
+
+      auto cameraIt = poseIdToCamera.find(view.getPoseId());
+      if(cameraIt == poseIdToCamera.end())
+      {
+        const geometry::Pose3& pose = sfmData.getPoses().at(view.getPoseId()).getTransform();
+        const std::vector<double> intrinsicParams = sfmData.getIntrinsics().at(view.getIntrinsicId())->getParams();
+
+        cuda::Camera camera;
+        const Mat3& R = pose.rotation();
+        const Vec3& t = pose.translation();
+        ceres::RotationMatrixToAngleAxis(static_cast<const double*>(R.data()), camera.angleAxis);
+        for(int k = 0; k < 3; ++k)
+        {
+          camera.translation[k] = t(k);
+          camera.distortion[k] = (std::size_t(3 + k) < intrinsicParams.size()) ? intrinsicParams.at(3 + k) : 0.0;
+        }
+        camera.focal = intrinsicParams.at(0);
+        camera.principalPoint[0] = intrinsicParams.at(1);
+        camera.principalPoint[1] = intrinsicParams.at(2);
+
+        cameraIt = poseIdToCamera.emplace(view.getPoseId(), int(cameras.size())).first;
+        cameras.push_back(camera);
+      }
+
+      cuda::Observation observation;
+      observation.cameraIndex = cameraIt->second;
+      observation.pointIndex = pointIndex;
+      observation.x = observationPair.second.x(0);
+      observation.y = observationPair.second.x(1);
+      observations.push_back(observation);
+      ++nbPointObservations;
+    }
+
+    if(nbPointObservations == 0)
+      continue; // the landmark is not observed by any reconstructed view
+
+    points.push_back(landmark.X(0));
+    points.push_back(landmark.X(1));
+    points.push_back(landmark.X(2));
+    landmarkIds.push_back(landmarkPair.first);
+  }
+
+  ALICEVISION_LOG_DEBUG("GPU bundle adjustment problem: " << cameras.size() << " cameras, "
+                        << landmarkIds.size() << " points, " << observations.size() << " observations.");
+
+  cuda::SolverSummary summary;
+  if(!cuda::refinePosesAndStructure(_options.deviceId, cameras, points, observations, _options.solver, summary))
+  {
+    ALICEVISION_LOG_WARNING("The GPU bundle adjustment failed on device " << _options.deviceId
+                            << ", falling back to the Ceres backend.");
+    return adjustWithCeres(sfmData, refineOptions);
+  }
+
+  // update the scene from the solution
+  for(const auto& poseIndexPair : poseIdToCamera)
+  {
+    const cuda::Camera& camera = cameras.at(poseIndexPair.second);
+
+    Mat3 R_refined;
+    ceres::AngleAxisToRotationMatrix(camera.angleAxis, R_refined.data());
+    const Vec3 t_refined(camera.translation[0], camera.translation[1], camera.translation[2]);
+
+    sfmData.getPoses().at(poseIndexPair.first).setTransform(poseFromRT(R_refined, t_refined));
+  }
+
+  for(std::size_t i = 0; i < landmarkIds.size(); ++i)
+    sfmData.getLandmarks().at(landmarkIds.at(i)).X = Vec3(points.at(3 * i), points.at(3 * i + 1), points.at(3 * i + 2));
+
+  const std::size_t nbResiduals = 2 * observations.size();
+  _statistics.ranOnDevice = true;
+  _statistics.nbSuccessfullIterations = summary.nbSuccessfulIterations;
+  _statistics.nbUnsuccessfullIterations = summary.nbUnsuccessfulIterations;
+  _statistics.nbObservations = observations.size();
+  _statistics.RMSEinitial = std::sqrt(summary.initialCost / nbResiduals);
+  _statistics.RMSEfinal = std::sqrt(summary.finalCost / nbResiduals);
+  _statistics.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  return true;
+}
+
+} // namespace sfm
+} // namespace aliceVision
@@ -0,0 +1,136 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/sfm/BundleAdjustment.hpp>
+#include <aliceVision/sfm/cuda/bundleAdjustmentCuda.hpp>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+} // namespace sfmData
+
+namespace sfm {
+
+/**
+ * @brief GPU bundle adjustment backend: Levenberg-Marquardt with a matrix-free
+ * Jacobi preconditioned conjugate gradient on CUDA (PBA-style).
+ *
+ * The backend refines the camera poses and the structure; the intrinsics are
+ * held constant on the device. Scenes the device solver does not support
+ * (intrinsics refinement requested, rigs, non-radial distortion models, no
+ * CUDA device) are transparently delegated to BundleAdjustmentCeres, so it
+ * can be used per call wherever the interface is: typically the large final
+ * adjustments run on GPU while the small local ones stay on the Ceres
+ * backend.
+ */
+class BundleAdjustmentPCG : public BundleAdjustment
+{
+public:
+
+  /**
+   * @brief Contains all GPU solver parameters.
+   */
+  struct PCGOptions
+  {
+    PCGOptions()
+    {}
+
+    /// CUDA device to run on
+    int deviceId = 0;
+    /// solver parameters forwarded to the device
+    cuda::SolverOptions solver;
+    /// minimum number of poses under which the Ceres backend is used (the
+    /// transfer and launch overhead does not pay off on small problems)
+    std::size_t minNbPosesForGPU = 100;
+  };
+
+  /**
+   * @brief Contains all informations related to the performed bundle adjustment.
+   */
+  struct Statistics
+  {
+    /// true if the adjustment ran on the device, false if it was delegated to Ceres
+    bool ranOnDevice = false;
+    /// number of successful iterations
+    std::size_t nbSuccessfullIterations = 0;
+    /// number of unsuccessful iterations
+    std::size_t nbUnsuccessfullIterations = 0;
+    /// number of observations in the problem
+    std::size_t nbObservations = 0;
+    /// RMSEinitial: sqrt(initial_cost / num_residuals)
+    double RMSEinitial = 0.0;
+    /// RMSEfinal: sqrt(final_cost / num_residuals)
+    double RMSEfinal = 0.0;
+    /// time spent to solve the BA (s)
+    double time = 0.0;
+
+    /**
+     * @brief Display statistics about the bundle adjustment in the terminal
+     *  Logger need to accept <info> log level
+     */
+    void show() const;
+  };
+
+  /**
+   * @brief Bundle adjustment constructor
+   * @param[in] options The user GPU solver options
+   * @see BundleAdjustmentPCG::PCGOptions
+   */
+  BundleAdjustmentPCG(const PCGOptions& options = PCGOptions())
+    : _options(options)
+  {}
+
+  /**
+   * @brief Perform a Bundle Adjustment on the SfM scene with refinement of the requested parameters
+   * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] refineOptions The chosen refine flag
+   * @return false if the bundle adjustment failed else true
+   * @see BundleAdjustment::Adjust
+   */
+  bool adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions = REFINE_ALL);
+
+  /**
+   * @brief Get bundle adjustment statistics structure
+   * @return statistics structure const ref
+   */
+  inline const Statistics& getStatistics() const
+  {
+    return _statistics;
+  }
+
+private:
+
+  /**
+   * @brief Return true if the scene and the refine flags are supported by the
+   * device solver, log the reason of the delegation to Ceres otherwise.
+   * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] refineOptions The chosen refine flag
+   */
+  bool isSupported(const sfmData::SfMData& sfmData, ERefineOptions refineOptions) const;
+
+  /**
+   * @brief Delegate the adjustment to the Ceres backend
+   * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
+   * @param[in] refineOptions The chosen refine flag
+   * @return false if the bundle adjustment failed else true
+   */
+  bool adjustWithCeres(sfmData::SfMData& sfmData, ERefineOptions refineOptions);
+
+  // private members
+
+  /// user GPU solver options
+  PCGOptions _options;
+
+  /// last adjustment statistics
+  Statistics _statistics;
+};
+
+} // namespace sfm
+} // namespace aliceVision
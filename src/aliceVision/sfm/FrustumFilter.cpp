@@ -78,6 +78,69 @@ PairSet FrustumFilter::getFrustumIntersectionPairs() const
   std::transform(z_near_z_far_perView.begin(), z_near_z_far_perView.end(),
     std::back_inserter(viewIds), stl::RetrieveKey());
 
+  // Broad phase for truncated frustums: their supporting points bound the
+  // volume, so sort the frustum bounding boxes along X and only run the exact
+  // half-plane test on the pairs whose boxes overlap. Infinite frustums are
+  // unbounded and keep the exhaustive comparison below.
+  if (_bTruncated)
+  {
+    struct FrustumBox
+    {
+      Vec3 bbMin, bbMax;
+      IndexT viewId;
+    };
+    std::vector<FrustumBox> boxes;
+    boxes.reserve(viewIds.size());
+    for (const IndexT viewId : viewIds)
+    {
+      const std::vector<Vec3> & points = frustum_perView.at(viewId).frustum_points();
+      FrustumBox box;
+      box.bbMin = points[0];
+      box.bbMax = points[0];
+      for (std::size_t i = 1; i < points.size(); ++i)
+      {
+        box.bbMin = box.bbMin.cwiseMin(points[i]);
+        box.bbMax = box.bbMax.cwiseMax(points[i]);
+      }
+      box.viewId = viewId;
+      boxes.push_back(box);
+    }
+    std::sort(boxes.begin(), boxes.end(),
+      [](const FrustumBox & a, const FrustumBox & b) { return a.bbMin.x() < b.bbMin.x(); });
+
+    boost::progress_display my_progress_bar(
+      boxes.size(), std::cout, "\nCompute frustum intersection\n");
+
+    #pragma omp parallel for
+    for (int i = 0; i < (int)boxes.size(); ++i)
+    {
+      const FrustumBox & a = boxes[i];
+      const geometry::Frustum & frustum_a = frustum_perView.at(a.viewId);
+      // boxes are sorted along X: stop as soon as the next box starts after ours ends
+      for (std::size_t j = i+1; j < boxes.size() && boxes[j].bbMin.x() <= a.bbMax.x(); ++j)
+      {
+        const FrustumBox & b = boxes[j];
+        if (b.bbMin.y() > a.bbMax.y() || b.bbMax.y() < a.bbMin.y() ||
+            b.bbMin.z() > a.bbMax.z() || b.bbMax.z() < a.bbMin.z())
+          continue;
+        if (frustum_a.intersect(frustum_perView.at(b.viewId)))
+        {
+          #pragma omp critical
+          {
+            pairs.insert(std::make_pair(std::min(a.viewId, b.viewId),
+                                        std::max(a.viewId, b.viewId)));
+          }
+        }
+      }
+      // Progress bar update
+      #pragma omp critical
+      {
+        ++my_progress_bar;
+      }
+    }
+    return pairs;
+  }
+
   boost::progress_display my_progress_bar(
     viewIds.size() * (viewIds.size()-1)/2,
     std::cout, "\nCompute frustum intersection\n");
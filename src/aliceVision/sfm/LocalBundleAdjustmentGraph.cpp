@@ -280,19 +280,35 @@ void LocalBundleAdjustmentGraph::computeGraphDistances(const sfmData::SfMData& s
     else
       bfs.addSource(it->second);
   }
-  bfs.start();
-  
+
+  // only the distances inside the active region are meaningful: every view
+  // beyond 'distanceLimit' is ignored by getStateFromDistance() whatever its
+  // exact distance is. The BFS processes the nodes by increasing distance, so
+  // it can stop at the boundary instead of walking the whole graph: the
+  // remaining (converged) parts of the reconstruction are left untouched.
+  const int distanceLimit = _graphDistanceLimit + 1;
+  while(!bfs.emptyQueue())
+  {
+    const lemon::ListGraph::Node node = bfs.processNextNode();
+    if(bfs.dist(node) > distanceLimit)
+      break;
+  }
+
   // handle bfs results (distances)
   for(const auto& x : _nodePerViewId) // each node in the graph
   {
     auto& node = x.second;
-    int d = -1; 
-    
+    int d = -1;
+
     if(bfs.reached(node))
     {
       d = bfs.dist(node);
       // dist(): "If node v is not reached from the root(s), then the return value of this function is undefined."
       // this is why the distance is previously set to -1.
+
+      // a reached node beyond the boundary has the same (ignored) state as an unreached one
+      if(d > distanceLimit)
+        d = -1;
     }
     _distancePerViewId[x.first] = d;
   }
@@ -604,30 +620,34 @@ std::size_t LocalBundleAdjustmentGraph::addIntrinsicEdgesToTheGraph(const sfmDat
 {
   std::size_t numAddedEdges = 0;
 
+  // group the reconstructed views of the graph by intrinsic once,
+  // instead of scanning the whole graph for every new view
+  std::map<IndexT, std::vector<IndexT>> viewIdsPerIntrinsicId;
+  for(const auto& x : _nodePerViewId)
+    viewIdsPerIntrinsicId[sfmData.getViews().at(x.first)->getIntrinsicId()].push_back(x.first);
+
   for(IndexT newViewId : newReconstructedViews) // for each new view
   {
     IndexT newViewIntrinsicId = sfmData.getViews().at(newViewId)->getIntrinsicId();
-    
+
     if(isFocalLengthConstant(newViewIntrinsicId)) // do not add edges for a constant intrinsic
       continue;
 
-    for(const auto& x : _nodePerViewId) // for each reconstructed view in the graph
+    const auto groupIt = viewIdsPerIntrinsicId.find(newViewIntrinsicId);
+    if(groupIt == viewIdsPerIntrinsicId.end())
+      continue;
+
+    for(const IndexT reconstructedViewId : groupIt->second)
     {
-      if(newViewId == x.first)  // do not compare a view with itself
+      if(newViewId == reconstructedViewId)  // do not compare a view with itself
         continue;
-      
-      const IndexT reconstructedViewIntrinsicId = sfmData.getViews().at(x.first)->getIntrinsicId();
-      
-      // if the new view share the same intrinsic than previously reconstructed views
-      if(reconstructedViewIntrinsicId == newViewIntrinsicId)
-      {
-        const IndexT minId = std::min(x.first, newViewId);
-        const IndexT maxId = std::max(x.first, newViewId);
-        
-        lemon::ListGraph::Edge edge = _graph.addEdge(_nodePerViewId[minId], _nodePerViewId[maxId]);
-        _intrinsicEdgesId[newViewIntrinsicId].push_back(_graph.id(edge));
-        numAddedEdges++;
-      }
+
+      const IndexT minId = std::min(reconstructedViewId, newViewId);
+      const IndexT maxId = std::max(reconstructedViewId, newViewId);
+
+      lemon::ListGraph::Edge edge = _graph.addEdge(_nodePerViewId[minId], _nodePerViewId[maxId]);
+      _intrinsicEdgesId[newViewIntrinsicId].push_back(_graph.id(edge));
+      numAddedEdges++;
     }
   }
   return numAddedEdges;
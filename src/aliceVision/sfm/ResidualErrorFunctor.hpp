@@ -10,6 +10,7 @@
 #include <aliceVision/camera/camera.hpp>
 
 #include <ceres/rotation.h>
+#include <ceres/sized_cost_function.h>
 
 // Define ceres Cost_functor for each AliceVision camera model
 
@@ -164,6 +165,105 @@ struct ResidualErrorFunctor_Pinhole
   double m_pos_2dpoint[2]; // The 2D observation
 };
 
+/**
+ * @brief Analytically differentiated version of ResidualErrorFunctor_Pinhole <2,3,6,3>.
+ *
+ * The jacobians are hand-derived instead of using automatic differentiation:
+ * the residual evaluation stays scalar but the derivative blocks are computed
+ * with fixed-size Eigen expressions, which removes the Jet arithmetic overhead
+ * that dominates jacobian evaluation for the distortion-free model.
+ * The derivative of the angle axis rotation follows Gallego & Yezzi,
+ * "A compact formula for the derivative of a 3-D rotation in exponential coordinates".
+ */
+class ResidualErrorAnalyticCostFunction_Pinhole : public ceres::SizedCostFunction<2, 3, 6, 3>
+{
+public:
+  explicit ResidualErrorAnalyticCostFunction_Pinhole(const double* const pos_2dpoint)
+  {
+    m_pos_2dpoint[0] = pos_2dpoint[0];
+    m_pos_2dpoint[1] = pos_2dpoint[1];
+  }
+
+  bool Evaluate(double const* const* parameters, double* residuals, double** jacobians) const override
+  {
+    const double* cam_K = parameters[0];
+    const double* cam_Rt = parameters[1];
+
+    const double& focal = cam_K[0];
+    const double& principal_point_x = cam_K[1];
+    const double& principal_point_y = cam_K[2];
+
+    const Eigen::Map<const Vec3> angleAxis(cam_Rt);
+    const Eigen::Map<const Vec3> translation(&cam_Rt[3]);
+    const Eigen::Map<const Vec3> point(parameters[2]);
+
+    Mat3 R;
+    ceres::AngleAxisToRotationMatrix(cam_Rt, R.data());
+
+    const Vec3 pos_rot = R * point;
+    const Vec3 pos_proj = pos_rot + translation;
+
+    const double iz = 1.0 / pos_proj(2);
+    const double x_u = pos_proj(0) * iz;
+    const double y_u = pos_proj(1) * iz;
+
+    residuals[0] = principal_point_x + focal * x_u - m_pos_2dpoint[0];
+    residuals[1] = principal_point_y + focal * y_u - m_pos_2dpoint[1];
+
+    if(jacobians == nullptr)
+      return true;
+
+    // jacobian of the perspective division, scaled by the focal length
+    Eigen::Matrix<double, 2, 3> J_proj;
+    J_proj << focal * iz, 0.0,        -focal * x_u * iz,
+              0.0,        focal * iz, -focal * y_u * iz;
+
+    if(jacobians[0] != nullptr) // intrinsics [focal, ppx, ppy]
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[0]);
+      J << x_u, 1.0, 0.0,
+           y_u, 0.0, 1.0;
+    }
+
+    if(jacobians[1] != nullptr) // pose [rX, rY, rZ, tx, ty, tz]
+    {
+      // derivative of R(angleAxis) * point with respect to the angle axis
+      Mat3 dRp;
+      const double theta2 = angleAxis.squaredNorm();
+      if(theta2 > Eigen::NumTraits<double>::epsilon())
+      {
+        const Mat3 ImR = Mat3::Identity() - R;
+        for(int i = 0; i < 3; ++i)
+        {
+          const Vec3 a = angleAxis(i) * angleAxis + angleAxis.cross(ImR.col(i));
+          dRp.col(i) = a.cross(pos_rot) / theta2;
+        }
+      }
+      else
+      {
+        // limit at zero rotation
+        for(int i = 0; i < 3; ++i)
+          dRp.col(i) = Vec3::Unit(i).cross(pos_rot);
+      }
+
+      Eigen::Map<Eigen::Matrix<double, 2, 6, Eigen::RowMajor>> J(jacobians[1]);
+      J.leftCols<3>() = J_proj * dRp;
+      J.rightCols<3>() = J_proj;
+    }
+
+    if(jacobians[2] != nullptr) // 3D point
+    {
+      Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[2]);
+      J = J_proj * R;
+    }
+
+    return true;
+  }
+
+private:
+  double m_pos_2dpoint[2]; // The 2D observation
+};
+
 /**
  * @brief Ceres functor to use a PinholeRadialK1
  *
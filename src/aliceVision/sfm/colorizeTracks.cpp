@@ -10,6 +10,7 @@
 #include <aliceVision/stl/indexedSort.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
 #include <aliceVision/image/io.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/progress.hpp>
 
@@ -22,29 +23,21 @@ namespace sfm {
 bool colorizeTracks(sfmData::SfMData& sfmData)
 {
   // colorize each track:
-  // start with the most representative image
+  // assign each landmark to the most representative image
   // and iterate to provide a color to each 3D point
 
-  std::vector<Vec3> vec_3dPoints;
-
   boost::progress_display progressBar(sfmData.getLandmarks().size(), std::cout, "\nCompute scene structure color\n");
 
-  vec_3dPoints.resize(sfmData.getLandmarks().size());
-
-  // build a list of contiguous index for the trackIds
-  std::map<IndexT, IndexT> trackIds_to_contiguousIndexes;
-  IndexT cpt = 0;
-  for(sfmData::Landmarks::const_iterator it = sfmData.getLandmarks().begin(); it != sfmData.getLandmarks().end(); ++it, ++cpt)
-  {
-    trackIds_to_contiguousIndexes[it->first] = cpt;
-    vec_3dPoints[cpt] = it->second.X;
-  }
+  // the track list that will be assigned to a view (point removed during the process)
+  // cache the landmark pointers to avoid a structure lookup per track at each loop
+  std::map<IndexT, sfmData::Landmark*> remainingTrackToColor;
+  for(auto& landmarkPair : sfmData.getLandmarks())
+    remainingTrackToColor[landmarkPair.first] = &landmarkPair.second;
 
-  // the track list that will be colored (point removed during the process)
-  std::set<IndexT> remainingTrackToColor;
-  std::transform(sfmData.getLandmarks().begin(), sfmData.getLandmarks().end(),
-    std::inserter(remainingTrackToColor, remainingTrackToColor.begin()),
-    stl::RetrieveKey());
+  // assign the landmarks to their coloring view up front, without any image access:
+  // the most representative view among the remaining tracks takes all its tracks.
+  // Each selected view can then be streamed exactly once, in parallel.
+  std::map<IndexT, std::vector<sfmData::Landmark*>> landmarksPerView;
 
   while(!remainingTrackToColor.empty())
   {
@@ -53,10 +46,9 @@ bool colorizeTracks(sfmData::SfMData& sfmData)
     //  b. sort to find the most representative view index
 
     std::map<IndexT, IndexT> map_IndexCardinal; // ViewId, Cardinal
-    for(std::set<IndexT>::const_iterator iterT = remainingTrackToColor.begin(); iterT != remainingTrackToColor.end(); ++iterT)
+    for(std::map<IndexT, sfmData::Landmark*>::const_iterator iterT = remainingTrackToColor.begin(); iterT != remainingTrackToColor.end(); ++iterT)
     {
-      const std::size_t trackId = *iterT;
-      const sfmData::Observations& observations = sfmData.getLandmarks().at(trackId).observations;
+      const sfmData::Observations& observations = iterT->second->observations;
 
       for(sfmData::Observations::const_iterator iterObs = observations.begin(); iterObs != observations.end(); ++iterObs)
       {
@@ -81,41 +73,60 @@ bool colorizeTracks(sfmData::SfMData& sfmData)
     // first image index with the most of occurrence
     std::map<IndexT, IndexT>::const_iterator iterTT = map_IndexCardinal.begin();
     std::advance(iterTT, packet_vec[0].index);
-    const std::size_t view_index = iterTT->first;
-    const sfmData::View * view = sfmData.getViews().at(view_index).get();
-    const std::string imagePath = view->getImagePath();
-    image::Image<image::RGBColor> image;
-    image::readImage(imagePath, image);
+    const IndexT view_index = iterTT->first;
 
-    // iterate through the remaining track to color
-    // - look if the current view is present to color the track
+    // iterate through the remaining track
+    // - look if the current view is present to assign the track to it
+    std::vector<sfmData::Landmark*>& viewLandmarks = landmarksPerView[view_index];
     std::set<IndexT> set_toRemove;
-    for(std::set<IndexT>::const_iterator iterT = remainingTrackToColor.begin(); iterT != remainingTrackToColor.end(); ++iterT)
+    for(std::map<IndexT, sfmData::Landmark*>::const_iterator iterT = remainingTrackToColor.begin(); iterT != remainingTrackToColor.end(); ++iterT)
     {
-      const std::size_t trackId = *iterT;
-      const sfmData::Observations& observations = sfmData.getLandmarks().at(trackId).observations;
-      sfmData::Observations::const_iterator it = observations.find(view_index);
+      sfmData::Landmark& landmark = *(iterT->second);
 
-      if(it != observations.end())
+      if(landmark.observations.count(view_index) != 0)
       {
-        // color the track
-        Vec2 pt = it->second.x;
-        // clamp the pixel position if the feature/marker center is outside the image.
-        pt.x() = clamp(pt.x(), 0.0, double(image.Width()-1));
-        pt.y() = clamp(pt.y(), 0.0, double(image.Height()-1));
-        sfmData.structure.at(trackId).rgb = image(pt.y(), pt.x());
-        set_toRemove.insert(trackId);
-        ++progressBar;
+        viewLandmarks.push_back(&landmark);
+        set_toRemove.insert(iterT->first);
       }
     }
 
-    // remove colored track
+    // remove assigned track
     for(std::set<IndexT>::const_iterator iter = set_toRemove.begin();
       iter != set_toRemove.end(); ++iter)
     {
       remainingTrackToColor.erase(*iter);
     }
   }
+
+  // flatten the view ids for the parallel loop
+  std::vector<IndexT> viewIds;
+  viewIds.reserve(landmarksPerView.size());
+  for(const auto& viewLandmarksPair : landmarksPerView)
+    viewIds.push_back(viewLandmarksPair.first);
+
+  // color the landmarks, each selected view image is streamed exactly once.
+  // each landmark is assigned to a single view, so there is no write conflict.
+  #pragma omp parallel for schedule(dynamic)
+  for(int i = 0; i < static_cast<int>(viewIds.size()); ++i)
+  {
+    const IndexT viewId = viewIds[i];
+    const sfmData::View* view = sfmData.getViews().at(viewId).get();
+    image::Image<image::RGBColor> image;
+    image::readImage(view->getImagePath(), image);
+
+    for(sfmData::Landmark* landmark : landmarksPerView.at(viewId))
+    {
+      // color the track
+      Vec2 pt = landmark->observations.find(viewId)->second.x;
+      // clamp the pixel position if the feature/marker center is outside the image.
+      pt.x() = clamp(pt.x(), 0.0, double(image.Width()-1));
+      pt.y() = clamp(pt.y(), 0.0, double(image.Height()-1));
+      landmark->rgb = image(pt.y(), pt.x());
+
+      #pragma omp critical
+      ++progressBar;
+    }
+  }
   return true;
 }
 
@@ -0,0 +1,596 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "bundleAdjustmentCuda.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aliceVision {
+namespace sfm {
+namespace cuda {
+
+#define BA_CUDA_BLOCK_SIZE 256
+
+// device problem layout:
+//  - poses: 6 doubles per camera [angleAxis(3), translation(3)], double buffered
+//  - intrinsics: 6 doubles per camera [focal, ppx, ppy, k1, k2, k3], constant
+//  - points: 3 doubles per point, double buffered
+//  - unknowns vector: [all pose parameters, all point parameters]
+
+__device__ inline void atomicAddD(double* address, double value)
+{
+#if __CUDA_ARCH__ >= 600
+    atomicAdd(address, value);
+#else
+    // atomicAdd on doubles needs compute capability 6.0, emulate it with a CAS loop
+    unsigned long long int* addressUll = (unsigned long long int*)address;
+    unsigned long long int old = *addressUll;
+    unsigned long long int assumed;
+    do
+    {
+        assumed = old;
+        old = atomicCAS(addressUll, assumed, __double_as_longlong(value + __longlong_as_double(assumed)));
+    } while(assumed != old);
+#endif
+}
+
+/// Rodrigues formula, R is row major
+__device__ inline void angleAxisToRotationMatrix(const double* r, double* R)
+{
+    const double theta2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+    if(theta2 > 1e-14)
+    {
+        const double theta = sqrt(theta2);
+        const double c = cos(theta);
+        const double s = sin(theta);
+        const double w0 = r[0] / theta;
+        const double w1 = r[1] / theta;
+        const double w2 = r[2] / theta;
+        const double oc = 1.0 - c;
+
+        R[0] = c + w0 * w0 * oc;      R[1] = w0 * w1 * oc - w2 * s; R[2] = w0 * w2 * oc + w1 * s;
+        R[3] = w1 * w0 * oc + w2 * s; R[4] = c + w1 * w1 * oc;      R[5] = w1 * w2 * oc - w0 * s;
+        R[6] = w2 * w0 * oc - w1 * s; R[7] = w2 * w1 * oc + w0 * s; R[8] = c + w2 * w2 * oc;
+    }
+    else
+    {
+        // first order approximation near zero
+        R[0] = 1.0;   R[1] = -r[2]; R[2] = r[1];
+        R[3] = r[2];  R[4] = 1.0;   R[5] = -r[0];
+        R[6] = -r[1]; R[7] = r[0];  R[8] = 1.0;
+    }
+}
+
+/**
+ * Derivative of R(r) * X with respect to the angle-axis r, following
+ * "A compact formula for the derivative of a 3-D rotation" (Gallego & Yezzi):
+ *   d(R X)/dr = -R [X]x (r r^T + (R^T - I) [r]x) / theta^2
+ * with the limit -[X]x at theta = 0. M is row major.
+ */
+__device__ inline void rotationDerivative(const double* r, const double* R, const double* X, double* M)
+{
+    // cross product matrix of X
+    const double Cx[9] = {0.0, -X[2], X[1], X[2], 0.0, -X[0], -X[1], X[0], 0.0};
+
+    const double theta2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+    if(theta2 <= 1e-14)
+    {
+        for(int i = 0; i < 9; ++i)
+            M[i] = -Cx[i];
+        return;
+    }
+
+    // T = (r r^T + (R^T - I) [r]x) / theta^2
+    const double Cr[9] = {0.0, -r[2], r[1], r[2], 0.0, -r[0], -r[1], r[0], 0.0};
+    double T[9];
+    for(int i = 0; i < 3; ++i)
+    {
+        for(int j = 0; j < 3; ++j)
+        {
+            // (R^T)(i,k) = R(k,i)
+            double rtc = 0.0;
+            for(int k = 0; k < 3; ++k)
+                rtc += (R[k * 3 + i] - (i == k ? 1.0 : 0.0)) * Cr[k * 3 + j];
+            T[i * 3 + j] = (r[i] * r[j] + rtc) / theta2;
+        }
+    }
+
+    // M = -(R * Cx) * T
+    double RCx[9];
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            RCx[i * 3 + j] = R[i * 3 + 0] * Cx[0 * 3 + j] + R[i * 3 + 1] * Cx[1 * 3 + j] + R[i * 3 + 2] * Cx[2 * 3 + j];
+
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            M[i * 3 + j] = -(RCx[i * 3 + 0] * T[0 * 3 + j] + RCx[i * 3 + 1] * T[1 * 3 + j] + RCx[i * 3 + 2] * T[2 * 3 + j]);
+}
+
+/// reprojection residual of one observation, same model as the Ceres radial functors
+__device__ inline void computeResidual(const double* pose, const double* K, const double* X,
+                                       double obsX, double obsY, double* e)
+{
+    double R[9];
+    angleAxisToRotationMatrix(pose, R);
+
+    const double pc[3] = {R[0] * X[0] + R[1] * X[1] + R[2] * X[2] + pose[3],
+                          R[3] * X[0] + R[4] * X[1] + R[5] * X[2] + pose[4],
+                          R[6] * X[0] + R[7] * X[1] + R[8] * X[2] + pose[5]};
+
+    const double u = pc[0] / pc[2];
+    const double v = pc[1] / pc[2];
+    const double r2 = u * u + v * v;
+    const double d = 1.0 + r2 * (K[3] + r2 * (K[4] + r2 * K[5]));
+
+    e[0] = K[0] * d * u + K[1] - obsX;
+    e[1] = K[0] * d * v + K[2] - obsY;
+}
+
+/// Huber robustifier on the squared residual norm, a is the threshold on the residual norm
+__device__ inline double robustCost(double s, double a)
+{
+    return (s <= a * a) ? s : 2.0 * a * sqrt(s) - a * a;
+}
+
+/// sqrt of the derivative of the Huber robustifier, used to reweight residuals and jacobians
+__device__ inline double robustWeight(double s, double a)
+{
+    return (s <= a * a) ? 1.0 : sqrt(a / sqrt(s));
+}
+
+/// robustified total cost, one thread per observation, block reduction in shared memory
+__global__ void costKernel(const double* poses, const double* intrinsics, const double* points,
+                           const int* obsCam, const int* obsPt, const double* obsXY, int nbObs,
+                           double huberA, double* cost)
+{
+    __shared__ double sharedCost[BA_CUDA_BLOCK_SIZE];
+
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    double localCost = 0.0;
+    if(i < nbObs)
+    {
+        double e[2];
+        computeResidual(poses + 6 * obsCam[i], intrinsics + 6 * obsCam[i], points + 3 * obsPt[i],
+                        obsXY[2 * i], obsXY[2 * i + 1], e);
+        localCost = robustCost(e[0] * e[0] + e[1] * e[1], huberA);
+    }
+    sharedCost[threadIdx.x] = localCost;
+    __syncthreads();
+
+    for(int stride = blockDim.x / 2; stride > 0; stride /= 2)
+    {
+        if(threadIdx.x < stride)
+            sharedCost[threadIdx.x] += sharedCost[threadIdx.x + stride];
+        __syncthreads();
+    }
+    if(threadIdx.x == 0)
+        atomicAddD(cost, sharedCost[0]);
+}
+
+/**
+ * One thread per observation: compute the robustly weighted residual and the
+ * 2x6 pose / 2x3 point jacobian blocks, and scatter the contributions to the
+ * gradient J^T e and to the diagonal of J^T J.
+ */
+__global__ void jacobianKernel(const double* poses, const double* intrinsics, const double* points,
+                               const int* obsCam, const int* obsPt, const double* obsXY, int nbObs,
+                               int nbCameras, double huberA,
+                               double* jacCam, double* jacPt, double* residuals,
+                               double* grad, double* diag)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i >= nbObs)
+        return;
+
+    const int camIndex = obsCam[i];
+    const int ptIndex = obsPt[i];
+    const double* pose = poses + 6 * camIndex;
+    const double* K = intrinsics + 6 * camIndex;
+    const double* X = points + 3 * ptIndex;
+
+    double R[9];
+    angleAxisToRotationMatrix(pose, R);
+
+    const double pc[3] = {R[0] * X[0] + R[1] * X[1] + R[2] * X[2] + pose[3],
+                          R[3] * X[0] + R[4] * X[1] + R[5] * X[2] + pose[4],
+                          R[6] * X[0] + R[7] * X[1] + R[8] * X[2] + pose[5]};
+
+    const double iz = 1.0 / pc[2];
+    const double u = pc[0] * iz;
+    const double v = pc[1] * iz;
+    const double r2 = u * u + v * v;
+    const double d = 1.0 + r2 * (K[3] + r2 * (K[4] + r2 * K[5]));
+    const double dd = K[3] + r2 * (2.0 * K[4] + r2 * 3.0 * K[5]); // dd/d(r2)
+
+    double e[2] = {K[0] * d * u + K[1] - obsXY[2 * i],
+                   K[0] * d * v + K[2] - obsXY[2 * i + 1]};
+
+    // P = f * D * A with D the distortion jacobian and A = d(u,v)/d(pc)
+    const double D00 = d + 2.0 * dd * u * u;
+    const double D01 = 2.0 * dd * u * v;
+    const double D11 = d + 2.0 * dd * v * v;
+    double P[6]; // 2x3, row major
+    P[0] = K[0] * iz * D00;
+    P[1] = K[0] * iz * D01;
+    P[2] = K[0] * (-u * D00 - v * D01) * iz;
+    P[3] = K[0] * iz * D01;
+    P[4] = K[0] * iz * D11;
+    P[5] = K[0] * (-u * D01 - v * D11) * iz;
+
+    double dpcdr[9];
+    rotationDerivative(pose, R, X, dpcdr);
+
+    const double w = robustWeight(e[0] * e[0] + e[1] * e[1], huberA);
+
+    double Jc[12]; // 2x6: [angleAxis | translation]
+    double Jx[6];  // 2x3
+    for(int row = 0; row < 2; ++row)
+    {
+        for(int col = 0; col < 3; ++col)
+        {
+            Jc[row * 6 + col] = w * (P[row * 3 + 0] * dpcdr[0 * 3 + col] +
+                                     P[row * 3 + 1] * dpcdr[1 * 3 + col] +
+                                     P[row * 3 + 2] * dpcdr[2 * 3 + col]);
+            Jc[row * 6 + 3 + col] = w * P[row * 3 + col];
+            Jx[row * 3 + col] = w * (P[row * 3 + 0] * R[0 * 3 + col] +
+                                     P[row * 3 + 1] * R[1 * 3 + col] +
+                                     P[row * 3 + 2] * R[2 * 3 + col]);
+        }
+        e[row] *= w;
+    }
+
+    for(int k = 0; k < 12; ++k)
+        jacCam[12 * i + k] = Jc[k];
+    for(int k = 0; k < 6; ++k)
+        jacPt[6 * i + k] = Jx[k];
+    residuals[2 * i] = e[0];
+    residuals[2 * i + 1] = e[1];
+
+    double* gradCam = grad + 6 * camIndex;
+    double* diagCam = diag + 6 * camIndex;
+    for(int k = 0; k < 6; ++k)
+    {
+        atomicAddD(gradCam + k, Jc[k] * e[0] + Jc[6 + k] * e[1]);
+        atomicAddD(diagCam + k, Jc[k] * Jc[k] + Jc[6 + k] * Jc[6 + k]);
+    }
+    double* gradPt = grad + 6 * nbCameras + 3 * ptIndex;
+    double* diagPt = diag + 6 * nbCameras + 3 * ptIndex;
+    for(int k = 0; k < 3; ++k)
+    {
+        atomicAddD(gradPt + k, Jx[k] * e[0] + Jx[3 + k] * e[1]);
+        atomicAddD(diagPt + k, Jx[k] * Jx[k] + Jx[3 + k] * Jx[3 + k]);
+    }
+}
+
+/// q += J^T J p, matrix-free from the per-observation jacobian blocks, q must be zeroed
+__global__ void applyJtJKernel(const int* obsCam, const int* obsPt, int nbObs, int nbCameras,
+                               const double* jacCam, const double* jacPt, const double* p, double* q)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i >= nbObs)
+        return;
+
+    const double* Jc = jacCam + 12 * i;
+    const double* Jx = jacPt + 6 * i;
+    const double* pCam = p + 6 * obsCam[i];
+    const double* pPt = p + 6 * nbCameras + 3 * obsPt[i];
+
+    double t0 = 0.0;
+    double t1 = 0.0;
+    for(int k = 0; k < 6; ++k)
+    {
+        t0 += Jc[k] * pCam[k];
+        t1 += Jc[6 + k] * pCam[k];
+    }
+    for(int k = 0; k < 3; ++k)
+    {
+        t0 += Jx[k] * pPt[k];
+        t1 += Jx[3 + k] * pPt[k];
+    }
+
+    double* qCam = q + 6 * obsCam[i];
+    for(int k = 0; k < 6; ++k)
+        atomicAddD(qCam + k, Jc[k] * t0 + Jc[6 + k] * t1);
+    double* qPt = q + 6 * nbCameras + 3 * obsPt[i];
+    for(int k = 0; k < 3; ++k)
+        atomicAddD(qPt + k, Jx[k] * t0 + Jx[3 + k] * t1);
+}
+
+/// y += a * x
+__global__ void axpyKernel(int n, double a, const double* x, double* y)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i < n)
+        y[i] += a * x[i];
+}
+
+/// p = x + a * p
+__global__ void xpayKernel(int n, double a, const double* x, double* p)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i < n)
+        p[i] = x[i] + a * p[i];
+}
+
+/// q += lambda * diag .* p (Marquardt damping term of the matrix-free operator)
+__global__ void dampKernel(int n, double lambda, const double* diag, const double* p, double* q)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i < n)
+        q[i] += lambda * diag[i] * p[i];
+}
+
+/// z = M^-1 r with the Jacobi preconditioner M = (1 + lambda) * diag(J^T J)
+__global__ void precondKernel(int n, double lambda, const double* diag, const double* r, double* z)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i < n)
+        z[i] = r[i] / ((1.0 + lambda) * fmax(diag[i], 1e-10));
+}
+
+__global__ void dotKernel(int n, const double* a, const double* b, double* out)
+{
+    __shared__ double sharedDot[BA_CUDA_BLOCK_SIZE];
+
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    sharedDot[threadIdx.x] = (i < n) ? a[i] * b[i] : 0.0;
+    __syncthreads();
+
+    for(int stride = blockDim.x / 2; stride > 0; stride /= 2)
+    {
+        if(threadIdx.x < stride)
+            sharedDot[threadIdx.x] += sharedDot[threadIdx.x + stride];
+        __syncthreads();
+    }
+    if(threadIdx.x == 0)
+        atomicAddD(out, sharedDot[0]);
+}
+
+/// trial parameters = current parameters + step
+__global__ void applyStepKernel(int nbPoseParams, int nbPointParams,
+                                const double* poses, const double* points, const double* step,
+                                double* trialPoses, double* trialPoints)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if(i < nbPoseParams)
+        trialPoses[i] = poses[i] + step[i];
+    else if(i < nbPoseParams + nbPointParams)
+        trialPoints[i - nbPoseParams] = points[i - nbPoseParams] + step[i];
+}
+
+int getDeviceCount()
+{
+    int nbDevices = 0;
+    if(cudaGetDeviceCount(&nbDevices) != cudaSuccess)
+        return 0;
+    return nbDevices;
+}
+
+bool refinePosesAndStructure(int deviceId,
+                             std::vector<Camera>& cameras,
+                             std::vector<double>& points,
+                             const std::vector<Observation>& observations,
+                             const SolverOptions& options,
+                             SolverSummary& summary)
+{
+    const int nbCameras = int(cameras.size());
+    const int nbPoints = int(points.size() / 3);
+    const int nbObs = int(observations.size());
+
+    if(nbCameras < 1 || nbPoints < 1 || nbObs < 1)
+        return false;
+
+    if(cudaSetDevice(deviceId) != cudaSuccess)
+        return false;
+
+    const int nbPoseParams = 6 * nbCameras;
+    const int nbPointParams = 3 * nbPoints;
+    const int nbParams = nbPoseParams + nbPointParams;
+
+    // pack the problem in flat host arrays
+    std::vector<double> hPoses(nbPoseParams);
+    std::vector<double> hIntrinsics(6 * nbCameras);
+    std::vector<int> hObsCam(nbObs);
+    std::vector<int> hObsPt(nbObs);
+    std::vector<double> hObsXY(2 * nbObs);
+    for(int c = 0; c < nbCameras; ++c)
+    {
+        const Camera& camera = cameras[c];
+        for(int k = 0; k < 3; ++k)
+        {
+            hPoses[6 * c + k] = camera.angleAxis[k];
+            hPoses[6 * c + 3 + k] = camera.translation[k];
+            hIntrinsics[6 * c + 3 + k] = camera.distortion[k];
+        }
+        hIntrinsics[6 * c] = camera.focal;
+        hIntrinsics[6 * c + 1] = camera.principalPoint[0];
+        hIntrinsics[6 * c + 2] = camera.principalPoint[1];
+    }
+    for(int i = 0; i < nbObs; ++i)
+    {
+        hObsCam[i] = observations[i].cameraIndex;
+        hObsPt[i] = observations[i].pointIndex;
+        hObsXY[2 * i] = observations[i].x;
+        hObsXY[2 * i + 1] = observations[i].y;
+    }
+
+    bool success = true;
+    std::vector<void*> allocations;
+    auto deviceAlloc = [&allocations, &success](std::size_t bytes) -> void* {
+        void* ptr = nullptr;
+        if(success && cudaMalloc(&ptr, bytes) != cudaSuccess)
+        {
+            success = false;
+            ptr = nullptr;
+        }
+        if(ptr != nullptr)
+            allocations.push_back(ptr);
+        return ptr;
+    };
+
+    double* dPoses[2] = {(double*)deviceAlloc(nbPoseParams * sizeof(double)),
+                         (double*)deviceAlloc(nbPoseParams * sizeof(double))};
+    double* dPoints[2] = {(double*)deviceAlloc(nbPointParams * sizeof(double)),
+                          (double*)deviceAlloc(nbPointParams * sizeof(double))};
+    double* dIntrinsics = (double*)deviceAlloc(hIntrinsics.size() * sizeof(double));
+    int* dObsCam = (int*)deviceAlloc(nbObs * sizeof(int));
+    int* dObsPt = (int*)deviceAlloc(nbObs * sizeof(int));
+    double* dObsXY = (double*)deviceAlloc(2 * nbObs * sizeof(double));
+    double* dJacCam = (double*)deviceAlloc(12 * std::size_t(nbObs) * sizeof(double));
+    double* dJacPt = (double*)deviceAlloc(6 * std::size_t(nbObs) * sizeof(double));
+    double* dResiduals = (double*)deviceAlloc(2 * std::size_t(nbObs) * sizeof(double));
+    double* dGrad = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dDiag = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dX = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dR = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dZ = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dP = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dQ = (double*)deviceAlloc(nbParams * sizeof(double));
+    double* dScalar = (double*)deviceAlloc(sizeof(double));
+
+    if(success)
+    {
+        success =
+            (cudaMemcpy(dPoses[0], hPoses.data(), nbPoseParams * sizeof(double), cudaMemcpyHostToDevice) == cudaSuccess) &&
+            (cudaMemcpy(dPoints[0], points.data(), nbPointParams * sizeof(double), cudaMemcpyHostToDevice) == cudaSuccess) &&
+            (cudaMemcpy(dIntrinsics, hIntrinsics.data(), hIntrinsics.size() * sizeof(double), cudaMemcpyHostToDevice) == cudaSuccess) &&
+            (cudaMemcpy(dObsCam, hObsCam.data(), nbObs * sizeof(int), cudaMemcpyHostToDevice) == cudaSuccess) &&
+            (cudaMemcpy(dObsPt, hObsPt.data(), nbObs * sizeof(int), cudaMemcpyHostToDevice) == cudaSuccess) &&
+            (cudaMemcpy(dObsXY, hObsXY.data(), 2 * nbObs * sizeof(double), cudaMemcpyHostToDevice) == cudaSuccess);
+    }
+
+    const int obsBlocks = (nbObs + BA_CUDA_BLOCK_SIZE - 1) / BA_CUDA_BLOCK_SIZE;
+    const int paramBlocks = (nbParams + BA_CUDA_BLOCK_SIZE - 1) / BA_CUDA_BLOCK_SIZE;
+
+    auto dot = [&](const double* a, const double* b) -> double {
+        cudaMemset(dScalar, 0, sizeof(double));
+        dotKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, a, b, dScalar);
+        double result = 0.0;
+        if(cudaMemcpy(&result, dScalar, sizeof(double), cudaMemcpyDeviceToHost) != cudaSuccess)
+            success = false;
+        return result;
+    };
+
+    auto computeCost = [&](const double* poses, const double* pts) -> double {
+        cudaMemset(dScalar, 0, sizeof(double));
+        costKernel<<<obsBlocks, BA_CUDA_BLOCK_SIZE>>>(poses, dIntrinsics, pts, dObsCam, dObsPt, dObsXY,
+                                                      nbObs, options.huberThreshold, dScalar);
+        double result = 0.0;
+        if(cudaMemcpy(&result, dScalar, sizeof(double), cudaMemcpyDeviceToHost) != cudaSuccess)
+            success = false;
+        return result;
+    };
+
+    int current = 0; // index of the accepted parameters buffers
+    double lambda = options.initialDamping;
+    double cost = success ? computeCost(dPoses[current], dPoints[current]) : 0.0;
+    summary.initialCost = cost;
+
+    for(int iteration = 0; success && iteration < options.maxIterations; ++iteration)
+    {
+        // build the weighted jacobian blocks, the gradient and the J^T J diagonal
+        cudaMemset(dGrad, 0, nbParams * sizeof(double));
+        cudaMemset(dDiag, 0, nbParams * sizeof(double));
+        jacobianKernel<<<obsBlocks, BA_CUDA_BLOCK_SIZE>>>(dPoses[current], dIntrinsics, dPoints[current],
+                                                          dObsCam, dObsPt, dObsXY, nbObs, nbCameras,
+                                                          options.huberThreshold,
+                                                          dJacCam, dJacPt, dResiduals, dGrad, dDiag);
+
+        // solve (J^T J + lambda * diag) step = -grad with Jacobi preconditioned CG
+        cudaMemset(dX, 0, nbParams * sizeof(double));
+        cudaMemset(dR, 0, nbParams * sizeof(double));
+        axpyKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, -1.0, dGrad, dR);
+        precondKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, lambda, dDiag, dR, dZ);
+        cudaMemcpy(dP, dZ, nbParams * sizeof(double), cudaMemcpyDeviceToDevice);
+
+        double rz = dot(dR, dZ);
+        const double bNorm = std::sqrt(dot(dR, dR));
+        if(bNorm < 1e-16)
+            break; // gradient is zero, converged
+
+        for(int cgIteration = 0; success && cgIteration < options.maxLinearIterations; ++cgIteration)
+        {
+            cudaMemset(dQ, 0, nbParams * sizeof(double));
+            applyJtJKernel<<<obsBlocks, BA_CUDA_BLOCK_SIZE>>>(dObsCam, dObsPt, nbObs, nbCameras,
+                                                              dJacCam, dJacPt, dP, dQ);
+            dampKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, lambda, dDiag, dP, dQ);
+
+            const double pq = dot(dP, dQ);
+            if(pq <= 0.0)
+                break; // numerical breakdown, keep the current step
+            const double alpha = rz / pq;
+            axpyKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, alpha, dP, dX);
+            axpyKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, -alpha, dQ, dR);
+
+            if(std::sqrt(dot(dR, dR)) < options.linearTolerance * bNorm)
+                break;
+
+            precondKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, lambda, dDiag, dR, dZ);
+            const double rzNew = dot(dR, dZ);
+            xpayKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbParams, rzNew / rz, dZ, dP);
+            rz = rzNew;
+        }
+
+        // evaluate the trial parameters
+        const int trial = 1 - current;
+        applyStepKernel<<<paramBlocks, BA_CUDA_BLOCK_SIZE>>>(nbPoseParams, nbPointParams,
+                                                             dPoses[current], dPoints[current], dX,
+                                                             dPoses[trial], dPoints[trial]);
+        const double newCost = computeCost(dPoses[trial], dPoints[trial]);
+
+        if(newCost < cost)
+        {
+            const double relativeDecrease = (cost - newCost) / cost;
+            current = trial;
+            cost = newCost;
+            lambda = std::max(lambda * 0.5, 1e-10);
+            ++summary.nbSuccessfulIterations;
+            if(relativeDecrease < options.functionTolerance)
+                break;
+        }
+        else
+        {
+            lambda *= 4.0;
+            ++summary.nbUnsuccessfulIterations;
+            if(lambda > 1e8)
+                break; // the damped step degenerated to no progress
+        }
+    }
+
+    summary.finalCost = cost;
+
+    if(success)
+    {
+        success =
+            (cudaGetLastError() == cudaSuccess) &&
+            (cudaMemcpy(hPoses.data(), dPoses[current], nbPoseParams * sizeof(double), cudaMemcpyDeviceToHost) == cudaSuccess) &&
+            (cudaMemcpy(points.data(), dPoints[current], nbPointParams * sizeof(double), cudaMemcpyDeviceToHost) == cudaSuccess);
+    }
+
+    if(success)
+    {
+        for(int c = 0; c < nbCameras; ++c)
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                cameras[c].angleAxis[k] = hPoses[6 * c + k];
+                cameras[c].translation[k] = hPoses[6 * c + 3 + k];
+            }
+        }
+    }
+
+    for(void* ptr : allocations)
+        cudaFree(ptr);
+
+    return success;
+}
+
+} // namespace cuda
+} // namespace sfm
+} // namespace aliceVision
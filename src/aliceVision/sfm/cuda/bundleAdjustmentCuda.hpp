@@ -0,0 +1,93 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+namespace cuda {
+
+/**
+ * @brief One camera of the device problem.
+ *
+ * The pose follows the Ceres backend convention: angle-axis rotation and the
+ * translation of the world to camera transform. The intrinsics are held
+ * constant by the solver; unused distortion coefficients must be zero.
+ */
+struct Camera
+{
+    double angleAxis[3];
+    double translation[3];
+    double focal;
+    double principalPoint[2];
+    double distortion[3]; //< r^2 polynomial coefficients k1, k2, k3
+};
+
+/// One observation: the 2d position of a point seen by a camera
+struct Observation
+{
+    int cameraIndex;
+    int pointIndex;
+    double x;
+    double y;
+};
+
+/// Levenberg-Marquardt / PCG solver parameters
+struct SolverOptions
+{
+    int maxIterations = 30;         //< maximum LM iterations
+    int maxLinearIterations = 100;  //< maximum CG iterations per LM iteration
+    double linearTolerance = 1e-4;  //< CG stop: relative residual norm
+    double functionTolerance = 1e-6; //< LM stop: relative cost decrease
+    double initialDamping = 1e-4;
+    double huberThreshold = 16.0;   //< same threshold as the HuberLoss of the Ceres backend
+};
+
+/// Solver report, costs are the robustified sums of squared reprojection errors
+struct SolverSummary
+{
+    int nbSuccessfulIterations = 0;
+    int nbUnsuccessfulIterations = 0;
+    double initialCost = 0.0;
+    double finalCost = 0.0;
+};
+
+/**
+ * @brief Get the number of available CUDA devices.
+ * @return number of devices, 0 if no device or no driver
+ */
+int getDeviceCount();
+
+/**
+ * @brief Refine the camera poses and the 3d points by minimizing the
+ * robustified reprojection error on one CUDA device.
+ *
+ * Levenberg-Marquardt outer loop; the damped normal equations of each
+ * iteration are solved matrix-free with a Jacobi preconditioned conjugate
+ * gradient, the per-observation jacobian blocks are the only stored matrix
+ * data. All intrinsics are kept constant.
+ *
+ * @param[in] deviceId CUDA device to run on
+ * @param[in,out] cameras The camera poses (intrinsics are read-only)
+ * @param[in,out] points The 3d points (3 * nbPoints)
+ * @param[in] observations The 2d observations linking cameras and points
+ * @param[in] options The solver parameters
+ * @param[out] summary The solver report
+ * @return true if the refinement ran to completion on the device
+ */
+bool refinePosesAndStructure(int deviceId,
+                             std::vector<Camera>& cameras,
+                             std::vector<double>& points,
+                             const std::vector<Observation>& observations,
+                             const SolverOptions& options,
+                             SolverSummary& summary);
+
+} // namespace cuda
+} // namespace sfm
+} // namespace aliceVision
@@ -7,9 +7,9 @@
 
 #include "RelativePoseInfo.hpp"
 
+#include <aliceVision/multiview/essential.hpp>
 #include <aliceVision/multiview/essentialKernelSolver.hpp>
 #include <aliceVision/multiview/projection.hpp>
-#include <aliceVision/multiview/triangulation/triangulationDLT.hpp>
 
 #include <aliceVision/robustEstimation/ACRansac.hpp>
 #include <aliceVision/robustEstimation/ACRansacKernelAdaptator.hpp>
@@ -22,9 +22,6 @@ bool estimate_Rt_fromE(const Mat3 & K1, const Mat3 & K2,
   const Mat3 & E, const std::vector<size_t> & vec_inliers,
   Mat3 * R, Vec3 * t)
 {
-  // Accumulator to find the best solution
-  std::vector<size_t> f(4, 0);
-
   std::vector<Mat3> Rs;  // Rotation matrix.
   std::vector<Vec3> ts;  // Translation matrix.
 
@@ -35,31 +32,19 @@ bool estimate_Rt_fromE(const Mat3 & K1, const Mat3 & K2,
   assert(Rs.size() == 4);
   assert(ts.size() == 4);
 
-  Mat34 P1, P2;
-  Mat3 R1 = Mat3::Identity();
-  Vec3 t1 = Vec3::Zero();
-  P_From_KRt(K1, R1, t1, &P1);
-
-  for (unsigned int i = 0; i < 4; ++i)
+  // Gather the inlier correspondences in one batch
+  Mat x1In(2, vec_inliers.size());
+  Mat x2In(2, vec_inliers.size());
+  for (size_t k = 0; k < vec_inliers.size(); ++k)
   {
-    const Mat3 &R2 = Rs[i];
-    const Vec3 &t2 = ts[i];
-    P_From_KRt(K2, R2, t2, &P2);
-    Vec3 X;
-
-    for (size_t k = 0; k < vec_inliers.size(); ++k)
-    {
-      const Vec2
-        & x1_ = x1.col(vec_inliers[k]),
-        & x2_ = x2.col(vec_inliers[k]);
-      TriangulateDLT(P1, x1_, P2, x2_, &X);
-      // Test if point is front to the two cameras.
-      if (Depth(R1, t1, X) > 0 && Depth(R2, t2, X) > 0)
-      {
-        ++f[i];
-      }
-    }
+    x1In.col(k) = x1.col(vec_inliers[k]);
+    x2In.col(k) = x2.col(vec_inliers[k]);
   }
+
+  // Accumulator to find the best solution: count the points in front of both
+  // cameras for all the solutions at once
+  std::vector<size_t> f;
+  MotionFromEssentialCheiralityCount(Rs, ts, K1, x1In, K2, x2In, &f);
   // Check the solution:
   const std::vector<size_t>::iterator iter = std::max_element(f.begin(), f.end());
   if (*iter == 0)
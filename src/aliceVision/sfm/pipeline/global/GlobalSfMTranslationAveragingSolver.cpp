@@ -319,6 +319,10 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
   std::set<IndexT> set_pose_ids;
   std::transform(map_globalR.begin(), map_globalR.end(),
     std::inserter(set_pose_ids, set_pose_ids.begin()), stl::RetrieveKey());
+  // Shared workspace: index the matches by their supporting pose edge once, so
+  // the per-triplet work below gathers its matches from three buckets instead
+  // of scanning the whole match list for every triplet
+  std::map<Pair, std::vector<const matching::PairwiseMatches::value_type *> > matchesPerPoseEdge;
   // List shared correspondences (pairs) between poses
   for (const auto & match_iterator : pairwiseMatches)
   {
@@ -333,8 +337,28 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
     {
       rotation_pose_id_graph.insert(
         std::make_pair(v1->getPoseId(), v2->getPoseId()));
+      const Pair poseEdge(std::min(v1->getPoseId(), v2->getPoseId()),
+                          std::max(v1->getPoseId(), v2->getPoseId()));
+      matchesPerPoseEdge[poseEdge].push_back(&match_iterator);
     }
   }
+  // Gather the matches supported by the three pose edges of a triplet
+  const auto collectTripletMatches = [&matchesPerPoseEdge](const graph::Triplet & triplet,
+                                                           matching::PairwiseMatches & outMatches)
+  {
+    const Pair tripletEdges[3] = {
+      Pair(std::min(triplet.i, triplet.j), std::max(triplet.i, triplet.j)),
+      Pair(std::min(triplet.i, triplet.k), std::max(triplet.i, triplet.k)),
+      Pair(std::min(triplet.j, triplet.k), std::max(triplet.j, triplet.k))};
+    for (const Pair & edge : tripletEdges)
+    {
+      const auto it = matchesPerPoseEdge.find(edge);
+      if (it == matchesPerPoseEdge.end())
+        continue;
+      for (const matching::PairwiseMatches::value_type * match : it->second)
+        outMatches.insert(*match);
+    }
+  };
   // List putative triplets (from global rotations Ids)
   const std::vector< graph::Triplet > vec_triplets =
     graph::tripletListing(rotation_pose_id_graph);
@@ -346,37 +370,22 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
     // An estimated triplets of translation mark three edges as estimated.
 
     //-- precompute the number of track per triplet:
-    HashMap<IndexT, IndexT> map_tracksPerTriplets;
+    std::vector<IndexT> tracksPerTriplet(vec_triplets.size(), 0);
 
     #pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < (int)vec_triplets.size(); ++i)
     {
       // List matches that belong to the triplet of poses
-      const graph::Triplet & triplet = vec_triplets[i];
       matching::PairwiseMatches map_triplet_matches;
-      const std::set<IndexT> set_triplet_pose_ids = {triplet.i, triplet.j, triplet.k};
-      // List shared correspondences (pairs) between the triplet poses
-      for (const auto & match_iterator : pairwiseMatches)
-      {
-        const Pair pair = match_iterator.first;
-        const View * v1 = sfmData.getViews().at(pair.first).get();
-        const View * v2 = sfmData.getViews().at(pair.second).get();
-        if (// Consider the pair iff it is supported by the triplet graph & 2 different pose id
-            (v1->getPoseId() != v2->getPoseId())
-            && set_triplet_pose_ids.count(v1->getPoseId())
-            && set_triplet_pose_ids.count(v2->getPoseId()))
-        {
-          map_triplet_matches.insert( match_iterator );
-        }
-      }
+      collectTripletMatches(vec_triplets[i], map_triplet_matches);
       // Compute tracks:
       {
         aliceVision::track::TracksBuilder tracksBuilder;
         tracksBuilder.build(map_triplet_matches);
         tracksBuilder.filter(3);
 
-        #pragma omp critical
-        map_tracksPerTriplets[i] = tracksBuilder.nbTracks(); //count the # of matches in the UF tree
+        // each triplet writes its own slot, no synchronization needed
+        tracksPerTriplet[i] = tracksBuilder.nbTracks(); //count the # of matches in the UF tree
       }
     }
 
@@ -424,7 +433,7 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
         std::vector<size_t> vec_commonTracksPerTriplets;
         for (const size_t triplet_index : vec_possibleTripletIndexes)
         {
-          vec_commonTracksPerTriplets.push_back(map_tracksPerTriplets[triplet_index]);
+          vec_commonTracksPerTriplets.push_back(tracksPerTriplet[triplet_index]);
         }
 
         using namespace stl::indexed_sort;
@@ -459,11 +468,13 @@ void GlobalSfMTranslationAveragingSolver::ComputePutativeTranslation_EdgesCovera
           aliceVision::track::TracksMap pose_triplet_tracks;
 
           const std::string sOutDirectory = "./";
+          matching::PairwiseMatches triplet_matches;
+          collectTripletMatches(triplet, triplet_matches);
           const bool bTriplet_estimation = Estimate_T_triplet(
               sfmData,
               map_globalR,
               normalizedFeaturesPerView,
-              pairwiseMatches,
+              triplet_matches,
               triplet,
               vec_tis,
               dPrecision,
@@ -584,7 +595,7 @@ bool GlobalSfMTranslationAveragingSolver::Estimate_T_triplet(
   const SfMData& sfmData,
   const HashMap<IndexT, Mat3>& map_globalR,
   const feature::FeaturesPerView& normalizedFeaturesPerView,
-  const matching::PairwiseMatches& pairwiseMatches,
+  const matching::PairwiseMatches& tripletMatches,
   const graph::Triplet& poses_id,
   std::vector<Vec3>& vec_tis,
   double& precision, // UpperBound of the precision found by the AContrario estimator
@@ -592,26 +603,9 @@ bool GlobalSfMTranslationAveragingSolver::Estimate_T_triplet(
   aliceVision::track::TracksMap& tracks,
   const std::string& outDirectory) const
 {
-  // List matches that belong to the triplet of poses
-  matching::PairwiseMatches map_triplet_matches;
-  const std::set<IndexT> set_pose_ids = {poses_id.i, poses_id.j, poses_id.k};
-  // List shared correspondences (pairs) between poses
-  for (const auto & match_iterator : pairwiseMatches)
-  {
-    const Pair& pair = match_iterator.first;
-    const View* v1 = sfmData.getViews().at(pair.first).get();
-    const View* v2 = sfmData.getViews().at(pair.second).get();
-    if (// Consider the pair iff it is supported by the triplet graph & 2 different pose id
-        (v1->getPoseId() != v2->getPoseId())
-        && set_pose_ids.count(v1->getPoseId())
-        && set_pose_ids.count(v2->getPoseId()))
-    {
-      map_triplet_matches.insert( match_iterator );
-    }
-  }
-
+  // The caller has already collected the matches supported by the triplet poses
   aliceVision::track::TracksBuilder tracksBuilder;
-  tracksBuilder.build(map_triplet_matches);
+  tracksBuilder.build(tripletMatches);
   tracksBuilder.filter(3);
   tracksBuilder.exportToSTL(tracks);
 
@@ -698,7 +692,7 @@ bool GlobalSfMTranslationAveragingSolver::Estimate_T_triplet(
   tiny_scene.poses[poses_id.k] = Pose3(vec_global_R_Triplet[2], -vec_global_R_Triplet[2].transpose() * vec_tis[2]);
 
   // insert views used by the relative pose pairs
-  for (const auto & pairIterator : map_triplet_matches )
+  for (const auto & pairIterator : tripletMatches )
   {
     // initialize camera indexes
     const IndexT I = pairIterator.first.first;
@@ -66,11 +66,12 @@ private:
 
   /**
    * @brief Robust estimation and refinement of a translation and 3D points of an image triplets.
+   * @note tripletMatches only contains the matches supported by the triplet poses.
    */
   bool Estimate_T_triplet(const sfmData::SfMData& sfmData,
            const HashMap<IndexT, Mat3>& map_globalR,
            const feature::FeaturesPerView& normalizedFeaturesPerView,
-           const matching::PairwiseMatches& pairwiseMatches,
+           const matching::PairwiseMatches& tripletMatches,
            const graph::Triplet& poses_id,
            std::vector<Vec3>& vec_tis,
            double& precision, // UpperBound of the precision found by the AContrario estimator
@@ -16,6 +16,7 @@
 #include <aliceVision/multiview/essential.hpp>
 #include <aliceVision/track/Track.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <dependencies/htmlDoc/htmlDoc.hpp>
 
@@ -442,6 +443,17 @@ void ReconstructionEngine_globalSfM::Compute_Relative_Rotations(rotationAveragin
     poseWiseMatches[Pair(v1->getPoseId(), v2->getPoseId())].insert(pair);
   }
 
+  // flat view of the pose pairs for the parallel loop: avoids the O(n) map
+  // iterator advance per iteration
+  std::vector<PoseWiseMatches::const_iterator> poseWiseMatchesIt;
+  poseWiseMatchesIt.reserve(poseWiseMatches.size());
+  for(PoseWiseMatches::const_iterator it = poseWiseMatches.begin(); it != poseWiseMatches.end(); ++it)
+    poseWiseMatchesIt.push_back(it);
+
+  // each thread collects its relative rotations in its own buffer, merged once
+  // at the end: no shared critical section on the result container
+  std::vector<rotationAveraging::RelativeRotations> threadRelativesR(omp_get_max_threads());
+
   boost::progress_display progressBar( poseWiseMatches.size(), std::cout, "\n- Relative pose computation -\n" );
   #pragma omp parallel for schedule(dynamic)
   // Compute the relative pose from pairwise point matches:
@@ -452,9 +464,7 @@ void ReconstructionEngine_globalSfM::Compute_Relative_Rotations(rotationAveragin
       ++progressBar;
     }
     {
-      PoseWiseMatches::const_iterator iter (poseWiseMatches.begin());
-      std::advance(iter, i);
-      const auto& relative_pose_iterator(*iter);
+      const auto& relative_pose_iterator(*poseWiseMatchesIt[i]);
       const Pair relative_pose_pair = relative_pose_iterator.first;
       const PairSet& match_pairs = relative_pose_iterator.second;
 
@@ -496,10 +506,15 @@ void ReconstructionEngine_globalSfM::Compute_Relative_Rotations(rotationAveragin
         assert(descType != feature::EImageDescriberType::UNINITIALIZED);
         const matching::IndMatches & matches = matchesPerDescIt.second;
 
+        // resolve the feature arrays of both views once per descriptor type
+        // instead of once per match
+        const feature::PointFeatures& features_I = _normalizedFeaturesPerView->getFeatures(I, descType);
+        const feature::PointFeatures& features_J = _normalizedFeaturesPerView->getFeatures(J, descType);
+
         for (const auto & match : matches)
         {
-          x1.col(iBearing) = _normalizedFeaturesPerView->getFeatures(I, descType)[match._i].coords().cast<double>();
-          x2.col(iBearing++) = _normalizedFeaturesPerView->getFeatures(J, descType)[match._j].coords().cast<double>();
+          x1.col(iBearing) = features_I[match._i].coords().cast<double>();
+          x2.col(iBearing++) = features_J[match._j].coords().cast<double>();
         }
       }
       assert(nbBearing == iBearing);
@@ -553,10 +568,12 @@ void ReconstructionEngine_globalSfM::Compute_Relative_Rotations(rotationAveragin
           if(descType == feature::EImageDescriberType::UNINITIALIZED)
             throw std::logic_error("descType UNINITIALIZED");
           const matching::IndMatches & matches = matchesPerDescIt.second;
+          const feature::PointFeatures& features_I = _featuresPerView->getFeatures(I, descType);
+          const feature::PointFeatures& features_J = _featuresPerView->getFeatures(J, descType);
           for (const matching::IndMatch& match: matches)
           {
-            const Vec2 x1_ = _featuresPerView->getFeatures(I, descType)[match._i].coords().cast<double>();
-            const Vec2 x2_ = _featuresPerView->getFeatures(J, descType)[match._j].coords().cast<double>();
+            const Vec2 x1_ = features_I[match._i].coords().cast<double>();
+            const Vec2 x2_ = features_J[match._j].coords().cast<double>();
             Vec3 X;
             TriangulateDLT(P1, x1_, P2, x2_, &X);
             Observations obs;
@@ -595,17 +612,21 @@ void ReconstructionEngine_globalSfM::Compute_Relative_Rotations(rotationAveragin
           relativePose_info.relativePose = Pose3(Rrel, -Rrel.transpose() * trel);
         }
       }
-      #pragma omp critical
+      // Add the relative rotation to the relative 'rotation' pose graph
+      // of this thread
       {
-        // Add the relative rotation to the relative 'rotation' pose graph
         using namespace aliceVision::rotationAveraging;
-          vec_relatives_R.emplace_back(
+          threadRelativesR.at(omp_get_thread_num()).emplace_back(
             relative_pose_pair.first, relative_pose_pair.second,
             relativePose_info.relativePose.rotation(), relativePose_info.vec_inliers.size());
       }
     }
   } // for all relative pose
 
+  // merge the per-thread buffers
+  for(const rotationAveraging::RelativeRotations& relativesR : threadRelativesR)
+    vec_relatives_R.insert(vec_relatives_R.end(), relativesR.begin(), relativesR.end());
+
   // Re-weight rotation in [0,1]
   if (vec_relatives_R.size() > 1)
   {
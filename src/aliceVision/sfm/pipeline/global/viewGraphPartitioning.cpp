@@ -0,0 +1,184 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "viewGraphPartitioning.hpp"
+#include <aliceVision/sfm/utils/alignment.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+
+namespace aliceVision {
+namespace sfm {
+
+std::vector<std::set<IndexT>> partitionViewGraph(const PairSet& pairs, std::size_t clusterCount)
+{
+  // adjacency list of the view graph
+  std::map<IndexT, std::set<IndexT>> adjacentViews;
+  for(const Pair& pair : pairs)
+  {
+    adjacentViews[pair.first].insert(pair.second);
+    adjacentViews[pair.second].insert(pair.first);
+  }
+
+  std::vector<std::set<IndexT>> clusters;
+
+  if(adjacentViews.empty())
+    return clusters;
+
+  if(clusterCount < 2)
+  {
+    clusters.emplace_back();
+    for(const auto& adjacencyPair : adjacentViews)
+      clusters.front().insert(adjacencyPair.first);
+    return clusters;
+  }
+
+  const std::size_t targetClusterSize = (adjacentViews.size() + clusterCount - 1) / clusterCount;
+
+  // greedy graph growing: breadth-first visit from the first unassigned view until the
+  // cluster reaches the target size, the remaining frontier seeds the next cluster.
+  // The visit order only depends on the view ids, the partition is deterministic.
+  std::map<IndexT, std::size_t> viewToCluster;
+
+  for(const auto& adjacencyPair : adjacentViews)
+  {
+    if(viewToCluster.count(adjacencyPair.first) != 0)
+      continue;
+
+    // assign the isolated components remaining after the last cluster to the smallest one
+    std::size_t clusterIndex = clusters.size();
+    if(clusters.size() >= clusterCount)
+    {
+      clusterIndex = 0;
+      for(std::size_t i = 1; i < clusters.size(); ++i)
+        if(clusters.at(i).size() < clusters.at(clusterIndex).size())
+          clusterIndex = i;
+    }
+    else
+    {
+      clusters.emplace_back();
+    }
+
+    std::set<IndexT>& cluster = clusters.at(clusterIndex);
+
+    std::deque<IndexT> visitQueue;
+    visitQueue.push_back(adjacencyPair.first);
+
+    while(!visitQueue.empty() && cluster.size() < targetClusterSize)
+    {
+      const IndexT viewId = visitQueue.front();
+      visitQueue.pop_front();
+
+      if(viewToCluster.count(viewId) != 0)
+        continue;
+
+      viewToCluster[viewId] = clusterIndex;
+      cluster.insert(viewId);
+
+      for(const IndexT adjacentViewId : adjacentViews.at(viewId))
+        if(viewToCluster.count(adjacentViewId) == 0)
+          visitQueue.push_back(adjacentViewId);
+    }
+  }
+
+  // duplicate the boundary views: every edge crossing two clusters contributes its two
+  // views to both, so neighbour clusters share posed views for the merge alignment.
+  for(const Pair& pair : pairs)
+  {
+    const std::size_t clusterA = viewToCluster.at(pair.first);
+    const std::size_t clusterB = viewToCluster.at(pair.second);
+
+    if(clusterA == clusterB)
+      continue;
+
+    clusters.at(clusterA).insert(pair.second);
+    clusters.at(clusterB).insert(pair.first);
+  }
+
+  for(std::size_t i = 0; i < clusters.size(); ++i)
+    ALICEVISION_LOG_DEBUG("View graph cluster #" << i << " contains " << clusters.at(i).size() << " views.");
+
+  return clusters;
+}
+
+bool mergePartialReconstruction(sfmData::SfMData& sfmData, const sfmData::SfMData& partialSfmData)
+{
+  // estimate the similarity transformation from the shared boundary views
+  double S;
+  Mat3 R;
+  Vec3 t;
+  if(!computeSimilarity(partialSfmData, sfmData, &S, &R, &t))
+  {
+    ALICEVISION_LOG_WARNING("Cannot merge the partial reconstruction, no similarity found from the shared views.");
+    return false;
+  }
+
+  sfmData::SfMData alignedSfmData = partialSfmData;
+  applyTransform(alignedSfmData, S, R, t);
+
+  // the boundary views present in both reconstructions
+  std::set<IndexT> sharedViewIds;
+  for(const auto& viewPair : alignedSfmData.getViews())
+    if(sfmData.getViews().count(viewPair.first) != 0)
+      sharedViewIds.insert(viewPair.first);
+
+  // add the views, intrinsics and poses reconstructed only by the partial scene,
+  // the boundary views shared with the output scene keep their current pose.
+  for(const auto& viewPair : alignedSfmData.getViews())
+  {
+    const sfmData::View& view = *viewPair.second;
+
+    if(sfmData.getViews().count(viewPair.first) == 0)
+      sfmData.getViews().emplace(viewPair.first, viewPair.second);
+
+    if(alignedSfmData.getIntrinsics().count(view.getIntrinsicId()) != 0 &&
+       sfmData.getIntrinsics().count(view.getIntrinsicId()) == 0)
+      sfmData.getIntrinsics().emplace(view.getIntrinsicId(), alignedSfmData.getIntrinsics().at(view.getIntrinsicId()));
+
+    if(alignedSfmData.getPoses().count(view.getPoseId()) != 0 &&
+       sfmData.getPoses().count(view.getPoseId()) == 0)
+      sfmData.getPoses().emplace(view.getPoseId(), alignedSfmData.getPoses().at(view.getPoseId()));
+  }
+
+  // landmark ids are cluster-wise track ids, renumber the added landmarks after the existing ones
+  IndexT nextLandmarkId = 0;
+  for(const auto& landmarkPair : sfmData.getLandmarks())
+    nextLandmarkId = std::max(nextLandmarkId, landmarkPair.first + 1);
+
+  std::size_t nbSkippedLandmarks = 0;
+  for(const auto& landmarkPair : alignedSfmData.getLandmarks())
+  {
+    const sfmData::Landmark& landmark = landmarkPair.second;
+
+    // skip the landmarks observed by shared views only, the output scene already represents them
+    bool hasNewObservation = false;
+    for(const auto& observationPair : landmark.observations)
+    {
+      if(sharedViewIds.count(observationPair.first) == 0)
+      {
+        hasNewObservation = true;
+        break;
+      }
+    }
+
+    if(!hasNewObservation)
+    {
+      ++nbSkippedLandmarks;
+      continue;
+    }
+
+    sfmData.getLandmarks().emplace(nextLandmarkId++, landmark);
+  }
+
+  ALICEVISION_LOG_DEBUG("Partial reconstruction merging: " << nbSkippedLandmarks << " landmarks already represented by the shared views.");
+
+  return true;
+}
+
+} // namespace sfm
+} // namespace aliceVision
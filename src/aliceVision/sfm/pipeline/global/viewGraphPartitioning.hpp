@@ -0,0 +1,48 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+
+#include <set>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Partition the view graph into clusters of similar size.
+ *
+ * The partition is deterministic: running the function on several machines with the
+ * same pairs always produces the same clusters, so each machine can reconstruct its
+ * own cluster independently. Every edge crossing two clusters contributes its two
+ * views to both clusters, neighbour clusters therefore share boundary views that
+ * are used later to align the partial reconstructions.
+ *
+ * @param[in] pairs the edges of the view graph
+ * @param[in] clusterCount the requested number of clusters
+ * @return the view ids of each cluster (boundary views belong to several clusters)
+ */
+std::vector<std::set<IndexT>> partitionViewGraph(const PairSet& pairs, std::size_t clusterCount);
+
+/**
+ * @brief Merge a partial reconstruction into an already reconstructed scene.
+ *
+ * A similarity transformation is estimated from the poses of the boundary views
+ * shared by the two reconstructions and applied to the partial one. The views,
+ * intrinsics, poses and landmarks reconstructed only by the partial scene are then
+ * added to the output scene. The shared boundary views keep their current pose.
+ *
+ * @param[in,out] sfmData the scene to merge into
+ * @param[in] partialSfmData the partial reconstruction of another cluster
+ * @return false if no similarity can be estimated from the shared views
+ */
+bool mergePartialReconstruction(sfmData::SfMData& sfmData, const sfmData::SfMData& partialSfmData);
+
+} // namespace sfm
+} // namespace aliceVision
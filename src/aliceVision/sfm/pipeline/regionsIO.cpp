@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <map>
 
 namespace fs = boost::filesystem;
 
@@ -20,49 +21,66 @@ namespace sfm {
 
 using namespace sfmData;
 
-std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders,
-                                              IndexT viewId,
-                                              const feature::ImageDescriber& imageDescriber)
-{
-  assert(!folders.empty());
-
-  const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber.getDescriberType());
-  const std::string basename = std::to_string(viewId);
+namespace {
 
-  std::string featFilename;
-  std::string descFilename;
+/**
+ * @brief List the content of the given features folders once: one directory
+ * listing per folder instead of two filesystem probes per (view, describer
+ * type) pair. Later folders take precedence, like the per-file probing did.
+ * @return a map of filename to full path
+ */
+std::map<std::string, std::string> listFeaturesFolders(const std::vector<std::string>& folders)
+{
+  std::map<std::string, std::string> filenames;
 
   for(const std::string& folder : folders)
   {
-    const fs::path featPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".feat");
-    const fs::path descPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".desc");
+    if(!fs::is_directory(folder))
+      continue;
 
-    if(fs::exists(featPath) && fs::exists(descPath))
+    for(fs::directory_iterator it(folder), end; it != end; ++it)
     {
-      featFilename = featPath.string();
-      descFilename = descPath.string();
+      if(fs::is_regular_file(it->status()))
+        filenames[it->path().filename().string()] = it->path().string();
     }
   }
+  return filenames;
+}
 
-  if(featFilename.empty() || descFilename.empty())
-    throw std::runtime_error("Can't find view " + basename + " region files");
-
-  ALICEVISION_LOG_TRACE("Features filename: "    << featFilename);
-  ALICEVISION_LOG_TRACE("Descriptors filename: " << descFilename);
+/**
+ * @brief Load the regions of one view from already resolved filenames.
+ * An empty @p descFilename loads the features only.
+ */
+std::unique_ptr<feature::Regions> loadRegionsFromFilenames(const std::string& featFilename,
+                                                           const std::string& descFilename,
+                                                           IndexT viewId,
+                                                           const feature::ImageDescriber& imageDescriber)
+{
+  ALICEVISION_LOG_TRACE("Features filename: " << featFilename);
+  if(!descFilename.empty())
+    ALICEVISION_LOG_TRACE("Descriptors filename: " << descFilename);
 
   std::unique_ptr<feature::Regions> regionsPtr;
   imageDescriber.allocate(regionsPtr);
 
   try
   {
-    regionsPtr->Load(featFilename, descFilename);
+    if(descFilename.empty())
+      regionsPtr->LoadFeatures(featFilename);
+    else
+      regionsPtr->Load(featFilename, descFilename);
   }
   catch(const std::exception& e)
   {
+    const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber.getDescriberType());
     std::stringstream ss;
-    ss << "Invalid " << imageDescriberTypeName << " regions files for the view " << basename << " : \n";
+    if(descFilename.empty())
+      ss << "Invalid " << imageDescriberTypeName << " features file for the view " << viewId << " : \n";
+    else
+      ss << "Invalid " << imageDescriberTypeName << " regions files for the view " << viewId << " : \n";
     ss << "\t- Features file : " << featFilename << "\n";
-    ss << "\t- Descriptors file: " << descFilename << "\n";
+    if(!descFilename.empty())
+      ss << "\t- Descriptors file: " << descFilename << "\n";
     ss << "\t  " << e.what() << "\n";
     ALICEVISION_LOG_ERROR(ss.str());
 
@@ -73,6 +91,38 @@ std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& fo
   return regionsPtr;
 }
 
+} // namespace
+
+std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders,
+                                              IndexT viewId,
+                                              const feature::ImageDescriber& imageDescriber)
+{
+  assert(!folders.empty());
+
+  const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber.getDescriberType());
+  const std::string basename = std::to_string(viewId);
+
+  std::string featFilename;
+  std::string descFilename;
+
+  for(const std::string& folder : folders)
+  {
+    const fs::path featPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".feat");
+    const fs::path descPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".desc");
+
+    if(fs::exists(featPath) && fs::exists(descPath))
+    {
+      featFilename = featPath.string();
+      descFilename = descPath.string();
+    }
+  }
+
+  if(featFilename.empty() || descFilename.empty())
+    throw std::runtime_error("Can't find view " + basename + " region files");
+
+  return loadRegionsFromFilenames(featFilename, descFilename, viewId, imageDescriber);
+}
+
 std::unique_ptr<feature::Regions> loadFeatures(const std::vector<std::string>& folders,
                                               IndexT viewId,
                                               const feature::ImageDescriber& imageDescriber)
@@ -94,31 +144,81 @@ std::unique_ptr<feature::Regions> loadFeatures(const std::vector<std::string>& f
   if(featFilename.empty())
     throw std::runtime_error("Can't find view " + basename + " features file");
 
-  ALICEVISION_LOG_TRACE("Features filename: " << featFilename);
+  return loadRegionsFromFilenames(featFilename, std::string(), viewId, imageDescriber);
+}
 
-  std::unique_ptr<feature::Regions> regionsPtr;
-  imageDescriber.allocate(regionsPtr);
+bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
+            const SfMData& sfmData,
+            const std::vector<std::string>& folders,
+            const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+            const std::set<IndexT>& viewIdFilter)
+{
+  std::vector<std::string> featuresFolders = sfmData.getFeaturesFolders(); // add sfm features folders
+  featuresFolders.insert(featuresFolders.end(), folders.begin(), folders.end()); // add user features folders
 
-  try
+  boost::progress_display progressBar(sfmData.getViews().size() * imageDescriberTypes.size(), std::cout, "Loading regions\n");
+
+  std::atomic_bool invalid(false);
+
+  std::vector<std::unique_ptr<feature::ImageDescriber>> imageDescribers;
+  imageDescribers.resize(imageDescriberTypes.size());
+
+  for(std::size_t i = 0; i < imageDescriberTypes.size(); ++i)
+    imageDescribers.at(i) = createImageDescriber(imageDescriberTypes.at(i));
+
+  // resolve the feature files of all the folders in one pass
+  const std::map<std::string, std::string> folderContent = listFeaturesFolders(featuresFolders);
+
+  // create each per-view slot up front: the parallel loop below fills disjoint
+  // pre-existing entries and never modifies the map structure itself
+  for(const auto& viewPair : sfmData.getViews())
   {
-    regionsPtr->LoadFeatures(featFilename);
+    if(viewIdFilter.empty() || viewIdFilter.find(viewPair.second.get()->getViewId()) != viewIdFilter.end())
+      regionsPerView.getData()[viewPair.second.get()->getViewId()];
   }
-  catch(const std::exception& e)
-  {
-    std::stringstream ss;
-    ss << "Invalid " << imageDescriberTypeName << " features file for the view " << basename << " : \n";
-    ss << "\t- Features file : " << featFilename << "\n";
-    ss << "\t  " << e.what() << "\n";
-    ALICEVISION_LOG_ERROR(ss.str());
 
-    throw std::runtime_error(e.what());
-  }
+#pragma omp parallel
+ for(auto iter = sfmData.getViews().begin(); iter != sfmData.getViews().end() && !invalid; ++iter)
+ {
+#pragma omp single nowait
+   {
+     for(std::size_t i = 0; i < imageDescriberTypes.size(); ++i)
+     {
+       if(viewIdFilter.empty() || viewIdFilter.find(iter->second.get()->getViewId()) != viewIdFilter.end())
+       {
+         const IndexT viewId = iter->second.get()->getViewId();
+         const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberTypes.at(i));
+         const std::string basename = std::to_string(viewId);
 
-  ALICEVISION_LOG_TRACE("Feature count: " << regionsPtr->RegionCount());
-  return regionsPtr;
+         const auto featIt = folderContent.find(basename + "." + imageDescriberTypeName + ".feat");
+         const auto descIt = folderContent.find(basename + "." + imageDescriberTypeName + ".desc");
+
+         if(featIt == folderContent.end() || descIt == folderContent.end())
+           throw std::runtime_error("Can't find view " + basename + " region files");
+
+         std::unique_ptr<feature::Regions> regionsPtr = loadRegionsFromFilenames(featIt->second, descIt->second, viewId, *(imageDescribers.at(i)));
+         if(regionsPtr)
+         {
+           // all the describer types of one view are loaded by the same task,
+           // so addRegions only fills the slot created before the parallel
+           // region and the critical section shrinks to the progress bar
+           regionsPerView.addRegions(viewId, imageDescriberTypes.at(i), regionsPtr.release());
+#pragma omp critical
+           ++progressBar;
+         }
+         else
+         {
+           invalid = true;
+         }
+       }
+     }
+   }
+ }
+ return !invalid;
 }
 
-bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
+
+bool loadPagedRegionsPerView(feature::PagedRegionsPerView& pagedRegionsPerView,
             const SfMData& sfmData,
             const std::vector<std::string>& folders,
             const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
@@ -127,7 +227,7 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
   std::vector<std::string> featuresFolders = sfmData.getFeaturesFolders(); // add sfm features folders
   featuresFolders.insert(featuresFolders.end(), folders.begin(), folders.end()); // add user features folders
 
-  boost::progress_display progressBar(sfmData.getViews().size() * imageDescriberTypes.size(), std::cout, "Loading regions\n");
+  boost::progress_display progressBar(sfmData.getViews().size() * imageDescriberTypes.size(), std::cout, "Loading regions (paged descriptors)\n");
 
   std::atomic_bool invalid(false);
 
@@ -137,7 +237,10 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
   for(std::size_t i = 0; i < imageDescriberTypes.size(); ++i)
     imageDescribers.at(i) = createImageDescriber(imageDescriberTypes.at(i));
 
-#pragma omp parallel num_threads(3)
+  // resolve the feature files of all the folders in one pass
+  const std::map<std::string, std::string> folderContent = listFeaturesFolders(featuresFolders);
+
+#pragma omp parallel
  for(auto iter = sfmData.getViews().begin(); iter != sfmData.getViews().end() && !invalid; ++iter)
  {
 #pragma omp single nowait
@@ -146,14 +249,24 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
      {
        if(viewIdFilter.empty() || viewIdFilter.find(iter->second.get()->getViewId()) != viewIdFilter.end())
        {
-         std::unique_ptr<feature::Regions> regionsPtr = loadRegions(featuresFolders, iter->second.get()->getViewId(), *(imageDescribers.at(i)));
+         const IndexT viewId = iter->second.get()->getViewId();
+         const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberTypes.at(i));
+         const std::string basename = std::to_string(viewId);
+
+         const auto featIt = folderContent.find(basename + "." + imageDescriberTypeName + ".feat");
+         // the descriptors are not loaded here, but the store needs the .desc path to page them in later
+         const auto descIt = folderContent.find(basename + "." + imageDescriberTypeName + ".desc");
+
+         std::unique_ptr<feature::Regions> regionsPtr;
+         if(featIt != folderContent.end() && descIt != folderContent.end())
+           regionsPtr = loadRegionsFromFilenames(featIt->second, std::string(), viewId, *(imageDescribers.at(i)));
+
          if(regionsPtr)
          {
+           // addRegions is thread-safe, only the progress bar needs the critical section
+           pagedRegionsPerView.addRegions(viewId, imageDescriberTypes.at(i), regionsPtr.release(), descIt->second);
 #pragma omp critical
-           {
-             regionsPerView.addRegions(iter->second.get()->getViewId(), imageDescriberTypes.at(i), regionsPtr.release());
-             ++progressBar;
-           }
+           ++progressBar;
          }
          else
          {
@@ -186,6 +299,14 @@ bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
   for(std::size_t i = 0; i < imageDescriberTypes.size(); ++i)
     imageDescribers.at(i) = createImageDescriber(imageDescriberTypes.at(i));
 
+  // resolve the feature files of all the folders in one pass
+  const std::map<std::string, std::string> folderContent = listFeaturesFolders(featuresFolders);
+
+  // create each per-view slot up front: the parallel loop below fills disjoint
+  // pre-existing entries and never modifies the map structure itself
+  for(const auto& viewPair : sfmData.getViews())
+    featuresPerView.getData()[viewPair.second.get()->getViewId()];
+
 #pragma omp parallel
   for (auto iter = sfmData.getViews().begin(); (iter != sfmData.getViews().end()) && (!invalid); ++iter)
   {
@@ -193,14 +314,21 @@ bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
     {
       for(std::size_t i = 0; i < imageDescriberTypes.size(); ++i)
       {
-        std::unique_ptr<feature::Regions> regionsPtr = loadFeatures(featuresFolders, iter->second.get()->getViewId(), *imageDescribers.at(i));
+        const IndexT viewId = iter->second.get()->getViewId();
+        const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberTypes.at(i));
+        const std::string basename = std::to_string(viewId);
+
+        const auto featIt = folderContent.find(basename + "." + imageDescriberTypeName + ".feat");
+        if(featIt == folderContent.end())
+          throw std::runtime_error("Can't find view " + basename + " features file");
+
+        std::unique_ptr<feature::Regions> regionsPtr = loadRegionsFromFilenames(featIt->second, std::string(), viewId, *imageDescribers.at(i));
 
+        // all the describer types of one view are loaded by the same task, so
+        // addFeatures only fills the slot created before the parallel region
+        featuresPerView.addFeatures(viewId, imageDescriberTypes[i], regionsPtr->GetRegionsPositions());
 #pragma omp critical
-        {
-          // save loaded Features as PointFeature
-          featuresPerView.addFeatures(iter->second.get()->getViewId(), imageDescriberTypes[i], regionsPtr->GetRegionsPositions());
-          ++progressBar;
-        }
+        ++progressBar;
       }
     }
   }
@@ -12,6 +12,7 @@
 #include <aliceVision/feature/ImageDescriber.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
 #include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/feature/PagedRegionsPerView.hpp>
 #include <aliceVision/feature/FeaturesPerView.hpp>
 
 #include <memory>
@@ -52,6 +53,23 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
                         const std::set<IndexT>& filter = std::set<IndexT>());
 
+/**
+ * @brief Load Regions for each view of the provided SfMData container in a paged store.
+ * Only the features are loaded upfront, the descriptors are paged in from the .desc
+ * files on demand (see feature::PagedRegionsPerView).
+ * @param[in,out] pagedRegionsPerView
+ * @param[in] sfmData The provided SfMData container
+ * @param[in] folders The feature Folders
+ * @param[in] imageDescriberTypes The imageDescriber types
+ * @param[in] filter To load Regions only for a sub-set of the views contained in the sfmData
+ * @return true if the regions are correctlty loaded
+ */
+bool loadPagedRegionsPerView(feature::PagedRegionsPerView& pagedRegionsPerView,
+                             const sfmData::SfMData& sfmData,
+                             const std::vector<std::string>& folders,
+                             const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                             const std::set<IndexT>& filter = std::set<IndexT>());
+
 /**
  * @brief Load Features for each view of the provided SfMData container.
  * @param[in,out] featuresPerView
@@ -26,6 +26,11 @@
 #include <aliceVision/system/cpu.hpp>
 #include <aliceVision/system/MemoryInfo.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+#include <aliceVision/sfm/BundleAdjustmentPCG.hpp>
+#endif
 
 #include <dependencies/htmlDoc/htmlDoc.hpp>
 
@@ -65,7 +70,7 @@ using namespace aliceVision::sfmData;
  */
 void computeTracksPyramidPerView(
     const track::TracksPerView& tracksPerView,
-    const track::TracksMap& map_tracks,
+    const track::FlatTracks& tracks,
     const Views& views,
     const feature::FeaturesPerView& featuresProvider,
     const std::size_t pyramidBase,
@@ -105,9 +110,9 @@ void computeTracksPyramidPerView(
     for(std::size_t i = 0; i < viewTracks.second.size(); ++i)
     {
       const std::size_t trackId = viewTracks.second[i];
-      const track::Track& track = map_tracks.at(trackId);
-      const std::size_t featIndex = track.featPerView.at(viewId);
-      const auto& feature = featuresProvider.getFeatures(viewId, track.descType)[featIndex]; 
+      const std::size_t trackIndex = tracks.findTrack(trackId);
+      const std::size_t featIndex = tracks.findObservation(trackIndex, viewId)->featureId;
+      const auto& feature = featuresProvider.getFeatures(viewId, tracks.descType(trackIndex))[featIndex];
       
       for(std::size_t level = 0; level < pyramidDepth; ++level)
       {
@@ -234,13 +239,13 @@ std::size_t ReconstructionEngine_sequentialSfM::fuseMatchesIntoTracks()
     }
 
     ALICEVISION_LOG_DEBUG("Track export to internal structure");
-    // build tracks with STL compliant type
-    tracksBuilder.exportToSTL(_map_tracks);
+    // build tracks in the compact CSR storage
+    tracksBuilder.exportToSTL(_flatTracks);
     ALICEVISION_LOG_DEBUG("Build tracks per view");
-    track::tracksUtilsMap::computeTracksPerView(_map_tracks, _map_tracksPerView);
+    track::tracksUtilsMap::computeTracksPerView(_flatTracks, _map_tracksPerView);
     ALICEVISION_LOG_DEBUG("Build tracks pyramid per view");
     computeTracksPyramidPerView(
-            _map_tracksPerView, _map_tracks, _sfmData.views, *_featuresPerView, _pyramidBase, _pyramidDepth, _map_featsPyramidPerView);
+            _map_tracksPerView, _flatTracks, _sfmData.views, *_featuresPerView, _pyramidBase, _pyramidDepth, _map_featsPyramidPerView);
 
     // display stats
     {
@@ -252,7 +257,7 @@ std::size_t ReconstructionEngine_sequentialSfM::fuseMatchesIntoTracks()
         << "\t- # images in tracks: " << imagesId.size());
 
       std::map<size_t, size_t> map_Occurence_TrackLength;
-      track::tracksUtilsMap::tracksLength(_map_tracks, map_Occurence_TrackLength);
+      track::tracksUtilsMap::tracksLength(_flatTracks, map_Occurence_TrackLength);
       ALICEVISION_LOG_INFO("TrackLength, Occurrence");
       for(const auto& iter: map_Occurence_TrackLength)
       {
@@ -262,7 +267,7 @@ std::size_t ReconstructionEngine_sequentialSfM::fuseMatchesIntoTracks()
       }
     }
   }
-  return _map_tracks.size();
+  return _flatTracks.size();
 }
 
 std::vector<Pair> ReconstructionEngine_sequentialSfM::getInitialImagePairsCandidates()
@@ -337,14 +342,15 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
   ALICEVISION_LOG_DEBUG("Find corresponding landmark id per track id");
 
   // find corresponding landmark id per track id
-  for(const auto& trackPair : _map_tracks)
+  for(std::size_t trackIndex = 0; trackIndex < _flatTracks.size(); ++trackIndex)
   {
-    const IndexT trackId = trackPair.first;
-    const Track& track = trackPair.second;
+    const IndexT trackId = _flatTracks.trackId(trackIndex);
+    const feature::EImageDescriberType descType = _flatTracks.descType(trackIndex);
 
-    for(const auto& featView : track.featPerView)
+    for(const FlatTracks::Observation* obs = _flatTracks.observationsBegin(trackIndex);
+        obs != _flatTracks.observationsEnd(trackIndex); ++obs)
     {
-      const ObsToLandmark::const_iterator it = obsToLandmark.find(ObsKey(featView.first, featView.second, track.descType));
+      const ObsToLandmark::const_iterator it = obsToLandmark.find(ObsKey(obs->viewId, obs->featureId, descType));
 
       if(it != obsToLandmark.end())
       {
@@ -356,7 +362,7 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
   }
 
   ALICEVISION_LOG_INFO("Landmark ids to track ids reampping: " << std::endl
-                        << "\t- # tracks: " << _map_tracks.size() << std::endl
+                        << "\t- # tracks: " << _flatTracks.size() << std::endl
                         << "\t- # input landmarks: " << landmarks.size() << std::endl
                         << "\t- # output landmarks: " << _sfmData.getLandmarks().size());
 }
@@ -446,6 +452,15 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
         ALICEVISION_LOG_DEBUG("Save of file " << os.str() << " took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - chrono_start).count() << " msec.");
       }
 
+      // reconstruction checkpoint, allows to resume an interrupted reconstruction
+      // note: the save is done on a temporary file first, a truncated checkpoint cannot exist
+      if((_checkpointInterval > 0) && (resectionId % _checkpointInterval) == 0)
+      {
+        auto chrono_start = std::chrono::steady_clock::now();
+        sfmDataIO::Save(_sfmData, (fs::path(_outputFolder) / checkpointFilename()).string(), sfmDataIO::ESfMData::ALL);
+        ALICEVISION_LOG_DEBUG("Save of the reconstruction checkpoint took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - chrono_start).count() << " msec.");
+      }
+
       ++resectionId;
     }
 
@@ -492,8 +507,14 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
 {
   auto chrono_start = std::chrono::steady_clock::now();
 
-  // add images to the 3D reconstruction
-#pragma omp parallel for
+  // localization results of the candidate group
+  std::vector<ResectionData> resectionDatas(bestViewIds.size());
+  std::vector<char> hasResectedView(bestViewIds.size(), false);
+
+  // Localize the candidate views in parallel: they are independent given the
+  // current map, so the scene is only read in this phase. The scene update is
+  // applied serially afterwards, it is the only part that mutates the map.
+#pragma omp parallel for schedule(dynamic)
   for(int i = 0; i < bestViewIds.size(); ++i)
   {
     const IndexT viewId = bestViewIds.at(i);
@@ -510,9 +531,6 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
           << "\t- rig id: " << view.getRigId() << std::endl
           << "\t- sub-pose id: " << view.getSubPoseId());
 
-#pragma omp critical
-        remainingViewIds.erase(viewId);
-
         continue;
       }
 
@@ -529,30 +547,30 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
           << "\t- rig id: " << view.getRigId() << std::endl
           << "\t- sub-pose id: " << view.getSubPoseId());
 
-#pragma omp critical
-        remainingViewIds.erase(viewId);
-
         continue;
       }
     }
 
-    ResectionData newResectionData;
-    const bool hasResected = computeResection(viewId, newResectionData);
+    hasResectedView.at(i) = computeResection(viewId, resectionDatas.at(i));
+  }
 
-#pragma omp critical
+  // serial map-update: triangulate/merge the observations of the localized
+  // views into the scene
+  for(int i = 0; i < bestViewIds.size(); ++i)
+  {
+    const IndexT viewId = bestViewIds.at(i);
+
+    if(hasResectedView.at(i))
     {
-      if(hasResected)
-      {
-        updateScene(viewId, newResectionData);
-        ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
-        _sfmData.getViews().at(viewId)->setResectionId(resectionId);
-      }
-      else
-      {
-        ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
-      }
-      remainingViewIds.erase(viewId);
+      updateScene(viewId, resectionDatas.at(i));
+      ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
+      _sfmData.getViews().at(viewId)->setResectionId(resectionId);
+    }
+    else
+    {
+      ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
     }
+    remainingViewIds.erase(viewId);
   }
 
   ALICEVISION_LOG_DEBUG("Resection of " << bestViewIds.size() << " new images took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - chrono_start).count() << " msec.");
@@ -651,6 +669,14 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
   if(enableLocalStrategy)
     BA.useLocalStrategyGraph(_localStrategyGraph);
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+  // the GPU backend performs the global pose / structure adjustments,
+  // it delegates the unsupported cases to the Ceres backend by itself
+  std::unique_ptr<BundleAdjustmentPCG> gpuBA;
+  if(_useGPUBundleAdjustment && !enableLocalStrategy)
+    gpuBA.reset(new BundleAdjustmentPCG());
+#endif
+
   // perform BA until all point are under the given precision
   do
   {
@@ -659,7 +685,14 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
 
     // bundle adjustment iteration
     {
-      const bool success = BA.adjust(_sfmData, refineOptions);
+      bool success = false;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+      if(gpuBA != nullptr)
+        success = gpuBA->adjust(_sfmData, refineOptions);
+      else
+#endif
+      success = BA.adjust(_sfmData, refineOptions);
 
       if(!success)
         return false; // not usable solution
@@ -669,9 +702,18 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
         _localStrategyGraph->saveIntrinsicsToHistory(_sfmData);
 
       // export and print information about the refinement
-      const BundleAdjustmentCeres::Statistics& statistics = BA.getStatistics();
-      statistics.exportToFile(_outputFolder, "bundle_adjustment.csv");
-      statistics.show();
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+      if(gpuBA != nullptr)
+      {
+        gpuBA->getStatistics().show();
+      }
+      else
+#endif
+      {
+        const BundleAdjustmentCeres::Statistics& statistics = BA.getStatistics();
+        statistics.exportToFile(_outputFolder, "bundle_adjustment.csv");
+        statistics.show();
+      }
     }
 
     nbOutliers = removeOutliers(_maxReprojectionError);
@@ -1031,7 +1073,7 @@ bool ReconstructionEngine_sequentialSfM::makeInitialPair3D(const Pair& currentPa
   // b. get common features between the two views
   // use the track to have a more dense match correspondence set
   aliceVision::track::TracksMap commonTracks;
-  track::tracksUtilsMap::getCommonTracksInImagesFast({I, J}, _map_tracks, _map_tracksPerView, commonTracks);
+  track::tracksUtilsMap::getCommonTracksInImagesFast({I, J}, _flatTracks, _map_tracksPerView, commonTracks);
 
   // copy point to arrays
   const std::size_t n = commonTracks.size();
@@ -1186,31 +1228,47 @@ bool ReconstructionEngine_sequentialSfM::getBestInitialImagePairs(std::vector<Pa
   typedef std::tuple<double, double, double, std::size_t, Pair> ImagePairScore;
   std::vector<ImagePairScore> bestImagePairs;
   bestImagePairs.reserve(_pairwiseMatches->size());
-  
+
+  // Flatten the candidate pairs once and apply the cheap filters upfront,
+  // so the parallel scoring loop only sees pairs worth the robust estimation
+  // (and indexes them directly instead of advancing a map iterator per pair).
+  std::vector<Pair> candidatePairs;
+  candidatePairs.reserve(_pairwiseMatches->size());
+  for (const auto& pairwiseMatch : *_pairwiseMatches)
+  {
+    const IndexT I = std::min(pairwiseMatch.first.first, pairwiseMatch.first.second);
+    const IndexT J = std::max(pairwiseMatch.first.first, pairwiseMatch.first.second);
+
+    if (filterViewId != UndefinedIndexT && filterViewId != I && filterViewId != J)
+      continue;
+
+    if (!valid_views.count(I) || !valid_views.count(J))
+      continue;
+
+    candidatePairs.push_back(pairwiseMatch.first);
+  }
+
   // Compute the relative pose & the 'baseline score'
-  boost::progress_display my_progress_bar( _pairwiseMatches->size(),
+  boost::progress_display my_progress_bar( candidatePairs.size(),
     std::cout,"Automatic selection of an initial pair:\n" );
 
-#pragma omp parallel for schedule(dynamic)
-  for (int i = 0; i < _pairwiseMatches->size(); ++i)
+#pragma omp parallel
+  {
+  // per-thread scores, merged once per thread: the scoring loop itself stays lock-free
+  std::vector<ImagePairScore> threadImagePairs;
+  threadImagePairs.reserve(candidatePairs.size() / omp_get_max_threads() + 1);
+
+#pragma omp for schedule(dynamic)
+  for (int i = 0; i < candidatePairs.size(); ++i)
   {
-    matching::PairwiseMatches::const_iterator iter = _pairwiseMatches->begin();
-    std::advance(iter, i);
-    
 #pragma omp critical
     ++my_progress_bar;
-    
-    const Pair current_pair = iter->first;
+
+    const Pair current_pair = candidatePairs[i];
 
     const IndexT I = std::min(current_pair.first, current_pair.second);
     const IndexT J = std::max(current_pair.first, current_pair.second);
 
-    if (filterViewId != UndefinedIndexT && filterViewId != I && filterViewId != J)
-      continue;
-
-    if (!valid_views.count(I) || !valid_views.count(J))
-      continue;
-    
     const View* viewI = _sfmData.getViews().at(I).get();
     const Intrinsics::const_iterator iterIntrinsic_I = _sfmData.getIntrinsics().find(viewI->getIntrinsicId());
     const View* viewJ = _sfmData.getViews().at(J).get();
@@ -1223,7 +1281,7 @@ bool ReconstructionEngine_sequentialSfM::getBestInitialImagePairs(std::vector<Pa
 
     aliceVision::track::TracksMap map_tracksCommon;
     const std::set<size_t> set_imageIndex= {I, J};
-    track::tracksUtilsMap::getCommonTracksInImagesFast(set_imageIndex, _map_tracks, _map_tracksPerView, map_tracksCommon);
+    track::tracksUtilsMap::getCommonTracksInImagesFast(set_imageIndex, _flatTracks, _map_tracksPerView, map_tracksCommon);
 
     // Copy points correspondences to arrays for relative pose estimation
     const size_t n = map_tracksCommon.size();
@@ -1298,10 +1356,13 @@ bool ReconstructionEngine_sequentialSfM::getBestInitialImagePairs(std::vector<Pa
           scoring_angle > fLimit_max_angle)
         score = - 1.0 / score;
 
-      #pragma omp critical
-      bestImagePairs.emplace_back(score, imagePairScore, scoring_angle, relativePose_info.vec_inliers.size(), current_pair);
+      threadImagePairs.emplace_back(score, imagePairScore, scoring_angle, relativePose_info.vec_inliers.size(), current_pair);
     }
   }
+
+#pragma omp critical
+  bestImagePairs.insert(bestImagePairs.end(), threadImagePairs.begin(), threadImagePairs.end());
+  }
   // We print the N best scores and return the best one.
   const std::size_t nBestScores = std::min(std::size_t(50), bestImagePairs.size());
   std::sort(bestImagePairs.begin(), bestImagePairs.end(), std::greater<ImagePairScore>());
@@ -1466,7 +1527,7 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewIndex
   
   // Get back featId associated to a tracksID already reconstructed.
   // These 2D/3D associations will be used for the resection.
-  tracksUtilsMap::getFeatureIdInViewPerTrack(_map_tracks,
+  tracksUtilsMap::getFeatureIdInViewPerTrack(_flatTracks,
                                              resectionData.tracksId,
                                              viewIndex,
                                              &resectionData.featuresId);
@@ -1654,18 +1715,30 @@ void ReconstructionEngine_sequentialSfM::getTracksToTriangulate(const std::set<I
 #pragma omp single nowait
       {
         const std::size_t trackId = *it;
-        
-        const track::Track& track = _map_tracks.at(trackId);
-        
-        std::set<IndexT> allViewsSharingTheTrack;
-        std::transform(track.featPerView.begin(), track.featPerView.end(),
-                       std::inserter(allViewsSharingTheTrack, allViewsSharingTheTrack.begin()),
-                       stl::RetrieveKey());
-        
+
+        const std::size_t trackIndex = _flatTracks.findTrack(trackId);
+
+        // the observations of the track are already sorted by view id, so the
+        // intersection can run directly on the span
         std::set<IndexT> allReconstructedViewsSharingTheTrack;
-        std::set_intersection(allViewsSharingTheTrack.begin(), allViewsSharingTheTrack.end(),
-                              allReconstructedViews.begin(), allReconstructedViews.end(),
-                              std::inserter(allReconstructedViewsSharingTheTrack, allReconstructedViewsSharingTheTrack.begin()));
+        {
+          const track::FlatTracks::Observation* obs = _flatTracks.observationsBegin(trackIndex);
+          const track::FlatTracks::Observation* obsEnd = _flatTracks.observationsEnd(trackIndex);
+          std::set<IndexT>::const_iterator viewIt = allReconstructedViews.begin();
+          while(obs != obsEnd && viewIt != allReconstructedViews.end())
+          {
+            if(obs->viewId < *viewIt)
+              ++obs;
+            else if(*viewIt < obs->viewId)
+              ++viewIt;
+            else
+            {
+              allReconstructedViewsSharingTheTrack.insert(allReconstructedViewsSharingTheTrack.end(), *viewIt);
+              ++obs;
+              ++viewIt;
+            }
+          }
+        }
         
         if (allReconstructedViewsSharingTheTrack.size() >= _minNbObservationsForTriangulation)
         {
@@ -1697,7 +1770,8 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
   {
     const IndexT trackId = setTracksId.at(i);
     bool isValidTrack = true;
-    const track::Track& track = _map_tracks.at(trackId);
+    const std::size_t trackIndex = _flatTracks.findTrack(trackId);
+    const feature::EImageDescriberType trackDescType = _flatTracks.descType(trackIndex);
     std::set<IndexT>& observations = mapTracksToTriangulate.at(trackId); // all the posed views possessing the track
     
     // The track needs to be seen by a min. number of views to be triangulated
@@ -1724,9 +1798,9 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
       const IntrinsicBase* camJ = scene.getIntrinsics().at(viewJ->getIntrinsicId()).get();
       const Pose3 poseI = scene.getPose(*viewI).getTransform();
       const Pose3 poseJ = scene.getPose(*viewJ).getTransform();
-      const Vec2 xI = _featuresPerView->getFeatures(I, track.descType)[track.featPerView.at(I)].coords().cast<double>();
-      const Vec2 xJ = _featuresPerView->getFeatures(J, track.descType)[track.featPerView.at(J)].coords().cast<double>();
-  
+      const Vec2 xI = _featuresPerView->getFeatures(I, trackDescType)[_flatTracks.findObservation(trackIndex, I)->featureId].coords().cast<double>();
+      const Vec2 xJ = _featuresPerView->getFeatures(J, trackDescType)[_flatTracks.findObservation(trackIndex, J)->featureId].coords().cast<double>();
+
       // -- Triangulate:
       TriangulateDLT(camI->get_projective_equivalent(poseI), 
                      camI->get_ud_pixel(xI), 
@@ -1761,14 +1835,12 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
       Mat2X features(2, observations.size()); // undistorted 2D features (one per pose)
       std::vector<Mat34> Ps; // projective matrices (one per pose)
       {
-        const track::Track& track = _map_tracks.at(trackId);
-        
         int i = 0;
         for (const IndexT& viewId : observations)
         {
           const View* view = scene.getViews().at(viewId).get();
           const IntrinsicBase* cam = scene.getIntrinsics().at(view->getIntrinsicId()).get();
-          const Vec2 x_ud = cam->get_ud_pixel(_featuresPerView->getFeatures(viewId, track.descType)[track.featPerView.at(viewId)].coords().cast<double>()); // undistorted 2D point
+          const Vec2 x_ud = cam->get_ud_pixel(_featuresPerView->getFeatures(viewId, trackDescType)[_flatTracks.findObservation(trackIndex, viewId)->featureId].coords().cast<double>()); // undistorted 2D point
           features(0,i) = x_ud(0); 
           features(1,i) = x_ud(1);  
           Ps.push_back(cam->get_projective_equivalent(scene.getPose(*view).getTransform()));
@@ -1803,11 +1875,12 @@ void ReconstructionEngine_sequentialSfM::triangulate_multiViewsLORANSAC(SfMData&
     {
       Landmark landmark;
       landmark.X = X_euclidean;
-      landmark.descType = track.descType;
+      landmark.descType = trackDescType;
       for (const IndexT & viewId : inliers) // add inliers as observations
       {
-        const Vec2 x = _featuresPerView->getFeatures(viewId, track.descType)[track.featPerView.at(viewId)].coords().cast<double>();
-        landmark.observations[viewId] = Observation(x, track.featPerView.at(viewId));
+        const std::size_t featureId = _flatTracks.findObservation(trackIndex, viewId)->featureId;
+        const Vec2 x = _featuresPerView->getFeatures(viewId, trackDescType)[featureId].coords().cast<double>();
+        landmark.observations[viewId] = Observation(x, featureId);
       }
 #pragma omp critical
       {
@@ -1861,7 +1934,7 @@ void ReconstructionEngine_sequentialSfM::triangulate_2Views(SfMData& scene, cons
       // Find track correspondences between I and J
       const std::set<std::size_t> set_viewIndex = { I, J };
       track::TracksMap map_tracksCommonIJ;
-      track::tracksUtilsMap::getCommonTracksInImagesFast(set_viewIndex, _map_tracks, _map_tracksPerView, map_tracksCommonIJ);
+      track::tracksUtilsMap::getCommonTracksInImagesFast(set_viewIndex, _flatTracks, _map_tracksPerView, map_tracksCommonIJ);
 
       const View* viewI = scene.getViews().at(I).get();
       const View* viewJ = scene.getViews().at(J).get();
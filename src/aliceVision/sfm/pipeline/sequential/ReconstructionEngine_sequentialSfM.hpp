@@ -115,6 +115,25 @@ public:
     _sfmStepFileExtension = fileExtension;
   }
 
+  /**
+   * @brief Set the number of resection groups between two reconstruction checkpoint files
+   * @param[in] checkpointInterval 0 means no checkpoint file
+   */
+  void setCheckpointInterval(std::size_t checkpointInterval)
+  {
+    _checkpointInterval = checkpointInterval;
+  }
+
+  /**
+   * @brief Filename of the reconstruction checkpoint written in the output folder.
+   *  The checkpoint is a complete SfMData: loading it as input scene resumes the
+   *  reconstruction (SfM augmentation mode).
+   */
+  static const char* checkpointFilename()
+  {
+    return "sfm_checkpoint.sfmb";
+  }
+
   void setLocalBundleAdjustmentGraphDistance(std::size_t distance)
   {
     if(_uselocalBundleAdjustment)
@@ -129,6 +148,15 @@ public:
       _localStrategyGraph = std::make_shared<LocalBundleAdjustmentGraph>(_sfmData);
   }
 
+  /**
+   * @brief Use the GPU PCG bundle adjustment backend for the global adjustments
+   * (no effect when the local strategy applies or without CUDA support).
+   */
+  void setUseGPUBundleAdjustment(bool useGPU)
+  {
+    _useGPUBundleAdjustment = useGPU;
+  }
+
   /**
    * @brief Process the entire incremental reconstruction
    * @return true if done
@@ -384,6 +412,7 @@ private:
   int _minTrackLength = 2;
   int _minPointsPerPose = 30;
   bool _uselocalBundleAdjustment = false;
+  bool _useGPUBundleAdjustment = false;
   bool _useRigConstraint = true;
   /// minimum number of obersvations to triangulate a 3d point.
   std::size_t _minNbObservationsForTriangulation = 2;
@@ -411,8 +440,9 @@ private:
 
   // Temporary data
 
-  /// Putative landmark tracks (visibility per potential 3D point)
-  track::TracksMap _map_tracks;
+  /// Putative landmark tracks (visibility per potential 3D point), stored in
+  /// the compact CSR layout (one observation arena with per-track spans)
+  track::FlatTracks _flatTracks;
   /// Putative tracks per view
   track::TracksPerView _map_tracksPerView;
   /// Precomputed pyramid index for each trackId of each viewId.
@@ -432,6 +462,8 @@ private:
   const std::string _sfmStepFolder;
   /// extension of the intermediate reconstruction files
   std::string _sfmStepFileExtension = ".ply";
+  /// number of resection groups between two reconstruction checkpoint files (0: disabled)
+  std::size_t _checkpointInterval = 0;
   /// filter for the intermediate reconstruction files
   sfmDataIO::ESfMData _sfmStepFilter = sfmDataIO::ESfMData(sfmDataIO::VIEWS |
                                                            sfmDataIO::EXTRINSICS |
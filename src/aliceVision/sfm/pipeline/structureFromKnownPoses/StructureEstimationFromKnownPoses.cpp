@@ -65,6 +65,12 @@ void StructureEstimationFromKnownPoses::run(
 {
   sfmData.structure.clear();
 
+  // guided matching and triangulation undistort every feature of every pair
+  // through remove_disto: cache the inverse distortion once per intrinsic
+  // instead of running the iterative bisection per point
+  for(auto& intrinsicPair : sfmData.getIntrinsics())
+    intrinsicPair.second->enableInverseDistortionCache();
+
   match(sfmData, pairs, regionsPerView);
   filter(sfmData, pairs, regionsPerView);
   triangulate(sfmData, regionsPerView);
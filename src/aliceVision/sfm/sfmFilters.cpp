@@ -11,6 +11,7 @@
 #include <aliceVision/system/Logger.hpp>
 
 #include <iterator>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
@@ -20,11 +21,21 @@ IndexT RemoveOutliers_PixelResidualError(sfmData::SfMData& sfmData,
                                          const unsigned int minTrackLength)
 {
   IndexT outlier_count = 0;
-  sfmData::Landmarks::iterator iterTracks = sfmData.structure.begin();
 
-  while(iterTracks != sfmData.structure.end())
+  // mark phase: the residual evaluation and the observation pruning only
+  // touch their own landmark, so the landmarks are processed in parallel
+  std::vector<sfmData::Landmarks::iterator> landmarkIts;
+  landmarkIts.reserve(sfmData.structure.size());
+  for(sfmData::Landmarks::iterator it = sfmData.structure.begin(); it != sfmData.structure.end(); ++it)
+    landmarkIts.push_back(it);
+
+  std::vector<char> removeLandmark(landmarkIts.size(), 0);
+
+  #pragma omp parallel for reduction(+:outlier_count)
+  for(int i = 0; i < static_cast<int>(landmarkIts.size()); ++i)
   {
-    sfmData::Observations & observations = iterTracks->second.observations;
+    sfmData::Landmark& landmark = landmarkIts.at(i)->second;
+    sfmData::Observations & observations = landmark.observations;
     sfmData::Observations::iterator itObs = observations.begin();
 
     while(itObs != observations.end())
@@ -32,9 +43,9 @@ IndexT RemoveOutliers_PixelResidualError(sfmData::SfMData& sfmData,
       const sfmData::View * view = sfmData.views.at(itObs->first).get();
       const geometry::Pose3 pose = sfmData.getPose(*view).getTransform();
       const camera::IntrinsicBase * intrinsic = sfmData.intrinsics.at(view->getIntrinsicId()).get();
-      const Vec2 residual = intrinsic->residual(pose, iterTracks->second.X, itObs->second.x);
+      const Vec2 residual = intrinsic->residual(pose, landmark.X, itObs->second.x);
 
-      if((pose.depth(iterTracks->second.X) < 0) || (residual.norm() > dThresholdPixel))
+      if((pose.depth(landmark.X) < 0) || (residual.norm() > dThresholdPixel))
       {
         ++outlier_count;
         itObs = observations.erase(itObs);
@@ -44,9 +55,14 @@ IndexT RemoveOutliers_PixelResidualError(sfmData::SfMData& sfmData,
     }
 
     if (observations.empty() || observations.size() < minTrackLength)
-      iterTracks = sfmData.structure.erase(iterTracks);
-    else
-      ++iterTracks;
+      removeLandmark.at(i) = 1;
+  }
+
+  // sweep phase: erase the marked landmarks, the stored iterators stay valid
+  for(std::size_t i = 0; i < landmarkIts.size(); ++i)
+  {
+    if(removeLandmark.at(i))
+      sfmData.structure.erase(landmarkIts.at(i));
   }
   return outlier_count;
 }
@@ -54,11 +70,19 @@ IndexT RemoveOutliers_PixelResidualError(sfmData::SfMData& sfmData,
 IndexT RemoveOutliers_AngleError(sfmData::SfMData& sfmData, const double dMinAcceptedAngle)
 {
   IndexT removedTrack_count = 0;
-  sfmData::Landmarks::iterator iterTracks = sfmData.structure.begin();
 
-  while(iterTracks != sfmData.structure.end())
+  // mark phase: the angle evaluation is independent between landmarks
+  std::vector<sfmData::Landmarks::iterator> landmarkIts;
+  landmarkIts.reserve(sfmData.structure.size());
+  for(sfmData::Landmarks::iterator it = sfmData.structure.begin(); it != sfmData.structure.end(); ++it)
+    landmarkIts.push_back(it);
+
+  std::vector<char> removeLandmark(landmarkIts.size(), 0);
+
+  #pragma omp parallel for
+  for(int i = 0; i < static_cast<int>(landmarkIts.size()); ++i)
   {
-    sfmData::Observations & observations = iterTracks->second.observations;
+    const sfmData::Observations & observations = landmarkIts.at(i)->second.observations;
     double max_angle = 0.0;
     for(sfmData::Observations::const_iterator itObs1 = observations.begin(); itObs1 != observations.end(); ++itObs1)
     {
@@ -80,12 +104,17 @@ IndexT RemoveOutliers_AngleError(sfmData::SfMData& sfmData, const double dMinAcc
       }
     }
     if (max_angle < dMinAcceptedAngle)
+      removeLandmark.at(i) = 1;
+  }
+
+  // sweep phase: erase the marked landmarks, the stored iterators stay valid
+  for(std::size_t i = 0; i < landmarkIts.size(); ++i)
+  {
+    if(removeLandmark.at(i))
     {
-      iterTracks = sfmData.structure.erase(iterTracks);
+      sfmData.structure.erase(landmarkIts.at(i));
       ++removedTrack_count;
     }
-    else
-      ++iterTracks;
   }
   return removedTrack_count;
 }
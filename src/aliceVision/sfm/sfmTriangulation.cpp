@@ -12,8 +12,8 @@
 
 #include <boost/progress.hpp>
 
-#include <deque>
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
@@ -31,7 +31,20 @@ StructureComputation_blind::StructureComputation_blind(bool verbose)
 
 void StructureComputation_blind::triangulate(sfmData::SfMData& sfmData) const
 {
-  std::deque<IndexT> rejectedId;
+  // flatten the landmarks to allow a parallel loop with a per-track result slot
+  std::vector<sfmData::Landmarks::iterator> landmarkIts;
+  landmarkIts.reserve(sfmData.structure.size());
+  for(sfmData::Landmarks::iterator iterTracks = sfmData.structure.begin();
+    iterTracks != sfmData.structure.end();
+    ++iterTracks)
+  {
+    landmarkIts.push_back(iterTracks);
+  }
+
+  // per-track triangulation results, committed to the landmarks map single-threaded afterwards
+  std::vector<Vec3> results(landmarkIts.size());
+  std::vector<char> validResults(landmarkIts.size(), false);
+
   std::unique_ptr<boost::progress_display> my_progress_bar;
   if (_bConsoleVerbose)
     my_progress_bar.reset( new boost::progress_display(
@@ -39,11 +52,12 @@ void StructureComputation_blind::triangulate(sfmData::SfMData& sfmData) const
     std::cout,
     "Blind triangulation progress:\n" ));
   #pragma omp parallel
-  for(sfmData::Landmarks::iterator iterTracks = sfmData.structure.begin();
-    iterTracks != sfmData.structure.end();
-    ++iterTracks)
   {
-    #pragma omp single nowait
+    // accumulator reused from one track to the next to avoid a per-track allocation
+    Triangulation trianObj;
+
+    #pragma omp for
+    for(int i = 0; i < static_cast<int>(landmarkIts.size()); ++i)
     {
       if (_bConsoleVerbose)
       {
@@ -51,8 +65,8 @@ void StructureComputation_blind::triangulate(sfmData::SfMData& sfmData) const
         ++(*my_progress_bar);
       }
       // Triangulate each landmark
-      Triangulation trianObj;
-      const sfmData::Observations & observations = iterTracks->second.observations;
+      trianObj.clear();
+      const sfmData::Observations & observations = landmarkIts[i]->second.observations;
       for(const auto& itObs : observations)
       {
         const sfmData::View * view = sfmData.views.at(itObs.first).get();
@@ -65,35 +79,26 @@ void StructureComputation_blind::triangulate(sfmData::SfMData& sfmData) const
             cam->get_ud_pixel(itObs.second.x));
         }
       }
-      if (trianObj.size() < 2)
-      {
-        #pragma omp critical
-        {
-          rejectedId.push_front(iterTracks->first);
-        }
-      }
-      else
+      if (trianObj.size() >= 2)
       {
         // Compute the 3D point
         const Vec3 X = trianObj.compute();
         if (trianObj.minDepth() > 0) // Keep the point only if it have a positive depth
         {
-          iterTracks->second.X = X;
-        }
-        else
-        {
-          #pragma omp critical
-          {
-            rejectedId.push_front(iterTracks->first);
-          }
+          results[i] = X;
+          validResults[i] = true;
         }
       }
     }
   }
-  // Erase the unsuccessful triangulated tracks
-  for (auto& it : rejectedId)
+  // single-threaded commit: update the successful tracks,
+  // erase the unsuccessful triangulated ones
+  for (std::size_t i = 0; i < landmarkIts.size(); ++i)
   {
-    sfmData.structure.erase(it);
+    if (validResults.at(i))
+      landmarkIts.at(i)->second.X = results.at(i);
+    else
+      sfmData.structure.erase(landmarkIts.at(i));
   }
 }
 
@@ -111,42 +116,48 @@ void StructureComputation_robust::triangulate(sfmData::SfMData& sfmData) const
 /// Invalid landmark are removed.
 void StructureComputation_robust::robust_triangulation(sfmData::SfMData& sfmData) const
 {
-  std::deque<IndexT> rejectedId;
+  // flatten the landmarks to allow a parallel loop with a per-track result slot
+  std::vector<sfmData::Landmarks::iterator> landmarkIts;
+  landmarkIts.reserve(sfmData.structure.size());
+  for(sfmData::Landmarks::iterator iterTracks = sfmData.structure.begin();
+    iterTracks != sfmData.structure.end();
+    ++iterTracks)
+  {
+    landmarkIts.push_back(iterTracks);
+  }
+
+  // per-track triangulation results, committed to the landmarks map single-threaded afterwards
+  std::vector<Vec3> results(landmarkIts.size());
+  std::vector<char> validResults(landmarkIts.size(), false);
+
   std::unique_ptr<boost::progress_display> my_progress_bar;
   if(_bConsoleVerbose)
     my_progress_bar.reset( new boost::progress_display(
     sfmData.structure.size(),
     std::cout,
     "Robust triangulation progress:\n" ));
-  #pragma omp parallel
-  for(sfmData::Landmarks::iterator iterTracks = sfmData.structure.begin();
-    iterTracks != sfmData.structure.end();
-    ++iterTracks)
+  #pragma omp parallel for
+  for(int i = 0; i < static_cast<int>(landmarkIts.size()); ++i)
   {
-    #pragma omp single nowait
+    if (_bConsoleVerbose)
     {
-      if (_bConsoleVerbose)
-      {
-        #pragma omp critical
-        ++(*my_progress_bar);
-      }
-      Vec3 X;
-      if (robust_triangulation(sfmData, iterTracks->second.observations, X)) {
-        iterTracks->second.X = X;
-      }
-      else {
-        iterTracks->second.X = Vec3::Zero();
-        #pragma omp critical
-        {
-          rejectedId.push_front(iterTracks->first);
-        }
-      }
+      #pragma omp critical
+      ++(*my_progress_bar);
+    }
+    Vec3 X;
+    if (robust_triangulation(sfmData, landmarkIts[i]->second.observations, X)) {
+      results[i] = X;
+      validResults[i] = true;
     }
   }
-  // Erase the unsuccessful triangulated tracks
-  for(auto& it : rejectedId)
+  // single-threaded commit: update the successful tracks,
+  // erase the unsuccessful triangulated ones
+  for (std::size_t i = 0; i < landmarkIts.size(); ++i)
   {
-    sfmData.structure.erase(it);
+    if (validResults.at(i))
+      landmarkIts.at(i)->second.X = results.at(i);
+    else
+      sfmData.structure.erase(landmarkIts.at(i));
   }
 }
 
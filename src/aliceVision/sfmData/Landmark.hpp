@@ -38,6 +38,8 @@ struct Observation
 };
 
 /// Observations are indexed by their View_id
+/// note: flat sorted storage, the observations of a landmark are contiguous in memory
+///       and iterated in increasing view id order (no per-node allocation)
 typedef stl::flat_map<IndexT, Observation> Observations;
 
 /**
@@ -12,6 +12,7 @@
 #include <aliceVision/sfmData/View.hpp>
 #include <aliceVision/sfmData/Rig.hpp>
 #include <aliceVision/camera/camera.hpp>
+#include <aliceVision/stl/FlatMap.hpp>
 #include <aliceVision/types.hpp>
 
 #include <stdexcept>
@@ -20,14 +21,20 @@
 namespace aliceVision {
 namespace sfmData {
 
+// The views, poses and intrinsics are iterated by every stage of the pipeline,
+// so they are stored in contiguous sorted vectors (same map API) instead of
+// node based maps: the elements behind the shared_ptr keep a stable address,
+// only iterators/references into the containers are invalidated on insertion.
+
 /// Define a collection of View
-using Views = HashMap<IndexT, std::shared_ptr<View> >;
+using Views = stl::flat_map<IndexT, std::shared_ptr<View> >;
 
 /// Define a collection of Pose (indexed by view.getPoseId())
-using Poses = HashMap<IndexT, CameraPose>;
+using Poses = stl::flat_map<IndexT, CameraPose, std::less<IndexT>,
+                            Eigen::aligned_allocator<std::pair<IndexT, CameraPose> > >;
 
 /// Define a collection of IntrinsicParameter (indexed by view.getIntrinsicId())
-using Intrinsics = HashMap<IndexT, std::shared_ptr<camera::IntrinsicBase> >;
+using Intrinsics = stl::flat_map<IndexT, std::shared_ptr<camera::IntrinsicBase> >;
 
 /// Define a collection of landmarks are indexed by their TrackId
 using Landmarks = HashMap<IndexT, Landmark>;
@@ -80,6 +80,16 @@ struct AlembicExporter::DataImpl
   Alembic::AbcGeom::OUInt32Property _propIntrinsicId;
   Alembic::AbcGeom::OStringProperty _mvgIntrinsicType;
   Alembic::AbcGeom::ODoubleArrayProperty _mvgIntrinsicParams;
+
+  // last written animated camera samples
+  // an unchanged sample is written with setFromPrevious, which only stores a
+  // sample index, so a constant intrinsic costs nothing per keyframe
+  std::vector<::uint32_t> _lastSensorSize_pix;
+  std::string _lastIntrinsicType;
+  std::vector<double> _lastIntrinsicParams;
+  float _lastFocalLength_mm = 0.0f;
+  float _lastHaperture_cm = 0.0f;
+  float _lastVaperture_cm = 0.0f;
 };
 
 
@@ -527,6 +537,11 @@ void AlembicExporter::initAnimatedCamera(const std::string& cameraName, std::siz
   // Intrinsic parameters
   _dataImpl->_mvgIntrinsicParams = ODoubleArrayProperty(userProps, "mvg_intrinsicParams");
   _dataImpl->_mvgIntrinsicParams.setTimeSampling(tsp);
+
+  // reset the last written samples, the properties belong to the new camera
+  _dataImpl->_lastSensorSize_pix.clear();
+  _dataImpl->_lastIntrinsicType.clear();
+  _dataImpl->_lastIntrinsicParams.clear();
 }
 
 void AlembicExporter::addCameraKeyframe(const geometry::Pose3& pose,
@@ -590,11 +605,21 @@ void AlembicExporter::addCameraKeyframe(const geometry::Pose3& pose,
   camSample.setFocalLength(focalLength_mm);
   camSample.setHorizontalAperture(haperture_cm);
   camSample.setVerticalAperture(vaperture_cm);
-  
+
+  // the first sample of each property must be a plain set, the next ones
+  // reuse the previous sample when unchanged to keep the memory bounded
+  const bool hasSamples = (_dataImpl->_propSensorSize_pix.getNumSamples() != 0);
+
   // Add sensor size in pixels as custom property
   std::vector<::uint32_t> sensorSize_pix = {cam->w(), cam->h()};
-  _dataImpl->_propSensorSize_pix.set(sensorSize_pix);
-  
+  if(hasSamples && sensorSize_pix == _dataImpl->_lastSensorSize_pix)
+    _dataImpl->_propSensorSize_pix.setFromPrevious();
+  else
+  {
+    _dataImpl->_propSensorSize_pix.set(sensorSize_pix);
+    _dataImpl->_lastSensorSize_pix = sensorSize_pix;
+  }
+
   // Set custom attributes
   // Image path
   _dataImpl->_imagePlane.set(imagePath);
@@ -603,14 +628,40 @@ void AlembicExporter::addCameraKeyframe(const geometry::Pose3& pose,
   _dataImpl->_propViewId.set(viewId);
   // Intrinsic id
   _dataImpl->_propIntrinsicId.set(intrinsicId);
+
   // Intrinsic type
-  _dataImpl->_mvgIntrinsicType.set(cam->getTypeStr());
+  const std::string intrinsicType = cam->getTypeStr();
+  if(hasSamples && intrinsicType == _dataImpl->_lastIntrinsicType)
+    _dataImpl->_mvgIntrinsicType.setFromPrevious();
+  else
+  {
+    _dataImpl->_mvgIntrinsicType.set(intrinsicType);
+    _dataImpl->_lastIntrinsicType = intrinsicType;
+  }
+
   // Intrinsic parameters
   std::vector<double> intrinsicParams = cam->getParams();
-  _dataImpl->_mvgIntrinsicParams.set(intrinsicParams);
-  
+  if(hasSamples && intrinsicParams == _dataImpl->_lastIntrinsicParams)
+    _dataImpl->_mvgIntrinsicParams.setFromPrevious();
+  else
+  {
+    _dataImpl->_mvgIntrinsicParams.set(intrinsicParams);
+    _dataImpl->_lastIntrinsicParams = intrinsicParams;
+  }
+
   // Attach intrinsic parameters to camera object
-  _dataImpl->_camObj.getSchema().set(camSample);
+  if(hasSamples &&
+     focalLength_mm == _dataImpl->_lastFocalLength_mm &&
+     haperture_cm == _dataImpl->_lastHaperture_cm &&
+     vaperture_cm == _dataImpl->_lastVaperture_cm)
+    _dataImpl->_camObj.getSchema().setFromPrevious();
+  else
+  {
+    _dataImpl->_camObj.getSchema().set(camSample);
+    _dataImpl->_lastFocalLength_mm = focalLength_mm;
+    _dataImpl->_lastHaperture_cm = haperture_cm;
+    _dataImpl->_lastVaperture_cm = vaperture_cm;
+  }
 }
 
 void AlembicExporter::jumpKeyframe(const std::string& imagePath)
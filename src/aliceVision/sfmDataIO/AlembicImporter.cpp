@@ -11,6 +11,8 @@
 #include <Alembic/AbcCoreFactory/All.h>
 #include <Alembic/AbcCoreOgawa/All.h>
 
+#include <vector>
+
 namespace aliceVision {
 namespace sfmDataIO {
 
@@ -113,12 +115,20 @@ bool readPointCloud(IObject iObj, M44d mat, sfmData::SfMData &sfmdata, ESfMData
 
   // Number of points before adding the Alembic data
   const std::size_t nbPointsInit = sfmdata.structure.size();
+
+  // keep the landmark pointers for the observations pass, a map lookup per point would be useless
+  std::vector<sfmData::Landmark*> landmarks(positions->size());
+
   for(std::size_t point3d_i = 0;
       point3d_i < positions->size();
       ++point3d_i)
   {
     const P3fArraySamplePtr::element_type::value_type & pos_i = positions->get()[point3d_i];
-    sfmData::Landmark& landmark = sfmdata.structure[nbPointsInit + point3d_i] = sfmData::Landmark(Vec3(pos_i.x, pos_i.y, pos_i.z), feature::EImageDescriberType::UNKNOWN);
+    // the landmark ids are increasing, the end hint makes the insertion constant time
+    const auto landmarkIt = sfmdata.structure.emplace_hint(sfmdata.structure.end(),
+        nbPointsInit + point3d_i, sfmData::Landmark(Vec3(pos_i.x, pos_i.y, pos_i.z), feature::EImageDescriberType::UNKNOWN));
+    sfmData::Landmark& landmark = landmarkIt->second;
+    landmarks.at(point3d_i) = &landmark;
 
     if(sampleColors)
     {
@@ -136,7 +146,8 @@ bool readPointCloud(IObject iObj, M44d mat, sfmData::SfMData &sfmdata, ESfMData
     }
   }
 
-  if(userProps &&
+  if((flags_part & ESfMData::OBSERVATIONS) &&
+     userProps &&
      userProps.getPropertyHeader("mvg_visibilitySize") &&
      userProps.getPropertyHeader("mvg_visibilityIds") &&
      userProps.getPropertyHeader("mvg_visibilityFeatPos"))
@@ -168,14 +179,22 @@ bool readPointCloud(IObject iObj, M44d mat, sfmData::SfMData &sfmdata, ESfMData
       return false;
     }
 
-    std::size_t obsGlobal_i = 0;
+    // prefix sum of the observation counts, to fill the landmarks in parallel
+    std::vector<std::size_t> obsOffsets(positions->size() + 1, 0);
     for(std::size_t point3d_i = 0;
         point3d_i < positions->size();
         ++point3d_i)
+      obsOffsets.at(point3d_i + 1) = obsOffsets.at(point3d_i) + (*sampleVisibilitySize)[point3d_i];
+
+    #pragma omp parallel for
+    for(int point3d_i = 0;
+        point3d_i < static_cast<int>(positions->size());
+        ++point3d_i)
     {
-      sfmData::Landmark& landmark = sfmdata.structure[nbPointsInit + point3d_i];
+      sfmData::Landmark& landmark = *(landmarks.at(point3d_i));
       // Number of observation for this 3d point
       const std::size_t visibilitySize = (*sampleVisibilitySize)[point3d_i];
+      std::size_t obsGlobal_i = obsOffsets.at(point3d_i) * 2;
 
       for(std::size_t obs_i = 0;
           obs_i < visibilitySize*2;
@@ -577,9 +596,12 @@ void visitObject(IObject iObj, M44d mat, sfmData::SfMData& sfmdata, ESfMData fla
     isReconstructed = false;
   
   const MetaData& md = iObj.getMetaData();
-  if(IPoints::matches(md) && (flagsPart & ESfMData::STRUCTURE))
+  if(IPoints::matches(md))
   {
-    readPointCloud(iObj, mat, sfmdata, flagsPart);
+    if(flagsPart & ESfMData::STRUCTURE)
+      readPointCloud(iObj, mat, sfmdata, flagsPart);
+    // nothing relevant below a point cloud, no need to recurse
+    return;
   }
   else if(IXform::matches(md))
   {
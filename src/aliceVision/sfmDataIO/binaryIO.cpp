@@ -0,0 +1,676 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "binaryIO.hpp"
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+namespace {
+
+const char SFMB_MAGIC[4] = {'A', 'V', 'S', 'B'};
+const std::uint32_t SFMB_VERSION = 1;
+
+template<typename T>
+void write(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+void read(std::istream& is, T& value)
+{
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& os, const std::string& value)
+{
+  write(os, static_cast<std::uint32_t>(value.size()));
+  os.write(value.data(), value.size());
+}
+
+void readString(std::istream& is, std::string& value)
+{
+  std::uint32_t size = 0;
+  read(is, size);
+  value.resize(size);
+  is.read(&value[0], size);
+}
+
+void writePose3(std::ostream& os, const geometry::Pose3& pose)
+{
+  const Mat3 rotation = pose.rotation();
+  const Vec3 center = pose.center();
+  os.write(reinterpret_cast<const char*>(rotation.data()), 9 * sizeof(double));
+  os.write(reinterpret_cast<const char*>(center.data()), 3 * sizeof(double));
+}
+
+void readPose3(std::istream& is, geometry::Pose3& pose)
+{
+  Mat3 rotation;
+  Vec3 center;
+  is.read(reinterpret_cast<char*>(rotation.data()), 9 * sizeof(double));
+  is.read(reinterpret_cast<char*>(center.data()), 3 * sizeof(double));
+  pose = geometry::Pose3(rotation, center);
+}
+
+/**
+ * @brief Write a set of landmarks (structure or control points) as flat arrays:
+ * each attribute is gathered in a contiguous buffer written in one block, so
+ * the cost does not depend on a per-landmark object creation.
+ */
+void writeLandmarks(std::ostream& os, const sfmData::Landmarks& landmarks)
+{
+  const std::size_t nbLandmarks = landmarks.size();
+  std::size_t nbObservations = 0;
+  for(const auto& landmarkPair : landmarks)
+    nbObservations += landmarkPair.second.observations.size();
+
+  // section byte size (without this field), allows skipping the section
+  const std::uint64_t sectionSize =
+      2 * sizeof(std::uint64_t) +
+      nbLandmarks * (2 * sizeof(std::uint32_t) + 3 * sizeof(double) + 3 * sizeof(unsigned char) + sizeof(std::uint32_t)) +
+      nbObservations * (2 * sizeof(std::uint32_t) + 2 * sizeof(double));
+  write(os, sectionSize);
+  write(os, static_cast<std::uint64_t>(nbLandmarks));
+  write(os, static_cast<std::uint64_t>(nbObservations));
+
+  std::vector<std::uint32_t> landmarkIds;
+  std::vector<std::uint32_t> descTypes;
+  std::vector<double> positions;
+  std::vector<unsigned char> colors;
+  std::vector<std::uint32_t> nbObsPerLandmark;
+  std::vector<std::uint32_t> obsViewIds;
+  std::vector<std::uint32_t> obsFeatureIds;
+  std::vector<double> obsPositions;
+
+  landmarkIds.reserve(nbLandmarks);
+  descTypes.reserve(nbLandmarks);
+  positions.reserve(3 * nbLandmarks);
+  colors.reserve(3 * nbLandmarks);
+  nbObsPerLandmark.reserve(nbLandmarks);
+  obsViewIds.reserve(nbObservations);
+  obsFeatureIds.reserve(nbObservations);
+  obsPositions.reserve(2 * nbObservations);
+
+  for(const auto& landmarkPair : landmarks)
+  {
+    const sfmData::Landmark& landmark = landmarkPair.second;
+
+    landmarkIds.push_back(landmarkPair.first);
+    descTypes.push_back(static_cast<std::uint32_t>(landmark.descType));
+    positions.push_back(landmark.X(0));
+    positions.push_back(landmark.X(1));
+    positions.push_back(landmark.X(2));
+    colors.push_back(landmark.rgb.r());
+    colors.push_back(landmark.rgb.g());
+    colors.push_back(landmark.rgb.b());
+    nbObsPerLandmark.push_back(static_cast<std::uint32_t>(landmark.observations.size()));
+
+    for(const auto& obsPair : landmark.observations)
+    {
+      obsViewIds.push_back(obsPair.first);
+      obsFeatureIds.push_back(obsPair.second.id_feat);
+      obsPositions.push_back(obsPair.second.x(0));
+      obsPositions.push_back(obsPair.second.x(1));
+    }
+  }
+
+  os.write(reinterpret_cast<const char*>(landmarkIds.data()), landmarkIds.size() * sizeof(std::uint32_t));
+  os.write(reinterpret_cast<const char*>(descTypes.data()), descTypes.size() * sizeof(std::uint32_t));
+  os.write(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(double));
+  os.write(reinterpret_cast<const char*>(colors.data()), colors.size() * sizeof(unsigned char));
+  os.write(reinterpret_cast<const char*>(nbObsPerLandmark.data()), nbObsPerLandmark.size() * sizeof(std::uint32_t));
+  os.write(reinterpret_cast<const char*>(obsViewIds.data()), obsViewIds.size() * sizeof(std::uint32_t));
+  os.write(reinterpret_cast<const char*>(obsFeatureIds.data()), obsFeatureIds.size() * sizeof(std::uint32_t));
+  os.write(reinterpret_cast<const char*>(obsPositions.data()), obsPositions.size() * sizeof(double));
+}
+
+void readLandmarks(std::istream& is, sfmData::Landmarks& landmarks, bool skip)
+{
+  std::uint64_t sectionSize = 0;
+  read(is, sectionSize);
+
+  if(skip)
+  {
+    is.seekg(sectionSize, std::ios::cur);
+    return;
+  }
+
+  std::uint64_t nbLandmarks = 0;
+  std::uint64_t nbObservations = 0;
+  read(is, nbLandmarks);
+  read(is, nbObservations);
+
+  std::vector<std::uint32_t> landmarkIds(nbLandmarks);
+  std::vector<std::uint32_t> descTypes(nbLandmarks);
+  std::vector<double> positions(3 * nbLandmarks);
+  std::vector<unsigned char> colors(3 * nbLandmarks);
+  std::vector<std::uint32_t> nbObsPerLandmark(nbLandmarks);
+  std::vector<std::uint32_t> obsViewIds(nbObservations);
+  std::vector<std::uint32_t> obsFeatureIds(nbObservations);
+  std::vector<double> obsPositions(2 * nbObservations);
+
+  is.read(reinterpret_cast<char*>(landmarkIds.data()), landmarkIds.size() * sizeof(std::uint32_t));
+  is.read(reinterpret_cast<char*>(descTypes.data()), descTypes.size() * sizeof(std::uint32_t));
+  is.read(reinterpret_cast<char*>(positions.data()), positions.size() * sizeof(double));
+  is.read(reinterpret_cast<char*>(colors.data()), colors.size() * sizeof(unsigned char));
+  is.read(reinterpret_cast<char*>(nbObsPerLandmark.data()), nbObsPerLandmark.size() * sizeof(std::uint32_t));
+  is.read(reinterpret_cast<char*>(obsViewIds.data()), obsViewIds.size() * sizeof(std::uint32_t));
+  is.read(reinterpret_cast<char*>(obsFeatureIds.data()), obsFeatureIds.size() * sizeof(std::uint32_t));
+  is.read(reinterpret_cast<char*>(obsPositions.data()), obsPositions.size() * sizeof(double));
+
+  std::size_t obsIndex = 0;
+  for(std::size_t i = 0; i < nbLandmarks; ++i)
+  {
+    sfmData::Landmark& landmark = landmarks[landmarkIds[i]];
+
+    landmark.descType = static_cast<feature::EImageDescriberType>(descTypes[i]);
+    landmark.X = Vec3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+    landmark.rgb = image::RGBColor(colors[3 * i], colors[3 * i + 1], colors[3 * i + 2]);
+
+    // observations were saved in increasing view id order: build the flat sorted storage linearly
+    landmark.observations.reserve(nbObsPerLandmark[i]);
+
+    for(std::uint32_t o = 0; o < nbObsPerLandmark[i]; ++o, ++obsIndex)
+    {
+      landmark.observations.emplace_hint(landmark.observations.end(), obsViewIds[obsIndex],
+        sfmData::Observation(Vec2(obsPositions[2 * obsIndex], obsPositions[2 * obsIndex + 1]),
+                             obsFeatureIds[obsIndex]));
+    }
+  }
+}
+
+void writeView(std::ostream& os, const sfmData::View& view)
+{
+  write(os, view.getViewId());
+  write(os, view.getPoseId());
+  write(os, view.getRigId());
+  write(os, view.getSubPoseId());
+  write(os, view.getFrameId());
+  write(os, view.getIntrinsicId());
+  write(os, view.getResectionId());
+  write(os, static_cast<std::uint8_t>(view.isPoseIndependant()));
+  writeString(os, view.getImagePath());
+  write(os, static_cast<std::uint64_t>(view.getWidth()));
+  write(os, static_cast<std::uint64_t>(view.getHeight()));
+
+  write(os, static_cast<std::uint64_t>(view.getMetadata().size()));
+  for(const auto& metadataPair : view.getMetadata())
+  {
+    writeString(os, metadataPair.first);
+    writeString(os, metadataPair.second);
+  }
+}
+
+void readView(std::istream& is, sfmData::View& view)
+{
+  IndexT viewId, poseId, rigId, subPoseId, frameId, intrinsicId, resectionId;
+  std::uint8_t isPoseIndependant;
+  std::string imagePath;
+  std::uint64_t width, height;
+
+  read(is, viewId);
+  read(is, poseId);
+  read(is, rigId);
+  read(is, subPoseId);
+  read(is, frameId);
+  read(is, intrinsicId);
+  read(is, resectionId);
+  read(is, isPoseIndependant);
+  readString(is, imagePath);
+  read(is, width);
+  read(is, height);
+
+  view.setViewId(viewId);
+  view.setPoseId(poseId);
+  if(rigId != UndefinedIndexT)
+    view.setRigAndSubPoseId(rigId, subPoseId);
+  view.setFrameId(frameId);
+  view.setIntrinsicId(intrinsicId);
+  view.setResectionId(resectionId);
+  view.setIndependantPose(isPoseIndependant != 0);
+  view.setImagePath(imagePath);
+  view.setWidth(width);
+  view.setHeight(height);
+
+  std::uint64_t nbMetadata = 0;
+  read(is, nbMetadata);
+  for(std::uint64_t i = 0; i < nbMetadata; ++i)
+  {
+    std::string key, value;
+    readString(is, key);
+    readString(is, value);
+    view.addMetadata(key, value);
+  }
+}
+
+void writeIntrinsic(std::ostream& os, IndexT intrinsicId, const std::shared_ptr<camera::IntrinsicBase>& intrinsic)
+{
+  const camera::EINTRINSIC intrinsicType = intrinsic->getType();
+
+  write(os, intrinsicId);
+  write(os, static_cast<std::uint32_t>(intrinsic->w()));
+  write(os, static_cast<std::uint32_t>(intrinsic->h()));
+  writeString(os, camera::EINTRINSIC_enumToString(intrinsicType));
+  writeString(os, intrinsic->serialNumber());
+  write(os, intrinsic->initialFocalLengthPix());
+
+  const camera::Pinhole& pinholeIntrinsic = dynamic_cast<camera::Pinhole&>(*intrinsic);
+  write(os, pinholeIntrinsic.getFocalLengthPix());
+  const Vec2 principalPoint = pinholeIntrinsic.getPrincipalPoint();
+  write(os, principalPoint(0));
+  write(os, principalPoint(1));
+
+  const std::vector<double>& distortionParams = pinholeIntrinsic.getDistortionParams();
+  write(os, static_cast<std::uint64_t>(distortionParams.size()));
+  os.write(reinterpret_cast<const char*>(distortionParams.data()), distortionParams.size() * sizeof(double));
+
+  write(os, static_cast<std::uint8_t>(intrinsic->isLocked()));
+}
+
+void readIntrinsic(std::istream& is, IndexT& intrinsicId, std::shared_ptr<camera::IntrinsicBase>& intrinsic)
+{
+  std::uint32_t width, height;
+  std::string type, serialNumber;
+  double initialFocalLength, focalLength;
+  Vec2 principalPoint;
+
+  read(is, intrinsicId);
+  read(is, width);
+  read(is, height);
+  readString(is, type);
+  readString(is, serialNumber);
+  read(is, initialFocalLength);
+  read(is, focalLength);
+  read(is, principalPoint(0));
+  read(is, principalPoint(1));
+
+  const camera::EINTRINSIC intrinsicType = camera::EINTRINSIC_stringToEnum(type);
+  if(!camera::isPinhole(intrinsicType))
+    throw std::out_of_range("Only Pinhole camera model supported");
+
+  std::shared_ptr<camera::Pinhole> pinholeIntrinsic =
+      camera::createPinholeIntrinsic(intrinsicType, width, height, focalLength, principalPoint(0), principalPoint(1));
+  pinholeIntrinsic->setInitialFocalLengthPix(initialFocalLength);
+  pinholeIntrinsic->setSerialNumber(serialNumber);
+
+  std::uint64_t nbDistortionParams = 0;
+  read(is, nbDistortionParams);
+  std::vector<double> distortionParams(nbDistortionParams);
+  is.read(reinterpret_cast<char*>(distortionParams.data()), distortionParams.size() * sizeof(double));
+
+  // Ensure that we have the right number of params
+  distortionParams.resize(pinholeIntrinsic->getDistortionParams().size(), 0.0);
+  pinholeIntrinsic->setDistortionParams(distortionParams);
+  intrinsic = std::static_pointer_cast<camera::IntrinsicBase>(pinholeIntrinsic);
+
+  std::uint8_t locked = 0;
+  read(is, locked);
+  if(locked != 0)
+    intrinsic->lock();
+  else
+    intrinsic->unlock();
+}
+
+#if !defined(_WIN32)
+
+/**
+ * @brief Read-only streambuf over an existing buffer, used to parse a mapped
+ * shared-memory segment without copying it.
+ */
+class MemoryViewStreambuf : public std::streambuf
+{
+public:
+  MemoryViewStreambuf(char* data, std::size_t size)
+  {
+    setg(data, data, data + size);
+  }
+};
+
+/// POSIX shared-memory object names must start with a slash.
+std::string shmObjectName(const std::string& name)
+{
+  if(!name.empty() && name.front() == '/')
+    return name;
+  return "/" + name;
+}
+
+#endif // !defined(_WIN32)
+
+} // namespace
+
+bool saveBinary(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+  std::ofstream os(filename, std::ios::binary);
+  if(!os.is_open())
+  {
+    ALICEVISION_LOG_ERROR("Unable to create the SfM data file: '" << filename << "'.");
+    return false;
+  }
+  return saveBinary(sfmData, os, partFlag);
+}
+
+bool saveBinary(const sfmData::SfMData& sfmData, std::ostream& os, ESfMData partFlag)
+{
+  // save flags
+  const bool saveViews = (partFlag & VIEWS) == VIEWS;
+  const bool saveIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+  const bool saveExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+  const bool saveStructure = (partFlag & STRUCTURE) == STRUCTURE;
+  const bool saveControlPoints = (partFlag & CONTROL_POINTS) == CONTROL_POINTS;
+
+  os.write(SFMB_MAGIC, sizeof(SFMB_MAGIC));
+  write(os, SFMB_VERSION);
+
+  // folders
+  write(os, static_cast<std::uint64_t>(sfmData.getRelativeFeaturesFolders().size()));
+  for(const std::string& featuresFolder : sfmData.getRelativeFeaturesFolders())
+    writeString(os, featuresFolder);
+
+  write(os, static_cast<std::uint64_t>(sfmData.getRelativeMatchesFolders().size()));
+  for(const std::string& matchesFolder : sfmData.getRelativeMatchesFolders())
+    writeString(os, matchesFolder);
+
+  // views
+  write(os, static_cast<std::uint64_t>(saveViews ? sfmData.getViews().size() : 0));
+  if(saveViews)
+    for(const auto& viewPair : sfmData.getViews())
+      writeView(os, *(viewPair.second));
+
+  // intrinsics
+  write(os, static_cast<std::uint64_t>(saveIntrinsics ? sfmData.getIntrinsics().size() : 0));
+  if(saveIntrinsics)
+    for(const auto& intrinsicPair : sfmData.getIntrinsics())
+      writeIntrinsic(os, intrinsicPair.first, intrinsicPair.second);
+
+  // poses
+  write(os, static_cast<std::uint64_t>(saveExtrinsics ? sfmData.getPoses().size() : 0));
+  if(saveExtrinsics)
+  {
+    for(const auto& posePair : sfmData.getPoses())
+    {
+      write(os, posePair.first);
+      writePose3(os, posePair.second.getTransform());
+      write(os, static_cast<std::uint8_t>(posePair.second.isLocked()));
+    }
+  }
+
+  // rigs
+  write(os, static_cast<std::uint64_t>(saveExtrinsics ? sfmData.getRigs().size() : 0));
+  if(saveExtrinsics)
+  {
+    for(const auto& rigPair : sfmData.getRigs())
+    {
+      write(os, rigPair.first);
+      write(os, static_cast<std::uint64_t>(rigPair.second.getSubPoses().size()));
+      for(const sfmData::RigSubPose& rigSubPose : rigPair.second.getSubPoses())
+      {
+        write(os, static_cast<std::uint8_t>(rigSubPose.status));
+        writePose3(os, rigSubPose.pose);
+      }
+    }
+  }
+
+  const sfmData::Landmarks emptyLandmarks;
+
+  // structure
+  writeLandmarks(os, saveStructure ? sfmData.getLandmarks() : emptyLandmarks);
+
+  // control points
+  writeLandmarks(os, saveControlPoints ? sfmData.getControlPoints() : emptyLandmarks);
+
+  return os.good();
+}
+
+bool loadBinary(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+  std::ifstream is(filename, std::ios::binary);
+  if(!is.is_open())
+  {
+    ALICEVISION_LOG_ERROR("Unable to open the SfM data file: '" << filename << "'.");
+    return false;
+  }
+  return loadBinary(sfmData, is, partFlag);
+}
+
+bool loadBinary(sfmData::SfMData& sfmData, std::istream& is, ESfMData partFlag)
+{
+  // load flags
+  const bool loadViews = (partFlag & VIEWS) == VIEWS;
+  const bool loadIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+  const bool loadExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+  const bool loadStructure = (partFlag & STRUCTURE) == STRUCTURE;
+  const bool loadControlPoints = (partFlag & CONTROL_POINTS) == CONTROL_POINTS;
+
+  char magic[4];
+  std::uint32_t version = 0;
+  is.read(magic, sizeof(magic));
+  read(is, version);
+  if(!std::equal(magic, magic + sizeof(magic), SFMB_MAGIC) || version != SFMB_VERSION)
+  {
+    ALICEVISION_LOG_ERROR("Invalid SfM data binary stream (bad magic or version).");
+    return false;
+  }
+
+  // folders
+  std::uint64_t nbFeaturesFolders = 0;
+  read(is, nbFeaturesFolders);
+  for(std::uint64_t i = 0; i < nbFeaturesFolders; ++i)
+  {
+    std::string featuresFolder;
+    readString(is, featuresFolder);
+    sfmData.addFeaturesFolder(featuresFolder);
+  }
+
+  std::uint64_t nbMatchesFolders = 0;
+  read(is, nbMatchesFolders);
+  for(std::uint64_t i = 0; i < nbMatchesFolders; ++i)
+  {
+    std::string matchesFolder;
+    readString(is, matchesFolder);
+    sfmData.addMatchesFolder(matchesFolder);
+  }
+
+  // views
+  std::uint64_t nbViews = 0;
+  read(is, nbViews);
+  if(loadViews)
+    sfmData.getViews().reserve(nbViews);
+  for(std::uint64_t i = 0; i < nbViews; ++i)
+  {
+    sfmData::View view;
+    readView(is, view);
+    if(loadViews)
+      sfmData.getViews().emplace(view.getViewId(), std::make_shared<sfmData::View>(view));
+  }
+
+  // intrinsics
+  std::uint64_t nbIntrinsics = 0;
+  read(is, nbIntrinsics);
+  if(loadIntrinsics)
+    sfmData.getIntrinsics().reserve(nbIntrinsics);
+  for(std::uint64_t i = 0; i < nbIntrinsics; ++i)
+  {
+    IndexT intrinsicId;
+    std::shared_ptr<camera::IntrinsicBase> intrinsic;
+    readIntrinsic(is, intrinsicId, intrinsic);
+    if(loadIntrinsics)
+      sfmData.getIntrinsics().emplace(intrinsicId, intrinsic);
+  }
+
+  // poses
+  std::uint64_t nbPoses = 0;
+  read(is, nbPoses);
+  if(loadExtrinsics)
+    sfmData.getPoses().reserve(nbPoses);
+  for(std::uint64_t i = 0; i < nbPoses; ++i)
+  {
+    IndexT poseId;
+    geometry::Pose3 transform;
+    std::uint8_t locked = 0;
+
+    read(is, poseId);
+    readPose3(is, transform);
+    read(is, locked);
+
+    if(loadExtrinsics)
+    {
+      sfmData::CameraPose pose;
+      pose.setTransform(transform);
+      if(locked != 0)
+        pose.lock();
+      sfmData.getPoses().emplace(poseId, pose);
+    }
+  }
+
+  // rigs
+  std::uint64_t nbRigs = 0;
+  read(is, nbRigs);
+  for(std::uint64_t i = 0; i < nbRigs; ++i)
+  {
+    IndexT rigId;
+    std::uint64_t nbSubPoses = 0;
+
+    read(is, rigId);
+    read(is, nbSubPoses);
+
+    sfmData::Rig rig(nbSubPoses);
+    for(std::uint64_t subPoseId = 0; subPoseId < nbSubPoses; ++subPoseId)
+    {
+      std::uint8_t status = 0;
+      sfmData::RigSubPose subPose;
+
+      read(is, status);
+      readPose3(is, subPose.pose);
+      subPose.status = static_cast<sfmData::ERigSubPoseStatus>(status);
+
+      rig.setSubPose(subPoseId, subPose);
+    }
+
+    if(loadExtrinsics)
+      sfmData.getRigs().emplace(rigId, rig);
+  }
+
+  // structure
+  readLandmarks(is, sfmData.getLandmarks(), !loadStructure);
+
+  // control points
+  readLandmarks(is, sfmData.getControlPoints(), !loadControlPoints);
+
+  return is.good();
+}
+
+#if !defined(_WIN32)
+
+bool saveBinaryShm(const sfmData::SfMData& sfmData, const std::string& name, ESfMData partFlag)
+{
+  // serialize first, the segment size must be known before mapping
+  std::ostringstream os(std::ios::binary);
+  if(!saveBinary(sfmData, os, partFlag))
+    return false;
+
+  const std::string buffer = os.str();
+  const std::string objectName = shmObjectName(name);
+
+  const int fd = shm_open(objectName.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if(fd < 0)
+  {
+    ALICEVISION_LOG_ERROR("Unable to create the shared-memory segment: '" << objectName << "'.");
+    return false;
+  }
+
+  if(ftruncate(fd, buffer.size()) != 0)
+  {
+    ALICEVISION_LOG_ERROR("Unable to resize the shared-memory segment: '" << objectName << "'.");
+    close(fd);
+    shm_unlink(objectName.c_str());
+    return false;
+  }
+
+  void* mapping = mmap(nullptr, buffer.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(mapping == MAP_FAILED)
+  {
+    ALICEVISION_LOG_ERROR("Unable to map the shared-memory segment: '" << objectName << "'.");
+    shm_unlink(objectName.c_str());
+    return false;
+  }
+
+  std::copy(buffer.begin(), buffer.end(), static_cast<char*>(mapping));
+  munmap(mapping, buffer.size());
+  return true;
+}
+
+bool loadBinaryShm(sfmData::SfMData& sfmData, const std::string& name, ESfMData partFlag)
+{
+  const std::string objectName = shmObjectName(name);
+
+  const int fd = shm_open(objectName.c_str(), O_RDONLY, 0);
+  if(fd < 0)
+  {
+    ALICEVISION_LOG_ERROR("Unable to open the shared-memory segment: '" << objectName << "'.");
+    return false;
+  }
+
+  struct stat fileStat;
+  if(fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+  {
+    ALICEVISION_LOG_ERROR("Unable to get the size of the shared-memory segment: '" << objectName << "'.");
+    close(fd);
+    return false;
+  }
+  const std::size_t size = static_cast<std::size_t>(fileStat.st_size);
+
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(mapping == MAP_FAILED)
+  {
+    ALICEVISION_LOG_ERROR("Unable to map the shared-memory segment: '" << objectName << "'.");
+    return false;
+  }
+
+  // the mapping is read-only, MemoryViewStreambuf never writes through it
+  MemoryViewStreambuf streambuf(static_cast<char*>(mapping), size);
+  std::istream is(&streambuf);
+  const bool status = loadBinary(sfmData, is, partFlag);
+
+  munmap(mapping, size);
+  return status;
+}
+
+#else // defined(_WIN32)
+
+bool saveBinaryShm(const sfmData::SfMData&, const std::string& name, ESfMData)
+{
+  ALICEVISION_LOG_ERROR("Shared-memory SfM data exchange ('shm://" << name << "') is only available on POSIX platforms.");
+  return false;
+}
+
+bool loadBinaryShm(sfmData::SfMData&, const std::string& name, ESfMData)
+{
+  ALICEVISION_LOG_ERROR("Shared-memory SfM data exchange ('shm://" << name << "') is only available on POSIX platforms.");
+  return false;
+}
+
+#endif // !defined(_WIN32)
+
+} // namespace sfmDataIO
+} // namespace aliceVision
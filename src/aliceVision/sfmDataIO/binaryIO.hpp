@@ -0,0 +1,85 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+
+#include <iosfwd>
+#include <string>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+/**
+ * @brief Save an SfMData in the binary '.sfmb' format.
+ *
+ * The structure (the hot part on large scenes) is stored as flat arrays
+ * (ids, positions, colors, observations) written in single blocks, so
+ * saving/loading does not allocate one node object per landmark as the
+ * JSON format does.
+ *
+ * @param[in] sfmData The input SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveBinary(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Save an SfMData in the binary '.sfmb' format into an arbitrary stream.
+ * @param[in] sfmData The input SfMData
+ * @param[in,out] os The output stream
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveBinary(const sfmData::SfMData& sfmData, std::ostream& os, ESfMData partFlag);
+
+/**
+ * @brief Load an SfMData from a binary '.sfmb' file.
+ * @param[out] sfmData The output SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadBinary(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Load an SfMData in the binary '.sfmb' format from an arbitrary stream.
+ * @param[out] sfmData The output SfMData
+ * @param[in,out] is The input stream
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadBinary(sfmData::SfMData& sfmData, std::istream& is, ESfMData partFlag);
+
+/**
+ * @brief Save an SfMData in the binary '.sfmb' format into a named shared-memory
+ * segment (POSIX shm), so pipeline steps running on the same host can hand the
+ * scene over without touching the filesystem.
+ *
+ * An existing segment with the same name is overwritten.
+ *
+ * @param[in] sfmData The input SfMData
+ * @param[in] name The shared-memory segment name (the part after 'shm://')
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveBinaryShm(const sfmData::SfMData& sfmData, const std::string& name, ESfMData partFlag);
+
+/**
+ * @brief Load an SfMData from a named shared-memory segment written by
+ * saveBinaryShm. The segment is mapped read-only and left in place, so several
+ * processes can load the same scene concurrently.
+ * @param[out] sfmData The output SfMData
+ * @param[in] name The shared-memory segment name (the part after 'shm://')
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadBinaryShm(sfmData::SfMData& sfmData, const std::string& name, ESfMData partFlag);
+
+} // namespace sfmDataIO
+} // namespace aliceVision
@@ -10,12 +10,151 @@
 
 #include <boost/property_tree/json_parser.hpp>
 
-#include <memory>
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <sstream>
 
 namespace aliceVision {
 namespace sfmDataIO {
 
+namespace {
+
+/**
+ * @brief Copy a JSON document, dropping the listed top-level sections.
+ *
+ * A minimal tokenizer (strings with escapes plus the '{['/']}'' nesting
+ * depth) is enough to locate the sections: their values are never
+ * materialized in the property tree, so a structure-free load of a large
+ * reconstruction does not pay for parsing the landmarks.
+ */
+std::string filterJsonSections(const std::string& document, const std::vector<std::string>& sectionsToSkip)
+{
+  std::string out;
+  out.reserve(document.size());
+
+  // consume a quoted string (with escapes) and return its content
+  const auto parseString = [&document](std::size_t& pos) -> std::string
+  {
+    std::string value;
+    ++pos; // opening quote
+    while(pos < document.size() && document[pos] != '"')
+    {
+      if(document[pos] == '\\' && pos + 1 < document.size())
+      {
+        value += document[pos];
+        ++pos;
+      }
+      value += document[pos];
+      ++pos;
+    }
+    ++pos; // closing quote
+    return value;
+  };
+
+  const auto skipWhitespace = [&document](std::size_t& pos)
+  {
+    while(pos < document.size() && std::isspace(static_cast<unsigned char>(document[pos])))
+      ++pos;
+  };
+
+  std::size_t i = 0;
+  int depth = 0;
+
+  while(i < document.size())
+  {
+    const char c = document[i];
+
+    if(c == '"')
+    {
+      const std::size_t start = i;
+      const std::string key = parseString(i);
+
+      if(depth == 1 &&
+         std::find(sectionsToSkip.begin(), sectionsToSkip.end(), key) != sectionsToSkip.end())
+      {
+        std::size_t probe = i;
+        skipWhitespace(probe);
+        if(probe < document.size() && document[probe] == ':')
+        {
+          // skip the value of the section
+          ++probe;
+          skipWhitespace(probe);
+          if(probe < document.size() && document[probe] == '"')
+          {
+            parseString(probe);
+          }
+          else if(probe < document.size() && (document[probe] == '{' || document[probe] == '['))
+          {
+            int valueDepth = 0;
+            while(probe < document.size())
+            {
+              const char v = document[probe];
+              if(v == '"')
+              {
+                parseString(probe);
+                continue;
+              }
+              if(v == '{' || v == '[')
+                ++valueDepth;
+              else if(v == '}' || v == ']')
+              {
+                --valueDepth;
+                if(valueDepth == 0)
+                {
+                  ++probe;
+                  break;
+                }
+              }
+              ++probe;
+            }
+          }
+          else
+          {
+            // scalar value
+            while(probe < document.size() && document[probe] != ',' && document[probe] != '}')
+              ++probe;
+          }
+
+          // drop the comma of the removed pair to keep the document valid
+          skipWhitespace(probe);
+          if(probe < document.size() && document[probe] == ',')
+          {
+            ++probe;
+          }
+          else
+          {
+            while(!out.empty() && std::isspace(static_cast<unsigned char>(out.back())))
+              out.pop_back();
+            if(!out.empty() && out.back() == ',')
+              out.pop_back();
+          }
+
+          i = probe;
+          continue;
+        }
+      }
+
+      out.append(document, start, i - start);
+      continue;
+    }
+
+    if(c == '{' || c == '[')
+      ++depth;
+    else if(c == '}' || c == ']')
+      --depth;
+
+    out += c;
+    ++i;
+  }
+
+  return out;
+}
+
+} // namespace
+
 void saveView(const std::string& name, const sfmData::View& view, bpt::ptree& parentTree)
 {
   bpt::ptree viewTree;
@@ -207,7 +346,7 @@ void loadRig(IndexT& rigId, sfmData::Rig& rig, bpt::ptree& rigTree)
   }
 }
 
-void saveLandmark(const std::string& name, IndexT landmarkId, const sfmData::Landmark& landmark, bpt::ptree& parentTree)
+void saveLandmark(const std::string& name, IndexT landmarkId, const sfmData::Landmark& landmark, bpt::ptree& parentTree, bool saveObservations)
 {
   bpt::ptree landmarkTree;
 
@@ -219,18 +358,21 @@ void saveLandmark(const std::string& name, IndexT landmarkId, const sfmData::Lan
 
   // observations
   bpt::ptree observationsTree;
-  for(const auto& obsPair : landmark.observations)
+  if(saveObservations)
   {
-    bpt::ptree obsTree;
+    for(const auto& obsPair : landmark.observations)
+    {
+      bpt::ptree obsTree;
 
-    const sfmData::Observation& observation = obsPair.second;
+      const sfmData::Observation& observation = obsPair.second;
 
-    obsTree.put("observationId", obsPair.first);
-    obsTree.put("featureId", observation.id_feat);
+      obsTree.put("observationId", obsPair.first);
+      obsTree.put("featureId", observation.id_feat);
 
-    saveMatrix("x", observation.x, obsTree);
+      saveMatrix("x", observation.x, obsTree);
 
-    observationsTree.push_back(std::make_pair("", obsTree));
+      observationsTree.push_back(std::make_pair("", obsTree));
+    }
   }
 
   landmarkTree.add_child("observations", observationsTree);
@@ -238,7 +380,7 @@ void saveLandmark(const std::string& name, IndexT landmarkId, const sfmData::Lan
   parentTree.push_back(std::make_pair(name, landmarkTree));
 }
 
-void loadLandmark(IndexT& landmarkId, sfmData::Landmark& landmark, bpt::ptree& landmarkTree)
+void loadLandmark(IndexT& landmarkId, sfmData::Landmark& landmark, bpt::ptree& landmarkTree, bool loadObservations)
 {
   landmarkId = landmarkTree.get<IndexT>("landmarkId");
   landmark.descType = feature::EImageDescriberType_stringToEnum(landmarkTree.get<std::string>("descType"));
@@ -246,8 +388,16 @@ void loadLandmark(IndexT& landmarkId, sfmData::Landmark& landmark, bpt::ptree& l
   loadMatrix("color", landmark.rgb, landmarkTree);
   loadMatrix("X", landmark.X, landmarkTree);
 
+  if(!loadObservations)
+    return;
+
   // observations
-  for(bpt::ptree::value_type &obsNode : landmarkTree.get_child("observations"))
+  bpt::ptree& observationsTree = landmarkTree.get_child("observations");
+
+  // observations were saved in increasing view id order: build the flat sorted storage linearly
+  landmark.observations.reserve(observationsTree.size());
+
+  for(bpt::ptree::value_type &obsNode : observationsTree)
   {
     bpt::ptree& obsTree = obsNode.second;
 
@@ -256,7 +406,7 @@ void loadLandmark(IndexT& landmarkId, sfmData::Landmark& landmark, bpt::ptree& l
     observation.id_feat = obsTree.get<IndexT>("featureId");
     loadMatrix("x", observation.x, obsTree);
 
-    landmark.observations.emplace(obsTree.get<IndexT>("observationId"), observation);
+    landmark.observations.emplace_hint(landmark.observations.end(), obsTree.get<IndexT>("observationId"), observation);
   }
 }
 
@@ -270,6 +420,7 @@ bool saveJSON(const sfmData::SfMData& sfmData, const std::string& filename, ESfM
   const bool saveIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
   const bool saveExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
   const bool saveStructure = (partFlag & STRUCTURE) == STRUCTURE;
+  const bool saveObservations = (partFlag & OBSERVATIONS) == OBSERVATIONS;
   const bool saveControlPoints = (partFlag & CONTROL_POINTS) == CONTROL_POINTS;
 
   // main tree
@@ -367,7 +518,7 @@ bool saveJSON(const sfmData::SfMData& sfmData, const std::string& filename, ESfM
     bpt::ptree structureTree;
 
     for(const auto& structurePair : sfmData.getLandmarks())
-      saveLandmark("", structurePair.first, structurePair.second, structureTree);
+      saveLandmark("", structurePair.first, structurePair.second, structureTree, saveObservations);
 
     fileTree.add_child("structure", structureTree);
   }
@@ -399,13 +550,43 @@ bool loadJSON(sfmData::SfMData& sfmData, const std::string& filename, ESfMData p
   const bool loadIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
   const bool loadExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
   const bool loadStructure = (partFlag & STRUCTURE) == STRUCTURE;
+  const bool loadObservations = (partFlag & OBSERVATIONS) == OBSERVATIONS;
   const bool loadControlPoints = (partFlag & CONTROL_POINTS) == CONTROL_POINTS;
 
   // main tree
   bpt::ptree fileTree;
 
+  // the sections that are not requested are dropped at the tokenizer level
+  // before filling the property tree: on large scenes parsing the landmarks
+  // dominates the loading time of a views/poses-only load
+  std::vector<std::string> sectionsToSkip;
+  if(!loadViews)
+    sectionsToSkip.push_back("views");
+  if(!loadIntrinsics)
+    sectionsToSkip.push_back("intrinsics");
+  if(!loadExtrinsics)
+  {
+    sectionsToSkip.push_back("poses");
+    sectionsToSkip.push_back("rigs");
+  }
+  if(!loadStructure)
+    sectionsToSkip.push_back("structure");
+  if(!loadControlPoints)
+    sectionsToSkip.push_back("controlPoints");
+
   // read the json file and initialize the tree
-  bpt::read_json(filename, fileTree);
+  if(sectionsToSkip.empty())
+  {
+    bpt::read_json(filename, fileTree);
+  }
+  else
+  {
+    std::ifstream fileStream(filename);
+    std::stringstream buffer;
+    buffer << fileStream.rdbuf();
+    std::istringstream filteredStream(filterJsonSections(buffer.str(), sectionsToSkip));
+    bpt::read_json(filteredStream, fileTree);
+  }
 
   // version
   loadMatrix("version", version, fileTree);
@@ -423,6 +604,7 @@ bool loadJSON(sfmData::SfMData& sfmData, const std::string& filename, ESfMData p
   if(loadIntrinsics && fileTree.count("intrinsics"))
   {
     sfmData::Intrinsics& intrinsics = sfmData.getIntrinsics();
+    intrinsics.reserve(fileTree.get_child("intrinsics").size());
 
     for(bpt::ptree::value_type &intrinsicNode : fileTree.get_child("intrinsics"))
     {
@@ -439,6 +621,7 @@ bool loadJSON(sfmData::SfMData& sfmData, const std::string& filename, ESfMData p
   if(loadViews && fileTree.count("views"))
   {
     sfmData::Views& views = sfmData.getViews();
+    views.reserve(fileTree.get_child("views").size());
 
     if(incompleteViews)
     {
@@ -453,7 +636,8 @@ bool loadJSON(sfmData::SfMData& sfmData, const std::string& filename, ESfMData p
       }
 
       // update incomplete views
-      #pragma omp parallel for
+      // dynamic scheduling, the metadata reads are I/O bound
+      #pragma omp parallel for schedule(dynamic)
       for(int i = 0; i < incompleteViews.size(); ++i)
       {
         sfmData::View& v = incompleteViews.at(i);
@@ -500,6 +684,7 @@ bool loadJSON(sfmData::SfMData& sfmData, const std::string& filename, ESfMData p
     if(fileTree.count("poses"))
     {
       sfmData::Poses& poses = sfmData.getPoses();
+      poses.reserve(fileTree.get_child("poses").size());
 
       for(bpt::ptree::value_type &poseNode : fileTree.get_child("poses"))
       {
@@ -539,7 +724,7 @@ bool loadJSON(sfmData::SfMData& sfmData, const std::string& filename, ESfMData p
       IndexT landmarkId;
       sfmData::Landmark landmark;
 
-      loadLandmark(landmarkId, landmark, landmarkNode.second);
+      loadLandmark(landmarkId, landmark, landmarkNode.second, loadObservations);
 
       structure.emplace(landmarkId, landmark);
     }
@@ -7,15 +7,41 @@
 
 #include "plyIO.hpp"
 
+#include <cstring>
 #include <fstream>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
 
+namespace {
+
+/// Size of a packed binary PLY vertex record: 3 floats + 3 uchars
+const std::size_t PLY_VERTEX_SIZE = 3 * sizeof(float) + 3;
+
+/// Number of vertices buffered before each write
+const std::size_t PLY_CHUNK_SIZE = 1 << 20;
+
+/// Pack one vertex in the binary-little-endian PLY layout
+/// nb: all the supported platforms are little-endian, values are written as-is
+inline void packPlyVertex(const Vec3& position, unsigned char r, unsigned char g, unsigned char b, char* out)
+{
+  const float xyz[3] = {static_cast<float>(position(0)),
+                        static_cast<float>(position(1)),
+                        static_cast<float>(position(2))};
+  std::memcpy(out, xyz, sizeof(xyz));
+  out[12] = static_cast<char>(r);
+  out[13] = static_cast<char>(g);
+  out[14] = static_cast<char>(b);
+}
+
+} // unnamed namespace
+
 bool savePLY(
   const sfmData::SfMData& sfmData,
   const std::string& filename,
-  ESfMData partFlag)
+  ESfMData partFlag,
+  bool binary)
 {
   const bool b_structure = (partFlag & STRUCTURE) == STRUCTURE;
   const bool b_extrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
@@ -24,7 +50,7 @@ bool savePLY(
     return false;
 
   //Create the stream and check it is ok
-  std::ofstream stream(filename.c_str());
+  std::ofstream stream(filename.c_str(), binary ? (std::ios::out | std::ios::binary) : std::ios::out);
   if (!stream.is_open())
     return false;
 
@@ -40,7 +66,7 @@ bool savePLY(
       }
     }
     stream << "ply"
-      << '\n' << "format ascii 1.0"
+      << '\n' << (binary ? "format binary_little_endian 1.0" : "format ascii 1.0")
       << '\n' << "element vertex "
         // Vertex count: (#landmark + #view_with_valid_pose)
         << ((b_structure ? sfmData.getLandmarks().size() : 0) +
@@ -53,29 +79,72 @@ bool savePLY(
       << '\n' << "property uchar blue"
       << '\n' << "end_header" << std::endl;
 
-      if (b_extrinsics)
+      if (binary)
       {
-        for (const auto& view : sfmData.getViews())
+        // pack the vertices in a fixed size buffer and write it chunk-wise,
+        // per-vertex stream formatting dominates the export of large clouds
+        std::vector<char> buffer(PLY_CHUNK_SIZE * PLY_VERTEX_SIZE);
+        std::size_t nbBufferedVertices = 0;
+
+        const auto flushBuffer = [&]()
+        {
+          stream.write(buffer.data(), nbBufferedVertices * PLY_VERTEX_SIZE);
+          nbBufferedVertices = 0;
+        };
+
+        if (b_extrinsics)
         {
-          if (sfmData.isPoseAndIntrinsicDefined(view.second.get()))
+          for (const auto& view : sfmData.getViews())
           {
-            const geometry::Pose3 pose = sfmData.getPose(*(view.second.get())).getTransform();
-            stream << pose.center().transpose()
-              << " 0 255 0" << "\n";
+            if (sfmData.isPoseAndIntrinsicDefined(view.second.get()))
+            {
+              const geometry::Pose3 pose = sfmData.getPose(*(view.second.get())).getTransform();
+              packPlyVertex(pose.center(), 0, 255, 0, &buffer[nbBufferedVertices * PLY_VERTEX_SIZE]);
+              if (++nbBufferedVertices == PLY_CHUNK_SIZE)
+                flushBuffer();
+            }
           }
         }
-      }
 
-      if (b_structure)
+        if (b_structure)
+        {
+          for (const auto& landmarkPair : sfmData.getLandmarks())
+          {
+            const sfmData::Landmark& landmark = landmarkPair.second;
+            packPlyVertex(landmark.X, landmark.rgb.r(), landmark.rgb.g(), landmark.rgb.b(),
+                          &buffer[nbBufferedVertices * PLY_VERTEX_SIZE]);
+            if (++nbBufferedVertices == PLY_CHUNK_SIZE)
+              flushBuffer();
+          }
+        }
+        flushBuffer();
+      }
+      else
       {
-        const sfmData::Landmarks& landmarks = sfmData.getLandmarks();
-        for (sfmData::Landmarks::const_iterator iterLandmarks = landmarks.begin();
-          iterLandmarks != landmarks.end();
-          ++iterLandmarks)  {
-          stream << iterLandmarks->second.X.transpose() << " "
-                 << (int)iterLandmarks->second.rgb.r() << " "
-                 << (int)iterLandmarks->second.rgb.g() << " "
-                 << (int)iterLandmarks->second.rgb.b() << "\n";
+        if (b_extrinsics)
+        {
+          for (const auto& view : sfmData.getViews())
+          {
+            if (sfmData.isPoseAndIntrinsicDefined(view.second.get()))
+            {
+              const geometry::Pose3 pose = sfmData.getPose(*(view.second.get())).getTransform();
+              stream << pose.center().transpose()
+                << " 0 255 0" << "\n";
+            }
+          }
+        }
+
+        if (b_structure)
+        {
+          const sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+          for (sfmData::Landmarks::const_iterator iterLandmarks = landmarks.begin();
+            iterLandmarks != landmarks.end();
+            ++iterLandmarks)  {
+            stream << iterLandmarks->second.X.transpose() << " "
+                   << (int)iterLandmarks->second.rgb.r() << " "
+                   << (int)iterLandmarks->second.rgb.g() << " "
+                   << (int)iterLandmarks->second.rgb.b() << "\n";
+          }
         }
       }
       stream.flush();
@@ -9,6 +9,7 @@
 #include <aliceVision/config.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/sfmDataIO/binaryIO.hpp>
 #include <aliceVision/sfmDataIO/plyIO.hpp>
 #include <aliceVision/sfmDataIO/bafIO.hpp>
 #include <aliceVision/sfmDataIO/gtIO.hpp>
@@ -97,10 +98,20 @@ bool Load(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partF
   const std::string extension = fs::extension(filename);
   bool status = false;
 
-  if(extension == ".sfm" || extension == ".json") // JSON File
+  if(filename.compare(0, 6, "shm://") == 0) // Shared-memory segment
+  {
+    // in-memory handoff between pipeline steps running on the same host,
+    // the segment holds the '.sfmb' binary form and is mapped read-only
+    status = loadBinaryShm(sfmData, filename.substr(6), partFlag);
+  }
+  else if(extension == ".sfm" || extension == ".json") // JSON File
   {
     status = loadJSON(sfmData, filename, partFlag);
   }
+  else if(extension == ".sfmb") // Binary File
+  {
+    status = loadBinary(sfmData, filename, partFlag);
+  }
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
   else if(extension == ".abc") // Alembic
   {
@@ -130,6 +141,13 @@ bool Load(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partF
 
 bool Save(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
+  if(filename.compare(0, 6, "shm://") == 0) // Shared-memory segment
+  {
+    // in-memory handoff between pipeline steps running on the same host,
+    // written in place: no temporary file is involved
+    return saveBinaryShm(sfmData, filename.substr(6), partFlag);
+  }
+
   const fs::path bPath = fs::path(filename);
   const std::string extension = bPath.extension().string();
   const std::string tmpPath = (bPath.parent_path() / bPath.stem()).string() + "." + fs::unique_path().string() + extension;
@@ -139,6 +157,10 @@ bool Save(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData
   {
     status = saveJSON(sfmData, tmpPath, partFlag);
   }
+  else if(extension == ".sfmb") // Binary File
+  {
+    status = saveBinary(sfmData, tmpPath, partFlag);
+  }
   else if(extension == ".ply") // Polygon File
   {
     status = savePLY(sfmData, tmpPath, partFlag);
@@ -12,6 +12,10 @@
 
 #include <sstream>
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
 #define BOOST_TEST_MODULE sfmDataIO
 #include <boost/test/included/unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
@@ -173,6 +177,95 @@ BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD_JSON) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD_SFMB) {
+
+  const std::string filename = "SAVE_LOAD.sfmb";
+  ALICEVISION_LOG_DEBUG("Testing:" << filename);
+
+  // SAVE / LOAD
+  {
+    const sfmData::SfMData sfmData = createTestScene(2, 2, true);
+    BOOST_CHECK( Save(sfmData, filename, ALL) );
+    sfmData::SfMData sfmDataLoad;
+    BOOST_CHECK( Load(sfmDataLoad, filename, ALL) );
+    BOOST_CHECK_EQUAL( sfmDataLoad.views.size(), sfmData.views.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.getPoses().size(), sfmData.getPoses().size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.intrinsics.size(), sfmData.intrinsics.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.structure.size(), sfmData.structure.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.control_points.size(), sfmData.control_points.size());
+
+    // the structure round-trip must be lossless (flat binary arrays)
+    BOOST_CHECK( sfmDataLoad.structure == sfmData.structure );
+  }
+
+  // LOAD (only a subpart: VIEWS)
+  {
+    const sfmData::SfMData sfmData = createTestScene(2, 2, true);
+    BOOST_CHECK( Save(sfmData, filename, ALL) );
+    sfmData::SfMData sfmDataLoad;
+    ESfMData flags_part = VIEWS;
+    BOOST_CHECK( Load(sfmDataLoad, filename, flags_part) );
+    BOOST_CHECK_EQUAL( sfmDataLoad.views.size(), sfmData.views.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.getPoses().size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.intrinsics.size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.structure.size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.control_points.size(), 0);
+  }
+
+  // LOAD (subparts: COMBINED)
+  {
+    const sfmData::SfMData sfmData = createTestScene(2, 2, false); //2 intrinsics group here
+    BOOST_CHECK( Save(sfmData, filename, ALL) );
+    sfmData::SfMData sfmDataLoad;
+    ESfMData flags_part = ESfMData(INTRINSICS | EXTRINSICS);
+    BOOST_CHECK( Load(sfmDataLoad, filename, flags_part) );
+    BOOST_CHECK_EQUAL( sfmDataLoad.views.size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.getPoses().size(), sfmData.getPoses().size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.intrinsics.size(), sfmData.intrinsics.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.structure.size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.control_points.size(), 0);
+  }
+}
+
+#if !defined(_WIN32)
+BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD_SHM) {
+
+  // shared-memory handoff, the segment holds the '.sfmb' binary form
+  const std::string filename = "shm://aliceVision_sfmDataIO_test";
+  ALICEVISION_LOG_DEBUG("Testing:" << filename);
+
+  // SAVE / LOAD
+  {
+    const sfmData::SfMData sfmData = createTestScene(2, 2, true);
+    BOOST_CHECK( Save(sfmData, filename, ALL) );
+    sfmData::SfMData sfmDataLoad;
+    BOOST_CHECK( Load(sfmDataLoad, filename, ALL) );
+    BOOST_CHECK_EQUAL( sfmDataLoad.views.size(), sfmData.views.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.getPoses().size(), sfmData.getPoses().size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.intrinsics.size(), sfmData.intrinsics.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.structure.size(), sfmData.structure.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.control_points.size(), sfmData.control_points.size());
+    BOOST_CHECK( sfmDataLoad.structure == sfmData.structure );
+  }
+
+  // LOAD (only a subpart: VIEWS)
+  {
+    const sfmData::SfMData sfmData = createTestScene(2, 2, true);
+    BOOST_CHECK( Save(sfmData, filename, ALL) );
+    sfmData::SfMData sfmDataLoad;
+    ESfMData flags_part = VIEWS;
+    BOOST_CHECK( Load(sfmDataLoad, filename, flags_part) );
+    BOOST_CHECK_EQUAL( sfmDataLoad.views.size(), sfmData.views.size());
+    BOOST_CHECK_EQUAL( sfmDataLoad.getPoses().size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.intrinsics.size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.structure.size(), 0);
+    BOOST_CHECK_EQUAL( sfmDataLoad.control_points.size(), 0);
+  }
+
+  shm_unlink("/aliceVision_sfmDataIO_test");
+}
+#endif // !defined(_WIN32)
+
 /*
 BOOST_AUTO_TEST_CASE(SfMData_IO_BigFile) {
   const int nbViews = 1000;
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -87,4 +89,99 @@ namespace stl
     std::vector<BlockType> vec_bits;
     size_t m_num_bits;
   };
+
+  /**
+   * Thread-safe variant of dynamic_bitset for parallel marking phases:
+   * set/reset/test can be called concurrently from several threads without
+   * locks (fetch-or/fetch-and based writes, relaxed reads). The blocks are
+   * exposed for word-level iteration, so counting or scanning the marked
+   * bits after a parallel phase works a word at a time.
+   */
+  struct atomic_dynamic_bitset
+  {
+    typedef std::uint64_t BlockType;
+    static const int bits_per_block = (std::numeric_limits<BlockType>::digits);
+
+    size_t block_index(size_t pos) const { return pos / bits_per_block; }
+    size_t bit_index(size_t pos) const { return static_cast<size_t>(pos % bits_per_block); }
+    BlockType bit_mask(size_t pos) const { return BlockType(1) << bit_index(pos); }
+
+    // Constructor
+    atomic_dynamic_bitset(size_t num_bits = 0)
+    {
+      resize(num_bits);
+    }
+
+    // read a single bit; relaxed, the caller synchronizes phases (e.g. a
+    // parallel-for barrier) before reading what other threads marked
+    bool operator[](size_t pos) const
+    {
+      return (vec_bits[block_index(pos)].load(std::memory_order_relaxed) & bit_mask(pos)) != 0;
+    }
+
+    void set(size_t pos)
+    {
+      vec_bits[block_index(pos)].fetch_or(bit_mask(pos), std::memory_order_relaxed);
+    }
+
+    void reset(size_t pos)
+    {
+      vec_bits[block_index(pos)].fetch_and(BlockType(~bit_mask(pos)), std::memory_order_relaxed);
+    }
+
+    // set a bit and return its previous value, so concurrent threads can
+    // claim an item exactly once
+    bool test_and_set(size_t pos)
+    {
+      const BlockType previous = vec_bits[block_index(pos)].fetch_or(bit_mask(pos), std::memory_order_relaxed);
+      return (previous & bit_mask(pos)) != 0;
+    }
+
+    // return the number of stored bits
+    size_t size() const { return m_num_bits; }
+
+    // return the number of BlockType block used to manipulate the bits
+    size_t num_blocks() const { return vec_bits.size(); }
+
+    // word-level access for popcount/scan over the marked bits
+    BlockType block(size_t blockIndex) const { return vec_bits[blockIndex].load(std::memory_order_relaxed); }
+
+    // return the number of set bits
+    size_t count() const
+    {
+      size_t nb = 0;
+      for(size_t b = 0; b < vec_bits.size(); ++b)
+        nb += std::bitset<bits_per_block>(block(b)).count();
+      return nb;
+    }
+
+    // not thread-safe, only call between parallel phases
+    void resize(size_t num_bits)
+    {
+      // a vector of atomics is not move-constructible, build a new one and swap
+      std::vector<std::atomic<BlockType>> vec(calc_num_blocks(num_bits));
+      vec_bits.swap(vec);
+      m_num_bits = num_bits;
+      reset();
+    }
+
+    // not thread-safe, only call between parallel phases
+    atomic_dynamic_bitset& reset()
+    {
+      for(size_t b = 0; b < vec_bits.size(); ++b)
+        vec_bits[b].store(BlockType(0), std::memory_order_relaxed);
+      return *this;
+    }
+
+  private:
+    inline size_t calc_num_blocks(size_t num_bits)
+    {
+      return num_bits / bits_per_block
+        + static_cast<size_t>(num_bits % bits_per_block != 0);
+    }
+
+    // DATA
+    std::vector<std::atomic<BlockType>> vec_bits;
+    size_t m_num_bits;
+  };
 } // namespace stl
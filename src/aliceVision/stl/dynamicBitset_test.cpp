@@ -7,6 +7,9 @@
 
 #include "DynamicBitset.hpp"
 
+#include <thread>
+#include <vector>
+
 #define BOOST_TEST_MODULE stlDynamicBitset
 #include <boost/test/included/unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
@@ -69,3 +72,71 @@ BOOST_AUTO_TEST_CASE(DYNAMIC_BITSET_InitAndReset_4)
     BOOST_CHECK_EQUAL(false, mybitset[i]);
   }
 }
+
+BOOST_AUTO_TEST_CASE(ATOMIC_DYNAMIC_BITSET_InitSetAndCount)
+{
+  using namespace stl;
+
+  const int nbBits = 100;
+  atomic_dynamic_bitset mybitset(nbBits);
+
+  BOOST_CHECK_EQUAL(100, mybitset.size());
+  BOOST_CHECK_EQUAL(2, mybitset.num_blocks());
+  BOOST_CHECK_EQUAL(0, mybitset.count());
+
+  // Set some bits to 1
+  for (int i = 0; i < mybitset.size(); i+=2)
+    mybitset.set(i);
+
+  // Check that some bits have been correctly set to 1
+  for (int i = 0; i < mybitset.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(!(i%2), mybitset[i]);
+  }
+  BOOST_CHECK_EQUAL(50, mybitset.count());
+
+  // test_and_set reports the previous value
+  BOOST_CHECK_EQUAL(true, mybitset.test_and_set(0));
+  BOOST_CHECK_EQUAL(false, mybitset.test_and_set(1));
+  BOOST_CHECK_EQUAL(true, mybitset[1]);
+
+  // Reset a single bit, then everything
+  mybitset.reset(0);
+  BOOST_CHECK_EQUAL(false, mybitset[0]);
+
+  mybitset.reset();
+  for (int i = 0; i < mybitset.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(false, mybitset[i]);
+  }
+  BOOST_CHECK_EQUAL(0, mybitset.count());
+}
+
+// Mark bits concurrently from several threads, every mark must be visible afterwards
+BOOST_AUTO_TEST_CASE(ATOMIC_DYNAMIC_BITSET_ConcurrentMarking)
+{
+  using namespace stl;
+
+  const int nbBits = 10000;
+  const int nbThreads = 4;
+  atomic_dynamic_bitset mybitset(nbBits);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nbThreads; ++t)
+  {
+    threads.emplace_back([&mybitset, t, nbThreads, nbBits]()
+    {
+      // interleaved ranges, so neighbouring bits of a block are set by different threads
+      for (int i = t; i < nbBits; i += nbThreads)
+        mybitset.set(i);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (int i = 0; i < mybitset.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(true, mybitset[i]);
+  }
+  BOOST_CHECK_EQUAL(nbBits, mybitset.count());
+}
@@ -8,6 +8,15 @@
 #ifndef ALICEVISION_STL_INDEXED_SORT_H
 #define ALICEVISION_STL_INDEXED_SORT_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace stl
 {
 namespace indexed_sort
@@ -60,6 +69,117 @@ namespace indexed_sort
         packet_vec.end());
   }
 
+  /// Monotone mapping of a sort key to unsigned bits, so that comparing the
+  /// bits as unsigned integers matches comparing the original keys.
+  inline std::uint32_t radix_key_bits(std::uint32_t v) { return v; }
+
+  inline std::uint32_t radix_key_bits(std::int32_t v)
+  {
+    return static_cast<std::uint32_t>(v) ^ 0x80000000u;
+  }
+
+  inline std::uint32_t radix_key_bits(float v)
+  {
+    std::uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    // positive floats compare like their bits, negative ones in reverse
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  }
+
+  template<typename T1, typename T2>
+  inline std::uint32_t radix_key_of(const sort_index_packet_ascend<T1,T2>& p)
+  {
+    return radix_key_bits(p.val);
+  }
+
+  template<typename T1, typename T2>
+  inline std::uint32_t radix_key_of(const sort_index_packet_descend<T1,T2>& p)
+  {
+    return ~radix_key_bits(p.val);
+  }
+
+  /// Stable LSD radix sort of the n elements at data by the 32 bit key
+  /// returned by key_of, with buffer as scratch space of the same size. The
+  /// four digit passes histogram and scatter in parallel when OpenMP is
+  /// enabled, and run in linear time where the comparison sorts above are
+  /// n log n, so prefer it for the large flat arrays of the MVS pipeline.
+  template<typename packet_type, typename key_extractor>
+  void radix_sort_by_key(packet_type* data, packet_type* buffer, std::size_t n,
+                         const key_extractor& key_of)
+  {
+#ifdef _OPENMP
+    const int nbChunks = std::max(1, omp_get_max_threads());
+#else
+    const int nbChunks = 1;
+#endif
+    const std::size_t chunkSize = (n + nbChunks - 1) / nbChunks;
+    std::vector<std::size_t> counts(static_cast<std::size_t>(nbChunks) * 256);
+
+    packet_type* src = data;
+    packet_type* dst = buffer;
+    for(int pass = 0; pass < 4; ++pass)
+    {
+      const int shift = pass * 8;
+      std::fill(counts.begin(), counts.end(), std::size_t(0));
+
+      // per chunk digit histograms
+      #pragma omp parallel for
+      for(int chunk = 0; chunk < nbChunks; ++chunk)
+      {
+        std::size_t* localCounts = &counts[static_cast<std::size_t>(chunk) * 256];
+        const std::size_t begin = chunk * chunkSize;
+        const std::size_t end = std::min(begin + chunkSize, n);
+        for(std::size_t i = begin; i < end; ++i)
+          ++localCounts[(key_of(src[i]) >> shift) & 0xff];
+      }
+
+      // exclusive scan, digit major then chunk, gives every chunk its own
+      // contiguous slice of each digit bucket: the scatter below is both
+      // race free and stable
+      std::size_t offset = 0;
+      for(int digit = 0; digit < 256; ++digit)
+      {
+        for(int chunk = 0; chunk < nbChunks; ++chunk)
+        {
+          std::size_t& count = counts[static_cast<std::size_t>(chunk) * 256 + digit];
+          const std::size_t chunkCount = count;
+          count = offset;
+          offset += chunkCount;
+        }
+      }
+
+      #pragma omp parallel for
+      for(int chunk = 0; chunk < nbChunks; ++chunk)
+      {
+        std::size_t* localOffsets = &counts[static_cast<std::size_t>(chunk) * 256];
+        const std::size_t begin = chunk * chunkSize;
+        const std::size_t end = std::min(begin + chunkSize, n);
+        for(std::size_t i = begin; i < end; ++i)
+          dst[localOffsets[(key_of(src[i]) >> shift) & 0xff]++] = src[i];
+      }
+
+      std::swap(src, dst);
+    }
+    // an even number of passes: the sorted data ended up back in data
+  }
+
+  /// Radix sorting counterpart of sort_index_helper, for full sorts of large
+  /// indexed arrays (no NN support: partial sorts stay comparison based).
+  template<typename packet_type, typename eT>
+  void radix_sort_index_helper(std::vector<packet_type>& packet_vec, const eT* in_mem)
+  {
+    const std::size_t n_elem = packet_vec.size();
+
+    for(std::size_t i = 0; i < n_elem; ++i)  {
+      packet_vec[i].val   = in_mem[i];
+      packet_vec[i].index = i;
+    }
+
+    std::vector<packet_type> buffer(n_elem);
+    radix_sort_by_key(packet_vec.data(), buffer.data(), n_elem,
+                      [](const packet_type& p) { return radix_key_of(p); });
+  }
+
 } // namespace indexed_sort
 } // namespace stl
 
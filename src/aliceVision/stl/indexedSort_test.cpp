@@ -0,0 +1,95 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "indexedSort.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+#define BOOST_TEST_MODULE stlIndexedSort
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+using namespace stl::indexed_sort;
+
+BOOST_AUTO_TEST_CASE(INDEXED_SORT_RadixKeyBits_Monotone)
+{
+  // the bit transforms must preserve the ordering of the original keys
+  const float floats[] = {-1e30f, -2.5f, -0.f, 0.f, 1e-20f, 3.f, 1e30f};
+  for(int i = 0; i + 1 < 7; ++i)
+    BOOST_CHECK(radix_key_bits(floats[i]) <= radix_key_bits(floats[i + 1]));
+
+  const std::int32_t ints[] = {INT32_MIN, -42, 0, 1, INT32_MAX};
+  for(int i = 0; i + 1 < 5; ++i)
+    BOOST_CHECK(radix_key_bits(ints[i]) < radix_key_bits(ints[i + 1]));
+}
+
+BOOST_AUTO_TEST_CASE(INDEXED_SORT_RadixSortByKey_MatchesStableSort)
+{
+  struct Entry { int key; int payload; };
+
+  srand(0);
+  const std::size_t n = 100000;
+  std::vector<Entry> entries(n), buffer(n);
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    entries[i].key = rand() % 1000 - 500;
+    entries[i].payload = static_cast<int>(i);
+  }
+
+  std::vector<Entry> expected = entries;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+  radix_sort_by_key(entries.data(), buffer.data(), n,
+                    [](const Entry& e) { return radix_key_bits(e.key); });
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_CHECK_EQUAL(expected[i].key, entries[i].key);
+    // equal keys keep their input order: the sort is stable
+    BOOST_CHECK_EQUAL(expected[i].payload, entries[i].payload);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(INDEXED_SORT_RadixSortIndexHelper_AscendAndDescend)
+{
+  srand(1);
+  const std::size_t n = 50000;
+  std::vector<float> values(n);
+  for(std::size_t i = 0; i < n; ++i)
+    values[i] = static_cast<float>(rand()) / 1000.f - 15.f;
+
+  std::vector<sort_index_packet_ascend<float, int>> ascending(n);
+  radix_sort_index_helper(ascending, values.data());
+
+  std::vector<sort_index_packet_descend<float, int>> descending(n);
+  radix_sort_index_helper(descending, values.data());
+
+  for(std::size_t i = 0; i + 1 < n; ++i)
+  {
+    BOOST_CHECK(ascending[i].val <= ascending[i + 1].val);
+    BOOST_CHECK(descending[i].val >= descending[i + 1].val);
+  }
+  // the indices must point back to the sorted values
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    BOOST_CHECK_EQUAL(values[ascending[i].index], ascending[i].val);
+    BOOST_CHECK_EQUAL(values[descending[i].index], descending[i].val);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(INDEXED_SORT_RadixSortByKey_DegenerateSizes)
+{
+  std::vector<float> empty, emptyBuffer;
+  radix_sort_by_key(empty.data(), emptyBuffer.data(), 0,
+                    [](float v) { return radix_key_bits(v); });
+
+  std::vector<float> single(1, 3.f), singleBuffer(1);
+  radix_sort_by_key(single.data(), singleBuffer.data(), 1,
+                    [](float v) { return radix_key_bits(v); });
+  BOOST_CHECK_EQUAL(3.f, single[0]);
+}
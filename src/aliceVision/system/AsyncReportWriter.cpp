@@ -0,0 +1,87 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "AsyncReportWriter.hpp"
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace aliceVision {
+namespace system {
+
+AsyncReportWriter::AsyncReportWriter(std::size_t maxQueuedReports)
+  : _maxQueuedReports(std::max<std::size_t>(maxQueuedReports, 1))
+  , _thread(&AsyncReportWriter::run, this)
+{}
+
+AsyncReportWriter::~AsyncReportWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _queueChanged.notify_all();
+  _thread.join();
+}
+
+void AsyncReportWriter::write(const std::string& path, std::string content)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _queueChanged.wait(lock, [this] { return _queue.size() < _maxQueuedReports; });
+  _queue.emplace_back(path, std::move(content));
+  _queueChanged.notify_all();
+}
+
+void AsyncReportWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _queueChanged.wait(lock, [this] { return _queue.empty() && _nbInFlight == 0; });
+}
+
+std::size_t AsyncReportWriter::nbFailures() const
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  return _nbFailures;
+}
+
+void AsyncReportWriter::run()
+{
+  for (;;)
+  {
+    std::pair<std::string, std::string> job;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _queueChanged.wait(lock, [this] { return _stop || !_queue.empty(); });
+      if (_queue.empty())
+        return; // stopped and fully drained
+      job = std::move(_queue.front());
+      _queue.pop_front();
+      ++_nbInFlight;
+      // wake writers blocked on the queue bound
+      _queueChanged.notify_all();
+    }
+
+    std::ofstream file(job.first);
+    file << job.second;
+    file.close();
+    const bool ok = !file.fail();
+    if (!ok)
+      ALICEVISION_LOG_WARNING("AsyncReportWriter: cannot write report file '" << job.first << "'.");
+
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      --_nbInFlight;
+      if (!ok)
+        ++_nbFailures;
+      // wake flush()
+      _queueChanged.notify_all();
+    }
+  }
+}
+
+} // namespace system
+} // namespace aliceVision
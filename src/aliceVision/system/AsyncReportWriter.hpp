@@ -0,0 +1,69 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Background writer for diagnostic outputs (HTML reports, SVG exports).
+ *
+ * Diagnostic files are written at the end of a stage or once per pair, and
+ * nothing downstream waits on them; serializing them inline only extends the
+ * stage wall time. The writer owns a single background thread and a bounded
+ * queue of (path, content) jobs: queueing is a string move unless the queue is
+ * full, in which case the caller blocks until the writer catches up, which
+ * bounds the memory held by pending reports. The destructor drains the queue,
+ * so every queued file is on disk once the writer goes out of scope.
+ */
+class AsyncReportWriter
+{
+public:
+  explicit AsyncReportWriter(std::size_t maxQueuedReports = 16);
+
+  /// drains the queue and joins the writer thread
+  ~AsyncReportWriter();
+
+  AsyncReportWriter(const AsyncReportWriter&) = delete;
+  AsyncReportWriter& operator=(const AsyncReportWriter&) = delete;
+
+  /**
+   * @brief Queue \p content to be written to \p path.
+   * Blocks only when \c maxQueuedReports jobs are already pending.
+   */
+  void write(const std::string& path, std::string content);
+
+  /// block until every queued report is on disk
+  void flush();
+
+  /// number of reports that could not be written so far
+  std::size_t nbFailures() const;
+
+private:
+  void run();
+
+  const std::size_t _maxQueuedReports;
+
+  mutable std::mutex _mutex;
+  std::condition_variable _queueChanged;
+  std::deque<std::pair<std::string, std::string>> _queue;
+  std::size_t _nbInFlight = 0;
+  std::size_t _nbFailures = 0;
+  bool _stop = false;
+
+  std::thread _thread;
+};
+
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,118 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/system/Timer.hpp>
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Keep a computed value alive so that the compiler cannot optimize
+ * the measured kernel away.
+ */
+template<typename T>
+inline void benchmarkDoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  volatile const T* sink = &value;
+  (void)sink;
+#endif
+}
+
+/**
+ * @brief Minimal micro-benchmark harness.
+ *
+ * A benchmark function receives the number of iterations and runs its
+ * measured kernel that many times. The harness grows the iteration count
+ * until one run lasts long enough to be meaningful, then reports the time
+ * per iteration.
+ *
+ * Benchmarks are registered with ALICEVISION_BENCHMARK and the executable
+ * entry point is generated by ALICEVISION_BENCHMARK_MAIN, mirroring the
+ * layout of the unit tests.
+ */
+class Benchmark
+{
+public:
+  typedef std::function<void(std::size_t nbIterations)> BenchFunc;
+
+  /**
+   * @brief register a benchmark function, used through ALICEVISION_BENCHMARK
+   * @param[in] name displayed name of the benchmark
+   * @param[in] func the benchmark function
+   * @return the number of registered benchmarks
+   */
+  static int registerCase(const std::string& name, BenchFunc func)
+  {
+    cases().push_back(std::make_pair(name, func));
+    return static_cast<int>(cases().size());
+  }
+
+  /**
+   * @brief run every registered benchmark and print the timings
+   * @param[in] minDurationSec minimum measured duration of one benchmark
+   * @return EXIT_SUCCESS
+   */
+  static int runAll(const double minDurationSec = 0.5)
+  {
+    std::cout << std::left << std::setw(48) << "benchmark"
+              << std::right << std::setw(14) << "iterations"
+              << std::setw(16) << "us/iteration" << std::endl;
+
+    for(const auto& benchCase : cases())
+    {
+      std::size_t nbIterations = 1;
+      double elapsedSec = 0.0;
+
+      // grow the iteration count until the run is long enough to be measured
+      // reliably, the reported timing is the one of the last run
+      for(;;)
+      {
+        Timer timer;
+        benchCase.second(nbIterations);
+        elapsedSec = timer.elapsed();
+
+        if(elapsedSec >= minDurationSec)
+          break;
+        nbIterations *= 2;
+      }
+
+      std::cout << std::left << std::setw(48) << benchCase.first
+                << std::right << std::setw(14) << nbIterations
+                << std::setw(16) << std::fixed << std::setprecision(3)
+                << (elapsedSec * 1.0e6 / nbIterations) << std::endl;
+    }
+    return 0;
+  }
+
+private:
+  static std::vector<std::pair<std::string, BenchFunc>>& cases()
+  {
+    static std::vector<std::pair<std::string, BenchFunc>> instance;
+    return instance;
+  }
+};
+
+} // namespace system
+} // namespace aliceVision
+
+#define ALICEVISION_BENCHMARK(func) \
+  static const int func##_benchmarkRegistered = \
+    aliceVision::system::Benchmark::registerCase(#func, func);
+
+#define ALICEVISION_BENCHMARK_MAIN() \
+  int main() { return aliceVision::system::Benchmark::runAll(); }
@@ -10,7 +10,10 @@
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/log/attributes/value_extraction.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/sources/severity_logger.hpp>
 #include <boost/log/sources/record_ostream.hpp>
@@ -28,11 +31,82 @@
 #include <boost/log/utility/empty_deleter.hpp>
 #endif
 
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+
 namespace aliceVision {
 namespace system {
 
+namespace {
+
+using AsyncSink = boost::log::sinks::asynchronous_sink<boost::log::sinks::text_ostream_backend>;
+
+/// the asynchronous console sink, kept to be stopped and drained at exit
+boost::shared_ptr<AsyncSink> asyncSink;
+
+/**
+ * @brief Stop the feeding thread of the asynchronous sink and write out the
+ * queued records. Registered with std::atexit: the teardown cannot wait for
+ * the static destructors, the boost.log core may be gone by then.
+ */
+void stopAsyncSink()
+{
+  if(asyncSink == nullptr)
+    return;
+
+  boost::log::core::get()->remove_sink(asyncSink);
+  asyncSink->stop();
+  asyncSink->flush();
+  asyncSink.reset();
+}
+
+/**
+ * @brief Sink backend writing each record as a compact binary event:
+ * microsecond timestamp, severity byte and raw message bytes.
+ * Meant for post-processing of heavily instrumented runs, not for humans.
+ */
+class BinaryEventBackend : public boost::log::sinks::basic_sink_backend<boost::log::sinks::synchronized_feeding>
+{
+public:
+  explicit BinaryEventBackend(const std::string& filepath)
+    : _stream(filepath.c_str(), std::ios::out | std::ios::binary)
+  {}
+
+  void consume(const boost::log::record_view& record)
+  {
+    if(!_stream.is_open())
+      return;
+
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    const auto timestamp = boost::log::extract<boost::posix_time::ptime>("TimeStamp", record);
+    const std::uint64_t microseconds = timestamp
+        ? static_cast<std::uint64_t>((timestamp.get() - epoch).total_microseconds()) : 0;
+
+    const auto severityRef = boost::log::extract<boost::log::trivial::severity_level>("Severity", record);
+    const std::uint8_t severity = static_cast<std::uint8_t>(severityRef ? severityRef.get() : boost::log::trivial::info);
+
+    const auto messageRef = boost::log::extract<std::string>("Message", record);
+    const std::string message = messageRef ? messageRef.get() : std::string();
+    const std::uint32_t messageSize = message.size();
+
+    _stream.write((const char*)&microseconds, sizeof(std::uint64_t));
+    _stream.write((const char*)&severity, sizeof(std::uint8_t));
+    _stream.write((const char*)&messageSize, sizeof(std::uint32_t));
+    _stream.write(message.data(), messageSize);
+  }
+
+private:
+  std::ofstream _stream;
+};
+
+} // unnamed namespace
+
 std::shared_ptr<Logger> Logger::_instance = nullptr;
 
+// permissive until a level is set, the boost.log filter does the final word
+std::atomic<int> Logger::_severityFilter(static_cast<int>(EVerboseLevel::Trace));
+
 Logger::Logger()
 {
   namespace expr = boost::log::expressions;
@@ -46,31 +120,48 @@ Logger::Logger()
 #else
   using null_deleter = boost::log::empty_deleter;
 #endif
-  boost::shared_ptr<sink_t> sink;
 
-  {
-    // create a backend and attach a stream to it
-    boost::shared_ptr<sinks::text_ostream_backend> backend = boost::make_shared<sinks::text_ostream_backend>();
-    backend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, null_deleter()));
-    // backend->add_stream( boost::shared_ptr< std::ostream >( new std::ofstream("sample.log") ) );
-
-    // enable auto-flushing after each log record written
-    backend->auto_flush(true);
+  // buffered mode: the records are queued and written by a dedicated thread,
+  // so logging threads never wait on the console
+  const char* envAsync = std::getenv("ALICEVISION_LOG_ASYNC");
+  const bool useAsyncSink = (envAsync != NULL && envAsync[0] != '\0' && std::string(envAsync) != "0");
 
-    // wrap it into the frontend and register in the core.
-    sink = boost::make_shared<sink_t>(backend);
-  }
+  // create a backend and attach a stream to it
+  boost::shared_ptr<sinks::text_ostream_backend> backend = boost::make_shared<sinks::text_ostream_backend>();
+  backend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, null_deleter()));
+  // backend->add_stream( boost::shared_ptr< std::ostream >( new std::ofstream("sample.log") ) );
 
-  sink->reset_formatter();
+  // enable auto-flushing after each log record written, except in buffered mode
+  backend->auto_flush(!useAsyncSink);
 
   // specify format of the log records
-  sink->set_formatter(expr::stream   
+  const boost::log::formatter formatter = expr::stream
          << "[" << expr::format_date_time<boost::posix_time::ptime>("TimeStamp","%H:%M:%S.%f") << "]"
          << "[" << boost::log::trivial::severity << "]"
-         << " " << expr::smessage);
+         << " " << expr::smessage;
+
+  // wrap the backend into the frontend and register in the core
+  if(useAsyncSink)
+  {
+    asyncSink = boost::make_shared<AsyncSink>(backend);
+    asyncSink->set_formatter(formatter);
+    boost::log::core::get()->add_sink(asyncSink);
+    std::atexit(stopAsyncSink);
+  }
+  else
+  {
+    boost::shared_ptr<sink_t> sink = boost::make_shared<sink_t>(backend);
+    sink->set_formatter(formatter);
+    boost::log::core::get()->add_sink(sink);
+  }
 
-  // register the sink in the logging core
-  boost::log::core::get()->add_sink(sink);
+  // binary structured event mode, added next to the console sink
+  const char* envBinaryFile = std::getenv("ALICEVISION_LOG_BINARY_FILE");
+  if(envBinaryFile != NULL && envBinaryFile[0] != '\0')
+  {
+    using binary_sink_t = sinks::synchronous_sink<BinaryEventBackend>;
+    boost::log::core::get()->add_sink(boost::make_shared<binary_sink_t>(boost::make_shared<BinaryEventBackend>(envBinaryFile)));
+  }
 
   boost::log::add_common_attributes();
 
@@ -96,6 +187,9 @@ EVerboseLevel Logger::getDefaultVerboseLevel()
 
 void Logger::setLogLevel(const EVerboseLevel level)
 {
+  // keep the fast gate of the logging macros in sync with the boost.log filter
+  _severityFilter.store(static_cast<int>(level), std::memory_order_relaxed);
+
   switch(level)
   {
     case EVerboseLevel::Fatal:   setLogLevel(boost::log::trivial::fatal);   break;
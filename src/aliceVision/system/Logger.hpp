@@ -12,6 +12,7 @@
 #define BOOST_LOG_DYN_LINK 1
 #include <boost/log/trivial.hpp>
 
+#include <atomic>
 #include <memory>
 #include <iostream>
 
@@ -27,14 +28,68 @@
 #define ALICEVISION_LOG_WARNING_OBJ BOOST_LOG_TRIVIAL(warning)
 #define ALICEVISION_LOG_ERROR_OBJ BOOST_LOG_TRIVIAL(error)
 #define ALICEVISION_LOG_FATAL_OBJ BOOST_LOG_TRIVIAL(fatal)
-#define ALICEVISION_LOG(MODE, a) MODE << a
 
-#define ALICEVISION_LOG_TRACE(a) ALICEVISION_LOG(ALICEVISION_LOG_TRACE_OBJ, a)
-#define ALICEVISION_LOG_DEBUG(a) ALICEVISION_LOG(ALICEVISION_LOG_DEBUG_OBJ, a)
-#define ALICEVISION_LOG_INFO(a) ALICEVISION_LOG(ALICEVISION_LOG_INFO_OBJ, a)
-#define ALICEVISION_LOG_WARNING(a) ALICEVISION_LOG(ALICEVISION_LOG_WARNING_OBJ, a)
-#define ALICEVISION_LOG_ERROR(a) ALICEVISION_LOG(ALICEVISION_LOG_ERROR_OBJ, a)
-#define ALICEVISION_LOG_FATAL(a) ALICEVISION_LOG(ALICEVISION_LOG_FATAL_OBJ, a)
+// Numeric severity values, only used for the compile-time stripping below
+#define ALICEVISION_LOG_LEVEL_FATAL 0
+#define ALICEVISION_LOG_LEVEL_ERROR 1
+#define ALICEVISION_LOG_LEVEL_WARNING 2
+#define ALICEVISION_LOG_LEVEL_INFO 3
+#define ALICEVISION_LOG_LEVEL_DEBUG 4
+#define ALICEVISION_LOG_LEVEL_TRACE 5
+
+// Most verbose severity compiled in: statements more verbose than this
+// expand to a no-op (the streamed expression stays type-checked but is
+// never evaluated), so per-item logging in hot loops can be stripped.
+#ifndef ALICEVISION_LOG_MAX_LEVEL
+#define ALICEVISION_LOG_MAX_LEVEL ALICEVISION_LOG_LEVEL_TRACE
+#endif
+
+#define ALICEVISION_LOG_STRIPPED(a) \
+do { \
+  if(false) { ALICEVISION_LOG_INFO_OBJ << a; } \
+} while(false)
+
+// The severity filter is checked with a relaxed atomic load before the
+// boost.log record machinery is involved: a filtered-out statement costs a
+// single comparison, whatever it streams.
+#define ALICEVISION_LOG(MODE, LEVEL, a) \
+do { \
+  if(aliceVision::system::Logger::mayLog(LEVEL)) \
+    MODE << a; \
+} while(false)
+
+#if ALICEVISION_LOG_MAX_LEVEL >= ALICEVISION_LOG_LEVEL_TRACE
+#define ALICEVISION_LOG_TRACE(a) ALICEVISION_LOG(ALICEVISION_LOG_TRACE_OBJ, aliceVision::system::EVerboseLevel::Trace, a)
+#else
+#define ALICEVISION_LOG_TRACE(a) ALICEVISION_LOG_STRIPPED(a)
+#endif
+
+#if ALICEVISION_LOG_MAX_LEVEL >= ALICEVISION_LOG_LEVEL_DEBUG
+#define ALICEVISION_LOG_DEBUG(a) ALICEVISION_LOG(ALICEVISION_LOG_DEBUG_OBJ, aliceVision::system::EVerboseLevel::Debug, a)
+#else
+#define ALICEVISION_LOG_DEBUG(a) ALICEVISION_LOG_STRIPPED(a)
+#endif
+
+#if ALICEVISION_LOG_MAX_LEVEL >= ALICEVISION_LOG_LEVEL_INFO
+#define ALICEVISION_LOG_INFO(a) ALICEVISION_LOG(ALICEVISION_LOG_INFO_OBJ, aliceVision::system::EVerboseLevel::Info, a)
+#else
+#define ALICEVISION_LOG_INFO(a) ALICEVISION_LOG_STRIPPED(a)
+#endif
+
+#if ALICEVISION_LOG_MAX_LEVEL >= ALICEVISION_LOG_LEVEL_WARNING
+#define ALICEVISION_LOG_WARNING(a) ALICEVISION_LOG(ALICEVISION_LOG_WARNING_OBJ, aliceVision::system::EVerboseLevel::Warning, a)
+#else
+#define ALICEVISION_LOG_WARNING(a) ALICEVISION_LOG_STRIPPED(a)
+#endif
+
+#if ALICEVISION_LOG_MAX_LEVEL >= ALICEVISION_LOG_LEVEL_ERROR
+#define ALICEVISION_LOG_ERROR(a) ALICEVISION_LOG(ALICEVISION_LOG_ERROR_OBJ, aliceVision::system::EVerboseLevel::Error, a)
+#else
+#define ALICEVISION_LOG_ERROR(a) ALICEVISION_LOG_STRIPPED(a)
+#endif
+
+// fatal statements are never stripped
+#define ALICEVISION_LOG_FATAL(a) ALICEVISION_LOG(ALICEVISION_LOG_FATAL_OBJ, aliceVision::system::EVerboseLevel::Fatal, a)
 
 #define ALICEVISION_THROW(EXCEPTION, x) \
 { \
@@ -127,6 +182,17 @@ public:
    */
   static EVerboseLevel getDefaultVerboseLevel();
 
+  /**
+   * @brief fast severity check, done by the logging macros before any
+   * boost.log machinery is involved
+   * @param level severity of the statement
+   * @return true if a statement of this severity may be logged
+   */
+  static bool mayLog(const EVerboseLevel level)
+  {
+    return static_cast<int>(level) <= _severityFilter.load(std::memory_order_relaxed);
+  }
+
   /**
    * @brief set Logger level with EVerboseLevel enum
    * @param level EVerboseLevel enum
@@ -153,6 +219,9 @@ private:
   void setLogLevel(const boost::log::trivial::severity_level level);
 
   static std::shared_ptr<Logger> _instance;
+
+  /// severity accepted by the fast mayLog() gate, kept in sync with the boost.log filter
+  static std::atomic<int> _severityFilter;
 };
 
 } // namespace system
@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MemoryGovernor.hpp"
+
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace system {
+
+MemoryGovernor& MemoryGovernor::get()
+{
+    static MemoryGovernor instance;
+    return instance;
+}
+
+std::size_t MemoryGovernor::registerClient(const std::string& name, EvictionCallback onPressure)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Client client;
+    client.name = name;
+    client.onPressure = onPressure;
+    client.active = true;
+    _clients.push_back(std::move(client));
+    ALICEVISION_LOG_DEBUG("MemoryGovernor: registered cache '" << name << "'.");
+    return _clients.size() - 1;
+}
+
+void MemoryGovernor::unregisterClient(std::size_t clientId)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Client& client = _clients.at(clientId);
+    client.active = false;
+    client.usage = 0;
+    client.onPressure = EvictionCallback();
+}
+
+void MemoryGovernor::reportUsage(std::size_t clientId, std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _clients.at(clientId).usage = bytes;
+}
+
+std::size_t MemoryGovernor::suggestedBudget(std::size_t clientId) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t nbActiveClients = 0;
+    for(const Client& client : _clients)
+        if(client.active)
+            ++nbActiveClients;
+    if(nbActiveClients == 0)
+        return headroomBytes();
+    // an equal share of the headroom on top of what the client already holds
+    return headroomBytes() / nbActiveClients + _clients.at(clientId).usage;
+}
+
+bool MemoryGovernor::requestAllocation(std::size_t clientId, std::size_t bytes)
+{
+    if(bytes <= headroomBytes())
+        return true;
+
+    // collect the other clients under the lock, biggest holders first, but
+    // call the eviction callbacks unlocked so they may call back into us
+    std::vector<std::pair<std::size_t, EvictionCallback>> targets; // (usage, callback)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(std::size_t i = 0; i < _clients.size(); ++i)
+        {
+            const Client& client = _clients[i];
+            if(i != clientId && client.active && client.onPressure)
+                targets.emplace_back(client.usage, client.onPressure);
+        }
+    }
+    std::sort(targets.begin(), targets.end(),
+              [](const std::pair<std::size_t, EvictionCallback>& a,
+                 const std::pair<std::size_t, EvictionCallback>& b) { return a.first > b.first; });
+
+    for(const auto& target : targets)
+    {
+        const std::size_t headroom = headroomBytes();
+        if(bytes <= headroom)
+            return true;
+        target.second(bytes - headroom);
+    }
+
+    const bool granted = (bytes <= headroomBytes());
+    if(!granted)
+        ALICEVISION_LOG_WARNING("MemoryGovernor: cannot free enough memory for an allocation of "
+                                << (bytes / (1024 * 1024)) << " MB.");
+    return granted;
+}
+
+void MemoryGovernor::setReservedFraction(double fraction)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _reservedFraction = std::max(0.0, std::min(1.0, fraction));
+}
+
+std::size_t MemoryGovernor::headroomBytes() const
+{
+    const MemoryInfo memoryInfo = getMemoryInfo();
+    const std::size_t reserved = std::size_t(_reservedFraction * memoryInfo.totalRam);
+    return memoryInfo.freeRam > reserved ? memoryInfo.freeRam - reserved : 0;
+}
+
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,92 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Process-wide coordination of the memory hungry caches.
+ *
+ * Subsystem caches register with the governor and expose an eviction
+ * callback. Sizing decisions then go through suggestedBudget(), which shares
+ * the free RAM headroom reported by getMemoryInfo() between the registered
+ * caches, and growth that would not fit the headroom goes through
+ * requestAllocation(), which applies eviction pressure to the other caches.
+ * A fraction of the total RAM is always kept out of reach of the caches for
+ * the rest of the process (I/O buffers, temporaries of the solvers).
+ */
+class MemoryGovernor
+{
+public:
+    /// Asked to release about \p bytes, returns the number of bytes actually released.
+    using EvictionCallback = std::function<std::size_t(std::size_t bytes)>;
+
+    /// Access the process-wide instance
+    static MemoryGovernor& get();
+
+    /**
+     * @brief Register a cache with the governor.
+     * @param[in] name cache name used in the logs
+     * @param[in] onPressure optional eviction callback, called without the
+     *            governor lock held so it may call back into the governor
+     * @return the client id used by the other calls
+     */
+    std::size_t registerClient(const std::string& name, EvictionCallback onPressure = EvictionCallback());
+
+    /// Unregister a cache, its id is not reused.
+    void unregisterClient(std::size_t clientId);
+
+    /// Report the memory currently held by the client's cache.
+    void reportUsage(std::size_t clientId, std::size_t bytes);
+
+    /**
+     * @brief Budget the client may grow into: an equal share of the current
+     * headroom on top of what the client already holds.
+     */
+    std::size_t suggestedBudget(std::size_t clientId) const;
+
+    /**
+     * @brief Ask to grow by \p bytes. When the headroom is too small,
+     * eviction pressure is applied to the other registered clients, biggest
+     * holders first.
+     * @return true if the headroom now covers the allocation
+     */
+    bool requestAllocation(std::size_t clientId, std::size_t bytes);
+
+    /// Fraction of the total RAM never handed to the caches (default: 0.1)
+    void setReservedFraction(double fraction);
+
+private:
+    MemoryGovernor() = default;
+    MemoryGovernor(const MemoryGovernor&) = delete;
+    MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+    /// free RAM above the reserve, 0 when the process is already over it
+    std::size_t headroomBytes() const;
+
+    struct Client
+    {
+        std::string name;
+        EvictionCallback onPressure;
+        std::size_t usage = 0;
+        bool active = false;
+    };
+
+    mutable std::mutex _mutex;
+    std::vector<Client> _clients;
+    double _reservedFraction = 0.1;
+};
+
+} // namespace system
+} // namespace aliceVision
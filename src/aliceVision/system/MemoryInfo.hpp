@@ -24,6 +24,12 @@ struct MemoryInfo
 
 MemoryInfo getMemoryInfo();
 
+/**
+ * @brief Peak resident memory of the current process since its start.
+ * @return the peak in bytes, 0 if it cannot be retrieved
+ */
+std::size_t getPeakRSS();
+
 std::ostream& operator<<(std::ostream& os, const MemoryInfo& infos);
 
 }
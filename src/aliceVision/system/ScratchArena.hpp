@@ -0,0 +1,156 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2019 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Bump allocator for short-lived scratch buffers in hot loops.
+ *
+ * Memory is carved out of a few large blocks with a simple pointer bump, so
+ * an allocation is a couple of arithmetic operations instead of a call into
+ * the heap allocator. Nothing is freed individually: a Scope marks a point in
+ * the arena and rewinds to it on destruction, which makes per-iteration
+ * temporaries free to "deallocate". The blocks themselves are kept across
+ * rewinds, so after a warm-up iteration the arena stops touching the heap.
+ *
+ * The arena is not thread-safe; use threadLocal() to get a per-thread
+ * instance (the intended usage inside OpenMP loops).
+ */
+class ScratchArena
+{
+public:
+  /**
+   * @brief RAII marker: remembers the arena position at construction and
+   * rewinds to it at destruction. Scopes can be nested.
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(ScratchArena& arena)
+      : _arena(arena)
+      , _block(arena._currentBlock)
+      , _offset(arena._offset)
+    {}
+
+    ~Scope()
+    {
+      _arena._currentBlock = _block;
+      _arena._offset = _offset;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ScratchArena& _arena;
+    std::size_t _block;
+    std::size_t _offset;
+  };
+
+  explicit ScratchArena(std::size_t initialCapacity = 1 << 16)
+  {
+    _blocks.emplace_back(initialCapacity);
+  }
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /**
+   * @brief Allocate raw scratch memory, valid until the enclosing Scope is
+   * destroyed (or reset() is called).
+   * @param[in] nbBytes number of bytes to allocate
+   * @param[in] alignment required alignment, a power of two
+   * @return pointer to uninitialized storage
+   */
+  void* allocate(std::size_t nbBytes, std::size_t alignment = alignof(std::max_align_t))
+  {
+    for(;;)
+    {
+      std::vector<unsigned char>& block = _blocks[_currentBlock];
+      const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data());
+      const std::size_t offset = alignUp(base + _offset, alignment) - base;
+
+      if(offset + nbBytes <= block.size())
+      {
+        _offset = offset + nbBytes;
+        return block.data() + offset;
+      }
+
+      // current block exhausted: move to the next one, growing the arena
+      // geometrically if none is available yet
+      if(_currentBlock + 1 == _blocks.size())
+        _blocks.emplace_back(std::max(_blocks.back().size() * 2, nbBytes + alignment));
+
+      ++_currentBlock;
+      _offset = 0;
+    }
+  }
+
+  /// Typed allocation helper; the returned storage is uninitialized.
+  template<typename T>
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /// Rewind the whole arena, keeping the allocated blocks for reuse.
+  void reset()
+  {
+    _currentBlock = 0;
+    _offset = 0;
+  }
+
+  /// Total capacity of the underlying blocks (high-water mark of past usage).
+  std::size_t capacity() const
+  {
+    std::size_t nbBytes = 0;
+    for(const std::vector<unsigned char>& block : _blocks)
+      nbBytes += block.size();
+    return nbBytes;
+  }
+
+  /// Per-thread arena instance, created on first use.
+  static ScratchArena& threadLocal()
+  {
+    static thread_local ScratchArena arena;
+    return arena;
+  }
+
+private:
+  static std::uintptr_t alignUp(std::uintptr_t value, std::size_t alignment)
+  {
+    return (value + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+  }
+
+  std::vector<std::vector<unsigned char>> _blocks;
+  std::size_t _currentBlock = 0;
+  std::size_t _offset = 0;
+};
+
+/**
+ * @brief Map an uninitialized Eigen matrix of the given size onto arena
+ * scratch memory. The mapped data is 32-byte aligned so Eigen can vectorize
+ * over it; it lives until the enclosing ScratchArena::Scope is destroyed.
+ */
+template<typename MatrixType>
+Eigen::Map<MatrixType> mapMatrix(ScratchArena& arena, std::ptrdiff_t rows, std::ptrdiff_t cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  Scalar* data = static_cast<Scalar*>(arena.allocate(sizeof(Scalar) * rows * cols, 32));
+  return Eigen::Map<MatrixType>(data, rows, cols);
+}
+
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,122 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "Telemetry.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+/// stages opened on this thread, the dotted join of the names is the stage path
+thread_local std::vector<std::string> openStages;
+
+/**
+ * @brief Write the report of the registry to ALICEVISION_TELEMETRY_FILE.
+ * Registered with std::atexit so every binary dumps without a code change.
+ */
+void saveTelemetryAtExit()
+{
+  const char* envFile = std::getenv("ALICEVISION_TELEMETRY_FILE");
+  if(envFile != NULL && envFile[0] != '\0')
+    Telemetry::get()->save(envFile);
+}
+
+} // unnamed namespace
+
+std::shared_ptr<Telemetry> Telemetry::_instance = nullptr;
+
+Telemetry::Telemetry()
+{
+  std::atexit(saveTelemetryAtExit);
+}
+
+std::shared_ptr<Telemetry> Telemetry::get()
+{
+  if(_instance == nullptr)
+      _instance.reset(new Telemetry());
+  return _instance;
+}
+
+Telemetry::ScopedTimer::ScopedTimer(const std::string& stageName)
+{
+  openStages.push_back(stageName);
+}
+
+Telemetry::ScopedTimer::~ScopedTimer()
+{
+  std::string stagePath = openStages.front();
+  for(std::size_t i = 1; i < openStages.size(); ++i)
+    stagePath += "." + openStages[i];
+  openStages.pop_back();
+
+  Telemetry::get()->closeStage(stagePath, _timer.elapsed());
+}
+
+void Telemetry::closeStage(const std::string& stagePath, const double elapsedSec)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  StageStats& stats = _stages[stagePath];
+  stats.durationSec += elapsedSec;
+  ++stats.nbCalls;
+  stats.peakRssBytes = getPeakRSS();
+}
+
+void Telemetry::count(const std::string& name, const std::size_t increment)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _counters[name] += increment;
+}
+
+bool Telemetry::save(const std::string& filepath) const
+{
+  namespace bpt = boost::property_tree;
+
+  bpt::ptree tree;
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for(const auto& stagePair : _stages)
+    {
+      // the dotted stage path nests in the property tree, so the report
+      // mirrors the pipeline structure
+      const std::string path = "stages." + stagePair.first;
+      tree.put(path + ".durationSec", stagePair.second.durationSec);
+      tree.put(path + ".nbCalls", stagePair.second.nbCalls);
+      tree.put(path + ".peakRssBytes", stagePair.second.peakRssBytes);
+    }
+
+    for(const auto& counterPair : _counters)
+      tree.put("counters." + counterPair.first, counterPair.second);
+  }
+
+  tree.put("peakRssBytes", getPeakRSS());
+  tree.put("totalRamBytes", getMemoryInfo().totalRam);
+
+  try
+  {
+    bpt::write_json(filepath, tree);
+  }
+  catch(const std::exception& e)
+  {
+    ALICEVISION_LOG_WARNING("Unable to save the telemetry report to '" << filepath << "': " << e.what());
+    return false;
+  }
+  return true;
+}
+
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,104 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2016 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/system/Timer.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Process-wide instrumentation registry: scoped stage timers, counters
+ * and peak resident memory, dumped as one JSON report.
+ *
+ * Stages nest: a Telemetry::ScopedTimer opened while another one is alive on
+ * the same thread is recorded under it, so the report mirrors the pipeline
+ * structure ("matching.loadRegions", "matching.putativeMatching", ...).
+ *
+ * If the environment variable ALICEVISION_TELEMETRY_FILE is set, the report
+ * is written to that path at process exit, so any binary can be profiled on
+ * the farm without a code change. A binary can also call save() explicitly to
+ * put the report alongside its outputs.
+ */
+class Telemetry
+{
+public:
+
+  /**
+   * @brief get Telemetry instance
+   * @return instance
+   */
+  static std::shared_ptr<Telemetry> get();
+
+  /**
+   * @brief RAII timer of one pipeline stage.
+   * The elapsed time and the peak resident memory are recorded when the
+   * scope closes.
+   */
+  class ScopedTimer
+  {
+  public:
+    /**
+     * @param[in] stageName name of the stage, without '.' (the stage path separator)
+     */
+    explicit ScopedTimer(const std::string& stageName);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    Timer _timer;
+  };
+
+  /**
+   * @brief add to a named counter
+   * @param[in] name name of the counter
+   * @param[in] increment value added to the counter
+   */
+  void count(const std::string& name, const std::size_t increment = 1);
+
+  /**
+   * @brief write the report as JSON
+   * @param[in] filepath output filepath
+   * @return true if the report has been written
+   */
+  bool save(const std::string& filepath) const;
+
+private:
+
+  /**
+   * @brief Telemetry private constructor
+   */
+  Telemetry();
+
+  /// cumulated measures of one stage path
+  struct StageStats
+  {
+    double durationSec = 0.0;
+    std::size_t nbCalls = 0;
+    std::size_t peakRssBytes = 0;
+  };
+
+  void closeStage(const std::string& stagePath, const double elapsedSec);
+
+  static std::shared_ptr<Telemetry> _instance;
+
+  mutable std::mutex _mutex;
+  /// cumulated stage measures, keyed by the dotted stage path
+  std::map<std::string, StageStats> _stages;
+  /// named counters
+  std::map<std::string, std::size_t> _counters;
+};
+
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,284 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "WorkServer.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#ifdef _WIN32
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  using socket_t = SOCKET;
+  #define AV_INVALID_SOCKET INVALID_SOCKET
+  #define av_closeSocket closesocket
+#else
+  #include <sys/socket.h>
+  #include <netinet/in.h>
+  #include <arpa/inet.h>
+  #include <netdb.h>
+  #include <unistd.h>
+  using socket_t = int;
+  #define AV_INVALID_SOCKET (-1)
+  #define av_closeSocket close
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+void initSockets()
+{
+#ifdef _WIN32
+  static bool initialized = false;
+  if(!initialized)
+  {
+    WSADATA wsaData;
+    if(WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+      throw std::runtime_error("WorkServer: WSAStartup failed.");
+    initialized = true;
+  }
+#endif
+}
+
+/// read a '\n' terminated line from the socket
+std::string readLine(socket_t fd)
+{
+  std::string line;
+  char c;
+  while(recv(fd, &c, 1, 0) == 1)
+  {
+    if(c == '\n')
+      break;
+    line += c;
+  }
+  return line;
+}
+
+void writeLine(socket_t fd, const std::string& line)
+{
+  const std::string data = line + "\n";
+  std::size_t sent = 0;
+  while(sent < data.size())
+  {
+    const auto n = send(fd, data.data() + sent, data.size() - sent, 0);
+    if(n <= 0)
+      return;
+    sent += static_cast<std::size_t>(n);
+  }
+}
+
+} // namespace
+
+WorkServer::WorkServer(int port, int nbItems, double targetChunkSeconds)
+  : _port(port)
+  , _nbItems(nbItems)
+  , _targetChunkSeconds(targetChunkSeconds)
+{}
+
+int WorkServer::chunkSize() const
+{
+  const int remaining = _nbItems - _next;
+  const int nbWorkers = std::max(1, static_cast<int>(_outstandingPerWorker.size()));
+
+  int size;
+  if(_secondsPerItem > 0.0)
+    size = static_cast<int>(_targetChunkSeconds / _secondsPerItem);
+  else
+    size = _nbItems / (8 * nbWorkers); // no cost feedback yet, start small
+
+  // shrink near the end of the range so the last chunks spread over the workers
+  size = std::min(size, std::max(1, remaining / (2 * nbWorkers)));
+
+  return std::max(1, std::min(size, remaining));
+}
+
+void WorkServer::run()
+{
+  initSockets();
+
+  const socket_t listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if(listenFd == AV_INVALID_SOCKET)
+    throw std::runtime_error("WorkServer: cannot create the listening socket.");
+
+  {
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+  }
+
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = INADDR_ANY;
+  address.sin_port = htons(static_cast<unsigned short>(_port));
+
+  if(bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+  {
+    av_closeSocket(listenFd);
+    throw std::runtime_error("WorkServer: cannot bind port " + std::to_string(_port) + ".");
+  }
+
+  if(listen(listenFd, 64) != 0)
+  {
+    av_closeSocket(listenFd);
+    throw std::runtime_error("WorkServer: cannot listen on port " + std::to_string(_port) + ".");
+  }
+
+  ALICEVISION_LOG_INFO("Work server: dispatching " << _nbItems << " items on port " << _port << ".");
+
+  for(;;)
+  {
+    const socket_t clientFd = accept(listenFd, nullptr, nullptr);
+    if(clientFd == AV_INVALID_SOCKET)
+      continue;
+
+    const std::string request = readLine(clientFd);
+
+    std::istringstream iss(request);
+    std::string command;
+    long workerId = 0;
+    int lastChunkSize = 0;
+    double lastChunkSeconds = 0.0;
+    iss >> command >> workerId >> lastChunkSize >> lastChunkSeconds;
+
+    if(command != "GET")
+    {
+      writeLine(clientFd, "DONE");
+      av_closeSocket(clientFd);
+      continue;
+    }
+
+    // cost feedback of the previous chunk
+    if(lastChunkSize > 0 && lastChunkSeconds > 0.0)
+    {
+      const double secondsPerItem = lastChunkSeconds / lastChunkSize;
+      _secondsPerItem = (_secondsPerItem > 0.0) ? (0.5 * _secondsPerItem + 0.5 * secondsPerItem) : secondsPerItem;
+    }
+    _outstandingPerWorker[workerId] = 0;
+
+    if(_next < _nbItems)
+    {
+      const int size = chunkSize();
+      ALICEVISION_LOG_INFO("Work server: chunk [" << _next << ", " << _next + size << ") to worker " << workerId
+        << " (" << (_nbItems - _next - size) << " items left).");
+      writeLine(clientFd, "CHUNK " + std::to_string(_next) + " " + std::to_string(size));
+      _outstandingPerWorker[workerId] = size;
+      _next += size;
+    }
+    else
+    {
+      writeLine(clientFd, "DONE");
+    }
+    av_closeSocket(clientFd);
+
+    // stop once everything is dispatched and no worker is still computing
+    if(_next >= _nbItems)
+    {
+      bool outstanding = false;
+      for(const auto& workerPair : _outstandingPerWorker)
+        outstanding |= (workerPair.second > 0);
+      if(!outstanding)
+        break;
+    }
+  }
+
+  av_closeSocket(listenFd);
+  ALICEVISION_LOG_INFO("Work server: all items dispatched and completed.");
+}
+
+WorkClient::WorkClient(const std::string& host, int port)
+  : _host(host)
+  , _port(port)
+  , _workerId(std::random_device()())
+{}
+
+bool WorkClient::nextChunk(int& rangeStart, int& rangeSize)
+{
+  initSockets();
+
+  double lastChunkSeconds = 0.0;
+  if(_lastChunkSize > 0)
+    lastChunkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _lastChunkTime).count();
+
+  const socket_t fd = socket(AF_INET, SOCK_STREAM, 0);
+  if(fd == AV_INVALID_SOCKET)
+    throw std::runtime_error("WorkClient: cannot create the socket.");
+
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo* result = nullptr;
+  if(getaddrinfo(_host.c_str(), std::to_string(_port).c_str(), &hints, &result) != 0 || result == nullptr)
+  {
+    av_closeSocket(fd);
+    throw std::runtime_error("WorkClient: cannot resolve the work server host '" + _host + "'.");
+  }
+
+  const int connected = connect(fd, result->ai_addr, static_cast<int>(result->ai_addrlen));
+  freeaddrinfo(result);
+
+  if(connected != 0)
+  {
+    av_closeSocket(fd);
+    throw std::runtime_error("WorkClient: cannot connect to the work server '" + _host + ":" + std::to_string(_port) + "'.");
+  }
+
+  writeLine(fd, "GET " + std::to_string(_workerId) + " " + std::to_string(_lastChunkSize) + " " + std::to_string(lastChunkSeconds));
+  const std::string response = readLine(fd);
+  av_closeSocket(fd);
+
+  std::istringstream iss(response);
+  std::string command;
+  iss >> command;
+
+  if(command == "CHUNK")
+  {
+    iss >> rangeStart >> rangeSize;
+    if(iss.fail() || rangeSize <= 0)
+      throw std::runtime_error("WorkClient: malformed chunk response '" + response + "'.");
+    _lastChunkSize = rangeSize;
+    _lastChunkTime = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  if(command == "DONE")
+  {
+    // report the duration of the final chunk so the coordinator can stop
+    _lastChunkSize = 0;
+    return false;
+  }
+
+  throw std::runtime_error("WorkClient: unexpected response '" + response + "' from the work server.");
+}
+
+bool parseWorkServerEndpoint(const std::string& endpoint, std::string& host, int& port)
+{
+  const std::size_t sep = endpoint.rfind(':');
+  if(sep == std::string::npos || sep == 0 || sep + 1 >= endpoint.size())
+    return false;
+
+  host = endpoint.substr(0, sep);
+  try
+  {
+    port = std::stoi(endpoint.substr(sep + 1));
+  }
+  catch(const std::exception&)
+  {
+    return false;
+  }
+  return port > 0 && port < 65536;
+}
+
+} // namespace system
+} // namespace aliceVision
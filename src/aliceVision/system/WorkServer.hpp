@@ -0,0 +1,101 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Coordinator side of the dynamic chunk scheduler used by the ranged
+ * pipeline binaries (featureExtraction, featureMatching, depthMapEstimation).
+ *
+ * The coordinator owns a range of [0, nbItems) work items and hands out
+ * [rangeStart, rangeSize) chunks over a plain TCP socket. Workers pull a new
+ * chunk when they finish the previous one and report how long it took, so the
+ * chunk size adapts to the measured per-item cost instead of being guessed
+ * up front: chunks aim at a fixed wall-clock duration and shrink near the end
+ * of the range to keep all the workers busy until the last item.
+ *
+ * The protocol is a single text line per request over a short-lived
+ * connection:
+ *     worker:      GET <workerId> <lastChunkSize> <lastChunkSeconds>
+ *     coordinator: CHUNK <rangeStart> <rangeSize>   or   DONE
+ */
+class WorkServer
+{
+public:
+
+  /**
+   * @param[in] port TCP port to listen on
+   * @param[in] nbItems total number of work items to dispatch
+   * @param[in] targetChunkSeconds wall-clock duration a chunk should aim at
+   */
+  WorkServer(int port, int nbItems, double targetChunkSeconds = 120.0);
+
+  /**
+   * @brief Serve chunk requests until every item has been dispatched and
+   * every known worker has been answered DONE.
+   */
+  void run();
+
+private:
+
+  /// compute the next chunk size from the measured per-item cost
+  int chunkSize() const;
+
+  const int _port;
+  const int _nbItems;
+  const double _targetChunkSeconds;
+
+  int _next = 0;
+  /// exponential average of the reported seconds per item, 0 until the first report
+  double _secondsPerItem = 0.0;
+  /// chunk in flight per worker id, used to wait for the last chunks
+  std::map<long, int> _outstandingPerWorker;
+};
+
+/**
+ * @brief Worker side of the dynamic chunk scheduler, see WorkServer.
+ *
+ * The duration of the previous chunk is measured between two nextChunk()
+ * calls and reported to the coordinator as cost feedback.
+ */
+class WorkClient
+{
+public:
+
+  WorkClient(const std::string& host, int port);
+
+  /**
+   * @brief Pull the next chunk from the coordinator.
+   * @param[out] rangeStart first item of the chunk
+   * @param[out] rangeSize number of items in the chunk
+   * @return false when there is no work left
+   */
+  bool nextChunk(int& rangeStart, int& rangeSize);
+
+private:
+
+  const std::string _host;
+  const int _port;
+  const long _workerId;
+  int _lastChunkSize = 0;
+  std::chrono::steady_clock::time_point _lastChunkTime;
+};
+
+/**
+ * @brief Parse a "host:port" endpoint string.
+ * @return false if the string is not of the expected form
+ */
+bool parseWorkServerEndpoint(const std::string& endpoint, std::string& host, int& port);
+
+} // namespace system
+} // namespace aliceVision
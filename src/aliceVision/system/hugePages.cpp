@@ -0,0 +1,75 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2019 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "hugePages.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+std::size_t hugePageSize()
+{
+    return 2 * 1024 * 1024;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+/**
+ * @brief madvise() requires a page-aligned range: round the buffer inward to
+ * full pages and apply the advice to what remains.
+ */
+bool adviseRange(void* ptr, std::size_t nbBytes, int advice)
+{
+    const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(ptr) + pageSize - 1) & ~(pageSize - 1);
+    const std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(ptr) + nbBytes) & ~(pageSize - 1);
+
+    if(end <= begin)
+        return false; // buffer smaller than a page
+
+    return madvise(reinterpret_cast<void*>(begin), end - begin, advice) == 0;
+}
+
+} // namespace
+
+bool adviseHugePages(void* ptr, std::size_t nbBytes)
+{
+#if defined(MADV_HUGEPAGE)
+    return adviseRange(ptr, nbBytes, MADV_HUGEPAGE);
+#else
+    return false;
+#endif
+}
+
+bool releasePages(void* ptr, std::size_t nbBytes)
+{
+    return adviseRange(ptr, nbBytes, MADV_DONTNEED);
+}
+
+#else // !__linux__
+
+bool adviseHugePages(void* /*ptr*/, std::size_t /*nbBytes*/)
+{
+    return false;
+}
+
+bool releasePages(void* /*ptr*/, std::size_t /*nbBytes*/)
+{
+    return false;
+}
+
+#endif
+
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,42 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2019 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Size of a transparent huge page (2 MB on x86-64 Linux). Buffers below
+ * this size do not benefit from huge-page backing.
+ */
+std::size_t hugePageSize();
+
+/**
+ * @brief Ask the kernel to back a buffer with transparent huge pages
+ * (madvise MADV_HUGEPAGE), reducing dTLB pressure on multi-GB buffers such as
+ * similarity volumes. Only meaningful for buffers of at least hugePageSize().
+ * @param[in] ptr start of the buffer (rounded to page boundaries internally)
+ * @param[in] nbBytes size of the buffer
+ * @return true on success, false when unsupported (non-Linux) or on failure
+ */
+bool adviseHugePages(void* ptr, std::size_t nbBytes);
+
+/**
+ * @brief Return the physical pages of a buffer to the kernel right away
+ * (madvise MADV_DONTNEED) without freeing the virtual range. The content is
+ * lost: subsequent reads return zeros. Use it when a still-allocated buffer
+ * is known to never be read again.
+ * @param[in] ptr start of the buffer (rounded to page boundaries internally)
+ * @param[in] nbBytes size of the buffer
+ * @return true on success, false when unsupported (non-Linux) or on failure
+ */
+bool releasePages(void* ptr, std::size_t nbBytes);
+
+} // namespace system
+} // namespace aliceVision
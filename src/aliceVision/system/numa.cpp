@@ -0,0 +1,152 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2019 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "numa.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#endif
+
+namespace aliceVision {
+namespace system {
+namespace numa {
+
+#if defined(__linux__)
+
+// mbind() policy constants, normally provided by libnuma's numaif.h;
+// defined here so no extra dependency is needed
+#define AV_MPOL_INTERLEAVE 3
+#define AV_MPOL_MF_MOVE (1 << 1)
+
+int getNumaNodeCount()
+{
+    static const int nbNodes = []()
+    {
+        int node = 0;
+        struct stat st;
+        while(stat(("/sys/devices/system/node/node" + std::to_string(node)).c_str(), &st) == 0)
+            ++node;
+        return node > 0 ? node : 1;
+    }();
+    return nbNodes;
+}
+
+bool pinThreadToNumaNode(int node)
+{
+    // the cpulist file holds ranges like "0-15,32-47"
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if(!file)
+        return false;
+
+    std::string cpulist;
+    std::getline(file, cpulist);
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+
+    const char* s = cpulist.c_str();
+    while(*s != '\0')
+    {
+        char* end = nullptr;
+        const long first = std::strtol(s, &end, 10);
+        long last = first;
+        if(*end == '-')
+            last = std::strtol(end + 1, &end, 10);
+        for(long cpu = first; cpu <= last; ++cpu)
+            if(cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpuset);
+        if(*end != ',')
+            break;
+        s = end + 1;
+    }
+
+    return sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0;
+}
+
+void pinOpenMPThreadsRoundRobin()
+{
+    const int nbNodes = getNumaNodeCount();
+    if(nbNodes <= 1)
+        return;
+
+#pragma omp parallel
+    {
+        // spread the workers evenly: thread i goes to node i * nbNodes / nbThreads
+        const int nbThreads = omp_get_num_threads();
+        pinThreadToNumaNode((omp_get_thread_num() * nbNodes) / nbThreads);
+    }
+}
+
+bool interleaveMemory(void* ptr, std::size_t nbBytes)
+{
+    const int nbNodes = getNumaNodeCount();
+    if(nbNodes <= 1)
+        return true; // nothing to balance
+
+    if(nbNodes > static_cast<int>(8 * sizeof(unsigned long)))
+        return false;
+
+    // round the range down/up to page boundaries, as mbind requires
+    const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(ptr) & ~(pageSize - 1);
+    const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(ptr) + nbBytes;
+
+    unsigned long nodeMask = (nbNodes == static_cast<int>(8 * sizeof(unsigned long)))
+        ? ~0ul
+        : (1ul << nbNodes) - 1ul;
+
+    // already-touched pages are moved, so this works right after a plain new[]
+    return syscall(SYS_mbind, begin, end - begin,
+                   AV_MPOL_INTERLEAVE, &nodeMask, 8 * sizeof(unsigned long) + 1,
+                   AV_MPOL_MF_MOVE) == 0;
+}
+
+#else // !__linux__
+
+int getNumaNodeCount()
+{
+    return 1;
+}
+
+bool pinThreadToNumaNode(int /*node*/)
+{
+    return false;
+}
+
+void pinOpenMPThreadsRoundRobin()
+{
+}
+
+bool interleaveMemory(void* /*ptr*/, std::size_t /*nbBytes*/)
+{
+    return false;
+}
+
+#endif
+
+void firstTouch(void* ptr, std::size_t nbBytes)
+{
+    unsigned char* data = static_cast<unsigned char*>(ptr);
+    const std::ptrdiff_t pageSize = 4096;
+
+#pragma omp parallel for
+    for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nbBytes); i += pageSize)
+        data[i] = 0;
+}
+
+} // namespace numa
+} // namespace system
+} // namespace aliceVision
@@ -0,0 +1,60 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2019 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace system {
+namespace numa {
+
+/**
+ * @brief Number of NUMA nodes of the machine.
+ * @return the node count, 1 on single-node machines and on platforms
+ *         without NUMA support (only Linux is supported).
+ */
+int getNumaNodeCount();
+
+/**
+ * @brief Pin the calling thread to the CPUs of one NUMA node, so its memory
+ * accesses stay local to that node.
+ * @param[in] node the NUMA node index
+ * @return true on success, false when pinning is unsupported or fails
+ */
+bool pinThreadToNumaNode(int node);
+
+/**
+ * @brief Distribute the OpenMP worker threads evenly over the NUMA nodes and
+ * pin each one to its node. Call it once before the parallel stage; a no-op
+ * on single-node machines.
+ */
+void pinOpenMPThreadsRoundRobin();
+
+/**
+ * @brief Interleave the pages of a buffer across all NUMA nodes, so threads
+ * on every socket pay the same average access cost. Already-touched pages are
+ * migrated. Intended for big shared buffers read by all workers (image cache
+ * slots, similarity volumes).
+ * @param[in] ptr start of the buffer (rounded down to a page internally)
+ * @param[in] nbBytes size of the buffer
+ * @return true on success, false when interleaving is unsupported or fails
+ */
+bool interleaveMemory(void* ptr, std::size_t nbBytes);
+
+/**
+ * @brief Touch the pages of a freshly allocated buffer from the OpenMP worker
+ * threads, so the first-touch policy places every page on the node of the
+ * thread that will use it. The touched bytes are zeroed: only call this on
+ * memory that is not initialized yet.
+ * @param[in] ptr start of the buffer
+ * @param[in] nbBytes size of the buffer
+ */
+void firstTouch(void* ptr, std::size_t nbBytes);
+
+} // namespace numa
+} // namespace system
+} // namespace aliceVision
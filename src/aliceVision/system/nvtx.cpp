@@ -15,6 +15,11 @@ void nvtxPushA( const char* label, const char* file, int line )
     nvtxRangePushA( ostr.str().c_str() );
 }
 
+void nvtxPushLabel( const char* label )
+{
+    nvtxRangePushA( label );
+}
+
 void nvtxPop ( const char* )
 {
     nvtxRangePop( );
@@ -1,11 +1,29 @@
 #pragma once
 
+#include <string>
+
 #define nvtxPush(a) nvtxPushA(a,__FILE__,__LINE__)
 
 #ifdef ALICEVISION_USE_NVTX
 void nvtxPushA( const char* label, const char* file, int line );
+void nvtxPushLabel( const char* label );
 void nvtxPop ( const char* label );
 #else
 inline void nvtxPushA( const char*, const char*, int ) { }
+inline void nvtxPushLabel( const char* ) { }
 inline void nvtxPop ( const char* ) { }
 #endif
+
+/**
+ * @brief RAII NVTX range, the ranges nest in the profiler timeline.
+ * Compiles to a no-op without ALICEVISION_USE_NVTX.
+ */
+class NvtxScope
+{
+public:
+    explicit NvtxScope( const std::string& label ) { nvtxPushLabel( label.c_str() ); }
+    ~NvtxScope() { nvtxPop( "" ); }
+
+    NvtxScope( const NvtxScope& ) = delete;
+    NvtxScope& operator=( const NvtxScope& ) = delete;
+};
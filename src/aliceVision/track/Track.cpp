@@ -7,50 +7,146 @@
 
 #include "Track.hpp"
 
+#include <numeric>
+
 namespace aliceVision {
 namespace track {
 
 using namespace aliceVision::matching;
 using namespace lemon;
 
+namespace {
+
+/// Minimal union-find over contiguous indices (path halving, union by lowest
+/// root). Used to fuse the matches in parallel before replaying the classes
+/// into the lemon structure.
+struct IndexUnionFind
+{
+  explicit IndexUnionFind(std::size_t nbElements)
+    : parent(nbElements)
+  {
+    std::iota(parent.begin(), parent.end(), 0);
+  }
+
+  std::size_t find(std::size_t i)
+  {
+    while(parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
+
+  void join(std::size_t a, std::size_t b)
+  {
+    a = find(a);
+    b = find(b);
+    if(a != b)
+      parent[std::max(a, b)] = std::min(a, b);
+  }
+
+  std::vector<std::size_t> parent;
+};
+
+} // namespace
+
 void TracksBuilder::build(const PairwiseMatches& pairwiseMatches)
 {
-  typedef std::set<IndexedFeaturePair> SetIndexedPair;
+  // flatten the pair map to allow indexed (parallel) iteration
+  std::vector<PairwiseMatches::const_iterator> pairList;
+  pairList.reserve(pairwiseMatches.size());
+  for(PairwiseMatches::const_iterator it = pairwiseMatches.begin(); it != pairwiseMatches.end(); ++it)
+    pairList.push_back(it);
 
   // set of all features of all images: (imageIndex, featureIndex)
-  SetIndexedPair allFeatures;
+  // collected with per-thread vectors then sorted/uniqued, which is much
+  // cheaper than a shared std::set on tens of millions of matches
+  std::vector<IndexedFeaturePair> allFeatures;
 
-  // for each couple of images make the union according the pair matches
-  for(const auto& matchesPerDescIt: pairwiseMatches)
+#pragma omp parallel
   {
-    const std::size_t& I = matchesPerDescIt.first.first;
-    const std::size_t& J = matchesPerDescIt.first.second;
-    const MatchesPerDescType& matchesPerDesc = matchesPerDescIt.second;
+    std::vector<IndexedFeaturePair> threadFeatures;
 
-    for(const auto& matchesIt: matchesPerDesc)
+#pragma omp for schedule(dynamic) nowait
+    for(int p = 0; p < static_cast<int>(pairList.size()); ++p)
     {
-      const feature::EImageDescriberType descType = matchesIt.first;
-      const IndMatches& matches = matchesIt.second;
-      // we have correspondences between I and J image index.
-      for(const IndMatch& m: matches)
+      const std::size_t& I = pairList[p]->first.first;
+      const std::size_t& J = pairList[p]->first.second;
+
+      for(const auto& matchesIt: pairList[p]->second)
       {
-        IndexedFeaturePair pairI(I, KeypointId(descType, m._i));
-        IndexedFeaturePair pairJ(J, KeypointId(descType, m._j));
-        allFeatures.insert(pairI);
-        allFeatures.insert(pairJ);
+        const feature::EImageDescriberType descType = matchesIt.first;
+        // we have correspondences between I and J image index.
+        for(const IndMatch& m: matchesIt.second)
+        {
+          threadFeatures.emplace_back(I, KeypointId(descType, m._i));
+          threadFeatures.emplace_back(J, KeypointId(descType, m._j));
+        }
+      }
+    }
+
+#pragma omp critical
+    allFeatures.insert(allFeatures.end(), threadFeatures.begin(), threadFeatures.end());
+  }
+
+  std::sort(allFeatures.begin(), allFeatures.end());
+  allFeatures.erase(std::unique(allFeatures.begin(), allFeatures.end()), allFeatures.end());
+
+  // the sorted feature list gives each feature a contiguous index
+  const auto featureIndex = [&allFeatures](const IndexedFeaturePair& featPair) -> std::size_t
+  {
+    return std::distance(allFeatures.begin(),
+                         std::lower_bound(allFeatures.begin(), allFeatures.end(), featPair));
+  };
+
+  // fuse the matches with a partition-then-merge union-find: each thread
+  // fuses its share of the pairs into a local structure and the per-thread
+  // equivalence classes are merged at the end
+  IndexUnionFind unionFind(allFeatures.size());
+
+#pragma omp parallel
+  {
+    IndexUnionFind threadUnionFind(allFeatures.size());
+
+#pragma omp for schedule(dynamic) nowait
+    for(int p = 0; p < static_cast<int>(pairList.size()); ++p)
+    {
+      const std::size_t& I = pairList[p]->first.first;
+      const std::size_t& J = pairList[p]->first.second;
+
+      for(const auto& matchesIt: pairList[p]->second)
+      {
+        const feature::EImageDescriberType descType = matchesIt.first;
+        for(const IndMatch& m: matchesIt.second)
+        {
+          const IndexedFeaturePair pairI(I, KeypointId(descType, m._i));
+          const IndexedFeaturePair pairJ(J, KeypointId(descType, m._j));
+          threadUnionFind.join(featureIndex(pairI), featureIndex(pairJ));
+        }
+      }
+    }
+
+#pragma omp critical
+    {
+      for(std::size_t i = 0; i < threadUnionFind.parent.size(); ++i)
+      {
+        const std::size_t root = threadUnionFind.find(i);
+        if(root != i)
+          unionFind.join(i, root);
       }
     }
   }
 
   // build the node indirection for each referenced feature
-  MapIndexToNode map_indexToNode;
-  map_indexToNode.reserve(allFeatures.size());
+  std::vector<lemon::ListDigraph::Node> nodes;
+  nodes.reserve(allFeatures.size());
   _map_nodeToIndex.reserve(allFeatures.size());
 
   for(const IndexedFeaturePair& featPair: allFeatures)
   {
     lemon::ListDigraph::Node node = _graph.addNode();
-    map_indexToNode.insert(std::make_pair(featPair, node));
+    nodes.push_back(node);
     _map_nodeToIndex.insert(std::make_pair(node, featPair));
   }
 
@@ -63,25 +159,13 @@ void TracksBuilder::build(const PairwiseMatches& pairwiseMatches)
     _tracksUF->insert(it);
   }
 
-  // make the union according the pair matches
-  for(const auto& matchesPerDescIt: pairwiseMatches)
+  // replay the merged classes into the lemon union-find: one join per
+  // feature instead of one per match
+  for(std::size_t i = 0; i < allFeatures.size(); ++i)
   {
-    const std::size_t& I = matchesPerDescIt.first.first;
-    const std::size_t& J = matchesPerDescIt.first.second;
-    const MatchesPerDescType& matchesPerDesc = matchesPerDescIt.second;
-
-    for(const auto& matchesIt: matchesPerDesc)
-    {
-      const feature::EImageDescriberType descType = matchesIt.first;
-      const IndMatches& matches = matchesIt.second;
-      // we have correspondences between I and J image index.
-      for(const IndMatch& m: matches)
-      {
-        IndexedFeaturePair pairI(I, KeypointId(descType, m._i));
-        IndexedFeaturePair pairJ(J, KeypointId(descType, m._j));
-        _tracksUF->join(map_indexToNode[pairI], map_indexToNode[pairJ]);
-      }
-    }
+    const std::size_t root = unionFind.find(i);
+    if(root != i)
+      _tracksUF->join(nodes[i], nodes[root]);
   }
 }
 
@@ -161,6 +245,39 @@ void TracksBuilder::exportToSTL(TracksMap& allTracks) const
   }
 }
 
+void TracksBuilder::exportToSTL(FlatTracks& allTracks) const
+{
+  allTracks.clear();
+
+  // count the tracks and the observations first so that the arena is
+  // allocated only once
+  std::size_t nbTracks = 0;
+  std::size_t nbObservations = 0;
+  for(lemon::UnionFindEnum< IndexMap >::ClassIt cit(*_tracksUF); cit != INVALID; ++cit)
+  {
+    ++nbTracks;
+    for(lemon::UnionFindEnum< IndexMap >::ItemIt iit(*_tracksUF, cit); iit != INVALID; ++iit)
+      ++nbObservations;
+  }
+  allTracks.reserve(nbTracks, nbObservations);
+
+  std::size_t trackIndex = 0;
+  for(lemon::UnionFindEnum< IndexMap >::ClassIt cit(*_tracksUF); cit != INVALID; ++cit, ++trackIndex)
+  {
+    // all descType inside the track will be the same
+    const IndexedFeaturePair& firstPair = _map_nodeToIndex.at(lemon::UnionFindEnum< IndexMap >::ItemIt(*_tracksUF, cit));
+
+    allTracks.beginTrack(trackIndex, firstPair.second.descType);
+
+    for(lemon::UnionFindEnum< IndexMap >::ItemIt iit(*_tracksUF, cit); iit != INVALID; ++iit)
+    {
+      const IndexedFeaturePair& currentPair = _map_nodeToIndex.at(iit);
+      allTracks.addObservation(currentPair.first, currentPair.second.featIndex);
+    }
+    allTracks.endTrack();
+  }
+}
+
 namespace tracksUtilsMap {
 
 bool getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
@@ -194,7 +311,7 @@ bool getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
 
 void getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
                              const TracksPerView& tracksPerView,
-                             std::set<std::size_t>& visibleTracks)
+                             TrackIdSet& visibleTracks)
 {
   assert(!imageIndexes.empty());
   visibleTracks.clear();
@@ -208,16 +325,17 @@ void getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
     if(tracksPerViewIt == tracksPerView.end())
     {
       // one image is not present in the tracksPerView, so there is no track in common
-      visibleTracks.clear();
       return;
     }
-    const TrackIdSet& imageTracks = tracksPerViewIt->second;
     // copy all the visible tracks by the first image
-    visibleTracks.insert(imageTracks.cbegin(), imageTracks.cend());
+    visibleTracks = tracksPerViewIt->second;
   }
   ++it;
-  // for each of the remaining view
-  for(; it != imageIndexes.cend(); ++it)
+  // for each of the remaining view, intersect with a linear merge: the track
+  // ids of each view are sorted so no intermediate std::set is needed
+  TrackIdSet tmp;
+  tmp.reserve(visibleTracks.size());
+  for(; it != imageIndexes.cend() && !visibleTracks.empty(); ++it)
   {
     // if there are no tracks for this view just return
     TracksPerView::const_iterator tracksPerViewIt = tracksPerView.find(*it);
@@ -228,15 +346,25 @@ void getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
       return;
     }
     const TrackIdSet& imageTracks = tracksPerViewIt->second;
-    std::set<std::size_t> tmp;
+    tmp.clear();
     std::set_intersection(
         visibleTracks.cbegin(), visibleTracks.cend(),
         imageTracks.cbegin(), imageTracks.cend(),
-        std::inserter(tmp, tmp.begin()));
+        std::back_inserter(tmp));
     visibleTracks.swap(tmp);
   }
 }
 
+void getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
+                             const TracksPerView& tracksPerView,
+                             std::set<std::size_t>& visibleTracks)
+{
+  TrackIdSet commonTracks;
+  getCommonTracksInImages(imageIndexes, tracksPerView, commonTracks);
+  visibleTracks.clear();
+  visibleTracks.insert(commonTracks.cbegin(), commonTracks.cend());
+}
+
 bool getCommonTracksInImagesFast(const std::set<std::size_t>& imageIndexes,
                                  const TracksMap& tracksIn,
                                  const TracksPerView& tracksPerView,
@@ -245,11 +373,11 @@ bool getCommonTracksInImagesFast(const std::set<std::size_t>& imageIndexes,
   assert(!imageIndexes.empty());
   tracksOut.clear();
 
-  std::set<std::size_t> set_visibleTracks;
-  getCommonTracksInImages(imageIndexes, tracksPerView, set_visibleTracks);
+  TrackIdSet visibleTracks;
+  getCommonTracksInImages(imageIndexes, tracksPerView, visibleTracks);
 
   // go along the tracks
-  for(std::size_t visibleTrack: set_visibleTracks)
+  for(std::size_t visibleTrack: visibleTracks)
   {
     TracksMap::const_iterator itTrackIn = tracksIn.find(visibleTrack);
     if(itTrackIn == tracksIn.end())
@@ -268,6 +396,36 @@ bool getCommonTracksInImagesFast(const std::set<std::size_t>& imageIndexes,
   return !tracksOut.empty();
 }
 
+bool getCommonTracksInImagesFast(const std::set<std::size_t>& imageIndexes,
+                                 const FlatTracks& tracksIn,
+                                 const TracksPerView& tracksPerView,
+                                 TracksMap& tracksOut)
+{
+  assert(!imageIndexes.empty());
+  tracksOut.clear();
+
+  TrackIdSet visibleTracks;
+  getCommonTracksInImages(imageIndexes, tracksPerView, visibleTracks);
+
+  // go along the tracks
+  for(std::size_t visibleTrack: visibleTracks)
+  {
+    const std::size_t trackIndex = tracksIn.findTrack(visibleTrack);
+    if(trackIndex == tracksIn.size())
+      continue;
+    Track& trackFeatsOut = tracksOut[visibleTrack];
+    trackFeatsOut.descType = tracksIn.descType(trackIndex);
+    for(std::size_t imageIndex: imageIndexes)
+    {
+      const FlatTracks::Observation* obs = tracksIn.findObservation(trackIndex, imageIndex);
+      if(obs != nullptr)
+        trackFeatsOut.featPerView[imageIndex] = obs->featureId;
+    }
+    assert(trackFeatsOut.featPerView.size() == imageIndexes.size());
+  }
+  return !tracksOut.empty();
+}
+
 void getTracksInImages(const std::set<std::size_t>& imagesId,
                        const TracksMap& tracks,
                        std::set<std::size_t>& tracksId)
@@ -288,35 +446,74 @@ void getTracksInImagesFast(const std::set<IndexT>& imagesId,
   tracksIds.clear();
   for(const std::size_t id : imagesId)
   {
-    std::set<std::size_t> currentImageTracks;
-    getTracksInImageFast(id, tracksPerView, currentImageTracks);
-    tracksIds.insert(currentImageTracks.begin(), currentImageTracks.end());
+    // insert the sorted track ids of the view directly, no temporary set needed
+    TracksPerView::const_iterator tracksPerViewIt = tracksPerView.find(id);
+    if(tracksPerViewIt == tracksPerView.end())
+      continue;
+    tracksIds.insert(tracksPerViewIt->second.cbegin(), tracksPerViewIt->second.cend());
   }
 }
-  
+
 void computeTracksPerView(const TracksMap& tracks, TracksPerView& tracksPerView)
 {
+  // count the visible tracks of each view first, so that the view entries are
+  // created in sorted order and each track id list is allocated only once
+  std::map<std::size_t, std::size_t> nbTracksPerView;
   for(const auto& track: tracks)
   {
     for(const auto& feat: track.second.featPerView)
-    {
-      TrackIdSet& tracksSet = tracksPerView[feat.first];
-      if(tracksSet.empty())
-        tracksSet.reserve(1000);
-      tracksSet.push_back(track.first);
-    }
+      ++nbTracksPerView[feat.first];
+  }
+
+  tracksPerView.reserve(tracksPerView.size() + nbTracksPerView.size());
+  for(const auto& viewCount: nbTracksPerView)
+  {
+    TrackIdSet& tracksSet = tracksPerView[viewCount.first];
+    tracksSet.reserve(tracksSet.size() + viewCount.second);
+  }
+
+  for(const auto& track: tracks)
+  {
+    for(const auto& feat: track.second.featPerView)
+      tracksPerView[feat.first].push_back(track.first);
   }
 
   // sort tracks Ids in each view
 #pragma omp parallel for
-  for(int i = 0; i < tracksPerView.size(); ++i)
+  for(int i = 0; i < static_cast<int>(tracksPerView.size()); ++i)
   {
-    TracksPerView::iterator it = tracksPerView.begin();
-    std::advance(it, i);
+    TracksPerView::iterator it = tracksPerView.begin() + i;
     std::sort(it->second.begin(), it->second.end());
   }
 }
 
+void computeTracksPerView(const FlatTracks& tracks, TracksPerView& tracksPerView)
+{
+  // count the visible tracks of each view first, so that the view entries are
+  // created in sorted order and each track id list is allocated only once
+  std::map<std::size_t, std::size_t> nbTracksPerView;
+  for(std::size_t i = 0; i < tracks.size(); ++i)
+  {
+    for(const FlatTracks::Observation* obs = tracks.observationsBegin(i); obs != tracks.observationsEnd(i); ++obs)
+      ++nbTracksPerView[obs->viewId];
+  }
+
+  tracksPerView.reserve(tracksPerView.size() + nbTracksPerView.size());
+  for(const auto& viewCount: nbTracksPerView)
+  {
+    TrackIdSet& tracksSet = tracksPerView[viewCount.first];
+    tracksSet.reserve(tracksSet.size() + viewCount.second);
+  }
+
+  for(std::size_t i = 0; i < tracks.size(); ++i)
+  {
+    for(const FlatTracks::Observation* obs = tracks.observationsBegin(i); obs != tracks.observationsEnd(i); ++obs)
+      tracksPerView[obs->viewId].push_back(tracks.trackId(i));
+  }
+
+  // the tracks are stored by increasing id, so each view list is already sorted
+}
+
 } // namespace tracksUtilsMap
 } // namespace track
 } // namespace aliceVision
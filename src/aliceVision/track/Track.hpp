@@ -51,6 +51,139 @@ struct Track
 typedef stl::flat_map<std::size_t, Track> TracksMap;
 typedef std::vector<std::size_t> TrackIdSet;
 
+/**
+ * @brief Compact storage for a set of tracks: all the {viewId, featureId}
+ * observations live in a single arena and each track references a contiguous
+ * span of it (CSR layout).
+ *
+ * Compared to TracksMap this avoids one container per track, so building and
+ * iterating millions of tracks costs a few large allocations instead of
+ * millions of small ones and the iteration stays cache friendly.
+ *
+ * The tracks are stored by increasing track id and the observations of each
+ * track are sorted by increasing view id (lookups use binary searches).
+ */
+struct FlatTracks
+{
+  /// one {viewId, featureId} entry of a track
+  struct Observation
+  {
+    std::size_t viewId;
+    std::size_t featureId;
+  };
+
+  /// @return the number of tracks
+  std::size_t size() const
+  {
+    return _trackIds.size();
+  }
+
+  bool empty() const
+  {
+    return _trackIds.empty();
+  }
+
+  void clear()
+  {
+    _trackIds.clear();
+    _descTypes.clear();
+    _offsets.assign(1, 0);
+    _observations.clear();
+  }
+
+  /// pre-allocate the storage (one call for all the tracks)
+  void reserve(std::size_t nbTracks, std::size_t nbObservations)
+  {
+    _trackIds.reserve(nbTracks);
+    _descTypes.reserve(nbTracks);
+    _offsets.reserve(nbTracks + 1);
+    _observations.reserve(nbObservations);
+  }
+
+  /// start a new track, the track ids must be appended in increasing order
+  void beginTrack(std::size_t trackId, feature::EImageDescriberType descType)
+  {
+    assert(_trackIds.empty() || _trackIds.back() < trackId);
+    _trackIds.push_back(trackId);
+    _descTypes.push_back(descType);
+  }
+
+  /// append an observation to the track opened by the last beginTrack()
+  void addObservation(std::size_t viewId, std::size_t featureId)
+  {
+    _observations.push_back({viewId, featureId});
+  }
+
+  /// close the track opened by the last beginTrack(): sort its observations by view
+  void endTrack()
+  {
+    std::sort(_observations.begin() + _offsets.back(), _observations.end(),
+              [](const Observation& a, const Observation& b) { return a.viewId < b.viewId; });
+    _offsets.push_back(_observations.size());
+  }
+
+  /// @return the id of the i-th track
+  std::size_t trackId(std::size_t i) const
+  {
+    return _trackIds[i];
+  }
+
+  /// @return the describer type of the i-th track
+  feature::EImageDescriberType descType(std::size_t i) const
+  {
+    return _descTypes[i];
+  }
+
+  /// @return the number of observations of the i-th track
+  std::size_t nbObservations(std::size_t i) const
+  {
+    return _offsets[i + 1] - _offsets[i];
+  }
+
+  /// @return begin of the observations of the i-th track (sorted by view id)
+  const Observation* observationsBegin(std::size_t i) const
+  {
+    return _observations.data() + _offsets[i];
+  }
+
+  /// @return end of the observations of the i-th track
+  const Observation* observationsEnd(std::size_t i) const
+  {
+    return _observations.data() + _offsets[i + 1];
+  }
+
+  /// @return the index of the track with the given id, or size() if unknown
+  std::size_t findTrack(std::size_t trackId) const
+  {
+    const auto it = std::lower_bound(_trackIds.begin(), _trackIds.end(), trackId);
+    if(it == _trackIds.end() || *it != trackId)
+      return size();
+    return std::distance(_trackIds.begin(), it);
+  }
+
+  /// @return the observation of the i-th track in the given view, nullptr if not seen
+  const Observation* findObservation(std::size_t i, std::size_t viewId) const
+  {
+    const Observation* first = observationsBegin(i);
+    const Observation* last = observationsEnd(i);
+    const Observation* it = std::lower_bound(first, last, viewId,
+        [](const Observation& obs, std::size_t id) { return obs.viewId < id; });
+    if(it == last || it->viewId != viewId)
+      return nullptr;
+    return it;
+  }
+
+private:
+  /// id of each track (sorted increasing)
+  std::vector<std::size_t> _trackIds;
+  /// describer type of each track
+  std::vector<feature::EImageDescriberType> _descTypes;
+  /// span of each track in the observation arena, size() + 1 entries
+  std::vector<std::size_t> _offsets = {0};
+  /// observation arena shared by all the tracks
+  std::vector<Observation> _observations;
+};
+
 /**
  * @brief Data structure that contains for each features of each view, its corresponding cell positions for each level of the pyramid, i.e.
  * for each view:
@@ -91,6 +224,11 @@ struct KeypointId
     return descType < other.descType;
   }
 
+  bool operator==(const KeypointId& other) const
+  {
+    return descType == other.descType && featIndex == other.featIndex;
+  }
+
   feature::EImageDescriberType descType = feature::EImageDescriberType::UNINITIALIZED;
   std::size_t featIndex = 0;
 };
@@ -180,6 +318,12 @@ struct TracksBuilder
    */
   void exportToSTL(TracksMap& allTracks) const;
 
+  /**
+   * @brief Export tracks into the compact CSR storage: all the observations
+   * are appended to a single arena instead of one container per track.
+   */
+  void exportToSTL(FlatTracks& allTracks) const;
+
   /**
    * @brief Return the number of connected set in the UnionFind structure (tree forest)
    * @return number of connected set in the UnionFind structure
@@ -205,6 +349,17 @@ bool getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
                                     const TracksMap& tracksIn,
                                     TracksMap & tracksOut);
   
+/**
+ * @brief Find common tracks among a set of images.
+ * The intersection is a linear merge of the per-view sorted track id lists.
+ * @param[in] imageIndexes: set of images we are looking for common tracks.
+ * @param[in] tracksPerView: for each view it contains the list of visible tracks. *The tracks ids must be ordered*.
+ * @param[out] visibleTracks: output with only the common tracks (sorted increasing).
+ */
+void getCommonTracksInImages(const std::set<std::size_t>& imageIndexes,
+                                    const TracksPerView& tracksPerView,
+                                    TrackIdSet& visibleTracks);
+
 /**
  * @brief Find common tracks among a set of images.
  * @param[in] imageIndexes: set of images we are looking for common tracks.
@@ -226,6 +381,18 @@ bool getCommonTracksInImagesFast(const std::set<std::size_t>& imageIndexes,
                                           const TracksMap& tracksIn,
                                           const TracksPerView& tracksPerView,
                                           TracksMap& tracksOut);
+
+/**
+ * @brief Find common tracks among images, from the compact track storage.
+ * @param[in] imageIndexes: set of images we are looking for common tracks.
+ * @param[in] tracksIn: all tracks of the scene.
+ * @param[in] tracksPerView: for each view the id of the visible tracks.
+ * @param[out] tracksOut: output with only the common tracks.
+ */
+bool getCommonTracksInImagesFast(const std::set<std::size_t>& imageIndexes,
+                                          const FlatTracks& tracksIn,
+                                          const TracksPerView& tracksPerView,
+                                          TracksMap& tracksOut);
   
 /**
  * @brief Find all the visible tracks from a set of images.
@@ -291,6 +458,13 @@ inline void getTracksInImageFast(const std::size_t& imageId,
  */
 void computeTracksPerView(const TracksMap& tracks, TracksPerView& tracksPerView);
 
+/**
+ * @brief computeTracksPerView, from the compact track storage.
+ * @param[in] tracks
+ * @param[out] tracksPerView
+ */
+void computeTracksPerView(const FlatTracks& tracks, TracksPerView& tracksPerView);
+
 /**
  * @brief Return the tracksId as a set (sorted increasing)
  * @param[in] tracks
@@ -336,6 +510,36 @@ inline bool getFeatureIdInViewPerTrack(const TracksMap& allTracks,
   return !out_featId->empty();
 }
 
+/**
+ * @brief Get feature id (with associated describer type) in the specified view for each TrackId,
+ *        from the compact track storage.
+ * @param[in] allTracks
+ * @param[in] trackIds
+ * @param[in] viewId
+ * @param[out] out_featId
+ * @return
+ */
+inline bool getFeatureIdInViewPerTrack(const FlatTracks& allTracks,
+                                       const std::set<std::size_t>& trackIds,
+                                       IndexT viewId,
+                                       std::vector<FeatureId>* out_featId)
+{
+  for(std::size_t trackId: trackIds)
+  {
+    const std::size_t trackIndex = allTracks.findTrack(trackId);
+
+    // ignore it if the track doesn't exist
+    if(trackIndex == allTracks.size())
+      continue;
+
+    // try to find imageIndex
+    const FlatTracks::Observation* obs = allTracks.findObservation(trackIndex, viewId);
+    if(obs != nullptr)
+      out_featId->emplace_back(allTracks.descType(trackIndex), obs->featureId);
+  }
+  return !out_featId->empty();
+}
+
 struct FunctorMapFirstEqual : public std::unary_function <TracksMap , bool>
 {
   std::size_t id;
@@ -403,6 +607,18 @@ inline void tracksLength(const TracksMap& tracks,
   }
 }
 
+/**
+ * @brief Return the occurrence of tracks length, from the compact track storage.
+ * @param[in] tracks
+ * @param[out] occurenceTrackLength
+ */
+inline void tracksLength(const FlatTracks& tracks,
+                         std::map<std::size_t, std::size_t>& occurenceTrackLength)
+{
+  for(std::size_t i = 0; i < tracks.size(); ++i)
+    occurenceTrackLength[tracks.nbObservations(i)] += 1;
+}
+
 /**
  * @brief Return a set containing the image Id considered in the tracks container.
  * @param[in] tracksPerView
@@ -178,6 +178,85 @@ BOOST_AUTO_TEST_CASE(Track_Conflict) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(Track_FlatTracks) {
+
+  // same fixture as Track_Simple
+  //A    B    C
+  //0 -> 0 -> 0
+  //1 -> 1 -> 6
+  //2 -> 3
+
+  PairwiseMatches map_pairwisematches;
+
+  const IndMatch testAB[] = {IndMatch(0,0), IndMatch(1,1), IndMatch(2,3)};
+  const IndMatch testBC[] = {IndMatch(0,0), IndMatch(1,6)};
+
+  const std::vector<IndMatch> ab(testAB, testAB+3);
+  const std::vector<IndMatch> bc(testBC, testBC+2);
+  const int A = 0;
+  const int B = 1;
+  const int C = 2;
+  map_pairwisematches[ std::make_pair(A, B) ][EImageDescriberType::UNKNOWN] = ab;
+  map_pairwisematches[ std::make_pair(B, C) ][EImageDescriberType::UNKNOWN] = bc;
+
+  TracksBuilder trackBuilder;
+  trackBuilder.build( map_pairwisematches );
+
+  FlatTracks flatTracks;
+  trackBuilder.exportToSTL(flatTracks);
+
+  // the flat storage must contain the same tracks as the map export
+  TracksMap map_tracks;
+  trackBuilder.exportToSTL(map_tracks);
+
+  BOOST_CHECK_EQUAL(map_tracks.size(), flatTracks.size());
+
+  for(std::size_t i = 0; i < flatTracks.size(); ++i)
+  {
+    const Track& track = map_tracks.at(flatTracks.trackId(i));
+
+    BOOST_CHECK(track.descType == flatTracks.descType(i));
+    BOOST_CHECK_EQUAL(track.featPerView.size(), flatTracks.nbObservations(i));
+
+    // observations are sorted by view and match the map export
+    const FlatTracks::Observation* obs = flatTracks.observationsBegin(i);
+    for(auto iter = track.featPerView.begin(); iter != track.featPerView.end(); ++iter, ++obs)
+    {
+      BOOST_CHECK_EQUAL(iter->first, obs->viewId);
+      BOOST_CHECK_EQUAL(iter->second, obs->featureId);
+    }
+
+    // per-view lookup
+    for(auto iter = track.featPerView.begin(); iter != track.featPerView.end(); ++iter)
+    {
+      const FlatTracks::Observation* found = flatTracks.findObservation(i, iter->first);
+      BOOST_CHECK(found != nullptr);
+      BOOST_CHECK_EQUAL(iter->second, found->featureId);
+    }
+    BOOST_CHECK(flatTracks.findObservation(i, 999) == nullptr);
+  }
+
+  // unknown track id
+  BOOST_CHECK_EQUAL(flatTracks.size(), flatTracks.findTrack(999));
+
+  // the tracks per view structure must match the one built from the map
+  TracksPerView tracksPerViewRef, tracksPerViewFlat;
+  tracksUtilsMap::computeTracksPerView(map_tracks, tracksPerViewRef);
+  tracksUtilsMap::computeTracksPerView(flatTracks, tracksPerViewFlat);
+  BOOST_CHECK(tracksPerViewRef == tracksPerViewFlat);
+
+  // common tracks retrieval must match the map based overload
+  TracksMap commonRef, commonFlat;
+  tracksUtilsMap::getCommonTracksInImagesFast({A, C}, map_tracks, tracksPerViewRef, commonRef);
+  tracksUtilsMap::getCommonTracksInImagesFast({A, C}, flatTracks, tracksPerViewFlat, commonFlat);
+  BOOST_CHECK_EQUAL(commonRef.size(), commonFlat.size());
+  for(const auto& trackPair: commonRef)
+  {
+    BOOST_CHECK(commonFlat.count(trackPair.first) == 1);
+    BOOST_CHECK(commonFlat.at(trackPair.first).featPerView == trackPair.second.featPerView);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(Track_GetCommonTracksInImages)
 {
   {
@@ -199,6 +278,13 @@ BOOST_AUTO_TEST_CASE(Track_GetCommonTracksInImages)
     // test non-existing view index
     tracksUtilsMap::getCommonTracksInImages({15, 50}, map_tracksPerView, set_visibleTracks);
     BOOST_CHECK(set_visibleTracks.empty());
+
+    // the sorted vector overload must give the same (ordered) result
+    TrackIdSet visibleTracks;
+    tracksUtilsMap::getCommonTracksInImages(set_imageIndex, map_tracksPerView, visibleTracks);
+    BOOST_CHECK(visibleTracks == base);
+    tracksUtilsMap::getCommonTracksInImages({15, 50}, map_tracksPerView, visibleTracks);
+    BOOST_CHECK(visibleTracks.empty());
   }
   {
     std::set<std::size_t> set_imageIndex {15, 20, 10, 40};
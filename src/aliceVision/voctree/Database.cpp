@@ -5,9 +5,11 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "Database.hpp"
+#include <aliceVision/alicevision_omp.hpp>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/tail.hpp>
 #include <boost/progress.hpp>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <stdexcept>
@@ -48,9 +50,70 @@ DocId Database::insert(DocId doc_id, const SparseHistogram& document)
 
   database_[doc_id] = document;
 
+  // Keep the flattened copy used by find() sorted by DocId, so that the scoring
+  // loop visits the documents in the same order as the map above.
+  DocumentVector flat = flattenSparseHistogram(document);
+  auto position = std::lower_bound(flat_database_.begin(), flat_database_.end(), doc_id,
+                                   [](const std::pair<DocId, DocumentVector>& doc, DocId id) { return doc.first < id; });
+  flat_database_.emplace(position, doc_id, std::move(flat));
+
   return doc_id;
 }
 
+void Database::insertBatch(std::vector<std::pair<DocId, SparseHistogram>> documents)
+{
+  if(documents.empty())
+    return;
+
+  // process in increasing DocId order so the inverted files and the flat copy
+  // used by find() keep their ordering
+  std::sort(documents.begin(), documents.end(),
+            [](const std::pair<DocId, SparseHistogram>& a, const std::pair<DocId, SparseHistogram>& b)
+            { return a.first < b.first; });
+
+  // bucket the (word, document) entries by word shard in one cheap pass, then
+  // let each thread append the words of its own shard: no two threads ever
+  // touch the same inverted file and every file keeps its DocId ordering
+  const int nbShards = omp_get_max_threads();
+  std::vector<std::vector<std::pair<Word, WordFrequency>>> shards(nbShards);
+  for(const auto& doc : documents)
+  {
+    // Ensure that the new document to insert is not already there.
+    assert(database_.find(doc.first) == database_.end());
+    for(const auto& word : doc.second)
+      shards[word.first % nbShards].emplace_back(word.first, WordFrequency(doc.first, word.second.size()));
+  }
+
+  #pragma omp parallel for
+  for(int s = 0; s < nbShards; ++s)
+  {
+    for(const auto& entry : shards[s])
+    {
+      InvertedFile& file = word_files_[entry.first];
+      if(file.empty() || file.back().id != entry.second.id)
+        file.push_back(entry.second);
+      else
+        file.back().count += entry.second.count;
+    }
+  }
+
+  // flatten the new documents in parallel, then merge the two sorted ranges
+  const std::size_t firstNew = flat_database_.size();
+  flat_database_.resize(firstNew + documents.size());
+  #pragma omp parallel for
+  for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(documents.size()); ++i)
+  {
+    flat_database_[firstNew + i].first = documents[i].first;
+    flat_database_[firstNew + i].second = flattenSparseHistogram(documents[i].second);
+  }
+  std::inplace_merge(flat_database_.begin(), flat_database_.begin() + firstNew, flat_database_.end(),
+                     [](const std::pair<DocId, DocumentVector>& a, const std::pair<DocId, DocumentVector>& b)
+                     { return a.first < b.first; });
+
+  for(auto& doc : documents)
+    database_[doc.first] = std::move(doc.second);
+}
+
 void Database::sanityCheck(std::size_t N, std::map<std::size_t, DocMatches>& matches) const
 {
   // if N is equal to zero
@@ -67,18 +130,21 @@ void Database::sanityCheck(std::size_t N, std::map<std::size_t, DocMatches>& mat
   }
 
   matches.clear();
-  // since we already know the size of the vectors, in order to parallelize the 
-  // query allocate the whole memory
   boost::progress_display display(database_.size());
-  
-  //#pragma omp parallel for default(none) shared(database_)
-  for(const auto &doc : database_)
+
+  #pragma omp parallel for
+  for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(database_.size()); ++i)
   {
+    SparseHistogramPerImage::const_iterator doc = database_.cbegin();
+    std::advance(doc, i);
+
     std::vector<DocMatch> m;
-    find(doc.second, N, m);
-    //		matches.emplace_back( m );
-    matches[doc.first] = m;
-    ++display;
+    find(doc->second, N, m);
+    #pragma omp critical
+    {
+      matches[doc->first] = m;
+      ++display;
+    }
   }
 }
 
@@ -114,12 +180,15 @@ void Database::find( const SparseHistogram& query, std::size_t N, std::vector<Do
   using bestN_tag = boost::accumulators::tag::tail<boost::accumulators::left>;
   boost::accumulators::accumulator_set<DocMatch, boost::accumulators::features<bestN_tag> > acc(bestN_tag::cache_size = N);
 
+  // flatten the query once, the scoring below only needs the (word, count) pairs
+  const DocumentVector flatQuery = flattenSparseHistogram(query);
+
   /// @todo Try only computing distances against documents sharing at least one word
-  for(const auto& document: database_)
+  for(const auto& document: flat_database_)
   {
-    // for each document/image in the database compute the distance between the 
+    // for each document/image in the database compute the distance between the
     // histograms of the query image and the others
-    float distance = sparseDistance(query, document.second, distanceMethod, word_weights_);
+    float distance = sparseDistance(flatQuery, document.second, distanceMethod, word_weights_);
     acc(DocMatch(document.first, distance));
   }
 
@@ -139,7 +208,8 @@ void Database::computeTfIdfWeights(float default_weight)
 {
   float N = (float) database_.size();
   std::size_t num_words = word_files_.size();
-  for(std::size_t i = 0; i < num_words; ++i)
+  #pragma omp parallel for
+  for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(num_words); ++i)
   {
     std::size_t Ni = word_files_[i].size();
     if(Ni != 0)
@@ -177,9 +247,125 @@ void Database::loadWeights(const std::string& file)
   }
 }
 
+void Database::save(const std::string& file) const
+{
+  std::ofstream out(file.c_str(), std::ios_base::binary);
+  if(!out.is_open())
+    throw std::runtime_error((boost::format("Unable to open the database file '%s' for writing") % file).str());
+
+  // vocabulary weights
+  const uint32_t num_words = word_weights_.size();
+  out.write((char*) (&num_words), sizeof (uint32_t));
+  out.write((char*) word_weights_.data(), num_words * sizeof (float));
+
+  // inverted files, flattened into a single entry array indexed by per-word offsets
+  std::vector<uint64_t> fileOffsets(num_words + 1, 0);
+  for(uint32_t i = 0; i < num_words; ++i)
+    fileOffsets[i + 1] = fileOffsets[i] + word_files_[i].size();
+  out.write((char*) fileOffsets.data(), fileOffsets.size() * sizeof (uint64_t));
+  for(uint32_t i = 0; i < num_words; ++i)
+    out.write((char*) word_files_[i].data(), word_files_[i].size() * sizeof (WordFrequency));
+
+  // documents: ids, per-document offsets into the word/count arrays, and the
+  // concatenated feature indices of every (document, word) entry
+  const uint32_t num_docs = database_.size();
+  std::vector<DocId> docIds;
+  std::vector<uint64_t> docOffsets;
+  std::vector<Word> docWords;
+  std::vector<uint32_t> docCounts;
+  std::vector<IndexT> features;
+  docIds.reserve(num_docs);
+  docOffsets.reserve(num_docs + 1);
+  docOffsets.push_back(0);
+  for(const auto& doc : database_)
+  {
+    docIds.push_back(doc.first);
+    for(const auto& word : doc.second)
+    {
+      docWords.push_back(word.first);
+      docCounts.push_back(word.second.size());
+      features.insert(features.end(), word.second.begin(), word.second.end());
+    }
+    docOffsets.push_back(docWords.size());
+  }
+  const uint64_t num_features = features.size();
+  out.write((char*) (&num_docs), sizeof (uint32_t));
+  out.write((char*) docIds.data(), docIds.size() * sizeof (DocId));
+  out.write((char*) docOffsets.data(), docOffsets.size() * sizeof (uint64_t));
+  out.write((char*) docWords.data(), docWords.size() * sizeof (Word));
+  out.write((char*) docCounts.data(), docCounts.size() * sizeof (uint32_t));
+  out.write((char*) (&num_features), sizeof (uint64_t));
+  out.write((char*) features.data(), features.size() * sizeof (IndexT));
+}
+
+void Database::load(const std::string& file)
+{
+  std::ifstream in;
+  in.exceptions(std::ifstream::eofbit | std::ifstream::failbit | std::ifstream::badbit);
+
+  try
+  {
+    in.open(file.c_str(), std::ios_base::binary);
+
+    // vocabulary weights
+    uint32_t num_words = 0;
+    in.read((char*) (&num_words), sizeof (uint32_t));
+    word_weights_.resize(num_words);
+    in.read((char*) word_weights_.data(), num_words * sizeof (float));
+
+    // inverted files: bulk-read the flat entry array, then slice it per word
+    std::vector<uint64_t> fileOffsets(num_words + 1);
+    in.read((char*) fileOffsets.data(), fileOffsets.size() * sizeof (uint64_t));
+    std::vector<WordFrequency> entries(fileOffsets[num_words]);
+    in.read((char*) entries.data(), entries.size() * sizeof (WordFrequency));
+    word_files_.assign(num_words, InvertedFile());
+    for(uint32_t i = 0; i < num_words; ++i)
+      word_files_[i].assign(entries.begin() + fileOffsets[i], entries.begin() + fileOffsets[i + 1]);
+
+    // documents
+    uint32_t num_docs = 0;
+    in.read((char*) (&num_docs), sizeof (uint32_t));
+    std::vector<DocId> docIds(num_docs);
+    in.read((char*) docIds.data(), docIds.size() * sizeof (DocId));
+    std::vector<uint64_t> docOffsets(num_docs + 1);
+    in.read((char*) docOffsets.data(), docOffsets.size() * sizeof (uint64_t));
+    std::vector<Word> docWords(docOffsets[num_docs]);
+    in.read((char*) docWords.data(), docWords.size() * sizeof (Word));
+    std::vector<uint32_t> docCounts(docOffsets[num_docs]);
+    in.read((char*) docCounts.data(), docCounts.size() * sizeof (uint32_t));
+    uint64_t num_features = 0;
+    in.read((char*) (&num_features), sizeof (uint64_t));
+    std::vector<IndexT> features(num_features);
+    in.read((char*) features.data(), features.size() * sizeof (IndexT));
+
+    database_.clear();
+    flat_database_.clear();
+    flat_database_.reserve(num_docs);
+    std::size_t featPos = 0;
+    for(uint32_t d = 0; d < num_docs; ++d)
+    {
+      SparseHistogram& histo = database_[docIds[d]];
+      DocumentVector flat;
+      flat.reserve(docOffsets[d + 1] - docOffsets[d]);
+      for(uint64_t w = docOffsets[d]; w < docOffsets[d + 1]; ++w)
+      {
+        histo[docWords[w]].assign(features.begin() + featPos, features.begin() + featPos + docCounts[w]);
+        featPos += docCounts[w];
+        flat.emplace_back(docWords[w], docCounts[w]);
+      }
+      // docIds come out of the map in increasing order, so the flat copy stays sorted
+      flat_database_.emplace_back(docIds[d], std::move(flat));
+    }
+  }
+  catch(std::ifstream::failure& e)
+  {
+    throw std::runtime_error((boost::format("Failed to load database file '%s'") % file).str());
+  }
+}
+
 ///**
 // * Normalize a document vector representing the histogram of visual words for a given image
-// * 
+// *
 // * @param[in/out] v the unnormalized histogram of visual words
 // */
 //void Database::normalize(SparseHistogram& v) const
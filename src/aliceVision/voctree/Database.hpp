@@ -12,6 +12,8 @@
 #include <map>
 #include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace aliceVision{
 namespace voctree{
@@ -75,6 +77,19 @@ public:
    */
   DocId insert(DocId doc_id, const SparseHistogram& document);
 
+  /**
+   * @brief Insert a whole corpus of documents at once.
+   *
+   * The inverted files are built sharded by word across the OpenMP threads and
+   * the flat copy used by find() is merged in a single pass, so a large batch
+   * avoids both the lock-free-unfriendly per-word appends and the per-document
+   * sorted insertion of insert(). Call computeTfIdfWeights() once afterwards.
+   *
+   * @param documents The (id, histogram) pairs to insert; the ids must be
+   * unique and not already present in the database.
+   */
+  void insertBatch(std::vector<std::pair<DocId, SparseHistogram>> documents);
+
   /**
    * @brief Perform a sanity check of the database by querying each document
    * of the database and finding its top N matches
@@ -123,9 +138,19 @@ public:
   /// Load the vocabulary word weights from a file.
   void loadWeights(const std::string& file);
 
-  // Save weights and documents
-  //void save(const std::string& file) const;
-  //void load(const std::string& file);
+  /**
+   * @brief Save the whole database (weights, inverted files and documents) to a file.
+   *
+   * The image is a set of flat offset-indexed arrays read back with a handful of bulk
+   * reads, so reopening a database is orders of magnitude faster than re-quantizing
+   * the descriptors of every document.
+   */
+  void save(const std::string& file) const;
+
+  /**
+   * @brief Load a database previously written by save(), replacing the current content.
+   */
+  void load(const std::string& file);
 
   const SparseHistogramPerImage& getSparseHistogramPerImage() const
   {
@@ -149,14 +174,15 @@ private:
   // Stored in increasing order by DocId
   typedef std::vector<WordFrequency> InvertedFile;
 
-  /// @todo Use sorted vector?
-  // typedef std::vector< std::pair<Word, float> > DocumentVector;
-  
   friend std::ostream& operator<<(std::ostream& os, const SparseHistogram& dv);
 
   std::vector<InvertedFile> word_files_;
   std::vector<float> word_weights_;
   SparseHistogramPerImage database_; // Precomputed for inserted documents
+  // Flattened copies of the inserted histograms, sorted by DocId: find() scores
+  // against these contiguous (word, count) vectors instead of the map-backed
+  // histograms above, which keeps the scoring loop cache-friendly
+  std::vector<std::pair<DocId, DocumentVector> > flat_database_;
 
   /**
    * Normalize a document vector representing the histogram of visual words for a given image
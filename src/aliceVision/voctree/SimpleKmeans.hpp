@@ -253,6 +253,22 @@ bool checkVectorElements(const std::vector<Feature, FeatureAllocator> &f, const
   return correct;
 }
 
+/**
+ * Mean of an accumulated sum cast back to the feature value type: integral
+ * descriptors (e.g. uint8 SIFT) are rounded instead of truncated.
+ */
+template<typename T>
+inline T centerMean(double sum, std::size_t count, std::true_type)
+{
+  return static_cast<T>(sum / count + 0.5);
+}
+
+template<typename T>
+inline T centerMean(double sum, std::size_t count, std::false_type)
+{
+  return static_cast<T>(sum / count);
+}
+
 /**
  * @brief Class for performing K-means clustering, optimized for a particular feature type and metric.
  *
@@ -304,6 +320,24 @@ public:
     restarts_ = restarts;
   }
 
+  std::size_t getMiniBatchSize() const
+  {
+    return mini_batch_size_;
+  }
+
+  /**
+   * @brief Set the number of features assigned per Lloyd iteration.
+   *
+   * With the default of 0 every feature is assigned in every iteration. A non-zero
+   * value updates the centers from a random subset of that size instead, which
+   * trades a small loss of clustering quality for much faster iterations on large
+   * inputs; a final full pass computes the membership of every feature.
+   */
+  void setMiniBatchSize(std::size_t size)
+  {
+    mini_batch_size_ = size;
+  }
+
   int getVerbose() const
   {
     return verbose_;
@@ -352,6 +386,7 @@ private:
   Initializer choose_centers_;
   std::size_t max_iterations_;
   std::size_t restarts_;
+  std::size_t mini_batch_size_;
   int verbose_;
 };
 
@@ -363,7 +398,8 @@ distance_(d),
 choose_centers_(InitKmeanspp()),
 max_iterations_(100),
 verbose_(verbose),
-restarts_(1)
+restarts_(1),
+mini_batch_size_(0)
 {
 }
 
@@ -417,72 +453,109 @@ SimpleKmeans<Feature, Distance, FeatureAllocator>::clusterOnce(const std::vector
                                                                std::vector<Feature, FeatureAllocator>& centers,
                                                                std::vector<unsigned int>& membership) const
 {
-  typedef typename std::vector<Feature, FeatureAllocator>::value_type centerType;
   typedef typename Distance::value_type feature_value_type;
 
+  const std::size_t dimension = zero_.size();
+
   std::vector<std::size_t> new_center_counts(k);
-  std::vector<Feature, FeatureAllocator> new_centers(k);
+  // The centers are accumulated in double so that integer descriptors
+  // (e.g. uint8 SIFT) are first-class: a Feature-typed accumulator would
+  // overflow on the sum and truncate on the division.
+  std::vector<std::vector<double> > new_center_sums(k, std::vector<double>(dimension, 0.0));
   squared_distance_type max_center_shift = std::numeric_limits<squared_distance_type>::max();
 
+  // When a mini-batch size is set, each iteration updates the centers from a
+  // random subset of the features instead of all of them
+  const bool useMiniBatch = (mini_batch_size_ > 0) && (mini_batch_size_ < features.size());
+  std::vector<std::size_t> batch;
+  if(useMiniBatch)
+  {
+    batch.resize(features.size());
+    std::iota(batch.begin(), batch.end(), 0);
+  }
+
   if(verbose_ > 0) ALICEVISION_LOG_DEBUG("Iterations");
   for(std::size_t iter = 0; iter < max_iterations_; ++iter)
   {
     if(verbose_ > 0) ALICEVISION_LOG_DEBUG("*");
     // Zero out new centers and counts
     std::fill(new_center_counts.begin(), new_center_counts.end(), 0);
-    //		for(std::size_t i = 0; i < k; checkElements(new_centers[i++], "bef"));
-    std::fill(new_centers.begin(), new_centers.end(), zero_);
-    //		for(std::size_t i = 0; i < k; checkElements(new_centers[i++], "aft"));
-    assert(checkVectorElements(new_centers, "newcenters init"));
+    for(std::size_t j = 0; j < k; ++j)
+      std::fill(new_center_sums[j].begin(), new_center_sums[j].end(), 0.0);
     bool is_stable = true;
 
-
-    // Assign data objects to current centers
-    #pragma omp parallel for shared( new_centers, new_center_counts, features, centers, membership)
-    for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(features.size()); ++i)
+    std::size_t batchSize = features.size();
+    if(useMiniBatch)
     {
-      squared_distance_type d_min = std::numeric_limits<squared_distance_type>::max();
-      unsigned int nearest = 0;
-      bool found = false;
+      // Draw the mini-batch as the head of a partial Fisher-Yates shuffle
+      batchSize = mini_batch_size_;
+      for(std::size_t i = 0; i < batchSize; ++i)
+        std::swap(batch[i], batch[i + rand() % (batch.size() - i)]);
+    }
 
-      // @todo if k is large, let's say k>100 use FLAAN to retrieve the 
-      // cluster center
+    // Assign data objects to current centers, accumulating the new centers
+    // per thread to avoid serializing on a shared accumulator
+    #pragma omp parallel shared(new_center_sums, new_center_counts, features, centers, membership, is_stable)
+    {
+      std::vector<std::vector<double> > local_center_sums(k, std::vector<double>(dimension, 0.0));
+      std::vector<std::size_t> local_center_counts(k, 0);
+      bool local_stable = true;
 
-      // Find the nearest cluster center to feature i
-      for(unsigned int j = 0; j < k; ++j)
+      #pragma omp for nowait
+      for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(batchSize); ++i)
       {
-        squared_distance_type distance = distance_(*features[i], centers[j]);
-        //		printf("\t\tdistance %f\n", (float)distance);
-        //		PrintFeat(*features[i] );
-        if(distance < d_min)
+        const std::size_t idx = useMiniBatch ? batch[i] : i;
+        squared_distance_type d_min = std::numeric_limits<squared_distance_type>::max();
+        unsigned int nearest = 0;
+        bool found = false;
+
+        // @todo if k is large, let's say k>100 use FLAAN to retrieve the
+        // cluster center
+
+        // Find the nearest cluster center to feature idx
+        for(unsigned int j = 0; j < k; ++j)
         {
-          d_min = distance;
-          nearest = j;
-          found = true;
+          squared_distance_type distance = distance_(*features[idx], centers[j]);
+          if(distance < d_min)
+          {
+            d_min = distance;
+            nearest = j;
+            found = true;
+          }
         }
-        //		 printf("\t distance %f %f\n", (double)distance, (double)d_min);
-      }
-      assert(found);
-      // Assign feature i to the cluster it is nearest to
-      if(membership[i] != nearest)
-      {
-        is_stable = false;
-        membership[i] = nearest;
-      }
-      // Accumulate the cluster center and its membership count
-      //	  printf("\t nearest %d\n", nearest);
-      //			checkElements(*features[i], "feat");
+        assert(found);
+        // Assign feature idx to the cluster it is nearest to
+        if(membership[idx] != nearest)
+        {
+          local_stable = false;
+          membership[idx] = nearest;
+        }
+        // Accumulate the cluster center and its membership count
+        const Feature& feature = *features[idx];
+        for(std::size_t d = 0; d < dimension; ++d)
+          local_center_sums[nearest][d] += feature[d];
+        ++local_center_counts[nearest];
+      }//for
+
+      // Merge the per-thread accumulators
       #pragma omp critical
       {
-        new_centers[nearest] += *features[i];
-        //			checkElements(new_centers[nearest], "sum");
-        //	  printf("\t new_centers[nearest] += *features[i];\n");
-        ++new_center_counts[nearest];
-        //	  printf("\taccumulate\n");
+        for(std::size_t j = 0; j < k; ++j)
+        {
+          if(local_center_counts[j] > 0)
+          {
+            for(std::size_t d = 0; d < dimension; ++d)
+              new_center_sums[j][d] += local_center_sums[j][d];
+            new_center_counts[j] += local_center_counts[j];
+          }
+        }
+        if(!local_stable)
+          is_stable = false;
       }
-    }//for
+    }
 
-    if(is_stable) break;
+    // membership only covers the whole input when every feature is assigned
+    if(is_stable && !useMiniBatch) break;
 
     if(iter > 0)
       max_center_shift = 0;
@@ -491,19 +564,20 @@ SimpleKmeans<Feature, Distance, FeatureAllocator>::clusterOnce(const std::vector
     {
       if(new_center_counts[i] > 0)
       {
-        //		  printf("%d - %d\n", i, new_center_counts[i] );
-        //		  PrintFeat(new_centers[i] );
-        //		checkElements(new_centers[i], "bef");
-        new_centers[i] = new_centers[i] / new_center_counts[i];
+        Feature new_center = zero_;
+        for(std::size_t d = 0; d < dimension; ++d)
+          new_center[d] = centerMean<feature_value_type>(new_center_sums[i][d], new_center_counts[i],
+                                                         std::is_integral<feature_value_type>());
 
-        squared_distance_type shift = distance_(new_centers[i], centers[i]);
+        squared_distance_type shift = distance_(new_center, centers[i]);
 
         max_center_shift = std::max(max_center_shift, shift);
 
-        centers[i] = new_centers[i];
-        //					centers[i] = new_centers[i] / new_center_counts[i];
-        //		checkElements(new_centers[i], "aft");
-        //		PrintFeat(centers[i] );
+        centers[i] = new_center;
+      }
+      else if(useMiniBatch)
+      {
+        // The cluster may simply not be represented in this batch, keep its center
       }
       else
       {
@@ -514,11 +588,33 @@ SimpleKmeans<Feature, Distance, FeatureAllocator>::clusterOnce(const std::vector
         ALICEVISION_LOG_DEBUG("Choosing a new center: " << index);
       }
     }
-    //			ALICEVISION_LOG_DEBUG("max_center_shift: " << max_center_shift);  
+    //			ALICEVISION_LOG_DEBUG("max_center_shift: " << max_center_shift);
     if(max_center_shift <= 10e-10) break;
   }
   if(verbose_ > 0) ALICEVISION_LOG_DEBUG("");
 
+  if(useMiniBatch)
+  {
+    // A mini-batch run only assigned the sampled features, compute the
+    // membership of every feature against the final centers
+    #pragma omp parallel for shared(features, centers, membership)
+    for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(features.size()); ++i)
+    {
+      squared_distance_type d_min = std::numeric_limits<squared_distance_type>::max();
+      unsigned int nearest = 0;
+      for(unsigned int j = 0; j < k; ++j)
+      {
+        squared_distance_type distance = distance_(*features[i], centers[j]);
+        if(distance < d_min)
+        {
+          d_min = distance;
+          nearest = j;
+        }
+      }
+      membership[i] = nearest;
+    }
+  }
+
   // Return the sum squared error
   /// @todo Kahan summation?
   squared_distance_type sse = squared_distance_type(0);
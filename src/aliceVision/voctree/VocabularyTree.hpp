@@ -37,6 +37,25 @@ typedef std::vector<Word> Document;
 typedef std::map<Word, std::vector<IndexT> > SparseHistogram;
 typedef std::map<DocId, SparseHistogram> SparseHistogramPerImage;
 
+/// Flattened view of a SparseHistogram: (word, count) pairs sorted by word,
+/// stored contiguously so that scoring a document is a linear scan
+typedef std::vector<std::pair<Word, uint32_t> > DocumentVector;
+
+/**
+ * Flatten a sparse histogram into its contiguous (word, count) representation
+ *
+ * @param[in] histogram the sparse histogram of visual words
+ * @return the flattened histogram, sorted by word
+ */
+inline DocumentVector flattenSparseHistogram(const SparseHistogram& histogram)
+{
+  DocumentVector flat;
+  flat.reserve(histogram.size());
+  for(const auto& word : histogram)
+    flat.emplace_back(word.first, static_cast<uint32_t>(word.second.size()));
+  return flat;
+}
+
 /**
  * Given a list of visual words associated to the features of a document it computes the 
  * vector of unique weighted visual words
@@ -343,6 +362,20 @@ void VocabularyTree<Feature, Distance, FeatureAllocator>::setNodeCounts()
  */
 float sparseDistance(const SparseHistogram& v1, const SparseHistogram& v2, const std::string &distanceMethod = "classic", const std::vector<float>& word_weights = std::vector<float>());
 
+/**
+ * @brief compute the sparse distance between two flattened histograms according to the chosen distance method.
+ *
+ * Same scores as the SparseHistogram overload, but the linear scan over contiguous
+ * (word, count) pairs avoids chasing map nodes; this is the inner loop of Database::find.
+ *
+ * @param v1 The first flattened histogram
+ * @param v2 The second flattened histogram
+ * @param distanceMethod distance method (norm L1, etc.)
+ * @param word_weights
+ * @return the distance of the two histograms
+ */
+float sparseDistance(const DocumentVector& v1, const DocumentVector& v2, const std::string &distanceMethod = "classic", const std::vector<float>& word_weights = std::vector<float>());
+
 inline std::unique_ptr<IVocabularyTree> createVoctreeForDescriberType(feature::EImageDescriberType imageDescriberType)
 {
   using namespace aliceVision::feature;
@@ -36,27 +36,36 @@ std::size_t populateDatabase(const sfmData::SfMData& sfmData,
   ALICEVISION_LOG_DEBUG("Reading the descriptors from " << descriptorsFiles.size() <<" files...");
   boost::progress_display display(descriptorsFiles.size());
 
+  std::vector<std::pair<DocId, SparseHistogram>> documents(descriptorsFiles.size());
+
+  #pragma omp parallel for
   // Run through the path vector and read the descriptors
-  for(const auto &currentFile : descriptorsFiles)
+  for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(descriptorsFiles.size()); ++i)
   {
-    
+    std::map<IndexT, std::string>::const_iterator currentFileIt = descriptorsFiles.cbegin();
+    std::advance(currentFileIt, i);
+
     std::vector<DescriptorT> descriptors;
 
     // Read the descriptors
-    loadDescsFromBinFile(currentFile.second, descriptors, false, Nmax);
-    size_t result = descriptors.size();
-    
-    SparseHistogram newDoc =  tree.quantizeToSparse(descriptors);
+    loadDescsFromBinFile(currentFileIt->second, descriptors, false, Nmax);
 
-    // Insert document in database
-    db.insert(currentFile.first, newDoc);
+    // quantize the descriptors, the database is filled in one batch below
+    documents[i] = std::make_pair(currentFileIt->first, tree.quantizeToSparse(descriptors));
 
-    // Update the overall counter
-    numDescriptors += result;
-    
-    ++display;
+    #pragma omp critical
+    {
+      // Update the overall counter
+      numDescriptors += descriptors.size();
+
+      ++display;
+    }
   }
 
+  // Insert the documents in one sharded batch; the idf weights are computed
+  // once by the caller through computeTfIdfWeights()
+  db.insertBatch(std::move(documents));
+
   // Return the result
   return numDescriptors;
 }
@@ -77,28 +86,39 @@ std::size_t populateDatabase(const sfmData::SfMData& sfmData,
   ALICEVISION_LOG_DEBUG("Reading the descriptors from " << descriptorsFiles.size() <<" files...");
   boost::progress_display display(descriptorsFiles.size());
 
+  std::vector<std::pair<DocId, SparseHistogram>> documents(descriptorsFiles.size());
+
+  #pragma omp parallel for
   // Run through the path vector and read the descriptors
-  for(const auto &currentFile : descriptorsFiles)
+  for(ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(descriptorsFiles.size()); ++i)
   {
+    std::map<IndexT, std::string>::const_iterator currentFileIt = descriptorsFiles.cbegin();
+    std::advance(currentFileIt, i);
+
     std::vector<DescriptorT> descriptors;
 
     // Read the descriptors
-    loadDescsFromBinFile(currentFile.second, descriptors, false, Nmax);
-    size_t result = descriptors.size();
-    
-    allDescriptors[currentFile.first] = descriptors;
-    
-    SparseHistogram newDoc = tree.quantizeToSparse(descriptors);
-    
-    // Insert document in database
-    db.insert(currentFile.first, newDoc);
+    loadDescsFromBinFile(currentFileIt->second, descriptors, false, Nmax);
+
+    // quantize the descriptors, the database is filled in one batch below
+    documents[i] = std::make_pair(currentFileIt->first, tree.quantizeToSparse(descriptors));
+    const std::size_t result = descriptors.size();
+
+    #pragma omp critical
+    {
+      allDescriptors[currentFileIt->first] = std::move(descriptors);
 
-    // Update the overall counter
-    numDescriptors += result;
+      // Update the overall counter
+      numDescriptors += result;
 
-    ++display;
+      ++display;
+    }
   }
 
+  // Insert the documents in one sharded batch; the idf weights are computed
+  // once by the caller through computeTfIdfWeights()
+  db.insertBatch(std::move(documents));
+
   // Return the result
   return numDescriptors;
 }
@@ -9,10 +9,21 @@
 #include <aliceVision/system/Logger.hpp>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
 
 namespace aliceVision {
 namespace voctree {
 
+namespace {
+
+// name of the per features folder file caching the descriptor count of every
+// .desc file, written after the first counting pass
+const char* descCountManifestFilename = "SIFT.descCounts.txt";
+
+}
+
 void getInfoBinFile(const std::string &path, int dim, std::size_t &numDescriptors, int &bytesPerElement)
 {
   std::fstream fs;
@@ -64,40 +75,34 @@ void getListOfDescriptorFiles(const sfmData::SfMData& sfmData, const std::vector
   if(sfmData.getViews().empty())
     throw std::runtime_error("Can't get list of descriptor files, no views found");
 
-  // explore the sfm_data container to get the files path
-  for(const auto& view : sfmData.getViews())
-  {
-    bool found = false;
+  // list the folders once: one directory listing per folder instead of one
+  // existence probe per (view, folder) pair; earlier folders take precedence
+  // like the per-file probing did
+  std::map<std::string, std::string> indexedFiles;
 
-    for(const std::string& featureFolder : featuresFolders)
+  const auto indexFolder = [&indexedFiles](const std::string& featureFolder)
+  {
+    if(!bfs::is_directory(featureFolder))
+      return;
+    for(bfs::directory_iterator it(featureFolder), end; it != end; ++it)
     {
-      // generate the equivalent .desc file path
-      const std::string filepath = bfs::path(bfs::path(featureFolder) / (std::to_string(view.first) + "." + feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT) + ".desc")).string();
-
-      if(bfs::exists(filepath))
-      {
-        descriptorsFiles[view.first] = filepath;
-        found = true;
-        break;
-      }
+      if(bfs::is_regular_file(it->status()))
+        indexedFiles.insert(std::make_pair(it->path().filename().string(), it->path().string()));
     }
+  };
 
-    if(found)
-      continue;
+  for(const std::string& featureFolder : featuresFolders)
+    indexFolder(featureFolder);
+  for(const std::string& featureFolder : sfmData.getFeaturesFolders())
+    indexFolder(featureFolder);
 
-    for(const std::string& featureFolder : sfmData.getFeaturesFolders())
-    {
-      const std::string filepath = bfs::path(bfs::path(featureFolder) / (std::to_string(view.first) + "." + feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT) + ".desc")).string();
-
-      if(bfs::exists(filepath))
-      {
-        descriptorsFiles[view.first] = filepath;
-        found = true;
-        break;
-      }
-    }
+  // explore the sfm_data container to get the files path
+  for(const auto& view : sfmData.getViews())
+  {
+    const std::string filename = std::to_string(view.first) + "." + feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT) + ".desc";
+    const auto it = indexedFiles.find(filename);
 
-    if(!found)
+    if(it == indexedFiles.end())
     {
       std::stringstream ss;
 
@@ -109,8 +114,53 @@ void getListOfDescriptorFiles(const sfmData::SfMData& sfmData, const std::vector
 
       throw std::runtime_error("Can't find descriptor of view " + std::to_string(view.first) + " in:\n" + ss.str());
     }
+
+    descriptorsFiles[view.first] = it->second;
+  }
+}
+
+void loadDescriptorCountManifests(const std::vector<std::string>& folders,
+                                  std::map<std::string, std::size_t>& descCountPerFile)
+{
+  namespace bfs = boost::filesystem;
+
+  for(const std::string& folder : folders)
+  {
+    std::ifstream fs(bfs::path(bfs::path(folder) / descCountManifestFilename).string());
+    if(!fs.is_open())
+      continue;
+
+    std::string filename;
+    std::size_t count;
+    while(fs >> filename >> count)
+      descCountPerFile.insert(std::make_pair(filename, count));
   }
 }
 
+void saveDescriptorCountManifest(const std::string& folder,
+                                 const std::map<std::string, std::size_t>& descCountPerFile)
+{
+  namespace bfs = boost::filesystem;
+  const std::string manifestPath = bfs::path(bfs::path(folder) / descCountManifestFilename).string();
+
+  // merge with the entries already on disk, the new counts take precedence
+  std::map<std::string, std::size_t> merged;
+  {
+    std::ifstream fs(manifestPath);
+    std::string filename;
+    std::size_t count;
+    while(fs >> filename >> count)
+      merged[filename] = count;
+  }
+  for(const auto& entry : descCountPerFile)
+    merged[entry.first] = entry.second;
+
+  std::ofstream fs(manifestPath, std::ios::trunc);
+  if(!fs.is_open())
+    return; // the folder is not writable, the cache is best effort
+  for(const auto& entry : merged)
+    fs << entry.first << " " << entry.second << "\n";
+}
+
 }
 }
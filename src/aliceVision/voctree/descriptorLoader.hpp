@@ -37,6 +37,26 @@ void getListOfDescriptorFiles(const sfmData::SfMData& sfmData,
                               const std::vector<std::string>& featuresFolders,
                               std::map<IndexT, std::string>& descriptorsFiles);
 
+/**
+ * @brief Load the per-folder manifests caching the number of descriptors of each
+ * .desc file, so repeat runs skip the per-file counting pass. Folders without a
+ * manifest are skipped, earlier folders take precedence.
+ * @param[in] folders The features folder(s) to look into
+ * @param[in,out] descCountPerFile A map of .desc filename to descriptor count
+ */
+void loadDescriptorCountManifests(const std::vector<std::string>& folders,
+                                  std::map<std::string, std::size_t>& descCountPerFile);
+
+/**
+ * @brief Write the descriptor count manifest of the given features folder,
+ * merging with the entries already on disk. The cache is best effort: nothing
+ * is written if the folder is not writable.
+ * @param[in] folder The features folder
+ * @param[in] descCountPerFile A map of .desc filename to descriptor count
+ */
+void saveDescriptorCountManifest(const std::string& folder,
+                                 const std::map<std::string, std::size_t>& descCountPerFile);
+
 /**
  * @brief Read a set of descriptors from a file containing the path to the descriptor files.
  * @param[in] sfmDataPath The input sfmData
@@ -52,6 +72,26 @@ std::size_t readDescFromFiles(const sfmData::SfMData& sfmData,
                          std::vector<DescriptorT>& descriptors,
                          std::vector<std::size_t>& numFeatures);
 
+/**
+ * @brief Read a bounded random sample of the descriptors of a dataset.
+ *
+ * The descriptor files are streamed one at a time and reservoir-sampled into the
+ * output vector, so the memory used is the sample size plus one file regardless
+ * of the dataset size. Every descriptor of the dataset has the same probability
+ * of ending up in the sample.
+ *
+ * @param[in] sfmData The input sfmData
+ * @param[in] featuresFolders The folder(s) containing the descriptor files (optional)
+ * @param[in] maxDescriptors The maximum number of descriptors to keep
+ * @param[out] descriptors the sampled descriptors, at most \p maxDescriptors of them
+ * @return the total number of descriptors seen in the dataset
+ */
+template<class DescriptorT, class FileDescriptorT>
+std::size_t readDescSampleFromFiles(const sfmData::SfMData& sfmData,
+                         const std::vector<std::string>& featuresFolders,
+                         std::size_t maxDescriptors,
+                         std::vector<DescriptorT>& descriptors);
+
 } // namespace voctree
 } // namespace aliceVision
 
@@ -6,6 +6,7 @@
 
 #include <aliceVision/feature/Descriptor.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
@@ -32,26 +33,62 @@ std::size_t readDescFromFiles(const sfmData::SfMData& sfmData,
   // of descriptors
   int bytesPerElement = 0;
 
-  // Display infos and progress bar
   ALICEVISION_LOG_DEBUG("Pre-computing the memory needed...");
-  boost::progress_display display(descriptorsFiles.size());
 
-  // Read all files and get the number of descriptors to load
+  // Load the per folder count caches, so repeat runs skip the per file pass
+  std::vector<std::string> manifestFolders = featuresFolders;
+  for(const std::string& folder : sfmData.getFeaturesFolders())
+    manifestFolders.push_back(folder);
+  std::map<std::string, std::size_t> cachedCounts;
+  loadDescriptorCountManifests(manifestFolders, cachedCounts);
+
+  // Flatten the file list for the parallel loop
+  std::vector<const std::string*> descFilepaths;
+  descFilepaths.reserve(descriptorsFiles.size());
   for(const auto &currentFile : descriptorsFiles)
+    descFilepaths.push_back(&currentFile.second);
+
+  // Read the leading files until one gives the number of bytes per descriptor
+  // element (we are assuming the features are all the same...); bytesPerElement
+  // could be 0 even after the first file (eg it has 0 descriptors...)
+  std::map<std::string, std::map<std::string, std::size_t>> newCountsPerFolder;
+  int firstEstimated = 0;
+  while(firstEstimated < static_cast<int>(descFilepaths.size()) && bytesPerElement == 0)
+  {
+    const std::string& filepath = *descFilepaths[firstEstimated];
+    std::size_t count = 0;
+    getInfoBinFile(filepath, DescriptorT::static_size, count, bytesPerElement);
+    numDescriptors += count;
+    newCountsPerFolder[bfs::path(filepath).parent_path().string()][bfs::path(filepath).filename().string()] = count;
+    ++firstEstimated;
+  }
+
+  // Count the remaining files in parallel: cached counts skip the filesystem
+  // entirely, the others are estimated from the file size without opening them
+  #pragma omp parallel for reduction(+:numDescriptors)
+  for(int i = firstEstimated; i < static_cast<int>(descFilepaths.size()); ++i)
   {
-    // if it is the first one read the number of descriptors and the type of data (we are assuming the the feat are all the same...)
-    // bytesPerElement could be 0 even after the first element (eg it has 0 descriptors...), so do it until we get the correct info
-    if(bytesPerElement == 0)
+    const std::string& filepath = *descFilepaths[i];
+    const std::string filename = bfs::path(filepath).filename().string();
+
+    const auto cachedIt = cachedCounts.find(filename);
+    if(cachedIt != cachedCounts.end())
     {
-      getInfoBinFile(currentFile.second, DescriptorT::static_size, numDescriptors, bytesPerElement);
+      numDescriptors += cachedIt->second;
     }
     else
     {
-      // get the file size in byte and estimate the number of features without opening the file
-      numDescriptors += (bfs::file_size(currentFile.second) / bytesPerElement) / DescriptorT::static_size;
+      const std::size_t count = (bfs::file_size(filepath) / bytesPerElement) / DescriptorT::static_size;
+      numDescriptors += count;
+      #pragma omp critical
+      newCountsPerFolder[bfs::path(filepath).parent_path().string()][filename] = count;
     }
-    ++display;
   }
+
+  // Cache the new counts so the next run skips the pass entirely (best effort)
+  for(const auto &folderCounts : newCountsPerFolder)
+    saveDescriptorCountManifest(folderCounts.first, folderCounts.second);
+
   ALICEVISION_LOG_DEBUG("Found " << numDescriptors << " descriptors overall, allocating memory...");
   if(bytesPerElement == 0)
   {
@@ -66,7 +103,7 @@ std::size_t readDescFromFiles(const sfmData::SfMData& sfmData,
 
   // Read the descriptors
   ALICEVISION_LOG_DEBUG("Reading the descriptors...");
-  display.restart(descriptorsFiles.size());
+  boost::progress_display display(descriptorsFiles.size());
 
   // Run through the path vector and read the descriptors
   for(const auto &currentFile : descriptorsFiles)
@@ -83,11 +120,60 @@ std::size_t readDescFromFiles(const sfmData::SfMData& sfmData,
 
     ++display;
   }
-  assert(numDescriptors == numDescriptorsCheck);
+  if(numDescriptors != numDescriptorsCheck)
+    ALICEVISION_LOG_WARNING("Read " << numDescriptors << " descriptors but the counting pass expected "
+                            << numDescriptorsCheck << " (stale descriptor count cache?)");
 
   // Return the result
   return numDescriptors;
 }
 
+template<class DescriptorT, class FileDescriptorT>
+std::size_t readDescSampleFromFiles(const sfmData::SfMData& sfmData,
+                         const std::vector<std::string>& featuresFolders,
+                         std::size_t maxDescriptors,
+                         std::vector<DescriptorT>& descriptors)
+{
+  assert(maxDescriptors > 0);
+  std::map<IndexT, std::string> descriptorsFiles;
+  getListOfDescriptorFiles(sfmData, featuresFolders, descriptorsFiles);
+
+  descriptors.clear();
+  descriptors.reserve(maxDescriptors);
+  std::size_t numDescriptors = 0;
+
+  ALICEVISION_LOG_DEBUG("Sampling at most " << maxDescriptors << " descriptors...");
+  boost::progress_display display(descriptorsFiles.size());
+
+  // Stream the files one at a time and reservoir-sample their descriptors:
+  // the n-th descriptor seen replaces a random element of the full reservoir
+  // with probability maxDescriptors / n
+  std::vector<DescriptorT> fileDescriptors;
+  for(const auto &currentFile : descriptorsFiles)
+  {
+    fileDescriptors.clear();
+    feature::loadDescsFromBinFile<DescriptorT, FileDescriptorT>(currentFile.second, fileDescriptors, false);
+
+    for(const DescriptorT &descriptor : fileDescriptors)
+    {
+      if(descriptors.size() < maxDescriptors)
+      {
+        descriptors.push_back(descriptor);
+      }
+      else
+      {
+        const std::size_t j = rand() % (numDescriptors + 1);
+        if(j < maxDescriptors)
+          descriptors[j] = descriptor;
+      }
+      ++numDescriptors;
+    }
+    ++display;
+  }
+  ALICEVISION_LOG_DEBUG("Kept " << descriptors.size() << " of the " << numDescriptors << " descriptors found");
+
+  return numDescriptors;
+}
+
 } // namespace voctree
 } // namespace aliceVision
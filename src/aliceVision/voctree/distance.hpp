@@ -6,19 +6,91 @@
 
 #pragma once
 
+#include <aliceVision/config.hpp>
+
 #include <stdint.h>
 //#include <iostream>
+#include <type_traits>
 #include <Eigen/Core>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
 namespace aliceVision {
 namespace voctree {
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+
+namespace optim_avx2{
+
+  // Squared euclidean distance between uint8 descriptors (AVX2 method).
+  // 16 components are processed per iteration: the uint8 values are widened
+  // to int16, and _mm256_madd_epi16 computes diff*diff pairs summed to int32.
+  inline double l2_avx2(const unsigned char* a, const unsigned char* b, std::size_t size)
+  {
+    __m256i cumSum = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for(; i + 16 <= size; i += 16)
+    {
+      const __m256i srcA = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+      const __m256i srcB = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      const __m256i diff = _mm256_sub_epi16(srcA, srcB);
+      cumSum = _mm256_add_epi32(cumSum, _mm256_madd_epi16(diff, diff));
+    }
+    //-- Horizontal sum of the 8 int32 lanes
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(cumSum), _mm256_extracti128_si256(cumSum, 1));
+    sum = _mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x55));
+    double result = static_cast<double>(_mm_cvtsi128_si32(sum));
+    //-- Process the last 0-15 values (not needed for standard descriptor lengths)
+    for(; i < size; ++i)
+    {
+      const double diff = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+      result += diff * diff;
+    }
+    return result;
+  }
+
+  // Squared euclidean distance between float descriptors (AVX2 method)
+  inline double l2_avx2(const float* a, const float* b, std::size_t size)
+  {
+    __m256 cumSum = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for(; i + 8 <= size; i += 8)
+    {
+      const __m256 srcA = _mm256_loadu_ps(a + i);
+      const __m256 srcB = _mm256_loadu_ps(b + i);
+      const __m256 diff = _mm256_sub_ps(srcA, srcB);
+      cumSum = _mm256_add_ps(cumSum, _mm256_mul_ps(diff, diff));
+    }
+    //-- Horizontal sum of the 8 lanes
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(cumSum), _mm256_extractf128_ps(cumSum, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    double result = static_cast<double>(_mm_cvtss_f32(sum));
+    //-- Process the last 0-7 values
+    for(; i < size; ++i)
+    {
+      const double diff = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+      result += diff * diff;
+    }
+    return result;
+  }
+
+} // namespace optim_avx2
+
+#endif // ALICEVISION_HAVE_AVX2
 
 /**
  * \brief Default implementation of L2 distance metric.
  *
  * Works with std::vector, boost::array, or more generally any container that has
  * a \c value_type typedef, \c size() and array-indexed element access.
+ *
+ * For contiguous uint8/float containers the distance is computed with AVX2 when
+ * available; this is the hot call of the vocabulary tree descent, executed once
+ * per child center and per level for every quantized descriptor.
  */
 template<class DescriptorA, class DescriptorB=DescriptorA>
 struct L2
@@ -27,6 +99,19 @@ struct L2
   typedef double result_type;
 
   result_type operator()(const DescriptorA& a, const DescriptorB& b) const
+  {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+    typedef typename DescriptorB::value_type value_type_b;
+    return compute(a, b, std::integral_constant<bool,
+        (std::is_same<value_type, unsigned char>::value && std::is_same<value_type_b, unsigned char>::value) ||
+        (std::is_same<value_type, float>::value && std::is_same<value_type_b, float>::value)>());
+#else
+    return computeGeneric(a, b);
+#endif
+  }
+
+private:
+  result_type computeGeneric(const DescriptorA& a, const DescriptorB& b) const
   {
     result_type result = result_type(0);
     for(std::size_t i = 0; i < a.size(); ++i)
@@ -36,6 +121,19 @@ struct L2
     }
     return result;
   }
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_AVX2)
+  // same element type on both sides, assume the usual contiguous storage
+  result_type compute(const DescriptorA& a, const DescriptorB& b, std::true_type) const
+  {
+    return optim_avx2::l2_avx2(&a[0], &b[0], a.size());
+  }
+
+  result_type compute(const DescriptorA& a, const DescriptorB& b, std::false_type) const
+  {
+    return computeGeneric(a, b);
+  }
+#endif // ALICEVISION_HAVE_AVX2
 };
 
 
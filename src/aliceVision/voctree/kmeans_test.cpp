@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/feature/Descriptor.hpp>
 #include <aliceVision/voctree/SimpleKmeans.hpp>
 
 #include <iostream>
@@ -205,6 +206,129 @@ BOOST_AUTO_TEST_CASE(kmeanSimple)
   }
 }
 
+BOOST_AUTO_TEST_CASE(kmeanUChar)
+{
+  using namespace aliceVision;
+
+  ALICEVISION_LOG_DEBUG("Testing kmeans on uint8 descriptors...");
+
+  const std::size_t DIMENSION = 8;
+  const std::size_t FEATURENUMBER = 500;
+
+  const std::size_t K = 10;
+
+  const unsigned char STEP = 25;
+
+  // uint8 descriptors as extracted by the default SIFT pipeline: the centers
+  // must be accumulated without overflow and rounded, not truncated
+  typedef feature::Descriptor<unsigned char, DIMENSION> FeatureUChar;
+  typedef std::vector<FeatureUChar> FeatureUCharVector;
+
+  std::default_random_engine generator;
+  std::uniform_int_distribution<int> noiseGen(-5, 5);
+
+  // generate k well separated clusters in the [0, 255] range
+  FeatureUCharVector features;
+  FeatureUCharVector centers;
+  std::vector<unsigned int> membership;
+  features.reserve(FEATURENUMBER * K);
+
+  for(std::size_t i = 0; i < K; ++i)
+  {
+    for(std::size_t j = 0; j < FEATURENUMBER; ++j)
+    {
+      FeatureUChar feature;
+      for(std::size_t d = 0; d < DIMENSION; ++d)
+        feature[d] = static_cast<unsigned char>(STEP * i + 10 + noiseGen(generator));
+      features.push_back(feature);
+    }
+  }
+
+  voctree::SimpleKmeans<FeatureUChar> kmeans(FeatureUChar(0));
+  kmeans.setVerbose(0);
+  kmeans.setRestarts(5);
+
+  kmeans.cluster(features, K, centers, membership);
+
+  BOOST_CHECK_EQUAL(membership.size(), features.size());
+
+  // every cluster center must stay near one of the generating values,
+  // a summation overflow would send it anywhere in the range
+  voctree::L2<FeatureUChar, FeatureUChar> distance;
+  for(std::size_t i = 0; i < K; ++i)
+  {
+    FeatureUChar gtCenter(static_cast<unsigned char>(STEP * i + 10));
+    double bestDist = std::numeric_limits<double>::max();
+    for(std::size_t j = 0; j < K; ++j)
+      bestDist = std::min(bestDist, distance(centers[j], gtCenter));
+    BOOST_CHECK_SMALL(bestDist, 4.0 * DIMENSION);
+  }
+
+  std::vector<unsigned int> h(K, 0);
+  for(std::size_t i = 0; i < membership.size(); ++i)
+  {
+    ++h[membership[i]];
+  }
+  for(std::size_t i = 0; i < h.size(); ++i)
+  {
+    BOOST_CHECK(h[i] > 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(kmeanMiniBatch)
+{
+  using namespace aliceVision;
+
+  ALICEVISION_LOG_DEBUG("Testing mini-batch kmeans...");
+
+  const std::size_t DIMENSION = 8;
+  const std::size_t FEATURENUMBER = 500;
+
+  const std::size_t K = 30;
+
+  const std::size_t STEP = 5 * K;
+
+  typedef Eigen::Matrix<float, 1, DIMENSION> FeatureFloat;
+  typedef std::vector<FeatureFloat, Eigen::aligned_allocator<FeatureFloat> > FeatureFloatVector;
+
+  // generate k clusters well far away, as in kmeanSimple
+  FeatureFloatVector features;
+  FeatureFloatVector centers;
+  std::vector<unsigned int> membership;
+  features.reserve(FEATURENUMBER * K);
+
+  for(std::size_t i = 0; i < K; ++i)
+  {
+    for(std::size_t j = 0; j < FEATURENUMBER; ++j)
+    {
+      features.push_back((FeatureFloat::Random(1, DIMENSION) + Eigen::MatrixXf::Constant(1, DIMENSION, STEP * i) - Eigen::MatrixXf::Constant(1, DIMENSION, STEP * (K - 1) / 2)) / ((STEP * (K - 1) / 2) * sqrt(DIMENSION)));
+    }
+  }
+
+  voctree::SimpleKmeans<FeatureFloat> kmeans(FeatureFloat::Zero());
+  kmeans.setVerbose(0);
+  kmeans.setRestarts(5);
+  // only assign a quarter of the features per iteration
+  kmeans.setMiniBatchSize(features.size() / 4);
+
+  kmeans.cluster(features, K, centers, membership);
+
+  BOOST_CHECK(voctree::checkVectorElements(centers, "miniBatch"));
+
+  // the final full pass must assign a membership to every feature,
+  // and on well separated clusters no cluster should end up empty
+  BOOST_CHECK_EQUAL(membership.size(), features.size());
+  std::vector<unsigned int> h(K, 0);
+  for(std::size_t i = 0; i < membership.size(); ++i)
+  {
+    ++h[membership[i]];
+  }
+  for(std::size_t i = 0; i < h.size(); ++i)
+  {
+    BOOST_CHECK(h[i] > 0);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(kmeanVarying)
 {
   using namespace aliceVision;
@@ -57,3 +57,56 @@ BOOST_AUTO_TEST_CASE(database)
     BOOST_CHECK_SMALL(static_cast<double>(match[0].score), 0.001);
   }
 }
+
+// A batch insertion must build the same database as per-document insertions
+BOOST_AUTO_TEST_CASE(databaseBatchInsert)
+{
+  const int cardDocuments = 10;
+  const int cardWords = 12;
+
+  // Create a documents vector
+  vector<vector<Word>> documentsToInsert;
+  documentsToInsert.resize(cardDocuments);
+  for(int i = 0; i < documentsToInsert.size(); ++i)
+  {
+    documentsToInsert[i].resize(cardWords);
+    for(int j = 0; j < cardWords; ++j)
+    {
+      documentsToInsert[i][j] = cardWords * i + j;
+    }
+  }
+
+  // Fill one database with insert(), the other with insertBatch()
+  const uint32_t numWords = documentsToInsert.size() * documentsToInsert[0].size();
+  Database dbRef(numWords);
+  Database dbBatch(numWords);
+  vector<pair<DocId, SparseHistogram>> batch;
+  for(int i = 0; i < documentsToInsert.size(); ++i)
+  {
+    SparseHistogram histo;
+    computeSparseHistogram(documentsToInsert[i], histo);
+    dbRef.insert(i, histo);
+    batch.emplace_back(i, histo);
+  }
+  dbBatch.insertBatch(batch);
+
+  // Compute weights
+  dbRef.computeTfIdfWeights();
+  dbBatch.computeTfIdfWeights();
+
+  BOOST_CHECK_EQUAL(dbRef.size(), dbBatch.size());
+  BOOST_CHECK(dbRef.getSparseHistogramPerImage() == dbBatch.getSparseHistogramPerImage());
+
+  // Both databases must return the same matches with the same scores
+  for(int i = 0; i < documentsToInsert.size(); i++)
+  {
+    vector<DocMatch> matchesRef, matchesBatch;
+    dbRef.find(documentsToInsert[i], cardDocuments, matchesRef, "classic");
+    dbBatch.find(documentsToInsert[i], cardDocuments, matchesBatch, "classic");
+    BOOST_CHECK_EQUAL(matchesRef.size(), matchesBatch.size());
+    for(std::size_t m = 0; m < matchesRef.size(); ++m)
+    {
+      BOOST_CHECK(matchesRef[m] == matchesBatch[m]);
+    }
+  }
+}
@@ -93,6 +93,10 @@ int main(int argc, char** argv)
   if(!fs::is_directory(outputFolder))
     fs::create_directory(outputFolder);
 
+  // check all inputs and compute the output filenames upfront,
+  // so a large batch fails fast instead of after hours of conversion
+  std::vector<std::string> outputPaths;
+  outputPaths.reserve(imagePaths.size());
   for(const std::string& path : imagePaths)
   {
     // check input path
@@ -111,32 +115,36 @@ int main(int argc, char** argv)
       return EXIT_FAILURE;
     }
 
+    outputPaths.push_back(outputPath);
+  }
+
+  // convert the frames in parallel, each thread decodes (the demosaic runs
+  // inside the RAW decode), then encodes its own frame: the memory bound is
+  // one frame per thread, the dynamic schedule absorbs uneven file sizes
+  bool succeed = true;
+
+#pragma omp parallel for schedule(dynamic)
+  for(int i = 0; i < static_cast<int>(imagePaths.size()); ++i)
+  {
     // read input image
     // only read the 3 first channels
     image::Image<image::RGBColor> image;
 
     try
     {
-      image::readImage(path, image);
+      image::readImage(imagePaths.at(i), image);
+      image::writeImage(outputPaths.at(i), image);
     }
     catch(std::exception& e)
     {
       ALICEVISION_LOG_ERROR(std::string("Error: ") + e.what());
-      return EXIT_FAILURE;
-    }
 
-    // write output image
-    try
-    {
-      image::writeImage(outputPath, image);
-    }
-    catch(std::exception& e)
-    {
-      ALICEVISION_LOG_ERROR(std::string("Error: ") + e.what());
-      return EXIT_FAILURE;
+#pragma omp critical
+      succeed = false;
     }
   }
-  return EXIT_SUCCESS;
+
+  return succeed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 
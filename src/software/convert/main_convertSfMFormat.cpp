@@ -17,6 +17,8 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
@@ -131,9 +133,20 @@ int main(int argc, char **argv)
 
   flags = (flags) ? flags : sfmDataIO::ALL;
 
+  // only load the sections needed for the output, so that a conversion
+  // restricted to some sections never materializes the others
+  int loadFlags = flags;
+  if(!imageWhiteList.empty())
+  {
+    // the white list filter needs the views and the landmark visibilities
+    loadFlags |= sfmDataIO::VIEWS;
+    if(flags & sfmDataIO::STRUCTURE)
+      loadFlags |= sfmDataIO::OBSERVATIONS;
+  }
+
   // load input SfMData scene
   sfmData::SfMData sfmData;
-  if(!sfmDataIO::Load(sfmData, sfmDataFilename, sfmDataIO::ESfMData::ALL))
+  if(!sfmDataIO::Load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(loadFlags)))
   {
     ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read");
     return EXIT_FAILURE;
@@ -146,17 +159,19 @@ int main(int argc, char **argv)
     std::vector<IndexT> posesToRemove;
     std::vector<IndexT> landmarksToRemove;
 
+    // hash lookup of the white list entries (uids and image path stems)
+    std::unordered_set<std::string> whiteListLookup;
+    for(const std::string& imageId : imageWhiteList)
+    {
+      whiteListLookup.insert(imageId);
+      whiteListLookup.insert(fs::path(imageId).stem().string());
+    }
+
     for(const auto& viewPair : sfmData.getViews())
     {
       const sfmData::View& view = *(viewPair.second);
-      bool toRemove = true;
-
-      for(const std::string& imageId : imageWhiteList)
-      {
-        if(fs::path(imageId).stem() == fs::path(view.getImagePath()).stem() ||
-           imageId == std::to_string(view.getViewId()))
-          toRemove = false;
-      }
+      const bool toRemove = !whiteListLookup.count(fs::path(view.getImagePath()).stem().string()) &&
+                            !whiteListLookup.count(std::to_string(view.getViewId()));
 
       if(toRemove)
       {
@@ -166,14 +181,21 @@ int main(int argc, char **argv)
       }
     }
 
+    const std::unordered_set<IndexT> removedViewIds(viewsToRemove.begin(), viewsToRemove.end());
+
     for(auto& landmarkPair : sfmData.getLandmarks())
     {
       sfmData::Landmark& landmark = landmarkPair.second;
-      for(const IndexT viewId : viewsToRemove)
+      std::vector<IndexT> observationsToRemove;
+
+      for(const auto& obsPair : landmark.observations)
       {
-        if(landmark.observations.find(viewId) != landmark.observations.end())
-          landmark.observations.erase(viewId);
+        if(removedViewIds.count(obsPair.first))
+          observationsToRemove.push_back(obsPair.first);
       }
+      for(const IndexT viewId : observationsToRemove)
+        landmark.observations.erase(viewId);
+
       if(landmark.observations.empty())
         landmarksToRemove.push_back(landmarkPair.first);
     }
@@ -8,6 +8,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/camera/cameraUndistortImage.hpp>
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
@@ -18,6 +19,8 @@
 #include <cmath>
 #include <iterator>
 #include <iomanip>
+#include <map>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
@@ -102,15 +105,34 @@ bool exportToMVE2Format(
     out << "drews 1.0\n";  // MVE expects this header
     out << cameraCount << " " << featureCount << "\n";
 
+    // precompute the undistortion maps, one per intrinsic, shared across all
+    // the views of the same camera
+    std::map<IndexT, UndistortionMap> undistortionMaps;
+    for(const auto& intrinsicPair : sfm_data.getIntrinsics())
+    {
+      const IntrinsicBase* intrinsic = intrinsicPair.second.get();
+      if(intrinsic->isValid() && intrinsic->have_disto())
+        undistortionMaps[intrinsicPair.first].compute(intrinsic, intrinsic->w(), intrinsic->h());
+    }
+
+    // per-view image export work, deferred to a parallel pass after the
+    // sequential bundle / meta.ini writes
+    struct ViewImageTask
+    {
+      std::string srcImage;
+      std::string dstImage;
+      std::string dstThumbnailImage;
+      IndexT intrinsicId;
+      const IntrinsicBase* cam;
+    };
+    std::vector<ViewImageTask> viewImageTasks;
+
     // Export (calibrated) views as undistorted images
-    boost::progress_display my_progress_bar(sfm_data.getViews().size());
-    std::pair<int,int> w_h_image_size;
-    Image<RGBColor> image, image_ud, thumbnail;
     std::string sOutViewIteratorDirectory;
     std::size_t view_index = 0;
     std::map<std::size_t, IndexT> viewIdToviewIndex;
     for(Views::const_iterator iter = sfm_data.getViews().begin();
-      iter != sfm_data.getViews().end(); ++iter, ++my_progress_bar)
+      iter != sfm_data.getViews().end(); ++iter)
     {
       const View * view = iter->second.get();
 
@@ -135,27 +157,6 @@ bool exportToMVE2Format(
 
       Intrinsics::const_iterator iterIntrinsic = sfm_data.getIntrinsics().find(view->getIntrinsicId());
       const IntrinsicBase * cam = iterIntrinsic->second.get();
-      if (cam->isValid() && cam->have_disto())
-      {
-        // Undistort and save the image
-        readImage(srcImage, image);
-        UndistortImage(image, cam, image_ud, BLACK);
-        writeImage(dstImage, image_ud);
-      }
-      else // (no distortion)
-      {
-        // If extensions match, copy the PNG image
-        if (fs::extension(srcImage) == ".PNG" ||
-          fs::extension(srcImage) == ".png")
-        {
-          fs::copy_file(srcImage, dstImage);
-        }
-        else
-        {
-          readImage( srcImage, image);
-          writeImage( dstImage, image);
-        }
-      }
 
       // Prepare to write an MVE 'meta.ini' file for the current view
       const Pose3 pose = sfm_data.getPose(*view).getTransform();
@@ -203,14 +204,53 @@ bool exportToMVE2Format(
         << rotation(2, 0) << " " << rotation(2, 1) << " " << rotation(2, 2) << "\n"
         << translation[0] << " " << translation[1] << " " << translation[2] << "\n";
 
-      // Save a thumbnail image "thumbnail.png", 50x50 pixels
-      thumbnail = create_thumbnail(image, 50, 50);
+      // The image and the thumbnail are written by the parallel pass below
       const std::string dstThumbnailImage = (fs::path(sOutViewIteratorDirectory) / "thumbnail.png").string();
-      writeImage(dstThumbnailImage, thumbnail);
-      
+      viewImageTasks.push_back({srcImage, dstImage, dstThumbnailImage, view->getIntrinsicId(), cam});
+
       ++view_index;
     }
 
+    // Undistort and write the images and their thumbnails, one view per
+    // iteration so that decode, remap and encode of different views overlap
+    boost::progress_display my_progress_bar(viewImageTasks.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < static_cast<int>(viewImageTasks.size()); ++i)
+    {
+      const ViewImageTask& task = viewImageTasks.at(i);
+      Image<RGBColor> image, image_ud, thumbnail;
+
+      readImage(task.srcImage, image);
+
+      if (task.cam->isValid() && task.cam->have_disto())
+      {
+        // Undistort the image through the shared per-intrinsic map and save it
+        UndistortImage(image, undistortionMaps.at(task.intrinsicId), image_ud, BLACK);
+        writeImage(task.dstImage, image_ud);
+      }
+      else // (no distortion)
+      {
+        // If extensions match, copy the PNG image
+        if (fs::extension(task.srcImage) == ".PNG" ||
+          fs::extension(task.srcImage) == ".png")
+        {
+          fs::copy_file(task.srcImage, task.dstImage);
+        }
+        else
+        {
+          writeImage(task.dstImage, image);
+        }
+      }
+
+      // Save a thumbnail image "thumbnail.png", 50x50 pixels
+      thumbnail = create_thumbnail(image, 50, 50);
+      writeImage(task.dstThumbnailImage, thumbnail);
+
+      #pragma omp critical
+      ++my_progress_bar;
+    }
+
     // For each feature, write to bundle:  position XYZ[0-3], color RGB[0-2], all ref.view_id & ref.feature_id
     // The following method is adapted from Simon Fuhrmann's MVE project:
     // https://github.com/simonfuhrmann/mve/blob/e3db7bc60ce93fe51702ba77ef480e151f927c23/libs/mve/bundle_io.cc
@@ -13,6 +13,7 @@
 #include <aliceVision/matching/io.hpp>
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/feature/svgVisualization.hpp>
+#include <aliceVision/system/AsyncReportWriter.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/cmdline.hpp>
 
@@ -84,6 +85,7 @@ int main(int argc, char ** argv)
   // user optional parameters
 
   std::string describerTypesName = EImageDescriberType_enumToString(EImageDescriberType::SIFT);
+  std::size_t maxMatchesPerPair = 1000;
 
   po::options_description allParams("AliceVision exportMatches");
 
@@ -101,7 +103,9 @@ int main(int argc, char ** argv)
   po::options_description optionalParams("Optional parameters");
   optionalParams.add_options()
     ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),
-      EImageDescriberType_informations().c_str());
+      EImageDescriberType_informations().c_str())
+    ("maxMatchesPerPair", po::value<std::size_t>(&maxMatchesPerPair)->default_value(maxMatchesPerPair),
+      "Maximum number of matches drawn per pair (uniformly sampled above this, 0 means no limit).");
 
   po::options_description logParams("Log parameters");
   logParams.add_options()
@@ -180,6 +184,8 @@ int main(int argc, char ** argv)
 
   fs::create_directory(outputFolder);
   ALICEVISION_LOG_INFO("Export pairwise matches");
+  // write the svg files from a background thread so the drawing loop never waits on disk
+  system::AsyncReportWriter reportWriter;
   const PairSet pairs = matching::getImagePairs(pairwiseMatches);
   boost::progress_display myProgressBar(pairs.size());
   for (PairSet::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter, ++myProgressBar)
@@ -212,8 +218,10 @@ int main(int argc, char ** argv)
     {
       const feature::EImageDescriberType descType = matchesIt.first;
       assert(descType != feature::EImageDescriberType::UNINITIALIZED);
-      const matching::IndMatches& matches = matchesIt.second;
-      ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(matchesIt.first) << ": " << matches.size() << " matches");
+      const matching::IndMatches matches = feature::sampleMatches(matchesIt.second, maxMatchesPerPair);
+      ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(matchesIt.first) << ": " << matchesIt.second.size()
+                           << " matches" << (matches.size() < matchesIt.second.size() ?
+                           " (" + std::to_string(matches.size()) + " drawn)" : ""));
 
       const PointFeatures& featuresI = featuresPerView.getFeatures(viewI->getViewId(), descType);
       const PointFeatures& featuresJ = featuresPerView.getFeatures(viewJ->getViewId(), descType);
@@ -247,9 +255,14 @@ int main(int argc, char ** argv)
     }
 
     fs::path outputFilename = fs::path(outputFolder) / std::string(std::to_string(iter->first) + "_" + std::to_string(iter->second) + "_" + std::to_string(filteredMatches.getNbAllMatches()) + ".svg");
-    std::ofstream svgFile(outputFilename.string());
-    svgFile << svgStream.closeSvgFile().str();
-    svgFile.close();
+    reportWriter.write(outputFilename.string(), svgStream.closeSvgFile().str());
+  }
+
+  reportWriter.flush();
+  if(reportWriter.nbFailures() > 0)
+  {
+    ALICEVISION_LOG_ERROR("Cannot write " << reportWriter.nbFailures() << " svg file(s) into '" << outputFolder << "'.");
+    return EXIT_FAILURE;
   }
   return EXIT_SUCCESS;
 }
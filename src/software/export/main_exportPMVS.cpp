@@ -8,6 +8,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/camera/cameraUndistortImage.hpp>
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
@@ -18,6 +19,8 @@
 #include <cmath>
 #include <iterator>
 #include <iomanip>
+#include <map>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
@@ -96,28 +99,46 @@ bool exportToPMVSFormat(
       file.close();
     }
 
-    // Export (calibrated) views as undistorted images
-    Image<RGBColor> image, image_ud;
+    // precompute the undistortion maps, one per intrinsic, shared across all
+    // the views of the same camera
+    std::map<IndexT, UndistortionMap> undistortionMaps;
+    for(const auto& intrinsicPair : sfm_data.getIntrinsics())
+    {
+      const IntrinsicBase* intrinsic = intrinsicPair.second.get();
+      if(intrinsic->isValid() && intrinsic->have_disto())
+        undistortionMaps[intrinsicPair.first].compute(intrinsic, intrinsic->w(), intrinsic->h());
+    }
+
+    // gather the valid views, the image exports are independent
+    std::vector<const View*> viewsToExport;
     for(Views::const_iterator iter = sfm_data.getViews().begin();
-      iter != sfm_data.getViews().end(); ++iter, ++my_progress_bar)
+      iter != sfm_data.getViews().end(); ++iter)
     {
-      const View * view = iter->second.get();
-      if (!sfm_data.isPoseAndIntrinsicDefined(view))
-        continue;
+      if (sfm_data.isPoseAndIntrinsicDefined(iter->second.get()))
+        viewsToExport.push_back(iter->second.get());
+    }
+
+    // Export (calibrated) views as undistorted images, one view per iteration
+    // so that decode, remap and encode of different views overlap
+    #pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < static_cast<int>(viewsToExport.size()); ++i)
+    {
+      const View * view = viewsToExport.at(i);
+      Image<RGBColor> image, image_ud;
 
       Intrinsics::const_iterator iterIntrinsic = sfm_data.getIntrinsics().find(view->getIntrinsicId());
 
       // We have a valid view with a corresponding camera & pose
       const std::string srcImage = view->getImagePath();
       std::ostringstream os;
-      os << std::setw(8) << std::setfill('0') << map_viewIdToContiguous[view->getViewId()];
+      os << std::setw(8) << std::setfill('0') << map_viewIdToContiguous.at(view->getViewId());
       const std::string dstImage = (fs::path(sOutDirectory) / std::string("visualize") / (os.str() + ".jpg")).string();
       const IntrinsicBase * cam = iterIntrinsic->second.get();
       if (cam->isValid() && cam->have_disto())
       {
-        // undistort the image and save it
+        // undistort the image through the shared per-intrinsic map and save it
         readImage( srcImage, image);
-        UndistortImage(image, cam, image_ud, BLACK);
+        UndistortImage(image, undistortionMaps.at(view->getIntrinsicId()), image_ud, BLACK);
         writeImage(dstImage, image_ud);
       }
       else // (no distortion)
@@ -134,6 +155,9 @@ bool exportToPMVSFormat(
           writeImage(dstImage, image);
         }
       }
+
+      #pragma omp critical
+      ++my_progress_bar;
     }
 
     //pmvs_options.txt
@@ -64,6 +64,7 @@ int main(int argc, char** argv)
   std::size_t minInputFrames = 10;
   double squareSize = 1.0;
   double maxTotalAvgErr = 0.1;
+  std::size_t detectionDownscale = 2;
 
 
   po::options_description desc("\n\nThis program is used to calibrate a camera from a dataset of images.\n");
@@ -98,6 +99,10 @@ int main(int argc, char** argv)
            "Minimal number of frames to limit the refinement loop.\n")
           ("maxTotalAvgErr,e", po::value<double>(&maxTotalAvgErr)->default_value(maxTotalAvgErr),
            "Max Total Average Error.\n")
+          ("detectionDownscale", po::value<std::size_t>(&detectionDownscale)->default_value(detectionDownscale),
+           "Downscale factor of the detection prefilter pass: frames are rejected on "
+           "a downscaled image and the full resolution detection only runs on hits. "
+           "1 disables the prefilter.\n")
           ("debugRejectedImgFolder", po::value<std::string>(&debugRejectedImgFolder)->default_value(""),
            "Folder to export delete images during the refinement loop.\n")
           ("debugSelectedImgFolder,d", po::value<std::string>(&debugSelectedImgFolder)->default_value(""),
@@ -193,6 +198,50 @@ int main(int argc, char** argv)
   aliceVision::system::Timer duration;
   
   std::size_t currentFrame = 0;
+
+  // Frames are read serially (the feed is stateful) and detected by batches:
+  // each batch is spread over the threads and its results are appended in the
+  // frame order, so the downstream best images selection sees the same stream.
+  const std::size_t detectionBatchSize = 64;
+  std::vector<cv::Mat> batchImages;
+  std::vector<std::size_t> batchFrames;
+  batchImages.reserve(detectionBatchSize);
+  batchFrames.reserve(detectionBatchSize);
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
+  // the CCTag detection pipeline is stateful, keep it on a single thread
+  const bool serialDetection = (patternType == aliceVision::calibration::Pattern::ASYMMETRIC_CCTAG_GRID);
+#else
+  const bool serialDetection = false;
+#endif
+
+  auto detectBatch = [&]()
+  {
+    std::vector<char> found(batchImages.size(), 0);
+    std::vector<std::vector<cv::Point2f> > pointbufPerImage(batchImages.size());
+    std::vector<std::vector<int> > detectedIdPerImage(batchImages.size());
+
+    #pragma omp parallel for schedule(dynamic) if(!serialDetection)
+    for (int i = 0; i < static_cast<int>(batchImages.size()); ++i)
+    {
+      // Find the chosen pattern in images
+      found[i] = aliceVision::calibration::findPattern(patternType, batchImages[i], boardSize, detectionDownscale,
+                                                       detectedIdPerImage[i], pointbufPerImage[i]);
+    }
+
+    for (std::size_t i = 0; i < batchImages.size(); ++i)
+    {
+      if (found[i])
+      {
+        validFrames.push_back(batchFrames[i]);
+        detectedIdPerFrame.push_back(detectedIdPerImage[i]);
+        imagePoints.push_back(pointbufPerImage[i]);
+      }
+    }
+    batchImages.clear();
+    batchFrames.clear();
+  };
+
   while (feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
   {
     cv::Mat viewGray;
@@ -215,24 +264,18 @@ int main(int argc, char** argv)
       throw std::runtime_error(std::string("You cannot mix multiple image resolutions during the camera calibration. See image file: ") + currentImgName);
     }
 
-    std::vector<cv::Point2f> pointbuf;
-    std::vector<int> detectedId;
     ALICEVISION_CERR("[" << currentFrame << "/" << nbFrames << "] (" << iInputFrame << "/" << nbFramesToProcess << ")");
 
-    // Find the chosen pattern in images
-    const bool found = aliceVision::calibration::findPattern(patternType, viewGray, boardSize, detectedId, pointbuf);
-    
-    if (found)
-    {
-      validFrames.push_back(currentFrame);
-      detectedIdPerFrame.push_back(detectedId);
-      imagePoints.push_back(pointbuf);
-    }
+    batchImages.push_back(viewGray);
+    batchFrames.push_back(currentFrame);
+    if (batchImages.size() == detectionBatchSize)
+      detectBatch();
 
     ++iInputFrame;
     currentFrame = std::floor(iInputFrame * step);
     feed.goToFrame(currentFrame);
   }
+  detectBatch();
 
   
   ALICEVISION_CERR("find points duration: " << aliceVision::system::prettyTime(duration.elapsedMs()));
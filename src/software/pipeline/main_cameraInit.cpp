@@ -8,7 +8,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
 #include <aliceVision/sfmDataIO/viewIO.hpp>
-#include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/Database.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/cmdline.hpp>
 
@@ -299,10 +299,10 @@ int main(int argc, char **argv)
   }
 
   // check sensor database
-  std::vector<sensorDB::Datasheet> sensorDatabase;
+  sensorDB::Database sensorDatabase;
   if(!sensorDatabasePath.empty())
   {
-    if(!sensorDB::parseDatabase(sensorDatabasePath, sensorDatabase))
+    if(!sensorDatabase.load(sensorDatabasePath))
     {
       ALICEVISION_LOG_ERROR("Invalid input database '" << sensorDatabasePath << "', please specify a valid file.");
       return EXIT_FAILURE;
@@ -338,7 +338,8 @@ int main(int argc, char **argv)
     {
       std::vector<sfmData::View> incompleteViews(imagePaths.size());
 
-      #pragma omp parallel for
+      // dynamic scheduling, the metadata reads are I/O bound
+      #pragma omp parallel for schedule(dynamic)
       for(int i = 0; i < incompleteViews.size(); ++i)
       {
         sfmData::View& view = incompleteViews.at(i);
@@ -360,12 +361,20 @@ int main(int argc, char **argv)
   }
 
   // create missing intrinsics
-  auto viewPairItBegin = sfmData.getViews().begin();
-
-  #pragma omp parallel for
-  for(int i = 0; i < sfmData.getViews().size(); ++i)
+  // gather the view pointers upfront, advancing the views map iterator
+  // inside the parallel loop would be quadratic
+  std::vector<sfmData::View*> viewPtrs;
+  viewPtrs.reserve(sfmData.getViews().size());
+  for(const auto& viewPair : sfmData.getViews())
+    viewPtrs.push_back(viewPair.second.get());
+
+  // intrinsic created by each view, merged in the SfMData after the loop
+  std::vector<std::pair<IndexT, std::shared_ptr<camera::IntrinsicBase>>> createdIntrinsics(viewPtrs.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for(int i = 0; i < viewPtrs.size(); ++i)
   {
-    sfmData::View& view = *(std::next(viewPairItBegin,i)->second);
+    sfmData::View& view = *(viewPtrs.at(i));
 
     // try to detect rig structure in the input folder
     const fs::path parentPath = fs::path(view.getImagePath()).parent_path();
@@ -417,7 +426,7 @@ int main(int argc, char **argv)
           // intrinsic px focal length is undefined
           // check if it is because the sensor is not in the database
           sensorDB::Datasheet datasheet;
-          if(hasCameraMetadata && !getInfo(make, model, sensorDatabase, datasheet))
+          if(hasCameraMetadata && !sensorDatabase.getInfo(make, model, datasheet))
           {
             #pragma omp critical
             unknownSensors.emplace(std::make_pair(make, model), view.getImagePath()); // will throw an error message
@@ -434,7 +443,7 @@ int main(int argc, char **argv)
       if(hasCameraMetadata)
       {
         sensorDB::Datasheet datasheet;
-        if(sensorDB::getInfo(make, model, sensorDatabase, datasheet))
+        if(sensorDatabase.getInfo(make, model, datasheet))
         {
           // sensor is in the database
           ALICEVISION_LOG_DEBUG("Sensor width found in database: " << std::endl
@@ -544,11 +553,16 @@ int main(int argc, char **argv)
     if(groupCameraModel == 0)
       intrinsicId = std::rand(); // random number
 
-    #pragma omp critical
-    {
-      view.setIntrinsicId(intrinsicId);
-      sfmData.getIntrinsics().emplace(intrinsicId, intrinsicBase);
-    }
+    view.setIntrinsicId(intrinsicId);
+    createdIntrinsics.at(i) = std::make_pair(intrinsicId, intrinsicBase);
+  }
+
+  // batch insertion of the created intrinsics
+  // grouping is done by the map, the views of a group share the same id
+  for(const auto& intrinsicPair : createdIntrinsics)
+  {
+    if(intrinsicPair.second != nullptr)
+      sfmData.getIntrinsics().emplace(intrinsicPair.first, intrinsicPair.second);
   }
 
   // create detected rigs structures
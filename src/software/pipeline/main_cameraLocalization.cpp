@@ -103,8 +103,13 @@ int main(int argc, char** argv)
   std::string vocTreeFilepath;
   /// the vocabulary tree weights file
   std::string weightsFilepath;
+  /// the cached localization database file
+  std::string databaseFilepath;
   /// Number of previous frame of the sequence to use for matching
   std::size_t nbFrameBufferMatching = 10;
+  /// enable/disable the tracking mode seeding the candidate images of each
+  /// frame from the inliers of the previous frame
+  bool useTracking = false;
   /// enable/disable the robust matching (geometric validation) when matching query image
   /// and databases images
   bool robustMatching = true;
@@ -116,7 +121,9 @@ int main(int argc, char** argv)
 
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
   // parameters for cctag localizer
-  std::size_t nNearestKeyFrames = 5;   
+  std::size_t nNearestKeyFrames = 5;
+  /// number of frames to submit at once to the marker detector
+  std::size_t cctagBatchSize = 1;
 #endif
   // parameters for the final bundle adjustment
   /// If !refineIntrinsics it can run a final global bundle to refine the scene
@@ -181,8 +188,12 @@ int main(int argc, char** argv)
           "be used in cluster tracking")
       ("voctree", po::value<std::string>(&vocTreeFilepath), 
           "[voctree] Filename for the vocabulary tree")
-      ("voctreeWeights", po::value<std::string>(&weightsFilepath), 
+      ("voctreeWeights", po::value<std::string>(&weightsFilepath),
           "[voctree] Filename for the vocabulary tree weights")
+      ("voctreeDatabase", po::value<std::string>(&databaseFilepath),
+          "[voctree] Filename for the cached localization database: loaded if the "
+          "file exists, otherwise the database built from the descriptors is saved "
+          "there to speed up the next run")
       ("algorithm", po::value<std::string>(&algostring)->default_value(algostring), 
           "[voctree] Algorithm type: FirstBest, AllResults" )
       ("matchingError", po::value<double>(&matchingErrorMax)->default_value(matchingErrorMax), 
@@ -192,13 +203,21 @@ int main(int argc, char** argv)
       ("nbFrameBufferMatching", po::value<std::size_t>(&nbFrameBufferMatching)->default_value(nbFrameBufferMatching),
           "[voctree] Number of previous frame of the sequence to use for matching "
           "(0 = Disable)")
+      ("tracking", po::value<bool>(&useTracking)->default_value(useTracking),
+          "[voctree] Enable/Disable the tracking mode: the candidate images of each "
+          "frame are seeded from the inliers of the previous frame, the database is "
+          "only queried when the tracking is lost")
       ("robustMatching", po::value<bool>(&robustMatching)->default_value(robustMatching), 
           "[voctree] Enable/Disable the robust matching between query and database images, "
           "all putative matches will be considered.")
 // cctag specific options
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
-      ("nNearestKeyFrames", po::value<size_t>(&nNearestKeyFrames)->default_value(nNearestKeyFrames), 
+      ("nNearestKeyFrames", po::value<size_t>(&nNearestKeyFrames)->default_value(nNearestKeyFrames),
           "[cctag] Number of images to retrieve in the database")
+      ("batchSize", po::value<size_t>(&cctagBatchSize)->default_value(cctagBatchSize),
+          "[cctag] Number of frames to submit at once to the marker detector "
+          "(1 = frame by frame). On CPU the frames of a batch are detected in "
+          "parallel.")
 #endif
   ;
   
@@ -339,7 +358,8 @@ int main(int argc, char** argv)
                                                    descriptorsFolder,
                                                    vocTreeFilepath,
                                                    weightsFilepath,
-                                                   matchDescTypes);
+                                                   matchDescTypes,
+                                                   databaseFilepath);
 
     localizer.reset(tmpLoc);
     
@@ -353,6 +373,7 @@ int main(int argc, char** argv)
     tmpParam->_matchingError = matchingErrorMax;
     tmpParam->_nbFrameBufferMatching = nbFrameBufferMatching;
     tmpParam->_useRobustMatching = robustMatching;
+    tmpParam->_useTracking = useTracking;
   }
   
   assert(localizer);
@@ -405,45 +426,104 @@ int main(int argc, char** argv)
   bacc::accumulator_set<double, bacc::stats<bacc::tag::mean, bacc::tag::min, bacc::tag::max, bacc::tag::sum > > stats;
   
   std::vector<localization::LocalizationResult> vec_localizationResults;
-  
-  while(feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
+
+  // handle one localization result: accumulate the statistics and export the keyframe
+  auto processFrame = [&](const localization::LocalizationResult& localizationResult,
+                          const camera::PinholeRadialK3& intrinsics,
+                          const std::string& imgName,
+                          double elapsedMs)
   {
-    ALICEVISION_COUT("******************************");
-    ALICEVISION_COUT("FRAME " << myToString(frameCounter,4));
-    ALICEVISION_COUT("******************************");
-    localization::LocalizationResult localizationResult;
-    auto detect_start = std::chrono::steady_clock::now();
-    localizer->localize(imageGrey, 
-                       param.get(),
-                       hasIntrinsics /*useInputIntrinsics*/,
-                       queryIntrinsics,
-                       localizationResult,
-                       currentImgName);
-    auto detect_end = std::chrono::steady_clock::now();
-    auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
-    ALICEVISION_COUT("\nLocalization took  " << detect_elapsed.count() << " [ms]");
-    stats(detect_elapsed.count());
-    
+    stats(elapsedMs);
+
     vec_localizationResults.emplace_back(localizationResult);
 
     // save data
     if(localizationResult.isValid())
     {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
-      exporter.addCameraKeyframe(localizationResult.getPose(), &queryIntrinsics, currentImgName, frameCounter, frameCounter);
+      exporter.addCameraKeyframe(localizationResult.getPose(), &intrinsics, imgName, frameCounter, frameCounter);
 #endif
-      
+
       goodFrameCounter++;
-      goodFrameList.push_back(currentImgName + " : " + std::to_string(localizationResult.getIndMatch3D2D().size()) );
+      goodFrameList.push_back(imgName + " : " + std::to_string(localizationResult.getIndMatch3D2D().size()) );
     }
     else
     {
       ALICEVISION_CERR("Unable to localize frame " << frameCounter);
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
-      exporter.jumpKeyframe(currentImgName);
+      exporter.jumpKeyframe(imgName);
 #endif
     }
     ++frameCounter;
+  };
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CCTAG)
+  if(!useVoctreeLocalizer && cctagBatchSize > 1)
+  {
+    // batched mode: read up to batchSize frames from the feed and submit them
+    // at once to the marker detector
+    localization::CCTagLocalizer& cctagLocalizer = dynamic_cast<localization::CCTagLocalizer&>(*localizer);
+    bool feedDone = false;
+    while(!feedDone)
+    {
+      std::vector<image::Image<float>> batchImages;
+      std::vector<camera::PinholeRadialK3> batchIntrinsics;
+      std::vector<std::string> batchImgNames;
+
+      while(batchImages.size() < cctagBatchSize &&
+            feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
+      {
+        batchImages.push_back(imageGrey);
+        batchIntrinsics.push_back(queryIntrinsics);
+        batchImgNames.push_back(currentImgName);
+        feed.goToNextFrame();
+      }
+      feedDone = (batchImages.size() < cctagBatchSize);
+      if(batchImages.empty())
+        break;
+
+      ALICEVISION_COUT("******************************");
+      ALICEVISION_COUT("FRAME " << myToString(frameCounter,4) << " - " << myToString(frameCounter + batchImages.size() - 1,4));
+      ALICEVISION_COUT("******************************");
+      std::vector<localization::LocalizationResult> batchResults;
+      auto detect_start = std::chrono::steady_clock::now();
+      cctagLocalizer.localizeBatch(batchImages,
+                                   param.get(),
+                                   hasIntrinsics /*useInputIntrinsics*/,
+                                   batchIntrinsics,
+                                   batchResults,
+                                   batchImgNames);
+      auto detect_end = std::chrono::steady_clock::now();
+      auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
+      ALICEVISION_COUT("\nLocalization of " << batchImages.size() << " frames took " << detect_elapsed.count() << " [ms]");
+
+      const double elapsedPerFrame = double(detect_elapsed.count()) / double(batchImages.size());
+      for(std::size_t i = 0; i < batchImages.size(); ++i)
+      {
+        processFrame(batchResults.at(i), batchIntrinsics.at(i), batchImgNames.at(i), elapsedPerFrame);
+      }
+    }
+  }
+  else
+#endif
+  while(feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
+  {
+    ALICEVISION_COUT("******************************");
+    ALICEVISION_COUT("FRAME " << myToString(frameCounter,4));
+    ALICEVISION_COUT("******************************");
+    localization::LocalizationResult localizationResult;
+    auto detect_start = std::chrono::steady_clock::now();
+    localizer->localize(imageGrey,
+                       param.get(),
+                       hasIntrinsics /*useInputIntrinsics*/,
+                       queryIntrinsics,
+                       localizationResult,
+                       currentImgName);
+    auto detect_end = std::chrono::steady_clock::now();
+    auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
+    ALICEVISION_COUT("\nLocalization took  " << detect_elapsed.count() << " [ms]");
+
+    processFrame(localizationResult, queryIntrinsics, currentImgName, detect_elapsed.count());
     feed.goToNextFrame();
   }
 
@@ -13,7 +13,9 @@
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/system/cmdline.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/numa.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/WorkServer.hpp>
 #include <aliceVision/gpu/gpu.hpp>
 
 #include <boost/program_options.hpp>
@@ -40,6 +42,7 @@ int main(int argc, char* argv[])
     // program range
     int rangeStart = -1;
     int rangeSize = -1;
+    std::string workServer;
 
     // image downscale factor during process
     int downscale = 2;
@@ -65,6 +68,9 @@ int main(int argc, char* argv[])
     double refineGammaP = 8.0;
     bool refineUseTcOrRcPixSize = false;
 
+    // NUMA placement
+    bool numaPinning = false;
+
     po::options_description allParams("AliceVision depthMapEstimation\n"
                                       "Estimate depth map for each input image");
 
@@ -83,6 +89,9 @@ int main(int argc, char* argv[])
             "Compute a sub-range of images from index rangeStart to rangeStart+rangeSize.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
             "Compute a sub-range of N images (N=rangeSize).")
+        ("workServer", po::value<std::string>(&workServer)->default_value(workServer),
+            "Pull dynamic camera ranges from a work server ('host:port', see aliceVision_utils_workServer) "
+            "instead of using a static --rangeStart/--rangeSize split.")
         ("downscale", po::value<int>(&downscale)->default_value(downscale),
             "Image downscale factor.")
         ("minViewAngle", po::value<float>(&minViewAngle)->default_value(minViewAngle),
@@ -114,7 +123,9 @@ int main(int argc, char* argv[])
         ("refineGammaP", po::value<double>(&refineGammaP)->default_value(refineGammaP),
             "Refine: GammaP threshold.")
         ("refineUseTcOrRcPixSize", po::value<bool>(&refineUseTcOrRcPixSize)->default_value(refineUseTcOrRcPixSize),
-            "Refine: Use current camera pixel size or minimum pixel size of neighbour cameras.");
+            "Refine: Use current camera pixel size or minimum pixel size of neighbour cameras.")
+        ("numaPinning", po::value<bool>(&numaPinning)->default_value(numaPinning),
+            "Pin the worker threads round-robin over the NUMA nodes (multi-socket machines).");
 
     po::options_description logParams("Log parameters");
     logParams.add_options()
@@ -206,6 +217,50 @@ int main(int argc, char* argv[])
     mp.userParams.put("refineRc.gammaP", refineGammaP);
     mp.userParams.put("refineRc.useTcOrRcPixSize", refineUseTcOrRcPixSize);
 
+    // spread the worker threads over the NUMA nodes before any big buffer is
+    // touched, so the first-touch policy places pages next to their workers
+    if(numaPinning)
+    {
+      ALICEVISION_LOG_INFO("Pin worker threads over " << system::numa::getNumaNodeCount() << " NUMA node(s).");
+      system::numa::pinOpenMPThreadsRoundRobin();
+    }
+
+    // worker mode: pull dynamic camera ranges from the coordinator until it
+    // runs out of work, the chunk size adapts to the measured per-camera cost
+    if(!workServer.empty())
+    {
+      std::string host;
+      int port;
+      if(!system::parseWorkServerEndpoint(workServer, host, port))
+      {
+        ALICEVISION_LOG_ERROR("Invalid work server endpoint '" << workServer << "', expected 'host:port'.");
+        return EXIT_FAILURE;
+      }
+
+      system::WorkClient workClient(host, port);
+      int chunkStart = 0;
+      int chunkSize = 0;
+
+      while(workClient.nextChunk(chunkStart, chunkSize))
+      {
+        StaticVector<int> chunkCams;
+        chunkCams.reserve(chunkSize);
+        for(int rc = chunkStart; rc < std::min(chunkStart + chunkSize, mp.ncams); ++rc)
+          chunkCams.push_back(rc);
+
+        if(chunkCams.empty())
+          continue;
+
+        ALICEVISION_LOG_INFO("Create depth maps for cameras [" << chunkStart << ", " << chunkStart + chunkCams.size() << ").");
+
+        depthMap::computeDepthMapsPSSGM(&mp, chunkCams);
+        depthMap::refineDepthMaps(&mp, chunkCams);
+      }
+
+      ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
+      return EXIT_SUCCESS;
+    }
+
     StaticVector<int> cams;
     cams.reserve(mp.ncams);
     if(rangeSize == -1)
@@ -19,6 +19,7 @@
 #include <aliceVision/system/MemoryInfo.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/WorkServer.hpp>
 #include <aliceVision/system/cmdline.hpp>
 #include <aliceVision/config.hpp>
 
@@ -33,6 +34,11 @@
 #include <functional>
 #include <memory>
 #include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
@@ -44,6 +50,58 @@ using namespace aliceVision;
 namespace po = boost::program_options;
 namespace fs = boost::filesystem;
 
+/**
+ * @brief Bounded multi-producer / multi-consumer queue used to connect the
+ * decode, describe and serialize stages of the CPU extraction pipeline.
+ * push() blocks when the queue is full, pop() blocks until an element is
+ * available or the queue has been closed by the producers.
+ */
+template<typename T>
+class BoundedBuffer
+{
+public:
+
+  explicit BoundedBuffer(std::size_t capacity)
+    : _capacity(std::max(std::size_t(1), capacity))
+  {}
+
+  void push(T element)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notFull.wait(lock, [this]{ return _buffer.size() < _capacity; });
+    _buffer.push_back(std::move(element));
+    _notEmpty.notify_one();
+  }
+
+  bool pop(T& element)
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notEmpty.wait(lock, [this]{ return !_buffer.empty() || _closed; });
+    if(_buffer.empty())
+      return false;
+    element = std::move(_buffer.front());
+    _buffer.pop_front();
+    _notFull.notify_one();
+    return true;
+  }
+
+  void close()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _closed = true;
+    _notEmpty.notify_all();
+  }
+
+private:
+
+  std::deque<T> _buffer;
+  std::size_t _capacity;
+  bool _closed = false;
+  std::mutex _mutex;
+  std::condition_variable _notFull;
+  std::condition_variable _notEmpty;
+};
+
 class FeatureExtractor
 {
   struct ViewJob
@@ -189,11 +247,8 @@ public:
       nbThreads = std::min(_cpuJobs.size(), nbThreads);
 
       ALICEVISION_LOG_DEBUG("# threads for extraction: " << nbThreads);
-      omp_set_nested(1);
 
-#pragma omp parallel for num_threads(nbThreads)
-      for(int i = 0; i < _cpuJobs.size(); ++i)
-        computeViewJob(_cpuJobs.at(i));
+      computeCpuJobsPipelined(nbThreads);
     }
 
     if(!_gpuJobs.empty())
@@ -205,6 +260,120 @@ public:
 
 private:
 
+  struct DecodedViewJob
+  {
+    const ViewJob* job = nullptr;
+    image::Image<float> imageGrayFloat;
+  };
+
+  struct SerializeJob
+  {
+    const feature::ImageDescriber* imageDescriber = nullptr;
+    std::unique_ptr<feature::Regions> regions;
+    std::string featuresPath;
+    std::string descriptorPath;
+  };
+
+  /**
+   * @brief Run the CPU jobs as a three-stage pipeline:
+   * asynchronous image decoding, parallel description and asynchronous
+   * serialization, connected by bounded queues so that image I/O overlaps
+   * with descriptor computation instead of stalling the describer threads.
+   * @param[in] nbThreads number of describer worker threads
+   */
+  void computeCpuJobsPipelined(std::size_t nbThreads)
+  {
+    // bound the queues to the number of describer threads so that decoding
+    // stays ahead of the workers without unbounded memory growth
+    BoundedBuffer<DecodedViewJob> decodedQueue(nbThreads);
+    BoundedBuffer<SerializeJob> serializeQueue(2 * nbThreads);
+
+    // decode pool: image reading is I/O bound, a few threads are enough
+    // to keep the describer workers fed
+    const std::size_t nbDecodeThreads = std::min<std::size_t>(std::max<std::size_t>(1, nbThreads / 2), 4);
+    std::atomic<std::size_t> nextJobIndex(0);
+    std::atomic<std::size_t> nbRunningDecoders(nbDecodeThreads);
+
+    std::vector<std::thread> decodeThreads;
+    for(std::size_t t = 0; t < nbDecodeThreads; ++t)
+    {
+      decodeThreads.emplace_back([&]()
+      {
+        for(std::size_t i = nextJobIndex++; i < _cpuJobs.size(); i = nextJobIndex++)
+        {
+          DecodedViewJob decodedJob;
+          decodedJob.job = &_cpuJobs.at(i);
+          image::readImage(decodedJob.job->view.getImagePath(), decodedJob.imageGrayFloat);
+          decodedQueue.push(std::move(decodedJob));
+        }
+        if(--nbRunningDecoders == 0)
+          decodedQueue.close();
+      });
+    }
+
+    // writer: descriptor serialization runs off the critical path
+    std::thread serializeThread([&]()
+    {
+      SerializeJob serializeJob;
+      while(serializeQueue.pop(serializeJob))
+        serializeJob.imageDescriber->Save(serializeJob.regions.get(), serializeJob.featuresPath, serializeJob.descriptorPath);
+    });
+
+    // describe workers
+    std::atomic<std::size_t> nbRunningWorkers(nbThreads);
+    std::vector<std::thread> describeThreads;
+    for(std::size_t t = 0; t < nbThreads; ++t)
+    {
+      describeThreads.emplace_back([&]()
+      {
+        DecodedViewJob decodedJob;
+        while(decodedQueue.pop(decodedJob))
+        {
+          const ViewJob& job = *decodedJob.job;
+          image::Image<unsigned char> imageGrayUChar;
+
+          for(const auto& imageDescriberIndex : job.cpuImageDescriberIndexes)
+          {
+            const auto& imageDescriber = _imageDescribers.at(imageDescriberIndex);
+            const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
+            const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberType);
+
+            ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName  << " features from view '" << job.view.getImagePath() << "' [cpu]");
+
+            SerializeJob serializeJob;
+            serializeJob.imageDescriber = imageDescriber.get();
+            serializeJob.featuresPath = job.getFeaturesPath(imageDescriberType);
+            serializeJob.descriptorPath = job.getDescriptorPath(imageDescriberType);
+
+            if(imageDescriber->useFloatImage())
+            {
+              // image buffer use float image, use the read buffer
+              imageDescriber->describe(decodedJob.imageGrayFloat, serializeJob.regions);
+            }
+            else
+            {
+              // image buffer can't use float image
+              if(imageGrayUChar.Width() == 0) // the first time, convert the float buffer to uchar
+                image::grayFloat2grayUChar(decodedJob.imageGrayFloat, &imageGrayUChar);
+              imageDescriber->describe(imageGrayUChar, serializeJob.regions);
+            }
+
+            ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << serializeJob.regions->RegionCount() << " " << imageDescriberTypeName  << " features extracted from view '" << job.view.getImagePath() << "'");
+            serializeQueue.push(std::move(serializeJob));
+          }
+        }
+        if(--nbRunningWorkers == 0)
+          serializeQueue.close();
+      });
+    }
+
+    for(auto& thread : decodeThreads)
+      thread.join();
+    for(auto& thread : describeThreads)
+      thread.join();
+    serializeThread.join();
+  }
+
   void computeViewJob(const ViewJob& job, bool useGPU = false)
   {
     image::Image<float> imageGrayFloat;
@@ -233,7 +402,7 @@ private:
       {
         // image buffer can't use float image
         if(imageGrayUChar.Width() == 0) // the first time, convert the float buffer to uchar
-          imageGrayUChar = (imageGrayFloat.GetMat() * 255.f).cast<unsigned char>();
+          image::grayFloat2grayUChar(imageGrayFloat, &imageGrayUChar);
         imageDescriber->describe(imageGrayUChar, regions);
       }
       imageDescriber->Save(regions.get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
@@ -268,6 +437,7 @@ int main(int argc, char **argv)
   std::string describerPreset = feature::EImageDescriberPreset_enumToString(feature::EImageDescriberPreset::NORMAL);
   int rangeStart = -1;
   int rangeSize = 1;
+  std::string workServer;
   int maxThreads = 0;
   bool forceCpuExtraction = false;
 
@@ -293,6 +463,9 @@ int main(int argc, char **argv)
       "Range image index start.")
     ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
       "Range size.")
+    ("workServer", po::value<std::string>(&workServer)->default_value(workServer),
+      "Pull dynamic view ranges from a work server ('host:port', see aliceVision_utils_workServer) "
+      "instead of using a static --rangeStart/--rangeSize split.")
     ("maxThreads", po::value<int>(&maxThreads)->default_value(maxThreads),
       "Specifies the maximum number of threads to run simultaneously (0 for automatic mode).");
 
@@ -363,6 +536,65 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
+  // initialize imageDescribers
+  std::vector<std::shared_ptr<feature::ImageDescriber>> imageDescribers;
+  {
+    std::vector<feature::EImageDescriberType> imageDescriberTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+    for(const auto& imageDescriberType: imageDescriberTypes)
+    {
+      std::shared_ptr<feature::ImageDescriber> imageDescriber = feature::createImageDescriber(imageDescriberType);
+      imageDescriber->setConfigurationPreset(describerPreset);
+      if(forceCpuExtraction)
+        imageDescriber->setUseCuda(false);
+
+      imageDescribers.push_back(imageDescriber);
+    }
+  }
+
+  // feature extraction routines
+  // for each View of the SfMData container:
+  // - if regions file exist continue,
+  // - if no file, compute features
+  system::Timer timer;
+
+  if(!workServer.empty())
+  {
+    // worker mode: pull dynamic view ranges from the coordinator until it
+    // runs out of work, the chunk size adapts to the measured per-view cost
+    std::string host;
+    int port;
+    if(!system::parseWorkServerEndpoint(workServer, host, port))
+    {
+      ALICEVISION_LOG_ERROR("Invalid work server endpoint '" << workServer << "', expected 'host:port'.");
+      return EXIT_FAILURE;
+    }
+
+    system::WorkClient workClient(host, port);
+    int chunkStart = 0;
+    int chunkSize = 0;
+
+    while(workClient.nextChunk(chunkStart, chunkSize))
+    {
+      const int nbViews = static_cast<int>(sfmData.getViews().size());
+      if(chunkStart >= nbViews)
+        continue;
+
+      FeatureExtractor extractor(sfmData);
+      extractor.setOutputFolder(outputFolder);
+      extractor.setMaxThreads(maxThreads);
+      extractor.setRange(chunkStart, std::min(chunkSize, nbViews - chunkStart));
+
+      for(auto& imageDescriber : imageDescribers)
+        extractor.addImageDescriber(imageDescriber);
+
+      extractor.process();
+    }
+
+    ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
+    return EXIT_SUCCESS;
+  }
+
   // create feature extractor
   FeatureExtractor extractor(sfmData);
   extractor.setOutputFolder(outputFolder);
@@ -386,31 +618,11 @@ int main(int argc, char **argv)
     extractor.setRange(rangeStart, rangeSize);
   }
 
-  // initialize feature extractor imageDescribers
-  {
-    std::vector<feature::EImageDescriberType> imageDescriberTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
-
-    for(const auto& imageDescriberType: imageDescriberTypes)
-    {
-      std::shared_ptr<feature::ImageDescriber> imageDescriber = feature::createImageDescriber(imageDescriberType);
-      imageDescriber->setConfigurationPreset(describerPreset);
-      if(forceCpuExtraction)
-        imageDescriber->setUseCuda(false);
-
-      extractor.addImageDescriber(imageDescriber);
-    }
-  }
-
-  // feature extraction routines
-  // for each View of the SfMData container:
-  // - if regions file exist continue,
-  // - if no file, compute features
-  {
-    system::Timer timer;
+  for(auto& imageDescriber : imageDescribers)
+    extractor.addImageDescriber(imageDescriber);
 
-    extractor.process();
+  extractor.process();
 
-    ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
-  }
+  ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
   return EXIT_SUCCESS;
 }
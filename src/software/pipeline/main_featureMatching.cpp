@@ -24,7 +24,9 @@
 #include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
 #include <aliceVision/matching/pairwiseAdjacencyDisplay.hpp>
 #include <aliceVision/matching/io.hpp>
+#include <aliceVision/system/Telemetry.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/WorkServer.hpp>
 #include <aliceVision/system/cmdline.hpp>
 #include <aliceVision/feature/selection.hpp>
 #include <aliceVision/graph/graph.hpp>
@@ -102,6 +104,7 @@ int main(int argc, char **argv)
   std::string predefinedPairList;
   int rangeStart = -1;
   int rangeSize = 0;
+  std::string workServer;
   std::string nearestMatchingMethod = "ANN_L2";
   std::string geometricEstimatorName = robustEstimation::ERobustEstimator_enumToString(robustEstimation::ERobustEstimator::ACRANSAC);
   double geometricErrorMax = 0.0; //< the maximum reprojection error allowed for image matching with geometric validation
@@ -109,6 +112,7 @@ int main(int argc, char **argv)
   bool guidedMatching = false;
   int maxIteration = 2048;
   bool matchFilePerImage = true;
+  bool incrementalMatching = false;
   size_t numMatchesToKeep = 0;
   bool useGridSort = true;
   bool exportDebugFiles = false;
@@ -143,6 +147,7 @@ int main(int argc, char **argv)
       "For Scalar based regions descriptor:\n"
       "* BRUTE_FORCE_L2: L2 BruteForce matching\n"
       "* ANN_L2: L2 Approximate Nearest Neighbor matching\n"
+      "* HNSW_L2: L2 Hierarchical Navigable Small World graph matching\n"
       "* CASCADE_HASHING_L2: L2 Cascade Hashing matching\n"
       "* FAST_CASCADE_HASHING_L2: L2 Cascade Hashing with precomputed hashed regions\n"
       "(faster than CASCADE_HASHING_L2 but use more memory)\n"
@@ -161,6 +166,9 @@ int main(int argc, char **argv)
       "Use the found model to improve the pairwise correspondences.")
     ("matchFilePerImage", po::value<bool>(&matchFilePerImage)->default_value(matchFilePerImage),
       "Save matches in a separate file per image.")
+    ("incrementalMatching", po::value<bool>(&incrementalMatching)->default_value(incrementalMatching),
+      "Only compute the image pairs that are not already present in the output folder "
+      "and merge the new matches with the existing ones (useful on a growing dataset).")
     ("distanceRatio", po::value<float>(&distRatio)->default_value(distRatio),
       "Distance ratio to discard non meaningful matches.")
     ("maxIteration", po::value<int>(&maxIteration)->default_value(maxIteration),
@@ -174,7 +182,10 @@ int main(int argc, char **argv)
     ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
       "Range image index start.")
     ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
-      "Range size.");
+      "Range size.")
+    ("workServer", po::value<std::string>(&workServer)->default_value(workServer),
+      "Pull dynamic image ranges from a work server ('host:port', see aliceVision_utils_workServer) "
+      "instead of using a static --rangeStart/--rangeSize split.");
 
   po::options_description logParams("Log parameters");
   logParams.add_options()
@@ -242,81 +253,143 @@ int main(int argc, char **argv)
   // a. Load SfMData (image view & intrinsics data)
 
   SfMData sfmData;
-  if(!sfmDataIO::Load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(sfmDataIO::VIEWS|sfmDataIO::INTRINSICS)))
   {
-    ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read.");
-    return EXIT_FAILURE;
+    system::Telemetry::ScopedTimer telemetryTimer("loadSfMData");
+    if(!sfmDataIO::Load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(sfmDataIO::VIEWS|sfmDataIO::INTRINSICS)))
+    {
+      ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read.");
+      return EXIT_FAILURE;
+    }
   }
 
   // b. Compute putative descriptor matches
   //    - Descriptor matching (according user method choice)
   //    - Keep correspondences only if NearestNeighbor ratio is ok
 
-  // from matching mode compute the pair list that have to be matched
-  PairSet pairs;
+  // allocate the right Matcher according the Matching requested method,
+  // it is shared by all the computed ranges
+  EMatcherType collectionMatcherType = EMatcherType_stringToEnum(nearestMatchingMethod);
+  std::unique_ptr<IImageCollectionMatcher> imageCollectionMatcher = createImageCollectionMatcher(collectionMatcherType, distRatio);
+  // allow the matcher to reuse precomputed data (e.g. hashed descriptions) across runs
+  imageCollectionMatcher->setCachePath((fs::path(matchesFolder) / "matcherCache").string());
+
+  const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+  // view regions cache, kept across the computed ranges
+  RegionsPerView regionPerView;
+
+  // compute and save the matches of one range of image pairs,
+  // the ranges come from --rangeStart/--rangeSize or from the work server
+  auto matchRange = [&](int rangeStart, int rangeSize) -> int
+  {
+
+  // from matching mode compute the pair source that have to be matched,
+  // the exhaustive pairs are generated on demand and never materialized
+  std::unique_ptr<IPairsSource> pairsSource;
   std::set<IndexT> filter;
 
   if(predefinedPairList.empty())
   {
-    pairs = exhaustivePairs(sfmData.getViews(), rangeStart, rangeSize);
+    pairsSource.reset(new ExhaustivePairsSource(sfmData.getViews(), rangeStart, rangeSize));
   }
   else
   {
     ALICEVISION_LOG_INFO("Load pair list from file: " << predefinedPairList);
+    PairSet pairs;
     if(!loadPairs(predefinedPairList, pairs, rangeStart, rangeSize))
         return EXIT_FAILURE;
+    pairsSource.reset(new StaticPairsSource(pairs));
   }
 
-  if(pairs.empty())
+  if(pairsSource->size() == 0)
   {
     ALICEVISION_LOG_INFO("No image pair to match.");
     // if we only compute a selection of matches, we may have no match.
     return rangeSize ? EXIT_SUCCESS : EXIT_FAILURE;
   }
 
-  ALICEVISION_LOG_INFO("Number of pairs: " << pairs.size());
+  ALICEVISION_LOG_INFO("Number of pairs: " << pairsSource->size());
 
-  // filter creation
-  for(const auto& pair: pairs)
+  // incremental mode: the pairs already matched by previous runs are loaded
+  // from the output folder and removed from the work list, so a growing
+  // dataset only requires matching the new pairs
+  PairwiseMatches previousMatches;
+  if(incrementalMatching)
   {
-    filter.insert(pair.first);
-    filter.insert(pair.second);
+    std::set<IndexT> allViewsKeys;
+    std::transform(sfmData.getViews().begin(), sfmData.getViews().end(),
+      std::inserter(allViewsKeys, allViewsKeys.begin()), stl::RetrieveKey());
+
+    if(Load(previousMatches, allViewsKeys, {matchesFolder}, {}))
+    {
+      // the work list is materialized here, the incremental filter needs it
+      std::size_t nbAlreadyMatched = 0;
+      PairVec remainingPairs;
+      remainingPairs.reserve(pairsSource->size());
+      for(std::size_t p = 0; p < pairsSource->size(); ++p)
+      {
+        const Pair pair = pairsSource->at(p);
+        if(previousMatches.count(pair))
+          ++nbAlreadyMatched;
+        else
+          remainingPairs.push_back(pair);
+      }
+      pairsSource.reset(new StaticPairsSource(std::move(remainingPairs)));
+      ALICEVISION_LOG_INFO("Incremental matching: " + std::to_string(nbAlreadyMatched) + " pairs already matched, "
+        + std::to_string(pairsSource->size()) + " pairs left to compute.");
+    }
+
+    if(pairsSource->size() == 0)
+    {
+      ALICEVISION_LOG_INFO("All the image pairs are already matched.");
+      return EXIT_SUCCESS;
+    }
   }
 
+  // filter creation
+  pairsSource->getUsedViews(filter);
+
   ALICEVISION_LOG_INFO("Putative matches");
 
   PairwiseMatches mapPutativesMatches;
 
-  // allocate the right Matcher according the Matching requested method
-  EMatcherType collectionMatcherType = EMatcherType_stringToEnum(nearestMatchingMethod);
-  std::unique_ptr<IImageCollectionMatcher> imageCollectionMatcher = createImageCollectionMatcher(collectionMatcherType, distRatio);
-
-  const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
-
-  ALICEVISION_LOG_INFO("There are " + std::to_string(sfmData.getViews().size()) + " views and " + std::to_string(pairs.size()) + " image pairs.");
+  ALICEVISION_LOG_INFO("There are " + std::to_string(sfmData.getViews().size()) + " views and " + std::to_string(pairsSource->size()) + " image pairs.");
 
-  // load the corresponding view regions
-  RegionsPerView regionPerView;
-  if(!sfm::loadRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, filter))
+  // load the corresponding view regions, the views already loaded by a
+  // previous range are kept in the cache
   {
-    ALICEVISION_LOG_ERROR("Invalid regions in '" + sfmDataFilename + "'");
-    return EXIT_FAILURE;
+    std::set<IndexT> missingViews;
+    for(const IndexT viewId : filter)
+      if(!regionPerView.viewExist(viewId))
+        missingViews.insert(viewId);
+
+    system::Telemetry::ScopedTimer telemetryTimer("loadRegions");
+    if(!missingViews.empty() && !sfm::loadRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, missingViews))
+    {
+      ALICEVISION_LOG_ERROR("Invalid regions in '" + sfmDataFilename + "'");
+      return EXIT_FAILURE;
+    }
   }
 
   // perform the matching
   system::Timer timer;
 
-  for(const feature::EImageDescriberType descType : describerTypes)
   {
-    assert(descType != feature::EImageDescriberType::UNINITIALIZED);
-    ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
+    system::Telemetry::ScopedTimer telemetryTimer("putativeMatching");
+    for(const feature::EImageDescriberType descType : describerTypes)
+    {
+      assert(descType != feature::EImageDescriberType::UNINITIALIZED);
+      ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
 
-    // photometric matching of putative pairs
-    imageCollectionMatcher->Match(regionPerView, pairs, descType, mapPutativesMatches);
+      // photometric matching of putative pairs, timed per describer type
+      system::Telemetry::ScopedTimer describerTimer(EImageDescriberType_enumToString(descType));
+      imageCollectionMatcher->Match(regionPerView, *pairsSource, descType, mapPutativesMatches);
 
-    // TODO: DELI
-    // if(!guided_matching) regionPerView.clearDescriptors()
+      // TODO: DELI
+      // if(!guided_matching) regionPerView.clearDescriptors()
+    }
   }
+  system::Telemetry::get()->count("putativePairs", mapPutativesMatches.size());
 
   if(mapPutativesMatches.empty())
   {
@@ -392,76 +465,81 @@ int main(int argc, char **argv)
 
   ALICEVISION_LOG_INFO("Geometric filtering: using " << matchingImageCollection::EGeometricFilterType_enumToString(geometricFilterType));
 
-  switch(geometricFilterType)
   {
-
-    case EGeometricFilterType::NO_FILTERING:
-      geometricMatches = mapPutativesMatches;
-    break;
-
-    case EGeometricFilterType::FUNDAMENTAL_MATRIX:
+    system::Telemetry::ScopedTimer telemetryTimer("geometricFiltering");
+    switch(geometricFilterType)
     {
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator),
-        mapPutativesMatches,
-        guidedMatching);
-    }
-    break;
 
-    case EGeometricFilterType::ESSENTIAL_MATRIX:
-    {
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_E_AC(std::numeric_limits<double>::infinity(), maxIteration),
-        mapPutativesMatches,
-        guidedMatching);
-
-      // perform an additional check to remove pairs with poor overlap
-      std::vector<PairwiseMatches::key_type> toRemoveVec;
-      for(PairwiseMatches::const_iterator iterMap = geometricMatches.begin();
-        iterMap != geometricMatches.end(); ++iterMap)
+      case EGeometricFilterType::NO_FILTERING:
+        geometricMatches = mapPutativesMatches;
+      break;
+
+      case EGeometricFilterType::FUNDAMENTAL_MATRIX:
       {
-        const size_t putativePhotometricCount = mapPutativesMatches.find(iterMap->first)->second.getNbAllMatches();
-        const size_t putativeGeometricCount = iterMap->second.getNbAllMatches();
-        const float ratio = putativeGeometricCount / (float)putativePhotometricCount;
-        if (putativeGeometricCount < 50 || ratio < .3f)
-          toRemoveVec.push_back(iterMap->first); // the image pair will be removed
+        matchingImageCollection::robustModelEstimation(geometricMatches,
+          &sfmData,
+          regionPerView,
+          GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator),
+          mapPutativesMatches,
+          guidedMatching);
       }
+      break;
 
-      // remove discarded pairs
-      for(std::vector<PairwiseMatches::key_type>::const_iterator iter = toRemoveVec.begin();
-          iter != toRemoveVec.end(); ++iter)
-        geometricMatches.erase(*iter);
-    }
-    break;
+      case EGeometricFilterType::ESSENTIAL_MATRIX:
+      {
+        matchingImageCollection::robustModelEstimation(geometricMatches,
+          &sfmData,
+          regionPerView,
+          GeometricFilterMatrix_E_AC(std::numeric_limits<double>::infinity(), maxIteration),
+          mapPutativesMatches,
+          guidedMatching);
+
+        // perform an additional check to remove pairs with poor overlap
+        std::vector<PairwiseMatches::key_type> toRemoveVec;
+        for(PairwiseMatches::const_iterator iterMap = geometricMatches.begin();
+          iterMap != geometricMatches.end(); ++iterMap)
+        {
+          const size_t putativePhotometricCount = mapPutativesMatches.find(iterMap->first)->second.getNbAllMatches();
+          const size_t putativeGeometricCount = iterMap->second.getNbAllMatches();
+          const float ratio = putativeGeometricCount / (float)putativePhotometricCount;
+          if (putativeGeometricCount < 50 || ratio < .3f)
+            toRemoveVec.push_back(iterMap->first); // the image pair will be removed
+        }
 
-    case EGeometricFilterType::HOMOGRAPHY_MATRIX:
-    {
-      const bool onlyGuidedMatching = true;
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_H_AC(std::numeric_limits<double>::infinity(), maxIteration),
-        mapPutativesMatches, guidedMatching,
-        onlyGuidedMatching ? -1.0 : 0.6);
-    }
-    break;
+        // remove discarded pairs
+        for(std::vector<PairwiseMatches::key_type>::const_iterator iter = toRemoveVec.begin();
+            iter != toRemoveVec.end(); ++iter)
+          geometricMatches.erase(*iter);
+      }
+      break;
 
-    case EGeometricFilterType::HOMOGRAPHY_GROWING:
-    {
-      matchingImageCollection::robustModelEstimation(geometricMatches,
-        &sfmData,
-        regionPerView,
-        GeometricFilterMatrix_HGrowing(std::numeric_limits<double>::infinity(), maxIteration),
-        mapPutativesMatches,
-        guidedMatching);
+      case EGeometricFilterType::HOMOGRAPHY_MATRIX:
+      {
+        const bool onlyGuidedMatching = true;
+        matchingImageCollection::robustModelEstimation(geometricMatches,
+          &sfmData,
+          regionPerView,
+          GeometricFilterMatrix_H_AC(std::numeric_limits<double>::infinity(), maxIteration),
+          mapPutativesMatches, guidedMatching,
+          onlyGuidedMatching ? -1.0 : 0.6);
+      }
+      break;
+
+      case EGeometricFilterType::HOMOGRAPHY_GROWING:
+      {
+        matchingImageCollection::robustModelEstimation(geometricMatches,
+          &sfmData,
+          regionPerView,
+          GeometricFilterMatrix_HGrowing(std::numeric_limits<double>::infinity(), maxIteration),
+          mapPutativesMatches,
+          guidedMatching);
+      }
+      break;
     }
-    break;
   }
 
+  system::Telemetry::get()->count("geometricPairs", geometricMatches.size());
+
   ALICEVISION_LOG_INFO(std::to_string(geometricMatches.size()) + " geometric image pair matches:");
   for(const auto& matchGeo: geometricMatches)
     ALICEVISION_LOG_INFO("\t- image pair (" + std::to_string(matchGeo.first.first) + ", " + std::to_string(matchGeo.first.second) + ") contains " + std::to_string(matchGeo.second.getNbAllMatches()) + " geometric matches.");
@@ -522,6 +600,13 @@ int main(int argc, char **argv)
 
   // export geometric filtered matches
   ALICEVISION_LOG_INFO("Save geometric matches.");
+  if(incrementalMatching)
+  {
+    // merge with the matches of the previous runs, so the output folder always
+    // contains the complete set of matched pairs
+    // note: insert does not overwrite the newly computed pairs
+    finalMatches.insert(previousMatches.begin(), previousMatches.end());
+  }
   Save(finalMatches, matchesFolder, fileExtension, matchFilePerImage);
   ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
 
@@ -555,4 +640,39 @@ int main(int argc, char **argv)
 #endif
 
   return EXIT_SUCCESS;
+
+  }; // matchRange
+
+  // worker mode: pull dynamic image ranges from the coordinator until it
+  // runs out of work, the chunk size adapts to the measured per-image cost
+  if(!workServer.empty())
+  {
+    if(incrementalMatching)
+    {
+      ALICEVISION_LOG_ERROR("--incrementalMatching cannot be combined with --workServer.");
+      return EXIT_FAILURE;
+    }
+
+    std::string host;
+    int port;
+    if(!aliceVision::system::parseWorkServerEndpoint(workServer, host, port))
+    {
+      ALICEVISION_LOG_ERROR("Invalid work server endpoint '" << workServer << "', expected 'host:port'.");
+      return EXIT_FAILURE;
+    }
+
+    aliceVision::system::WorkClient workClient(host, port);
+    int chunkStart = 0;
+    int chunkSize = 0;
+
+    while(workClient.nextChunk(chunkStart, chunkSize))
+    {
+      const int returnCode = matchRange(chunkStart, chunkSize);
+      if(returnCode != EXIT_SUCCESS)
+        return returnCode;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  return matchRange(rangeStart, rangeSize);
 }
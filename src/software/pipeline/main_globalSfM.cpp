@@ -10,6 +10,8 @@
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
 #include <aliceVision/sfm/pipeline/global/ReconstructionEngine_globalSfM.hpp>
+#include <aliceVision/sfm/pipeline/global/viewGraphPartitioning.hpp>
+#include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/cmdline.hpp>
@@ -22,7 +24,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -46,6 +48,9 @@ int main(int argc, char **argv)
   int rotationAveragingMethod = static_cast<int>(sfm::ROTATION_AVERAGING_L2);
   int translationAveragingMethod = static_cast<int>(sfm::TRANSLATION_AVERAGING_SOFTL1);
   bool refineIntrinsics = true;
+  int clusterCount = 0;
+  int clusterIndex = -1;
+  std::vector<std::string> partialSfMDataFilenames;
 
   po::options_description allParams("Implementation of the paper\n"
     "\"Global Fusion of Relative Motions for "
@@ -77,7 +82,19 @@ int main(int argc, char **argv)
       "* 1: L1 minimization\n"
       "* 2: L2 minimization of sum of squared Chordal distances")
     ("refineIntrinsics", po::value<bool>(&refineIntrinsics)->default_value(refineIntrinsics),
-      "Refine intrinsic parameters.");
+      "Refine intrinsic parameters.")
+    ("clusterCount", po::value<int>(&clusterCount)->default_value(clusterCount),
+      "Partition the view graph into the given number of clusters and only reconstruct\n"
+      "the cluster selected with --clusterIndex (0: no partitioning).\n"
+      "The partition is deterministic, each cluster can be reconstructed on its own machine\n"
+      "and the partial results merged afterwards with --mergePartialSfMDatas.")
+    ("clusterIndex", po::value<int>(&clusterIndex)->default_value(clusterIndex),
+      "Index of the view graph cluster to reconstruct (used with --clusterCount).")
+    ("mergePartialSfMDatas", po::value<std::vector<std::string>>(&partialSfMDataFilenames)->multitoken(),
+      "Partial SfMData files reconstructed from the view graph clusters.\n"
+      "Merge them into a single scene instead of running a reconstruction,\n"
+      "each file must share boundary views with the previously given ones\n"
+      "(featuresFolders and matchesFolders are not used in this mode).");
 
   po::options_description logParams("Log parameters");
   logParams.add_options()
@@ -131,6 +148,61 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
+  if(clusterCount > 0 && (clusterIndex < 0 || clusterIndex >= clusterCount))
+  {
+    ALICEVISION_LOG_ERROR("Cluster index is invalid, it must be in the range [0;" << clusterCount - 1 << "]");
+    return EXIT_FAILURE;
+  }
+
+  // partial reconstructions merging mode
+  if(!partialSfMDataFilenames.empty())
+  {
+    if(partialSfMDataFilenames.size() < 2)
+    {
+      ALICEVISION_LOG_ERROR("At least 2 partial SfMData files are needed for the merge.");
+      return EXIT_FAILURE;
+    }
+
+    sfmData::SfMData mergedSfmData;
+    if(!sfmDataIO::Load(mergedSfmData, partialSfMDataFilenames.front(), sfmDataIO::ESfMData::ALL))
+    {
+      ALICEVISION_LOG_ERROR("The input SfMData file '" << partialSfMDataFilenames.front() << "' cannot be read.");
+      return EXIT_FAILURE;
+    }
+
+    for(std::size_t i = 1; i < partialSfMDataFilenames.size(); ++i)
+    {
+      sfmData::SfMData partialSfmData;
+      if(!sfmDataIO::Load(partialSfmData, partialSfMDataFilenames.at(i), sfmDataIO::ESfMData::ALL))
+      {
+        ALICEVISION_LOG_ERROR("The input SfMData file '" << partialSfMDataFilenames.at(i) << "' cannot be read.");
+        return EXIT_FAILURE;
+      }
+
+      if(!sfm::mergePartialReconstruction(mergedSfmData, partialSfmData))
+      {
+        ALICEVISION_LOG_ERROR("Unable to merge the partial reconstruction '" << partialSfMDataFilenames.at(i) << "'.");
+        return EXIT_FAILURE;
+      }
+    }
+
+    if(!fs::exists(outDirectory))
+      fs::create_directory(outDirectory);
+
+    // export to disk the merged scene (data & visualizable results)
+    ALICEVISION_LOG_INFO("Export merged SfMData to disk");
+
+    sfmDataIO::Save(mergedSfmData, outSfMDataFilename, sfmDataIO::ESfMData::ALL);
+    sfmDataIO::Save(mergedSfmData, (fs::path(outDirectory) / "cloud_and_poses.ply").string(), sfmDataIO::ESfMData::ALL);
+
+    ALICEVISION_LOG_INFO("Merged structure from motion results:" << std::endl
+      << "\t- # partial reconstructions: " << partialSfMDataFilenames.size() << std::endl
+      << "\t- # cameras calibrated: " << mergedSfmData.getPoses().size() << std::endl
+      << "\t- # landmarks: " << mergedSfmData.getLandmarks().size());
+
+    return EXIT_SUCCESS;
+  }
+
   // load input SfMData scene
   sfmData::SfMData sfmData;
   if(!sfmDataIO::Load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(sfmDataIO::VIEWS|sfmDataIO::INTRINSICS)))
@@ -171,6 +243,38 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
+  // view graph partitioning: restrict the scene and the matches to the selected cluster
+  if(clusterCount > 0)
+  {
+    const PairSet pairs = matching::getImagePairs(pairwiseMatches);
+    const std::vector<std::set<IndexT>> clusters = sfm::partitionViewGraph(pairs, clusterCount);
+
+    if(clusterIndex >= static_cast<int>(clusters.size()))
+    {
+      ALICEVISION_LOG_ERROR("The view graph only contains " << clusters.size() << " clusters.");
+      return EXIT_FAILURE;
+    }
+
+    const std::set<IndexT>& cluster = clusters.at(clusterIndex);
+
+    std::set<IndexT> removedViewIds;
+    for(const auto& viewPair : sfmData.getViews())
+      if(cluster.count(viewPair.first) == 0)
+        removedViewIds.insert(viewPair.first);
+
+    for(const IndexT viewId : removedViewIds)
+      sfmData.getViews().erase(viewId);
+
+    matching::PairwiseMatches clusterPairwiseMatches;
+    for(const auto& matchesPair : pairwiseMatches)
+      if(cluster.count(matchesPair.first.first) != 0 && cluster.count(matchesPair.first.second) != 0)
+        clusterPairwiseMatches.insert(matchesPair);
+
+    pairwiseMatches.swap(clusterPairwiseMatches);
+
+    ALICEVISION_LOG_INFO("View graph cluster #" << clusterIndex << ": " << cluster.size() << " views, " << pairwiseMatches.size() << " image pairs.");
+  }
+
   if(outDirectory.empty())
   {
     ALICEVISION_LOG_ERROR("It is an invalid output folder");
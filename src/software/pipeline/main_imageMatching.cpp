@@ -9,6 +9,7 @@
 #include <aliceVision/voctree/Database.hpp>
 #include <aliceVision/voctree/VocabularyTree.hpp>
 #include <aliceVision/voctree/databaseIO.hpp>
+#include <aliceVision/matchingImageCollection/pairBuilder.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/cmdline.hpp>
 #include <aliceVision/config.hpp>
@@ -407,7 +408,8 @@ int main(int argc, char** argv)
       "Input file path of the vocabulary tree. This file can be generated by createVoctree. "
       "This software is intended to be used with a generic, pre-trained vocabulary tree.")
     ("output,o", po::value<std::string>(&outputFile)->required(),
-      "Filepath to the output file with the list of selected image pairs.");
+      "Filepath to the output file with the list of selected image pairs. "
+      "A '.bin' extension selects the compact binary pair list format.");
 
   po::options_description optionalParams("Optional parameters");
   optionalParams.add_options()
@@ -680,10 +682,27 @@ int main(int argc, char** argv)
   }
 
   // write it to file
-  std::ofstream fileout;
-  fileout.open(outputFile, std::ofstream::out);
-  fileout << selectedPairs;
-  fileout.close();
+  if(fs::path(outputFile).extension() == ".bin")
+  {
+    // compact binary format, preferred at large scale: the text format makes
+    // the shortlist of a big dataset slow to parse back at matching time
+    std::map<IndexT, std::vector<IndexT>> pairsPerImage;
+    for(const auto& imagePairs : selectedPairs)
+      pairsPerImage[imagePairs.first].assign(imagePairs.second.begin(), imagePairs.second.end());
+
+    if(!savePairsToBinary(outputFile, pairsPerImage))
+    {
+      ALICEVISION_LOG_ERROR("Unable to write the output pair list: " << outputFile);
+      return EXIT_FAILURE;
+    }
+  }
+  else
+  {
+    std::ofstream fileout;
+    fileout.open(outputFile, std::ofstream::out);
+    fileout << selectedPairs;
+    fileout.close();
+  }
 
   ALICEVISION_LOG_INFO("pairList exported in: " << outputFile);
 
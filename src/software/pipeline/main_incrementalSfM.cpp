@@ -20,11 +20,12 @@
 #include <boost/filesystem.hpp>
 
 #include <cstdlib>
+#include <utility>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -92,10 +93,13 @@ int main(int argc, char **argv)
   float maxAngleInitialPair = 40.0f;
   bool refineIntrinsics = true;
   bool useLocalBundleAdjustment = false;
+  bool useGPUBundleAdjustment = false;
   bool useOnlyMatchesFromInputFolder = false;
   bool useTrackFiltering = true;
   bool useRigConstraint = true;
   bool lockScenePreviouslyReconstructed = true;
+  std::size_t checkpointInterval = 0;
+  bool resume = false;
   std::size_t localBundelAdjustementGraphDistanceLimit = 1;
   std::string localizerEstimatorName = robustEstimation::ERobustEstimator_enumToString(robustEstimation::ERobustEstimator::ACRANSAC);
 
@@ -155,6 +159,9 @@ int main(int argc, char **argv)
       "It reduces the reconstruction time, especially for big datasets (500+ images).")
     ("localBAGraphDistance", po::value<std::size_t>(&localBundelAdjustementGraphDistanceLimit)->default_value(localBundelAdjustementGraphDistanceLimit),
       "Graph-distance limit setting the Active region in the Local Bundle Adjustment strategy.")
+    ("useGPUBA", po::value<bool>(&useGPUBundleAdjustment)->default_value(useGPUBundleAdjustment),
+      "Enable/Disable the GPU bundle adjustment backend for the global adjustments.\n"
+      "Requires CUDA support and fixed intrinsics, unsupported scenes stay on the CPU backend.")
     ("localizerEstimator", po::value<std::string>(&localizerEstimatorName)->default_value(localizerEstimatorName),
       "Estimator type used to localize cameras (acransac (default), ransac, lsmeds, loransac, maxconsensus)")
     ("useOnlyMatchesFromInputFolder", po::value<bool>(&useOnlyMatchesFromInputFolder)->default_value(useOnlyMatchesFromInputFolder),
@@ -165,7 +172,13 @@ int main(int argc, char **argv)
     ("useRigConstraint", po::value<bool>(&useRigConstraint)->default_value(useRigConstraint),
       "Enable/Disable rig constraint.\n")
     ("lockScenePreviouslyReconstructed", po::value<bool>(&lockScenePreviouslyReconstructed)->default_value(lockScenePreviouslyReconstructed),
-      "Lock/Unlock scene previously reconstructed.\n");
+      "Lock/Unlock scene previously reconstructed.\n")
+    ("checkpointInterval", po::value<std::size_t>(&checkpointInterval)->default_value(checkpointInterval),
+      "Number of resection groups between two reconstruction checkpoint files written in the extraInfoFolder.\n"
+      "A checkpoint allows to resume an interrupted reconstruction with '--resume'. 0 means no checkpoint.")
+    ("resume", po::value<bool>(&resume)->default_value(resume),
+      "Resume the reconstruction from the last checkpoint file found in the extraInfoFolder.\n"
+      "If no checkpoint file is found, the reconstruction starts from scratch.");
 
   po::options_description logParams("Log parameters");
   logParams.add_options()
@@ -254,6 +267,35 @@ int main(int argc, char **argv)
   if (!fs::exists(extraInfoFolder))
     fs::create_directory(extraInfoFolder);
 
+  // resume from the last reconstruction checkpoint if any
+  // note: the checkpoint is a complete SfMData, the reconstruction resumes in SfM augmentation mode.
+  //       Views that failed resection before the interruption are simply tried again.
+  if(resume)
+  {
+    const std::string checkpointPath = (fs::path(extraInfoFolder) / sfm::ReconstructionEngine_sequentialSfM::checkpointFilename()).string();
+
+    if(fs::exists(checkpointPath))
+    {
+      sfmData::SfMData checkpointSfmData;
+      if(!sfmDataIO::Load(checkpointSfmData, checkpointPath, sfmDataIO::ESfMData::ALL))
+      {
+        ALICEVISION_LOG_ERROR("The checkpoint file '" + checkpointPath + "' cannot be read.");
+        return EXIT_FAILURE;
+      }
+
+      ALICEVISION_LOG_INFO("Resume reconstruction from checkpoint: " << checkpointPath << std::endl
+        << "\t- # cameras calibrated: " << checkpointSfmData.getPoses().size() << std::endl
+        << "\t- # landmarks: " << checkpointSfmData.getLandmarks().size());
+
+      // the checkpoint carries the pose/intrinsic lock flags of the interrupted run
+      sfmData = std::move(checkpointSfmData);
+    }
+    else
+    {
+      ALICEVISION_LOG_WARNING("No checkpoint file found in '" + extraInfoFolder + "', the reconstruction starts from scratch.");
+    }
+  }
+
   // sequential reconstruction process
   aliceVision::system::Timer timer;
   sfm::ReconstructionEngine_sequentialSfM sfmEngine(
@@ -274,8 +316,15 @@ int main(int argc, char **argv)
   sfmEngine.setMinAngleInitialPair(minAngleInitialPair);
   sfmEngine.setMaxAngleInitialPair(maxAngleInitialPair);
   sfmEngine.setIntermediateFileExtension(outInterFileExtension);
+  sfmEngine.setCheckpointInterval(checkpointInterval);
   sfmEngine.setUseLocalBundleAdjustmentStrategy(useLocalBundleAdjustment);
   sfmEngine.setLocalBundleAdjustmentGraphDistance(localBundelAdjustementGraphDistanceLimit);
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+  sfmEngine.setUseGPUBundleAdjustment(useGPUBundleAdjustment);
+#else
+  if(useGPUBundleAdjustment)
+    ALICEVISION_LOG_WARNING("The GPU bundle adjustment backend requires CUDA support, using the CPU backend.");
+#endif
   sfmEngine.setLocalizerEstimator(robustEstimation::ERobustEstimator_stringToEnum(localizerEstimatorName));
   sfmEngine.useTrackFiltering(useTrackFiltering);
   sfmEngine.useRigConstraint(useRigConstraint);
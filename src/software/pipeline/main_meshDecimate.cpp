@@ -8,6 +8,7 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <OpenMesh/Core/IO/reader/OBJReader.hh>
 #include <OpenMesh/Core/IO/writer/OBJWriter.hh>
@@ -30,6 +31,194 @@ using namespace aliceVision;
 namespace bfs = boost::filesystem;
 namespace po = boost::program_options;
 
+// Mesh type
+typedef OpenMesh::TriMesh_ArrayKernelT<>                      Mesh;
+// Decimater type
+typedef OpenMesh::Decimater::DecimaterT< Mesh >               Decimater;
+// Decimation Module Handle type
+typedef OpenMesh::Decimater::ModQuadricT< Mesh >::Handle HModQuadric;
+
+/**
+ * @brief Decimate the given mesh down to nbVertices vertices with the quadric
+ * module. Locked vertices are kept in place.
+ * @return the number of removed vertices
+ */
+std::size_t decimateMesh(Mesh& mesh, std::size_t nbVertices)
+{
+    // a decimater object, connected to a mesh
+    Decimater   decimater(mesh);
+    // use a quadric module
+    HModQuadric hModQuadric;
+    // register module at the decimater
+    decimater.add(hModQuadric);
+
+    /*
+     * since we need exactly one priority module (non-binary)
+     * we have to call set_binary(false) for our priority module
+     * in the case of HModQuadric, unset_max_err() calls set_binary(false) internally
+     */
+    decimater.module(hModQuadric).unset_max_err();
+    // let the decimater initialize the mesh and the modules
+    decimater.initialize();
+    // do decimation
+    const std::size_t removedVertices = decimater.decimate_to(nbVertices);
+    decimater.mesh().garbage_collection();
+    return removedVertices;
+}
+
+/**
+ * @brief Decimate the mesh in spatial blocks: the faces are bucketed in a
+ * uniform gridSize^3 grid over the mesh bounding box, each block is decimated
+ * concurrently with its boundary vertices locked, and the merged result goes
+ * through a last global pass that collapses the block boundaries.
+ *
+ * The result can slightly differ from a single global decimation, since the
+ * collapse ordering is only optimal per block.
+ */
+void decimateMeshInBlocks(Mesh& mesh, int gridSize, std::size_t nbOutputPoints)
+{
+    if(mesh.n_vertices() == 0)
+        return;
+
+    const int nbBlocks = gridSize * gridSize * gridSize;
+
+    // compute the bounding box of the mesh
+    Mesh::Point bbMin = mesh.point(*mesh.vertices_begin());
+    Mesh::Point bbMax = bbMin;
+    for(Mesh::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+    {
+        bbMin.minimize(mesh.point(*v_it));
+        bbMax.maximize(mesh.point(*v_it));
+    }
+    const Mesh::Point bbSize = bbMax - bbMin;
+
+    const auto cellIndex = [&](Mesh::Scalar coord, Mesh::Scalar origin, Mesh::Scalar extent)
+    {
+        if(extent <= Mesh::Scalar(0))
+            return 0;
+        return std::max(0, std::min(gridSize - 1, int((coord - origin) / extent * gridSize)));
+    };
+
+    // bucket each face into the grid cell of its barycenter; a vertex shared
+    // by faces of several blocks lies on a block boundary
+    std::vector<std::vector<int>> blockFaces(nbBlocks);
+    std::vector<int> vertexBlock(mesh.n_vertices(), -1);
+    std::vector<char> isBlockBoundary(mesh.n_vertices(), 0);
+
+    for(Mesh::FaceIter f_it = mesh.faces_begin(); f_it != mesh.faces_end(); ++f_it)
+    {
+        const Mesh::Point barycenter = mesh.calc_face_centroid(*f_it);
+        const int blockId = (cellIndex(barycenter[2], bbMin[2], bbSize[2]) * gridSize +
+                             cellIndex(barycenter[1], bbMin[1], bbSize[1])) * gridSize +
+                             cellIndex(barycenter[0], bbMin[0], bbSize[0]);
+        blockFaces[blockId].push_back(f_it->idx());
+
+        for(Mesh::FaceVertexIter fv_it = mesh.fv_iter(*f_it); fv_it.is_valid(); ++fv_it)
+        {
+            int& block = vertexBlock[fv_it->idx()];
+            if(block == -1)
+                block = blockId;
+            else if(block != blockId)
+                isBlockBoundary[fv_it->idx()] = 1;
+        }
+    }
+
+    // build one sub-mesh per block; boundary vertices are duplicated in every
+    // block using them and locked, so the parallel pass leaves them in place
+    struct Block
+    {
+        Mesh mesh;
+        OpenMesh::VPropHandleT<int> globalId;
+        std::size_t nbTargetVertices = 0;
+    };
+
+    const double keepRatio = double(nbOutputPoints) / double(mesh.n_vertices());
+    std::vector<Block> blocks(nbBlocks);
+    std::vector<int> globalToLocal(mesh.n_vertices(), -1);
+
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        Block& block = blocks[b];
+        block.mesh.request_vertex_status();
+        block.mesh.add_property(block.globalId);
+
+        for(const int faceId : blockFaces[b])
+        {
+            const Mesh::FaceHandle fh(faceId);
+            std::vector<Mesh::VertexHandle> faceVertices;
+            for(Mesh::FaceVertexIter fv_it = mesh.fv_iter(fh); fv_it.is_valid(); ++fv_it)
+            {
+                int& local = globalToLocal[fv_it->idx()];
+                if(local == -1)
+                {
+                    const Mesh::VertexHandle vh = block.mesh.add_vertex(mesh.point(*fv_it));
+                    block.mesh.property(block.globalId, vh) = fv_it->idx();
+                    if(isBlockBoundary[fv_it->idx()])
+                        block.mesh.status(vh).set_locked(true);
+                    local = vh.idx();
+                }
+                faceVertices.push_back(Mesh::VertexHandle(local));
+            }
+            block.mesh.add_face(faceVertices);
+        }
+
+        // reset the mapping for the next block
+        for(Mesh::VertexIter v_it = block.mesh.vertices_begin(); v_it != block.mesh.vertices_end(); ++v_it)
+            globalToLocal[block.mesh.property(block.globalId, *v_it)] = -1;
+
+        block.nbTargetVertices = std::size_t(keepRatio * block.mesh.n_vertices());
+    }
+
+    // decimate the blocks concurrently
+#pragma omp parallel for schedule(dynamic)
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        if(blocks[b].mesh.n_vertices() == 0)
+            continue;
+        decimateMesh(blocks[b].mesh, blocks[b].nbTargetVertices);
+    }
+
+    // merge the decimated blocks, de-duplicating the locked boundary vertices
+    Mesh mergedMesh;
+    std::map<int, Mesh::VertexHandle> boundaryVertices; // global id -> merged handle
+
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        Block& block = blocks[b];
+        std::vector<Mesh::VertexHandle> localToMerged(block.mesh.n_vertices());
+
+        for(Mesh::VertexIter v_it = block.mesh.vertices_begin(); v_it != block.mesh.vertices_end(); ++v_it)
+        {
+            const int globalId = block.mesh.property(block.globalId, *v_it);
+            if(isBlockBoundary[globalId])
+            {
+                auto it = boundaryVertices.find(globalId);
+                if(it == boundaryVertices.end())
+                    it = boundaryVertices.emplace(globalId, mergedMesh.add_vertex(block.mesh.point(*v_it))).first;
+                localToMerged[v_it->idx()] = it->second;
+            }
+            else
+            {
+                localToMerged[v_it->idx()] = mergedMesh.add_vertex(block.mesh.point(*v_it));
+            }
+        }
+
+        for(Mesh::FaceIter f_it = block.mesh.faces_begin(); f_it != block.mesh.faces_end(); ++f_it)
+        {
+            std::vector<Mesh::VertexHandle> faceVertices;
+            for(Mesh::FaceVertexIter fv_it = block.mesh.fv_iter(*f_it); fv_it.is_valid(); ++fv_it)
+                faceVertices.push_back(localToMerged[fv_it->idx()]);
+            mergedMesh.add_face(faceVertices);
+        }
+    }
+
+    mesh = mergedMesh;
+
+    // last global pass: the block boundaries are not locked anymore and get
+    // collapsed down to the requested number of vertices
+    decimateMesh(mesh, nbOutputPoints);
+}
+
 int main(int argc, char* argv[])
 {
     system::Timer timer;
@@ -42,6 +231,7 @@ int main(int argc, char* argv[])
     int fixedNbVertices = 0;
     int minVertices = 0;
     int maxVertices = 0;
+    int blocksGridSize = 0;
     bool flipNormals = false;
 
     po::options_description allParams("AliceVision meshResampling");
@@ -63,6 +253,8 @@ int main(int argc, char* argv[])
             "Min number of output vertices.")
         ("maxVertices", po::value<int>(&maxVertices)->default_value(maxVertices),
             "Max number of output vertices.")
+        ("blocksGridSize", po::value<int>(&blocksGridSize)->default_value(blocksGridSize),
+            "Decimate the mesh in blocksGridSize^3 spatial blocks in parallel, with locked block boundaries collapsed in a final pass (0: decimate the whole mesh at once).")
         ("flipNormals", po::value<bool>(&flipNormals)->default_value(flipNormals),
             "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the convention change from one software to another.");
 
@@ -110,13 +302,6 @@ int main(int argc, char* argv[])
     if(!bfs::is_directory(outDirectory))
         bfs::create_directory(outDirectory);
 
-    // Mesh type
-    typedef OpenMesh::TriMesh_ArrayKernelT<>                      Mesh;
-    // Decimater type
-    typedef OpenMesh::Decimater::DecimaterT< Mesh >               Decimater;
-    // Decimation Module Handle type
-    typedef OpenMesh::Decimater::ModQuadricT< Mesh >::Handle HModQuadric;
-
     Mesh mesh;
     if(!OpenMesh::IO::read_mesh(mesh, inputMeshPath.c_str()))
     {
@@ -153,28 +338,14 @@ int main(int argc, char* argv[])
     ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << mesh.n_faces() << " facets.");
     ALICEVISION_LOG_INFO("Target output mesh: " << nbOutputPoints << " vertices.");
 
+    if(blocksGridSize > 1)
+    {
+        ALICEVISION_LOG_INFO("Decimate the mesh in " << blocksGridSize << "x" << blocksGridSize << "x" << blocksGridSize << " parallel blocks.");
+        decimateMeshInBlocks(mesh, blocksGridSize, nbOutputPoints);
+    }
+    else
     {
-        // a decimater object, connected to a mesh
-        Decimater   decimater(mesh);
-        // use a quadric module
-        HModQuadric hModQuadric;
-        // register module at the decimater
-        decimater.add(hModQuadric);
-
-        // the way to access the module
-        std::cout << decimater.module(hModQuadric).name() << std::endl;
-
-        /*
-         * since we need exactly one priority module (non-binary)
-         * we have to call set_binary(false) for our priority module
-         * in the case of HModQuadric, unset_max_err() calls set_binary(false) internally
-         */
-        decimater.module(hModQuadric).unset_max_err();
-        // let the decimater initialize the mesh and the modules
-        decimater.initialize();
-        // do decimation
-        size_t removedVertices = decimater.decimate_to(nbOutputPoints);
-        decimater.mesh().garbage_collection();
+        decimateMesh(mesh, nbOutputPoints);
     }
     ALICEVISION_LOG_INFO("Output mesh: " << mesh.n_vertices() << " vertices and " << mesh.n_faces() << " facets.");
 
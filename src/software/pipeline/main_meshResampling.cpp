@@ -8,6 +8,7 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <geogram/mesh/mesh.h>
 #include <geogram/mesh/mesh_io.h>
@@ -15,6 +16,7 @@
 #include <geogram/mesh/mesh_preprocessing.h>
 #include <geogram/mesh/mesh_decimate.h>
 #include <geogram/mesh/mesh_remesh.h>
+#include <geogram/mesh/mesh_repair.h>
 
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/command_line_args.h>
@@ -22,6 +24,9 @@
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
+#include <memory>
+#include <cmath>
+
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
@@ -32,6 +37,246 @@ using namespace aliceVision;
 namespace bfs = boost::filesystem;
 namespace po = boost::program_options;
 
+/**
+ * @brief Remesh the input mesh into nbPoints samples with the CVT remeshing.
+ */
+void remeshMesh(GEO::Mesh& M_in, GEO::Mesh& M_out, int nbPoints, unsigned int nbLloydIter)
+{
+    const unsigned int nbNewtonIter = 0;
+    const unsigned int newtonM = 0;
+
+    GEO::remesh_smooth(
+        M_in, M_out,
+        nbPoints,
+        3, // 3 dimensions
+        nbLloydIter, // Number of iterations for Lloyd pre-smoothing
+        nbNewtonIter, // Number of iterations for Newton-CVT
+        newtonM // Number of evaluations for Hessian approximation
+        );
+}
+
+/**
+ * @brief Append the triangles of the given mesh to the output mesh.
+ */
+void appendMesh(GEO::Mesh& M_out, const GEO::Mesh& M_in)
+{
+    const GEO::index_t vertexOffset = M_out.vertices.nb();
+    M_out.vertices.create_vertices(M_in.vertices.nb());
+    for(GEO::index_t v = 0; v < M_in.vertices.nb(); ++v)
+    {
+        const double* src = M_in.vertices.point_ptr(v);
+        double* dst = M_out.vertices.point_ptr(vertexOffset + v);
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+    }
+    for(GEO::index_t f = 0; f < M_in.facets.nb(); ++f)
+    {
+        M_out.facets.create_triangle(vertexOffset + M_in.facets.vertex(f, 0),
+                                     vertexOffset + M_in.facets.vertex(f, 1),
+                                     vertexOffset + M_in.facets.vertex(f, 2));
+    }
+}
+
+/**
+ * @brief Resample the mesh in spatial blocks: the facets are bucketed in a
+ * uniform gridSize^3 grid over the mesh bounding box (the same partitioning as
+ * the block decimation), each block is remeshed concurrently with a margin of
+ * facets borrowed from the neighboring cells, the facets resampled inside the
+ * margin are dropped and the block seams are stitched by welding vertices
+ * closer than a fraction of the target sampling distance.
+ *
+ * The sampling is only optimal per block and the welded seams are not
+ * guaranteed to be watertight, so the result can slightly differ from a single
+ * global remeshing.
+ *
+ * If checkpointPrefix is not empty, each remeshed block is saved to
+ * "<checkpointPrefix><blockId>.geogram" and reused when restarting after an
+ * interruption.
+ */
+void resampleMeshInBlocks(GEO::Mesh& M_in, GEO::Mesh& M_out, int gridSize, int nbOutputPoints,
+                          unsigned int nbLloydIter, const std::string& checkpointPrefix)
+{
+    const int nbBlocks = gridSize * gridSize * gridSize;
+
+    // compute the bounding box of the mesh
+    double bbMin[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    double bbMax[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    for(GEO::index_t v = 0; v < M_in.vertices.nb(); ++v)
+    {
+        const double* p = M_in.vertices.point_ptr(v);
+        for(int c = 0; c < 3; ++c)
+        {
+            bbMin[c] = std::min(bbMin[c], p[c]);
+            bbMax[c] = std::max(bbMax[c], p[c]);
+        }
+    }
+    double bbSize[3];
+    for(int c = 0; c < 3; ++c)
+        bbSize[c] = bbMax[c] - bbMin[c];
+
+    const auto cellIndex = [&](double coord, int axis)
+    {
+        if(bbSize[axis] <= 0.0)
+            return 0;
+        return std::max(0, std::min(gridSize - 1, int((coord - bbMin[axis]) / bbSize[axis] * gridSize)));
+    };
+
+    // bucket each facet into the grid cell of its barycenter; the facets whose
+    // barycenter falls within the margin of a neighboring cell are also added
+    // to that block, so the sampler sees the surface across the seam
+    const double marginRatio = 0.2; // fraction of the cell extent
+    std::vector<std::vector<GEO::index_t>> blockFaces(nbBlocks);
+    std::vector<double> blockArea(nbBlocks, 0.0);
+    double totalArea = 0.0;
+
+    for(GEO::index_t f = 0; f < M_in.facets.nb(); ++f)
+    {
+        const double* p0 = M_in.vertices.point_ptr(M_in.facets.vertex(f, 0));
+        const double* p1 = M_in.vertices.point_ptr(M_in.facets.vertex(f, 1));
+        const double* p2 = M_in.vertices.point_ptr(M_in.facets.vertex(f, 2));
+
+        double center[3];
+        int cellFrom[3];
+        int cellTo[3];
+        for(int c = 0; c < 3; ++c)
+        {
+            center[c] = (p0[c] + p1[c] + p2[c]) / 3.0;
+            const double margin = (bbSize[c] / gridSize) * marginRatio;
+            cellFrom[c] = cellIndex(center[c] - margin, c);
+            cellTo[c] = cellIndex(center[c] + margin, c);
+        }
+
+        const double area = GEO::Geom::triangle_area(GEO::vec3(p0[0], p0[1], p0[2]),
+                                                     GEO::vec3(p1[0], p1[1], p1[2]),
+                                                     GEO::vec3(p2[0], p2[1], p2[2]));
+        totalArea += area;
+        blockArea[(cellIndex(center[2], 2) * gridSize + cellIndex(center[1], 1)) * gridSize + cellIndex(center[0], 0)] += area;
+
+        for(int z = cellFrom[2]; z <= cellTo[2]; ++z)
+          for(int y = cellFrom[1]; y <= cellTo[1]; ++y)
+            for(int x = cellFrom[0]; x <= cellTo[0]; ++x)
+                blockFaces[(z * gridSize + y) * gridSize + x].push_back(f);
+    }
+
+    // build one sub-mesh per block
+    std::vector<std::unique_ptr<GEO::Mesh>> blocks(nbBlocks);
+    std::vector<GEO::index_t> globalToLocal(M_in.vertices.nb(), GEO::NO_VERTEX);
+
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        blocks[b].reset(new GEO::Mesh());
+        GEO::Mesh& block = *blocks[b];
+
+        for(const GEO::index_t f : blockFaces[b])
+        {
+            GEO::index_t localVertices[3];
+            for(GEO::index_t lv = 0; lv < 3; ++lv)
+            {
+                const GEO::index_t v = M_in.facets.vertex(f, lv);
+                if(globalToLocal[v] == GEO::NO_VERTEX)
+                {
+                    globalToLocal[v] = block.vertices.create_vertex(M_in.vertices.point_ptr(v));
+                }
+                localVertices[lv] = globalToLocal[v];
+            }
+            block.facets.create_triangle(localVertices[0], localVertices[1], localVertices[2]);
+        }
+
+        // reset the mapping for the next block
+        for(const GEO::index_t f : blockFaces[b])
+            for(GEO::index_t lv = 0; lv < 3; ++lv)
+                globalToLocal[M_in.facets.vertex(f, lv)] = GEO::NO_VERTEX;
+    }
+
+    // remesh the blocks concurrently; geogram runs single threaded per block
+    std::vector<std::unique_ptr<GEO::Mesh>> remeshedBlocks(nbBlocks);
+    int nbRemeshedBlocks = 0;
+
+#pragma omp parallel for schedule(dynamic)
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        if(blocks[b]->facets.nb() == 0)
+            continue;
+
+        remeshedBlocks[b].reset(new GEO::Mesh());
+        GEO::Mesh& remeshed = *remeshedBlocks[b];
+
+        const std::string checkpointPath = checkpointPrefix.empty() ? std::string()
+            : checkpointPrefix + std::to_string(b) + ".geogram";
+
+        if(!checkpointPath.empty() && bfs::exists(checkpointPath) && GEO::mesh_load(checkpointPath, remeshed))
+        {
+            #pragma omp critical
+            {
+                ALICEVISION_LOG_INFO("Block " << b << " reloaded from checkpoint \"" << checkpointPath << "\".");
+            }
+        }
+        else
+        {
+            // each block gets its share of the output budget, proportional to
+            // the surface area it owns (the margin facets are not counted)
+            const int nbBlockPoints = std::max(4, int(double(nbOutputPoints) * blockArea[b] / std::max(totalArea, 1e-9)));
+            remeshMesh(*blocks[b], remeshed, nbBlockPoints, nbLloydIter);
+
+            // drop the facets resampled inside the margin: the cell they
+            // belong to is owned by a neighboring block
+            const int bx = b % gridSize;
+            const int by = (b / gridSize) % gridSize;
+            const int bz = b / (gridSize * gridSize);
+            GEO::vector<GEO::index_t> facetsToDelete(remeshed.facets.nb(), 0);
+            for(GEO::index_t f = 0; f < remeshed.facets.nb(); ++f)
+            {
+                const double* p0 = remeshed.vertices.point_ptr(remeshed.facets.vertex(f, 0));
+                const double* p1 = remeshed.vertices.point_ptr(remeshed.facets.vertex(f, 1));
+                const double* p2 = remeshed.vertices.point_ptr(remeshed.facets.vertex(f, 2));
+                const double center[3] = {(p0[0] + p1[0] + p2[0]) / 3.0,
+                                          (p0[1] + p1[1] + p2[1]) / 3.0,
+                                          (p0[2] + p1[2] + p2[2]) / 3.0};
+                if(cellIndex(center[0], 0) != bx ||
+                   cellIndex(center[1], 1) != by ||
+                   cellIndex(center[2], 2) != bz)
+                    facetsToDelete[f] = 1;
+            }
+            remeshed.facets.delete_elements(facetsToDelete);
+
+            if(!checkpointPath.empty())
+                GEO::mesh_save(remeshed, checkpointPath);
+        }
+
+        blocks[b].reset(); // the input sub-mesh is not needed anymore
+
+        #pragma omp critical
+        {
+            ++nbRemeshedBlocks;
+            ALICEVISION_LOG_INFO("Block " << b << " remeshed: " << remeshed.vertices.nb() << " vertices ("
+                                  << nbRemeshedBlocks << " blocks done).");
+        }
+    }
+
+    // merge the remeshed blocks and stitch the seams: the borders of adjacent
+    // blocks are sampled independently, welding the vertices closer than a
+    // fraction of the target sampling distance reconnects them
+    for(int b = 0; b < nbBlocks; ++b)
+    {
+        if(remeshedBlocks[b])
+        {
+            appendMesh(M_out, *remeshedBlocks[b]);
+            remeshedBlocks[b].reset();
+        }
+    }
+
+    const double samplingDistance = std::sqrt(totalArea / std::max(1, nbOutputPoints));
+    GEO::mesh_repair(M_out, GEO::MESH_REPAIR_DEFAULT, 0.3 * samplingDistance);
+
+    // remove the checkpoints once the merged mesh exists
+    if(!checkpointPrefix.empty())
+    {
+        for(int b = 0; b < nbBlocks; ++b)
+            bfs::remove(checkpointPrefix + std::to_string(b) + ".geogram");
+    }
+}
+
 int main(int argc, char* argv[])
 {
     system::Timer timer;
@@ -45,6 +290,8 @@ int main(int argc, char* argv[])
     int minVertices = 0;
     int maxVertices = 0;
     unsigned int nbLloydIter = 40;
+    int blocksGridSize = 0;
+    bool checkpoints = false;
     bool flipNormals = false;
 
     po::options_description allParams("AliceVision meshResampling");
@@ -68,6 +315,10 @@ int main(int argc, char* argv[])
             "Max number of output vertices.")
         ("nbLloydIter", po::value<unsigned int>(&nbLloydIter)->default_value(nbLloydIter),
             "Number of iterations for Lloyd pre-smoothing.")
+        ("blocksGridSize", po::value<int>(&blocksGridSize)->default_value(blocksGridSize),
+            "Resample the mesh in blocksGridSize^3 spatial blocks in parallel, with the block seams stitched by welding the border vertices (0: remesh the whole mesh at once).")
+        ("checkpoints", po::value<bool>(&checkpoints)->default_value(checkpoints),
+            "Save each remeshed block next to the output mesh and reuse it when restarting after an interruption (block mode only).")
         ("flipNormals", po::value<bool>(&flipNormals)->default_value(flipNormals),
             "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the convention change from one software to another.");
 
@@ -165,18 +416,21 @@ int main(int argc, char* argv[])
         GEO::CmdLine::import_arg_group("opt");
         GEO::CmdLine::import_arg_group("poly");
 
-        const unsigned int nbNewtonIter = 0;
-        const unsigned int newtonM = 0;
-
         ALICEVISION_LOG_INFO("Start mesh resampling.");
-        GEO::remesh_smooth(
-            M_in, M_out,
-            nbOutputPoints,
-            3, // 3 dimensions
-            nbLloydIter, // Number of iterations for Lloyd pre-smoothing
-            nbNewtonIter, // Number of iterations for Newton-CVT
-            newtonM // Number of evaluations for Hessian approximation
-            );
+        if(blocksGridSize > 1)
+        {
+            // the blocks run concurrently through OpenMP, keep geogram itself
+            // single threaded to avoid nesting its own thread pool
+            GEO::CmdLine::set_arg("sys:multithread", false);
+
+            ALICEVISION_LOG_INFO("Resample the mesh in " << blocksGridSize << "x" << blocksGridSize << "x" << blocksGridSize << " parallel blocks.");
+            const std::string checkpointPrefix = checkpoints ? outputMeshPath + ".block_" : std::string();
+            resampleMeshInBlocks(M_in, M_out, blocksGridSize, nbOutputPoints, nbLloydIter, checkpointPrefix);
+        }
+        else
+        {
+            remeshMesh(M_in, M_out, nbOutputPoints, nbLloydIter);
+        }
         ALICEVISION_LOG_INFO("Mesh resampling done.");
     }
     ALICEVISION_LOG_INFO("Output mesh: " << M_out.vertices.nb() << " vertices and " << M_out.facets.nb() << " facets.");
@@ -96,6 +96,9 @@ int main(int argc, char* argv[])
     float estimateSpaceMinObservationAngle = 10.0f;
     double universePercentile = 0.999;
     int maxPtsPerVoxel = 6000000;
+    std::string maxFlowAlg = "boykovKolmogorov";
+    int rangeStart = -1;
+    int rangeSize = -1;
     bool meshingFromDepthMaps = true;
     bool estimateSpaceFromSfM = true;
 
@@ -134,7 +137,12 @@ int main(int argc, char* argv[])
         ("repartition", po::value<ERepartitionMode>(&repartitionMode)->default_value(repartitionMode),
             "Repartition: 'multiResolution' or 'regularGrid'.")
         ("estimateSpaceFromSfM", po::value<bool>(&estimateSpaceFromSfM)->default_value(estimateSpaceFromSfM),
-            "Estimate the 3d space from the SfM.");
+            "Estimate the 3d space from the SfM.")
+        ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
+            "Reconstruct only a sub-range of the voxels from index rangeStart to rangeStart+rangeSize "
+            "(partitioning 'auto' only, to distribute the voxels over several machines).")
+        ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
+            "Range size.");
 
     po::options_description advancedParams("Advanced parameters");
     advancedParams.add_options()
@@ -159,7 +167,9 @@ int main(int argc, char* argv[])
         ("minAngleThreshold", po::value<double>(&fuseParams.minAngleThreshold)->default_value(fuseParams.minAngleThreshold),
             "minAngleThreshold")
         ("refineFuse", po::value<bool>(&fuseParams.refineFuse)->default_value(fuseParams.refineFuse),
-            "refineFuse");
+            "refineFuse")
+        ("maxFlowAlg", po::value<std::string>(&maxFlowAlg)->default_value(maxFlowAlg),
+            "Maxflow solver for the graph cut: 'boykovKolmogorov' (single-threaded) or 'parallelPushRelabel'.");
 
     po::options_description logParams("Log parameters");
     logParams.add_options()
@@ -231,6 +241,7 @@ int main(int argc, char* argv[])
     mvsUtils::MultiViewParams mp(sfmData, "", depthMapsFolder, depthMapsFilterFolder, meshingFromDepthMaps);
 
     mp.userParams.put("LargeScale.universePercentile", universePercentile);
+    mp.userParams.put("delaunaycut.maxFlowAlg", maxFlowAlg);
 
     int ocTreeDim = mp.userParams.get<int>("LargeScale.gridLevel0", 1024);
     const auto baseDir = mp.userParams.get<std::string>("LargeScale.baseDirName", "root01024");
@@ -270,7 +281,16 @@ int main(int argc, char* argv[])
                         voxelsArray = rp.computeReconstructionPlanBinSearch(fuseParams.maxPoints);
                         saveArrayToFile<Point3d>(voxelsArrayFileName, voxelsArray);
                     }
-                    fuseCut::reconstructSpaceAccordingToVoxelsArray(voxelsArrayFileName, &lsbase);
+                    fuseCut::reconstructSpaceAccordingToVoxelsArray(voxelsArrayFileName, &lsbase, rangeStart, rangeSize);
+
+                    if(rangeStart != -1)
+                    {
+                        // sub-range of a distributed reconstruction: other machines own the remaining
+                        // voxels, a final invocation without a range performs the join
+                        ALICEVISION_LOG_INFO("Voxel sub-range reconstructed, skipping mesh join.");
+                        break;
+                    }
+
                     // Join meshes
                     mesh::Mesh* mesh = fuseCut::joinMeshes(voxelsArrayFileName, &lsbase);
 
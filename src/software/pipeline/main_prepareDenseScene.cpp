@@ -7,6 +7,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/mvsUtils/cameraTable.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/cmdline.hpp>
 #include <aliceVision/config.hpp>
@@ -44,7 +45,8 @@ bool prepareDenseScene(const SfMData& sfmData,
                        const std::string& outFolder,
                        image::EImageFileType outputFileType,
                        bool saveMetadata,
-                       bool saveMatricesFiles)
+                       bool saveMatricesFiles,
+                       int nbPyramidLevels)
 {
   // defined view Ids
   std::set<IndexT> viewIds;
@@ -73,6 +75,17 @@ bool prepareDenseScene(const SfMData& sfmData,
     ALICEVISION_LOG_WARNING("Cannot save informations in images metadata.\n"
                             "Choose '.exr' file type if you want AliceVision custom metadata");
 
+  // precompute the undistortion maps, one per intrinsic, shared across all the
+  // views of the same camera: the distortion model is only evaluated once per
+  // pixel instead of once per pixel and per view
+  std::map<IndexT, UndistortionMap> undistortionMaps;
+  for(const auto& intrinsicPair : sfmData.getIntrinsics())
+  {
+    const IntrinsicBase* cam = intrinsicPair.second.get();
+    if(cam->isValid() && cam->have_disto())
+      undistortionMaps[intrinsicPair.first].compute(cam, cam->w(), cam->h());
+  }
+
   // export data
   boost::progress_display progressBar(viewIds.size(), std::cout, "Exporting Scene Undistorted Images\n");
 
@@ -193,20 +206,79 @@ bool prepareDenseScene(const SfMData& sfmData,
       // undistort
       if(cam->isValid() && cam->have_disto())
       {
-        // undistort the image and save it
-        UndistortImage(image, cam, image_ud, FBLACK);
+        // undistort the image through the precomputed map and save it
+        UndistortImage(image, undistortionMaps.at(view->getIntrinsicId()), image_ud, FBLACK);
         writeImage(dstColorImage, image_ud, metadata);
       }
       else
       {
         writeImage(dstColorImage, image, metadata);
       }
+
+      // pyramid sidecars: halve the undistorted image nbPyramidLevels times and
+      // save each level as '<viewId>_d<scale>', so the dense reconstruction steps
+      // can read their working scale directly instead of re-decoding and
+      // downscaling the full-resolution frame
+      if(nbPyramidLevels > 0)
+      {
+        const Image<RGBfColor>* src = (cam->isValid() && cam->have_disto()) ? &image_ud : &image;
+        Image<RGBfColor> level;
+        int scale = 1;
+        for(int l = 0; l < nbPyramidLevels; ++l)
+        {
+          scale *= 2;
+          Image<RGBfColor> halved;
+          ImageHalfSample(*src, halved);
+
+          oiio::ParamValueList levelMetadata = metadata;
+          for(oiio::ParamValue& param : levelMetadata)
+            if(param.name() == "AliceVision:downscale")
+              param = oiio::ParamValue("AliceVision:downscale", scale);
+
+          const std::string dstLevelImage = (fs::path(outFolder) / (baseFilename + "_d" + std::to_string(scale) + "." + image::EImageFileType_enumToString(outputFileType))).string();
+          writeImage(dstLevelImage, halved, levelMetadata);
+          level = std::move(halved);
+          src = &level;
+        }
+      }
     }
 
     #pragma omp critical
     ++progressBar;
   }
 
+  // write the consolidated binary camera table: MultiViewParams reads all the
+  // camera parameters of the scene from this single file instead of probing
+  // the metadata of every image at startup
+  {
+    std::vector<mvsUtils::CameraTableEntry> cameraTable;
+    cameraTable.reserve(viewIds.size());
+
+    for(const IndexT viewId : viewIds)
+    {
+      const View* view = sfmData.getViews().at(viewId).get();
+      const Pose3 pose = sfmData.getPose(*view).getTransform();
+      const Mat34 P = sfmData.getIntrinsicPtr(view->getIntrinsicId())->get_projective_equivalent(pose);
+
+      mvsUtils::CameraTableEntry entry;
+      entry.viewId = viewId;
+      entry.width = view->getWidth();
+      entry.height = view->getHeight();
+      entry.downscale = 1; // the undistorted images are written at scale 1
+
+      typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+      Eigen::Map<RowMatrixXd>(entry.P, P.rows(), P.cols()) = P;
+
+      entry.focal = -1.0; // same 'unknown' convention as the D files
+      entry.k1 = -1.0;
+      entry.k2 = -1.0;
+
+      cameraTable.push_back(entry);
+    }
+
+    mvsUtils::saveCameraTable(outFolder, cameraTable);
+  }
+
   return true;
 }
 
@@ -223,6 +295,7 @@ int main(int argc, char *argv[])
   int rangeSize = 1;
   bool saveMetadata = true;
   bool saveMatricesTxtFiles = false;
+  int nbPyramidLevels = 0;
 
   po::options_description allParams("AliceVision prepareDenseScene");
 
@@ -244,6 +317,10 @@ int main(int argc, char *argv[])
       "Save projections and intrinsics information in images metadata.")
     ("saveMatricesTxtFiles", po::value<bool>(&saveMatricesTxtFiles)->default_value(saveMatricesTxtFiles),
       "Save projections and intrinsics information in text files.")
+    ("savePyramidLevels", po::value<int>(&nbPyramidLevels)->default_value(nbPyramidLevels),
+      "Also export each undistorted image at N halved resolutions ('<viewId>_d<scale>' sidecars).\n"
+      "The dense reconstruction steps read their working scale directly from these sidecars\n"
+      "instead of re-decoding and downscaling the full-resolution frames.")
     ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
       "Range image index start.")
     ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
@@ -325,7 +402,7 @@ int main(int argc, char *argv[])
   }
 
   // export
-  if(prepareDenseScene(sfmData, imagesFolders, rangeStart, rangeEnd, outFolder, outputFileType, saveMetadata, saveMatricesTxtFiles))
+  if(prepareDenseScene(sfmData, imagesFolders, rangeStart, rangeEnd, outFolder, outputFileType, saveMetadata, saveMatricesTxtFiles, nbPyramidLevels))
     return EXIT_SUCCESS;
 
   return EXIT_FAILURE;
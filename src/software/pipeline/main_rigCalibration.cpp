@@ -92,6 +92,8 @@ int main(int argc, char** argv)
   double matchingErrorMax = 4.0;
   /// the maximum number of frames in input
   std::size_t maxInputFrames = 0;
+  /// the number of threads for the rig bundle adjustment
+  std::size_t nbThreads = 0;
 
 
   // parameters for voctree localizer
@@ -155,8 +157,11 @@ int main(int argc, char** argv)
       ("reprojectionError", po::value<double>(&resectionErrorMax)->default_value(resectionErrorMax), 
           "Maximum reprojection error (in pixels) allowed for resectioning. If set "
           "to 0 it lets the ACRansac select an optimal value.")
-      ("maxInputFrames", po::value<std::size_t>(&maxInputFrames)->default_value(maxInputFrames), 
-          "Maximum number of frames to read in input. 0 means no limit.");
+      ("maxInputFrames", po::value<std::size_t>(&maxInputFrames)->default_value(maxInputFrames),
+          "Maximum number of frames to read in input. 0 means no limit.")
+      ("nbThreads", po::value<std::size_t>(&nbThreads)->default_value(nbThreads),
+          "Number of threads used by the solver during the rig bundle adjustment. "
+          "0 means all the available cores.");
 
   // parameters for voctree localizer
   po::options_description voctreeParams("Parameters specific for the vocabulary tree-based localizer");
@@ -454,7 +459,7 @@ int main(int argc, char** argv)
     return EXIT_FAILURE;
   }
   ALICEVISION_COUT("Rig calibration optimization...");
-  if(!rig.optimizeCalibration())
+  if(!rig.optimizeCalibration(nbThreads))
   {
     ALICEVISION_CERR("Unable to optimize the relative poses! Aborting...");
     return EXIT_FAILURE;
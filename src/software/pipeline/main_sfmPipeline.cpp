@@ -0,0 +1,432 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/sfm/sfm.hpp>
+#include <aliceVision/feature/feature.hpp>
+#include <aliceVision/feature/FeaturesPerView.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/feature/selection.hpp>
+#include <aliceVision/matchingImageCollection/matchingCommon.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilter.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_F_AC.hpp>
+#include <aliceVision/matchingImageCollection/pairBuilder.hpp>
+#include <aliceVision/matching/io.hpp>
+#include <aliceVision/image/all.hpp>
+#include <aliceVision/system/Telemetry.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/cmdline.hpp>
+#include <aliceVision/config.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+/**
+ * @brief Extract the regions of every view and keep them in memory.
+ *
+ * The regions go to regionsPerView for the matching stage and their positions
+ * to featuresPerView for the reconstruction, nothing is written to disk unless
+ * a featuresFolder is given.
+ */
+void extractRegions(const sfmData::SfMData& sfmData,
+                    const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+                    const std::string& featuresFolder,
+                    feature::RegionsPerView& regionsPerView,
+                    feature::FeaturesPerView& featuresPerView)
+{
+  std::vector<const sfmData::View*> views;
+  views.reserve(sfmData.getViews().size());
+  for(const auto& viewPair : sfmData.getViews())
+    views.push_back(viewPair.second.get());
+
+  for(const auto& imageDescriber : imageDescribers)
+  {
+    const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
+    const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberType);
+
+    // GPU describers schedule their own work, run them on one view at a time
+    const bool parallel = !imageDescriber->useCuda();
+
+    system::Telemetry::ScopedTimer describerTimer("extract_" + imageDescriberTypeName);
+
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for(int i = 0; i < static_cast<int>(views.size()); ++i)
+    {
+      const sfmData::View& view = *views.at(i);
+
+      ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName << " features from view '" << view.getImagePath() << "'");
+
+      image::Image<float> imageGrayFloat;
+      image::readImage(view.getImagePath(), imageGrayFloat);
+
+      std::unique_ptr<feature::Regions> regions;
+      if(imageDescriber->useFloatImage())
+      {
+        imageDescriber->describe(imageGrayFloat, regions);
+      }
+      else
+      {
+        const image::Image<unsigned char> imageGrayUChar = (imageGrayFloat.GetMat() * 255.f).cast<unsigned char>();
+        imageDescriber->describe(imageGrayUChar, regions);
+      }
+
+      ALICEVISION_LOG_INFO(std::to_string(regions->RegionCount()) + " " + imageDescriberTypeName + " features extracted from view '" + view.getImagePath() + "'");
+
+      if(!featuresFolder.empty())
+      {
+        const std::string basename = (fs::path(featuresFolder) / fs::path(std::to_string(view.getViewId()))).string();
+        imageDescriber->Save(regions.get(), basename + "." + imageDescriberTypeName + ".feat",
+                                            basename + "." + imageDescriberTypeName + ".desc");
+      }
+
+      #pragma omp critical(sfmPipelineRegions)
+      {
+        featuresPerView.addFeatures(view.getViewId(), imageDescriberType, regions->GetRegionsPositions());
+        regionsPerView.addRegions(view.getViewId(), imageDescriberType, regions.release());
+      }
+    }
+  }
+}
+
+/// Run the feature extraction, feature matching and incremental SfM stages in
+/// a single process, passing regions and matches in memory between the stages.
+int main(int argc, char **argv)
+{
+  // command-line parameters
+
+  std::string verboseLevel = system::EVerboseLevel_enumToString(system::Logger::getDefaultVerboseLevel());
+  std::string sfmDataFilename;
+  std::string outputSfM;
+
+  // user optional parameters
+
+  std::string featuresFolder;
+  std::string matchesFolder;
+  std::string extraInfoFolder;
+  std::string describerTypesName = feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT);
+  std::string describerPreset = feature::EImageDescriberPreset_enumToString(feature::EImageDescriberPreset::NORMAL);
+  bool forceCpuExtraction = false;
+  std::string nearestMatchingMethod = "ANN_L2";
+  float distRatio = 0.8f;
+  double geometricErrorMax = 0.0;
+  int maxIteration = 2048;
+  bool useGridSort = true;
+  std::size_t numMatchesToKeep = 0;
+  int minInputTrackLength = 2;
+  bool refineIntrinsics = true;
+  bool useLocalBundleAdjustment = false;
+  std::size_t checkpointInterval = 0;
+
+  po::options_description allParams(
+    "Run the feature extraction, feature matching and incremental SfM stages in a single process.\n"
+    "Regions and matches are passed in memory between the stages instead of being written and reread,\n"
+    "the intermediate files are only written when an output folder is explicitly given.\n"
+    "AliceVision sfmPipeline");
+
+  po::options_description requiredParams("Required parameters");
+  requiredParams.add_options()
+    ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
+      "SfMData file.")
+    ("output,o", po::value<std::string>(&outputSfM)->required(),
+      "Path to the output SfMData file.");
+
+  po::options_description optionalParams("Optional parameters");
+  optionalParams.add_options()
+    ("featuresFolder,f", po::value<std::string>(&featuresFolder)->default_value(featuresFolder),
+      "If set, the extracted features and descriptors are also written to this folder (*.feat, *.desc).")
+    ("matchesFolder,m", po::value<std::string>(&matchesFolder)->default_value(matchesFolder),
+      "If set, the geometric matches are also written to this folder.")
+    ("extraInfoFolder", po::value<std::string>(&extraInfoFolder)->default_value(extraInfoFolder),
+      "Folder for intermediate reconstruction files and additional reconstruction information files.")
+    ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),
+      feature::EImageDescriberType_informations().c_str())
+    ("describerPreset,p", po::value<std::string>(&describerPreset)->default_value(describerPreset),
+      "Control the ImageDescriber configuration (low, medium, normal, high, ultra).")
+    ("forceCpuExtraction", po::value<bool>(&forceCpuExtraction)->default_value(forceCpuExtraction),
+      "Use only CPU feature extraction methods.")
+    ("photometricMatchingMethod", po::value<std::string>(&nearestMatchingMethod)->default_value(nearestMatchingMethod),
+      "Photometric matching method (BRUTE_FORCE_L2, ANN_L2, HNSW_L2, CASCADE_HASHING_L2, FAST_CASCADE_HASHING_L2, BRUTE_FORCE_HAMMING).")
+    ("distanceRatio", po::value<float>(&distRatio)->default_value(distRatio),
+      "Distance ratio to discard non meaningful matches.")
+    ("geometricError", po::value<double>(&geometricErrorMax)->default_value(geometricErrorMax),
+      "Maximum matching error (in pixels) allowed for image matching with geometric verification. "
+      "If set to 0 it lets the ACRansac select an optimal value.")
+    ("maxIteration", po::value<int>(&maxIteration)->default_value(maxIteration),
+      "Maximum number of iterations allowed in ransac step.")
+    ("useGridSort", po::value<bool>(&useGridSort)->default_value(useGridSort),
+      "Use matching grid sort.")
+    ("maxMatches", po::value<std::size_t>(&numMatchesToKeep)->default_value(numMatchesToKeep),
+      "Maximum number of matches to keep.")
+    ("minInputTrackLength", po::value<int>(&minInputTrackLength)->default_value(minInputTrackLength),
+      "Minimum track length in input of SfM.")
+    ("refineIntrinsics", po::value<bool>(&refineIntrinsics)->default_value(refineIntrinsics),
+      "Refine intrinsic parameters.")
+    ("useLocalBA,l", po::value<bool>(&useLocalBundleAdjustment)->default_value(useLocalBundleAdjustment),
+      "Enable/Disable the Local bundle adjustment strategy.\n"
+      "It reduces the reconstruction time, especially for big datasets (500+ images).")
+    ("checkpointInterval", po::value<std::size_t>(&checkpointInterval)->default_value(checkpointInterval),
+      "Number of resection groups between two reconstruction checkpoint files written in the extraInfoFolder. 0 means no checkpoint.");
+
+  po::options_description logParams("Log parameters");
+  logParams.add_options()
+    ("verboseLevel,v", po::value<std::string>(&verboseLevel)->default_value(verboseLevel),
+      "verbosity level (fatal, error, warning, info, debug, trace).");
+
+  allParams.add(requiredParams).add(optionalParams).add(logParams);
+
+  po::variables_map vm;
+  try
+  {
+    po::store(po::parse_command_line(argc, argv, allParams), vm);
+
+    if(vm.count("help") || (argc == 1))
+    {
+      ALICEVISION_COUT(allParams);
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  }
+  catch(boost::program_options::required_option& e)
+  {
+    ALICEVISION_CERR("ERROR: " << e.what());
+    ALICEVISION_COUT("Usage:\n\n" << allParams);
+    return EXIT_FAILURE;
+  }
+  catch(boost::program_options::error& e)
+  {
+    ALICEVISION_CERR("ERROR: " << e.what());
+    ALICEVISION_COUT("Usage:\n\n" << allParams);
+    return EXIT_FAILURE;
+  }
+
+  ALICEVISION_COUT("Program called with the following parameters:");
+  ALICEVISION_COUT(vm);
+
+  // set verbose level
+  system::Logger::get()->setLogLevel(verboseLevel);
+
+  // 0 lets the ACRansac select an optimal geometric error value
+  if(!robustEstimation::checkRobustEstimator(robustEstimation::ERobustEstimator::ACRANSAC, geometricErrorMax))
+    return EXIT_FAILURE;
+
+  if(describerTypesName.empty())
+  {
+    ALICEVISION_LOG_ERROR("--describerTypes option is empty.");
+    return EXIT_FAILURE;
+  }
+
+  // create the opt-in persistence folders
+  for(const std::string& folder : {featuresFolder, matchesFolder})
+  {
+    if(!folder.empty() && !fs::exists(folder) && !fs::create_directory(folder))
+    {
+      ALICEVISION_LOG_ERROR("Cannot create output folder: " + folder);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // load input scene
+  sfmData::SfMData sfmData;
+  if(!sfmDataIO::Load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(sfmDataIO::VIEWS|sfmDataIO::INTRINSICS)))
+  {
+    ALICEVISION_LOG_ERROR("The input SfMData file '" + sfmDataFilename + "' cannot be read.");
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+  // a. Feature extraction, the regions stay in memory
+
+  feature::RegionsPerView regionsPerView;
+  feature::FeaturesPerView featuresPerView;
+
+  {
+    std::vector<std::shared_ptr<feature::ImageDescriber>> imageDescribers;
+    for(const auto& imageDescriberType : describerTypes)
+    {
+      std::shared_ptr<feature::ImageDescriber> imageDescriber = feature::createImageDescriber(imageDescriberType);
+      imageDescriber->setConfigurationPreset(describerPreset);
+      if(forceCpuExtraction)
+        imageDescriber->setUseCuda(false);
+      imageDescribers.push_back(imageDescriber);
+    }
+
+    system::Timer timer;
+    extractRegions(sfmData, imageDescribers, featuresFolder, regionsPerView, featuresPerView);
+    ALICEVISION_LOG_INFO("Task (Feature Extraction) done in (s): " + std::to_string(timer.elapsed()));
+  }
+
+  // b. Putative matching and geometric filtering, the matches stay in memory
+
+  matching::PairwiseMatches finalMatches;
+
+  {
+    system::Timer timer;
+
+    matchingImageCollection::ExhaustivePairsSource pairsSource(sfmData.getViews());
+    ALICEVISION_LOG_INFO("Number of pairs: " << pairsSource.size());
+
+    matching::PairwiseMatches mapPutativesMatches;
+
+    const matching::EMatcherType collectionMatcherType = matching::EMatcherType_stringToEnum(nearestMatchingMethod);
+    std::unique_ptr<matchingImageCollection::IImageCollectionMatcher> imageCollectionMatcher = matchingImageCollection::createImageCollectionMatcher(collectionMatcherType, distRatio);
+    if(!matchesFolder.empty())
+      imageCollectionMatcher->setCachePath((fs::path(matchesFolder) / "matcherCache").string());
+
+    {
+      system::Telemetry::ScopedTimer telemetryTimer("putativeMatching");
+      for(const feature::EImageDescriberType descType : describerTypes)
+      {
+        ALICEVISION_LOG_INFO(feature::EImageDescriberType_enumToString(descType) + " Regions Matching");
+        imageCollectionMatcher->Match(regionsPerView, pairsSource, descType, mapPutativesMatches);
+      }
+    }
+
+    ALICEVISION_LOG_INFO(std::to_string(mapPutativesMatches.size()) + " putative image pair matches");
+
+    if(mapPutativesMatches.empty())
+    {
+      ALICEVISION_LOG_ERROR("No putative matches.");
+      return EXIT_FAILURE;
+    }
+
+    matching::PairwiseMatches geometricMatches;
+    {
+      system::Telemetry::ScopedTimer telemetryTimer("geometricFiltering");
+      matchingImageCollection::robustModelEstimation(geometricMatches,
+        &sfmData,
+        regionsPerView,
+        matchingImageCollection::GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration),
+        mapPutativesMatches,
+        false);
+    }
+
+    ALICEVISION_LOG_INFO(std::to_string(geometricMatches.size()) + " geometric image pair matches");
+
+    // grid filtering, same post-process as the standalone featureMatching
+    for(const auto& geometricMatch : geometricMatches)
+    {
+      const Pair& indexImagePair = geometricMatch.first;
+
+      for(const auto& match : geometricMatch.second)
+      {
+        const feature::EImageDescriberType descType = match.first;
+        const matching::IndMatches& inputMatches = match.second;
+
+        const feature::FeatRegions<feature::SIOPointFeature>* rRegions = dynamic_cast<const feature::FeatRegions<feature::SIOPointFeature>*>(&regionsPerView.getRegions(indexImagePair.second, descType));
+        const feature::FeatRegions<feature::SIOPointFeature>* lRegions = dynamic_cast<const feature::FeatRegions<feature::SIOPointFeature>*>(&regionsPerView.getRegions(indexImagePair.first, descType));
+
+        if(lRegions && rRegions)
+        {
+          matching::IndMatches outMatches;
+          feature::sortMatches_byFeaturesScale(inputMatches, *lRegions, *rRegions, outMatches);
+
+          if(useGridSort)
+            feature::matchesGridFiltering(*lRegions, *rRegions, indexImagePair, sfmData, outMatches);
+
+          if(numMatchesToKeep > 0)
+            outMatches.resize(std::min(numMatchesToKeep, outMatches.size()));
+
+          finalMatches[indexImagePair].insert(std::make_pair(descType, outMatches));
+        }
+        else
+        {
+          finalMatches[indexImagePair].insert(std::make_pair(descType, inputMatches));
+        }
+      }
+    }
+
+    if(!matchesFolder.empty())
+    {
+      ALICEVISION_LOG_INFO("Save geometric matches.");
+      matching::Save(finalMatches, matchesFolder, "txt", true);
+    }
+
+    ALICEVISION_LOG_INFO("Task (Regions Matching) done in (s): " + std::to_string(timer.elapsed()));
+
+    // the descriptors are only needed by the matching
+    regionsPerView.clearDescriptors();
+  }
+
+  // c. Incremental reconstruction from the in-memory features and matches
+
+  if(extraInfoFolder.empty())
+    extraInfoFolder = fs::path(outputSfM).parent_path().string();
+
+  if(!fs::exists(extraInfoFolder))
+    fs::create_directory(extraInfoFolder);
+
+  system::Timer timer;
+  sfm::ReconstructionEngine_sequentialSfM sfmEngine(
+    sfmData,
+    extraInfoFolder,
+    (fs::path(extraInfoFolder) / "sfm_log.html").string());
+
+  sfmEngine.setFeatures(&featuresPerView);
+  sfmEngine.setMatches(&finalMatches);
+
+  sfmEngine.setFixedIntrinsics(!refineIntrinsics);
+  sfmEngine.setMinInputTrackLength(minInputTrackLength);
+  sfmEngine.setCheckpointInterval(checkpointInterval);
+  sfmEngine.setUseLocalBundleAdjustmentStrategy(useLocalBundleAdjustment);
+
+  if(!sfmEngine.process())
+    return EXIT_FAILURE;
+
+  // get the color for the 3D points
+  if(!sfmEngine.colorize())
+    ALICEVISION_LOG_ERROR("SfM Colorization failed.");
+
+  // the features and matches folders are only referenced when they were written
+  {
+    const fs::path sfmFolder = fs::path(outputSfM).remove_filename();
+
+    if(!featuresFolder.empty())
+      sfmEngine.getSfMData().addFeaturesFolder(fs::relative(fs::path(featuresFolder), sfmFolder).string());
+
+    if(!matchesFolder.empty())
+      sfmEngine.getSfMData().addMatchesFolder(fs::relative(fs::path(matchesFolder), sfmFolder).string());
+
+    sfmEngine.getSfMData().setAbsolutePath(outputSfM);
+  }
+
+  ALICEVISION_LOG_INFO("Structure from motion took (s): " + std::to_string(timer.elapsed()));
+
+  sfm::generateSfMReport(sfmEngine.getSfMData(), (fs::path(extraInfoFolder) / "sfm_report.html").string());
+
+  // export to disk computed scene (data & visualizable results)
+  ALICEVISION_LOG_INFO("Export SfMData to disk: " + outputSfM);
+
+  sfmDataIO::Save(sfmEngine.getSfMData(), (fs::path(extraInfoFolder) / "cloud_and_poses.ply").string(), sfmDataIO::ESfMData(sfmDataIO::VIEWS|sfmDataIO::EXTRINSICS|sfmDataIO::INTRINSICS|sfmDataIO::STRUCTURE));
+  sfmDataIO::Save(sfmEngine.getSfMData(), outputSfM, sfmDataIO::ESfMData::ALL);
+
+  ALICEVISION_LOG_INFO("Structure from Motion results:" << std::endl
+    << "\t- # input images: " << sfmEngine.getSfMData().getViews().size() << std::endl
+    << "\t- # cameras calibrated: " << sfmEngine.getSfMData().getValidViews().size() << std::endl
+    << "\t- # poses: " << sfmEngine.getSfMData().getPoses().size() << std::endl
+    << "\t- # landmarks: " << sfmEngine.getSfMData().getLandmarks().size());
+
+  return EXIT_SUCCESS;
+}
@@ -93,6 +93,8 @@ int main(int argc, char* argv[])
             "(0.0 to disable angle hard threshold filtering).")
         ("forceVisibleByAllVertices", po::value<bool>(&texParams.forceVisibleByAllVertices)->default_value(texParams.forceVisibleByAllVertices),
             "triangle visibility is based on the union of vertices visiblity.")
+        ("blockSize", po::value<unsigned int>(&texParams.blockSize)->default_value(texParams.blockSize),
+            "Number of texture rows accumulated at once to bound memory usage, with windowed reads of the source images (0: process the whole texture in memory).")
         ("visibilityRemappingMethod", po::value<std::string>(&visibilityRemappingMethod)->default_value(visibilityRemappingMethod),
             "Method to remap visibilities from the reconstruction to the input mesh.\n"
             " * Pull: For each vertex of the input mesh, pull the visibilities from the closest vertex in the reconstruction.\n"
@@ -15,6 +15,9 @@
 
 #include <boost/program_options.hpp>
 
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
 #include <string>
 #include <sstream>
 #include <vector>
@@ -31,6 +34,123 @@ using namespace aliceVision::sfmDataIO;
 namespace po = boost::program_options;
 
 
+/**
+ * @brief Compute the 6x6 diagonal blocks of the pose covariance matrix only.
+ *
+ * The landmark parameters are eliminated through the Schur complement (their
+ * information block is 3x3 block-diagonal since each observation involves a
+ * single landmark), the reduced camera system is factorized once and each pose
+ * covariance block is recovered by a 6 column back-substitution. This avoids
+ * factorizing/inverting the full information matrix and scales to thousands of
+ * cameras, at the price of only providing the per-pose marginal covariances.
+ *
+ * @param[in] jacobian The BA jacobian with columns ordered as [poses|intrinsics|points].
+ * @param[in] numPoses Number of 6 parameters pose blocks.
+ * @param[in] numIntrinsicParams Total number of intrinsic parameters (kept constant, skipped).
+ * @param[in] numPoints Number of 3 parameters landmark blocks.
+ * @param[in] epsilon Damping added to the reduced system diagonal to handle the gauge freedom.
+ * @param[out] out_poseCovariances The 6x6 covariance block of each pose.
+ * @return false if the jacobian layout does not match or the factorization fails.
+ */
+bool computePoseBlockDiagonalCovariances(const ceres::CRSMatrix& jacobian,
+                                         std::size_t numPoses,
+                                         std::size_t numIntrinsicParams,
+                                         std::size_t numPoints,
+                                         double epsilon,
+                                         std::vector<Eigen::Matrix<double, 6, 6>>& out_poseCovariances)
+{
+  const std::size_t poseCols = 6 * numPoses;
+  const std::size_t pointCols = 3 * numPoints;
+
+  if(poseCols + numIntrinsicParams + pointCols != static_cast<std::size_t>(jacobian.num_cols))
+  {
+    ALICEVISION_CERR("Unexpected jacobian layout: " << jacobian.num_cols << " columns for "
+      << numPoses << " poses, " << numIntrinsicParams << " intrinsic parameters and "
+      << numPoints << " points.");
+    return false;
+  }
+
+  // split the jacobian into its pose part and its landmark part, the columns of
+  // the constant intrinsics do not contribute to the covariance
+  std::vector<Eigen::Triplet<double>> poseTriplets;
+  std::vector<Eigen::Triplet<double>> pointTriplets;
+  for(int row = 0; row < jacobian.num_rows; ++row)
+  {
+    for(int idx = jacobian.rows[row]; idx < jacobian.rows[row + 1]; ++idx)
+    {
+      const std::size_t col = jacobian.cols[idx];
+      if(col < poseCols)
+        poseTriplets.emplace_back(row, col, jacobian.values[idx]);
+      else if(col >= poseCols + numIntrinsicParams)
+        pointTriplets.emplace_back(row, col - poseCols - numIntrinsicParams, jacobian.values[idx]);
+    }
+  }
+
+  Eigen::SparseMatrix<double> Jp(jacobian.num_rows, poseCols);
+  Eigen::SparseMatrix<double> Jx(jacobian.num_rows, pointCols);
+  Jp.setFromTriplets(poseTriplets.begin(), poseTriplets.end());
+  Jx.setFromTriplets(pointTriplets.begin(), pointTriplets.end());
+
+  const Eigen::SparseMatrix<double> Hpp = Eigen::SparseMatrix<double>(Jp.transpose()) * Jp;
+  const Eigen::SparseMatrix<double> Hpx = Eigen::SparseMatrix<double>(Jp.transpose()) * Jx;
+  const Eigen::SparseMatrix<double> Hxx = Eigen::SparseMatrix<double>(Jx.transpose()) * Jx;
+
+  // invert the 3x3 landmark blocks of Hxx (exactly block-diagonal: each
+  // observation involves a single landmark)
+  std::vector<Eigen::Matrix3d> blockInverses(numPoints);
+
+  #pragma omp parallel for schedule(dynamic)
+  for(int b = 0; b < static_cast<int>(numPoints); ++b)
+  {
+    Eigen::Matrix3d block;
+    for(int r = 0; r < 3; ++r)
+      for(int c = 0; c < 3; ++c)
+        block(r, c) = Hxx.coeff(3 * b + r, 3 * b + c);
+    // damp the block as well: landmarks observed from a degenerate set of views
+    // would otherwise make the elimination blow up
+    block.diagonal().array() += epsilon;
+    blockInverses[b] = block.inverse();
+  }
+
+  std::vector<Eigen::Triplet<double>> inverseTriplets;
+  inverseTriplets.reserve(9 * numPoints);
+  for(std::size_t b = 0; b < numPoints; ++b)
+    for(int r = 0; r < 3; ++r)
+      for(int c = 0; c < 3; ++c)
+        inverseTriplets.emplace_back(3 * b + r, 3 * b + c, blockInverses[b](r, c));
+
+  Eigen::SparseMatrix<double> HxxInv(pointCols, pointCols);
+  HxxInv.setFromTriplets(inverseTriplets.begin(), inverseTriplets.end());
+
+  // reduced camera system (Schur complement on the landmarks)
+  Eigen::SparseMatrix<double> S = Hpp - Hpx * HxxInv * Eigen::SparseMatrix<double>(Hpx.transpose());
+  for(std::size_t i = 0; i < poseCols; ++i)
+    S.coeffRef(i, i) += epsilon;
+
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
+  solver.compute(S);
+  if(solver.info() != Eigen::Success)
+  {
+    ALICEVISION_CERR("Factorization of the reduced camera system failed.");
+    return false;
+  }
+
+  out_poseCovariances.resize(numPoses);
+
+  // the factorization is shared, each block only needs its own 6 column solve
+  #pragma omp parallel for schedule(dynamic)
+  for(int b = 0; b < static_cast<int>(numPoses); ++b)
+  {
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(poseCols, 6);
+    for(int k = 0; k < 6; ++k)
+      rhs(6 * b + k, k) = 1.0;
+    const Eigen::MatrixXd sol = solver.solve(rhs);
+    out_poseCovariances[b] = sol.block<6, 6>(6 * b, 0);
+  }
+
+  return true;
+}
+
 int main(int argc, char **argv)
 {
   // command-line parameters
@@ -40,6 +160,7 @@ int main(int argc, char **argv)
   std::string outSfMDataFilename;
   std::string outputStats;
   std::string algorithm = cov::EAlgorithm_enumToString(cov::eAlgorithmSvdTaylorExpansion);
+  bool poseBlockDiagonal = false;
   bool debug = false;
 
   po::options_description params("AliceVision Uncertainty");
@@ -52,6 +173,10 @@ int main(int argc, char **argv)
     "Output covariances file.")
   ("algorithm,a", po::value<std::string>(&algorithm)->default_value(algorithm),
     "Algorithm.")
+  ("poseBlockDiagonal", po::value<bool>(&poseBlockDiagonal)->default_value(poseBlockDiagonal),
+    "Only compute the per-pose 6x6 covariance blocks through the Schur complement "
+    "on the landmarks. Much faster on large scenes, but the landmark uncertainties "
+    "are not computed.")
   ("debug,d", po::value<bool>(&debug)->default_value(debug),
     "Enable creation of debug files in the current folder.")
     ("verboseLevel,v", po::value<std::string>(&verboseLevel)->default_value(verboseLevel),
@@ -109,6 +234,33 @@ int main(int argc, char **argv)
     bundleAdjustmentObj.createJacobian(sfmData, refineOptions, jacobian);
   }
 
+  if(poseBlockDiagonal)
+  {
+    const double epsilon = 1e-10;
+
+    std::size_t numIntrinsicParams = 0;
+    for(const auto& intrinsicPair : sfmData.getIntrinsics())
+      numIntrinsicParams += intrinsicPair.second->getParams().size();
+
+    std::vector<Eigen::Matrix<double, 6, 6>> poseCovariances;
+    if(!computePoseBlockDiagonalCovariances(jacobian,
+                                            sfmData.getPoses().size(),
+                                            numIntrinsicParams,
+                                            sfmData.structure.size(),
+                                            epsilon,
+                                            poseCovariances))
+      return EXIT_FAILURE;
+
+    std::size_t indexPose = 0;
+    for (Poses::const_iterator itPose = sfmData.getPoses().begin(); itPose != sfmData.getPoses().end(); ++itPose, ++indexPose)
+    {
+      const IndexT idPose = itPose->first;
+      Vec6& u = sfmData._posesUncertainty[idPose]; // create uncertainty entry
+      const Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 6, 6>> eigenSolver(poseCovariances[indexPose]);
+      u = eigenSolver.eigenvalues();
+    }
+  }
+  else
   {
     cov::Options options;
     // Configure covariance engine (find the indexes of the most distatnt points etc.)
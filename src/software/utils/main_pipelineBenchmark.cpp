@@ -0,0 +1,287 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/cmdline.hpp>
+#include <aliceVision/system/system.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined(__UNIX__)
+#include <sys/resource.h>
+#endif
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+namespace bpt = boost::property_tree;
+
+namespace {
+
+/// One stage of the benchmarked chain: an aliceVision binary and its arguments
+struct BenchmarkStage
+{
+  std::string name;
+  std::string binary;
+  std::vector<std::string> arguments;
+};
+
+/// Measures of one executed stage
+struct StageResult
+{
+  std::string command;
+  int exitCode = 0;
+  double wallSec = 0.0;
+  double cpuSec = 0.0;
+  std::size_t peakRssBytes = 0;
+};
+
+/// Cumulated CPU time of the terminated child processes, in seconds
+double childrenCpuSec()
+{
+#if defined(__UNIX__)
+  struct rusage usage;
+  if(getrusage(RUSAGE_CHILDREN, &usage) != 0)
+    return 0.0;
+  return double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+       + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1.0e-6;
+#else
+  return 0.0;
+#endif
+}
+
+/// Peak resident memory over the terminated child processes, in bytes
+std::size_t childrenPeakRssBytes()
+{
+#if defined(__LINUX__)
+  struct rusage usage;
+  if(getrusage(RUSAGE_CHILDREN, &usage) != 0)
+    return 0;
+  return std::size_t(usage.ru_maxrss) * 1024; // ru_maxrss is in kilobytes
+#elif defined(__MACOS__)
+  struct rusage usage;
+  if(getrusage(RUSAGE_CHILDREN, &usage) != 0)
+    return 0;
+  return std::size_t(usage.ru_maxrss); // ru_maxrss is in bytes
+#else
+  return 0;
+#endif
+}
+
+/// Run one stage through the shell and measure it
+StageResult runStage(const BenchmarkStage& stage)
+{
+  StageResult result;
+
+  result.command = "\"" + stage.binary + "\"";
+  for(const std::string& argument : stage.arguments)
+    result.command += " \"" + argument + "\"";
+
+  ALICEVISION_LOG_INFO("Benchmark stage '" << stage.name << "': " << result.command);
+
+  const double cpuBefore = childrenCpuSec();
+
+  system::Timer timer;
+  result.exitCode = std::system(result.command.c_str());
+  result.wallSec = timer.elapsed();
+
+  // the children measures are cumulated over all the terminated stages, the
+  // CPU time is reported as a delta and the peak RSS as the peak so far
+  result.cpuSec = childrenCpuSec() - cpuBefore;
+  result.peakRssBytes = childrenPeakRssBytes();
+
+  return result;
+}
+
+} // unnamed namespace
+
+/**
+ * @brief Run the canonical reconstruction chain on a pinned dataset and
+ * report per-stage wall/CPU time and peak resident memory as JSON, for
+ * regression trend tracking between releases.
+ */
+int main(int argc, char** argv)
+{
+  // command-line parameters
+
+  std::string verboseLevel = system::EVerboseLevel_enumToString(system::Logger::getDefaultVerboseLevel());
+  std::string sfmDataFilename;
+  std::string outputFolder;
+  std::string binariesFolder = fs::path(argv[0]).parent_path().string();
+  std::string resultFilepath;
+
+  po::options_description allParams(
+    "Run the canonical reconstruction chain (featureExtraction, featureMatching, incrementalSfM,\n"
+    "prepareDenseScene, depthMapEstimation, depthMapFiltering, meshing, texturing) on a pinned\n"
+    "dataset and report per-stage timings and memory as JSON.\n"
+    "AliceVision pipelineBenchmark");
+
+  po::options_description requiredParams("Required parameters");
+  requiredParams.add_options()
+    ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
+      "SfMData file of the benchmark dataset (output of cameraInit).")
+    ("output,o", po::value<std::string>(&outputFolder)->required(),
+      "Working folder for all the intermediate pipeline data.");
+
+  po::options_description optionalParams("Optional parameters");
+  optionalParams.add_options()
+    ("binariesFolder", po::value<std::string>(&binariesFolder)->default_value(binariesFolder),
+      "Folder containing the aliceVision binaries to benchmark.")
+    ("resultFile", po::value<std::string>(&resultFilepath)->default_value(resultFilepath),
+      "Output JSON result file (default: <output>/benchmark.json).");
+
+  po::options_description logParams("Log parameters");
+  logParams.add_options()
+    ("verboseLevel,v", po::value<std::string>(&verboseLevel)->default_value(verboseLevel),
+      "verbosity level (fatal, error, warning, info, debug, trace).");
+
+  allParams.add(requiredParams).add(optionalParams).add(logParams);
+
+  po::variables_map vm;
+  try
+  {
+    po::store(po::parse_command_line(argc, argv, allParams), vm);
+
+    if(vm.count("help") || (argc == 1))
+    {
+      ALICEVISION_COUT(allParams);
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  }
+  catch(boost::program_options::required_option& e)
+  {
+    ALICEVISION_CERR("ERROR: " << e.what());
+    ALICEVISION_COUT("Usage:\n\n" << allParams);
+    return EXIT_FAILURE;
+  }
+  catch(boost::program_options::error& e)
+  {
+    ALICEVISION_CERR("ERROR: " << e.what());
+    ALICEVISION_COUT("Usage:\n\n" << allParams);
+    return EXIT_FAILURE;
+  }
+
+  ALICEVISION_COUT("Program called with the following parameters:");
+  ALICEVISION_COUT(vm);
+
+  // set verbose level
+  system::Logger::get()->setLogLevel(verboseLevel);
+
+  if(!fs::exists(outputFolder))
+    fs::create_directory(outputFolder);
+
+  if(resultFilepath.empty())
+    resultFilepath = (fs::path(outputFolder) / "benchmark.json").string();
+
+  const auto binaryPath = [&](const std::string& name)
+  {
+    return (fs::path(binariesFolder) / name).string();
+  };
+  const auto outPath = [&](const std::string& name)
+  {
+    return (fs::path(outputFolder) / name).string();
+  };
+
+  // the canonical chain; prepareDenseScene and depthMapFiltering are part of
+  // it because the MVS stages consume their outputs
+  const std::string featuresFolder = outPath("features");
+  const std::string matchesFolder = outPath("matches");
+  const std::string sfmFilepath = outPath("sfm.abc");
+  const std::string mvsImagesFolder = outPath("mvsImages");
+  const std::string depthMapFolder = outPath("depthMap");
+  const std::string depthMapFilterFolder = outPath("depthMapFiltered");
+  const std::string meshFilepath = outPath("mesh/mesh.obj");
+  const std::string texturingFolder = outPath("texturing");
+
+  fs::create_directory(outPath("mesh"));
+
+  const std::vector<BenchmarkStage> stages = {
+    {"featureExtraction", binaryPath("aliceVision_featureExtraction"),
+      {"-i", sfmDataFilename, "-o", featuresFolder}},
+    {"featureMatching", binaryPath("aliceVision_featureMatching"),
+      {"-i", sfmDataFilename, "-f", featuresFolder, "-o", matchesFolder}},
+    {"incrementalSfM", binaryPath("aliceVision_incrementalSfM"),
+      {"-i", sfmDataFilename, "-f", featuresFolder, "-m", matchesFolder, "-o", sfmFilepath}},
+    {"prepareDenseScene", binaryPath("aliceVision_prepareDenseScene"),
+      {"-i", sfmFilepath, "-o", mvsImagesFolder}},
+    {"depthMapEstimation", binaryPath("aliceVision_depthMapEstimation"),
+      {"-i", sfmFilepath, "--imagesFolder", mvsImagesFolder, "-o", depthMapFolder}},
+    {"depthMapFiltering", binaryPath("aliceVision_depthMapFiltering"),
+      {"-i", sfmFilepath, "--depthMapsFolder", depthMapFolder, "-o", depthMapFilterFolder}},
+    {"meshing", binaryPath("aliceVision_meshing"),
+      {"-i", sfmFilepath, "--depthMapsFolder", depthMapFolder, "--depthMapsFilterFolder", depthMapFilterFolder, "-o", meshFilepath}},
+    {"texturing", binaryPath("aliceVision_texturing"),
+      {"-i", sfmFilepath, "--inputDenseReconstruction", outPath("mesh/denseReconstruction.bin"), "-o", texturingFolder}},
+  };
+
+  bpt::ptree resultTree;
+  resultTree.put("dataset", sfmDataFilename);
+  resultTree.put("totalRamBytes", system::getMemoryInfo().totalRam);
+
+  bool success = true;
+  double totalWallSec = 0.0;
+  double totalCpuSec = 0.0;
+
+  for(const BenchmarkStage& stage : stages)
+  {
+    const StageResult result = runStage(stage);
+
+    totalWallSec += result.wallSec;
+    totalCpuSec += result.cpuSec;
+
+    const std::string path = "stages." + stage.name;
+    resultTree.put(path + ".command", result.command);
+    resultTree.put(path + ".exitCode", result.exitCode);
+    resultTree.put(path + ".wallSec", result.wallSec);
+    resultTree.put(path + ".cpuSec", result.cpuSec);
+    resultTree.put(path + ".peakRssBytes", result.peakRssBytes);
+
+    ALICEVISION_LOG_INFO("Benchmark stage '" << stage.name << "' done in " << system::prettyTime(result.wallSec * 1000.0)
+                         << " (cpu: " << result.cpuSec << " s, peak rss: " << result.peakRssBytes << " bytes).");
+
+    if(result.exitCode != 0)
+    {
+      ALICEVISION_LOG_ERROR("Benchmark stage '" << stage.name << "' failed with exit code " << result.exitCode << ".");
+      success = false;
+      break;
+    }
+  }
+
+  resultTree.put("totalWallSec", totalWallSec);
+  resultTree.put("totalCpuSec", totalCpuSec);
+  resultTree.put("peakRssBytes", childrenPeakRssBytes());
+  resultTree.put("success", success);
+
+  try
+  {
+    bpt::write_json(resultFilepath, resultTree);
+  }
+  catch(const std::exception& e)
+  {
+    ALICEVISION_LOG_ERROR("Unable to save the benchmark results to '" << resultFilepath << "': " << e.what());
+    return EXIT_FAILURE;
+  }
+
+  ALICEVISION_LOG_INFO("Benchmark results saved to '" << resultFilepath << "'.");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
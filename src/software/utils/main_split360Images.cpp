@@ -51,11 +51,12 @@ public:
     _K << focal,     0,  width/2.0,
               0, focal, height/2.0,
               0,     0,          1;
+    _Kinv = _K.inverse();
   }
 
   Vec3 getLocalRay(double x, double y) const
   {
-    return (_K.inverse() * Vec3(x, y, 1.0)).normalized();
+    return (_Kinv * Vec3(x, y, 1.0)).normalized();
   }
 
   Vec3 getRay(double x, double y) const
@@ -68,6 +69,8 @@ private:
   Mat3 _R;
   /// Intrinsic matrix
   Mat3 _K;
+  /// Inverse intrinsic matrix, computed once instead of once per ray
+  Mat3 _Kinv;
 };
 
 /**
@@ -177,7 +180,52 @@ bool splitDualFisheye(const std::string& imagePath, const std::string& outputFol
   return true;
 }
 
-bool splitEquirectangular(const std::string& imagePath, const std::string& outputFolder, std::size_t nbSplits, std::size_t splitResolution)
+/**
+ * @brief Precomputed equirectangular-to-pinhole sampling grids.
+ *
+ * The backward mapping only depends on the panorama resolution and the split
+ * settings, so for a video every frame shares the same grids: they are computed
+ * once and reused, instead of shooting a ray per output pixel and per frame.
+ */
+struct EquirectangularSamplingGrids
+{
+  int inWidth = 0;
+  int inHeight = 0;
+  double focal = 0.0;
+  /// per split, the source position of each output pixel (row major)
+  std::vector<std::vector<Vec2f>> grids;
+
+  void compute(int width, int height, std::size_t nbSplits, std::size_t splitResolution)
+  {
+    inWidth = width;
+    inHeight = height;
+    focal = focalFromPinholeHeight(inHeight, degreeToRadian(60.0));
+
+    const double alpha = (M_PI * 2.0) / static_cast<double>(nbSplits);
+
+    grids.resize(nbSplits);
+    for(std::size_t s = 0; s < nbSplits; ++s)
+    {
+      const PinholeCameraR camera(focal, splitResolution, splitResolution, RotationAroundY(alpha * s));
+      std::vector<Vec2f>& grid = grids.at(s);
+      grid.resize(splitResolution * splitResolution);
+
+      #pragma omp parallel for
+      for(int j = 0; j < static_cast<int>(splitResolution); ++j)
+      {
+        for(int i = 0; i < static_cast<int>(splitResolution); ++i)
+        {
+          const Vec3 ray = camera.getRay(i, j);
+          const Vec2 x = SphericalMapping::get2DPoint(ray, inWidth, inHeight);
+          grid[j * splitResolution + i] = x.cast<float>();
+        }
+      }
+    }
+  }
+};
+
+bool splitEquirectangular(const std::string& imagePath, const std::string& outputFolder, std::size_t nbSplits, std::size_t splitResolution,
+                          EquirectangularSamplingGrids& samplingGrids)
 {
   oiio::ImageBuf inBuffer(imagePath);
 
@@ -192,35 +240,29 @@ bool splitEquirectangular(const std::string& imagePath, const std::string& outpu
   const int inWidth = imageSource.Width();
   const int inHeight = imageSource.Height();
 
-  std::vector<PinholeCameraR> cameras;
-
-  const double twoPi = M_PI * 2.0;
-  const double alpha = twoPi / static_cast<double>(nbSplits);
-  const double focal = focalFromPinholeHeight(inHeight, degreeToRadian(60.0));
-
-  double angle = 0.0;
-  for(std::size_t i = 0; i < nbSplits; ++i)
+  // (re)compute the sampling grids only when the panorama resolution changes
+  if(samplingGrids.inWidth != inWidth || samplingGrids.inHeight != inHeight)
   {
-    cameras.emplace_back(focal, splitResolution, splitResolution, RotationAroundY(angle));
-    angle += alpha;
+    ALICEVISION_LOG_INFO("Compute sampling grids for panorama resolution " << inWidth << "x" << inHeight << ".");
+    samplingGrids.compute(inWidth, inHeight, nbSplits, splitResolution);
   }
 
+  const double focal = samplingGrids.focal;
   const image::Sampler2d<image::SamplerLinear> sampler;
   image::Image<image::RGBColor> imaOut(splitResolution, splitResolution, image::BLACK);
 
   size_t index = 0;
-  for(const PinholeCameraR& camera : cameras)
+  for(const std::vector<Vec2f>& grid : samplingGrids.grids)
   {
-    imaOut.fill(image::BLACK);
-
     // Backward mapping:
-    // - Find for each pixels of the pinhole image where it comes from the panoramic image
-    for(int j = 0; j < splitResolution; ++j)
+    // - Find for each pixels of the pinhole image where it comes from the panoramic image,
+    //   through the precomputed grid, with one row of output pixels per task
+    #pragma omp parallel for
+    for(int j = 0; j < static_cast<int>(splitResolution); ++j)
     {
-      for(int i = 0; i < splitResolution; ++i)
+      for(int i = 0; i < static_cast<int>(splitResolution); ++i)
       {
-        const Vec3 ray = camera.getRay(i, j);
-        const Vec2 x = SphericalMapping::get2DPoint(ray, inWidth, inHeight);
+        const Vec2f& x = grid[j * splitResolution + i];
         imaOut(j,i) = sampler(imageSource, x(1), x(0));
       }
     }
@@ -450,6 +492,10 @@ int main(int argc, char** argv)
     }
   }
 
+  // shared across all frames: a video keeps the same resolution, so the
+  // backward mapping is only computed for the first frame
+  EquirectangularSamplingGrids samplingGrids;
+
   for(const std::string& imagePath : imagePaths)
   {
     bool hasCorrectPath = true;
@@ -459,7 +505,7 @@ int main(int argc, char** argv)
       if(equirectangularDemoMode)
         hasCorrectPath = splitEquirectangularDemo(imagePath, outputFolder, equirectangularNbSplits, equirectangularSplitResolution);
       else
-        hasCorrectPath = splitEquirectangular(imagePath, outputFolder, equirectangularNbSplits, equirectangularSplitResolution);
+        hasCorrectPath = splitEquirectangular(imagePath, outputFolder, equirectangularNbSplits, equirectangularSplitResolution, samplingGrids);
     }
     else if(splitMode == "dualfisheye")
     {
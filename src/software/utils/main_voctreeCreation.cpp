@@ -53,6 +53,8 @@ int main(int argc, char** argv)
   std::uint32_t K = 10;
   std::uint32_t restart = 5;
   std::uint32_t LEVELS = 6;
+  std::uint32_t maxDescriptors = 0;
+  std::uint32_t miniBatchSize = 0;
   bool sanityCheck = true;
 
   po::options_description allParams("This program is used to load the sift descriptors from a SfMData file and create a vocabulary tree\n"
@@ -73,6 +75,8 @@ int main(int argc, char** argv)
     (",k", po::value<uint32_t>(&K)->default_value(10), "The branching factor of the tree")
     ("restart,r", po::value<uint32_t>(&restart)->default_value(5), "Number of times that the kmean is launched for each cluster, the best solution is kept")
     (",L", po::value<uint32_t>(&LEVELS)->default_value(6), "Number of levels of the tree")
+    ("maxDescriptors,m", po::value<uint32_t>(&maxDescriptors)->default_value(0), "Maximum number of descriptors to use for the tree building, a random sample of the dataset is used when it contains more. 0 loads all the descriptors, which may not fit in memory on large datasets")
+    ("miniBatchSize,b", po::value<uint32_t>(&miniBatchSize)->default_value(0), "Number of descriptors assigned per k-means iteration, a random mini-batch is drawn when the cluster is larger. 0 assigns every descriptor in every iteration")
     ("sanitycheck,s", po::value<bool>(&sanityCheck)->default_value(sanityCheck), "Perform a sanity check at the end of the creation of the vocabulary tree. The sanity check is a query to the database with the same documents/images useed to train the vocabulary tree");
 
   po::options_description logParams("Log parameters");
@@ -122,12 +126,25 @@ int main(int argc, char** argv)
     return EXIT_FAILURE;
   }
 
-  std::vector<DescriptorFloat> descriptors;
+  // SIFT descriptors are stored as uint8 on disk; the tree is built and saved
+  // in uint8 as well (the runtime loads SIFT trees as uint8, see
+  // createVoctreeForDescriberType), so no float copy of the dataset is made.
+  std::vector<DescriptorUChar> descriptors;
 
   std::vector<size_t> descRead;
   ALICEVISION_COUT("Reading descriptors from " << sfmDataFilename);
   auto detect_start = std::chrono::steady_clock::now();
-  size_t numTotDescriptors = aliceVision::voctree::readDescFromFiles<DescriptorFloat, DescriptorUChar>(sfmData, featuresFolders, descriptors, descRead);
+  size_t numTotDescriptors;
+  if(maxDescriptors > 0)
+  {
+    // stream the files and keep a bounded random sample for the tree building,
+    // so datasets larger than memory can be processed
+    numTotDescriptors = aliceVision::voctree::readDescSampleFromFiles<DescriptorUChar, DescriptorUChar>(sfmData, featuresFolders, maxDescriptors, descriptors);
+  }
+  else
+  {
+    numTotDescriptors = aliceVision::voctree::readDescFromFiles<DescriptorUChar, DescriptorUChar>(sfmData, featuresFolders, descriptors, descRead);
+  }
   auto detect_end = std::chrono::steady_clock::now();
   auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
   if(descriptors.size() == 0)
@@ -136,13 +153,14 @@ int main(int argc, char** argv)
     return EXIT_FAILURE;
   }
 
-  ALICEVISION_COUT("Done! " << descRead.size() << " sets of descriptors read for a total of " << numTotDescriptors << " features");
+  ALICEVISION_COUT("Done! " << descriptors.size() << " descriptors kept of the " << numTotDescriptors << " features found");
   ALICEVISION_COUT("Reading took " << detect_elapsed.count() << " sec");
 
   // Create tree
-  aliceVision::voctree::TreeBuilder<DescriptorFloat> builder(DescriptorFloat(0));
+  aliceVision::voctree::TreeBuilder<DescriptorUChar> builder(DescriptorUChar(0));
   builder.setVerbose(tbVerbosity);
   builder.kmeans().setRestarts(restart);
+  builder.kmeans().setMiniBatchSize(miniBatchSize);
   ALICEVISION_COUT("Building a tree of L=" << LEVELS << " levels with a branching factor of k=" << K);
   detect_start = std::chrono::steady_clock::now();
   builder.build(descriptors, K, LEVELS);
@@ -153,35 +171,41 @@ int main(int argc, char** argv)
   ALICEVISION_COUT("Saving vocabulary tree as " << treeName);
   builder.tree().save(treeName);
 
+  // the training descriptors are no longer needed, the quantization below
+  // re-streams the files one image at a time
+  std::vector<DescriptorUChar>().swap(descriptors);
+
+  std::map<IndexT, std::string> descriptorsFiles;
+  aliceVision::voctree::getListOfDescriptorFiles(sfmData, featuresFolders, descriptorsFiles);
+
   aliceVision::voctree::SparseHistogramPerImage allSparseHistograms;
   // temporary vector used to save all the visual word for each image before adding them to documents
   std::vector<aliceVision::voctree::Word> imgVisualWords;
+  std::vector<DescriptorUChar> imgDescriptors;
   ALICEVISION_COUT("Quantizing the features");
-  size_t offset = 0; ///< this is used to align to the features of a given image in 'feature'
+  size_t docId = 0;
   detect_start = std::chrono::steady_clock::now();
   // pass each feature through the vocabulary tree to get the associated visual word
-  // for each read images, recover the number of features in it from descRead and loop over the features
-  for(size_t i = 0; i < descRead.size(); ++i)
+  for(const auto &currentFile : descriptorsFiles)
   {
     // for each image:
-    // clear the temporary vector used to save all the visual word and allocate the proper size
+    // load its descriptors and allocate as many visual words
+    imgDescriptors.clear();
+    feature::loadDescsFromBinFile<DescriptorUChar, DescriptorUChar>(currentFile.second, imgDescriptors, false);
     imgVisualWords.clear();
-    // allocate as many visual words as the number of the features in the image
-    imgVisualWords.resize(descRead[i], 0);
+    imgVisualWords.resize(imgDescriptors.size(), 0);
 
     #pragma omp parallel for
-    for(ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(descRead[i]); ++j)
+    for(ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(imgDescriptors.size()); ++j)
     {
       //	store the visual word associated to the feature in the temporary list
-      imgVisualWords[j] = builder.tree().quantize(descriptors[ j + offset ]);
+      imgVisualWords[j] = builder.tree().quantize(imgDescriptors[j]);
     }
     aliceVision::voctree::SparseHistogram histo;
     aliceVision::voctree::computeSparseHistogram(imgVisualWords, histo);
     // add the vector to the documents
-    allSparseHistograms[i] = histo;
-
-    // update the offset
-    offset += descRead[i];
+    allSparseHistograms[docId] = histo;
+    ++docId;
   }
   detect_end = std::chrono::steady_clock::now();
   detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
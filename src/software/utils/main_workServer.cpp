@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2018 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/WorkServer.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/cmdline.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdlib>
+#include <string>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+
+/// Coordinator of the dynamic chunk scheduler for the ranged pipeline
+/// binaries, see the --workServer option of featureExtraction,
+/// featureMatching and depthMapEstimation.
+int main(int argc, char** argv)
+{
+  // command-line parameters
+
+  std::string verboseLevel = system::EVerboseLevel_enumToString(system::Logger::getDefaultVerboseLevel());
+  int port = 0;
+  int nbItems = 0;
+
+  // user optional parameters
+
+  double targetChunkSeconds = 120.0;
+
+  po::options_description allParams(
+    "Dispatch dynamic work chunks to the ranged pipeline binaries.\n"
+    "Workers started with '--workServer <host>:<port>' pull a new [rangeStart, rangeSize)\n"
+    "chunk when they finish the previous one; the chunk size adapts to the reported\n"
+    "per-item cost instead of being a static partition.\n"
+    "AliceVision workServer");
+
+  po::options_description requiredParams("Required parameters");
+  requiredParams.add_options()
+    ("port,p", po::value<int>(&port)->required(),
+      "TCP port to listen on.")
+    ("nbItems,n", po::value<int>(&nbItems)->required(),
+      "Total number of work items to dispatch (number of views for featureExtraction/featureMatching, "
+      "number of cameras for depthMapEstimation).");
+
+  po::options_description optionalParams("Optional parameters");
+  optionalParams.add_options()
+    ("targetChunkSeconds", po::value<double>(&targetChunkSeconds)->default_value(targetChunkSeconds),
+      "Wall-clock duration a chunk should aim at, once the per-item cost has been measured.");
+
+  po::options_description logParams("Log parameters");
+  logParams.add_options()
+    ("verboseLevel,v", po::value<std::string>(&verboseLevel)->default_value(verboseLevel),
+      "verbosity level (fatal, error, warning, info, debug, trace).");
+
+  allParams.add(requiredParams).add(optionalParams).add(logParams);
+
+  po::variables_map vm;
+  try
+  {
+    po::store(po::parse_command_line(argc, argv, allParams), vm);
+
+    if(vm.count("help") || (argc == 1))
+    {
+      ALICEVISION_COUT(allParams);
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+  }
+  catch(boost::program_options::required_option& e)
+  {
+    ALICEVISION_CERR("ERROR: " << e.what());
+    ALICEVISION_COUT("Usage:\n\n" << allParams);
+    return EXIT_FAILURE;
+  }
+  catch(boost::program_options::error& e)
+  {
+    ALICEVISION_CERR("ERROR: " << e.what());
+    ALICEVISION_COUT("Usage:\n\n" << allParams);
+    return EXIT_FAILURE;
+  }
+
+  // set verbose level
+  system::Logger::get()->setLogLevel(verboseLevel);
+
+  if(nbItems <= 0)
+  {
+    ALICEVISION_LOG_ERROR("Invalid number of work items: " << nbItems);
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    system::WorkServer server(port, nbItems, targetChunkSeconds);
+    server.run();
+  }
+  catch(const std::exception& e)
+  {
+    ALICEVISION_LOG_ERROR(e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
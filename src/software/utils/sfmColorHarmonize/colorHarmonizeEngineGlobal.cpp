@@ -32,6 +32,7 @@
 
 #include <boost/progress.hpp>
 
+#include <array>
 #include <numeric>
 #include <iomanip>
 #include <iterator>
@@ -196,7 +197,66 @@ bool ColorHarmonizationEngineGlobal::Process()
   map_relativeHistograms[1].resize(_pairwiseMatches.size());
   map_relativeHistograms[2].resize(_pairwiseMatches.size());
 
-  for (size_t i = 0; i < _pairwiseMatches.size(); ++i)
+  if(_selectionMethod != eHistogramHarmonizeFullFrame &&
+     _selectionMethod != eHistogramHarmonizeMatchedPoints &&
+     _selectionMethod != eHistogramHarmonizeVLDSegment)
+  {
+    std::cout << "Selection method unsupported" << std::endl;
+    return false;
+  }
+
+  if(_selectionMethod == eHistogramHarmonizeFullFrame)
+  {
+    // the selection mask covers the whole frame: the histograms only depend on
+    // the image, compute them once per image instead of once per edge
+    std::vector<size_t> viewIds;
+    std::map<size_t, size_t> viewHistoIndex;
+    for(const auto& matchesIt : _pairwiseMatches)
+    {
+      for(const size_t viewId : {matchesIt.first.first, matchesIt.first.second})
+      {
+        if(viewHistoIndex.emplace(viewId, viewIds.size()).second)
+          viewIds.push_back(viewId);
+      }
+    }
+
+    std::vector<std::array<Histogram< double >, 3>> viewHistograms(viewIds.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int v = 0; v < static_cast<int>(viewIds.size()); ++v)
+    {
+      Image< RGBColor > image;
+      readImage(_fileNames[viewIds[v]], image);
+
+      for(std::size_t channelIndex = 0; channelIndex < 3; ++channelIndex)
+      {
+        Histogram< double > histo(minvalue, maxvalue, bin);
+        colorHarmonization::CommonDataByPair::computeHisto(histo, channelIndex, image);
+        viewHistograms[v][channelIndex] = histo;
+      }
+    }
+
+    std::size_t i = 0;
+    for(matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin();
+        iter != _pairwiseMatches.end(); ++iter, ++i)
+    {
+      const size_t viewI = iter->first.first;
+      const size_t viewJ = iter->first.second;
+
+      for(std::size_t channelIndex = 0; channelIndex < 3; ++channelIndex)
+      {
+        map_relativeHistograms[channelIndex][i] = relativeColorHistogramEdge(
+          map_cameraNodeToCameraIndex.at(viewI), map_cameraNodeToCameraIndex.at(viewJ),
+          viewHistograms[viewHistoIndex.at(viewI)][channelIndex].GetHist(),
+          viewHistograms[viewHistoIndex.at(viewJ)][channelIndex].GetHist());
+      }
+    }
+  }
+  else
+  {
+  // each iteration only reads shared data and writes its own edge slots
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < static_cast<int>(_pairwiseMatches.size()); ++i)
   {
     matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin();
     std::advance(iter, i);
@@ -210,6 +270,8 @@ bool ColorHarmonizationEngineGlobal::Process()
     //-- Edges names:
     std::pair< std::string, std::string > p_imaNames;
     p_imaNames = make_pair( _fileNames[ viewI ], _fileNames[ viewJ ] );
+
+    #pragma omp critical
     std::cout << "Current edge : "
       << fs::path(p_imaNames.first).filename().string() << "\t"
       << fs::path(p_imaNames.second).filename().string() << std::endl;
@@ -220,14 +282,6 @@ bool ColorHarmonizationEngineGlobal::Process()
 
     switch(_selectionMethod)
     {
-      case eHistogramHarmonizeFullFrame:
-      {
-        colorHarmonization::CommonDataByPair_fullFrame  dataSelector(
-          p_imaNames.first,
-          p_imaNames.second);
-        dataSelector.computeMask( maskI, maskJ );
-      }
-      break;
       case eHistogramHarmonizeMatchedPoints:
       {
         int circleSize = 10;
@@ -262,8 +316,8 @@ bool ColorHarmonizationEngineGlobal::Process()
       }
       break;
       default:
-        std::cout << "Selection method unsupported" << std::endl;
-        return false;
+        // already checked before the loop
+        break;
     }
 
     //-- Export the masks
@@ -297,7 +351,7 @@ bool ColorHarmonizationEngineGlobal::Process()
     colorHarmonization::CommonDataByPair::computeHisto( histoI, maskI, channelIndex, imageI );
     colorHarmonization::CommonDataByPair::computeHisto( histoJ, maskJ, channelIndex, imageJ );
     relativeColorHistogramEdge & edgeR = map_relativeHistograms[channelIndex][i];
-    edgeR = relativeColorHistogramEdge(map_cameraNodeToCameraIndex[viewI], map_cameraNodeToCameraIndex[viewJ],
+    edgeR = relativeColorHistogramEdge(map_cameraNodeToCameraIndex.at(viewI), map_cameraNodeToCameraIndex.at(viewJ),
       histoI.GetHist(), histoJ.GetHist());
 
     histoI = histoJ = Histogram< double >( minvalue, maxvalue, bin);
@@ -305,7 +359,7 @@ bool ColorHarmonizationEngineGlobal::Process()
     colorHarmonization::CommonDataByPair::computeHisto( histoI, maskI, channelIndex, imageI );
     colorHarmonization::CommonDataByPair::computeHisto( histoJ, maskJ, channelIndex, imageJ );
     relativeColorHistogramEdge & edgeG = map_relativeHistograms[channelIndex][i];
-    edgeG = relativeColorHistogramEdge(map_cameraNodeToCameraIndex[viewI], map_cameraNodeToCameraIndex[viewJ],
+    edgeG = relativeColorHistogramEdge(map_cameraNodeToCameraIndex.at(viewI), map_cameraNodeToCameraIndex.at(viewJ),
       histoI.GetHist(), histoJ.GetHist());
 
     histoI = histoJ = Histogram< double >( minvalue, maxvalue, bin);
@@ -313,9 +367,10 @@ bool ColorHarmonizationEngineGlobal::Process()
     colorHarmonization::CommonDataByPair::computeHisto( histoI, maskI, channelIndex, imageI );
     colorHarmonization::CommonDataByPair::computeHisto( histoJ, maskJ, channelIndex, imageJ );
     relativeColorHistogramEdge & edgeB = map_relativeHistograms[channelIndex][i];
-    edgeB = relativeColorHistogramEdge(map_cameraNodeToCameraIndex[viewI], map_cameraNodeToCameraIndex[viewJ],
+    edgeB = relativeColorHistogramEdge(map_cameraNodeToCameraIndex.at(viewI), map_cameraNodeToCameraIndex.at(viewJ),
       histoI.GetHist(), histoJ.GetHist());
   }
+  }
 
   std::cout << "\n -- \n SOLVE for color consistency with linear programming\n --" << std::endl;
   //-- Solve for the gains and offsets: